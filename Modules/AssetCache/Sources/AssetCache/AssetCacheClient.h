@@ -18,6 +18,7 @@ public:
         String ip = AssetCache::GetLocalHost();
         uint16 port = AssetCache::ASSET_SERVER_PORT;
         uint64 timeoutms = 60u * 1000u;
+        uint32 chunksInFlight = 4u; // chunks of item that are sent or requested without waiting for responses
     };
 
     AssetCacheClient();
@@ -28,6 +29,16 @@ public:
 
     AssetCache::Error AddToCacheSynchronously(const AssetCache::CacheItemKey& key, const AssetCache::CachedItemValue& value);
     AssetCache::Error RequestFromCacheSynchronously(const AssetCache::CacheItemKey& key, AssetCache::CachedItemValue* value);
+
+    /**
+        Batch requests pass many items that fit into one chunk by few packets, so they aren't limited by round trip per item.
+        Items that don't fit into one chunk are passed by single requests after batch. Result of every item is written into `results`,
+        returned error is an error of connection or sending that has interrupted request, so results of remaining items are the same.
+    */
+    AssetCache::Error AddToCacheSynchronously(const Vector<AssetCache::CacheItemKey>& keys, const Vector<AssetCache::CachedItemValue>& values, Vector<AssetCache::Error>& results);
+    /** Server responds on items in order of their reading, so item that is in memory of server doesn't wait for items that are read from disk */
+    AssetCache::Error RequestFromCacheSynchronously(const Vector<AssetCache::CacheItemKey>& keys, Vector<AssetCache::CachedItemValue>& values, Vector<AssetCache::Error>& results);
+
     AssetCache::Error RemoveFromCacheSynchronously(const AssetCache::CacheItemKey& key);
     AssetCache::Error ClearCacheSynchronously();
 
@@ -39,12 +50,16 @@ public:
 
 private:
     AssetCache::Error WaitRequest();
+    AssetCache::Error WaitChunkResponses(uint32& responsesCount);
+    void SkipChunkResponses(uint32 requestsCount);
     AssetCache::Error CheckStatusSynchronously();
+    void UpdateAddStats(AssetCache::Error resultCode);
+    void UpdateGetStats(AssetCache::Error resultCode);
     void ProcessNetwork();
 
     //ClientNetProxyListener
     void OnAddedToCache(const AssetCache::CacheItemKey& key, bool added) override;
-    void OnReceivedFromCache(const AssetCache::CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData) override;
+    void OnReceivedFromCache(const AssetCache::CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const AssetCache::ChunkView& chunkData) override;
     void OnRemovedFromCache(const AssetCache::CacheItemKey& key, bool removed) override;
     void OnCacheCleared(bool cleared) override;
     void OnServerStatusReceived() override;
@@ -75,6 +90,7 @@ private:
 
             recieved = false;
             processingRequest = false;
+            responsesCount = 0;
         }
 
         AssetCache::CacheItemKey key;
@@ -85,6 +101,7 @@ private:
 
         bool recieved = false;
         bool processingRequest = false;
+        uint32 responsesCount = 0; // responses on chunks of item, several chunks can be in flight
     };
 
     Dispatcher<Function<void()>> dispatcher;
@@ -103,7 +120,24 @@ private:
             bytesReceived = 0;
             bytesRemaining = 0;
             chunksReceived = 0;
+            chunksOverall = 0;
+        }
+    };
+
+    struct BatchRequest
+    {
+        void Reset()
+        {
+            itemIndices.clear();
+            itemsByChunks.clear();
+            values = nullptr;
+            results = nullptr;
         }
+
+        UnorderedMap<AssetCache::CacheItemKey, size_t> itemIndices; // index of item in request by its key
+        Vector<size_t> itemsByChunks; // items that are received as several chunks
+        Vector<AssetCache::CachedItemValue>* values = nullptr;
+        Vector<AssetCache::Error>* results = nullptr;
     };
 
     struct AddFilesRequest
@@ -145,12 +179,14 @@ private:
     AssetCache::ClientNetProxy client;
 
     uint64 timeoutMs = 60u * 1000u;
+    uint32 chunksInFlight = 4u;
 
     Mutex requestLocker;
     Mutex connectEstablishLocker;
     Request request;
     GetFilesRequest getFilesRequest;
     AddFilesRequest addFilesRequest;
+    BatchRequest batchRequest;
 
     Stats stats;
     std::atomic<bool> isActive;
@@ -28,6 +28,8 @@ enum ePacketID : uint8
     PACKET_REMOVE_RESPONSE,
     PACKET_CLEAR_REQUEST,
     PACKET_CLEAR_RESPONSE,
+    PACKET_GET_BATCH_REQUEST,
+    PACKET_ADD_BATCH_REQUEST,
     PACKET_COUNT
 };
 
@@ -3,6 +3,7 @@
 #include "AssetCache/CacheItemKey.h"
 #include "AssetCache/CachedItemValue.h"
 #include "AssetCache/AssetCacheConstants.h"
+#include "AssetCache/ChunkSplitter.h"
 
 #include <FileSystem/DynamicMemoryFile.h>
 
@@ -69,6 +70,9 @@ public:
     ePacketID type = PACKET_UNKNOWN;
     ScopedPtr<DynamicMemoryFile> serializationBuffer;
 
+protected:
+    const uint8* receivedData = nullptr; // raw data of received packet, deserialized fields may refer to it
+
 private:
     static Map<const uint8*, ScopedPtr<DynamicMemoryFile>> sendingPackets;
 };
@@ -78,7 +82,7 @@ class DataChunkPacket : public CachePacket
 {
 public:
     DataChunkPacket(ePacketID packetId);
-    DataChunkPacket(ePacketID packetId, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData);
+    DataChunkPacket(ePacketID packetId, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData);
 
 protected:
     bool DeserializeFromBuffer(File* file) override;
@@ -88,7 +92,7 @@ public:
     uint64 dataSize = 0;
     uint32 numOfChunks = 0;
     uint32 chunkNumber = 0;
-    Vector<uint8> chunkData;
+    ChunkView chunkData; // refers to data of received packet and isn't copied
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -96,7 +100,7 @@ class AddChunkRequestPacket : public DataChunkPacket
 {
 public:
     AddChunkRequestPacket();
-    AddChunkRequestPacket(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData);
+    AddChunkRequestPacket(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData);
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -134,7 +138,7 @@ class GetChunkResponsePacket : public DataChunkPacket
 {
 public:
     GetChunkResponsePacket();
-    GetChunkResponsePacket(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData);
+    GetChunkResponsePacket(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData);
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -219,5 +223,33 @@ public:
     bool cleared = false;
 };
 
+//////////////////////////////////////////////////////////////////////////
+class GetBatchRequestPacket : public CachePacket
+{
+public:
+    GetBatchRequestPacket();
+    GetBatchRequestPacket(const Vector<CacheItemKey>& keys);
+
+protected:
+    bool DeserializeFromBuffer(File* file) override;
+
+public:
+    Vector<CacheItemKey> keys; // first chunk of every item is responded by GetChunkResponsePacket
+};
+
+//////////////////////////////////////////////////////////////////////////
+class AddBatchRequestPacket : public CachePacket
+{
+public:
+    AddBatchRequestPacket();
+    AddBatchRequestPacket(const Vector<ItemChunkView>& items);
+
+protected:
+    bool DeserializeFromBuffer(File* file) override;
+
+public:
+    Vector<ItemChunkView> items; // chunks refer to data of received packet, every item is responded by AddResponsePacket
+};
+
 } // end of namespace AssetCache
 } // end of namespace DAVA
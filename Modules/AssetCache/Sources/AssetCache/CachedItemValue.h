@@ -55,7 +55,7 @@ public:
     void Serialize(KeyedArchive* archieve, bool serializeData) const;
     void Deserialize(KeyedArchive* archieve);
 
-    bool Serialize(File* file) const;
+    bool Serialize(File* file, bool serializeData = true) const;
     bool Deserialize(File* file);
 
     bool operator==(const CachedItemValue& right) const;
@@ -1,15 +1,44 @@
 #pragma once
 
+#include "AssetCache/CacheItemKey.h"
+
 #include <Base/BaseTypes.h>
 
 namespace DAVA
 {
 namespace AssetCache
 {
+/**
+    Non-owning view of chunk bytes. It refers either to serialized data of item or to received packet,
+    so it's valid while they are alive and unchanged.
+*/
+struct ChunkView
+{
+    ChunkView() = default;
+    ChunkView(const uint8* data_, uint32 size_)
+        : data(data_)
+        , size(size_)
+    {
+    }
+
+    const uint8* data = nullptr;
+    uint32 size = 0;
+};
+
+/** Item that fits into one chunk, several of such items are passed in one batch packet */
+struct ItemChunkView
+{
+    CacheItemKey key;
+    ChunkView chunk;
+};
+
 namespace ChunkSplitter
 {
+uint32 GetChunkSize();
 uint32 GetNumberOfChunks(uint64 overallSize);
-Vector<uint8> GetChunk(const Vector<uint8>& dataVector, uint32 chunkNumber);
+
+/** Returns view of chunk with given number inside of data vector, view is empty if there is no such chunk */
+ChunkView GetChunk(const Vector<uint8>& dataVector, uint32 chunkNumber);
 }
 } // namespace AssetCache
 } // namespace DAVA
@@ -2,6 +2,7 @@
 
 #include "AssetCache/Connection.h"
 #include "AssetCache/CacheItemKey.h"
+#include "AssetCache/ChunkSplitter.h"
 
 #include <Base/BaseTypes.h>
 #include <Network/IChannel.h>
@@ -27,7 +28,7 @@ public:
 
     virtual void OnClientProxyStateChanged(){};
     virtual void OnAddedToCache(const CacheItemKey& key, bool added){};
-    virtual void OnReceivedFromCache(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData){};
+    virtual void OnReceivedFromCache(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData){};
     virtual void OnRemovedFromCache(const CacheItemKey& key, bool removed){};
     virtual void OnCacheCleared(bool cleared){};
     virtual void OnServerStatusReceived(){};
@@ -51,8 +52,10 @@ public:
 
     // requests to sent on server
     bool RequestServerStatus();
-    bool RequestAddNextChunk(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData);
+    bool RequestAddNextChunk(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData);
     bool RequestGetNextChunk(const CacheItemKey& key, uint32 chunkNumber);
+    bool RequestAddBatch(const Vector<ItemChunkView>& items);
+    bool RequestGetBatch(const Vector<CacheItemKey>& keys);
     bool RequestWarmingUp(const CacheItemKey& key);
     bool RequestRemoveData(const CacheItemKey& key);
     bool RequestClearCache();
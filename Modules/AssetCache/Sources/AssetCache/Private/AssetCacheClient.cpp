@@ -5,6 +5,7 @@
 #include <Concurrency/LockGuard.h>
 #include <Concurrency/Thread.h>
 #include <FileSystem/DynamicMemoryFile.h>
+#include <FileSystem/UnmanagedMemoryFile.h>
 #include <Time/SystemTimer.h>
 #include <Utils/StringFormat.h>
 #include <Logger/Logger.h>
@@ -12,6 +13,11 @@
 
 namespace DAVA
 {
+namespace AssetCacheClientDetails
+{
+const uint32 MAX_ITEMS_IN_BATCH = 1024;
+}
+
 AssetCacheClient::AssetCacheClient()
     : dispatcher([](const Function<void()>& fn) { fn(); })
     , client(&dispatcher)
@@ -34,8 +40,9 @@ AssetCache::Error AssetCacheClient::ConnectSynchronously(const ConnectionParams&
 {
     isActive = true;
     timeoutMs = connectionParams.timeoutms;
+    chunksInFlight = std::max(connectionParams.chunksInFlight, 1u);
 
-    client.Connect(connectionParams.ip, AssetCache::ASSET_SERVER_PORT);
+    client.Connect(connectionParams.ip, connectionParams.port);
 
     {
         LockGuard<Mutex> guard(connectEstablishLocker);
@@ -111,53 +118,38 @@ AssetCache::Error AssetCacheClient::AddToCacheSynchronously(const AssetCache::Ca
         addFilesRequest.chunksSent = 0;
     }
 
-    AssetCache::Error resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
-
-    for (uint32 currentChunk = 0; currentChunk < chunksOverall; ++currentChunk)
+    // several chunks are sent without waiting for responses: server handles chunks of connection in order
+    // and responds on each of them, so throughput isn't limited by one chunk per round trip
+    AssetCache::Error resultCode = (chunksOverall > 0) ? AssetCache::Error::NO_ERRORS : AssetCache::Error::CANNOT_SEND_REQUEST;
+    uint32 chunksSent = 0;
+    uint32 responsesCount = 0;
+    while (resultCode == AssetCache::Error::NO_ERRORS && responsesCount < chunksOverall)
     {
-        Vector<uint8> chunkData;
-        {
-            LockGuard<Mutex> guard(requestLocker);
-            request = Request(AssetCache::PACKET_ADD_CHUNK_REQUEST, key);
-            chunkData = AssetCache::ChunkSplitter::GetChunk(addFilesRequest.serializedData->GetDataVector(), currentChunk);
-        }
-
-        resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
-
-        bool requestSent = client.RequestAddNextChunk(key, dataSizeOverall, chunksOverall, currentChunk, chunkData);
-        if (requestSent)
-        {
-            resultCode = WaitRequest();
-        }
-
+        for (; chunksSent < chunksOverall && chunksSent - responsesCount < chunksInFlight; ++chunksSent)
         {
-            LockGuard<Mutex> guard(requestLocker);
-            request.Reset();
+            // serialized data isn't changed until request is finished, so chunks refer to it without copying
+            AssetCache::ChunkView chunkData = AssetCache::ChunkSplitter::GetChunk(addFilesRequest.serializedData->GetDataVector(), chunksSent);
+            if (client.RequestAddNextChunk(key, dataSizeOverall, chunksOverall, chunksSent, chunkData) == false)
+            {
+                resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
+                break;
+            }
         }
 
-        if (resultCode != AssetCache::Error::NO_ERRORS)
+        if (resultCode == AssetCache::Error::NO_ERRORS)
         {
-            break;
+            resultCode = WaitChunkResponses(responsesCount);
         }
     }
 
-    { //process stats
-        ++stats.addRequestsCount;
-        switch (resultCode)
-        {
-        case AssetCache::Error::NO_ERRORS:
-            ++stats.addRequestsSucceedCount;
-            break;
-        case AssetCache::Error::OPERATION_TIMEOUT:
-            ++stats.addRequestsTimeoutCount;
-            break;
+    SkipChunkResponses(chunksSent);
 
-        default:
-            ++stats.addRequestsFailedCount;
-            break;
-        }
+    {
+        LockGuard<Mutex> guard(requestLocker);
+        request.Reset();
     }
 
+    UpdateAddStats(resultCode);
     return resultCode;
 }
 
@@ -171,92 +163,287 @@ AssetCache::Error AssetCacheClient::RequestFromCacheSynchronously(const AssetCac
         getFilesRequest.Reset();
     }
 
-    AssetCache::Error resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
-
-    bool requestSent = client.RequestGetNextChunk(key, 0);
-    if (requestSent)
+    // number of chunks is known when first chunk is received. After that several chunks are requested
+    // without waiting for responses: server handles requests of connection in order and responds on each of them
+    AssetCache::Error resultCode = AssetCache::Error::NO_ERRORS;
+    uint32 chunksOverall = 1;
+    uint32 chunksRequested = 0;
+    uint32 responsesCount = 0;
+    while (resultCode == AssetCache::Error::NO_ERRORS && responsesCount < chunksOverall)
     {
-        resultCode = WaitRequest();
+        for (; chunksRequested < chunksOverall && chunksRequested - responsesCount < chunksInFlight; ++chunksRequested)
+        {
+            if (client.RequestGetNextChunk(key, chunksRequested) == false)
+            {
+                resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
+                break;
+            }
+        }
+
+        if (resultCode == AssetCache::Error::NO_ERRORS)
+        {
+            resultCode = WaitChunkResponses(responsesCount);
+
+            LockGuard<Mutex> guard(requestLocker);
+            chunksOverall = std::max(getFilesRequest.chunksOverall, 1u);
+        }
     }
 
-    uint32 chunksOverall = 0;
+    SkipChunkResponses(chunksRequested);
+
     {
         LockGuard<Mutex> guard(requestLocker);
         request.Reset();
-        chunksOverall = getFilesRequest.chunksOverall;
     }
 
     if (resultCode == AssetCache::Error::NO_ERRORS)
     {
-        DVASSERT(chunksOverall > 0);
-        for (uint32 currentChunk = 1; currentChunk < chunksOverall; ++currentChunk)
+        LockGuard<Mutex> guard(requestLocker);
+        if (getFilesRequest.chunksReceived == getFilesRequest.chunksOverall && getFilesRequest.bytesRemaining == 0)
+        {
+            ScopedPtr<DynamicMemoryFile> f(DynamicMemoryFile::Create(std::move(getFilesRequest.receivedData), File::OPEN | File::READ, "receivedData"));
+            value->Deserialize(f);
+
+            const AssetCache::CachedItemValue::Description& description = value->GetDescription();
+            Logger::Info("Data got from cache. Generated %s on machine %s (%s)",
+                         description.creationDate.c_str(),
+                         description.machineName.c_str(),
+                         description.comment.c_str());
+        }
+        else
+        {
+            Logger::Error("Packet was not completely transferred. Chunks %u/%u, bytes remaining: %u",
+                          getFilesRequest.chunksReceived,
+                          getFilesRequest.chunksOverall,
+                          getFilesRequest.bytesRemaining);
+            resultCode = AssetCache::Error::CORRUPTED_DATA;
+        }
+    }
+
+    UpdateGetStats(resultCode);
+    return resultCode;
+}
+
+AssetCache::Error AssetCacheClient::AddToCacheSynchronously(const Vector<AssetCache::CacheItemKey>& keys, const Vector<AssetCache::CachedItemValue>& values, Vector<AssetCache::Error>& results)
+{
+    using namespace AssetCacheClientDetails;
+
+    DVASSERT(keys.size() == values.size());
+    results.assign(keys.size(), AssetCache::Error::CODE_NOT_INITIALIZED);
+
+    const uint32 chunkSize = AssetCache::ChunkSplitter::GetChunkSize();
+    Vector<size_t> batchItems;
+    Vector<size_t> itemsByChunks;
+    Vector<std::pair<size_t, size_t>> duplicates; // index of item and index of the same key that is added
+    Vector<ScopedPtr<DynamicMemoryFile>> serializedData(keys.size());
+    {
+        LockGuard<Mutex> guard(requestLocker);
+        request = Request(AssetCache::PACKET_ADD_BATCH_REQUEST);
+        batchRequest.Reset();
+        batchRequest.results = &results;
+
+        for (size_t index = 0; index < keys.size(); ++index)
         {
+            auto inserted = batchRequest.itemIndices.emplace(keys[index], index);
+            if (inserted.second == false)
             {
-                LockGuard<Mutex> guard(requestLocker);
-                request = Request(AssetCache::PACKET_GET_CHUNK_REQUEST, key);
+                duplicates.emplace_back(index, inserted.first->second);
+                continue;
             }
 
-            resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
-
-            bool requestSent = client.RequestGetNextChunk(key, currentChunk);
-            if (requestSent)
+            serializedData[index] = DynamicMemoryFile::Create(File::CREATE | File::WRITE | File::READ);
+            values[index].Serialize(serializedData[index]);
+            if (serializedData[index]->GetSize() <= chunkSize)
+            {
+                batchItems.push_back(index);
+            }
+            else
             {
-                resultCode = WaitRequest();
+                serializedData[index] = nullptr;
+                itemsByChunks.push_back(index);
             }
+        }
+    }
 
+    // several packets are sent without waiting for responses, as chunks of single item.
+    // Server responds on every item of packet, so packet is in flight until responses on all its items are received
+    AssetCache::Error resultCode = AssetCache::Error::NO_ERRORS;
+    Deque<uint32> packetsInFlight; // count of items that are sent including packet
+    uint32 itemsSent = 0;
+    uint32 responsesCount = 0;
+    while (resultCode == AssetCache::Error::NO_ERRORS && responsesCount < batchItems.size())
+    {
+        while (itemsSent < batchItems.size() && packetsInFlight.size() < chunksInFlight)
+        {
+            Vector<AssetCache::ItemChunkView> items;
+            uint64 packetSize = 0;
+            for (size_t next = itemsSent; next < batchItems.size() && items.size() < MAX_ITEMS_IN_BATCH; ++next)
             {
-                LockGuard<Mutex> guard(requestLocker);
-                request.Reset();
+                const Vector<uint8>& data = serializedData[batchItems[next]]->GetDataVector();
+                if (items.empty() == false && packetSize + data.size() > chunkSize)
+                {
+                    break;
+                }
+
+                items.push_back({ keys[batchItems[next]], AssetCache::ChunkView(data.data(), static_cast<uint32>(data.size())) });
+                packetSize += data.size();
             }
 
-            if (resultCode != AssetCache::Error::NO_ERRORS)
+            if (client.RequestAddBatch(items) == false)
             {
+                resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
                 break;
             }
+
+            itemsSent += static_cast<uint32>(items.size());
+            packetsInFlight.push_back(itemsSent);
         }
 
         if (resultCode == AssetCache::Error::NO_ERRORS)
         {
-            LockGuard<Mutex> guard(requestLocker);
-            if (getFilesRequest.chunksReceived == getFilesRequest.chunksOverall && getFilesRequest.bytesRemaining == 0)
+            resultCode = WaitChunkResponses(responsesCount);
+            while (packetsInFlight.empty() == false && packetsInFlight.front() <= responsesCount)
             {
-                ScopedPtr<DynamicMemoryFile> f(DynamicMemoryFile::Create(std::move(getFilesRequest.receivedData), File::OPEN | File::READ, "receivedData"));
-                value->Deserialize(f);
-
-                const AssetCache::CachedItemValue::Description& description = value->GetDescription();
-                Logger::Info("Data got from cache. Generated %s on machine %s (%s)",
-                             description.creationDate.c_str(),
-                             description.machineName.c_str(),
-                             description.comment.c_str());
+                packetsInFlight.pop_front();
+            }
+        }
+    }
+
+    SkipChunkResponses(itemsSent);
+
+    {
+        LockGuard<Mutex> guard(requestLocker);
+        batchRequest.Reset();
+        request.Reset();
+    }
+
+    for (size_t index = 0; index < keys.size(); ++index)
+    {
+        if (results[index] == AssetCache::Error::CODE_NOT_INITIALIZED)
+        {
+            results[index] = resultCode;
+        }
+    }
+
+    if (resultCode == AssetCache::Error::NO_ERRORS)
+    {
+        for (size_t index : itemsByChunks)
+        {
+            results[index] = AddToCacheSynchronously(keys[index], values[index]);
+        }
+    }
+
+    for (const std::pair<size_t, size_t>& duplicate : duplicates)
+    {
+        results[duplicate.first] = results[duplicate.second];
+    }
+
+    for (size_t index = 0; index < keys.size(); ++index)
+    {
+        // items that are added by single requests are counted by them
+        bool addedBySingleRequest = (resultCode == AssetCache::Error::NO_ERRORS && std::find(itemsByChunks.begin(), itemsByChunks.end(), index) != itemsByChunks.end());
+        if (addedBySingleRequest == false)
+        {
+            UpdateAddStats(results[index]);
+        }
+    }
+
+    return resultCode;
+}
+
+AssetCache::Error AssetCacheClient::RequestFromCacheSynchronously(const Vector<AssetCache::CacheItemKey>& keys, Vector<AssetCache::CachedItemValue>& values, Vector<AssetCache::Error>& results)
+{
+    using namespace AssetCacheClientDetails;
+
+    values.clear();
+    values.resize(keys.size());
+    results.assign(keys.size(), AssetCache::Error::CODE_NOT_INITIALIZED);
+
+    Vector<AssetCache::CacheItemKey> uniqueKeys;
+    Vector<std::pair<size_t, size_t>> duplicates; // index of item and index of the same key that is requested
+    {
+        LockGuard<Mutex> guard(requestLocker);
+        request = Request(AssetCache::PACKET_GET_BATCH_REQUEST);
+        batchRequest.Reset();
+        batchRequest.values = &values;
+        batchRequest.results = &results;
+
+        uniqueKeys.reserve(keys.size());
+        for (size_t index = 0; index < keys.size(); ++index)
+        {
+            auto inserted = batchRequest.itemIndices.emplace(keys[index], index);
+            if (inserted.second)
+            {
+                uniqueKeys.push_back(keys[index]);
             }
             else
             {
-                Logger::Error("Packet was not completely transferred. Chunks %u/%u, bytes remaining: %u",
-                              getFilesRequest.chunksReceived,
-                              getFilesRequest.chunksOverall,
-                              getFilesRequest.bytesRemaining);
-                resultCode = AssetCache::Error::CORRUPTED_DATA;
+                duplicates.emplace_back(index, inserted.first->second);
             }
         }
     }
 
-    { //process stats
-        ++stats.getRequestsCount;
-        switch (resultCode)
+    // all keys are sent at once: they are small, and server reads items from disk by limited number of workers.
+    // Server responds on every key by first chunk of item, or by empty chunk if item isn't found
+    AssetCache::Error resultCode = AssetCache::Error::NO_ERRORS;
+    uint32 keysRequested = 0;
+    for (size_t first = 0; first < uniqueKeys.size(); first += MAX_ITEMS_IN_BATCH)
+    {
+        size_t last = std::min(first + MAX_ITEMS_IN_BATCH, uniqueKeys.size());
+        if (client.RequestGetBatch(Vector<AssetCache::CacheItemKey>(uniqueKeys.begin() + first, uniqueKeys.begin() + last)) == false)
         {
-        case AssetCache::Error::NO_ERRORS:
-            ++stats.getRequestsSucceedCount;
-            break;
-        case AssetCache::Error::OPERATION_TIMEOUT:
-            ++stats.getRequestsTimeoutCount;
-            break;
-        case AssetCache::Error::NOT_FOUND_ON_SERVER:
-            ++stats.getRequestsNotFoundCount;
+            resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
             break;
+        }
+        keysRequested += static_cast<uint32>(last - first);
+    }
 
-        default:
-            ++stats.getRequestsFailedCount;
-            break;
+    uint32 responsesCount = 0;
+    while (resultCode == AssetCache::Error::NO_ERRORS && responsesCount < keysRequested)
+    {
+        resultCode = WaitChunkResponses(responsesCount);
+    }
+
+    SkipChunkResponses(keysRequested);
+
+    Vector<size_t> itemsByChunks;
+    {
+        LockGuard<Mutex> guard(requestLocker);
+        itemsByChunks = std::move(batchRequest.itemsByChunks);
+        batchRequest.Reset();
+        request.Reset();
+    }
+
+    for (size_t index = 0; index < keys.size(); ++index)
+    {
+        if (results[index] == AssetCache::Error::CODE_NOT_INITIALIZED)
+        {
+            results[index] = resultCode;
+        }
+    }
+
+    // first chunk of big item is requested again, so big items are received by single requests
+    if (resultCode == AssetCache::Error::NO_ERRORS)
+    {
+        for (size_t index : itemsByChunks)
+        {
+            results[index] = RequestFromCacheSynchronously(keys[index], &values[index]);
+        }
+    }
+
+    for (const std::pair<size_t, size_t>& duplicate : duplicates)
+    {
+        values[duplicate.first] = values[duplicate.second];
+        results[duplicate.first] = results[duplicate.second];
+    }
+
+    for (size_t index = 0; index < keys.size(); ++index)
+    {
+        // items that are received by single requests are counted by them
+        bool receivedBySingleRequest = (resultCode == AssetCache::Error::NO_ERRORS && std::find(itemsByChunks.begin(), itemsByChunks.end(), index) != itemsByChunks.end());
+        if (receivedBySingleRequest == false)
+        {
+            UpdateGetStats(results[index]);
         }
     }
 
@@ -354,6 +541,74 @@ AssetCache::Error AssetCacheClient::WaitRequest()
     return currentRequest.result;
 }
 
+AssetCache::Error AssetCacheClient::WaitChunkResponses(uint32& responsesCount)
+{
+    AssetCache::Error resultCode = WaitRequest();
+
+    LockGuard<Mutex> guard(requestLocker);
+    request.recieved = false; // several responses may be received during one wait, next wait is for the rest of them
+    responsesCount = request.responsesCount;
+    return resultCode;
+}
+
+void AssetCacheClient::SkipChunkResponses(uint32 requestsCount)
+{
+    // responses on chunks that were in flight when request has failed shouldn't be taken for responses on the next request
+    uint32 responsesCount = 0;
+    {
+        LockGuard<Mutex> guard(requestLocker);
+        responsesCount = request.responsesCount;
+    }
+
+    while (responsesCount < requestsCount)
+    {
+        AssetCache::Error resultCode = WaitChunkResponses(responsesCount);
+        if (resultCode == AssetCache::Error::OPERATION_TIMEOUT || resultCode == AssetCache::Error::CANNOT_CONNECT)
+        {
+            break;
+        }
+    }
+}
+
+void AssetCacheClient::UpdateAddStats(AssetCache::Error resultCode)
+{
+    ++stats.addRequestsCount;
+    switch (resultCode)
+    {
+    case AssetCache::Error::NO_ERRORS:
+        ++stats.addRequestsSucceedCount;
+        break;
+    case AssetCache::Error::OPERATION_TIMEOUT:
+        ++stats.addRequestsTimeoutCount;
+        break;
+
+    default:
+        ++stats.addRequestsFailedCount;
+        break;
+    }
+}
+
+void AssetCacheClient::UpdateGetStats(AssetCache::Error resultCode)
+{
+    ++stats.getRequestsCount;
+    switch (resultCode)
+    {
+    case AssetCache::Error::NO_ERRORS:
+        ++stats.getRequestsSucceedCount;
+        break;
+    case AssetCache::Error::OPERATION_TIMEOUT:
+        ++stats.getRequestsTimeoutCount;
+        break;
+    case AssetCache::Error::NOT_FOUND_ON_SERVER:
+        ++stats.getRequestsNotFoundCount;
+        break;
+
+    default:
+        ++stats.getRequestsFailedCount;
+        break;
+    }
+}
+
 void AssetCacheClient::OnServerStatusReceived()
 {
     LockGuard<Mutex> guard(requestLocker);
@@ -373,9 +628,24 @@ void AssetCacheClient::OnAddedToCache(const AssetCache::CacheItemKey& key, bool
 {
     LockGuard<Mutex> guard(requestLocker);
 
-    if ((request.requestID == AssetCache::PACKET_ADD_CHUNK_REQUEST) && request.key == key)
+    if (request.requestID == AssetCache::PACKET_ADD_BATCH_REQUEST)
     {
-        request.result = (added) ? AssetCache::Error::NO_ERRORS : AssetCache::Error::SERVER_ERROR;
+        auto found = batchRequest.itemIndices.find(key);
+        if (found != batchRequest.itemIndices.end())
+        {
+            ++request.responsesCount;
+            (*batchRequest.results)[found->second] = (added) ? AssetCache::Error::NO_ERRORS : AssetCache::Error::SERVER_ERROR;
+            request.recieved = true;
+            request.processingRequest = false;
+        }
+    }
+    else if ((request.requestID == AssetCache::PACKET_ADD_CHUNK_REQUEST) && request.key == key)
+    {
+        ++request.responsesCount;
+        if (added == false)
+        {
+            request.result = AssetCache::Error::SERVER_ERROR;
+        }
         request.recieved = true;
         request.processingRequest = false;
     }
@@ -385,12 +655,56 @@ void AssetCacheClient::OnAddedToCache(const AssetCache::CacheItemKey& key, bool
     }
 }
 
-void AssetCacheClient::OnReceivedFromCache(const AssetCache::CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData)
+void AssetCacheClient::OnReceivedFromCache(const AssetCache::CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const AssetCache::ChunkView& chunkData)
 {
     LockGuard<Mutex> guard(requestLocker);
 
-    if (request.requestID == AssetCache::PACKET_GET_CHUNK_REQUEST && request.key == key)
+    if (request.requestID == AssetCache::PACKET_GET_BATCH_REQUEST)
     {
+        auto found = batchRequest.itemIndices.find(key);
+        if (found != batchRequest.itemIndices.end())
+        {
+            ++request.responsesCount;
+            request.recieved = true;
+            request.processingRequest = false;
+
+            size_t index = found->second;
+            AssetCache::Error& result = (*batchRequest.results)[index];
+            if (dataSize == 0 || numOfChunks == 0 || chunkData.size == 0)
+            {
+                result = AssetCache::Error::NOT_FOUND_ON_SERVER;
+            }
+            else if (chunkNumber != 0)
+            {
+                Logger::Error("Wrong chunk: expected #0, received #%u", chunkNumber);
+                result = AssetCache::Error::WRONG_CHUNK;
+            }
+            else if (numOfChunks > 1)
+            {
+                batchRequest.itemsByChunks.push_back(index);
+            }
+            else if (chunkData.size != dataSize)
+            {
+                Logger::Error("Chunk #0 size %u differs from data size %llu", chunkData.size, dataSize);
+                result = AssetCache::Error::WRONG_CHUNK;
+            }
+            else
+            {
+                // item is deserialized from received packet without copying
+                ScopedPtr<File> file(new UnmanagedMemoryFile(chunkData.data, chunkData.size));
+                result = (*batchRequest.values)[index].Deserialize(file) ? AssetCache::Error::NO_ERRORS : AssetCache::Error::CORRUPTED_DATA;
+            }
+        }
+    }
+    else if (request.requestID == AssetCache::PACKET_GET_CHUNK_REQUEST && request.key == key)
+    {
+        ++request.responsesCount;
+        if (request.result != AssetCache::Error::NO_ERRORS)
+        { // request has already failed, chunks that were in flight are skipped
+            request.recieved = true;
+            return;
+        }
+
         if (getFilesRequest.chunksReceived == 0)
         {
             if (dataSize == 0 || numOfChunks == 0)
@@ -410,7 +724,7 @@ void AssetCacheClient::OnReceivedFromCache(const AssetCache::CacheItemKey& key,
             }
         }
 
-        if (chunkData.empty())
+        if (chunkData.size == 0)
         {
             request.result = AssetCache::Error::NOT_FOUND_ON_SERVER;
         }
@@ -419,19 +733,19 @@ void AssetCacheClient::OnReceivedFromCache(const AssetCache::CacheItemKey& key,
             Logger::Error("Wrong chunk: expected #%u, received #%u", getFilesRequest.chunksReceived, chunkNumber);
             request.result = AssetCache::Error::WRONG_CHUNK;
         }
-        else if (getFilesRequest.bytesRemaining < chunkData.size())
+        else if (getFilesRequest.bytesRemaining < chunkData.size)
         {
-            Logger::Error("Chunk #%u size is too big. Remaining bytes: %u, received chunk size: ", chunkNumber, getFilesRequest.bytesRemaining, chunkData.size());
+            Logger::Error("Chunk #%u size is too big. Remaining bytes: %u, received chunk size: ", chunkNumber, getFilesRequest.bytesRemaining, chunkData.size);
             request.result = AssetCache::Error::WRONG_CHUNK;
         }
         else
         {
             request.result = AssetCache::Error::NO_ERRORS;
-            Memcpy(getFilesRequest.receivedData.data() + getFilesRequest.bytesReceived, chunkData.data(), chunkData.size());
-            getFilesRequest.bytesReceived += chunkData.size();
-            getFilesRequest.bytesRemaining -= chunkData.size();
+            Memcpy(getFilesRequest.receivedData.data() + getFilesRequest.bytesReceived, chunkData.data, chunkData.size);
+            getFilesRequest.bytesReceived += chunkData.size;
+            getFilesRequest.bytesRemaining -= chunkData.size;
             ++(getFilesRequest.chunksReceived);
-            Logger::FrameworkDebug("Chunk #%u received: %u bytes. Overall received %u, remaining %u", chunkNumber, chunkData.size(), getFilesRequest.bytesReceived, getFilesRequest.bytesRemaining);
+            Logger::FrameworkDebug("Chunk #%u received: %u bytes. Overall received %u, remaining %u", chunkNumber, chunkData.size, getFilesRequest.bytesReceived, getFilesRequest.bytesRemaining);
         }
 
         request.recieved = true;
@@ -477,6 +791,7 @@ void AssetCacheClient::OnIncorrectPacketReceived(AssetCache::IncorrectPacketType
 {
     LockGuard<Mutex> guard(requestLocker);
     ++stats.incorrectPacketsCount;
+    ++request.responsesCount;
     request.recieved = true;
     request.processingRequest = false;
 
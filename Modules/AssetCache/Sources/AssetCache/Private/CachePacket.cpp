@@ -1,6 +1,7 @@
 #include "AssetCache/CachePacket.h"
 
 #include <FileSystem/DynamicMemoryFile.h>
+#include <FileSystem/UnmanagedMemoryFile.h>
 #include <Network/IChannel.h>
 #include <Logger/Logger.h>
 
@@ -9,7 +10,7 @@ namespace DAVA
 namespace AssetCache
 {
 const uint16 PACKET_HEADER = 0xACCA;
-const uint8 PACKET_VERSION = 3;
+const uint8 PACKET_VERSION = 5;
 
 Map<const uint8*, ScopedPtr<DynamicMemoryFile>> CachePacket::sendingPackets;
 
@@ -27,17 +28,17 @@ bool ReadFromBuffer(File* buffer, T& value)
     return (buffer->Read(&value) == sizeof(value));
 };
 
-bool ReadFromBuffer(File* buffer, Vector<uint8>& data, uint32 dataSize)
+// chunk is referred in place of buffer data without reading
+bool ReadFromBuffer(File* buffer, const uint8* bufferData, ChunkView& chunk, uint32 chunkSize)
 {
-    data.resize(dataSize);
-    if (dataSize > 0)
+    uint64 position = buffer->GetPos();
+    if (position + chunkSize > buffer->GetSize())
     {
-        return (buffer->Read(data.data(), dataSize) == dataSize);
-    }
-    else
-    {
-        return true;
+        return false;
     }
+
+    chunk = ChunkView(bufferData + position, chunkSize);
+    return true;
 };
 }
 
@@ -65,7 +66,7 @@ void CachePacket::PacketSent(const uint8* buffer, size_t length)
 
 CachePacket::CreateResult CachePacket::Create(const uint8* rawdata, uint32 length, std::unique_ptr<CachePacket>& packet)
 {
-    ScopedPtr<File> buffer(DynamicMemoryFile::Create(const_cast<uint8*>(rawdata), length, File::OPEN | File::READ));
+    ScopedPtr<File> buffer(new UnmanagedMemoryFile(rawdata, length));
 
     CachePacketHeader header;
     if (buffer->Read(&header) != sizeof(header))
@@ -91,6 +92,7 @@ CachePacket::CreateResult CachePacket::Create(const uint8* rawdata, uint32 lengt
         return ERR_INCORRECT_DATA;
     }
 
+    packet->receivedData = rawdata;
     bool loaded = packet->DeserializeFromBuffer(buffer);
     if (!loaded)
     {
@@ -128,6 +130,10 @@ std::unique_ptr<CachePacket> CachePacket::CreateByType(ePacketID type)
         return std::unique_ptr<CachePacket>(new ClearRequestPacket());
     case PACKET_CLEAR_RESPONSE:
         return std::unique_ptr<CachePacket>(new ClearResponsePacket());
+    case PACKET_GET_BATCH_REQUEST:
+        return std::unique_ptr<CachePacket>(new GetBatchRequestPacket());
+    case PACKET_ADD_BATCH_REQUEST:
+        return std::unique_ptr<CachePacket>(new AddBatchRequestPacket());
     default:
     {
         Logger::Error("[CachePacket::%s] Wrong packet type: %d", __FUNCTION__, type);
@@ -155,13 +161,13 @@ void CachePacket::WriteHeader(File* file) const
 }
 
 //////////////////////////////////////////////////////////////////////////
-DataChunkPacket::DataChunkPacket(ePacketID packetId, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData)
+DataChunkPacket::DataChunkPacket(ePacketID packetId, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData)
     : CachePacket(packetId, CREATE_SENDING_BUFFER)
 {
     WriteHeader(serializationBuffer);
 
     uint32 keySize = static_cast<uint32>(key.size());
-    uint32 chunkDataSize = static_cast<uint32>(chunkData.size());
+    uint32 chunkDataSize = chunkData.size;
 
     serializationBuffer->Write(key.data(), keySize);
     serializationBuffer->Write(&dataSize, sizeof(dataSize));
@@ -170,7 +176,7 @@ DataChunkPacket::DataChunkPacket(ePacketID packetId, const CacheItemKey& key, ui
     serializationBuffer->Write(&chunkDataSize, sizeof(chunkDataSize));
     if (chunkDataSize > 0)
     {
-        serializationBuffer->Write(chunkData.data(), chunkDataSize);
+        serializationBuffer->Write(chunkData.data, chunkDataSize);
     }
 }
 
@@ -189,11 +195,11 @@ bool DataChunkPacket::DeserializeFromBuffer(File* buffer)
             && ReadFromBuffer(buffer, numOfChunks)
             && ReadFromBuffer(buffer, chunkNumber)
             && ReadFromBuffer(buffer, chunkDataSize)
-            && ReadFromBuffer(buffer, chunkData, chunkDataSize));
+            && ReadFromBuffer(buffer, receivedData, chunkData, chunkDataSize));
 }
 
 //////////////////////////////////////////////////////////////////////////
-AddChunkRequestPacket::AddChunkRequestPacket(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData)
+AddChunkRequestPacket::AddChunkRequestPacket(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData)
     : DataChunkPacket(PACKET_ADD_CHUNK_REQUEST, key, dataSize, numOfChunks, chunkNumber, chunkData)
 {
 }
@@ -246,7 +252,7 @@ bool GetChunkRequestPacket::DeserializeFromBuffer(File* buffer)
 }
 
 //////////////////////////////////////////////////////////////////////////
-GetChunkResponsePacket::GetChunkResponsePacket(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData)
+GetChunkResponsePacket::GetChunkResponsePacket(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData)
     : DataChunkPacket(PACKET_GET_CHUNK_RESPONSE, key, dataSize, numOfChunks, chunkNumber, chunkData)
 {
 }
@@ -370,5 +376,102 @@ bool ClearResponsePacket::DeserializeFromBuffer(File* file)
     return ((file->Read(&cleared) == sizeof(cleared)));
 }
 
+//////////////////////////////////////////////////////////////////////////
+GetBatchRequestPacket::GetBatchRequestPacket(const Vector<CacheItemKey>& keys_)
+    : CachePacket(PACKET_GET_BATCH_REQUEST, CREATE_SENDING_BUFFER)
+{
+    WriteHeader(serializationBuffer);
+
+    uint32 keysCount = static_cast<uint32>(keys_.size());
+    serializationBuffer->Write(&keysCount, sizeof(keysCount));
+    for (const CacheItemKey& key : keys_)
+    {
+        serializationBuffer->Write(key.data(), static_cast<uint32>(key.size()));
+    }
+}
+
+GetBatchRequestPacket::GetBatchRequestPacket()
+    : CachePacket(PACKET_GET_BATCH_REQUEST, DO_NOT_CREATE_SENDING_BUFFER)
+{
+}
+
+bool GetBatchRequestPacket::DeserializeFromBuffer(File* buffer)
+{
+    using namespace CachePacketDetails;
+
+    uint32 keysCount = 0;
+    if (ReadFromBuffer(buffer, keysCount) == false || buffer->GetPos() + static_cast<uint64>(keysCount) * HASH_SIZE > buffer->GetSize())
+    {
+        return false;
+    }
+
+    keys.resize(keysCount);
+    for (CacheItemKey& key : keys)
+    {
+        if (ReadFromBuffer(buffer, key) == false)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+AddBatchRequestPacket::AddBatchRequestPacket(const Vector<ItemChunkView>& items_)
+    : CachePacket(PACKET_ADD_BATCH_REQUEST, CREATE_SENDING_BUFFER)
+{
+    WriteHeader(serializationBuffer);
+
+    uint32 itemsCount = static_cast<uint32>(items_.size());
+    serializationBuffer->Write(&itemsCount, sizeof(itemsCount));
+    for (const ItemChunkView& item : items_)
+    {
+        serializationBuffer->Write(item.key.data(), static_cast<uint32>(item.key.size()));
+        serializationBuffer->Write(&item.chunk.size, sizeof(item.chunk.size));
+        if (item.chunk.size > 0)
+        {
+            serializationBuffer->Write(item.chunk.data, item.chunk.size);
+        }
+    }
+}
+
+AddBatchRequestPacket::AddBatchRequestPacket()
+    : CachePacket(PACKET_ADD_BATCH_REQUEST, DO_NOT_CREATE_SENDING_BUFFER)
+{
+}
+
+bool AddBatchRequestPacket::DeserializeFromBuffer(File* buffer)
+{
+    using namespace CachePacketDetails;
+
+    uint32 itemsCount = 0;
+    if (ReadFromBuffer(buffer, itemsCount) == false || buffer->GetPos() + static_cast<uint64>(itemsCount) * (HASH_SIZE + sizeof(uint32)) > buffer->GetSize())
+    {
+        return false;
+    }
+
+    items.resize(itemsCount);
+    for (ItemChunkView& item : items)
+    {
+        uint32 chunkSize = 0;
+        if ((ReadFromBuffer(buffer, item.key) && ReadFromBuffer(buffer, chunkSize) && ReadFromBuffer(buffer, receivedData, item.chunk, chunkSize)) == false)
+        {
+            return false;
+        }
+
+        // chunk is referred in place, so it's skipped. Position beyond the last byte can't be set, it is reached by the last item only
+        uint64 nextItemPosition = buffer->GetPos() + chunkSize;
+        if (nextItemPosition < buffer->GetSize())
+        {
+            buffer->Seek(static_cast<int64>(nextItemPosition), File::SEEK_FROM_START);
+        }
+        else if (&item != &items.back())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 } //AssetCache
 } //DAVA
@@ -150,7 +150,7 @@ void CachedItemValue::Deserialize(KeyedArchive* archieve)
     validationDetails.filesDataSize = archieve->GetUInt64("ValidationDetails.filesDataSize");
 }
 
-bool CachedItemValue::Serialize(File* buffer) const
+bool CachedItemValue::Serialize(File* buffer, bool serializeData) const
 {
     DVASSERT(buffer);
 
@@ -169,7 +169,7 @@ bool CachedItemValue::Serialize(File* buffer) const
         uint32 dataSize = 0;
         const uint8* data = nullptr;
 
-        if (IsDataLoaded(entry.second))
+        if (serializeData && IsDataLoaded(entry.second))
         {
             data = entry.second->data();
             dataSize = static_cast<uint32>(entry.second->size());
@@ -96,7 +96,7 @@ bool ClientNetProxy::RequestServerStatus()
     return false;
 }
 
-bool ClientNetProxy::RequestAddNextChunk(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData)
+bool ClientNetProxy::RequestAddNextChunk(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData)
 {
     if (openedChannel)
     {
@@ -120,6 +120,28 @@ bool ClientNetProxy::RequestGetNextChunk(const CacheItemKey& key, uint32 chunkNu
     return false;
 }
 
+bool ClientNetProxy::RequestAddBatch(const Vector<ItemChunkView>& items)
+{
+    if (openedChannel)
+    {
+        AddBatchRequestPacket packet(items);
+        return packet.SendTo(openedChannel);
+    }
+
+    return false;
+}
+
+bool ClientNetProxy::RequestGetBatch(const Vector<CacheItemKey>& keys)
+{
+    if (openedChannel)
+    {
+        GetBatchRequestPacket packet(keys);
+        return packet.SendTo(openedChannel);
+    }
+
+    return false;
+}
+
 bool ClientNetProxy::RequestWarmingUp(const CacheItemKey& key)
 {
     //Logger::FrameworkDebug("Requesting warmup");
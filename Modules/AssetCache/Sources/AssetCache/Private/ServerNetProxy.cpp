@@ -15,6 +15,22 @@ namespace AssetCache
 // timeout of waiting for response from client.
 const uint32 CLIENT_PING_TIMEOUT_MS = 1 * 1000;
 
+void ServerNetProxyListener::OnAddBatchToCache(const std::shared_ptr<Net::IChannel>& channel, const Vector<ItemChunkView>& items)
+{
+    for (const ItemChunkView& item : items)
+    {
+        OnAddChunkToCache(channel, item.key, item.chunk.size, 1, 0, item.chunk);
+    }
+}
+
+void ServerNetProxyListener::OnBatchRequestedFromCache(const std::shared_ptr<Net::IChannel>& channel, const Vector<CacheItemKey>& keys)
+{
+    for (const CacheItemKey& key : keys)
+    {
+        OnChunkRequestedFromCache(channel, key, 0);
+    }
+}
+
 ServerNetProxy::ServerNetProxy(Dispatcher<Function<void()>>* dispatcher)
     : dispatcher(dispatcher)
 {
@@ -89,6 +105,18 @@ void ServerNetProxy::OnPacketReceived(const std::shared_ptr<Net::IChannel>& chan
                 listener->OnStatusRequested(channel);
                 return;
             }
+            case PACKET_GET_BATCH_REQUEST:
+            {
+                GetBatchRequestPacket* p = static_cast<GetBatchRequestPacket*>(packet.get());
+                listener->OnBatchRequestedFromCache(channel, p->keys);
+                return;
+            }
+            case PACKET_ADD_BATCH_REQUEST:
+            {
+                AddBatchRequestPacket* p = static_cast<AddBatchRequestPacket*>(packet.get());
+                listener->OnAddBatchToCache(channel, p->items);
+                return;
+            }
             default:
             {
                 Logger::Error("%s: Unexpected packet type: %d", __FUNCTION__, packet->type);
@@ -149,7 +177,7 @@ bool ServerNetProxy::SendCleared(const std::shared_ptr<Net::IChannel>& channel,
     return false;
 }
 
-bool ServerNetProxy::SendChunk(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData)
+bool ServerNetProxy::SendChunk(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData)
 {
     if (channel)
     {
@@ -4,6 +4,7 @@
 
 #include "AssetCache/Connection.h"
 #include "AssetCache/CacheItemKey.h"
+#include "AssetCache/ChunkSplitter.h"
 
 #include <Base/BaseTypes.h>
 #include <Network/IChannel.h>
@@ -19,7 +20,7 @@ class ServerNetProxyListener
 public:
     virtual ~ServerNetProxyListener() = default;
 
-    virtual void OnAddChunkToCache(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData) = 0;
+    virtual void OnAddChunkToCache(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData) = 0;
     virtual void OnChunkRequestedFromCache(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, uint32 chunkNumber) = 0;
     virtual void OnRemoveFromCache(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key) = 0;
     virtual void OnClearCache(const std::shared_ptr<Net::IChannel>& channel) = 0;
@@ -27,6 +28,10 @@ public:
     virtual void OnStatusRequested(const std::shared_ptr<Net::IChannel>& channel) = 0;
 
     virtual void OnChannelClosed(const std::shared_ptr<Net::IChannel>& channel, const char8* message){};
+
+    // batch requests are handled as sequence of single requests by default
+    virtual void OnAddBatchToCache(const std::shared_ptr<Net::IChannel>& channel, const Vector<ItemChunkView>& items);
+    virtual void OnBatchRequestedFromCache(const std::shared_ptr<Net::IChannel>& channel, const Vector<CacheItemKey>& keys);
 };
 
 class ServerNetProxy final : public Net::IChannelListener
@@ -42,11 +47,12 @@ public:
     void Disconnect();
 
     uint16 GetListenPort() const;
+    Dispatcher<Function<void()>>* GetDispatcher() const;
 
     bool SendAddedToCache(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, bool added);
     bool SendRemovedFromCache(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, bool removed);
     bool SendCleared(const std::shared_ptr<Net::IChannel>& channel, bool cleared);
-    bool SendChunk(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData);
+    bool SendChunk(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const ChunkView& chunkData);
     bool SendStatus(const std::shared_ptr<Net::IChannel>& channel);
 
     //Net::IChannelListener
@@ -73,6 +79,11 @@ inline uint16 ServerNetProxy::GetListenPort() const
     return listenPort;
 }
 
+inline Dispatcher<Function<void()>>* ServerNetProxy::GetDispatcher() const
+{
+    return dispatcher;
+}
+
 inline void ServerNetProxy::SetListener(ServerNetProxyListener* listener_)
 {
     listener = listener_;
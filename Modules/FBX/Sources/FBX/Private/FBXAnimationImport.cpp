@@ -1,5 +1,6 @@
 #include "FBXAnimationImport.h"
 
+#include "Animation/AnimationChannelEncoder.h"
 #include "Animation/AnimationClip.h"
 #include "FileSystem/File.h"
 #include "Logger/Logger.h"
@@ -84,14 +85,7 @@ void SaveAnimation(const FBXAnimationStackData& fbxStackAnimationData, const Fil
         //Track part
         uint8 target;
         uint8 pad0[3];
-
-        //Channel part
-        uint32 signature = AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE;
-        uint8 dimension = 0;
-        uint8 interpolation = 0;
-        uint16 compression = 0;
-        uint32 keyCount = 0;
-    } channelHeader;
+    } channelHeader = {};
 
     ScopedPtr<File> file(File::Create(filePath, File::CREATE | File::WRITE));
     if (file)
@@ -133,50 +127,33 @@ void SaveAnimation(const FBXAnimationStackData& fbxStackAnimationData, const Fil
                 if (!fbxChannelData.animationKeys.empty())
                 {
                     channelHeader.target = fbxChannelData.channel;
-                    channelHeader.keyCount = uint32(fbxChannelData.animationKeys.size());
+                    WriteToBuffer(animationData, &channelHeader);
 
+                    uint32 dimension = 0;
+                    AnimationChannel::eInterpolation interpolation = AnimationChannel::INTERPOLATION_LINEAR;
                     if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_POSITION)
                     {
-                        channelHeader.dimension = 3;
-                        channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
+                        dimension = 3;
                     }
                     else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
                     {
-                        channelHeader.dimension = 4;
-                        channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
+                        dimension = 4;
+                        interpolation = AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR;
                     }
                     else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_SCALE)
                     {
-                        channelHeader.dimension = 1;
-                        channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
+                        dimension = 1;
                     }
 
-                    WriteToBuffer(animationData, &channelHeader);
-
-                    for (uint32 k = 0; k < channelHeader.keyCount; ++k)
+                    Vector<AnimationChannelEncoder::Key> keys(fbxChannelData.animationKeys.size());
+                    for (size_t k = 0; k < keys.size(); ++k)
                     {
                         const FBXAnimationKey& key = fbxChannelData.animationKeys[k];
-
-                        float32 relativeKeyTime = key.time - fbxStackAnimationData.minTimeStamp;
-                        WriteToBuffer(animationData, &relativeKeyTime);
-
-                        if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_POSITION)
-                        {
-                            Vector3 position = Vector3(key.value.data);
-                            WriteToBuffer(animationData, &position);
-                        }
-                        else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
-                        {
-                            Quaternion orientation = Quaternion(key.value.data);
-                            orientation.Normalize();
-                            WriteToBuffer(animationData, &orientation);
-                        }
-                        else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_SCALE)
-                        {
-                            float32 scale = key.value.x;
-                            WriteToBuffer(animationData, &scale);
-                        }
+                        keys[k].time = key.time - fbxStackAnimationData.minTimeStamp;
+                        keys[k].value = key.value;
                     }
+
+                    AnimationChannelEncoder::WriteChannel(animationData, dimension, interpolation, keys);
                 }
             }
         }
@@ -188,7 +165,7 @@ void SaveAnimation(const FBXAnimationStackData& fbxStackAnimationData, const Fil
 
         AnimationClip::FileHeader header;
         header.signature = AnimationClip::ANIMATION_CLIP_FILE_SIGNATURE;
-        header.version = 1;
+        header.version = AnimationClip::ANIMATION_CLIP_FILE_VERSION;
         header.crc32 = CRC32::ForBuffer(animationData.data(), animationDataSize);
         header.dataSize = animationDataSize;
 
@@ -45,8 +45,9 @@ void ChannelListenerDispatched::OnChannelClosed(const std::shared_ptr<IChannel>&
 
 void ChannelListenerDispatched::OnPacketReceived(const std::shared_ptr<IChannel>& channel, const void* buffer, size_t length)
 {
-    Vector<uint8> bufferCopy(length);
-    Memcpy(bufferCopy.data(), buffer, length);
+    // buffer is copied once, copies of message made by dispatcher share it
+    std::shared_ptr<Vector<uint8>> bufferCopy = std::make_shared<Vector<uint8>>(length);
+    Memcpy(bufferCopy->data(), buffer, length);
 
     std::shared_ptr<IChannel> channelCopy = channel;
     std::weak_ptr<IChannelListener> targetObjectWeakCopy = targetObjectWeak;
@@ -56,7 +57,7 @@ void ChannelListenerDispatched::OnPacketReceived(const std::shared_ptr<IChannel>
         std::shared_ptr<IChannelListener> objectShared = targetObjectWeakCopy.lock();
         if (objectShared)
         {
-            objectShared->OnPacketReceived(channelCopy, bufferCopy.data(), bufferCopy.size());
+            objectShared->OnPacketReceived(channelCopy, bufferCopy->data(), bufferCopy->size());
         }
     };
     netEventsDispatcher->PostEvent(msg);
@@ -47,6 +47,7 @@ public:
     static const String Mode;
 
     static const String SaveNormals;
+    static const String FlatHierarchy;
     static const String CopyConverted;
     static const String SetCompression;
     static const String SetPreset;
@@ -41,6 +41,7 @@ const String OptionName::HDTextures("-hd");
 const String OptionName::Mode("-mode");
 
 const String OptionName::SaveNormals("-saveNormals");
+const String OptionName::FlatHierarchy("-flatHierarchy");
 const String OptionName::CopyConverted("-copyconverted");
 const String OptionName::SetCompression("-setcompression");
 const String OptionName::SetPreset("-setpreset");
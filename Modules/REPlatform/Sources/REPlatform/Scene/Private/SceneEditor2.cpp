@@ -186,7 +186,7 @@ SceneFileV2::eError SceneEditor2::LoadScene(const FilePath& path)
     return ret;
 }
 
-SceneFileV2::eError SceneEditor2::SaveScene(const FilePath& path, bool saveForGame /*= false*/)
+SceneFileV2::eError SceneEditor2::SaveScene(const FilePath& path, bool saveForGame /*= false*/, bool flatHierarchy /*= false*/)
 {
     using namespace DAVA;
     EditorLightSystem* lightSystem = GetSystem<EditorLightSystem>();
@@ -227,7 +227,7 @@ SceneFileV2::eError SceneEditor2::SaveScene(const FilePath& path, bool saveForGa
         landscapeEditorDrawSystem->ResetTileMaskTexture();
     }
 
-    SceneFileV2::eError err = Scene::SaveScene(path, saveForGame);
+    SceneFileV2::eError err = Scene::SaveScene(path, saveForGame, flatHierarchy);
     if (SceneFileV2::ERROR_NO_ERROR == err)
     {
         curScenePath = path;
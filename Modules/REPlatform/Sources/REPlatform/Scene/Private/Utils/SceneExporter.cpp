@@ -43,7 +43,7 @@ const uint32 EXPORTER_VERSION = 1;
 const uint32 LINKS_PARSER_VERSION = 2;
 const String LINKS_NAME = "links.txt";
 
-void CalculateSceneKey(const FilePath& scenePathname, const String& sceneLink, AssetCache::CacheItemKey& key, uint32 optimize)
+void CalculateSceneKey(const FilePath& scenePathname, const String& sceneLink, AssetCache::CacheItemKey& key, uint32 optimize, uint32 flatHierarchy)
 {
     using namespace DAVA;
 
@@ -64,6 +64,7 @@ void CalculateSceneKey(const FilePath& scenePathname, const String& sceneLink, A
         params += Format("ExporterVersion: %u", EXPORTER_VERSION);
         params += Format("LinksParserVersion: %u", LINKS_PARSER_VERSION);
         params += Format("Optimized: %u", optimize);
+        params += Format("FlatHierarchy: %u", flatHierarchy);
         for (int32 linkType = 0; linkType < SceneExporter::OBJECT_COUNT; ++linkType)
         {
             params += Format("LinkType: %d", linkType);
@@ -78,6 +79,8 @@ void CalculateSceneKey(const FilePath& scenePathname, const String& sceneLink, A
 
 namespace SceneExporterDetails
 {
+const size_t SCENES_CACHE_BATCH_SIZE = 32;
+
 bool SaveExportedObjects(const FilePath& linkPathname, const Vector<SceneExporter::ExportedObjectCollection>& exportedObjects)
 {
     using namespace DAVA;
@@ -470,10 +473,23 @@ bool SceneExporter::ExportSceneObject(const ExportedObject& sceneObject)
     AssetCache::CacheItemKey cacheKey;
     if (cacheClient != nullptr && cacheClient->IsConnected())
     { //request Scene from cache
-        SceneExporterCache::CalculateSceneKey(scenePathname, sceneObject.relativePathname, cacheKey, static_cast<uint32>(exportingParams.optimizeOnExport));
-
         AssetCache::CachedItemValue retrievedData;
-        AssetCache::Error requested = cacheClient->RequestFromCacheSynchronously(cacheKey, &retrievedData);
+        AssetCache::Error requested = AssetCache::Error::CODE_NOT_INITIALIZED;
+
+        auto requestedScene = requestedScenes.find(sceneObject.relativePathname);
+        if (requestedScene != requestedScenes.end())
+        { // scene was requested by RequestScenesFromCache together with others
+            cacheKey = requestedScene->second.key;
+            retrievedData = requestedScene->second.value;
+            requested = requestedScene->second.result;
+            requestedScenes.erase(requestedScene);
+        }
+        else
+        {
+            SceneExporterCache::CalculateSceneKey(scenePathname, sceneObject.relativePathname, cacheKey, static_cast<uint32>(exportingParams.optimizeOnExport), static_cast<uint32>(exportingParams.flatHierarchy));
+            requested = cacheClient->RequestFromCacheSynchronously(cacheKey, &retrievedData);
+        }
+
         if (requested == AssetCache::Error::NO_ERRORS)
         {
             bool exportedToFolder = retrievedData.ExportToFolder(outSceneFolder);
@@ -513,18 +529,89 @@ bool SceneExporter::ExportSceneObject(const ExportedObject& sceneObject)
         value.UpdateValidationData();
         value.SetDescription(cacheItemDescription);
 
-        AssetCache::Error added = cacheClient->AddToCacheSynchronously(cacheKey, value);
-        if (added == AssetCache::Error::NO_ERRORS)
+        // data is loaded into value, so temporary files may be deleted before scene is sent
+        exportedSceneKeys.push_back(cacheKey);
+        exportedSceneValues.push_back(value);
+        exportedScenePaths.push_back(scenePathname);
+        if (exportedSceneKeys.size() >= SceneExporterDetails::SCENES_CACHE_BATCH_SIZE)
         {
-            Logger::Info("%s - added to cache", scenePathname.GetAbsolutePathname().c_str());
+            AddExportedScenesToCache();
         }
-        else
+    }
+
+    return sceneExported;
+}
+
+void SceneExporter::RequestScenesFromCache(const ExportedObjectCollection& scenes, size_t begin, size_t end)
+{
+    requestedScenes.clear();
+    if (cacheClient == nullptr || cacheClient->IsConnected() == false)
+    {
+        return;
+    }
+
+    Vector<AssetCache::CacheItemKey> keys;
+    Vector<const String*> names;
+    for (size_t i = begin; i < end; ++i)
+    {
+        FilePath scenePathname = exportingParams.dataSourceFolder + scenes[i].relativePathname;
+        if (alreadyExportedScenes.count(scenePathname) == 0)
         {
-            Logger::Info("%s - failed to add to cache (%s)", scenePathname.GetAbsolutePathname().c_str(), AssetCache::ErrorToString(added).c_str());
+            keys.emplace_back();
+            SceneExporterCache::CalculateSceneKey(scenePathname, scenes[i].relativePathname, keys.back(), static_cast<uint32>(exportingParams.optimizeOnExport), static_cast<uint32>(exportingParams.flatHierarchy));
+            names.push_back(&scenes[i].relativePathname);
         }
     }
 
-    return sceneExported;
+    if (keys.empty())
+    {
+        return;
+    }
+
+    Vector<AssetCache::CachedItemValue> values;
+    Vector<AssetCache::Error> results;
+    AssetCache::Error requested = cacheClient->RequestFromCacheSynchronously(keys, values, results);
+    if (requested != AssetCache::Error::NO_ERRORS)
+    {
+        Logger::Info("Failed to request %u scenes from cache (%s)", static_cast<uint32>(keys.size()), AssetCache::ErrorToString(requested).c_str());
+    }
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        CachedScene& requestedScene = requestedScenes[*names[i]];
+        requestedScene.key = keys[i];
+        requestedScene.value = values[i];
+        requestedScene.result = results[i];
+    }
+}
+
+void SceneExporter::AddExportedScenesToCache()
+{
+    if (exportedSceneKeys.empty())
+    {
+        return;
+    }
+
+    if (cacheClient != nullptr && cacheClient->IsConnected())
+    {
+        Vector<AssetCache::Error> results;
+        cacheClient->AddToCacheSynchronously(exportedSceneKeys, exportedSceneValues, results);
+        for (size_t i = 0; i < exportedScenePaths.size(); ++i)
+        {
+            if (results[i] == AssetCache::Error::NO_ERRORS)
+            {
+                Logger::Info("%s - added to cache", exportedScenePaths[i].GetAbsolutePathname().c_str());
+            }
+            else
+            {
+                Logger::Info("%s - failed to add to cache (%s)", exportedScenePaths[i].GetAbsolutePathname().c_str(), AssetCache::ErrorToString(results[i]).c_str());
+            }
+        }
+    }
+
+    exportedSceneKeys.clear();
+    exportedSceneValues.clear();
+    exportedScenePaths.clear();
 }
 
 bool SceneExporter::ExportSceneFileInternal(const FilePath& scenePathname, const FilePath& outScenePathname, Vector<SceneExporter::ExportedObjectCollection>& exportedObjects)
@@ -980,7 +1067,7 @@ bool SceneExporter::ExportScene(Scene* scene, const FilePath& scenePathname, con
 
     // save scene to new place
     FilePath tempSceneName = FilePath::CreateWithNewExtension(scenePathname, ".exported.sc2");
-    scene->SaveScene(tempSceneName, exportingParams.optimizeOnExport);
+    scene->SaveScene(tempSceneName, exportingParams.optimizeOnExport, exportingParams.flatHierarchy);
 
     FileSystem* fileSystem = GetEngineContext()->fileSystem;
     bool moved = fileSystem->MoveFile(tempSceneName, outScenePathname, true);
@@ -1015,6 +1102,11 @@ bool SceneExporter::ExportObjects(const ExportedObjectCollection& exportedObject
     const ExportedObjectCollection& scenes = objectsToExport[eExportedObjectType::OBJECT_SCENE];
     for (uint32 i = 0; i < static_cast<uint32>(scenes.size()); ++i)
     {
+        if (i % SceneExporterDetails::SCENES_CACHE_BATCH_SIZE == 0)
+        {
+            RequestScenesFromCache(scenes, i, Min(scenes.size(), i + SceneExporterDetails::SCENES_CACHE_BATCH_SIZE));
+        }
+
         const ExportedObject& sceneObj = scenes[i];
         CreateFoldersStructure(sceneObj);
 
@@ -1046,6 +1138,8 @@ bool SceneExporter::ExportObjects(const ExportedObjectCollection& exportedObject
             }
         }
     }
+    requestedScenes.clear();
+    AddExportedScenesToCache();
 
     //export objects
     for (int32 i = eExportedObjectType::OBJECT_SCENE + 1; i < eExportedObjectType::OBJECT_COUNT; ++i)
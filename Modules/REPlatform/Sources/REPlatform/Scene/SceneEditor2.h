@@ -56,7 +56,7 @@ public:
 
     // save/load
     SceneFileV2::eError LoadScene(const FilePath& path) override;
-    SceneFileV2::eError SaveScene(const FilePath& pathname, bool saveForGame = false) override;
+    SceneFileV2::eError SaveScene(const FilePath& pathname, bool saveForGame = false, bool flatHierarchy = false) override;
     SceneFileV2::eError SaveScene();
     bool Export(const SceneExporter::Params& exportingParams);
 
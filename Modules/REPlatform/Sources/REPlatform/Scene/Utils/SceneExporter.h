@@ -77,6 +77,7 @@ public:
         String filenamesTag;
 
         bool optimizeOnExport = false;
+        bool flatHierarchy = false;
     };
 
     SceneExporter() = default;
@@ -97,6 +98,8 @@ private:
     bool CopyObject(const ExportedObject& object);
 
     bool ExportSceneFileInternal(const FilePath& scenePathname, const FilePath& outScenePathname, Vector<ExportedObjectCollection>& exportedObjects); //without cache
+    void RequestScenesFromCache(const ExportedObjectCollection& scenes, size_t begin, size_t end);
+    void AddExportedScenesToCache();
     bool ExportDescriptor(TextureDescriptor& descriptor, const Params::Output& output);
     bool SplitCompressedFile(const TextureDescriptor& descriptor, eGPUFamily gpu, const Params::Output& output) const;
     void CollectObjects(Scene* scene, Vector<ExportedObjectCollection>& exportedObjects);
@@ -108,6 +111,18 @@ private:
     AssetCacheClient* cacheClient = nullptr;
     AssetCache::CachedItemValue::Description cacheItemDescription;
 
+    // scenes are requested from cache and added to it by batches
+    struct CachedScene
+    {
+        AssetCache::CacheItemKey key;
+        AssetCache::CachedItemValue value;
+        AssetCache::Error result = AssetCache::Error::CODE_NOT_INITIALIZED;
+    };
+    UnorderedMap<String, CachedScene> requestedScenes; // by relative pathname
+    Vector<AssetCache::CacheItemKey> exportedSceneKeys;
+    Vector<AssetCache::CachedItemValue> exportedSceneValues;
+    Vector<FilePath> exportedScenePaths;
+
     SceneExporter::Params exportingParams;
     Vector<ExportedObjectCollection> objectsToExport;
 
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Base/BaseTypes.h>
+
+/**
+    Synthetic hilly heightmap, used to compare landscape ray casts and height queries through min-max height pyramid
+    with per-quad walk over heightmap points, as line-of-sight and projectile checks did before.
+    Rays are a mix of vertical drops, long grazing lines of sight and random directions.
+*/
+struct LandscapeRayCastBenchmarkParams
+{
+    DAVA::uint32 heightmapSize = 1024;
+    DAVA::float32 landscapeSize = 2048.f;
+    DAVA::float32 landscapeHeight = 200.f;
+    DAVA::uint32 raysCount = 20000;
+    DAVA::uint32 heightQueriesCount = 1000000;
+};
+
+struct LandscapeRayCastBenchmarkResult
+{
+    DAVA::uint32 hitsCount = 0;
+    DAVA::uint32 mismatchesCount = 0; ///< Rays which results of walk and pyramid differ
+    DAVA::float32 buildMs = 0.f; ///< Time of building pyramid over the whole heightmap
+    DAVA::float32 quadWalkMs = 0.f; ///< Time of casting all rays by walking heightmap quads along every ray
+    DAVA::float32 pyramidSerialMs = 0.f; ///< Time of casting all rays through the pyramid on the calling thread
+    DAVA::float32 pyramidParallelMs = 0.f; ///< Time of casting all rays through the pyramid on job workers
+    DAVA::float32 heightPointsNs = 0.f; ///< Average time of height query interpolating `Heightmap::GetPoint` results
+    DAVA::float32 heightPyramidNs = 0.f; ///< Average time of height query through the pyramid
+    DAVA::float32 speedup = 0.f;
+};
+
+class LandscapeRayCastBenchmark final
+{
+public:
+    /** Build benchmark heightmap, run all ray cast and height query modes on it and log results. */
+    static LandscapeRayCastBenchmarkResult Run(const LandscapeRayCastBenchmarkParams& params = LandscapeRayCastBenchmarkParams());
+};
@@ -0,0 +1,280 @@
+#include "LandscapeRayCastBenchmark.h"
+
+#include <Base/ScopedPtr.h>
+#include <Logger/Logger.h>
+#include <Math/AABBox3.h>
+#include <Math/MathConstants.h>
+#include <Math/Ray.h>
+#include <Render/Highlevel/Heightmap.h>
+#include <Render/Highlevel/HeightmapPyramid.h>
+#include <Time/SystemTimer.h>
+
+#include <cmath>
+
+namespace LandscapeRayCastBenchmarkDetails
+{
+using namespace DAVA;
+
+const float32 SIGHT_HEIGHT = 2.f;
+
+float32 RandomFloat(uint32& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float32>(state >> 8) / static_cast<float32>(1 << 24);
+}
+
+void FillHeightmap(Heightmap* heightmap)
+{
+    uint32 size = static_cast<uint32>(heightmap->Size());
+    uint16* data = heightmap->Data();
+    uint32 state = 1;
+    for (uint32 y = 0; y < size; ++y)
+    {
+        for (uint32 x = 0; x < size; ++x)
+        {
+            float32 fx = static_cast<float32>(x) / static_cast<float32>(size);
+            float32 fy = static_cast<float32>(y) / static_cast<float32>(size);
+            float32 hills = 0.5f + 0.25f * std::sin(fx * 9.f) * std::cos(fy * 7.f) + 0.15f * std::sin((fx + fy) * 31.f);
+            float32 noise = 0.02f * RandomFloat(state);
+            data[y * size + x] = static_cast<uint16>(Clamp(hills + noise, 0.f, 1.f) * static_cast<float32>(Heightmap::MAX_VALUE));
+        }
+    }
+}
+
+/** Height query interpolating four `Heightmap::GetPoint` results, as `Landscape::GetHeightAtPoint` did. */
+float32 GetHeightFromPoints(const Heightmap* heightmap, const AABBox3& bbox, const Vector3& point)
+{
+    float32 hmSize = static_cast<float32>(heightmap->Size());
+    float32 fx = hmSize * (point.x - bbox.min.x) / (bbox.max.x - bbox.min.x);
+    float32 fy = hmSize * (point.y - bbox.min.y) / (bbox.max.y - bbox.min.y);
+    uint16 x = static_cast<uint16>(fx);
+    uint16 y = static_cast<uint16>(fy);
+
+    Vector3 h00 = heightmap->GetPoint(x, y, bbox);
+    Vector3 h01 = heightmap->GetPoint(x + 1, y, bbox);
+    Vector3 h10 = heightmap->GetPoint(x, y + 1, bbox);
+    Vector3 h11 = heightmap->GetPoint(x + 1, y + 1, bbox);
+
+    float32 dx = fx - static_cast<float32>(x);
+    float32 dy = fy - static_cast<float32>(y);
+    float32 h0 = h00.z * (1.0f - dx) + h01.z * dx;
+    float32 h1 = h10.z * (1.0f - dx) + h11.z * dx;
+    return h0 * (1.0f - dy) + h1 * dy;
+}
+
+/** Walk heightmap quads under the ray one by one from the landscape box entry, testing both triangles of every quad. */
+bool WalkQuads(const Heightmap* heightmap, const AABBox3& bbox, const Ray3& ray, float32& resultT)
+{
+    float32 tMin = 0.f;
+    float32 tMax = 0.f;
+    if (!Intersection::RayBox(Ray3Optimized(ray.origin, ray.direction), bbox, tMin, tMax))
+    {
+        return false;
+    }
+    tMin = Max(tMin, 0.f);
+    if (tMin > tMax)
+    {
+        return false;
+    }
+
+    int32 size = heightmap->Size();
+    Vector2 quadSize((bbox.max.x - bbox.min.x) / static_cast<float32>(size), (bbox.max.y - bbox.min.y) / static_cast<float32>(size));
+    Vector3 start = ray.ToPoint(tMin);
+    int32 pos[2] = { Clamp(static_cast<int32>((start.x - bbox.min.x) / quadSize.x), 0, size - 1),
+                     Clamp(static_cast<int32>((start.y - bbox.min.y) / quadSize.y), 0, size - 1) };
+
+    int32 step[2];
+    float32 nextCrossingT[2];
+    float32 deltaT[2];
+    for (int32 axis = 0; axis < 2; ++axis)
+    {
+        float32 direction = ray.direction.data[axis];
+        step[axis] = (direction >= 0.f) ? 1 : -1;
+        if (direction != 0.f)
+        {
+            float32 boundary = bbox.min.data[axis] + static_cast<float32>(pos[axis] + (step[axis] > 0 ? 1 : 0)) * quadSize.data[axis];
+            nextCrossingT[axis] = (boundary - ray.origin.data[axis]) / direction;
+            deltaT[axis] = quadSize.data[axis] / std::abs(direction);
+        }
+        else
+        {
+            nextCrossingT[axis] = FLOAT_MAX;
+            deltaT[axis] = FLOAT_MAX;
+        }
+    }
+
+    float32 closestT = FLOAT_MAX;
+    for (;;)
+    {
+        uint16 x = static_cast<uint16>(pos[0]);
+        uint16 y = static_cast<uint16>(pos[1]);
+        Vector3 p00 = heightmap->GetPoint(x, y, bbox);
+        Vector3 p01 = heightmap->GetPoint(x, y + 1, bbox);
+        Vector3 p10 = heightmap->GetPoint(x + 1, y, bbox);
+        Vector3 p11 = heightmap->GetPoint(x + 1, y + 1, bbox);
+
+        float32 t = 0.f;
+        if (Intersection::RayTriangle(ray, p00, p01, p11, t, 0.f, closestT))
+        {
+            closestT = t;
+        }
+        if (Intersection::RayTriangle(ray, p00, p11, p10, t, 0.f, closestT))
+        {
+            closestT = t;
+        }
+
+        // quads are visited in order of distance, so the first hit is the closest one
+        if (closestT < FLOAT_MAX)
+        {
+            resultT = closestT;
+            return true;
+        }
+
+        int32 axis = (nextCrossingT[0] < nextCrossingT[1]) ? 0 : 1;
+        if (nextCrossingT[axis] > tMax)
+        {
+            return false;
+        }
+        pos[axis] += step[axis];
+        if (pos[axis] < 0 || pos[axis] >= size)
+        {
+            return false;
+        }
+        nextCrossingT[axis] += deltaT[axis];
+    }
+}
+
+Vector<Ray3> CreateRays(const HeightmapPyramid& pyramid, const AABBox3& bbox, const LandscapeRayCastBenchmarkParams& params)
+{
+    auto randomPoint = [&bbox](uint32& state, float32 heightAboveGround, const HeightmapPyramid& pyramid) {
+        Vector3 point(bbox.min.x + (bbox.max.x - bbox.min.x) * RandomFloat(state), bbox.min.y + (bbox.max.y - bbox.min.y) * RandomFloat(state), 0.f);
+        pyramid.GetHeightAtPoint(point, point.z);
+        point.z += heightAboveGround;
+        return point;
+    };
+
+    Vector<Ray3> rays;
+    rays.reserve(params.raysCount);
+    uint32 state = 17;
+    for (uint32 i = 0; i < params.raysCount; ++i)
+    {
+        switch (i % 3)
+        {
+        case 0: // projectile dropped from above
+        {
+            Vector3 origin = randomPoint(state, params.landscapeHeight * RandomFloat(state), pyramid);
+            rays.emplace_back(origin, Vector3(0.f, 0.f, -1.f));
+            break;
+        }
+        case 1: // line of sight between two units standing on the ground
+        {
+            Vector3 origin = randomPoint(state, SIGHT_HEIGHT, pyramid);
+            Vector3 target = randomPoint(state, SIGHT_HEIGHT, pyramid);
+            rays.emplace_back(origin, target - origin);
+            break;
+        }
+        default: // shot in random direction
+        {
+            Vector3 origin = randomPoint(state, SIGHT_HEIGHT + 10.f * RandomFloat(state), pyramid);
+            Vector3 direction(RandomFloat(state) - 0.5f, RandomFloat(state) - 0.5f, -0.2f * RandomFloat(state));
+            rays.emplace_back(origin, direction);
+            break;
+        }
+        }
+    }
+    return rays;
+}
+
+float32 ToMs(uint64 us)
+{
+    return static_cast<float32>(us) / 1000.f;
+}
+}
+
+LandscapeRayCastBenchmarkResult LandscapeRayCastBenchmark::Run(const LandscapeRayCastBenchmarkParams& params)
+{
+    using namespace DAVA;
+    using namespace LandscapeRayCastBenchmarkDetails;
+
+    LandscapeRayCastBenchmarkResult result;
+
+    ScopedPtr<Heightmap> heightmap(new Heightmap(static_cast<int32>(params.heightmapSize)));
+    FillHeightmap(heightmap);
+    float32 halfSize = params.landscapeSize / 2.f;
+    AABBox3 bbox(Vector3(-halfSize, -halfSize, 0.f), Vector3(halfSize, halfSize, params.landscapeHeight));
+
+    HeightmapPyramid pyramid;
+    uint64 startUs = SystemTimer::GetUs();
+    pyramid.Build(heightmap, bbox);
+    result.buildMs = ToMs(SystemTimer::GetUs() - startUs);
+
+    Vector<Ray3> rays = CreateRays(pyramid, bbox, params);
+    uint32 raysCount = static_cast<uint32>(rays.size());
+    Vector<float32> walkResults(raysCount, FLOAT_MAX);
+    Vector<float32> serialResults(raysCount);
+    Vector<float32> parallelResults(raysCount);
+
+    startUs = SystemTimer::GetUs();
+    for (uint32 i = 0; i < raysCount; ++i)
+    {
+        WalkQuads(heightmap, bbox, rays[i], walkResults[i]);
+    }
+    result.quadWalkMs = ToMs(SystemTimer::GetUs() - startUs);
+
+    startUs = SystemTimer::GetUs();
+    result.hitsCount = pyramid.RayCast(rays.data(), raysCount, serialResults.data(), false);
+    result.pyramidSerialMs = ToMs(SystemTimer::GetUs() - startUs);
+
+    startUs = SystemTimer::GetUs();
+    pyramid.RayCast(rays.data(), raysCount, parallelResults.data(), true);
+    result.pyramidParallelMs = ToMs(SystemTimer::GetUs() - startUs);
+
+    for (uint32 i = 0; i < raysCount; ++i)
+    {
+        float32 walkT = walkResults[i];
+        float32 pyramidT = serialResults[i];
+        bool sameHit = (walkT == pyramidT) || ((walkT < FLOAT_MAX) && (pyramidT < FLOAT_MAX) && std::abs(walkT - pyramidT) <= 1e-3f * Max(1.f, walkT));
+        if (!sameHit || serialResults[i] != parallelResults[i])
+        {
+            ++result.mismatchesCount;
+        }
+    }
+
+    Vector<Vector3> points(params.heightQueriesCount);
+    uint32 state = 29;
+    for (Vector3& point : points)
+    {
+        point = Vector3(bbox.min.x + params.landscapeSize * RandomFloat(state), bbox.min.y + params.landscapeSize * RandomFloat(state), 0.f);
+    }
+
+    // sums keep queries from being optimized out
+    float32 pointsSum = 0.f;
+    startUs = SystemTimer::GetUs();
+    for (const Vector3& point : points)
+    {
+        pointsSum += GetHeightFromPoints(heightmap, bbox, point);
+    }
+    uint64 pointsUs = SystemTimer::GetUs() - startUs;
+
+    float32 pyramidSum = 0.f;
+    startUs = SystemTimer::GetUs();
+    for (const Vector3& point : points)
+    {
+        float32 height = 0.f;
+        pyramid.GetHeightAtPoint(point, height);
+        pyramidSum += height;
+    }
+    uint64 pyramidUs = SystemTimer::GetUs() - startUs;
+
+    float32 queriesCount = static_cast<float32>(Max(params.heightQueriesCount, 1u));
+    result.heightPointsNs = static_cast<float32>(pointsUs) * 1000.f / queriesCount;
+    result.heightPyramidNs = static_cast<float32>(pyramidUs) * 1000.f / queriesCount;
+    result.speedup = (result.pyramidParallelMs > 0.f) ? result.quadWalkMs / result.pyramidParallelMs : 0.f;
+
+    Logger::Info("LandscapeRayCastBenchmark: heightmap %u, %u rays, %u hits, %u mismatches, pyramid build %.3f ms, quad walk %.3f ms, pyramid serial %.3f ms, pyramid parallel %.3f ms, speedup x%.2f",
+                 params.heightmapSize, raysCount, result.hitsCount, result.mismatchesCount, result.buildMs, result.quadWalkMs, result.pyramidSerialMs, result.pyramidParallelMs, result.speedup);
+    Logger::Info("LandscapeRayCastBenchmark: %u height queries, points %.1f ns, pyramid %.1f ns, average heights %.3f / %.3f",
+                 params.heightQueriesCount, result.heightPointsNs, result.heightPyramidNs, pointsSum / queriesCount, pyramidSum / queriesCount);
+
+    return result;
+}
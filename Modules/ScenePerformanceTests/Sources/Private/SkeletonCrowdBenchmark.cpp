@@ -0,0 +1,141 @@
+#include "SkeletonCrowdBenchmark.h"
+
+#include <Base/ScopedPtr.h>
+#include <Logger/Logger.h>
+#include <Render/Highlevel/RenderBatch.h>
+#include <Render/Highlevel/SkinnedMesh.h>
+#include <Scene3D/Scene.h>
+#include <Scene3D/Entity.h>
+#include <Scene3D/Components/RenderComponent.h>
+#include <Scene3D/Components/SkeletonComponent.h>
+#include <Scene3D/Components/TransformComponent.h>
+#include <Scene3D/Systems/SkeletonSystem.h>
+#include <Time/SystemTimer.h>
+
+namespace SkeletonCrowdBenchmarkDetails
+{
+using namespace DAVA;
+
+Vector<SkeletonComponent::Joint> CreateJoints(const SkeletonCrowdBenchmarkParams& params)
+{
+    Vector<SkeletonComponent::Joint> joints(params.jointsPerCharacter);
+    Vector<Vector3> objectSpacePositions(params.jointsPerCharacter);
+    for (uint32 i = 0; i < params.jointsPerCharacter; ++i)
+    {
+        SkeletonComponent::Joint& joint = joints[i];
+        joint.name = FastName(Format("joint%u", i));
+        joint.uid = joint.name;
+        joint.bbox = AABBox3(Vector3(), 0.2f);
+
+        bool chainStart = (i == 0) || (params.jointsPerChain <= 1) || ((i - 1) % params.jointsPerChain == 0);
+        joint.parentIndex = (i == 0) ? SkeletonComponent::INVALID_JOINT_INDEX : (chainStart ? 0 : i - 1);
+
+        Vector3 offset = (i == 0) ? Vector3() : Vector3(0.f, 0.f, 0.25f);
+        if (chainStart && i != 0)
+        {
+            offset = Vector3(0.1f * static_cast<float32>((i - 1) / params.jointsPerChain), 0.f, 0.f);
+        }
+        objectSpacePositions[i] = (i == 0) ? offset : objectSpacePositions[joint.parentIndex] + offset;
+
+        // bind transforms are in parent space, inverse ones are in object space
+        joint.bindTransform = Matrix4::MakeTranslation(offset);
+        joint.bindTransformInv = Matrix4::MakeTranslation(-objectSpacePositions[i]);
+    }
+    return joints;
+}
+
+SkinnedMesh* CreateSkinnedMesh(RenderBatch* batch, const SkeletonCrowdBenchmarkParams& params)
+{
+    // joint targets are enough to make skeleton system write skinning data, mesh itself is never rendered
+    SkinnedMesh::JointTargets targets;
+    for (uint32 i = 0; i < params.jointsPerCharacter && i < SkinnedMesh::MAX_TARGET_JOINTS; ++i)
+    {
+        targets.push_back(static_cast<int32>(i));
+    }
+
+    SkinnedMesh* mesh = new SkinnedMesh();
+    mesh->SetJointTargets(batch, targets);
+    return mesh;
+}
+
+void AnimateCrowd(const Vector<SkeletonComponent*>& skeletons, uint32 frame)
+{
+    float32 phase = static_cast<float32>(frame) * 0.05f;
+    for (size_t c = 0; c < skeletons.size(); ++c)
+    {
+        SkeletonComponent* skeleton = skeletons[c];
+        for (uint32 j = 0, count = skeleton->GetJointsCount(); j < count; ++j)
+        {
+            skeleton->SetJointOrientation(j, Quaternion::MakeRotationFastY(0.3f * sinf(phase + static_cast<float32>(c + j) * 0.1f)));
+        }
+    }
+}
+
+float32 MeasureMode(Scene* scene, const Vector<SkeletonComponent*>& skeletons, bool parallel, JointKernels::eImplementation implementation, const SkeletonCrowdBenchmarkParams& params)
+{
+    SkeletonSystem* skeletonSystem = scene->skeletonSystem;
+    skeletonSystem->SetParallelUpdate(parallel);
+    skeletonSystem->SetKernelsImplementation(implementation);
+
+    uint64 totalUs = 0;
+    for (uint32 frame = 0; frame < params.framesCount; ++frame)
+    {
+        AnimateCrowd(skeletons, frame);
+
+        uint64 startUs = SystemTimer::GetUs();
+        skeletonSystem->Process(0.f);
+        totalUs += SystemTimer::GetUs() - startUs;
+    }
+
+    return static_cast<float32>(totalUs) / 1000.f / std::max(params.framesCount, 1u);
+}
+}
+
+SkeletonCrowdBenchmarkResult SkeletonCrowdBenchmark::Run(const SkeletonCrowdBenchmarkParams& params)
+{
+    using namespace DAVA;
+    using namespace SkeletonCrowdBenchmarkDetails;
+
+    SkeletonCrowdBenchmarkResult result;
+
+    ScopedPtr<Scene> scene(new Scene());
+    bool initialParallel = scene->skeletonSystem->GetParallelUpdate();
+    JointKernels::eImplementation initialImplementation = scene->skeletonSystem->GetKernelsImplementation();
+
+    ScopedPtr<RenderBatch> batch(new RenderBatch());
+    Vector<SkeletonComponent::Joint> joints = CreateJoints(params);
+    Vector<SkeletonComponent*> skeletons;
+    for (uint32 i = 0; i < params.charactersCount; ++i)
+    {
+        ScopedPtr<Entity> character(new Entity());
+        character->GetComponent<TransformComponent>()->SetLocalTranslation(Vector3(static_cast<float32>(i % 32), static_cast<float32>(i / 32), 0.f));
+
+        ScopedPtr<SkinnedMesh> mesh(CreateSkinnedMesh(batch, params));
+        character->AddComponent(new RenderComponent(mesh));
+
+        SkeletonComponent* skeleton = new SkeletonComponent();
+        skeleton->SetJoints(joints);
+        character->AddComponent(skeleton);
+
+        scene->AddNode(character);
+        skeletons.push_back(skeleton);
+        result.jointsCount += skeleton->GetJointsCount();
+    }
+
+    // skeletons are built on the first update, it shouldn't be measured
+    scene->skeletonSystem->Process(0.f);
+
+    JointKernels::eImplementation bestImplementation = JointKernels::GetBestImplementation();
+    result.serialScalarMs = MeasureMode(scene, skeletons, false, JointKernels::eImplementation::SCALAR, params);
+    result.serialSimdMs = MeasureMode(scene, skeletons, false, bestImplementation, params);
+    result.parallelSimdMs = MeasureMode(scene, skeletons, true, bestImplementation, params);
+    result.speedup = (result.parallelSimdMs > 0.f) ? result.serialScalarMs / result.parallelSimdMs : 0.f;
+
+    scene->skeletonSystem->SetParallelUpdate(initialParallel);
+    scene->skeletonSystem->SetKernelsImplementation(initialImplementation);
+
+    Logger::Info("SkeletonCrowdBenchmark: %u characters, %u joints, serial scalar %.3f ms, serial simd %.3f ms, parallel simd %.3f ms, speedup x%.2f",
+                 params.charactersCount, result.jointsCount, result.serialScalarMs, result.serialSimdMs, result.parallelSimdMs, result.speedup);
+
+    return result;
+}
@@ -0,0 +1,109 @@
+#include "TransformBenchmark.h"
+
+#include <Base/ScopedPtr.h>
+#include <Logger/Logger.h>
+#include <Math/Transform.h>
+#include <Scene3D/Scene.h>
+#include <Scene3D/Entity.h>
+#include <Scene3D/Components/TransformComponent.h>
+#include <Scene3D/Components/SingleComponents/TransformSingleComponent.h>
+#include <Scene3D/Systems/TransformSystem.h>
+#include <Time/SystemTimer.h>
+
+namespace TransformBenchmarkDetails
+{
+using namespace DAVA;
+
+void AddChildren(Entity* parent, uint32 depth, const TransformBenchmarkParams& params, uint32& nodesCount)
+{
+    if (depth == 0)
+    {
+        return;
+    }
+
+    for (uint32 i = 0; i < params.childrenPerNode; ++i)
+    {
+        ScopedPtr<Entity> child(new Entity());
+        child->GetComponent<TransformComponent>()->SetLocalTranslation(Vector3(0.5f * (i + 1), 0.f, 1.f));
+        parent->AddNode(child);
+        ++nodesCount;
+
+        AddChildren(child, depth - 1, params, nodesCount);
+    }
+}
+
+float32 MeasureMode(Scene* scene, const Vector<Entity*>& animatedRoots, TransformSystem::eUpdateMode mode, const TransformBenchmarkParams& params, uint32& updatedNodes)
+{
+    TransformSystem* transformSystem = scene->transformSystem;
+    transformSystem->SetUpdateMode(mode);
+
+    uint64 totalUs = 0;
+    for (uint32 frame = 0; frame < params.framesCount; ++frame)
+    {
+        float32 phase = static_cast<float32>(frame) * 0.1f;
+        for (size_t i = 0; i < animatedRoots.size(); ++i)
+        {
+            Quaternion rotation;
+            rotation.Construct(Vector3(0.f, 0.f, 1.f), phase + static_cast<float32>(i));
+            animatedRoots[i]->GetComponent<TransformComponent>()->SetLocalRotation(rotation);
+        }
+
+        uint64 startUs = SystemTimer::GetUs();
+        transformSystem->Process(0.f);
+        totalUs += SystemTimer::GetUs() - startUs;
+
+        updatedNodes = static_cast<uint32>(transformSystem->GetLastUpdatedNodesCount());
+        scene->transformSingleComponent->Clear();
+    }
+
+    return static_cast<float32>(totalUs) / 1000.f / std::max(params.framesCount, 1u);
+}
+}
+
+TransformBenchmarkResult TransformBenchmark::Run(const TransformBenchmarkParams& params)
+{
+    using namespace DAVA;
+    using namespace TransformBenchmarkDetails;
+
+    TransformBenchmarkResult result;
+
+    ScopedPtr<Scene> scene(new Scene());
+    TransformSystem::eUpdateMode initialMode = scene->transformSystem->GetUpdateMode();
+
+    Vector<Entity*> animatedRoots;
+    uint32 animatedEvery = (params.animatedFraction > 0.f) ? std::max(static_cast<uint32>(1.f / params.animatedFraction), 1u) : 0;
+    for (uint32 i = 0; i < params.rootsCount; ++i)
+    {
+        ScopedPtr<Entity> root(new Entity());
+        root->GetComponent<TransformComponent>()->SetLocalTranslation(Vector3(static_cast<float32>(i % 256), static_cast<float32>(i / 256), 0.f));
+        scene->AddNode(root);
+        ++result.nodesCount;
+
+        AddChildren(root, params.depth, params, result.nodesCount);
+
+        if (animatedEvery != 0 && (i % animatedEvery) == 0)
+        {
+            animatedRoots.push_back(root);
+        }
+    }
+
+    // initial placement of all nodes shouldn't be measured
+    scene->transformSystem->Process(0.f);
+    scene->transformSingleComponent->Clear();
+
+    uint32 walkUpdated = 0;
+    uint32 levelsUpdated = 0;
+    result.hierarchyWalkMs = MeasureMode(scene, animatedRoots, TransformSystem::eUpdateMode::HIERARCHY_WALK, params, walkUpdated);
+    result.levelArraysMs = MeasureMode(scene, animatedRoots, TransformSystem::eUpdateMode::LEVEL_ARRAYS, params, levelsUpdated);
+    DVASSERT(walkUpdated == levelsUpdated);
+
+    result.updatedNodesPerFrame = levelsUpdated;
+    result.speedup = (result.levelArraysMs > 0.f) ? result.hierarchyWalkMs / result.levelArraysMs : 0.f;
+
+    scene->transformSystem->SetUpdateMode(initialMode);
+
+    Logger::Info("TransformBenchmark: %u nodes, %u updated per frame, hierarchy walk %.3f ms, level arrays %.3f ms, speedup x%.2f",
+                 result.nodesCount, result.updatedNodesPerFrame, result.hierarchyWalkMs, result.levelArraysMs, result.speedup);
+
+    return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Base/BaseTypes.h>
+
+/**
+    Synthetic crowd of skinned characters, used to compare SkeletonSystem update modes.
+    Every frame all joints of every character are rotated, so whole skeletons and skinning data are recalculated.
+*/
+struct SkeletonCrowdBenchmarkParams
+{
+    DAVA::uint32 charactersCount = 500;
+    DAVA::uint32 jointsPerCharacter = 64;
+    DAVA::uint32 jointsPerChain = 8; ///< Joints are organized in chains growing from the root, like spine and limbs
+    DAVA::uint32 framesCount = 100;
+};
+
+struct SkeletonCrowdBenchmarkResult
+{
+    DAVA::uint32 jointsCount = 0;
+    DAVA::float32 serialScalarMs = 0.f; ///< Average SkeletonSystem::Process time on the calling thread with scalar kernels
+    DAVA::float32 serialSimdMs = 0.f; ///< Average SkeletonSystem::Process time on the calling thread with the best kernels
+    DAVA::float32 parallelSimdMs = 0.f; ///< Average SkeletonSystem::Process time on job workers with the best kernels
+    DAVA::float32 speedup = 0.f;
+};
+
+class SkeletonCrowdBenchmark final
+{
+public:
+    /** Build benchmark scene, run all update modes on it and log results. Should be called from the main thread. */
+    static SkeletonCrowdBenchmarkResult Run(const SkeletonCrowdBenchmarkParams& params = SkeletonCrowdBenchmarkParams());
+};
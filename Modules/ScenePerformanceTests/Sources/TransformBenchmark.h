@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Base/BaseTypes.h>
+
+/**
+    Synthetic scene of animated prop hierarchies, used to compare TransformSystem update modes.
+    Every frame local transforms of `animatedFraction` of roots are changed, so whole their subtrees are recalculated.
+*/
+struct TransformBenchmarkParams
+{
+    DAVA::uint32 rootsCount = 20000;
+    DAVA::uint32 childrenPerNode = 3;
+    DAVA::uint32 depth = 2;
+    DAVA::uint32 framesCount = 100;
+    DAVA::float32 animatedFraction = 1.f;
+};
+
+struct TransformBenchmarkResult
+{
+    DAVA::uint32 nodesCount = 0;
+    DAVA::uint32 updatedNodesPerFrame = 0;
+    DAVA::float32 hierarchyWalkMs = 0.f; ///< Average TransformSystem::Process time of depth-first walk
+    DAVA::float32 levelArraysMs = 0.f; ///< Average TransformSystem::Process time of level arrays update
+    DAVA::float32 speedup = 0.f;
+};
+
+class TransformBenchmark final
+{
+public:
+    /** Build benchmark scene, run both update modes on it and log results. Should be called from the main thread. */
+    static TransformBenchmarkResult Run(const TransformBenchmarkParams& params = TransformBenchmarkParams());
+};
@@ -25,6 +25,8 @@ const String ResourcePacker2D::INTERNAL_LIBPSD_VERSION = "0.0.1";
 
 namespace ResourcePacker2DDetails
 {
+const size_t CACHE_ADD_BATCH_SIZE = 32;
+
 List<FilePath> ReadIgnoresList(const FilePath& ignoresListPath, const FilePath& baseDir)
 {
     List<FilePath> result;
@@ -228,6 +230,7 @@ void ResourcePacker2D::PackResources(const Vector<eGPUFamily>& forGPUs)
     }
 
     PackRecursively(inputGfxDirectory, outputGfxDirectory, packAlgorithms);
+    FlushFilesToCache();
 
     // Put latest md5 after convertation
     RecalculateDirMD5(outputGfxDirectory, processDirectoryPath + gfxDirName + ".md5", true);
@@ -794,30 +797,57 @@ bool ResourcePacker2D::AddFilesToCache(const AssetCache::CacheItemKey& key, cons
         value.UpdateValidationData();
         value.SetDescription(cacheItemDescription);
 
-        AssetCache::Error addError = cacheClient->AddToCacheSynchronously(key, value);
-        if (addError == AssetCache::Error::NO_ERRORS)
+        addedKeys.push_back(key);
+        addedValues.push_back(std::move(value));
+        addedPaths.push_back(addedDataRelativePath);
+        if (addedKeys.size() >= ResourcePacker2DDetails::CACHE_ADD_BATCH_SIZE)
         {
-            Logger::Info("%s - added to cache", addedDataRelativePath.c_str());
-            return true;
+            FlushFilesToCache();
+        }
+        return true;
+    }
+    else
+    {
+        Logger::Info("%s - empty folder", addedDataRelativePath.c_str());
+    }
+
+    return false;
+
+#endif
+}
+
+void ResourcePacker2D::FlushFilesToCache()
+{
+#ifndef __DAVAENGINE_WIN_UAP__
+    if (addedKeys.empty())
+    {
+        return;
+    }
+
+    Vector<AssetCache::Error> results;
+    cacheClient->AddToCacheSynchronously(addedKeys, addedValues, results);
+    for (size_t i = 0; i < addedPaths.size(); ++i)
+    {
+        AssetCache::Error itemError = results[i];
+        if (itemError == AssetCache::Error::NO_ERRORS)
+        {
+            Logger::Info("%s - added to cache", addedPaths[i].c_str());
         }
         else
         {
-            String errorInfo = AssetCache::ErrorToString(addError);
-            if (addError == AssetCache::Error::OPERATION_TIMEOUT)
+            String errorInfo = AssetCache::ErrorToString(itemError);
+            if (itemError == AssetCache::Error::OPERATION_TIMEOUT)
             {
                 errorInfo.append(Format(" (%u ms)", cacheClient->GetTimeoutMs()));
             }
 
-            Logger::Info("%s - can't add to cache: %s", addedDataRelativePath.c_str(), errorInfo.c_str());
+            Logger::Info("%s - can't add to cache: %s", addedPaths[i].c_str(), errorInfo.c_str());
         }
     }
-    else
-    {
-        Logger::Info("%s - empty folder", addedDataRelativePath.c_str());
-    }
-
-    return false;
 
+    addedKeys.clear();
+    addedValues.clear();
+    addedPaths.clear();
 #endif
 }
 
@@ -61,6 +61,7 @@ private:
 
     bool GetFilesFromCache(const AssetCache::CacheItemKey& key, const FilePath& inputPath, const FilePath& outputPath);
     bool AddFilesToCache(const AssetCache::CacheItemKey& key, const FilePath& inputPath, const FilePath& outputPath);
+    void FlushFilesToCache();
 
 public:
     FilePath inputGfxDirectory;
@@ -82,6 +83,11 @@ private:
     AssetCacheClient* cacheClient = nullptr;
     AssetCache::CachedItemValue::Description cacheItemDescription;
 
+    // packed folders are added to cache by batches
+    Vector<AssetCache::CacheItemKey> addedKeys;
+    Vector<AssetCache::CachedItemValue> addedValues;
+    Vector<String> addedPaths;
+
     String tag;
     FilePath ignoresListPath;
     List<FilePath> ignoredFiles;
@@ -13,7 +13,16 @@
 #include <Logger/Logger.h>
 
 const DAVA::String CacheDB::DB_FILE_NAME = "cache.dat";
-const DAVA::uint32 CacheDB::VERSION = 1;
+const DAVA::String CacheDB::JOURNAL_FILE_NAME = "cache.journal";
+const DAVA::uint32 CacheDB::VERSION = 2;
+const DAVA::uint32 CacheDB::LEGACY_VERSION = 1;
+const DAVA::uint64 CacheDB::MIN_JOURNAL_RECORDS_TO_COMPACT = 4096;
+
+namespace CacheDBDetails
+{
+const DAVA::char8 SNAPSHOT_SIGNATURE[4] = { 'A', 'C', 'D', 'B' };
+const DAVA::char8 JOURNAL_SIGNATURE[4] = { 'A', 'C', 'D', 'J' };
+}
 
 CacheDB::CacheDB(CacheDBOwner& _owner)
     : owner(_owner)
@@ -48,6 +57,7 @@ void CacheDB::UpdateSettings(const DAVA::FilePath& folderPath, const DAVA::uint6
 
         cacheRootFolder = newCacheRootFolder;
         cacheSettings = cacheRootFolder + DB_FILE_NAME;
+        journalPath = cacheRootFolder + JOURNAL_FILE_NAME;
 
         Load();
         fullCacheChanged = true;
@@ -87,25 +97,89 @@ void CacheDB::Load()
     DVASSERT(fastCache.empty());
     DVASSERT(fullCache.empty());
 
+    occupiedSize = 0;
+    journalGeneration = 0;
+    journalRecordsCount = 0;
+    compactionRequired = true;
+
     DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(cacheSettings, DAVA::File::OPEN | DAVA::File::READ));
-    if (!file)
+    if (file)
     {
-        return;
+        DAVA::char8 signature[4] = {};
+        file->Read(signature, sizeof(signature));
+        file->Seek(0, DAVA::File::SEEK_FROM_START);
+
+        if (Memcmp(signature, CacheDBDetails::SNAPSHOT_SIGNATURE, sizeof(signature)) == 0)
+        {
+            // snapshot isn't rewritten if it's loaded completely and journal can be continued
+            compactionRequired = (LoadSnapshot(file) == false || ReplayJournal() == false);
+        }
+        else
+        {
+            LoadLegacySnapshot(file);
+        }
+    }
+
+    if (compactionRequired == false)
+    {
+        journal = DAVA::File::Create(journalPath, DAVA::File::APPEND | DAVA::File::WRITE);
+        compactionRequired = !journal;
     }
 
+    NotifySizeChanged();
+    dbStateChanged = compactionRequired;
+}
+
+bool CacheDB::LoadSnapshot(DAVA::File* file)
+{
+    SnapshotHeader header;
+    if (file->Read(&header, sizeof(header)) != sizeof(header))
+    {
+        DAVA::Logger::Error("[CacheDB::%s] Can't read header of %s", __FUNCTION__, cacheSettings.GetStringValue().c_str());
+        return false;
+    }
+
+    if (header.version != VERSION)
+    {
+        DVASSERT(false, "cachedb file version is changed. Versions load functions should be implemented");
+        return false;
+    }
+
+    fullCache.reserve(static_cast<size_t>(header.itemsCount));
+    journalGeneration = header.generation;
+
+    // items are stored in access order
+    for (DAVA::uint64 index = 0; index < header.itemsCount; ++index)
+    {
+        DAVA::AssetCache::CacheItemKey key;
+        ServerCacheEntry entry;
+        if (file->Read(key.data(), static_cast<DAVA::uint32>(key.size())) != key.size() || entry.Deserialize(file) == false)
+        {
+            DAVA::Logger::Error("[CacheDB::%s] Can't read item %llu of %llu", __FUNCTION__, index, header.itemsCount);
+            return false;
+        }
+
+        InsertInIndex(key, std::move(entry));
+    }
+
+    return true;
+}
+
+bool CacheDB::LoadLegacySnapshot(DAVA::File* file)
+{
     DAVA::ScopedPtr<DAVA::KeyedArchive> header(new DAVA::KeyedArchive());
     header->Load(file);
 
     if (header->GetString("signature") != "cache")
     {
         DAVA::Logger::Error("[CacheDB::%s] Wrong signature %s", __FUNCTION__, header->GetString("signature").c_str());
-        return;
+        return false;
     }
 
-    if (header->GetUInt32("version") != VERSION)
+    if (header->GetUInt32("version") != LEGACY_VERSION)
     {
         DVASSERT(false, "cachedb file version is changed. Versions load functions should be implemented");
-        return;
+        return false;
     }
 
     DAVA::uint64 cacheSize = header->GetUInt64("itemsCount");
@@ -115,27 +189,121 @@ void CacheDB::Load()
     if (!cache->Load(file))
     {
         DAVA::Logger::Error("[%s] Can't load cache file", __FUNCTION__);
-        return;
+        return false;
     }
 
-    occupiedSize = 0;
+    DAVA::Vector<std::pair<DAVA::AssetCache::CacheItemKey, ServerCacheEntry>> items;
+    items.reserve(static_cast<size_t>(cacheSize));
     for (DAVA::uint64 index = 0; index < cacheSize; ++index)
     {
         DAVA::KeyedArchive* itemArchieve = cache->GetArchive(DAVA::Format("item_%d", index));
         DVASSERT(nullptr != itemArchieve);
 
+        items.emplace_back();
+        items.back().first.Deserialize(itemArchieve);
+        items.back().second.Deserialize(itemArchieve);
+    }
+
+    // legacy snapshot isn't ordered, so access order is restored by timestamps
+    std::sort(items.begin(), items.end(), [](const std::pair<DAVA::AssetCache::CacheItemKey, ServerCacheEntry>& left, const std::pair<DAVA::AssetCache::CacheItemKey, ServerCacheEntry>& right)
+              {
+                  return left.second.GetTimestamp() < right.second.GetTimestamp();
+              });
+
+    for (auto& item : items)
+    {
+        InsertInIndex(item.first, std::move(item.second));
+    }
+
+    return true;
+}
+
+bool CacheDB::ReplayJournal()
+{
+    DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(journalPath, DAVA::File::OPEN | DAVA::File::READ));
+    if (!file)
+    {
+        return false;
+    }
+
+    JournalHeader header;
+    if (file->Read(&header, sizeof(header)) != sizeof(header)
+        || Memcmp(header.signature, CacheDBDetails::JOURNAL_SIGNATURE, sizeof(header.signature)) != 0
+        || header.version != VERSION)
+    {
+        DAVA::Logger::Error("[CacheDB::%s] Wrong header of %s", __FUNCTION__, journalPath.GetStringValue().c_str());
+        return false;
+    }
+
+    if (header.generation != journalGeneration)
+    {
+        // journal was started for another snapshot, its changes are already in loaded one
+        return false;
+    }
+
+    while (true)
+    {
+        eJournalRecord type;
+        if (file->Read(&type, sizeof(type)) != sizeof(type))
+        {
+            return true;
+        }
+
         DAVA::AssetCache::CacheItemKey key;
-        key.Deserialize(itemArchieve);
+        if (file->Read(key.data(), static_cast<DAVA::uint32>(key.size())) != key.size())
+        {
+            break;
+        }
 
-        ServerCacheEntry entry;
-        entry.Deserialize(itemArchieve);
+        if (type == JOURNAL_INSERT)
+        {
+            ServerCacheEntry entry;
+            if (entry.Deserialize(file) == false)
+            {
+                break;
+            }
+
+            auto found = fullCache.find(key);
+            if (found != fullCache.end())
+            {
+                RemoveFromIndex(found);
+            }
+            InsertInIndex(key, std::move(entry));
+        }
+        else if (type == JOURNAL_REMOVE)
+        {
+            auto found = fullCache.find(key);
+            if (found != fullCache.end())
+            {
+                RemoveFromIndex(found);
+            }
+        }
+        else if (type == JOURNAL_ACCESS)
+        {
+            DAVA::uint64 timestamp = 0;
+            if (file->Read(&timestamp, sizeof(timestamp)) != sizeof(timestamp))
+            {
+                break;
+            }
 
-        occupiedSize += entry.GetValue().GetSize();
-        fullCache[key] = std::move(entry);
+            auto found = fullCache.find(key);
+            if (found != fullCache.end())
+            {
+                found->second.SetTimestamp(timestamp);
+                accessList.MoveToBack(&found->second);
+            }
+        }
+        else
+        {
+            break;
+        }
+
+        ++journalRecordsCount;
     }
 
-    NotifySizeChanged();
-    dbStateChanged = false;
+    // last record was interrupted by crash, journal can't be continued
+    DAVA::Logger::Warning("[CacheDB::%s] Journal %s is damaged after %llu records", __FUNCTION__, journalPath.GetStringValue().c_str(), journalRecordsCount);
+    return false;
 }
 
 void CacheDB::Unload()
@@ -148,65 +316,138 @@ void CacheDB::Unload()
     }
 
     fastCache.clear();
+    accessList.Clear();
     fullCache.clear();
+    journal.reset();
     occupiedSize = 0;
     NotifySizeChanged();
 }
 
 void CacheDB::Save()
 {
+    if (cacheRootFolder.IsEmpty())
+    {
+        return;
+    }
+
+    if (compactionRequired || journalRecordsCount > DAVA::Max(static_cast<DAVA::uint64>(fullCache.size()), MIN_JOURNAL_RECORDS_TO_COMPACT))
+    {
+        Compact();
+    }
+    else
+    {
+        journal->Flush();
+    }
+
+    dbStateChanged = false;
+    lastSaveTime = DAVA::SystemTimer::GetMs();
+}
+
+void CacheDB::Compact()
+{
+    journal.reset();
+    compactionRequired = true;
+
     DAVA::FileSystem::Instance()->CreateDirectory(cacheRootFolder, true);
 
-    DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(cacheSettings, DAVA::File::CREATE | DAVA::File::WRITE));
+    const DAVA::FilePath tempPath = cacheRootFolder + (DB_FILE_NAME + ".tmp");
+    DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(tempPath, DAVA::File::CREATE | DAVA::File::WRITE));
     if (!file)
     {
-        DAVA::Logger::Error("[CacheDB::%s] Cannot create file %s", __FUNCTION__, cacheSettings.GetStringValue().c_str());
+        DAVA::Logger::Error("[CacheDB::%s] Cannot create file %s", __FUNCTION__, tempPath.GetStringValue().c_str());
         return;
     }
 
-    DAVA::ScopedPtr<DAVA::KeyedArchive> header(new DAVA::KeyedArchive());
-    header->SetString("signature", "cache");
-    header->SetUInt32("version", VERSION);
-    header->SetUInt64("itemsCount", fullCache.size());
-    header->Save(file);
+    SnapshotHeader header;
+    Memcpy(header.signature, CacheDBDetails::SNAPSHOT_SIGNATURE, sizeof(header.signature));
+    header.version = VERSION;
+    header.generation = journalGeneration + 1;
+    header.itemsCount = fullCache.size();
 
-    DAVA::ScopedPtr<DAVA::KeyedArchive> cache(new DAVA::KeyedArchive());
-    DAVA::uint64 index = 0;
-    for (auto& item : fullCache)
+    bool written = (file->Write(&header, sizeof(header)) == sizeof(header));
+    for (ServerCacheEntry* entry = accessList.Front(); written && entry != nullptr; entry = accessList.Next(entry))
+    {
+        const DAVA::AssetCache::CacheItemKey& key = accessList.GetKey(entry);
+        written = (file->Write(key.data(), static_cast<DAVA::uint32>(key.size())) == key.size()) && entry->Serialize(file);
+    }
+    written = written && file->Flush();
+    file.reset();
+
+    if (!written || !DAVA::FileSystem::Instance()->MoveFile(tempPath, cacheSettings, true))
     {
-        DAVA::ScopedPtr<DAVA::KeyedArchive> itemArchieve(new DAVA::KeyedArchive());
-        item.first.Serialize(itemArchieve);
-        item.second.Serialize(itemArchieve);
+        DAVA::Logger::Error("[CacheDB::%s] Cannot write file %s", __FUNCTION__, cacheSettings.GetStringValue().c_str());
+        DAVA::FileSystem::Instance()->DeleteFile(tempPath);
+        return;
+    }
+    journalGeneration = header.generation;
+    journalRecordsCount = 0;
 
-        cache->SetArchive(DAVA::Format("item_%d", index++), itemArchieve);
+    journal = DAVA::File::Create(journalPath, DAVA::File::CREATE | DAVA::File::WRITE);
+    if (!journal)
+    {
+        DAVA::Logger::Error("[CacheDB::%s] Cannot create file %s", __FUNCTION__, journalPath.GetStringValue().c_str());
+        return;
     }
-    cache->Save(file);
 
-    dbStateChanged = false;
-    lastSaveTime = DAVA::SystemTimer::GetMs();
+    JournalHeader journalHeader;
+    Memcpy(journalHeader.signature, CacheDBDetails::JOURNAL_SIGNATURE, sizeof(journalHeader.signature));
+    journalHeader.version = VERSION;
+    journalHeader.generation = journalGeneration;
+    if (journal->Write(&journalHeader, sizeof(journalHeader)) != sizeof(journalHeader) || journal->Flush() == false)
+    {
+        DAVA::Logger::Error("[CacheDB::%s] Cannot write file %s", __FUNCTION__, journalPath.GetStringValue().c_str());
+        journal.reset();
+        return;
+    }
+
+    compactionRequired = false;
+}
+
+void CacheDB::WriteJournalRecord(eJournalRecord type, const DAVA::AssetCache::CacheItemKey& key, const ServerCacheEntry* entry)
+{
+    if (!journal)
+    {
+        return; // all changes will get into snapshot
+    }
+
+    bool written = (journal->Write(&type, sizeof(type)) == sizeof(type)) && (journal->Write(key.data(), static_cast<DAVA::uint32>(key.size())) == key.size());
+    if (written && type == JOURNAL_INSERT)
+    {
+        written = entry->Serialize(journal);
+    }
+    else if (written && type == JOURNAL_ACCESS)
+    {
+        DAVA::uint64 timestamp = entry->GetTimestamp();
+        written = (journal->Write(&timestamp, sizeof(timestamp)) == sizeof(timestamp));
+    }
+
+    if (written)
+    {
+        ++journalRecordsCount;
+    }
+    else
+    {
+        DAVA::Logger::Error("[CacheDB::%s] Cannot write file %s", __FUNCTION__, journalPath.GetStringValue().c_str());
+        journal.reset();
+        compactionRequired = true;
+    }
 }
 
 void CacheDB::ReduceFullCacheToSize(DAVA::uint64 toSize)
 {
     while (occupiedSize > toSize)
     {
-        const auto& found = std::min_element(fullCache.begin(), fullCache.end(), [](const CacheMap::value_type& left, const CacheMap::value_type& right) -> bool
-                                             {
-                                                 return left.second.GetTimestamp() < right.second.GetTimestamp();
-                                             });
-        if (found != fullCache.end())
+        ServerCacheEntry* oldest = accessList.Front();
+        if (oldest != nullptr)
         {
-            Remove(found);
+            Remove(fullCache.find(accessList.GetKey(oldest)));
         }
         else
         {
-            if (occupiedSize > 0)
-            {
-                DAVA::Logger::Warning("Occupied size is %u, should be 0", occupiedSize);
-                occupiedSize = 0;
-                NotifySizeChanged();
-                break;
-            }
+            DAVA::Logger::Warning("Occupied size is %u, should be 0", occupiedSize);
+            occupiedSize = 0;
+            NotifySizeChanged();
+            break;
         }
     }
 }
@@ -263,6 +504,16 @@ ServerCacheEntry* CacheDB::Get(const DAVA::AssetCache::CacheItemKey& key)
     return entry;
 }
 
+const ServerCacheEntry* CacheDB::Find(const DAVA::AssetCache::CacheItemKey& key) const
+{
+    return FindInFullCache(key);
+}
+
+DAVA::FilePath CacheDB::GetItemFolder(const DAVA::AssetCache::CacheItemKey& key) const
+{
+    return CreateFolderPath(key);
+}
+
 ServerCacheEntry* CacheDB::FindInFastCache(const DAVA::AssetCache::CacheItemKey& key) const
 {
     auto found = fastCache.find(key);
@@ -325,12 +576,10 @@ void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry
     }
 
     DAVA::Logger::Debug("Inserting into cache: key %s", Brief(key).c_str());
-    fullCache[key] = std::move(entry);
-    ServerCacheEntry* insertedEntry = &fullCache[key];
+    entry.UpdateAccessTimestamp();
+    ServerCacheEntry* insertedEntry = InsertInIndex(key, std::move(entry));
     DAVA::FilePath savedPath = CreateFolderPath(key);
     insertedEntry->GetValue().ExportToFolder(savedPath);
-    insertedEntry->UpdateAccessTimestamp();
-    occupiedSize += insertedEntry->GetValue().GetSize();
     NotifySizeChanged();
 
     InsertInFastCache(key, insertedEntry);
@@ -344,6 +593,19 @@ void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry
     dbStateChanged = true;
 }
 
+ServerCacheEntry* CacheDB::InsertInIndex(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry&& entry)
+{
+    auto inserted = fullCache.emplace(key, std::move(entry));
+    DVASSERT(inserted.second == true);
+
+    ServerCacheEntry* insertedEntry = &inserted.first->second;
+    accessList.PushBack(inserted.first->first, insertedEntry);
+    occupiedSize += insertedEntry->GetValue().GetSize();
+    WriteJournalRecord(JOURNAL_INSERT, key, insertedEntry);
+
+    return insertedEntry;
+}
+
 void CacheDB::InsertInFastCache(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry* entry)
 {
     if (fastCache.count(key) != 0)
@@ -377,6 +639,8 @@ void CacheDB::UpdateAccessTimestamp(ServerCacheEntry* entry)
     if (nullptr != entry)
     {
         entry->UpdateAccessTimestamp();
+        accessList.MoveToBack(entry);
+        WriteJournalRecord(JOURNAL_ACCESS, accessList.GetKey(entry), entry);
         dbStateChanged = true;
     }
 }
@@ -412,12 +676,20 @@ void CacheDB::RemoveFromFullCache(const CacheMap::iterator& it)
     DAVA::FilePath dataPath = CreateFolderPath(it->first);
     DAVA::FileSystem::Instance()->DeleteDirectory(dataPath);
 
+    DAVA::Logger::Debug("Removing from full cache: key %s", Brief(it->first).c_str());
+    RemoveFromIndex(it);
+    NotifySizeChanged();
+}
+
+void CacheDB::RemoveFromIndex(const CacheMap::iterator& it)
+{
     DAVA::uint64 itemSize = it->second.GetValue().GetSize();
     DVASSERT(itemSize <= occupiedSize);
     occupiedSize -= itemSize;
-    DAVA::Logger::Debug("Removing from full cache: key %s", Brief(it->first).c_str());
+
+    WriteJournalRecord(JOURNAL_REMOVE, it->first, nullptr);
+    accessList.Remove(&it->second);
     fullCache.erase(it);
-    NotifySizeChanged();
 }
 
 void CacheDB::RemoveFromFastCache(const FastCacheMap::iterator& it)
@@ -3,29 +3,67 @@
 #include <AssetCache/CacheItemKey.h>
 
 #include <Base/BaseTypes.h>
+#include <Base/ScopedPtr.h>
 #include <FileSystem/FilePath.h>
 
 #include <atomic>
 
+#include "ServerCacheEntry.h"
+
 namespace DAVA
 {
+class File;
+
 namespace AssetCache
 {
 class CachedItemValue;
 }
 }
 
-class ServerCacheEntry;
-
 struct CacheDBOwner
 {
     virtual void OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overall) = 0;
 };
 
+/**
+    Index of cached items with their last access order.
+
+    Index is stored as snapshot file `DB_FILE_NAME` and append-only journal `JOURNAL_FILE_NAME`
+    with insert, remove and access records made after snapshot. Journal is flushed on `Save`,
+    and when it contains more records than items in index, snapshot is rewritten and journal is started anew.
+    Journal is applied on load only if it was started for the loaded snapshot, which is checked by generation number.
+
+    Items are linked in access order, so the least recently used item is evicted without search.
+*/
 class CacheDB final
 {
     static const DAVA::String DB_FILE_NAME;
+    static const DAVA::String JOURNAL_FILE_NAME;
     static const DAVA::uint32 VERSION;
+    static const DAVA::uint32 LEGACY_VERSION;
+    static const DAVA::uint64 MIN_JOURNAL_RECORDS_TO_COMPACT;
+
+    enum eJournalRecord : DAVA::uint8
+    {
+        JOURNAL_INSERT = 0, // key, entry
+        JOURNAL_REMOVE, // key
+        JOURNAL_ACCESS // key, timestamp
+    };
+
+    struct SnapshotHeader
+    {
+        DAVA::char8 signature[4];
+        DAVA::uint32 version;
+        DAVA::uint64 generation;
+        DAVA::uint64 itemsCount;
+    };
+
+    struct JournalHeader
+    {
+        DAVA::char8 signature[4];
+        DAVA::uint32 version;
+        DAVA::uint64 generation;
+    };
 
     using CacheMap = DAVA::UnorderedMap<DAVA::AssetCache::CacheItemKey, ServerCacheEntry>;
     using FastCacheMap = DAVA::UnorderedMap<DAVA::AssetCache::CacheItemKey, ServerCacheEntry*>;
@@ -40,6 +78,9 @@ public:
     void Load();
 
     ServerCacheEntry* Get(const DAVA::AssetCache::CacheItemKey& key);
+    /** Returns entry without fetching of its data and updating of access time, data of entry that isn't fetched is stored in `GetItemFolder` */
+    const ServerCacheEntry* Find(const DAVA::AssetCache::CacheItemKey& key) const;
+    DAVA::FilePath GetItemFolder(const DAVA::AssetCache::CacheItemKey& key) const;
 
     void Insert(const DAVA::AssetCache::CacheItemKey& key, const DAVA::AssetCache::CachedItemValue& value);
     bool Remove(const DAVA::AssetCache::CacheItemKey& key);
@@ -54,8 +95,17 @@ public:
     void Update();
 
 private:
+    friend class CacheDBBenchmark;
+
     void Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry&& entry);
 
+    bool LoadSnapshot(DAVA::File* file);
+    bool LoadLegacySnapshot(DAVA::File* file);
+    bool ReplayJournal();
+    void Compact();
+
+    void WriteJournalRecord(eJournalRecord type, const DAVA::AssetCache::CacheItemKey& key, const ServerCacheEntry* entry);
+
     DAVA::FilePath CreateFolderPath(const DAVA::AssetCache::CacheItemKey& key) const;
 
     void Unload();
@@ -74,6 +124,10 @@ private:
     void RemoveFromFastCache(const FastCacheMap::iterator& it);
     void RemoveFromFullCache(const CacheMap::iterator& it);
 
+    // change index and journal only, without files of items
+    ServerCacheEntry* InsertInIndex(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry&& entry);
+    void RemoveFromIndex(const CacheMap::iterator& it);
+
     void Remove(const CacheMap::iterator& it);
 
     void NotifySizeChanged();
@@ -83,6 +137,7 @@ private:
 
     DAVA::FilePath cacheRootFolder; //path to folder with settings and cache of files
     DAVA::FilePath cacheSettings; //path to settings
+    DAVA::FilePath journalPath; //path to changes made after settings were saved
 
     DAVA::uint64 maxStorageSize = 0; //maximum cache size
     DAVA::uint32 maxItemsInMemory = 0; //count of items in memory, to use for fast access
@@ -95,6 +150,12 @@ private:
 
     FastCacheMap fastCache; //runtime, week storage
     CacheMap fullCache; //stored on disk, strong storage
+    ServerCacheEntryList accessList; //items of full cache, least recently used first
+
+    DAVA::ScopedPtr<DAVA::File> journal; //opened for append, null if snapshot should be rewritten
+    DAVA::uint64 journalGeneration = 0; //generation of snapshot which journal continues
+    DAVA::uint64 journalRecordsCount = 0;
+    bool compactionRequired = true;
 
     std::atomic<bool> dbStateChanged; //flag about changes in db
 };
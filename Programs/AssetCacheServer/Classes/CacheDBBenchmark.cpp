@@ -0,0 +1,141 @@
+#include "CacheDBBenchmark.h"
+#include "ServerCacheEntry.h"
+
+#include <AssetCache/CachedItemValue.h>
+
+#include <FileSystem/File.h>
+#include <FileSystem/FileSystem.h>
+#include <Logger/Logger.h>
+#include <Time/SystemTimer.h>
+
+#include <random>
+
+namespace CacheDBBenchmarkDetails
+{
+const DAVA::uint32 ITEM_SIZE = 1024;
+const DAVA::uint32 SCAN_EVICTIONS_COUNT = 100;
+
+DAVA::AssetCache::CacheItemKey CreateKey(DAVA::uint32 index)
+{
+    DAVA::AssetCache::CacheItemKey key;
+    key.fill(0);
+    Memcpy(key.data(), &index, sizeof(index));
+    return key;
+}
+
+DAVA::float64 ToMs(DAVA::int64 us)
+{
+    return static_cast<DAVA::float64>(us) / 1000.0;
+}
+
+DAVA::float64 ToNsPerItem(DAVA::int64 us, DAVA::uint64 count)
+{
+    return (count > 0) ? static_cast<DAVA::float64>(us) * 1000.0 / static_cast<DAVA::float64>(count) : 0.0;
+}
+}
+
+CacheDBBenchmark::CacheDBBenchmark(const DAVA::FilePath& folder_)
+    : folder(folder_)
+{
+    folder.MakeDirectoryPathname();
+}
+
+void CacheDBBenchmark::OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overall)
+{
+}
+
+void CacheDBBenchmark::Run(DAVA::uint32 itemsCount)
+{
+    using namespace DAVA;
+    using namespace CacheDBBenchmarkDetails;
+
+    FileSystem::Instance()->DeleteDirectory(folder);
+
+    // half of items fit into storage, so every insertion after that evicts the least recently used item
+    const uint64 storageSize = static_cast<uint64>(itemsCount / 2) * ITEM_SIZE;
+
+    // all items refer to the same data, only descriptions of items are stored in index
+    AssetCache::CachedItemValue value;
+    value.Add("data", std::make_shared<Vector<uint8>>(ITEM_SIZE, uint8(0)));
+
+    int64 insertTime = 0;
+    int64 accessTime = 0;
+    int64 compactionTime = 0;
+    int64 scanEvictionTime = 0;
+    int64 loadTime = 0;
+    uint64 storedCount = 0;
+    uint64 journalRecordsCount = 0;
+    uint64 scanEvictionsCount = 0;
+    uint64 loadedCount = 0;
+    uint64 snapshotSize = 0;
+
+    {
+        CacheDB db(*this);
+        db.UpdateSettings(folder, storageSize, 0, 0);
+
+        int64 startTime = SystemTimer::GetUs();
+        for (uint32 index = 0; index < itemsCount; ++index)
+        {
+            ServerCacheEntry entry(value);
+            entry.UpdateAccessTimestamp();
+            db.InsertInIndex(CreateKey(index), std::move(entry));
+
+            while (db.occupiedSize > storageSize)
+            {
+                db.RemoveFromIndex(db.fullCache.find(db.accessList.GetKey(db.accessList.Front())));
+            }
+        }
+        insertTime = SystemTimer::GetUs() - startTime;
+        storedCount = db.fullCache.size();
+
+        std::mt19937 random(0);
+        const uint32 firstStoredIndex = itemsCount - static_cast<uint32>(storedCount);
+        startTime = SystemTimer::GetUs();
+        for (uint32 index = 0; index < itemsCount && storedCount > 0; ++index)
+        {
+            db.UpdateAccessTimestamp(CreateKey(firstStoredIndex + static_cast<uint32>(random() % storedCount)));
+        }
+        accessTime = SystemTimer::GetUs() - startTime;
+        journalRecordsCount = db.journalRecordsCount;
+
+        startTime = SystemTimer::GetUs();
+        db.Compact();
+        compactionTime = SystemTimer::GetUs() - startTime;
+
+        // eviction as it was done before access list
+        startTime = SystemTimer::GetUs();
+        for (; scanEvictionsCount < SCAN_EVICTIONS_COUNT && db.fullCache.empty() == false; ++scanEvictionsCount)
+        {
+            auto oldest = std::min_element(db.fullCache.begin(), db.fullCache.end(), [](const CacheDB::CacheMap::value_type& left, const CacheDB::CacheMap::value_type& right)
+                                           {
+                                               return left.second.GetTimestamp() < right.second.GetTimestamp();
+                                           });
+            db.RemoveFromIndex(oldest);
+        }
+        scanEvictionTime = SystemTimer::GetUs() - startTime;
+    }
+
+    {
+        ScopedPtr<File> snapshot(File::Create(folder + CacheDB::DB_FILE_NAME, File::OPEN | File::READ));
+        snapshotSize = snapshot ? snapshot->GetSize() : 0;
+    }
+
+    {
+        CacheDB db(*this);
+
+        int64 startTime = SystemTimer::GetUs();
+        db.UpdateSettings(folder, storageSize, 0, 0);
+        loadTime = SystemTimer::GetUs() - startTime;
+        loadedCount = db.fullCache.size();
+    }
+
+    FileSystem::Instance()->DeleteDirectory(folder);
+
+    Logger::Info("[CacheDBBenchmark] %u items inserted, %llu kept in storage", itemsCount, storedCount);
+    Logger::Info("[CacheDBBenchmark] insert with eviction: %.1f ms, %.0f ns per item", ToMs(insertTime), ToNsPerItem(insertTime, itemsCount));
+    Logger::Info("[CacheDBBenchmark] access: %.1f ms, %.0f ns per item", ToMs(accessTime), ToNsPerItem(accessTime, itemsCount));
+    Logger::Info("[CacheDBBenchmark] compaction of %llu journal records to %llu bytes: %.1f ms", journalRecordsCount, snapshotSize, ToMs(compactionTime));
+    Logger::Info("[CacheDBBenchmark] load of %llu items: %.1f ms", loadedCount, ToMs(loadTime));
+    Logger::Info("[CacheDBBenchmark] eviction by scan: %.0f ns per item, %.1f s estimated for %u evictions",
+                 ToNsPerItem(scanEvictionTime, scanEvictionsCount), ToNsPerItem(scanEvictionTime, scanEvictionsCount) * (itemsCount - storedCount) / 1e9, itemsCount - static_cast<uint32>(storedCount));
+}
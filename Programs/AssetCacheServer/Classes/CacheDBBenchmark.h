@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CacheDB.h"
+
+#include <Base/BaseTypes.h>
+#include <FileSystem/FilePath.h>
+
+/**
+    Measures index operations of `CacheDB` on synthetic keys: insertion with eviction of least recently used items,
+    access updates, journal flush, compaction and loading. Item files aren't written, so disk I/O is only index I/O.
+    Eviction by scanning all items, as it was done before access list, is measured on a few items for comparison.
+
+    Run by `AssetCacheServer --benchmark-cachedb [itemsCount]`, results are written to log.
+*/
+class CacheDBBenchmark final : public CacheDBOwner
+{
+public:
+    static const DAVA::uint32 DEFAULT_ITEMS_COUNT = 1000000;
+
+    CacheDBBenchmark(const DAVA::FilePath& folder);
+
+    void Run(DAVA::uint32 itemsCount);
+
+private:
+    void OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overall) override;
+
+    DAVA::FilePath folder;
+};
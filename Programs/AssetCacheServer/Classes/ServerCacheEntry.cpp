@@ -1,6 +1,7 @@
 #include "ServerCacheEntry.h"
 
 #include "FileSystem/KeyedArchive.h"
+#include "FileSystem/File.h"
 
 #include "Debug/DVAssert.h"
 
@@ -21,6 +22,8 @@ ServerCacheEntry::ServerCacheEntry(ServerCacheEntry&& right)
 
 ServerCacheEntry& ServerCacheEntry::operator=(ServerCacheEntry&& right)
 {
+    DVASSERT(ServerCacheEntryList::IsLinked(this) == false);
+
     if (this != &right)
     {
         value = std::move(right.value);
@@ -57,6 +60,26 @@ void ServerCacheEntry::Deserialize(DAVA::KeyedArchive* archieve)
     value.Deserialize(valueArchieve);
 }
 
+bool ServerCacheEntry::Serialize(DAVA::File* file) const
+{
+    DVASSERT(nullptr != file);
+
+    if (file->Write(&accessTimestamp) != sizeof(accessTimestamp))
+        return false;
+
+    return value.Serialize(file, false);
+}
+
+bool ServerCacheEntry::Deserialize(DAVA::File* file)
+{
+    DVASSERT(nullptr != file);
+
+    if (file->Read(&accessTimestamp) != sizeof(accessTimestamp))
+        return false;
+
+    return value.Deserialize(file);
+}
+
 bool ServerCacheEntry::Fetch(const DAVA::FilePath& folder)
 {
     return value.Fetch(folder);
@@ -66,3 +89,77 @@ void ServerCacheEntry::Free()
 {
     value.Free();
 }
+
+void ServerCacheEntryList::PushBack(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry* entry)
+{
+    DVASSERT(IsLinked(entry) == false);
+
+    entry->key = &key;
+    entry->prev = tail;
+    entry->next = nullptr;
+
+    if (tail != nullptr)
+    {
+        tail->next = entry;
+    }
+    else
+    {
+        head = entry;
+    }
+    tail = entry;
+}
+
+void ServerCacheEntryList::MoveToBack(ServerCacheEntry* entry)
+{
+    DVASSERT(IsLinked(entry));
+
+    if (entry != tail)
+    {
+        const DAVA::AssetCache::CacheItemKey* key = entry->key;
+        Remove(entry);
+        PushBack(*key, entry);
+    }
+}
+
+void ServerCacheEntryList::Remove(ServerCacheEntry* entry)
+{
+    DVASSERT(IsLinked(entry));
+
+    if (entry->prev != nullptr)
+    {
+        entry->prev->next = entry->next;
+    }
+    else
+    {
+        head = entry->next;
+    }
+
+    if (entry->next != nullptr)
+    {
+        entry->next->prev = entry->prev;
+    }
+    else
+    {
+        tail = entry->prev;
+    }
+
+    entry->prev = nullptr;
+    entry->next = nullptr;
+    entry->key = nullptr;
+}
+
+void ServerCacheEntryList::Clear()
+{
+    ServerCacheEntry* entry = head;
+    while (entry != nullptr)
+    {
+        ServerCacheEntry* next = entry->next;
+        entry->prev = nullptr;
+        entry->next = nullptr;
+        entry->key = nullptr;
+        entry = next;
+    }
+
+    head = nullptr;
+    tail = nullptr;
+}
@@ -1,14 +1,19 @@
 #pragma once
 
 #include <AssetCache/CachedItemValue.h>
+#include <AssetCache/CacheItemKey.h>
 #include <Base/BaseTypes.h>
+#include <Debug/DVAssert.h>
 #include <chrono>
 
 namespace DAVA
 {
 class KeyedArchive;
+class File;
 }
 
+class ServerCacheEntryList;
+
 class ServerCacheEntry final
 {
 public:
@@ -28,19 +33,55 @@ public:
     void Serialize(DAVA::KeyedArchive* archieve) const;
     void Deserialize(DAVA::KeyedArchive* archieve);
 
+    /** Write timestamp and value description without file data */
+    bool Serialize(DAVA::File* file) const;
+    bool Deserialize(DAVA::File* file);
+
     void UpdateAccessTimestamp();
+    void SetTimestamp(DAVA::uint64 timestamp);
     DAVA::uint64 GetTimestamp() const;
 
     DAVA::AssetCache::CachedItemValue& GetValue();
+    const DAVA::AssetCache::CachedItemValue& GetValue() const;
 
     bool Fetch(const DAVA::FilePath& folder);
     void Free();
 
 private:
+    friend class ServerCacheEntryList;
+
     DAVA::AssetCache::CachedItemValue value;
 
 private:
     DAVA::uint64 accessTimestamp = 0;
+
+    // links of access order list, aren't moved with entry
+    ServerCacheEntry* prev = nullptr;
+    ServerCacheEntry* next = nullptr;
+    const DAVA::AssetCache::CacheItemKey* key = nullptr;
+};
+
+/**
+    Intrusive list of entries ordered by access: least recently used entry is at front.
+    Entries should stay at the same address while linked, i.e. be stored in node based container.
+*/
+class ServerCacheEntryList final
+{
+public:
+    void PushBack(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry* entry);
+    void MoveToBack(ServerCacheEntry* entry);
+    void Remove(ServerCacheEntry* entry);
+    void Clear();
+
+    ServerCacheEntry* Front() const;
+    ServerCacheEntry* Next(const ServerCacheEntry* entry) const;
+
+    static const DAVA::AssetCache::CacheItemKey& GetKey(const ServerCacheEntry* entry);
+    static bool IsLinked(const ServerCacheEntry* entry);
+
+private:
+    ServerCacheEntry* head = nullptr;
+    ServerCacheEntry* tail = nullptr;
 };
 
 inline void ServerCacheEntry::UpdateAccessTimestamp()
@@ -48,6 +89,11 @@ inline void ServerCacheEntry::UpdateAccessTimestamp()
     accessTimestamp = std::chrono::steady_clock::now().time_since_epoch().count();
 }
 
+inline void ServerCacheEntry::SetTimestamp(DAVA::uint64 timestamp)
+{
+    accessTimestamp = timestamp;
+}
+
 inline DAVA::uint64 ServerCacheEntry::GetTimestamp() const
 {
     return accessTimestamp;
@@ -57,3 +103,29 @@ inline DAVA::AssetCache::CachedItemValue& ServerCacheEntry::GetValue()
 {
     return value;
 }
+
+inline const DAVA::AssetCache::CachedItemValue& ServerCacheEntry::GetValue() const
+{
+    return value;
+}
+
+inline ServerCacheEntry* ServerCacheEntryList::Front() const
+{
+    return head;
+}
+
+inline ServerCacheEntry* ServerCacheEntryList::Next(const ServerCacheEntry* entry) const
+{
+    return entry->next;
+}
+
+inline const DAVA::AssetCache::CacheItemKey& ServerCacheEntryList::GetKey(const ServerCacheEntry* entry)
+{
+    DVASSERT(entry->key != nullptr);
+    return *entry->key;
+}
+
+inline bool ServerCacheEntryList::IsLinked(const ServerCacheEntry* entry)
+{
+    return (entry->key != nullptr);
+}
@@ -5,9 +5,48 @@
 #include <AssetCache/ChunkSplitter.h>
 
 #include <Concurrency/LockGuard.h>
+#include <Engine/Engine.h>
+#include <Job/JobManager.h>
 #include <Logger/Logger.h>
 #include <Utils/StringFormat.h>
 
+namespace ServerLogicsDetails
+{
+// reads in flight are limited to keep memory of read items bounded, few of them per worker are enough to keep workers busy
+const DAVA::uint32 ITEM_READS_PER_WORKER = 4;
+
+// called on worker thread, so it fetches copy of value that refers to files of item but has no data
+DAVA::ScopedPtr<DAVA::DynamicMemoryFile> ReadItem(DAVA::AssetCache::CachedItemValue value, const DAVA::FilePath& folder, const DAVA::String& serverName)
+{
+    using namespace DAVA;
+
+    if (value.Fetch(folder) == false)
+    {
+        return ScopedPtr<DynamicMemoryFile>(nullptr);
+    }
+
+    AssetCache::CachedItemValue::Description description = value.GetDescription();
+    description.receivingChain += "/" + serverName;
+    value.SetDescription(description);
+
+    ScopedPtr<DynamicMemoryFile> serializedData(DynamicMemoryFile::Create(File::CREATE | File::READ | File::WRITE));
+    value.Serialize(serializedData);
+    return serializedData;
+}
+}
+
+ServerLogics::~ServerLogics()
+{
+    DAVA::JobManager* jobManager = DAVA::GetEngineContext()->jobManager;
+    if (jobManager != nullptr)
+    {
+        for (const DAVA::JobHandle& job : itemReadJobs)
+        {
+            jobManager->WaitWorkerJob(job);
+        }
+    }
+}
+
 void ServerLogics::Init(DAVA::AssetCache::ServerNetProxy* server_, const DAVA::String& serverName_, DAVA::AssetCache::ClientNetProxy* client_, CacheDB* dataBase_)
 {
     serverProxy = server_;
@@ -16,7 +55,7 @@ void ServerLogics::Init(DAVA::AssetCache::ServerNetProxy* server_, const DAVA::S
     dataBase = dataBase_;
 }
 
-void ServerLogics::OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunkData)
+void ServerLogics::OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunkData)
 {
     hasIncomingRequestsRecently = true;
 
@@ -65,7 +104,7 @@ void ServerLogics::OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>&
         task.chunksOverall = numOfChunks;
     }
 
-    Logger::Debug("Adding chunk #%u, %u bytes. Overall received %u, remaining %u", chunkNumber, chunkData.size(), task.bytesReceived, task.bytesOverall - task.bytesReceived);
+    Logger::Debug("Adding chunk #%u, %u bytes. Overall received %u, remaining %u", chunkNumber, chunkData.size, task.bytesReceived, task.bytesOverall - task.bytesReceived);
 
     if (task.chunksReceived != chunkNumber)
     {
@@ -73,8 +112,8 @@ void ServerLogics::OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>&
         return;
     }
 
-    uint32 chunkSize = static_cast<uint32>(chunkData.size());
-    uint32 written = task.receivedData->Write(chunkData.data(), chunkSize);
+    uint32 chunkSize = chunkData.size;
+    uint32 written = task.receivedData->Write(chunkData.data, chunkSize);
     if (written != chunkSize)
     {
         Error(Format("can't append %u bytes", chunkSize).c_str());
@@ -188,8 +227,7 @@ void ServerLogics::OnChunkRequestedFromCache(const std::shared_ptr<DAVA::Net::IC
     auto Error = [&](const char* err)
     {
         Logger::Error("Wrong chunk request: %s. Client %p, key %s, chunk %u", err, clientChannel.get(), Brief(key).c_str(), chunkNumber);
-        Vector<uint8> empty;
-        serverProxy->SendChunk(clientChannel, key, 0, 0, 0, empty);
+        serverProxy->SendChunk(clientChannel, key, 0, 0, 0, AssetCache::ChunkView());
     };
 
     DataGetMap::iterator taskIter = GetOrCreateGetTask(key);
@@ -200,8 +238,8 @@ void ServerLogics::OnChunkRequestedFromCache(const std::shared_ptr<DAVA::Net::IC
 
         if (task.chunksReady > chunkNumber) // task has such chunk
         {
-            Vector<uint8> chunk = AssetCache::ChunkSplitter::GetChunk(task.serializedData->GetDataVector(), chunkNumber);
-            if (chunk.empty())
+            AssetCache::ChunkView chunk = AssetCache::ChunkSplitter::GetChunk(task.serializedData->GetDataVector(), chunkNumber);
+            if (chunk.size == 0)
             {
                 Error("can't get valid range for given chunk");
                 return;
@@ -225,15 +263,116 @@ void ServerLogics::OnChunkRequestedFromCache(const std::shared_ptr<DAVA::Net::IC
             else
             {
                 client.status = DataGetTask::WAITING_NEXT_CHUNK;
-                client.waitingChunk = chunkNumber;
+                client.waitingChunks.push_back(chunkNumber);
             }
         }
     }
     else
     { // Not found in db. Remote server isn't connected.
-        Vector<uint8> empty;
         DAVA::Logger::Debug("Sending empty chunk");
-        serverProxy->SendChunk(clientChannel, key, 0, 0, 0, empty);
+        serverProxy->SendChunk(clientChannel, key, 0, 0, 0, AssetCache::ChunkView());
+    }
+}
+
+void ServerLogics::OnBatchRequestedFromCache(const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, const DAVA::Vector<DAVA::AssetCache::CacheItemKey>& keys)
+{
+    hasIncomingRequestsRecently = true;
+
+    DAVA::Logger::Debug("Requested batch of %u items", keys.size());
+
+    bool workersAreAvailable = (DAVA::GetEngineContext()->jobManager != nullptr && serverProxy->GetDispatcher() != nullptr);
+    for (const DAVA::AssetCache::CacheItemKey& key : keys)
+    {
+        // item that is in memory, is received from remote server or isn't found is responded at once, so it doesn't wait for reads from disk
+        const ServerCacheEntry* entry = (workersAreAvailable && dataGetTasks.count(key) == 0) ? dataBase->Find(key) : nullptr;
+        if (entry != nullptr && entry->GetValue().IsFetched() == false)
+        {
+            dataBase->UpdateAccessTimestamp(key);
+            itemReadTasks.push_back({ key, clientChannel });
+            ++itemReadsOfClients[clientChannel];
+        }
+        else
+        {
+            OnChunkRequestedFromCache(clientChannel, key, 0);
+        }
+    }
+
+    StartItemReads();
+}
+
+void ServerLogics::StartItemReads()
+{
+    using namespace DAVA;
+
+    if (itemReadTasks.empty())
+    {
+        return;
+    }
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    itemReadJobs.erase(std::remove_if(itemReadJobs.begin(), itemReadJobs.end(), [](const JobHandle& job) { return job.IsFinished(); }), itemReadJobs.end());
+
+    const uint32 maxReadsInFlight = std::max(jobManager->GetWorkersCount(), 1u) * ServerLogicsDetails::ITEM_READS_PER_WORKER;
+    while (itemReadTasks.empty() == false && itemReadsInFlight < maxReadsInFlight)
+    {
+        ItemReadTask task = itemReadTasks.front();
+        itemReadTasks.pop_front();
+
+        const ServerCacheEntry* entry = dataBase->Find(task.key);
+        if (entry == nullptr || entry->GetValue().IsFetched() || dataGetTasks.count(task.key) != 0)
+        { // item was fetched, removed or requested by other client while task was waiting, so it is responded as single request
+            OnItemRead(task.key, task.channel, ScopedPtr<DynamicMemoryFile>(nullptr));
+            continue;
+        }
+
+        ++itemReadsInFlight;
+
+        AssetCache::CachedItemValue value = entry->GetValue();
+        FilePath folder = dataBase->GetItemFolder(task.key);
+        String receivingServerName = serverName;
+        Dispatcher<Function<void()>>* dispatcher = serverProxy->GetDispatcher();
+        std::weak_ptr<bool> token = lifetimeToken;
+        itemReadJobs.push_back(jobManager->CreateWorkerJob([this, task, value, folder, receivingServerName, dispatcher, token]()
+                                                           {
+                                                               ScopedPtr<DynamicMemoryFile> serializedData = ServerLogicsDetails::ReadItem(value, folder, receivingServerName);
+                                                               dispatcher->PostEvent([this, task, serializedData, token]()
+                                                                                     {
+                                                                                         if (token.expired() == false)
+                                                                                         {
+                                                                                             --itemReadsInFlight;
+                                                                                             OnItemRead(task.key, task.channel, serializedData);
+                                                                                             StartItemReads();
+                                                                                         }
+                                                                                     });
+                                                           }));
+    }
+}
+
+void ServerLogics::OnItemRead(const DAVA::AssetCache::CacheItemKey& key, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::ScopedPtr<DAVA::DynamicMemoryFile> serializedData)
+{
+    using namespace DAVA;
+
+    auto client = itemReadsOfClients.find(clientChannel);
+    if (client != itemReadsOfClients.end())
+    {
+        if (--client->second == 0)
+        {
+            itemReadsOfClients.erase(client);
+        }
+
+        // item might be removed from cache while it was read
+        if (serializedData && dataBase->Find(key) != nullptr && dataGetTasks.count(key) == 0)
+        {
+            Logger::Debug("Creating get task using data read by worker");
+            DataGetTask& task = dataGetTasks.emplace(key, DataGetTask()).first->second;
+            task.serializedData = serializedData;
+            task.dataStatus = DataGetTask::READY;
+            task.bytesOverall = task.bytesReady = task.serializedData->GetSize();
+            task.chunksOverall = task.chunksReady = AssetCache::ChunkSplitter::GetNumberOfChunks(task.bytesOverall);
+        }
+
+        // chunk is sent from created task. If item wasn't read, it is fetched as for single request, so errors are handled the same way
+        OnChunkRequestedFromCache(clientChannel, key, 0);
     }
 }
 
@@ -281,6 +420,14 @@ void ServerLogics::OnChannelClosed(const std::shared_ptr<DAVA::Net::IChannel>& c
 {
     DAVA::Logger::Debug("Channel %p is closed", channel.get());
     RemoveClientFromTasks(channel);
+
+    // reads that are started already are finished, but their results are dropped
+    itemReadsOfClients.erase(channel);
+    itemReadTasks.erase(std::remove_if(itemReadTasks.begin(), itemReadTasks.end(), [&channel](const ItemReadTask& task)
+                                       {
+                                           return task.channel == channel;
+                                       }),
+                        itemReadTasks.end());
 }
 
 void ServerLogics::OnRemoteDisconnecting()
@@ -298,7 +445,7 @@ void ServerLogics::OnClientProxyStateChanged()
     }
 }
 
-void ServerLogics::OnReceivedFromCache(const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunkData)
+void ServerLogics::OnReceivedFromCache(const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunkData)
 {
     hasIncomingRequestsRecently = true;
 
@@ -353,9 +500,9 @@ void ServerLogics::OnReceivedFromCache(const DAVA::AssetCache::CacheItemKey& key
         return;
     }
 
-    Logger::Debug("Receiving chunk #%u: %u bytes. Overall received %u, remaining %u", chunkNumber, chunkData.size(), task.bytesReady, task.bytesOverall - task.bytesReady);
+    Logger::Debug("Receiving chunk #%u: %u bytes. Overall received %u, remaining %u", chunkNumber, chunkData.size, task.bytesReady, task.bytesOverall - task.bytesReady);
 
-    if (chunkData.empty())
+    if (chunkData.size == 0)
     {
         Logger::Debug("Empty chunk is received. GetData task will be canceled for all clients");
         CancelGetTask(taskIter);
@@ -368,8 +515,8 @@ void ServerLogics::OnReceivedFromCache(const DAVA::AssetCache::CacheItemKey& key
         return;
     }
 
-    uint32 chunkSize = static_cast<uint32>(chunkData.size());
-    uint32 written = task.serializedData->Write(chunkData.data(), chunkSize);
+    uint32 chunkSize = chunkData.size;
+    uint32 written = task.serializedData->Write(chunkData.data, chunkSize);
     if (written != chunkSize)
     {
         Error(Format("can't append %u bytes", chunkSize).c_str(), taskIter);
@@ -465,14 +612,19 @@ void ServerLogics::RequestNextChunk(ServerLogics::DataGetMap::iterator it)
     task.dataStatus = DataGetTask::WAITING_NEXT_CHUNK;
 }
 
-void ServerLogics::SendChunkToClient(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunk)
+void ServerLogics::SendChunkToClient(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunk)
 {
     DataGetTask& task = taskIt->second;
     DataGetTask::ClientStatus& client = task.clients[clientChannel];
 
-    DAVA::Logger::Debug("Sending chunk #%u: %u bytes", chunkNumber, chunk.size());
+    DAVA::Logger::Debug("Sending chunk #%u: %u bytes", chunkNumber, chunk.size);
     serverProxy->SendChunk(clientChannel, taskIt->first, task.bytesOverall, task.chunksOverall, chunkNumber, chunk);
-    client.status = DataGetTask::READY;
+
+    if (client.waitingChunks.empty() == false && client.waitingChunks.front() == chunkNumber)
+    {
+        client.waitingChunks.pop_front();
+    }
+    client.status = client.waitingChunks.empty() ? DataGetTask::READY : DataGetTask::WAITING_NEXT_CHUNK;
 
     if (chunkNumber + 1 == task.chunksOverall)
     {
@@ -480,7 +632,7 @@ void ServerLogics::SendChunkToClient(DataGetMap::iterator taskIt, const std::sha
     }
 }
 
-void ServerLogics::SendChunkToClients(ServerLogics::DataGetMap::iterator taskIt, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunk)
+void ServerLogics::SendChunkToClients(ServerLogics::DataGetMap::iterator taskIt, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunk)
 {
     DVASSERT(taskIt != dataGetTasks.end());
 
@@ -489,7 +641,8 @@ void ServerLogics::SendChunkToClients(ServerLogics::DataGetMap::iterator taskIt,
 
     for (std::pair<std::shared_ptr<DAVA::Net::IChannel> const, DataGetTask::ClientStatus>& client : task.clients)
     {
-        if (client.second.status == DataGetTask::WAITING_NEXT_CHUNK && client.second.waitingChunk == chunkNumber)
+        // chunks are received from remote server in order, so chunk that client waits first is the next one
+        if (client.second.status == DataGetTask::WAITING_NEXT_CHUNK && client.second.waitingChunks.front() == chunkNumber)
         {
             SendChunkToClient(taskIt, client.first, chunkNumber, chunk);
         }
@@ -549,7 +702,7 @@ bool ServerLogics::SendChunkToRemote(DataRemoteAddMap::iterator taskIt)
     const AssetCache::CacheItemKey& key = taskIt->first;
     DataRemoteAddTask& task = taskIt->second;
 
-    Vector<uint8> chunk = AssetCache::ChunkSplitter::GetChunk(task.serializedData->GetDataVector(), task.chunksSent);
+    AssetCache::ChunkView chunk = AssetCache::ChunkSplitter::GetChunk(task.serializedData->GetDataVector(), task.chunksSent);
     DAVA::Logger::Debug("Sending add chunk %u/%u to remote, key %s", task.chunksSent, task.chunksOverall, Brief(key).c_str());
     return clientProxy->RequestAddNextChunk(key, task.bytesOverall, task.chunksOverall, task.chunksSent++, chunk);
 }
@@ -572,8 +725,11 @@ void ServerLogics::CancelGetTask(ServerLogics::DataGetMap::iterator it)
             case DataGetTask::READY:
                 break;
             case DataGetTask::WAITING_NEXT_CHUNK:
-                DAVA::Logger::Debug("Sending empty chunk");
-                serverProxy->SendChunk(client.first, key, 0, 0, 0, Vector<uint8>());
+                DAVA::Logger::Debug("Sending empty chunks");
+                for (size_t i = 0; i < client.second.waitingChunks.size(); ++i)
+                {
+                    serverProxy->SendChunk(client.first, key, 0, 0, 0, AssetCache::ChunkView());
+                }
                 break;
             default:
                 DVASSERT(false, Format("Incorrect data status: %u", task.dataStatus).c_str());
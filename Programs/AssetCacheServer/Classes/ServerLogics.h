@@ -5,11 +5,14 @@
 #include <AssetCache/AssetCache.h>
 
 #include <FileSystem/DynamicMemoryFile.h>
+#include <Job/JobHandle.h>
 
 class ServerLogics : public DAVA::AssetCache::ServerNetProxyListener,
                      public DAVA::AssetCache::ClientNetProxyListener
 {
 public:
+    ~ServerLogics();
+
     void Init(DAVA::AssetCache::ServerNetProxy* server, const DAVA::String& serverName, DAVA::AssetCache::ClientNetProxy* client, CacheDB* dataBase);
     void Update();
     void LazyUpdate();
@@ -17,18 +20,19 @@ public:
     void OnRemoteDisconnecting();
 
     //ServerNetProxyListener
-    void OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunkData) override;
+    void OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunkData) override;
     void OnChunkRequestedFromCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint32 chunkNumber) override;
     void OnRemoveFromCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key) override;
     void OnClearCache(const std::shared_ptr<DAVA::Net::IChannel>& channel) override;
     void OnWarmingUp(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key) override;
     void OnChannelClosed(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::char8* message) override;
     void OnStatusRequested(const std::shared_ptr<DAVA::Net::IChannel>& channel) override;
+    void OnBatchRequestedFromCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::Vector<DAVA::AssetCache::CacheItemKey>& keys) override;
 
     //ClientNetProxyListener
     void OnClientProxyStateChanged() override;
     void OnAddedToCache(const DAVA::AssetCache::CacheItemKey& key, bool added) override;
-    void OnReceivedFromCache(const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunkData) override;
+    void OnReceivedFromCache(const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunkData) override;
 
 private:
     struct DataGetTask
@@ -46,7 +50,7 @@ private:
             {
             }
             DataRequestStatus status = DataRequestStatus::READY;
-            DAVA::uint32 waitingChunk = 0;
+            DAVA::Deque<DAVA::uint32> waitingChunks; // client may request several chunks without waiting for responses
             bool lastChunkWasSent = false;
         };
 
@@ -82,6 +86,12 @@ private:
     };
     using DataRemoteAddMap = DAVA::UnorderedMap<DAVA::AssetCache::CacheItemKey, DataRemoteAddTask>;
 
+    struct ItemReadTask
+    {
+        DAVA::AssetCache::CacheItemKey key;
+        std::shared_ptr<DAVA::Net::IChannel> channel;
+    };
+
     struct DataWarmupTask
     {
         DataWarmupTask(const DAVA::AssetCache::CacheItemKey& key)
@@ -97,8 +107,8 @@ private:
     DAVA::List<DataAddTask>::iterator GetOrCreateAddTask(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key);
     DataGetMap::iterator GetOrCreateGetTask(const DAVA::AssetCache::CacheItemKey& key);
     void RequestNextChunk(DataGetMap::iterator it);
-    void SendChunkToClient(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunk);
-    void SendChunkToClients(DataGetMap::iterator taskIt, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunk);
+    void SendChunkToClient(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunk);
+    void SendChunkToClients(DataGetMap::iterator taskIt, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunk);
     bool SendFirstChunkToRemote(DataRemoteAddMap::iterator taskIt);
     bool SendChunkToRemote(DataRemoteAddMap::iterator taskIt);
     void CancelGetTask(DataGetMap::iterator it);
@@ -106,6 +116,9 @@ private:
     void RemoveClientFromTasks(const std::shared_ptr<DAVA::Net::IChannel>& clientChannel);
     void RemoveTaskIfChunksAreSent(ServerLogics::DataGetMap::iterator taskIt);
 
+    void StartItemReads();
+    void OnItemRead(const DAVA::AssetCache::CacheItemKey& key, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::ScopedPtr<DAVA::DynamicMemoryFile> serializedData);
+
     void ProcessLazyTasks();
 
     void ProcessFirstRemoteAddDataTask();
@@ -119,6 +132,14 @@ private:
     DAVA::List<DataAddTask> dataAddTasks;
     DAVA::List<DataWarmupTask> dataWarmupTasks;
     DataRemoteAddMap dataRemoteAddTasks;
+
+    // items of batch requests that aren't in memory are read from disk by workers, results are handled in thread of server proxy
+    DAVA::Deque<ItemReadTask> itemReadTasks; // waiting for free worker
+    DAVA::Vector<DAVA::JobHandle> itemReadJobs;
+    DAVA::uint32 itemReadsInFlight = 0;
+    DAVA::UnorderedMap<std::shared_ptr<DAVA::Net::IChannel>, DAVA::uint32> itemReadsOfClients; // items that are waiting or read for client
+    std::shared_ptr<bool> lifetimeToken = std::make_shared<bool>(true); // results of reads are dropped if they're handled after destruction
+
     DAVA::String serverName;
     bool hasIncomingRequestsRecently = false; // any incoming request has been received after last lazy update
 };
@@ -0,0 +1,345 @@
+#include "TransferBenchmark.h"
+
+#include <AssetCache/AssetCacheClient.h>
+#include <AssetCache/CachedItemValue.h>
+
+#include <FileSystem/FileSystem.h>
+#include <Logger/Logger.h>
+#include <Network/NetCore.h>
+#include <Time/SystemTimer.h>
+
+#include <random>
+
+namespace TransferBenchmarkDetails
+{
+const DAVA::uint16 BENCHMARK_PORT = DAVA::AssetCache::ASSET_SERVER_HTTP_PORT + 1;
+const DAVA::uint32 LATENCIES_MS[] = { 0, 10, 50, 100 };
+const DAVA::uint32 CHUNKS_IN_FLIGHT[] = { 1, 4, 8 };
+const DAVA::uint32 ITEMS_IN_MEMORY = 4;
+const DAVA::uint32 SMALL_ITEMS_COUNT = 100;
+const DAVA::uint32 SMALL_ITEM_SIZE = 16 * 1024;
+
+DAVA::AssetCache::CacheItemKey CreateKey(DAVA::uint32 index)
+{
+    DAVA::AssetCache::CacheItemKey key;
+    key.fill(0);
+    Memcpy(key.data(), &index, sizeof(index));
+    return key;
+}
+
+DAVA::float64 ToMbPerSecond(DAVA::uint64 bytes, DAVA::int64 us)
+{
+    return (us > 0) ? static_cast<DAVA::float64>(bytes) / (1024.0 * 1024.0) / (static_cast<DAVA::float64>(us) / 1e6) : 0.0;
+}
+
+DAVA::float64 ToItemsPerSecond(DAVA::uint64 count, DAVA::int64 us)
+{
+    return (us > 0) ? static_cast<DAVA::float64>(count) / (static_cast<DAVA::float64>(us) / 1e6) : 0.0;
+}
+
+DAVA::uint32 CountFailures(const DAVA::Vector<DAVA::AssetCache::Error>& results)
+{
+    return static_cast<DAVA::uint32>(std::count_if(results.begin(), results.end(), [](DAVA::AssetCache::Error result) { return result != DAVA::AssetCache::Error::NO_ERRORS; }));
+}
+}
+
+TransferBenchmark::TransferBenchmark(const DAVA::FilePath& folder_)
+    : folder(folder_)
+{
+    folder.MakeDirectoryPathname();
+}
+
+void TransferBenchmark::OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overall)
+{
+}
+
+void TransferBenchmark::Run(DAVA::uint32 itemSizeMb)
+{
+    using namespace DAVA;
+    using namespace TransferBenchmarkDetails;
+
+    FileSystem::Instance()->DeleteDirectory(folder);
+
+    AssetCache::CachedItemValue value;
+    {
+        std::shared_ptr<Vector<uint8>> data = std::make_shared<Vector<uint8>>(static_cast<size_t>(itemSizeMb) * 1024 * 1024);
+        std::mt19937 random(0);
+        std::generate(data->begin(), data->end(), [&random]() { return static_cast<uint8>(random()); });
+        value.Add("data", data);
+        value.UpdateValidationData();
+    }
+
+    CacheDB dataBase(*this);
+    dataBase.UpdateSettings(folder, value.GetSize() * ITEMS_IN_MEMORY + SMALL_ITEMS_COUNT * SMALL_ITEM_SIZE * 4, ITEMS_IN_MEMORY, 0);
+
+    AssetCache::ServerNetProxy serverProxy(Net::NetCore::Instance()->GetNetEventsDispatcher());
+    serverLogics.Init(&serverProxy, "TransferBenchmark", nullptr, &dataBase);
+    serverProxy.SetListener(this);
+    serverProxy.Listen(BENCHMARK_PORT);
+
+    runIndex = 0;
+    for (uint32 latency : LATENCIES_MS)
+    {
+        latencyMs = latency;
+        RunBigItem(value);
+        RunSmallItems();
+    }
+
+    serverProxy.SetListener(nullptr);
+    serverProxy.Disconnect();
+    delayedRequests.clear();
+    Net::NetCore::Instance()->Update(); // processing of delayed requests that is already posted finishes on empty queue
+
+    FileSystem::Instance()->DeleteDirectory(folder);
+}
+
+void TransferBenchmark::RunBigItem(const DAVA::AssetCache::CachedItemValue& value)
+{
+    using namespace DAVA;
+    using namespace TransferBenchmarkDetails;
+
+    for (uint32 chunksInFlight : CHUNKS_IN_FLIGHT)
+    {
+        AssetCacheClient client;
+        AssetCacheClient::ConnectionParams params;
+        params.port = BENCHMARK_PORT;
+        params.chunksInFlight = chunksInFlight;
+        AssetCache::Error connectResult = client.ConnectSynchronously(params);
+        if (connectResult != AssetCache::Error::NO_ERRORS)
+        {
+            Logger::Error("[TransferBenchmark] can't connect to %s:%u: %s", params.ip.c_str(), BENCHMARK_PORT, AssetCache::ErrorToString(connectResult).c_str());
+            client.Disconnect();
+            return;
+        }
+
+        const AssetCache::CacheItemKey key = CreateKey(runIndex++);
+
+        int64 startTime = SystemTimer::GetUs();
+        AssetCache::Error addResult = client.AddToCacheSynchronously(key, value);
+        int64 addTime = SystemTimer::GetUs() - startTime;
+
+        AssetCache::CachedItemValue receivedValue;
+        startTime = SystemTimer::GetUs();
+        AssetCache::Error getResult = client.RequestFromCacheSynchronously(key, &receivedValue);
+        int64 getTime = SystemTimer::GetUs() - startTime;
+
+        client.Disconnect();
+
+        if (addResult != AssetCache::Error::NO_ERRORS || getResult != AssetCache::Error::NO_ERRORS || receivedValue.GetSize() != value.GetSize())
+        {
+            Logger::Error("[TransferBenchmark] latency %u ms, %u chunks in flight: add %s, get %s", latencyMs, chunksInFlight, AssetCache::ErrorToString(addResult).c_str(), AssetCache::ErrorToString(getResult).c_str());
+            continue;
+        }
+
+        Logger::Info("[TransferBenchmark] latency %u ms, %u chunks in flight: add %.1f MB/s, get %.1f MB/s",
+                     latencyMs, chunksInFlight, ToMbPerSecond(value.GetSize(), addTime), ToMbPerSecond(value.GetSize(), getTime));
+    }
+}
+
+void TransferBenchmark::RunSmallItems()
+{
+    using namespace DAVA;
+    using namespace TransferBenchmarkDetails;
+
+    AssetCacheClient client;
+    AssetCacheClient::ConnectionParams params;
+    params.port = BENCHMARK_PORT;
+    AssetCache::Error connectResult = client.ConnectSynchronously(params);
+    if (connectResult != AssetCache::Error::NO_ERRORS)
+    {
+        Logger::Error("[TransferBenchmark] can't connect to %s:%u: %s", params.ip.c_str(), BENCHMARK_PORT, AssetCache::ErrorToString(connectResult).c_str());
+        client.Disconnect();
+        return;
+    }
+
+    // all items refer to the same data, only keys differ
+    Vector<AssetCache::CachedItemValue> values(SMALL_ITEMS_COUNT);
+    std::shared_ptr<Vector<uint8>> data = std::make_shared<Vector<uint8>>(SMALL_ITEM_SIZE, uint8(1));
+    for (AssetCache::CachedItemValue& value : values)
+    {
+        value.Add("data", data);
+        value.UpdateValidationData();
+    }
+
+    for (bool batched : { false, true })
+    {
+        Vector<AssetCache::CacheItemKey> keys(SMALL_ITEMS_COUNT);
+        for (AssetCache::CacheItemKey& key : keys)
+        {
+            key = CreateKey(runIndex++);
+        }
+
+        Vector<AssetCache::Error> addResults(SMALL_ITEMS_COUNT);
+        int64 startTime = SystemTimer::GetUs();
+        if (batched)
+        {
+            client.AddToCacheSynchronously(keys, values, addResults);
+        }
+        else
+        {
+            for (uint32 i = 0; i < SMALL_ITEMS_COUNT; ++i)
+            {
+                addResults[i] = client.AddToCacheSynchronously(keys[i], values[i]);
+            }
+        }
+        int64 addTime = SystemTimer::GetUs() - startTime;
+
+        Vector<AssetCache::CachedItemValue> receivedValues(SMALL_ITEMS_COUNT);
+        Vector<AssetCache::Error> getResults(SMALL_ITEMS_COUNT);
+        startTime = SystemTimer::GetUs();
+        if (batched)
+        {
+            client.RequestFromCacheSynchronously(keys, receivedValues, getResults);
+        }
+        else
+        {
+            for (uint32 i = 0; i < SMALL_ITEMS_COUNT; ++i)
+            {
+                getResults[i] = client.RequestFromCacheSynchronously(keys[i], &receivedValues[i]);
+            }
+        }
+        int64 getTime = SystemTimer::GetUs() - startTime;
+
+        const char* requestsName = batched ? "batch" : "single";
+        uint32 failuresCount = CountFailures(addResults) + CountFailures(getResults);
+        if (failuresCount > 0)
+        {
+            Logger::Error("[TransferBenchmark] latency %u ms, %u small items by %s requests: %u requests failed", latencyMs, SMALL_ITEMS_COUNT, requestsName, failuresCount);
+            continue;
+        }
+
+        Logger::Info("[TransferBenchmark] latency %u ms, %u small items by %s requests: add %.0f items/s, get %.0f items/s",
+                     latencyMs, SMALL_ITEMS_COUNT, requestsName, ToItemsPerSecond(SMALL_ITEMS_COUNT, addTime), ToItemsPerSecond(SMALL_ITEMS_COUNT, getTime));
+    }
+
+    client.Disconnect();
+}
+
+void TransferBenchmark::OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunkData)
+{
+    // chunk refers to received packet, so it's copied to be passed later
+    std::shared_ptr<DAVA::Vector<DAVA::uint8>> chunk = std::make_shared<DAVA::Vector<DAVA::uint8>>(chunkData.data, chunkData.data + chunkData.size);
+    DelayRequest([=]()
+                 {
+                     serverLogics.OnAddChunkToCache(channel, key, dataSize, numOfChunks, chunkNumber, DAVA::AssetCache::ChunkView(chunk->data(), chunkData.size));
+                 });
+}
+
+void TransferBenchmark::OnChunkRequestedFromCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint32 chunkNumber)
+{
+    DelayRequest([=]()
+                 {
+                     serverLogics.OnChunkRequestedFromCache(channel, key, chunkNumber);
+                 });
+}
+
+void TransferBenchmark::OnRemoveFromCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key)
+{
+    DelayRequest([=]()
+                 {
+                     serverLogics.OnRemoveFromCache(channel, key);
+                 });
+}
+
+void TransferBenchmark::OnClearCache(const std::shared_ptr<DAVA::Net::IChannel>& channel)
+{
+    DelayRequest([=]()
+                 {
+                     serverLogics.OnClearCache(channel);
+                 });
+}
+
+void TransferBenchmark::OnWarmingUp(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key)
+{
+    DelayRequest([=]()
+                 {
+                     serverLogics.OnWarmingUp(channel, key);
+                 });
+}
+
+void TransferBenchmark::OnStatusRequested(const std::shared_ptr<DAVA::Net::IChannel>& channel)
+{
+    DelayRequest([=]()
+                 {
+                     serverLogics.OnStatusRequested(channel);
+                 });
+}
+
+void TransferBenchmark::OnChannelClosed(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::char8* message)
+{
+    // requests of closed channel that are still delayed are passed before
+    DAVA::String reason = (message != nullptr) ? message : "";
+    DelayRequest([=]()
+                 {
+                     serverLogics.OnChannelClosed(channel, reason.c_str());
+                 });
+}
+
+void TransferBenchmark::OnAddBatchToCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::Vector<DAVA::AssetCache::ItemChunkView>& items)
+{
+    // batch is delayed as one request, so chunks of all items are copied into one buffer
+    std::shared_ptr<DAVA::Vector<DAVA::uint8>> chunks = std::make_shared<DAVA::Vector<DAVA::uint8>>();
+    for (const DAVA::AssetCache::ItemChunkView& item : items)
+    {
+        chunks->insert(chunks->end(), item.chunk.data, item.chunk.data + item.chunk.size);
+    }
+
+    DelayRequest([=]()
+                 {
+                     DAVA::Vector<DAVA::AssetCache::ItemChunkView> copiedItems = items;
+                     const DAVA::uint8* chunkData = chunks->data();
+                     for (DAVA::AssetCache::ItemChunkView& item : copiedItems)
+                     {
+                         item.chunk.data = chunkData;
+                         chunkData += item.chunk.size;
+                     }
+                     serverLogics.OnAddBatchToCache(channel, copiedItems);
+                 });
+}
+
+void TransferBenchmark::OnBatchRequestedFromCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::Vector<DAVA::AssetCache::CacheItemKey>& keys)
+{
+    DelayRequest([=]()
+                 {
+                     serverLogics.OnBatchRequestedFromCache(channel, keys);
+                 });
+}
+
+void TransferBenchmark::DelayRequest(const DAVA::Function<void()>& request)
+{
+    if (latencyMs == 0 && delayedRequests.empty())
+    {
+        request();
+        return;
+    }
+
+    bool processingIsScheduled = (delayedRequests.empty() == false);
+
+    DelayedRequest delayedRequest;
+    delayedRequest.processingTime = DAVA::SystemTimer::GetMs() + latencyMs;
+    delayedRequest.request = request;
+    delayedRequests.push_back(delayedRequest);
+
+    if (processingIsScheduled == false)
+    {
+        DAVA::Net::NetCore::Instance()->GetNetEventsDispatcher()->PostEvent(DAVA::MakeFunction(this, &TransferBenchmark::ProcessDelayedRequests));
+    }
+}
+
+void TransferBenchmark::ProcessDelayedRequests()
+{
+    // client waits for responses by updating of net core, so delayed requests are checked on each update
+    // by posting of this method to net events dispatcher until all of them are passed
+    DAVA::int64 currentTime = DAVA::SystemTimer::GetMs();
+    while (delayedRequests.empty() == false && delayedRequests.front().processingTime <= currentTime)
+    {
+        DAVA::Function<void()> request = delayedRequests.front().request;
+        delayedRequests.pop_front();
+        request();
+    }
+
+    if (delayedRequests.empty() == false)
+    {
+        DAVA::Net::NetCore::Instance()->GetNetEventsDispatcher()->PostEvent(DAVA::MakeFunction(this, &TransferBenchmark::ProcessDelayedRequests));
+    }
+}
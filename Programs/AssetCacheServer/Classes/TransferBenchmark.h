@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CacheDB.h"
+#include "ServerLogics.h"
+
+#include <AssetCache/ServerNetProxy.h>
+
+#include <Base/BaseTypes.h>
+#include <FileSystem/FilePath.h>
+#include <Functional/Function.h>
+
+/**
+    Measures throughput of adding and getting of one big item by `AssetCacheClient` from `ServerLogics`
+    that listens on loopback in the same process. Latency of link is simulated by passing requests
+    to server logics with delay, so each request waits for one round trip.
+    Every latency is measured with chunks transferred one by one and with several chunks in flight,
+    and with many small items that are added and got by single requests and by batch requests.
+
+    Run by `AssetCacheServer --benchmark-transfer [itemSizeMb]`, results are written to log.
+*/
+class TransferBenchmark final : public CacheDBOwner,
+                                public DAVA::AssetCache::ServerNetProxyListener
+{
+public:
+    static const DAVA::uint32 DEFAULT_ITEM_SIZE_MB = 64;
+
+    TransferBenchmark(const DAVA::FilePath& folder);
+
+    void Run(DAVA::uint32 itemSizeMb);
+
+private:
+    void OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overall) override;
+
+    //ServerNetProxyListener
+    void OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::AssetCache::ChunkView& chunkData) override;
+    void OnChunkRequestedFromCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint32 chunkNumber) override;
+    void OnRemoveFromCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key) override;
+    void OnClearCache(const std::shared_ptr<DAVA::Net::IChannel>& channel) override;
+    void OnWarmingUp(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key) override;
+    void OnStatusRequested(const std::shared_ptr<DAVA::Net::IChannel>& channel) override;
+    void OnChannelClosed(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::char8* message) override;
+    void OnAddBatchToCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::Vector<DAVA::AssetCache::ItemChunkView>& items) override;
+    void OnBatchRequestedFromCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::Vector<DAVA::AssetCache::CacheItemKey>& keys) override;
+
+    void RunBigItem(const DAVA::AssetCache::CachedItemValue& value);
+    void RunSmallItems();
+
+    void DelayRequest(const DAVA::Function<void()>& request);
+    void ProcessDelayedRequests();
+
+    struct DelayedRequest
+    {
+        DAVA::int64 processingTime = 0;
+        DAVA::Function<void()> request;
+    };
+
+    DAVA::FilePath folder;
+    DAVA::uint32 runIndex = 0;
+    ServerLogics serverLogics;
+
+    DAVA::Deque<DelayedRequest> delayedRequests;
+    DAVA::uint32 latencyMs = 0;
+};
@@ -1,5 +1,7 @@
 #include "UI/AssetCacheServerWindow.h"
 #include "ServerCore.h"
+#include "CacheDBBenchmark.h"
+#include "TransferBenchmark.h"
 #include "Logger/RotationLogger.h"
 
 #include <QtHelpers/RunGuard.h>
@@ -32,6 +34,35 @@ int Process(DAVA::Engine& e)
     alertLogger.SetLogPath("~doc:/AssetCacheServerLogs/alert.log");
     alertLogger.SetLogLevel(DAVA::Logger::LEVEL_INFO);
 
+    const Vector<String>& cmdLine = e.GetCommandLine();
+    auto benchmarkArg = std::find(cmdLine.begin(), cmdLine.end(), "--benchmark-cachedb");
+    if (benchmarkArg != cmdLine.end())
+    {
+        uint32 itemsCount = 0;
+        if (std::next(benchmarkArg) != cmdLine.end())
+        {
+            itemsCount = static_cast<uint32>(std::strtoul(std::next(benchmarkArg)->c_str(), nullptr, 10));
+        }
+
+        CacheDBBenchmark benchmark("~doc:/AssetCacheServerBenchmark/");
+        benchmark.Run(itemsCount > 0 ? itemsCount : CacheDBBenchmark::DEFAULT_ITEMS_COUNT);
+        return 0;
+    }
+
+    auto transferBenchmarkArg = std::find(cmdLine.begin(), cmdLine.end(), "--benchmark-transfer");
+    if (transferBenchmarkArg != cmdLine.end())
+    {
+        uint32 itemSizeMb = 0;
+        if (std::next(transferBenchmarkArg) != cmdLine.end())
+        {
+            itemSizeMb = static_cast<uint32>(std::strtoul(std::next(transferBenchmarkArg)->c_str(), nullptr, 10));
+        }
+
+        TransferBenchmark benchmark("~doc:/AssetCacheServerBenchmark/");
+        benchmark.Run(itemSizeMb > 0 ? itemSizeMb : TransferBenchmark::DEFAULT_ITEM_SIZE_MB);
+        return 0;
+    }
+
     const QString appUid = "{DAVA.AssetCacheServer.Version.1.0.0}";
     const QString appUidPath = QCryptographicHash::hash((appUid).toUtf8(), QCryptographicHash::Sha1).toHex();
     std::unique_ptr<QtHelpers::RunGuard> runGuard = std::make_unique<QtHelpers::RunGuard>(appUidPath);
@@ -10,6 +10,16 @@
 #include "Tests/UniversalTest.h"
 #include "Tests/MaterialsTest.h"
 #include "Tests/LoadingTest.h"
+#include "Tests/JobSystemTest.h"
+#include "Tests/RenderBatchSortTest.h"
+#include "Tests/ResourceArchiveLoadTest.h"
+#include "Tests/FastNameContentionTest.h"
+#include "Tests/SceneFormatLoadTest.h"
+#include "Tests/ParticleSimulationTest.h"
+#include "Tests/PropertyLineBakeTest.h"
+#include "Tests/AnimationCompressionTest.h"
+#include "Tests/FormulaEvaluationTest.h"
+#include "Tests/NetworkLoopbackTest.h"
 
 #include <Version/Version.h>
 
@@ -133,6 +143,85 @@ void GameCore::RegisterTests()
 
         testChain.push_back(new LoadingTest(params));
     }
+
+    // job system test doesn't need any map
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = JobSystemTest::TEST_NAME;
+
+        testChain.push_back(new JobSystemTest(params));
+    }
+
+    // render batch sorting test uses synthetic batches
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = RenderBatchSortTest::TEST_NAME;
+
+        testChain.push_back(new RenderBatchSortTest(params));
+    }
+
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = ResourceArchiveLoadTest::TEST_NAME;
+
+        testChain.push_back(new ResourceArchiveLoadTest(params));
+    }
+
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = FastNameContentionTest::TEST_NAME;
+
+        testChain.push_back(new FastNameContentionTest(params));
+    }
+
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = ParticleSimulationTest::TEST_NAME;
+
+        testChain.push_back(new ParticleSimulationTest(params));
+    }
+
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = PropertyLineBakeTest::TEST_NAME;
+
+        testChain.push_back(new PropertyLineBakeTest(params));
+    }
+
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = AnimationCompressionTest::TEST_NAME;
+
+        testChain.push_back(new AnimationCompressionTest(params));
+    }
+
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = FormulaEvaluationTest::TEST_NAME;
+
+        testChain.push_back(new FormulaEvaluationTest(params));
+    }
+
+    // network test uses loopback connection of NetCore
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = NetworkLoopbackTest::TEST_NAME;
+
+        testChain.push_back(new NetworkLoopbackTest(params));
+    }
+
+    // scene format test compares nested and flat hierarchy of the same maps
+    scenes.clear();
+    LoadMaps(SceneFormatLoadTest::TEST_NAME, scenes);
+
+    for (const auto& scene : scenes)
+    {
+        BaseTest::TestParams params = defaultTestParams;
+        params.sceneName = scene.first;
+        params.scenePath = scene.second;
+
+        testChain.push_back(new SceneFormatLoadTest(params));
+    }
 }
 
 void GameCore::LoadMaps(const String& testName, Vector<std::pair<String, String>>& mapsVector)
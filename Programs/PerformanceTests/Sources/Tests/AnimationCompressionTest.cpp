@@ -0,0 +1,180 @@
+#include "AnimationCompressionTest.h"
+
+#include <Animation/AnimationChannelEncoder.h>
+#include <Animation/AnimationTrack.h>
+
+namespace AnimationCompressionTestDetails
+{
+static const uint32 JOINTS_COUNT = 64;
+static const uint32 KEYS_COUNT = 300; // 10 seconds sampled at 30 fps, as exporters write it
+static const float32 KEY_INTERVAL = 1.f / 30.f;
+static const uint32 FRAMES_COUNT = 2000;
+static const float32 FRAME_TIME = 1.f / 60.f;
+
+struct Clip
+{
+    Vector<uint8> data;
+    Vector<AnimationTrack> tracks;
+};
+
+void ReportStatistic(const String& key, float64 value)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", value)).c_str());
+}
+
+// Every joint has position, orientation and scale channels with smooth motion of own phase
+Clip CreateClip(const AnimationChannelEncoder::Settings& settings)
+{
+    Clip clip;
+    Vector<size_t> trackOffsets;
+    for (uint32 j = 0; j < JOINTS_COUNT; ++j)
+    {
+        trackOffsets.push_back(clip.data.size());
+
+        uint32 header[] = { AnimationTrack::ANIMATION_TRACK_DATA_SIGNATURE, 3 };
+        const uint8* headerBytes = reinterpret_cast<const uint8*>(header);
+        clip.data.insert(clip.data.end(), headerBytes, headerBytes + sizeof(header));
+
+        float32 phase = float32(j) * 0.37f;
+        for (uint32 target = 0; target < AnimationTrack::CHANNEL_TARGET_COUNT; ++target)
+        {
+            uint32 dimension = (target == AnimationTrack::CHANNEL_TARGET_POSITION) ? 3 : (target == AnimationTrack::CHANNEL_TARGET_ORIENTATION) ? 4 : 1;
+            AnimationChannel::eInterpolation interpolation = (dimension == 4) ? AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR : AnimationChannel::INTERPOLATION_LINEAR;
+
+            Vector<AnimationChannelEncoder::Key> keys(KEYS_COUNT);
+            for (uint32 k = 0; k < KEYS_COUNT; ++k)
+            {
+                float32 time = float32(k) * KEY_INTERVAL;
+                keys[k].time = time;
+                if (dimension == 4)
+                {
+                    Quaternion q;
+                    q.Construct(Normalize(Vector3(std::sin(time + phase), std::cos(time * 0.7f), 0.5f)), std::sin(time * 2.f + phase));
+                    keys[k].value = Vector4(q.x, q.y, q.z, q.w);
+                }
+                else
+                {
+                    keys[k].value = Vector4(std::sin(time * 3.f + phase) * 0.1f, std::cos(time + phase), 1.f + 0.01f * time, 0.f);
+                }
+            }
+
+            uint8 trackPart[] = { uint8(target), 0, 0, 0 };
+            clip.data.insert(clip.data.end(), trackPart, trackPart + sizeof(trackPart));
+            AnimationChannelEncoder::WriteChannel(clip.data, dimension, interpolation, keys, settings);
+        }
+    }
+
+    clip.tracks.resize(JOINTS_COUNT);
+    for (uint32 j = 0; j < JOINTS_COUNT; ++j)
+    {
+        clip.tracks[j].Bind(clip.data.data() + trackOffsets[j]);
+    }
+    return clip;
+}
+
+// Evaluate every track each frame as skeleton animation does, values of the last frame are left in `values`
+uint64 Evaluate(const Clip& clip, Vector<float32>& values)
+{
+    Vector<AnimationChannel::Cursor> cursors(JOINTS_COUNT * AnimationTrack::CHANNEL_TARGET_COUNT);
+    values.resize(JOINTS_COUNT * 8);
+
+    uint64 start = SystemTimer::GetUs();
+    float32 duration = float32(KEYS_COUNT - 1) * KEY_INTERVAL;
+    float32 time = 0.f;
+    for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+    {
+        for (uint32 j = 0; j < JOINTS_COUNT; ++j)
+        {
+            clip.tracks[j].EvaluateAll(time, cursors.data() + j * AnimationTrack::CHANNEL_TARGET_COUNT, values.data() + j * 8, 8);
+        }
+
+        time += FRAME_TIME;
+        if (time > duration)
+            time -= duration;
+    }
+    return SystemTimer::GetUs() - start;
+}
+}
+
+const String AnimationCompressionTest::TEST_NAME = "AnimationCompressionTest";
+
+AnimationCompressionTest::AnimationCompressionTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void AnimationCompressionTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(TEST_NAME));
+    AddControl(testText);
+}
+
+void AnimationCompressionTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void AnimationCompressionTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+void AnimationCompressionTest::RunBenchmarks()
+{
+    using namespace AnimationCompressionTestDetails;
+
+    AnimationChannelEncoder::Settings rawSettings;
+    rawSettings.compress = false;
+    rawSettings.tolerance = 0.f;
+
+    Clip rawClip = CreateClip(rawSettings);
+    Clip compressedClip = CreateClip(AnimationChannelEncoder::Settings());
+
+    Vector<float32> rawValues;
+    Vector<float32> compressedValues;
+    uint64 rawUs = Evaluate(rawClip, rawValues);
+    uint64 compressedUs = Evaluate(compressedClip, compressedValues);
+
+    // quaternions may come with opposite sign after compression
+    float32 error = 0.f;
+    for (size_t i = 0; i < rawValues.size(); ++i)
+    {
+        error = Max(error, Min(std::abs(rawValues[i] - compressedValues[i]), std::abs(rawValues[i] + compressedValues[i])));
+    }
+
+    const float64 evaluationsCount = float64(FRAMES_COUNT) * JOINTS_COUNT;
+    ReportStatistic("Raw_clip_bytes", float64(rawClip.data.size()));
+    ReportStatistic("Compressed_clip_bytes", float64(compressedClip.data.size()));
+    ReportStatistic("Raw_track_ns", rawUs * 1000.0 / evaluationsCount);
+    ReportStatistic("Compressed_track_ns", compressedUs * 1000.0 / evaluationsCount);
+    ReportStatistic("Compressed_error", error);
+}
+
+void AnimationCompressionTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void AnimationCompressionTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool AnimationCompressionTest::IsFinished() const
+{
+    return finished;
+}
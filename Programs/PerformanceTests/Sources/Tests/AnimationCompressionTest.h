@@ -0,0 +1,40 @@
+#ifndef __ANIMATION_COMPRESSION_TEST_H__
+#define __ANIMATION_COMPRESSION_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Builds the same skeleton clip with raw and with compressed animation channels,
+    reports memory per clip, nanoseconds per evaluated joint track and the largest error of compressed clip.
+*/
+class AnimationCompressionTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    AnimationCompressionTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "FastNameContentionTest.h"
+
+#include <Base/FastName.h>
+#include <Concurrency/LockGuard.h>
+#include <Concurrency/Spinlock.h>
+#include <Concurrency/Thread.h>
+
+namespace FastNameContentionTestDetails
+{
+static const uint32 THREAD_COUNTS[] = { 1, 2, 4, 8, 16 };
+static const uint32 NAMES_PER_THREAD = 200000;
+static const uint32 EXISTING_NAMES_COUNT = 20000;
+// every NEW_NAME_PERIOD-th constructed name is not interned yet
+static const uint32 NEW_NAME_PERIOD = 10;
+
+// Interning as it was done before the sharded table, for comparison
+class LegacyNameDB
+{
+public:
+    LegacyNameDB()
+        : nameToIndexMap(8192 * 2)
+    {
+    }
+
+    const char* Intern(const char* name)
+    {
+        LockGuard<Spinlock> guard(mutex);
+        auto it = nameToIndexMap.find(name);
+        if (it != nameToIndexMap.end())
+        {
+            return namesTable[it->second].get();
+        }
+
+        size_t nameSize = strlen(name) + 1;
+        namesTable.emplace_back(new char[nameSize]);
+        memcpy(namesTable.back().get(), name, nameSize);
+        nameToIndexMap.emplace(namesTable.back().get(), namesTable.size() - 1);
+        return namesTable.back().get();
+    }
+
+private:
+    struct NameHash
+    {
+        size_t operator()(const char* str) const
+        {
+            return DavaHashString(str);
+        }
+    };
+
+    struct NameEqualTo
+    {
+        bool operator()(const char* left, const char* right) const
+        {
+            return strcmp(left, right) == 0;
+        }
+    };
+
+    Vector<std::unique_ptr<char[]>> namesTable;
+    UnorderedMap<const char*, size_t, NameHash, NameEqualTo> nameToIndexMap;
+    Spinlock mutex;
+};
+
+// Names are prepared up front, so only interning is measured
+Vector<Vector<String>> PrepareNames(const String& prefix, uint32 threadCount)
+{
+    Vector<Vector<String>> names(threadCount);
+    for (uint32 t = 0; t < threadCount; ++t)
+    {
+        names[t].reserve(NAMES_PER_THREAD);
+        for (uint32 i = 0; i < NAMES_PER_THREAD; ++i)
+        {
+            if (i % NEW_NAME_PERIOD == 0)
+            {
+                names[t].push_back(Format("%s_new_%u_%u", prefix.c_str(), t, i));
+            }
+            else
+            {
+                names[t].push_back(Format("existing_name_%u", (i * 7919 + t * 104729) % EXISTING_NAMES_COUNT));
+            }
+        }
+    }
+    return names;
+}
+
+template <typename InternFn>
+uint64 MeasureThreads(const Vector<Vector<String>>& names, InternFn internFn)
+{
+    Vector<Thread*> threads;
+    for (const Vector<String>& threadNames : names)
+    {
+        threads.push_back(Thread::Create([&threadNames, &internFn]() {
+            for (const String& name : threadNames)
+            {
+                internFn(name.c_str());
+            }
+        }));
+    }
+
+    uint64 start = SystemTimer::GetUs();
+    for (Thread* thread : threads)
+    {
+        thread->Start();
+    }
+    for (Thread* thread : threads)
+    {
+        thread->Join();
+        SafeRelease(thread);
+    }
+    return SystemTimer::GetUs() - start;
+}
+
+void ReportStatistic(const String& key, uint64 timeUs)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", timeUs / 1000.0)).c_str());
+}
+}
+
+const String FastNameContentionTest::TEST_NAME = "FastNameContentionTest";
+
+FastNameContentionTest::FastNameContentionTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void FastNameContentionTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(TEST_NAME));
+    AddControl(testText);
+}
+
+void FastNameContentionTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void FastNameContentionTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+void FastNameContentionTest::RunBenchmarks()
+{
+    using namespace FastNameContentionTestDetails;
+
+    LegacyNameDB legacyDB;
+    for (uint32 i = 0; i < EXISTING_NAMES_COUNT; ++i)
+    {
+        String name = Format("existing_name_%u", i);
+        FastName fn(name);
+        legacyDB.Intern(name.c_str());
+    }
+
+    for (uint32 threadCount : THREAD_COUNTS)
+    {
+        // new names are unique for every run, so both databases insert the same amount
+        Vector<Vector<String>> legacyNames = PrepareNames(Format("legacy_%u", threadCount), threadCount);
+        Vector<Vector<String>> fastNames = PrepareNames(Format("sharded_%u", threadCount), threadCount);
+
+        uint64 legacyUs = MeasureThreads(legacyNames, [&legacyDB](const char* name) { legacyDB.Intern(name); });
+        uint64 shardedUs = MeasureThreads(fastNames, [](const char* name) { FastName fn(name); });
+
+        Logger::Info("FastNameContentionTest: %u threads, %u names per thread", threadCount, NAMES_PER_THREAD);
+        ReportStatistic(Format("Legacy_intern_%u_threads_ms", threadCount), legacyUs);
+        ReportStatistic(Format("FastName_intern_%u_threads_ms", threadCount), shardedUs);
+    }
+}
+
+void FastNameContentionTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void FastNameContentionTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool FastNameContentionTest::IsFinished() const
+{
+    return finished;
+}
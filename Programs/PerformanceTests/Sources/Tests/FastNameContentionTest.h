@@ -0,0 +1,41 @@
+#ifndef __FAST_NAME_CONTENTION_TEST_H__
+#define __FAST_NAME_CONTENTION_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Contention benchmark of FastName construction from 1 to 16 threads: mostly existing names
+    with a share of new ones, compared with the previous interning scheme
+    (single UnorderedMap guarded by a spinlock).
+*/
+class FastNameContentionTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    FastNameContentionTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
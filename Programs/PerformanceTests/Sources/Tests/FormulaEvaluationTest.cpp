@@ -0,0 +1,179 @@
+#include "FormulaEvaluationTest.h"
+
+#include <UI/Formula/Private/FormulaParser.h>
+#include <UI/Formula/Private/FormulaExecutor.h>
+#include <UI/Formula/Private/FormulaProgram.h>
+#include <Reflection/ReflectionRegistrator.h>
+
+class FormulaEvaluationTestData : public ReflectionBase
+{
+    DAVA_VIRTUAL_REFLECTION(FormulaEvaluationTestData);
+
+public:
+    float flVal = 0.5f;
+    bool bVal = false;
+    String strVal = "Hello, world";
+    int intVal = 42;
+    Vector<int> array;
+    Map<String, int> map;
+
+    FormulaEvaluationTestData()
+    {
+        array.push_back(10);
+        array.push_back(20);
+        array.push_back(30);
+
+        map["a"] = 11;
+        map["b"] = 22;
+        map["c"] = 33;
+    }
+
+    int sum(const std::shared_ptr<FormulaContext>& context, int a, int b)
+    {
+        return a + b;
+    }
+
+    String intToStr(const std::shared_ptr<FormulaContext>& context, int a)
+    {
+        return Format("*%d*", a);
+    }
+};
+
+DAVA_VIRTUAL_REFLECTION_IMPL(FormulaEvaluationTestData)
+{
+    ReflectionRegistrator<FormulaEvaluationTestData>::Begin()
+    .Field("fl", &FormulaEvaluationTestData::flVal)
+    .Field("b", &FormulaEvaluationTestData::bVal)
+    .Field("str", &FormulaEvaluationTestData::strVal)
+    .Field("intVal", &FormulaEvaluationTestData::intVal)
+    .Field("array", &FormulaEvaluationTestData::array)
+    .Field("map", &FormulaEvaluationTestData::map)
+    .Method("sum", &FormulaEvaluationTestData::sum)
+    .Method("intToStr", &FormulaEvaluationTestData::intToStr)
+    .End();
+};
+
+namespace FormulaEvaluationTestDetails
+{
+static const uint32 ITERATIONS_COUNT = 20000;
+
+struct FormulaSet
+{
+    String name;
+    Vector<String> formulas;
+};
+
+void ReportStatistic(const String& key, float64 value)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", value)).c_str());
+}
+
+void Benchmark(const FormulaSet& set, const std::shared_ptr<FormulaContext>& context)
+{
+    Vector<std::shared_ptr<FormulaExpression>> expressions;
+    Vector<std::unique_ptr<FormulaProgram>> programs;
+    for (const String& str : set.formulas)
+    {
+        expressions.push_back(FormulaParser(str).ParseExpression());
+        programs.emplace_back(new FormulaProgram(expressions.back()));
+    }
+
+    // data binding creates executor for every calculation
+    uint64 start = SystemTimer::GetUs();
+    for (uint32 i = 0; i < ITERATIONS_COUNT; ++i)
+    {
+        for (const std::shared_ptr<FormulaExpression>& exp : expressions)
+        {
+            FormulaExecutor executor(context);
+            executor.Calculate(exp.get());
+        }
+    }
+    uint64 executorUs = SystemTimer::GetUs() - start;
+
+    start = SystemTimer::GetUs();
+    for (uint32 i = 0; i < ITERATIONS_COUNT; ++i)
+    {
+        for (const std::unique_ptr<FormulaProgram>& program : programs)
+        {
+            program->Calculate(context);
+        }
+    }
+    uint64 programUs = SystemTimer::GetUs() - start;
+
+    const float64 calculationsCount = float64(ITERATIONS_COUNT) * set.formulas.size();
+    ReportStatistic(Format("%s_Executor_ns", set.name.c_str()), executorUs * 1000.0 / calculationsCount);
+    ReportStatistic(Format("%s_Program_ns", set.name.c_str()), programUs * 1000.0 / calculationsCount);
+}
+}
+
+const String FormulaEvaluationTest::TEST_NAME = "FormulaEvaluationTest";
+
+FormulaEvaluationTest::FormulaEvaluationTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void FormulaEvaluationTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(TEST_NAME));
+    AddControl(testText);
+}
+
+void FormulaEvaluationTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void FormulaEvaluationTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+void FormulaEvaluationTest::RunBenchmarks()
+{
+    using namespace FormulaEvaluationTestDetails;
+
+    FormulaEvaluationTestData data;
+    std::shared_ptr<FormulaContext> context = std::make_shared<FormulaReflectionContext>(Reflection::Create(&data), std::shared_ptr<FormulaContext>());
+
+    const FormulaSet sets[] = {
+        { "Constants", { "5 + 5", "7U-9U", "1---2", "2.0 * 5.5", "6 > 5", "when 5 == 2 -> 0, 1" } },
+        { "FieldAccess", { "intVal", "map.b + intVal", "array[1]", "array[intVal - 41] * fl", "b and (array[1] == 1)", "\"Hello, world\" == str" } },
+        { "Functions", { "sum(16, intVal * 2)", "intToStr(55)", "intToStr(5) == \"*5*\"" } },
+        { "When", { "when b -> 0, intVal > 3 -> intVal, 2", "when intVal > 40 -> fl * 2, fl" } }
+    };
+
+    for (const FormulaSet& set : sets)
+    {
+        Benchmark(set, context);
+    }
+}
+
+void FormulaEvaluationTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void FormulaEvaluationTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool FormulaEvaluationTest::IsFinished() const
+{
+    return finished;
+}
@@ -0,0 +1,40 @@
+#ifndef __FORMULA_EVALUATION_TEST_H__
+#define __FORMULA_EVALUATION_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Calculates formulas of UI formula unit tests with AST executor and with compiled
+    bytecode program, reports nanoseconds per calculated formula.
+*/
+class FormulaEvaluationTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    FormulaEvaluationTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
@@ -0,0 +1,263 @@
+#include "JobSystemTest.h"
+
+#include <Job/JobManager.h>
+#include <Job/JobQueue.h>
+
+namespace JobSystemTestDetails
+{
+static const uint32 BURST_JOBS_COUNT = 200000;
+static const uint32 LEGACY_QUEUE_CAPACITY = 1024; // JobQueueWorker asserts when more jobs are pushed at once
+static const uint32 PARALLEL_FOR_COUNT = 4 * 1024 * 1024;
+static const uint32 PARALLEL_FOR_GRAIN = 4096;
+static const uint32 REPEAT_COUNT = 5;
+
+// Small amount of work that can't be optimized away
+void TinyWork(std::atomic<uint32>* counter, uint32 seed)
+{
+    uint32 x = seed + 1;
+    for (uint32 i = 0; i < 64; ++i)
+    {
+        x = x * 1664525u + 1013904223u;
+    }
+    counter->fetch_add(x & 1, std::memory_order_relaxed);
+}
+
+void ChunkWork(Vector<float32>& values, uint32 begin, uint32 end)
+{
+    for (uint32 i = begin; i < end; ++i)
+    {
+        values[i] = std::sqrt(values[i] * 0.5f + static_cast<float32>(i));
+    }
+}
+
+// Reproduces worker loop of the legacy JobManager on top of JobQueueWorker
+class LegacyJobQueueRunner
+{
+public:
+    LegacyJobQueueRunner(uint32 threadsCount)
+        : queue(LEGACY_QUEUE_CAPACITY)
+        , doneSem(0)
+    {
+        for (uint32 i = 0; i < threadsCount; ++i)
+        {
+            Thread* thread = Thread::Create([this]() { ThreadFunc(); });
+            thread->Start();
+            threads.push_back(thread);
+        }
+    }
+
+    ~LegacyJobQueueRunner()
+    {
+        cancel = true;
+        while (finishedCount < threads.size())
+        {
+            queue.Broadcast();
+            Thread::Sleep(1);
+        }
+
+        for (Thread* thread : threads)
+        {
+            thread->Join();
+            SafeRelease(thread);
+        }
+    }
+
+    void Push(const Function<void()>& fn)
+    {
+        queue.Push(fn);
+        queue.Signal();
+    }
+
+    void Wait()
+    {
+        while (!queue.IsEmpty())
+        {
+            doneSem.Wait();
+        }
+    }
+
+private:
+    void ThreadFunc()
+    {
+        while (!cancel)
+        {
+            queue.Wait();
+            while (queue.PopAndExec())
+            {
+            }
+            doneSem.Post();
+        }
+        finishedCount++;
+    }
+
+    JobQueueWorker queue;
+    Semaphore doneSem;
+    Vector<Thread*> threads;
+    std::atomic<bool> cancel{ false };
+    std::atomic<uint32> finishedCount{ 0 };
+};
+
+uint64 MeasureLegacyBurst(uint32 threadsCount)
+{
+    LegacyJobQueueRunner runner(threadsCount);
+    std::atomic<uint32> counter(0);
+
+    uint64 start = SystemTimer::GetUs();
+    for (uint32 i = 0; i < BURST_JOBS_COUNT; i += LEGACY_QUEUE_CAPACITY)
+    {
+        uint32 end = std::min(i + LEGACY_QUEUE_CAPACITY, BURST_JOBS_COUNT);
+        for (uint32 j = i; j < end; ++j)
+        {
+            runner.Push([&counter, j]() { TinyWork(&counter, j); });
+        }
+        runner.Wait();
+    }
+    return SystemTimer::GetUs() - start;
+}
+
+uint64 MeasureStealingBurst(JobManager* jobManager)
+{
+    std::atomic<uint32> counter(0);
+
+    uint64 start = SystemTimer::GetUs();
+    for (uint32 i = 0; i < BURST_JOBS_COUNT; ++i)
+    {
+        jobManager->CreateWorkerJob([&counter, i]() { TinyWork(&counter, i); });
+    }
+    jobManager->WaitWorkerJobs();
+    return SystemTimer::GetUs() - start;
+}
+
+uint64 MeasureStealingNestedBurst(JobManager* jobManager)
+{
+    std::atomic<uint32> counter(0);
+    uint32 workersCount = std::max(jobManager->GetWorkersCount(), 1u);
+    uint32 jobsPerSpawner = BURST_JOBS_COUNT / workersCount;
+
+    // jobs spawned from workers go to their local deques
+    uint64 start = SystemTimer::GetUs();
+    for (uint32 w = 0; w < workersCount; ++w)
+    {
+        jobManager->CreateWorkerJob([jobManager, &counter, jobsPerSpawner, w]() {
+            for (uint32 i = 0; i < jobsPerSpawner; ++i)
+            {
+                uint32 seed = w * jobsPerSpawner + i;
+                jobManager->CreateWorkerJob([&counter, seed]() { TinyWork(&counter, seed); });
+            }
+        });
+    }
+    jobManager->WaitWorkerJobs();
+    return SystemTimer::GetUs() - start;
+}
+
+uint64 MeasureLegacyParallelLoop(uint32 threadsCount, Vector<float32>& values)
+{
+    LegacyJobQueueRunner runner(threadsCount);
+
+    uint64 start = SystemTimer::GetUs();
+    for (uint32 i = 0; i < PARALLEL_FOR_COUNT; i += PARALLEL_FOR_GRAIN)
+    {
+        uint32 end = std::min(i + PARALLEL_FOR_GRAIN, PARALLEL_FOR_COUNT);
+        runner.Push([&values, i, end]() { ChunkWork(values, i, end); });
+    }
+    runner.Wait();
+    return SystemTimer::GetUs() - start;
+}
+
+uint64 MeasureParallelFor(JobManager* jobManager, Vector<float32>& values)
+{
+    uint64 start = SystemTimer::GetUs();
+    jobManager->ParallelFor(0, PARALLEL_FOR_COUNT, PARALLEL_FOR_GRAIN, [&values](uint32 begin, uint32 end) {
+        ChunkWork(values, begin, end);
+    });
+    return SystemTimer::GetUs() - start;
+}
+
+void ReportStatistic(const String& key, uint64 bestTimeUs)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", bestTimeUs / 1000.0)).c_str());
+}
+}
+
+const String JobSystemTest::TEST_NAME = "JobSystemTest";
+
+JobSystemTest::JobSystemTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void JobSystemTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(TEST_NAME));
+    AddControl(testText);
+}
+
+void JobSystemTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void JobSystemTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+void JobSystemTest::RunBenchmarks()
+{
+    using namespace JobSystemTestDetails;
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    uint32 workersCount = jobManager->GetWorkersCount();
+
+    uint64 legacyBurst = std::numeric_limits<uint64>::max();
+    uint64 stealingBurst = std::numeric_limits<uint64>::max();
+    uint64 stealingNestedBurst = std::numeric_limits<uint64>::max();
+    uint64 legacyLoop = std::numeric_limits<uint64>::max();
+    uint64 parallelFor = std::numeric_limits<uint64>::max();
+
+    Vector<float32> values(PARALLEL_FOR_COUNT, 1.0f);
+    for (uint32 i = 0; i < REPEAT_COUNT; ++i)
+    {
+        legacyBurst = std::min(legacyBurst, MeasureLegacyBurst(workersCount));
+        stealingBurst = std::min(stealingBurst, MeasureStealingBurst(jobManager));
+        stealingNestedBurst = std::min(stealingNestedBurst, MeasureStealingNestedBurst(jobManager));
+        legacyLoop = std::min(legacyLoop, MeasureLegacyParallelLoop(workersCount, values));
+        parallelFor = std::min(parallelFor, MeasureParallelFor(jobManager, values));
+    }
+
+    Logger::Info("JobSystemTest: %u workers, %u tiny jobs, %u elements loop", workersCount, BURST_JOBS_COUNT, PARALLEL_FOR_COUNT);
+    ReportStatistic("Legacy_queue_burst_ms", legacyBurst);
+    ReportStatistic("Work_stealing_burst_ms", stealingBurst);
+    ReportStatistic("Work_stealing_nested_burst_ms", stealingNestedBurst);
+    ReportStatistic("Legacy_queue_loop_ms", legacyLoop);
+    ReportStatistic("Parallel_for_loop_ms", parallelFor);
+}
+
+void JobSystemTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void JobSystemTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool JobSystemTest::IsFinished() const
+{
+    return finished;
+}
@@ -0,0 +1,40 @@
+#ifndef __JOB_SYSTEM_TEST_H__
+#define __JOB_SYSTEM_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Microbenchmark of worker jobs: compares work-stealing JobManager with the legacy
+    single-lock JobQueueWorker on bursts of tiny jobs and on chunked parallel loops.
+*/
+class JobSystemTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    JobSystemTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
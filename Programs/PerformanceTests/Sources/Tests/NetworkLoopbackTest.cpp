@@ -0,0 +1,297 @@
+#include "NetworkLoopbackTest.h"
+
+#include <Network/NetCore.h>
+#include <Network/NetConfig.h>
+#include <Network/NetService.h>
+#include <Network/Base/Endpoint.h>
+#include <Network/Private/ProtoTypes.h>
+
+namespace NetworkLoopbackTestDetails
+{
+using namespace DAVA::Net;
+
+static const uint32 SERVICE_BULK = 1100; // big packets like memory profiler snapshots
+static const uint32 SERVICE_MESSAGES = 1101; // small packets like logger messages
+static const uint16 FIRST_PORT = 55201;
+static const uint32 BULK_PACKET_SIZE = 1024 * 1024;
+static const uint32 BULK_PACKETS_COUNT = 128;
+static const uint32 PING_SIZE = 128;
+static const uint64 RUN_TIMEOUT_US = 60 * 1000 * 1000;
+
+enum eContext
+{
+    SERVER_CONTEXT = 1,
+    CLIENT_CONTEXT
+};
+
+// Server side: sends all big packets at once as soon as channel is open
+class BulkSender : public NetService
+{
+public:
+    BulkSender()
+        : data(BULK_PACKET_SIZE)
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<uint8>(i);
+        }
+    }
+
+    void ChannelOpen() override
+    {
+        startTime = SystemTimer::GetUs();
+        for (uint32 i = 0; i < BULK_PACKETS_COUNT; ++i)
+        {
+            Send(data.data(), data.size());
+        }
+    }
+
+    uint64 startTime = 0;
+
+private:
+    Vector<uint8> data;
+};
+
+// Client side: counts received bytes of big packets
+class BulkReceiver : public NetService
+{
+public:
+    void PacketReceived(const void* packet, size_t length) override
+    {
+        bytesReceived += length;
+        if (bytesReceived == static_cast<uint64>(BULK_PACKET_SIZE) * BULK_PACKETS_COUNT)
+        {
+            finishTime = SystemTimer::GetUs();
+        }
+    }
+
+    bool IsDone() const
+    {
+        return finishTime != 0;
+    }
+
+    uint64 bytesReceived = 0;
+    uint64 finishTime = 0;
+};
+
+// Server side: echoes every message through the same connection as big packets
+class MessageEcho : public NetService
+{
+public:
+    void PacketReceived(const void* packet, size_t length) override
+    {
+        Send(echoData.data(), length);
+    }
+
+private:
+    Array<uint8, PING_SIZE> echoData = {};
+};
+
+// Client side: sends next ping after previous one is echoed until all big packets are received
+class MessagePinger : public NetService
+{
+public:
+    MessagePinger(const BulkReceiver* bulkReceiver_)
+        : bulkReceiver(bulkReceiver_)
+    {
+    }
+
+    void ChannelOpen() override
+    {
+        SendPing();
+    }
+
+    void PacketReceived(const void* packet, size_t length) override
+    {
+        roundTripTimeSum += SystemTimer::GetUs() - pingTime;
+        pingsCount += 1;
+        if (!bulkReceiver->IsDone())
+        {
+            SendPing();
+        }
+    }
+
+    uint64 roundTripTimeSum = 0;
+    uint32 pingsCount = 0;
+
+private:
+    void SendPing()
+    {
+        pingTime = SystemTimer::GetUs();
+        Send(pingData.data(), pingData.size());
+    }
+
+    const BulkReceiver* bulkReceiver = nullptr;
+    Array<uint8, PING_SIZE> pingData = {};
+    uint64 pingTime = 0;
+};
+
+struct LoopbackServices
+{
+    BulkSender bulkSender;
+    BulkReceiver bulkReceiver;
+    MessageEcho messageEcho;
+    MessagePinger messagePinger{ &bulkReceiver };
+};
+
+struct LoopbackResult
+{
+    bool done = false;
+    float64 megabytesPerSecond = 0.0;
+    float64 averagePingUs = 0.0;
+    uint32 pingsCount = 0;
+};
+
+void PollUntil(const Function<bool()>& condition, uint64 timeoutUs)
+{
+    uint64 start = SystemTimer::GetUs();
+    while (!condition() && SystemTimer::GetUs() - start < timeoutUs)
+    {
+        NetCore::Instance()->Poll();
+    }
+}
+
+LoopbackResult RunLoopback(size_t sendBudget, uint16 port)
+{
+    LoopbackServices services;
+    NetCore* netCore = NetCore::Instance();
+
+    ServiceCreator creator = [&services](uint32 serviceId, void* context) -> IChannelListener* {
+        bool isServer = reinterpret_cast<intptr_t>(context) == SERVER_CONTEXT;
+        if (serviceId == SERVICE_BULK)
+        {
+            return isServer ? static_cast<IChannelListener*>(&services.bulkSender) : &services.bulkReceiver;
+        }
+        return isServer ? static_cast<IChannelListener*>(&services.messageEcho) : &services.messagePinger;
+    };
+    ServiceDeleter deleter = [](IChannelListener*, void*) {};
+    netCore->RegisterService(SERVICE_BULK, creator, deleter, "Bulk");
+    netCore->RegisterService(SERVICE_MESSAGES, creator, deleter, "Messages");
+
+    NetConfig serverConfig(SERVER_ROLE);
+    serverConfig.AddTransport(TRANSPORT_TCP, Endpoint(port));
+    serverConfig.AddService(SERVICE_BULK);
+    serverConfig.AddService(SERVICE_MESSAGES);
+    serverConfig.SetSendBudget(sendBudget);
+
+    NetConfig clientConfig = serverConfig.Mirror(IPAddress("127.0.0.1"));
+
+    NetCore::TrackId serverId = netCore->CreateController(serverConfig, reinterpret_cast<void*>(SERVER_CONTEXT));
+    NetCore::TrackId clientId = netCore->CreateController(clientConfig, reinterpret_cast<void*>(CLIENT_CONTEXT));
+
+    PollUntil([&services]() { return services.bulkReceiver.IsDone(); }, RUN_TIMEOUT_US);
+
+    LoopbackResult result;
+    result.done = services.bulkReceiver.IsDone();
+    if (result.done)
+    {
+        uint64 durationUs = std::max<uint64>(services.bulkReceiver.finishTime - services.bulkSender.startTime, 1);
+        result.megabytesPerSecond = static_cast<float64>(services.bulkReceiver.bytesReceived) / durationUs * 1000000.0 / (1024.0 * 1024.0);
+        result.pingsCount = services.messagePinger.pingsCount;
+        if (result.pingsCount > 0)
+        {
+            result.averagePingUs = static_cast<float64>(services.messagePinger.roundTripTimeSum) / result.pingsCount;
+        }
+    }
+
+    // callbacks may outlive this function if controllers aren't destroyed in time
+    std::shared_ptr<uint32> destroyedCount = std::make_shared<uint32>(0);
+    netCore->DestroyController(serverId, [destroyedCount]() { *destroyedCount += 1; });
+    netCore->DestroyController(clientId, [destroyedCount]() { *destroyedCount += 1; });
+    PollUntil([destroyedCount]() { return *destroyedCount == 2; }, RUN_TIMEOUT_US);
+
+    netCore->UnregisterService(SERVICE_BULK);
+    netCore->UnregisterService(SERVICE_MESSAGES);
+    return result;
+}
+
+void ReportStatistic(const String& key, float64 value)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", value)).c_str());
+}
+
+void ReportResult(const String& prefix, const LoopbackResult& result)
+{
+    if (result.done)
+    {
+        Logger::Info("NetworkLoopbackTest: %s, %.1f MB/s, %u pings", prefix.c_str(), result.megabytesPerSecond, result.pingsCount);
+        ReportStatistic(prefix + "_MBps", result.megabytesPerSecond);
+        ReportStatistic(prefix + "_ping_us", result.averagePingUs);
+    }
+    else
+    {
+        Logger::Error("NetworkLoopbackTest: %s, transfer isn't finished in time", prefix.c_str());
+    }
+}
+}
+
+const String NetworkLoopbackTest::TEST_NAME = "NetworkLoopbackTest";
+
+NetworkLoopbackTest::NetworkLoopbackTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void NetworkLoopbackTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(TEST_NAME));
+    AddControl(testText);
+}
+
+void NetworkLoopbackTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void NetworkLoopbackTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+void NetworkLoopbackTest::RunBenchmarks()
+{
+    using namespace NetworkLoopbackTestDetails;
+
+    if (Net::NetCore::Instance() == nullptr)
+    {
+        Logger::Error("NetworkLoopbackTest: NetCore module isn't created");
+        return;
+    }
+
+    // NetCore is polled here so network must not run in separate thread
+    LoopbackResult singleFrame = RunLoopback(Net::PROTO_MAX_FRAME_SIZE, FIRST_PORT);
+    LoopbackResult batched = RunLoopback(Net::DEFAULT_SEND_BUDGET, FIRST_PORT + 1);
+
+    Logger::Info("NetworkLoopbackTest: %u packets of %u bytes with %u bytes pings", BULK_PACKETS_COUNT, BULK_PACKET_SIZE, PING_SIZE);
+    ReportResult("Loopback_single_frame", singleFrame);
+    ReportResult("Loopback_batched", batched);
+}
+
+void NetworkLoopbackTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void NetworkLoopbackTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool NetworkLoopbackTest::IsFinished() const
+{
+    return finished;
+}
@@ -0,0 +1,41 @@
+#ifndef __NETWORK_LOOPBACK_TEST_H__
+#define __NETWORK_LOOPBACK_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Sends memory profiler sized packets and logger sized ping messages over loopback TCP through
+    NetCore services, reports throughput of big packets and round trip time of small messages
+    with one frame per transport write and with default send budget of ProtoDriver.
+*/
+class NetworkLoopbackTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    NetworkLoopbackTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
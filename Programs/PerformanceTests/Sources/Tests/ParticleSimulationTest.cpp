@@ -0,0 +1,183 @@
+#include "ParticleSimulationTest.h"
+
+#include <Particles/ParticleEmitter.h>
+#include <Particles/ParticleLayer.h>
+#include <Particles/ParticleKernels.h>
+#include <Scene3D/Components/ParticleEffectComponent.h>
+#include <Scene3D/Components/TransformComponent.h>
+#include <Scene3D/Systems/ParticleEffectSystem.h>
+
+namespace ParticleSimulationTestDetails
+{
+static const uint32 EFFECTS_COUNT = 200;
+static const uint32 WARMUP_FRAMES = 120; // particles live 2 seconds, so pools are full after it
+static const uint32 MEASURED_FRAMES = 600;
+static const float32 FRAME_TIME = 1.f / 60.f;
+
+template <class T>
+RefPtr<PropertyLine<T>> MakeValue(const T& value)
+{
+    return RefPtr<PropertyLine<T>>(new PropertyLineValue<T>(value));
+}
+
+RefPtr<PropertyLine<float32>> MakeKeyframes(float32 from, float32 to)
+{
+    RefPtr<PropertyLineKeyframes<float32>> line(new PropertyLineKeyframes<float32>());
+    line->AddValue(0.f, from);
+    line->AddValue(0.5f, (from + to) * 0.5f);
+    line->AddValue(1.f, to);
+    return line;
+}
+
+// Emitter with one layer using the same property lines as typical smoke and sparks effects
+ParticleEmitter* CreateEmitter()
+{
+    ParticleEmitter* emitter = new ParticleEmitter();
+    emitter->emissionRange = MakeValue(180.f);
+
+    ScopedPtr<ParticleLayer> layer(new ParticleLayer());
+    layer->isLooped = true;
+    layer->life = MakeValue(2.f);
+    layer->lifeVariation = MakeValue(0.5f);
+    layer->number = MakeValue(250.f);
+    layer->size = MakeValue(Vector2(1.f, 1.f));
+    layer->sizeOverLifeXY = RefPtr<PropertyLine<Vector2>>(new PropertyLineValue<Vector2>(Vector2(2.f, 2.f)));
+    layer->velocity = MakeValue(5.f);
+    layer->velocityVariation = MakeValue(1.f);
+    layer->velocityOverLife = MakeKeyframes(1.f, 0.2f);
+    layer->spin = MakeValue(90.f);
+    layer->spinOverLife = MakeKeyframes(1.f, 0.f);
+
+    ScopedPtr<ParticleForceSimplified> gravity(new ParticleForceSimplified(MakeValue(Vector3(0.f, 0.f, -9.8f)), MakeKeyframes(0.f, 1.f)));
+    layer->AddSimplifiedForce(gravity);
+
+    emitter->AddLayer(layer);
+    return emitter;
+}
+
+uint32 CountParticles(const Vector<ParticleEffectComponent*>& effects)
+{
+    uint32 count = 0;
+    for (ParticleEffectComponent* effect : effects)
+    {
+        count += effect->GetActiveParticlesCount();
+    }
+    return count;
+}
+
+void ReportStatistic(const String& key, float64 value)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", value)).c_str());
+}
+}
+
+const String ParticleSimulationTest::TEST_NAME = "ParticleSimulationTest";
+
+ParticleSimulationTest::ParticleSimulationTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void ParticleSimulationTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(TEST_NAME));
+    AddControl(testText);
+}
+
+void ParticleSimulationTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void ParticleSimulationTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+void ParticleSimulationTest::RunBenchmarks()
+{
+    using namespace ParticleSimulationTestDetails;
+
+    const ParticleKernels::eImplementation implementations[] = {
+        ParticleKernels::eImplementation::SCALAR,
+        ParticleKernels::eImplementation::SSE,
+        ParticleKernels::eImplementation::NEON
+    };
+    const char* implementationNames[] = { "Scalar", "SSE", "NEON" };
+
+    ScopedPtr<ParticleEmitter> emitter(CreateEmitter());
+
+    for (uint32 i = 0; i < COUNT_OF(implementations); ++i)
+    {
+        if (!ParticleKernels::IsImplementationAvailable(implementations[i]))
+        {
+            continue;
+        }
+
+        // every implementation simulates its own scene from scratch
+        ScopedPtr<Scene> scene(new Scene());
+        scene->particleEffectSystem->SetKernelsImplementation(implementations[i]);
+
+        Vector<ParticleEffectComponent*> effects;
+        for (uint32 e = 0; e < EFFECTS_COUNT; ++e)
+        {
+            ScopedPtr<Entity> entity(new Entity());
+            entity->GetComponent<TransformComponent>()->SetLocalTranslation(Vector3(float32(e % 20) * 10.f, float32(e / 20) * 10.f, 0.f));
+
+            ParticleEffectComponent* effect = new ParticleEffectComponent();
+            effect->AddEmitterInstance(emitter.get());
+            entity->AddComponent(effect);
+            scene->AddNode(entity);
+
+            effect->Start();
+            effects.push_back(effect);
+        }
+
+        for (uint32 frame = 0; frame < WARMUP_FRAMES; ++frame)
+        {
+            scene->particleEffectSystem->Process(FRAME_TIME);
+        }
+
+        uint64 updatedParticles = 0;
+        uint64 start = SystemTimer::GetUs();
+        for (uint32 frame = 0; frame < MEASURED_FRAMES; ++frame)
+        {
+            scene->particleEffectSystem->Process(FRAME_TIME);
+            updatedParticles += CountParticles(effects);
+        }
+        uint64 elapsedUs = Max(SystemTimer::GetUs() - start, uint64(1));
+
+        Logger::Info("ParticleSimulationTest: %s kernels, %u effects, %u particles", implementationNames[i], EFFECTS_COUNT, CountParticles(effects));
+        ReportStatistic(Format("%s_frame_ms", implementationNames[i]), elapsedUs / 1000.0 / MEASURED_FRAMES);
+        ReportStatistic(Format("%s_mparticles_per_second", implementationNames[i]), float64(updatedParticles) / elapsedUs);
+    }
+}
+
+void ParticleSimulationTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void ParticleSimulationTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool ParticleSimulationTest::IsFinished() const
+{
+    return finished;
+}
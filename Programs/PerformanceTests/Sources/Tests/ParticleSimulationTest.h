@@ -0,0 +1,40 @@
+#ifndef __PARTICLE_SIMULATION_TEST_H__
+#define __PARTICLE_SIMULATION_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Simulates a scene of synthetic particle effects without rendering and reports particles updated per second
+    for every particle kernels implementation available on target (scalar one is the reference).
+*/
+class ParticleSimulationTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    ParticleSimulationTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
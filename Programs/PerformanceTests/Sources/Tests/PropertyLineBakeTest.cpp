@@ -0,0 +1,148 @@
+#include "PropertyLineBakeTest.h"
+
+#include <Particles/ParticlePropertyLine.h>
+
+namespace PropertyLineBakeTestDetails
+{
+static const uint32 KEYS_COUNT = 8;
+static const uint32 BATCH_SIZE = 1024; // typical count of particles in a group
+static const uint32 BATCHES_COUNT = 2000;
+static const float32 TOLERANCE = 0.001f;
+
+template <class T>
+RefPtr<PropertyLineKeyframes<T>> MakeKeyframes(const Vector<T>& values)
+{
+    RefPtr<PropertyLineKeyframes<T>> line(new PropertyLineKeyframes<T>());
+    for (uint32 i = 0; i < KEYS_COUNT; ++i)
+    {
+        line->AddValue(float32(i) / float32(KEYS_COUNT - 1), values[i % values.size()]);
+    }
+    return line;
+}
+
+void ReportStatistic(const String& key, float64 value)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", value)).c_str());
+}
+
+// over life values of particles born at different time
+Vector<float32> MakeOverLife()
+{
+    Vector<float32> overLife(BATCH_SIZE);
+    for (uint32 i = 0; i < BATCH_SIZE; ++i)
+    {
+        overLife[i] = float32((i * 7919) % BATCH_SIZE) / float32(BATCH_SIZE);
+    }
+    return overLife;
+}
+
+template <class T>
+void Benchmark(const String& name, const Vector<T>& keyValues)
+{
+    Vector<float32> overLife = MakeOverLife();
+    Vector<T> values(BATCH_SIZE);
+    Vector<T> exactValues(BATCH_SIZE);
+
+    RefPtr<PropertyLineKeyframes<T>> keyframes = MakeKeyframes(keyValues);
+    PropertyLine<T>* line = keyframes.Get();
+
+    uint64 start = SystemTimer::GetUs();
+    for (uint32 batch = 0; batch < BATCHES_COUNT; ++batch)
+    {
+        for (uint32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            values[i] = line->GetValue(overLife[i]);
+        }
+    }
+    uint64 perValueUs = SystemTimer::GetUs() - start;
+
+    start = SystemTimer::GetUs();
+    for (uint32 batch = 0; batch < BATCHES_COUNT; ++batch)
+    {
+        line->GetValues(overLife.data(), exactValues.data(), BATCH_SIZE);
+    }
+    uint64 batchUs = SystemTimer::GetUs() - start;
+
+    bool baked = keyframes->Bake(TOLERANCE);
+    start = SystemTimer::GetUs();
+    for (uint32 batch = 0; batch < BATCHES_COUNT; ++batch)
+    {
+        line->GetValues(overLife.data(), values.data(), BATCH_SIZE);
+    }
+    uint64 bakedUs = SystemTimer::GetUs() - start;
+
+    float32 error = 0.f;
+    for (uint32 i = 0; i < BATCH_SIZE; ++i)
+    {
+        error = Max(error, PropertyValueHelper::MaxAbsDifference(values[i], exactValues[i]));
+    }
+
+    const float64 valuesCount = float64(BATCH_SIZE) * BATCHES_COUNT;
+    Logger::Info("PropertyLineBakeTest: %s line baked: %s", name.c_str(), baked ? "yes" : "no");
+    ReportStatistic(Format("%s_GetValue_ns", name.c_str()), perValueUs * 1000.0 / valuesCount);
+    ReportStatistic(Format("%s_GetValues_ns", name.c_str()), batchUs * 1000.0 / valuesCount);
+    ReportStatistic(Format("%s_Baked_ns", name.c_str()), bakedUs * 1000.0 / valuesCount);
+    ReportStatistic(Format("%s_Baked_error", name.c_str()), error);
+}
+}
+
+const String PropertyLineBakeTest::TEST_NAME = "PropertyLineBakeTest";
+
+PropertyLineBakeTest::PropertyLineBakeTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void PropertyLineBakeTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(TEST_NAME));
+    AddControl(testText);
+}
+
+void PropertyLineBakeTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void PropertyLineBakeTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+void PropertyLineBakeTest::RunBenchmarks()
+{
+    using namespace PropertyLineBakeTestDetails;
+
+    Benchmark<float32>("Float", { 0.f, 1.f, 0.5f, 0.8f, 0.2f, 1.f, 0.3f, 0.f });
+    Benchmark<Vector2>("Vector2", { Vector2(1.f, 1.f), Vector2(2.f, 1.5f), Vector2(3.f, 1.f), Vector2(2.f, 0.5f) });
+    Benchmark<Color>("Color", { Color(1.f, 1.f, 1.f, 0.f), Color(1.f, 0.5f, 0.f, 1.f), Color(0.5f, 0.5f, 0.5f, 1.f), Color(0.f, 0.f, 0.f, 0.f) });
+}
+
+void PropertyLineBakeTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void PropertyLineBakeTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool PropertyLineBakeTest::IsFinished() const
+{
+    return finished;
+}
@@ -0,0 +1,40 @@
+#ifndef __PROPERTY_LINE_BAKE_TEST_H__
+#define __PROPERTY_LINE_BAKE_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Evaluates keyframed particle property lines with per-value calls, with batch calls and with batch calls
+    over baked lookup tables, reports nanoseconds per evaluated value and the largest error of baked lines.
+*/
+class PropertyLineBakeTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    PropertyLineBakeTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
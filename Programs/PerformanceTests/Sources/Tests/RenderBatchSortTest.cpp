@@ -0,0 +1,252 @@
+#include "RenderBatchSortTest.h"
+
+#include <Render/Highlevel/Camera.h>
+#include <Render/Highlevel/RenderBatch.h>
+#include <Render/Highlevel/RenderBatchArray.h>
+#include <Render/Highlevel/RenderObject.h>
+#include <Render/Material/NMaterial.h>
+#include <Utils/Random.h>
+
+namespace RenderBatchSortTestDetails
+{
+static const uint32 BATCH_COUNTS[] = { 10000, 25000, 50000, 100000 };
+static const uint32 PARENT_MATERIALS_COUNT = 64;
+static const uint32 BATCHES_PER_OBJECT = 4;
+static const uint32 FRAMES_COUNT = 20;
+static const uint32 MAX_BATCH_SORTING_KEY = 15;
+
+// Synthetic set of batches spread over 2km square with materials inherited from a few parents
+class BatchSet
+{
+public:
+    BatchSet(uint32 batchCount)
+    {
+        Random* random = Random::Instance();
+
+        for (uint32 i = 0; i < PARENT_MATERIALS_COUNT; ++i)
+        {
+            parents.push_back(new NMaterial());
+        }
+
+        uint32 objectCount = (batchCount + BATCHES_PER_OBJECT - 1) / BATCHES_PER_OBJECT;
+        matrices.resize(objectCount);
+        for (uint32 i = 0; i < objectCount; ++i)
+        {
+            Vector3 position(random->RandFloat32InBounds(-1000.0f, 1000.0f), random->RandFloat32InBounds(-1000.0f, 1000.0f), 0.0f);
+            matrices[i] = Matrix4::MakeTranslation(position);
+
+            RenderObject* object = new RenderObject();
+            object->SetWorldMatrixPtr(&matrices[i]);
+            objects.push_back(object);
+        }
+
+        for (uint32 i = 0; i < batchCount; ++i)
+        {
+            NMaterial* material = new NMaterial();
+            material->SetParent(parents[random->Rand(PARENT_MATERIALS_COUNT - 1)]);
+
+            RenderBatch* batch = new RenderBatch();
+            batch->SetMaterial(material);
+            batch->SetRenderObject(objects[i / BATCHES_PER_OBJECT]);
+            batch->SetSortingKey(random->Rand(MAX_BATCH_SORTING_KEY));
+            batches.push_back(batch);
+
+            SafeRelease(material);
+        }
+    }
+
+    ~BatchSet()
+    {
+        for (RenderBatch* batch : batches)
+        {
+            SafeRelease(batch);
+        }
+        for (RenderObject* object : objects)
+        {
+            SafeRelease(object);
+        }
+        for (NMaterial* parent : parents)
+        {
+            SafeRelease(parent);
+        }
+    }
+
+    Vector<RenderBatch*> batches;
+
+private:
+    Vector<NMaterial*> parents;
+    Vector<RenderObject*> objects;
+    Vector<Matrix4> matrices;
+};
+
+// Sorting as it was done before packed keys: key is written to batch and std::sort compares through pointers
+void LegacySort(Vector<RenderBatch*>& batches, Camera* camera, uint32 sortFlags)
+{
+    auto compare = [](const RenderBatch* a, const RenderBatch* b) { return a->layerSortingKey > b->layerSortingKey; };
+
+    if (sortFlags & RenderBatchArray::SORT_BY_MATERIAL)
+    {
+        for (RenderBatch* batch : batches)
+        {
+            uint32 materialIndex = batch->GetMaterial()->GetSortingKey();
+            batch->layerSortingKey = static_cast<pointer_size>((materialIndex & 0x0FFFFFFF) | (batch->GetSortingKey() << 28));
+        }
+        std::sort(batches.begin(), batches.end(), compare);
+    }
+    else
+    {
+        Vector3 cameraPosition = camera->GetPosition();
+        Vector3 cameraDirection = camera->GetDirection();
+        for (RenderBatch* batch : batches)
+        {
+            Vector3 delta = batch->GetRenderObject()->GetWorldMatrixPtr()->GetTranslationVector() - cameraPosition;
+            uint32 distance = delta.DotProduct(cameraDirection) < 0 ? 0 : (static_cast<uint32>(delta.Length() * 1000.0f));
+            distance = distance + 31 - batch->GetSortingOffset();
+            batch->layerSortingKey = (distance & 0x0fffffff) | (batch->GetSortingKey() << 28);
+        }
+        std::stable_sort(batches.begin(), batches.end(), compare);
+    }
+}
+
+struct FrameTimes
+{
+    uint64 firstFrameUs = 0;
+    uint64 averageFrameUs = 0;
+};
+
+// Camera slowly moves through the scene, every frame batches come in the same (visibility) order
+template <typename SortFn>
+FrameTimes MeasureFrames(SortFn sortFn)
+{
+    ScopedPtr<Camera> camera(new Camera());
+    camera->SetUp(Vector3(0.0f, 0.0f, 1.0f));
+    camera->SetDirection(Vector3(1.0f, 0.0f, 0.0f));
+
+    FrameTimes times;
+    uint64 totalUs = 0;
+    for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+    {
+        camera->SetPosition(Vector3(frame * 0.5f, 0.0f, 10.0f));
+
+        uint64 start = SystemTimer::GetUs();
+        sortFn(camera);
+        uint64 frameUs = SystemTimer::GetUs() - start;
+
+        if (frame == 0)
+        {
+            times.firstFrameUs = frameUs;
+        }
+        totalUs += frameUs;
+    }
+    times.averageFrameUs = totalUs / FRAMES_COUNT;
+    return times;
+}
+
+FrameTimes MeasureRenderBatchArray(const BatchSet& batchSet, uint32 sortFlags)
+{
+    RenderBatchArray batchArray;
+    batchArray.SetSortingFlags(sortFlags);
+
+    return MeasureFrames([&batchSet, &batchArray](Camera* camera) {
+        batchArray.Clear();
+        for (RenderBatch* batch : batchSet.batches)
+        {
+            batchArray.AddRenderBatch(batch);
+        }
+        batchArray.Sort(camera);
+    });
+}
+
+FrameTimes MeasureLegacy(const BatchSet& batchSet, uint32 sortFlags)
+{
+    Vector<RenderBatch*> batches;
+
+    return MeasureFrames([&batchSet, &batches, sortFlags](Camera* camera) {
+        batches.assign(batchSet.batches.begin(), batchSet.batches.end());
+        LegacySort(batches, camera, sortFlags);
+    });
+}
+
+void ReportStatistic(const String& key, uint64 timeUs)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", timeUs / 1000.0)).c_str());
+}
+}
+
+const String RenderBatchSortTest::TEST_NAME = "RenderBatchSortTest";
+
+RenderBatchSortTest::RenderBatchSortTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void RenderBatchSortTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(TEST_NAME));
+    AddControl(testText);
+}
+
+void RenderBatchSortTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void RenderBatchSortTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+void RenderBatchSortTest::RunBenchmarks()
+{
+    using namespace RenderBatchSortTestDetails;
+
+    const uint32 materialFlags = RenderBatchArray::SORT_ENABLED | RenderBatchArray::SORT_BY_MATERIAL;
+    const uint32 distanceFlags = RenderBatchArray::SORT_ENABLED | RenderBatchArray::SORT_BY_DISTANCE_BACK_TO_FRONT;
+
+    for (uint32 batchCount : BATCH_COUNTS)
+    {
+        BatchSet batchSet(batchCount);
+
+        FrameTimes legacyMaterial = MeasureLegacy(batchSet, materialFlags);
+        FrameTimes packedMaterial = MeasureRenderBatchArray(batchSet, materialFlags);
+        FrameTimes legacyDistance = MeasureLegacy(batchSet, distanceFlags);
+        FrameTimes packedDistance = MeasureRenderBatchArray(batchSet, distanceFlags);
+
+        Logger::Info("RenderBatchSortTest: %u batches, %u frames", batchCount, FRAMES_COUNT);
+        ReportStatistic(Format("Legacy_material_sort_%u_ms", batchCount), legacyMaterial.averageFrameUs);
+        ReportStatistic(Format("Radix_material_sort_first_frame_%u_ms", batchCount), packedMaterial.firstFrameUs);
+        ReportStatistic(Format("Radix_material_sort_%u_ms", batchCount), packedMaterial.averageFrameUs);
+        ReportStatistic(Format("Legacy_distance_sort_%u_ms", batchCount), legacyDistance.averageFrameUs);
+        ReportStatistic(Format("Radix_distance_sort_first_frame_%u_ms", batchCount), packedDistance.firstFrameUs);
+        ReportStatistic(Format("Radix_distance_sort_%u_ms", batchCount), packedDistance.averageFrameUs);
+    }
+}
+
+void RenderBatchSortTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void RenderBatchSortTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool RenderBatchSortTest::IsFinished() const
+{
+    return finished;
+}
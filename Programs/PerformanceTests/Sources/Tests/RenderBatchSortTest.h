@@ -0,0 +1,41 @@
+#ifndef __RENDER_BATCH_SORT_TEST_H__
+#define __RENDER_BATCH_SORT_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Microbenchmark of RenderBatchArray sorting: compares packed 64-bit keys sorted with radix sort
+    (and previous frame order) with the legacy per-batch keys sorted with std::sort,
+    for 10k-100k batches in material and distance sorting modes.
+*/
+class RenderBatchSortTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    RenderBatchSortTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
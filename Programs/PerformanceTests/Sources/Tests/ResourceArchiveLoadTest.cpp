@@ -0,0 +1,233 @@
+#include "ResourceArchiveLoadTest.h"
+
+#include <Compression/LZ4Compressor.h>
+#include <FileSystem/FileSystem.h>
+#include <FileSystem/ResourceArchive.h>
+#include <FileSystem/Private/PackFormatSpec.h>
+#include <Utils/CRC32.h>
+#include <Utils/Random.h>
+
+namespace ResourceArchiveLoadTestDetails
+{
+static const uint32 FILES_COUNT = 4000;
+static const uint32 MIN_FILE_SIZE = 4 * 1024;
+static const uint32 MAX_FILE_SIZE = 128 * 1024;
+static const uint32 REQUEST_COUNTS[] = { 100, 1000, 4000 };
+static const uint32 ITERATIONS_COUNT = 5;
+
+// Text-like content so lz4 has something to compress
+Vector<uint8> GenerateContent(uint32 size)
+{
+    static const char8 alphabet[] = "abcdefghijklmnopqrstuvwxyz 0123456789\n";
+    Random* random = Random::Instance();
+
+    Vector<uint8> content(size);
+    for (uint32 i = 0; i < size; ++i)
+    {
+        content[i] = (i % 16 < 8) ? static_cast<uint8>(alphabet[random->Rand(sizeof(alphabet) - 2)]) : content[i - 8];
+    }
+    return content;
+}
+
+Vector<String> MakeRequest(const ResourceArchive& archive, uint32 count)
+{
+    Vector<String> paths;
+    for (const ResourceArchive::FileInfo& info : archive.GetFilesInfo())
+    {
+        paths.push_back(info.relativeFilePath);
+    }
+
+    // requests usually don't follow order of files in pack
+    Random* random = Random::Instance();
+    for (size_t i = paths.size() - 1; i > 0; --i)
+    {
+        std::swap(paths[i], paths[random->Rand(static_cast<uint32>(i))]);
+    }
+    paths.resize(std::min(static_cast<size_t>(count), paths.size()));
+    return paths;
+}
+
+uint64 MeasureLoadFile(const ResourceArchive& archive, const Vector<String>& paths)
+{
+    uint64 start = SystemTimer::GetUs();
+    for (uint32 iteration = 0; iteration < ITERATIONS_COUNT; ++iteration)
+    {
+        Vector<uint8> content;
+        for (const String& path : paths)
+        {
+            archive.LoadFile(path, content);
+        }
+    }
+    return (SystemTimer::GetUs() - start) / ITERATIONS_COUNT;
+}
+
+uint64 MeasureLoadFiles(const ResourceArchive& archive, const Vector<String>& paths)
+{
+    uint64 start = SystemTimer::GetUs();
+    for (uint32 iteration = 0; iteration < ITERATIONS_COUNT; ++iteration)
+    {
+        Vector<Vector<uint8>> contents;
+        archive.LoadFiles(paths, contents);
+    }
+    return (SystemTimer::GetUs() - start) / ITERATIONS_COUNT;
+}
+
+void ReportStatistic(const String& key, uint64 timeUs)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", timeUs / 1000.0)).c_str());
+}
+}
+
+const String ResourceArchiveLoadTest::TEST_NAME = "ResourceArchiveLoadTest";
+
+ResourceArchiveLoadTest::ResourceArchiveLoadTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void ResourceArchiveLoadTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(TEST_NAME));
+    AddControl(testText);
+}
+
+void ResourceArchiveLoadTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void ResourceArchiveLoadTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+bool ResourceArchiveLoadTest::CreateArchive(const FilePath& archivePath)
+{
+    using namespace ResourceArchiveLoadTestDetails;
+    using namespace PackFormat;
+
+    ScopedPtr<File> file(File::Create(archivePath, File::CREATE | File::WRITE));
+    if (!file)
+    {
+        return false;
+    }
+
+    Random* random = Random::Instance();
+    Vector<FileTableEntry> entries;
+    String names;
+    uint64 position = 0;
+    for (uint32 i = 0; i < FILES_COUNT; ++i)
+    {
+        Vector<uint8> content = GenerateContent(MIN_FILE_SIZE + random->Rand(MAX_FILE_SIZE - MIN_FILE_SIZE));
+        Vector<uint8> compressed;
+        if (!LZ4Compressor().Compress(content, compressed))
+        {
+            return false;
+        }
+
+        FileTableEntry entry = {};
+        entry.startPosition = position;
+        entry.compressedSize = static_cast<uint32>(compressed.size());
+        entry.originalSize = static_cast<uint32>(content.size());
+        entry.compressedCrc32 = CRC32::ForBuffer(compressed.data(), compressed.size());
+        entry.type = Compressor::Type::Lz4;
+        entry.originalCrc32 = CRC32::ForBuffer(content.data(), content.size());
+        entries.push_back(entry);
+
+        names += Format("Data/file_%u.bin", i);
+        names.push_back('\0');
+
+        if (file->Write(compressed.data(), entry.compressedSize) != entry.compressedSize)
+        {
+            return false;
+        }
+        position += entry.compressedSize;
+    }
+
+    Vector<uint8> namesOriginal(names.begin(), names.end());
+    Vector<uint8> namesCompressed;
+    if (!LZ4HCCompressor().Compress(namesOriginal, namesCompressed))
+    {
+        return false;
+    }
+
+    Vector<uint8> filesTable(entries.size() * sizeof(FileTableEntry));
+    std::copy_n(reinterpret_cast<const uint8*>(entries.data()), filesTable.size(), filesTable.data());
+    filesTable.insert(filesTable.end(), namesCompressed.begin(), namesCompressed.end());
+
+    PackFile::FooterBlock footer;
+    footer.info.numFiles = FILES_COUNT;
+    footer.info.namesSizeCompressed = static_cast<uint32>(namesCompressed.size());
+    footer.info.namesSizeOriginal = static_cast<uint32>(namesOriginal.size());
+    footer.info.filesTableSize = static_cast<uint32>(filesTable.size());
+    footer.info.filesTableCrc32 = CRC32::ForBuffer(filesTable.data(), filesTable.size());
+    footer.info.packArchiveMarker = FILE_MARKER;
+    footer.infoCrc32 = CRC32::ForBuffer(reinterpret_cast<const char*>(&footer.info), sizeof(footer.info));
+
+    uint32 tableSize = static_cast<uint32>(filesTable.size());
+    return file->Write(filesTable.data(), tableSize) == tableSize && file->Write(&footer, sizeof(footer)) == sizeof(footer);
+}
+
+void ResourceArchiveLoadTest::RunBenchmarks()
+{
+    using namespace ResourceArchiveLoadTestDetails;
+
+    const FilePath archivePath("~doc:/ResourceArchiveLoadTest.dvpk");
+    if (!CreateArchive(archivePath))
+    {
+        Logger::Error("ResourceArchiveLoadTest: can't create %s", archivePath.GetStringValue().c_str());
+        return;
+    }
+
+    try
+    {
+        ResourceArchive archive(archivePath);
+        ResourceArchive mappedArchive(archivePath, true);
+
+        for (uint32 requestCount : REQUEST_COUNTS)
+        {
+            Vector<String> paths = MakeRequest(archive, requestCount);
+
+            Logger::Info("ResourceArchiveLoadTest: %u files of %u in archive", static_cast<uint32>(paths.size()), FILES_COUNT);
+            ReportStatistic(Format("LoadFile_loop_%u_ms", requestCount), MeasureLoadFile(archive, paths));
+            ReportStatistic(Format("LoadFiles_batch_%u_ms", requestCount), MeasureLoadFiles(archive, paths));
+            ReportStatistic(Format("LoadFile_loop_mapped_%u_ms", requestCount), MeasureLoadFile(mappedArchive, paths));
+            ReportStatistic(Format("LoadFiles_batch_mapped_%u_ms", requestCount), MeasureLoadFiles(mappedArchive, paths));
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        Logger::Error("ResourceArchiveLoadTest: %s", ex.what());
+    }
+
+    FileSystem::Instance()->DeleteFile(archivePath);
+}
+
+void ResourceArchiveLoadTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void ResourceArchiveLoadTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool ResourceArchiveLoadTest::IsFinished() const
+{
+    return finished;
+}
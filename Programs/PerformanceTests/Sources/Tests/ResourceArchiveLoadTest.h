@@ -0,0 +1,42 @@
+#ifndef __RESOURCE_ARCHIVE_LOAD_TEST_H__
+#define __RESOURCE_ARCHIVE_LOAD_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Benchmark of loading many files from .dvpk archive: compares ResourceArchive::LoadFile called in a loop
+    with batched ResourceArchive::LoadFiles, for file reads and memory mapped archive.
+    Archive with lz4 compressed files is generated in ~doc: before measurement.
+*/
+class ResourceArchiveLoadTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    ResourceArchiveLoadTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+    bool CreateArchive(const FilePath& archivePath);
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
@@ -0,0 +1,196 @@
+#include "SceneFormatLoadTest.h"
+
+#include <Concurrency/Thread.h>
+#include <Scene3D/SceneFileV2.h>
+
+#include <atomic>
+
+namespace SceneFormatLoadTestDetails
+{
+static const uint32 LOADS_COUNT = 5;
+static const uint32 MEMORY_SAMPLING_INTERVAL_MS = 1;
+
+struct LoadResult
+{
+    uint64 averageLoadUs = 0;
+    uint32 peakMemory = 0; // over memory allocated before loading
+};
+
+// Polls allocated memory from helper thread while scene is loading
+class PeakMemorySampler
+{
+public:
+    PeakMemorySampler(const Function<uint32()>& getAllocatedMemory_)
+        : getAllocatedMemory(getAllocatedMemory_)
+        , baseline(getAllocatedMemory_())
+        , peak(baseline)
+    {
+        thread = Thread::Create([this]() {
+            while (!stop)
+            {
+                Sample();
+                Thread::Sleep(MEMORY_SAMPLING_INTERVAL_MS);
+            }
+        });
+        thread->Start();
+    }
+
+    ~PeakMemorySampler()
+    {
+        SafeRelease(thread);
+    }
+
+    uint32 Stop()
+    {
+        stop = true;
+        thread->Join();
+        Sample();
+        return peak - baseline;
+    }
+
+private:
+    void Sample()
+    {
+        peak = Max(peak.load(), getAllocatedMemory());
+    }
+
+    Function<uint32()> getAllocatedMemory;
+    uint32 baseline = 0;
+    std::atomic<uint32> peak;
+    std::atomic<bool> stop = { false };
+    Thread* thread = nullptr;
+};
+
+LoadResult MeasureLoading(const FilePath& scenePath, const Function<uint32()>& getAllocatedMemory)
+{
+    LoadResult result;
+    uint64 totalUs = 0;
+    for (uint32 i = 0; i < LOADS_COUNT; ++i)
+    {
+        PeakMemorySampler sampler(getAllocatedMemory);
+
+        uint64 start = SystemTimer::GetUs();
+        ScopedPtr<Scene> scene(new Scene());
+        SceneFileV2::eError error = scene->LoadScene(scenePath);
+        totalUs += SystemTimer::GetUs() - start;
+
+        result.peakMemory = Max(result.peakMemory, sampler.Stop());
+
+        if (error != SceneFileV2::ERROR_NO_ERROR)
+        {
+            Logger::Error("SceneFormatLoadTest: can't load %s, error %d", scenePath.GetStringValue().c_str(), error);
+        }
+    }
+    result.averageLoadUs = totalUs / LOADS_COUNT;
+    return result;
+}
+
+void ReportStatistic(const String& key, uint64 timeUs)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", timeUs / 1000.0)).c_str());
+}
+
+void ReportSize(const String& key, uint64 size)
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatBuildStatistic(key, Format("%f", size / 1024.0)).c_str());
+}
+}
+
+const String SceneFormatLoadTest::TEST_NAME = "SceneFormatLoadTest";
+
+SceneFormatLoadTest::SceneFormatLoadTest(const TestParams& testParams)
+    : BaseTest(TEST_NAME, testParams)
+{
+}
+
+void SceneFormatLoadTest::LoadResources()
+{
+    ScopedPtr<Font> font(FTFont::Create("~res:/Fonts/korinna.ttf"));
+
+    testText = new UIStaticText();
+    testText->SetFont(font);
+    testText->SetFontSize(18.f);
+    testText->SetTextColor(Color(0.f, 1.f, 0.f, 1.f));
+    testText->SetTextAlign(ALIGN_HCENTER | ALIGN_VCENTER);
+    testText->SetRect(DAVA::GetEngineContext()->uiControlSystem->vcs->GetFullScreenVirtualRect());
+    testText->SetText(UTF8Utils::EncodeToWideString(Format("%s: %s", TEST_NAME.c_str(), GetParams().sceneName.c_str())));
+    AddControl(testText);
+}
+
+void SceneFormatLoadTest::UnloadResources()
+{
+    SafeRelease(testText);
+}
+
+void SceneFormatLoadTest::Update(float32 timeElapsed)
+{
+    BaseScreen::Update(timeElapsed);
+
+    if (!finished)
+    {
+        RunBenchmarks();
+        finished = true;
+    }
+}
+
+void SceneFormatLoadTest::RunBenchmarks()
+{
+    using namespace SceneFormatLoadTestDetails;
+
+    FileSystem* fileSystem = GetEngineContext()->fileSystem;
+
+    FilePath scenePath("~res:/3d/Maps/" + GetParams().scenePath);
+    FilePath folder("~doc:/SceneFormatLoadTest/");
+    FilePath nestedPath = folder + scenePath.GetBasename() + "_nested.sc2";
+    FilePath flatPath = folder + scenePath.GetBasename() + "_flat.sc2";
+    fileSystem->CreateDirectory(folder, true);
+
+    // both copies are saved from the same scene into the same folder, so they differ only in entity hierarchy layout
+    {
+        ScopedPtr<Scene> scene(new Scene());
+        if (scene->LoadScene(scenePath) != SceneFileV2::ERROR_NO_ERROR)
+        {
+            Logger::Error("SceneFormatLoadTest: can't load %s", scenePath.GetStringValue().c_str());
+            return;
+        }
+        if (scene->SaveScene(nestedPath) != SceneFileV2::ERROR_NO_ERROR || scene->SaveScene(flatPath, false, true) != SceneFileV2::ERROR_NO_ERROR)
+        {
+            Logger::Error("SceneFormatLoadTest: can't save copies of %s", scenePath.GetStringValue().c_str());
+            return;
+        }
+    }
+
+    Function<uint32()> getAllocatedMemory = [this]() { return GetAllocatedMemory(); };
+    LoadResult nested = MeasureLoading(nestedPath, getAllocatedMemory);
+    LoadResult flat = MeasureLoading(flatPath, getAllocatedMemory);
+
+    uint64 nestedSize = 0;
+    uint64 flatSize = 0;
+    fileSystem->GetFileSize(nestedPath, nestedSize);
+    fileSystem->GetFileSize(flatPath, flatSize);
+
+    Logger::Info("SceneFormatLoadTest: map %s, %u loads", GetParams().sceneName.c_str(), LOADS_COUNT);
+    ReportStatistic("Nested_load_ms", nested.averageLoadUs);
+    ReportStatistic("Flat_load_ms", flat.averageLoadUs);
+    ReportSize("Nested_peak_memory_kb", nested.peakMemory);
+    ReportSize("Flat_peak_memory_kb", flat.peakMemory);
+    ReportSize("Nested_file_size_kb", nestedSize);
+    ReportSize("Flat_file_size_kb", flatSize);
+
+    fileSystem->DeleteDirectory(folder);
+}
+
+void SceneFormatLoadTest::OnStart()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestStarted(GetSceneName()).c_str());
+}
+
+void SceneFormatLoadTest::OnFinish()
+{
+    Logger::Info(TeamcityPerformanceTestsOutput::FormatTestFinished(GetSceneName()).c_str());
+}
+
+bool SceneFormatLoadTest::IsFinished() const
+{
+    return finished;
+}
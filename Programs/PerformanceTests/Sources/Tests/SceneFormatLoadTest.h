@@ -0,0 +1,41 @@
+#ifndef __SCENE_FORMAT_LOAD_TEST_H__
+#define __SCENE_FORMAT_LOAD_TEST_H__
+
+#include "BaseTest.h"
+
+/**
+    Compares loading of test map saved with nested entity archives and with flat entity hierarchy:
+    both copies are written from the same loaded scene, load time and peak of allocated memory
+    during loading are reported for each of them.
+*/
+class SceneFormatLoadTest : public BaseTest
+{
+public:
+    static const String TEST_NAME;
+
+    SceneFormatLoadTest(const TestParams& testParams);
+
+    void OnStart() override;
+    void OnFinish() override;
+
+    void Update(float32 timeElapsed) override;
+
+    bool IsFinished() const override;
+
+protected:
+    void LoadResources() override;
+    void UnloadResources() override;
+
+    void CreateUI() override{};
+    void UpdateUI() override{};
+
+    void PerformTestLogic(float32 timeElapsed) override{};
+
+private:
+    void RunBenchmarks();
+
+    bool finished = false;
+    UIStaticText* testText = nullptr;
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include "Classes/Collada/ColladaToSc2Importer/ImportSettings.h"
 
 #include <Animation/AnimationChannel.h>
+#include <Animation/AnimationChannelEncoder.h>
 #include <Animation/AnimationClip.h>
 #include <Animation/AnimationTrack.h>
 #include <FileSystem/DynamicMemoryFile.h>
@@ -433,14 +434,7 @@ eColladaErrorCodes ColladaImporter::SaveAnimations(ColladaScene* colladaScene, c
         //Track part
         uint8 target;
         uint8 pad0[3];
-
-        //Channel part
-        uint32 signature = AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE;
-        uint8 dimension = 0;
-        uint8 interpolation = 0;
-        uint16 compression = 0;
-        uint32 keyCount = 0;
-    } channelHeader;
+    } channelHeader = {};
 
     for (auto canimation : colladaScene->colladaAnimations)
     {
@@ -481,49 +475,47 @@ eColladaErrorCodes ColladaImporter::SaveAnimations(ColladaScene* colladaScene, c
                 if (!animationData.translations.empty())
                 {
                     //Write position channel
-                    channelHeader.dimension = 3;
-                    channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
                     channelHeader.target = AnimationTrack::CHANNEL_TARGET_POSITION;
-                    channelHeader.keyCount = uint32(animationData.translations.size());
                     WriteToBuffer(animationClipData, &channelHeader);
 
-                    for (auto& t : animationData.translations)
+                    Vector<AnimationChannelEncoder::Key> keys(animationData.translations.size());
+                    for (size_t k = 0; k < keys.size(); ++k)
                     {
-                        WriteToBuffer(animationClipData, &t.first); //time
-                        WriteToBuffer(animationClipData, &t.second); //position
+                        keys[k].time = animationData.translations[k].first;
+                        keys[k].value = Vector4(animationData.translations[k].second, 0.f);
                     }
+                    AnimationChannelEncoder::WriteChannel(animationClipData, 3, AnimationChannel::INTERPOLATION_LINEAR, keys);
                 }
 
                 //Write orientation channel
                 if (!animationData.rotations.empty())
                 {
-                    channelHeader.dimension = 4;
-                    channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
                     channelHeader.target = AnimationTrack::CHANNEL_TARGET_ORIENTATION;
-                    channelHeader.keyCount = uint32(animationData.rotations.size());
                     WriteToBuffer(animationClipData, &channelHeader);
 
-                    for (auto& r : animationData.rotations)
+                    Vector<AnimationChannelEncoder::Key> keys(animationData.rotations.size());
+                    for (size_t k = 0; k < keys.size(); ++k)
                     {
-                        WriteToBuffer(animationClipData, &r.first); //time
-                        WriteToBuffer(animationClipData, &r.second); //rotation
+                        const Quaternion& rotation = animationData.rotations[k].second;
+                        keys[k].time = animationData.rotations[k].first;
+                        keys[k].value = Vector4(rotation.x, rotation.y, rotation.z, rotation.w);
                     }
+                    AnimationChannelEncoder::WriteChannel(animationClipData, 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR, keys);
                 }
 
                 //Write scale channel
                 if (!animationData.scales.empty())
                 {
-                    channelHeader.dimension = 1;
-                    channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
                     channelHeader.target = AnimationTrack::CHANNEL_TARGET_SCALE;
-                    channelHeader.keyCount = uint32(animationData.scales.size());
                     WriteToBuffer(animationClipData, &channelHeader);
 
-                    for (auto& s : animationData.scales)
+                    Vector<AnimationChannelEncoder::Key> keys(animationData.scales.size());
+                    for (size_t k = 0; k < keys.size(); ++k)
                     {
-                        WriteToBuffer(animationClipData, &s.first); //time
-                        WriteToBuffer(animationClipData, &s.second.x); //scale
+                        keys[k].time = animationData.scales[k].first;
+                        keys[k].value.x = animationData.scales[k].second.x;
                     }
+                    AnimationChannelEncoder::WriteChannel(animationClipData, 1, AnimationChannel::INTERPOLATION_LINEAR, keys);
                 }
             }
 
@@ -534,7 +526,7 @@ eColladaErrorCodes ColladaImporter::SaveAnimations(ColladaScene* colladaScene, c
 
             AnimationClip::FileHeader header;
             header.signature = AnimationClip::ANIMATION_CLIP_FILE_SIGNATURE;
-            header.version = 1;
+            header.version = AnimationClip::ANIMATION_CLIP_FILE_VERSION;
             header.crc32 = CRC32::ForBuffer(animationClipData.data(), animationDataSize);
             header.dataSize = animationDataSize;
 
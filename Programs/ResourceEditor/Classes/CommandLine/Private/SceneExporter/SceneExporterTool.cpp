@@ -227,6 +227,7 @@ SceneExporterTool::SceneExporterTool(const DAVA::Vector<DAVA::String>& commandLi
     options.AddOption(OptionName::GPU, VariantType(String("origin")), "GPU family: PowerVR_iOS, PowerVR_Android, tegra, mali, adreno, origin, dx11. Can be multiple: -gpu mali,adreno,origin", true);
 
     options.AddOption(OptionName::SaveNormals, VariantType(false), "Disable removing of normals from vertexes");
+    options.AddOption(OptionName::FlatHierarchy, VariantType(false), "Save scenes with flat entity table and per-component-type blobs, loads faster than nested archives");
     options.AddOption(OptionName::HDTextures, VariantType(false), "Use 0-mip level as texture.hd.ext");
 
     options.AddOption(OptionName::Tag, VariantType(String("")), "Tag for filenames, example: .china. Will export texture.china.tex instead of texture.tex");
@@ -316,6 +317,7 @@ bool SceneExporterTool::PostInitInternal()
 
     const bool saveNormals = options.GetOption(OptionName::SaveNormals).AsBool();
     exportingParams.optimizeOnExport = !saveNormals;
+    exportingParams.flatHierarchy = options.GetOption(OptionName::FlatHierarchy).AsBool();
 
     useAssetCache = options.GetOption(OptionName::UseAssetCache).AsBool();
     if (useAssetCache)
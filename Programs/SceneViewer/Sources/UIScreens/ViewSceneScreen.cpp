@@ -228,6 +228,11 @@ void ViewSceneScreen::AddMenuControl()
     reloadShadersMenuItem = mainSubMenu->AddActionItem(L"Reload shaders", DAVA::Message(this, &ViewSceneScreen::OnButtonReloadShaders));
     performanceTestMenuItem = mainSubMenu->AddActionItem(L"Performance test", DAVA::Message(this, &ViewSceneScreen::OnButtonPerformanceTest));
     characterSpawnMenuItem = mainSubMenu->AddActionItem(L"Toggle Spawn Character", DAVA::Message(this, &ViewSceneScreen::OnButtonToggleSpawnCharacter));
+#ifdef WITH_SCENE_PERFORMANCE_TESTS
+    mainSubMenu->AddActionItem(L"Transform benchmark", DAVA::Message(this, &ViewSceneScreen::OnButtonTransformBenchmark));
+    mainSubMenu->AddActionItem(L"Skeleton crowd benchmark", DAVA::Message(this, &ViewSceneScreen::OnButtonSkeletonCrowdBenchmark));
+    mainSubMenu->AddActionItem(L"Landscape ray cast benchmark", DAVA::Message(this, &ViewSceneScreen::OnButtonLandscapeRayCastBenchmark));
+#endif
     mainSubMenu->AddBackItem();
 
     qualitySettingsMenuItem->SetEnabled(false);
@@ -404,6 +409,30 @@ void ViewSceneScreen::OnButtonPerformanceTest(DAVA::BaseObject* caller, void* pa
 #endif
 }
 
+void ViewSceneScreen::OnButtonTransformBenchmark(DAVA::BaseObject* caller, void* param, void* callerData)
+{
+#ifdef WITH_SCENE_PERFORMANCE_TESTS
+    // results are written to log
+    TransformBenchmark::Run();
+#endif
+}
+
+void ViewSceneScreen::OnButtonSkeletonCrowdBenchmark(DAVA::BaseObject* caller, void* param, void* callerData)
+{
+#ifdef WITH_SCENE_PERFORMANCE_TESTS
+    // results are written to log
+    SkeletonCrowdBenchmark::Run();
+#endif
+}
+
+void ViewSceneScreen::OnButtonLandscapeRayCastBenchmark(DAVA::BaseObject* caller, void* param, void* callerData)
+{
+#ifdef WITH_SCENE_PERFORMANCE_TESTS
+    // results are written to log
+    LandscapeRayCastBenchmark::Run();
+#endif
+}
+
 void ViewSceneScreen::OnButtonQualitySettings(DAVA::BaseObject* caller, void* param, void* callerData)
 {
     menu->SetEnabled(false);
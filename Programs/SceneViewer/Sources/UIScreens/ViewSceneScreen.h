@@ -7,6 +7,9 @@
 
 #ifdef WITH_SCENE_PERFORMANCE_TESTS
 #include <GridTest.h>
+#include <TransformBenchmark.h>
+#include <SkeletonCrowdBenchmark.h>
+#include <LandscapeRayCastBenchmark.h>
 #endif
 
 #include <UI/UIList.h>
@@ -61,6 +64,9 @@ private:
     void OnButtonQualitySettings(DAVA::BaseObject* caller, void* param, void* callerData);
     void OnButtonReloadShaders(DAVA::BaseObject* caller, void* param, void* callerData);
     void OnButtonPerformanceTest(DAVA::BaseObject* caller, void* param, void* callerData);
+    void OnButtonTransformBenchmark(DAVA::BaseObject* caller, void* param, void* callerData);
+    void OnButtonSkeletonCrowdBenchmark(DAVA::BaseObject* caller, void* param, void* callerData);
+    void OnButtonLandscapeRayCastBenchmark(DAVA::BaseObject* caller, void* param, void* callerData);
     void OnButtonSelectFromRes(DAVA::BaseObject* caller, void* param, void* callerData);
     void OnButtonSelectFromDoc(DAVA::BaseObject* caller, void* param, void* callerData);
     void OnButtonSelectFromExt(DAVA::BaseObject* caller, void* param, void* callerData);
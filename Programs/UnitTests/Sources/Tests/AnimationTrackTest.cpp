@@ -0,0 +1,277 @@
+#include "DAVAEngine.h"
+#include "UnitTests/UnitTests.h"
+
+#include "Animation/AnimationChannel.h"
+#include "Animation/AnimationChannelEncoder.h"
+#include "Animation/AnimationTrack.h"
+#include "Job/JobManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace DAVA;
+
+namespace AnimationTrackTestDetails
+{
+const uint32 KEYS_COUNT = 37;
+const uint32 SAMPLES_COUNT = 1000;
+const float32 KEY_INTERVAL = 0.1f;
+
+float32 RandomFloat(uint32& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float32>(state >> 8) / static_cast<float32>(1 << 24);
+}
+
+template <class T>
+void Write(Vector<uint8>& data, const T& value)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+// Track data in format described in 'AnimationBinaryFormat.md': linear position, spherical orientation and linear scale channels
+Vector<uint8> CreateTrackData()
+{
+    Vector<uint8> data;
+    Write(data, uint32(AnimationTrack::ANIMATION_TRACK_DATA_SIGNATURE));
+    Write(data, uint32(3));
+
+    const std::pair<AnimationTrack::eChannelTarget, AnimationChannel::eInterpolation> channels[] = {
+        { AnimationTrack::CHANNEL_TARGET_POSITION, AnimationChannel::INTERPOLATION_LINEAR },
+        { AnimationTrack::CHANNEL_TARGET_ORIENTATION, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR },
+        { AnimationTrack::CHANNEL_TARGET_SCALE, AnimationChannel::INTERPOLATION_LINEAR }
+    };
+    const uint8 dimensions[] = { 3, 4, 1 };
+
+    uint32 state = 7;
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        Write(data, uint8(channels[c].first));
+        Write(data, uint8(0));
+        Write(data, uint16(0)); //pad
+
+        Write(data, uint32(AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE));
+        Write(data, dimensions[c]);
+        Write(data, uint8(channels[c].second));
+        Write(data, uint16(0));
+        Write(data, KEYS_COUNT);
+        for (uint32 k = 0; k < KEYS_COUNT; ++k)
+        {
+            Write(data, float32(k) * KEY_INTERVAL);
+            if (channels[c].second == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR)
+            {
+                Quaternion q(RandomFloat(state), RandomFloat(state), RandomFloat(state), RandomFloat(state));
+                q.Normalize();
+                for (uint32 d = 0; d < 4; ++d)
+                    Write(data, q.data[d]);
+            }
+            else
+            {
+                for (uint32 d = 0; d < dimensions[c]; ++d)
+                    Write(data, RandomFloat(state));
+            }
+        }
+    }
+
+    return data;
+}
+
+// Times before, after and inside keys range, moving forward by small steps and jumping back and forth
+Vector<float32> CreateSampleTimes()
+{
+    Vector<float32> times;
+    uint32 state = 13;
+    float32 duration = float32(KEYS_COUNT - 1) * KEY_INTERVAL;
+    float32 time = -0.5f;
+    for (uint32 i = 0; i < SAMPLES_COUNT; ++i)
+    {
+        if (i % 10 == 0)
+            time = (RandomFloat(state) * 1.2f - 0.1f) * duration;
+        else
+            time += RandomFloat(state) * KEY_INTERVAL * 1.5f;
+
+        times.push_back(time);
+    }
+    times.push_back(0.f);
+    times.push_back(duration);
+    times.push_back(KEY_INTERVAL * 5.f);
+    return times;
+}
+
+// Smooth curve sampled at 30 fps, quaternions change sign time to time as exported ones may do
+Vector<AnimationChannelEncoder::Key> CreateSampledKeys(uint32 dimension)
+{
+    Vector<AnimationChannelEncoder::Key> keys(300);
+    for (uint32 k = 0; k < uint32(keys.size()); ++k)
+    {
+        float32 time = float32(k) / 30.f;
+        keys[k].time = time;
+        if (dimension == 4)
+        {
+            Quaternion q;
+            q.Construct(Normalize(Vector3(std::sin(time), std::cos(time * 0.7f), 0.5f)), time * 1.3f);
+            keys[k].value = Vector4(q.x, q.y, q.z, q.w) * ((k % 7 == 0) ? -1.f : 1.f);
+        }
+        else
+        {
+            keys[k].value = Vector4(std::sin(time) * 2.f, time * 0.5f, std::floor(time), 0.f);
+        }
+    }
+    return keys;
+}
+
+float32 MaxError(const AnimationChannel& channel, const AnimationChannel& reference, float32 duration, bool isQuaternion)
+{
+    float32 error = 0.f;
+    AnimationChannel::Cursor cursor;
+    for (float32 time = 0.f; time < duration; time += 0.003f)
+    {
+        float32 value[4];
+        float32 referenceValue[4];
+        channel.Evaluate(time, &cursor, value, 4);
+        reference.Evaluate(time, referenceValue, 4);
+
+        float32 difference = 0.f;
+        float32 negatedDifference = 0.f;
+        for (uint32 d = 0; d < channel.GetDimension(); ++d)
+        {
+            difference = Max(difference, std::abs(value[d] - referenceValue[d]));
+            negatedDifference = Max(negatedDifference, std::abs(value[d] + referenceValue[d]));
+        }
+        error = Max(error, isQuaternion ? Min(difference, negatedDifference) : difference);
+    }
+    return error;
+}
+
+bool EvaluatesSame(const AnimationTrack& track, const Vector<float32>& times, Vector<AnimationChannel::Cursor>& cursors)
+{
+    Vector<float32> reference(track.GetValuesSize());
+    Vector<float32> values(track.GetValuesSize());
+    for (float32 time : times)
+    {
+        for (uint32 c = 0; c < track.GetChannelsCount(); ++c)
+            track.Evaluate(time, c, reference.data() + track.GetChannelValueOffset(c), track.GetChannelValueSize(c));
+
+        track.EvaluateAll(time, cursors.data(), values.data(), uint32(values.size()));
+        if (std::memcmp(reference.data(), values.data(), values.size() * sizeof(float32)) != 0)
+            return false;
+    }
+    return true;
+}
+}
+
+DAVA_TESTCLASS (AnimationTrackTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("AnimationChannel.cpp")
+    DECLARE_COVERED_FILES("AnimationChannelEncoder.cpp")
+    DECLARE_COVERED_FILES("AnimationTrack.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (KeySearchTest)
+    {
+        using namespace AnimationTrackTestDetails;
+
+        Vector<uint8> data = CreateTrackData();
+        AnimationTrack track;
+        TEST_VERIFY(track.Bind(data.data()) == uint32(data.size()));
+        TEST_VERIFY(track.GetChannelsCount() == 3);
+        TEST_VERIFY(track.GetValuesSize() == 8);
+
+        // interpolation is exact at keys and clamped outside of keys range
+        float32 value[4];
+        float32 firstKeyValue[3];
+        std::memcpy(firstKeyValue, data.data() + 8 + 4 + 12 + 4, sizeof(firstKeyValue));
+        track.Evaluate(-1.f, 0, value, 3);
+        TEST_VERIFY(std::memcmp(value, firstKeyValue, sizeof(firstKeyValue)) == 0);
+        track.Evaluate(0.f, 0, value, 3);
+        TEST_VERIFY(std::memcmp(value, firstKeyValue, sizeof(firstKeyValue)) == 0);
+
+        // cursor evaluation gives exactly the same values as stateless binary search
+        Vector<AnimationChannel::Cursor> cursors(track.GetChannelsCount());
+        TEST_VERIFY(EvaluatesSame(track, CreateSampleTimes(), cursors));
+    }
+
+    DAVA_TEST (CompressedChannelTest)
+    {
+        using namespace AnimationTrackTestDetails;
+
+        const std::pair<uint32, AnimationChannel::eInterpolation> channels[] = {
+            { 3, AnimationChannel::INTERPOLATION_LINEAR },
+            { 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR }
+        };
+
+        for (const auto& c : channels)
+        {
+            Vector<AnimationChannelEncoder::Key> keys = CreateSampledKeys(c.first);
+
+            AnimationChannelEncoder::Settings rawSettings;
+            rawSettings.compress = false;
+            rawSettings.tolerance = 0.f;
+            Vector<uint8> rawData;
+            AnimationChannelEncoder::WriteChannel(rawData, c.first, c.second, keys, rawSettings);
+
+            AnimationChannelEncoder::Settings settings;
+            Vector<uint8> compressedData;
+            AnimationChannelEncoder::WriteChannel(compressedData, c.first, c.second, keys, settings);
+
+            AnimationChannel raw;
+            AnimationChannel compressed;
+            TEST_VERIFY(raw.Bind(rawData.data()) == uint32(rawData.size()));
+            TEST_VERIFY(compressed.Bind(compressedData.data()) == uint32(compressedData.size()));
+            TEST_VERIFY(raw.GetCompression() == AnimationChannel::COMPRESSION_NONE);
+            TEST_VERIFY(compressed.GetCompression() != AnimationChannel::COMPRESSION_NONE);
+            TEST_VERIFY(compressed.GetKeysCount() < raw.GetKeysCount());
+            TEST_VERIFY(compressedData.size() < rawData.size());
+            TEST_VERIFY((compressedData.size() & 0x3) == 0);
+
+            // key reduction and quantization share one error budget
+            float32 duration = keys.back().time;
+            TEST_VERIFY(MaxError(compressed, raw, duration, c.first == 4) < settings.tolerance);
+        }
+    }
+
+    DAVA_TEST (WideRangeChannelTest)
+    {
+        // 16-bit steps of so wide range exceed tolerance, so channel isn't quantized and linear keys are still reduced
+        Vector<AnimationChannelEncoder::Key> keys(100);
+        for (uint32 k = 0; k < uint32(keys.size()); ++k)
+        {
+            keys[k].time = float32(k) / 30.f;
+            keys[k].value = Vector4(float32(k) * 10.f, 0.f, 0.f, 0.f);
+        }
+
+        Vector<uint8> data;
+        AnimationChannelEncoder::WriteChannel(data, 1, AnimationChannel::INTERPOLATION_LINEAR, keys);
+
+        AnimationChannel channel;
+        TEST_VERIFY(channel.Bind(data.data()) == uint32(data.size()));
+        TEST_VERIFY(channel.GetCompression() == AnimationChannel::COMPRESSION_NONE);
+        TEST_VERIFY(channel.GetKeysCount() == 2);
+    }
+
+    DAVA_TEST (ConcurrentEvaluationTest)
+    {
+        using namespace AnimationTrackTestDetails;
+
+        Vector<uint8> data = CreateTrackData();
+        AnimationTrack track;
+        track.Bind(data.data());
+
+        // many instances with own cursors evaluate one shared track at once
+        const uint32 instancesCount = 256;
+        Vector<float32> times = CreateSampleTimes();
+        Vector<Vector<AnimationChannel::Cursor>> cursors(instancesCount, Vector<AnimationChannel::Cursor>(track.GetChannelsCount()));
+        Vector<uint8> results(instancesCount, 0);
+
+        GetEngineContext()->jobManager->ParallelFor(0, instancesCount, 4, [&](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+                results[i] = EvaluatesSame(track, times, cursors[i]) ? 1 : 0;
+        });
+
+        TEST_VERIFY(uint32(std::count(results.begin(), results.end(), uint8(1))) == instancesCount);
+    }
+};
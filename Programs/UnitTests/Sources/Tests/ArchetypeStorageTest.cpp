@@ -0,0 +1,212 @@
+#include "DAVAEngine.h"
+#include "UnitTests/UnitTests.h"
+#include "Scene3D/Components/WaveComponent.h"
+#include "Scene3D/Components/WindComponent.h"
+
+#include <atomic>
+
+using namespace DAVA;
+
+namespace ArchetypeStorageTestDetails
+{
+struct Velocity
+{
+    float32 x = 0.f;
+    float32 y = 0.f;
+};
+
+Entity* CreateEntity(Entity* parent)
+{
+    Entity* entity = new Entity();
+    parent->AddNode(entity);
+    entity->Release();
+    return entity;
+}
+
+uint32 CountWind(Scene* scene)
+{
+    uint32 count = 0;
+    scene->ForEach<WindComponent>([&count](Entity* entity, WindComponent* wind) {
+        TEST_VERIFY(entity->GetComponent<WindComponent>() == wind);
+        ++count;
+    });
+    return count;
+}
+}
+
+DAVA_TESTCLASS (ArchetypeStorageTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("ArchetypeStorage.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (ForEachTest)
+    {
+        using namespace ArchetypeStorageTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene());
+
+        // entities added before registration are picked up by it
+        Entity* a = CreateEntity(scene);
+        a->AddComponent(new WindComponent());
+        Entity* b = CreateEntity(a);
+        b->AddComponent(new WindComponent());
+        b->AddComponent(new WaveComponent());
+
+        scene->RegisterArchetypeComponent<WindComponent>();
+        scene->RegisterArchetypeComponent<WaveComponent>();
+        TEST_VERIFY(scene->archetypeStorage.GetEntitiesCount() == 2);
+        TEST_VERIFY(CountWind(scene) == 2);
+
+        uint32 count = 0;
+        scene->ForEach<WindComponent, WaveComponent>([&](Entity* entity, WindComponent* wind, WaveComponent* wave) {
+            TEST_VERIFY(entity == b);
+            TEST_VERIFY(entity->GetComponent<WindComponent>() == wind);
+            TEST_VERIFY(entity->GetComponent<WaveComponent>() == wave);
+            ++count;
+        });
+        TEST_VERIFY(count == 1);
+
+        // entities added later are tracked by scene
+        Entity* c = CreateEntity(scene);
+        c->AddComponent(new WaveComponent());
+        TEST_VERIFY(CountWind(scene) == 2);
+        c->AddComponent(new WindComponent());
+        TEST_VERIFY(CountWind(scene) == 3);
+
+        // removing component moves entity to another archetype
+        b->RemoveComponent<WindComponent>();
+        TEST_VERIFY(CountWind(scene) == 2);
+        TEST_VERIFY(scene->archetypeStorage.GetEntitiesCount() == 3);
+
+        // the second component of the same type replaces the removed first one
+        WindComponent* secondWind = new WindComponent();
+        c->AddComponent(secondWind);
+        c->RemoveComponent(c->GetComponent<WindComponent>());
+        scene->ForEach<WindComponent>([&](Entity* entity, WindComponent* wind) {
+            if (entity == c)
+            {
+                TEST_VERIFY(wind == secondWind);
+            }
+        });
+
+        // removing entity removes its children too
+        scene->RemoveNode(a);
+        TEST_VERIFY(scene->archetypeStorage.GetEntitiesCount() == 1);
+        TEST_VERIFY(CountWind(scene) == 1);
+    }
+
+    DAVA_TEST (ParallelForEachTest)
+    {
+        using namespace ArchetypeStorageTestDetails;
+
+        const uint32 entitiesCount = ArchetypeStorage::CHUNK_CAPACITY * 5 + 7;
+
+        ScopedPtr<Scene> scene(new Scene());
+        scene->RegisterArchetypeComponent<WindComponent>();
+        scene->RegisterArchetypeComponent<WaveComponent>();
+
+        for (uint32 i = 0; i < entitiesCount; ++i)
+        {
+            Entity* entity = CreateEntity(scene);
+            entity->AddComponent(new WindComponent());
+            if (i % 2 == 0)
+            {
+                entity->AddComponent(new WaveComponent());
+            }
+        }
+        TEST_VERIFY(scene->archetypeStorage.GetArchetypesCount() == 2);
+
+        std::atomic<uint32> windCount = { 0 };
+        scene->ParallelForEach<WindComponent>([&windCount](Entity* entity, WindComponent* wind) {
+            wind->SetWindSpeed(2.f);
+            ++windCount;
+        });
+        TEST_VERIFY(windCount == entitiesCount);
+
+        std::atomic<uint32> waveCount = { 0 };
+        scene->ParallelForEach<WaveComponent, WindComponent>([&waveCount](Entity* entity, WaveComponent* wave, WindComponent* wind) {
+            ++waveCount;
+        });
+        TEST_VERIFY(waveCount == (entitiesCount + 1) / 2);
+
+        bool allUpdated = true;
+        scene->ForEach<WindComponent>([&allUpdated](Entity* entity, WindComponent* wind) {
+            allUpdated = allUpdated && wind->GetWindSpeed() == 2.f;
+        });
+        TEST_VERIFY(allUpdated);
+
+        // rows stay dense after removal from the middle of chunks
+        for (int32 i = scene->GetChildrenCount() - 1; i >= 0; i -= 3)
+        {
+            scene->RemoveNode(scene->GetChild(i));
+        }
+        uint32 expected = static_cast<uint32>(scene->GetChildrenCount());
+        TEST_VERIFY(scene->archetypeStorage.GetEntitiesCount() == expected);
+        TEST_VERIFY(CountWind(scene) == expected);
+    }
+
+    DAVA_TEST (DataTest)
+    {
+        using namespace ArchetypeStorageTestDetails;
+
+        const uint32 entitiesCount = ArchetypeStorage::CHUNK_CAPACITY + 3;
+
+        ScopedPtr<Scene> scene(new Scene());
+        scene->RegisterArchetypeComponent<WindComponent>();
+        scene->archetypeStorage.RegisterDataType<Velocity>();
+        TEST_VERIFY(scene->archetypeStorage.IsRegisteredDataType(Type::Instance<Velocity>()));
+        TEST_VERIFY(!scene->archetypeStorage.IsRegisteredComponentType(Type::Instance<Velocity>()));
+
+        Vector<Entity*> entities;
+        for (uint32 i = 0; i < entitiesCount; ++i)
+        {
+            Entity* entity = CreateEntity(scene);
+            Velocity velocity;
+            velocity.x = float32(i);
+            scene->archetypeStorage.SetData(entity, velocity);
+            entities.push_back(entity);
+        }
+        TEST_VERIFY(scene->archetypeStorage.GetEntitiesCount() == entitiesCount);
+
+        // data is stored by value in chunk and is kept when entity moves to another archetype
+        for (uint32 i = 0; i < entitiesCount; i += 2)
+        {
+            entities[i]->AddComponent(new WindComponent());
+        }
+        scene->ParallelForEach<Velocity>([](Entity* entity, Velocity* velocity) {
+            velocity->y = velocity->x * 2.f;
+        });
+
+        bool allKept = true;
+        for (uint32 i = 0; i < entitiesCount; ++i)
+        {
+            Velocity* velocity = scene->archetypeStorage.GetData<Velocity>(entities[i]);
+            allKept = allKept && velocity != nullptr && velocity->x == float32(i) && velocity->y == float32(i) * 2.f;
+        }
+        TEST_VERIFY(allKept);
+
+        uint32 count = 0;
+        scene->ForEach<WindComponent, Velocity>([&count](Entity* entity, WindComponent* wind, Velocity* velocity) {
+            TEST_VERIFY(entity->GetComponent<WindComponent>() == wind);
+            TEST_VERIFY(static_cast<uint32>(velocity->x) % 2 == 0);
+            ++count;
+        });
+        TEST_VERIFY(count == (entitiesCount + 1) / 2);
+
+        // entity without components and data isn't stored
+        scene->archetypeStorage.RemoveData<Velocity>(entities[1]);
+        TEST_VERIFY(scene->archetypeStorage.GetData<Velocity>(entities[1]) == nullptr);
+        TEST_VERIFY(scene->archetypeStorage.GetEntitiesCount() == entitiesCount - 1);
+
+        // removing data keeps components
+        scene->archetypeStorage.RemoveData<Velocity>(entities[0]);
+        TEST_VERIFY(scene->archetypeStorage.GetEntitiesCount() == entitiesCount - 1);
+        TEST_VERIFY(CountWind(scene) == (entitiesCount + 1) / 2);
+
+        // data is removed with entity
+        scene->RemoveNode(entities[2]);
+        TEST_VERIFY(scene->archetypeStorage.GetEntitiesCount() == entitiesCount - 2);
+    }
+};
@@ -1,9 +1,11 @@
 #include "UnitTests/UnitTests.h"
 #include <FileSystem/Private/PackArchive.h>
+#include <FileSystem/Private/MappedFile.h>
 #include <FileSystem/Private/ZipArchive.h>
 #include <FileSystem/FileSystem.h>
 #include <Logger/Logger.h>
 
+#include <atomic>
 #include <cstring>
 
 using namespace DAVA;
@@ -58,6 +60,103 @@ DAVA_TESTCLASS (ArchiveTest)
 #endif // __DAVAENGINE_IPHONE__
     }
 
+    DAVA_TEST (TestMappedDavaArchive)
+    {
+#if !defined(__DAVAENGINE_IPHONE__) && !defined(__DAVAENGINE_ANDROID__)
+        try
+        {
+            const FilePath archivePath("~res:/TestData/ArchiveTest/archive.dvpk");
+            RefPtr<File> fileDvpk(File::Create(archivePath, File::OPEN | File::READ));
+            PackArchive fileArchive(fileDvpk, archivePath);
+
+            RefPtr<File> fileDvpkMapped(File::Create(archivePath, File::OPEN | File::READ));
+            std::shared_ptr<MappedFile> mapping = MappedFile::Open(archivePath);
+            TEST_VERIFY(mapping != nullptr);
+
+            ResourceArchive::FileView view;
+            {
+                PackArchive mappedArchive(fileDvpkMapped, archivePath, mapping);
+                TEST_VERIFY(mappedArchive.IsMemoryMapped());
+
+                // every file should be the same as loaded through File reads
+                for (const ResourceArchive::FileInfo& info : fileArchive.GetFilesInfo())
+                {
+                    Vector<uint8> fromFile;
+                    Vector<uint8> fromMapping;
+                    TEST_VERIFY(fileArchive.LoadFile(info.relativeFilePath, fromFile));
+                    TEST_VERIFY(mappedArchive.LoadFile(info.relativeFilePath, fromMapping));
+                    TEST_VERIFY(fromFile == fromMapping);
+
+                    ResourceArchive::FileView fileView;
+                    TEST_VERIFY(mappedArchive.LoadFileView(info.relativeFilePath, fileView));
+                    TEST_VERIFY(fileView.GetSize() == fromFile.size());
+                    TEST_VERIFY(std::equal(fileView.begin(), fileView.end(), fromFile.begin()));
+
+                    if (info.compressionType == Compressor::Type::None)
+                    {
+                        // uncompressed content is not copied
+                        TEST_VERIFY(fileView.GetData() >= mapping->GetData() && fileView.end() <= mapping->GetData() + mapping->GetSize());
+                    }
+                }
+
+                TEST_VERIFY(mappedArchive.LoadFileView("Utf8Test/utf16le.txt", view));
+                TEST_VERIFY(!mappedArchive.LoadFileView("not/existing/file.txt", view) && !view.IsEmpty());
+            }
+
+            // view keeps its memory alive after archive and mapping owners are gone
+            mapping.reset();
+            Vector<uint8> expected;
+            TEST_VERIFY(fileArchive.LoadFile("Utf8Test/utf16le.txt", expected));
+            TEST_VERIFY(view.GetSize() == expected.size() && std::equal(view.begin(), view.end(), expected.begin()));
+        }
+        catch (std::exception& ex)
+        {
+            Logger::Info(ex.what());
+        }
+#endif // __DAVAENGINE_IPHONE__
+    }
+
+    DAVA_TEST (TestBatchLoadDavaArchive)
+    {
+        try
+        {
+            ResourceArchive archive("~res:/TestData/ArchiveTest/archive.dvpk");
+
+            // request files in reverse order plus one missing file, results should match LoadFile
+            Vector<String> paths;
+            for (const ResourceArchive::FileInfo& info : archive.GetFilesInfo())
+            {
+                paths.insert(paths.begin(), info.relativeFilePath);
+            }
+            paths.push_back("not/existing/file.txt");
+
+            Vector<Vector<uint8>> contents;
+            TEST_VERIFY(!archive.LoadFiles(paths, contents));
+            TEST_VERIFY(contents.size() == paths.size());
+            TEST_VERIFY(contents.back().empty());
+
+            for (size_t i = 0; i + 1 < paths.size(); ++i)
+            {
+                Vector<uint8> expected;
+                TEST_VERIFY(archive.LoadFile(paths[i], expected));
+                TEST_VERIFY(contents[i] == expected);
+            }
+
+            std::atomic<uint32> loadedCount(0);
+            archive.LoadFiles(paths, [&loadedCount](uint32, bool loaded, Vector<uint8>&) {
+                if (loaded)
+                {
+                    ++loadedCount;
+                }
+            });
+            TEST_VERIFY(loadedCount == paths.size() - 1);
+        }
+        catch (std::exception& ex)
+        {
+            Logger::Info(ex.what());
+        }
+    }
+
     DAVA_TEST (TestZipArchive)
     {
         try
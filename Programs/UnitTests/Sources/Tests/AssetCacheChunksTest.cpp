@@ -0,0 +1,137 @@
+#include <DAVAEngine.h>
+#include <UnitTests/UnitTests.h>
+
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
+
+#include <AssetCache/CachePacket.h>
+#include <AssetCache/ChunkSplitter.h>
+
+DAVA_TESTCLASS (AssetCacheChunksTest)
+{
+    // ChunkSplitter::GetChunk
+    DAVA_TEST (ChunksReferToData)
+    {
+        using namespace DAVA;
+
+        Vector<uint8> data(12 * 1024 * 1024 + 5);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<uint8>(i % 251);
+        }
+
+        uint32 chunksCount = AssetCache::ChunkSplitter::GetNumberOfChunks(data.size());
+        TEST_VERIFY(chunksCount > 1);
+
+        const uint8* expectedData = data.data();
+        uint32 firstChunkSize = AssetCache::ChunkSplitter::GetChunk(data, 0).size;
+        for (uint32 chunkNumber = 0; chunkNumber < chunksCount; ++chunkNumber)
+        {
+            AssetCache::ChunkView chunk = AssetCache::ChunkSplitter::GetChunk(data, chunkNumber);
+            TEST_VERIFY(chunk.data == expectedData);
+            TEST_VERIFY(chunk.size > 0);
+            TEST_VERIFY(chunk.size == firstChunkSize || chunkNumber + 1 == chunksCount);
+            expectedData += chunk.size;
+        }
+        TEST_VERIFY(expectedData == data.data() + data.size());
+
+        TEST_VERIFY(AssetCache::ChunkSplitter::GetChunk(data, chunksCount).size == 0);
+    }
+
+    // DataChunkPacket::DeserializeFromBuffer
+    DAVA_TEST (ReceivedChunkRefersToPacket)
+    {
+        using namespace DAVA;
+
+        AssetCache::CacheItemKey key;
+        key.fill(7);
+
+        Vector<uint8> data(1000);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<uint8>(i % 13);
+        }
+
+        AssetCache::AddChunkRequestPacket sentPacket(key, data.size(), 1, 0, AssetCache::ChunkView(data.data(), static_cast<uint32>(data.size())));
+        const Vector<uint8>& rawData = sentPacket.serializationBuffer->GetDataVector();
+
+        std::unique_ptr<AssetCache::CachePacket> packet;
+        TEST_VERIFY(AssetCache::CachePacket::Create(rawData.data(), static_cast<uint32>(rawData.size()), packet) == AssetCache::CachePacket::CREATED);
+        TEST_VERIFY(packet && packet->type == AssetCache::PACKET_ADD_CHUNK_REQUEST);
+
+        const AssetCache::AddChunkRequestPacket* receivedPacket = static_cast<const AssetCache::AddChunkRequestPacket*>(packet.get());
+        TEST_VERIFY(receivedPacket->key == key);
+        TEST_VERIFY(receivedPacket->dataSize == data.size());
+        TEST_VERIFY(receivedPacket->chunkData.size == data.size());
+        TEST_VERIFY(receivedPacket->chunkData.data >= rawData.data() && receivedPacket->chunkData.data + receivedPacket->chunkData.size == rawData.data() + rawData.size());
+        TEST_VERIFY(Memcmp(receivedPacket->chunkData.data, data.data(), data.size()) == 0);
+
+        // truncated packet isn't created
+        TEST_VERIFY(AssetCache::CachePacket::Create(rawData.data(), static_cast<uint32>(rawData.size() - 1), packet) == AssetCache::CachePacket::ERR_INCORRECT_DATA);
+    }
+
+    // GetBatchRequestPacket::DeserializeFromBuffer
+    DAVA_TEST (ReceivedBatchHasAllKeys)
+    {
+        using namespace DAVA;
+
+        Vector<AssetCache::CacheItemKey> keys(300);
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            keys[i].fill(static_cast<uint8>(i));
+        }
+
+        AssetCache::GetBatchRequestPacket sentPacket(keys);
+        const Vector<uint8>& rawData = sentPacket.serializationBuffer->GetDataVector();
+
+        std::unique_ptr<AssetCache::CachePacket> packet;
+        TEST_VERIFY(AssetCache::CachePacket::Create(rawData.data(), static_cast<uint32>(rawData.size()), packet) == AssetCache::CachePacket::CREATED);
+        TEST_VERIFY(packet && packet->type == AssetCache::PACKET_GET_BATCH_REQUEST);
+        TEST_VERIFY(static_cast<const AssetCache::GetBatchRequestPacket*>(packet.get())->keys == keys);
+
+        TEST_VERIFY(AssetCache::CachePacket::Create(rawData.data(), static_cast<uint32>(rawData.size() - 1), packet) == AssetCache::CachePacket::ERR_INCORRECT_DATA);
+    }
+
+    // AddBatchRequestPacket::DeserializeFromBuffer
+    DAVA_TEST (ReceivedBatchItemsReferToPacket)
+    {
+        using namespace DAVA;
+
+        Vector<uint8> data(1000);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<uint8>(i % 17);
+        }
+
+        // items of different sizes, including empty one, refer to parts of data
+        Vector<AssetCache::ItemChunkView> items(4);
+        uint32 offsets[] = { 0, 100, 100, 600 };
+        uint32 sizes[] = { 100, 0, 500, 400 };
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            items[i].key.fill(static_cast<uint8>(i + 1));
+            items[i].chunk = AssetCache::ChunkView(data.data() + offsets[i], sizes[i]);
+        }
+
+        AssetCache::AddBatchRequestPacket sentPacket(items);
+        const Vector<uint8>& rawData = sentPacket.serializationBuffer->GetDataVector();
+
+        std::unique_ptr<AssetCache::CachePacket> packet;
+        TEST_VERIFY(AssetCache::CachePacket::Create(rawData.data(), static_cast<uint32>(rawData.size()), packet) == AssetCache::CachePacket::CREATED);
+        TEST_VERIFY(packet && packet->type == AssetCache::PACKET_ADD_BATCH_REQUEST);
+
+        const AssetCache::AddBatchRequestPacket* receivedPacket = static_cast<const AssetCache::AddBatchRequestPacket*>(packet.get());
+        TEST_VERIFY(receivedPacket->items.size() == items.size());
+        for (size_t i = 0; i < items.size() && i < receivedPacket->items.size(); ++i)
+        {
+            const AssetCache::ItemChunkView& item = receivedPacket->items[i];
+            TEST_VERIFY(item.key == items[i].key);
+            TEST_VERIFY(item.chunk.size == sizes[i]);
+            TEST_VERIFY(item.chunk.data >= rawData.data() && item.chunk.data + item.chunk.size <= rawData.data() + rawData.size());
+            TEST_VERIFY(Memcmp(item.chunk.data, data.data() + offsets[i], sizes[i]) == 0);
+        }
+
+        TEST_VERIFY(AssetCache::CachePacket::Create(rawData.data(), static_cast<uint32>(rawData.size() - 1), packet) == AssetCache::CachePacket::ERR_INCORRECT_DATA);
+    }
+};
+
+#endif
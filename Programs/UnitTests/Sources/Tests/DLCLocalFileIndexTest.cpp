@@ -0,0 +1,100 @@
+#include <DLCManager/Private/LocalFileIndex.h>
+#include <FileSystem/File.h>
+#include <FileSystem/FileSystem.h>
+#include <Engine/Engine.h>
+
+#include "UnitTests/UnitTests.h"
+
+#ifndef __DAVAENGINE_WIN_UAP__
+
+DAVA_TESTCLASS (DLCLocalFileIndexTest)
+{
+    DAVA_TEST (SavedEntriesAreFound)
+    {
+        using namespace DAVA;
+
+        FileSystem* fs = GetEngineContext()->fileSystem;
+        const FilePath dir("~doc:/UnitTests/DLCLocalFileIndexTest/");
+        const FilePath indexPath = dir + "local_files_index.index";
+        fs->DeleteDirectory(dir);
+        fs->CreateDirectory(dir, true);
+
+        const int64 scanTime = 1000;
+
+        Vector<LocalFileIndex::Entry> entries(3);
+        entries[0].relativeName = "a.dvpl";
+        entries[0].sizeOnDevice = 100;
+        entries[0].modificationTime = scanTime - 10;
+        entries[0].compressedSize = 80;
+        entries[0].crc32Hash = 0x12345678;
+        entries[1].relativeName = "dir/b.dvpl";
+        entries[1].sizeOnDevice = 20;
+        entries[1].modificationTime = scanTime - 1;
+        entries[1].compressedSize = 0;
+        entries[1].crc32Hash = 0;
+        // modified in the same second as files were listed
+        entries[2].relativeName = "c.dvpl";
+        entries[2].sizeOnDevice = 30;
+        entries[2].modificationTime = scanTime;
+
+        TEST_VERIFY(LocalFileIndex::Save(indexPath, entries, scanTime));
+        TEST_VERIFY(fs->IsFile(indexPath));
+
+        LocalFileIndex index;
+        TEST_VERIFY(index.Load(indexPath));
+        TEST_VERIFY(index.GetCount() == entries.size());
+
+        const LocalFileIndex::Entry* entry = index.Find("a.dvpl", 100, scanTime - 10);
+        TEST_VERIFY(entry != nullptr && entry->compressedSize == 80 && entry->crc32Hash == 0x12345678);
+        entry = index.Find("dir/b.dvpl", 20, scanTime - 1);
+        TEST_VERIFY(entry != nullptr && entry->compressedSize == 0 && entry->crc32Hash == 0);
+
+        // changed files aren't found
+        TEST_VERIFY(index.Find("a.dvpl", 101, scanTime - 10) == nullptr);
+        TEST_VERIFY(index.Find("a.dvpl", 100, scanTime - 9) == nullptr);
+        TEST_VERIFY(index.Find("c.dvpl", 30, scanTime) == nullptr);
+        TEST_VERIFY(index.Find("d.dvpl", 100, scanTime - 10) == nullptr);
+
+        fs->DeleteDirectory(dir);
+    }
+
+    DAVA_TEST (CorruptedIndexIsNotLoaded)
+    {
+        using namespace DAVA;
+
+        FileSystem* fs = GetEngineContext()->fileSystem;
+        const FilePath dir("~doc:/UnitTests/DLCLocalFileIndexTest/");
+        const FilePath indexPath = dir + "local_files_index.index";
+        fs->DeleteDirectory(dir);
+        fs->CreateDirectory(dir, true);
+
+        LocalFileIndex index;
+        TEST_VERIFY(index.Load(indexPath) == false);
+
+        Vector<LocalFileIndex::Entry> entries(1);
+        entries[0].relativeName = "a.dvpl";
+        entries[0].sizeOnDevice = 100;
+        TEST_VERIFY(LocalFileIndex::Save(indexPath, entries, 1000));
+
+        Vector<uint8> content;
+        {
+            ScopedPtr<File> f(File::Create(indexPath, File::OPEN | File::READ));
+            TEST_VERIFY(f);
+            content.resize(static_cast<size_t>(f->GetSize()));
+            f->Read(content.data(), static_cast<uint32>(content.size()));
+        }
+        content[content.size() / 2] ^= 0xff;
+        {
+            ScopedPtr<File> f(File::Create(indexPath, File::CREATE | File::WRITE));
+            TEST_VERIFY(f);
+            f->Write(content.data(), static_cast<uint32>(content.size()));
+        }
+
+        TEST_VERIFY(index.Load(indexPath) == false);
+        TEST_VERIFY(index.GetCount() == 0);
+
+        fs->DeleteDirectory(dir);
+    }
+};
+
+#endif // __DAVAENGINE_WIN_UAP__
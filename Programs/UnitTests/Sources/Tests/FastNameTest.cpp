@@ -152,4 +152,55 @@ DAVA_TESTCLASS (FastNameTest)
             TEST_VERIFY(strcmp(fns[i].back().c_str(), std::to_string(i).c_str()) == 0);
         }
     }
+
+    DAVA_TEST (LiteralTest)
+    {
+        static const FastNameLiteral literal("fast_name_literal");
+
+        FastName fn1(literal);
+        FastName fn2("fast_name_literal");
+        FastName fn3(String("fast_name_literal"));
+
+        TEST_VERIFY(literal.GetHash() == DavaHashString("fast_name_literal"));
+        TEST_VERIFY(fn1 == fn2);
+        TEST_VERIFY(fn1 == fn3);
+        TEST_VERIFY(strcmp(fn1.c_str(), "fast_name_literal") == 0);
+    }
+
+    DAVA_TEST (ConcurrentGrowthTest)
+    {
+        // enough new names to grow every shard several times while other threads read them
+        const size_t threadsNum = 8;
+        const size_t namesNum = 50000;
+
+        Array<Thread*, threadsNum> threads;
+        Vector<Vector<const char*>> results(threadsNum, Vector<const char*>(namesNum));
+
+        for (size_t i = 0; i < threads.size(); ++i)
+        {
+            threads[i] = Thread::Create([i, &results]() {
+                for (size_t j = 0; j < results[i].size(); ++j)
+                {
+                    size_t k = (j * 7 + i * 13) % results[i].size();
+                    results[i][k] = FastName("growth_" + std::to_string(k)).c_str();
+                }
+            });
+            threads[i]->Start();
+        }
+
+        for (auto& thread : threads)
+        {
+            thread->Join();
+            SafeRelease(thread);
+        }
+
+        for (size_t j = 0; j < namesNum; ++j)
+        {
+            for (size_t i = 1; i < threadsNum; ++i)
+            {
+                TEST_VERIFY(results[i][j] == results[0][j]);
+            }
+            TEST_VERIFY(("growth_" + std::to_string(j)) == results[0][j]);
+        }
+    }
 };
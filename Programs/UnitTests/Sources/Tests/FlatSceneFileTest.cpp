@@ -0,0 +1,347 @@
+#include "DAVAEngine.h"
+#include "UnitTests/UnitTests.h"
+#include "Render/3D/PolygonGroup.h"
+#include "Render/Highlevel/Mesh.h"
+#include "Render/Material/NMaterialNames.h"
+#include "Scene3D/Components/ComponentHelpers.h"
+#include "Scene3D/Components/RenderComponent.h"
+#include "Scene3D/Components/CustomPropertiesComponent.h"
+#include "Scene3D/Components/SwitchComponent.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Components/WaveComponent.h"
+#include "Scene3D/Components/WindComponent.h"
+#include "Scene3D/Lod/LodComponent.h"
+
+using namespace DAVA;
+
+namespace FlatSceneFileTestDetails
+{
+Entity* CreateEntity(const char* name, Entity* parent)
+{
+    Entity* entity = new Entity();
+    entity->SetName(name);
+    parent->AddNode(entity);
+    entity->Release();
+    return entity;
+}
+
+// mesh with one triangle batch per lod, batches share material
+void AddMesh(Entity* entity)
+{
+    ScopedPtr<NMaterial> material(new NMaterial());
+    material->SetMaterialName(FastName("mesh_material"));
+    material->SetFXName(NMaterialName::TEXTURED_OPAQUE);
+
+    ScopedPtr<Mesh> mesh(new Mesh());
+    for (int32 lod = 0; lod < 2; ++lod)
+    {
+        ScopedPtr<PolygonGroup> polygonGroup(new PolygonGroup());
+        polygonGroup->AllocateData(EVF_VERTEX, 3, 3);
+        polygonGroup->SetCoord(0, Vector3(0.f, 0.f, float32(lod)));
+        polygonGroup->SetCoord(1, Vector3(1.f, 0.f, float32(lod)));
+        polygonGroup->SetCoord(2, Vector3(0.f, 1.f, float32(lod)));
+        for (int32 i = 0; i < 3; ++i)
+        {
+            polygonGroup->SetIndex(i, int16(i));
+        }
+        polygonGroup->RecalcAABBox();
+
+        ScopedPtr<RenderBatch> batch(new RenderBatch());
+        batch->SetPolygonGroup(polygonGroup);
+        batch->SetMaterial(material);
+        batch->SetSortingKey(lod + 3);
+        mesh->AddRenderBatch(batch, lod, -1);
+    }
+
+    entity->AddComponent(new RenderComponent(mesh));
+}
+
+// a(wind) -> [a1(switch, custom properties) -> [a11], a2(wave)], b(wind, transform), c(lod, mesh)
+void FillScene(Scene* scene)
+{
+    Entity* a = CreateEntity("a", scene);
+    WindComponent* wind = new WindComponent();
+    wind->SetWindForce(3.5f);
+    wind->SetWindSpeed(0.25f);
+    wind->SetInfluenceBBox(AABBox3(Vector3(-1.f, -2.f, -3.f), Vector3(4.f, 5.f, 6.f)));
+    a->AddComponent(wind);
+
+    Entity* a1 = CreateEntity("a1", a);
+    SwitchComponent* switchComponent = new SwitchComponent();
+    switchComponent->SetSwitchIndex(1);
+    a1->AddComponent(switchComponent);
+    GetOrCreateCustomProperties(a1)->GetArchive()->SetString("property", "value");
+    CreateEntity("a11", a1);
+
+    Entity* a2 = CreateEntity("a2", a);
+    WaveComponent* wave = new WaveComponent();
+    wave->SetWaveAmplitude(2.f);
+    wave->SetInfluenceRadius(15.f);
+    a2->AddComponent(wave);
+
+    Entity* b = CreateEntity("b", scene);
+    b->AddComponent(new WindComponent());
+    TransformComponent* transform = GetTransformComponent(b);
+    transform->SetLocalTranslation(Vector3(1.f, 2.f, 3.f));
+    transform->SetLocalScale(Vector3(2.f, 2.f, 2.f));
+
+    Entity* c = CreateEntity("c", scene);
+    LodComponent* lod = new LodComponent();
+    lod->SetLodLayerDistance(0, 50.f);
+    c->AddComponent(lod);
+    AddMesh(c);
+}
+
+bool CompareRenderObjects(RenderObject* object1, RenderObject* object2)
+{
+    if ((object1 == nullptr) != (object2 == nullptr))
+    {
+        return false;
+    }
+    if (object1 == nullptr)
+    {
+        return true;
+    }
+    if (object1->GetClassName() != object2->GetClassName() || object1->GetRenderBatchCount() != object2->GetRenderBatchCount())
+    {
+        return false;
+    }
+
+    for (uint32 i = 0; i < object1->GetRenderBatchCount(); ++i)
+    {
+        int32 lod1 = -1, switch1 = -1, lod2 = -1, switch2 = -1;
+        RenderBatch* batch1 = object1->GetRenderBatch(i, lod1, switch1);
+        RenderBatch* batch2 = object2->GetRenderBatch(i, lod2, switch2);
+        if (lod1 != lod2 || switch1 != switch2 || batch1->GetSortingKey() != batch2->GetSortingKey())
+        {
+            return false;
+        }
+
+        NMaterial* material1 = batch1->GetMaterial();
+        NMaterial* material2 = batch2->GetMaterial();
+        if (material1 == nullptr || material2 == nullptr || material1->GetMaterialName() != material2->GetMaterialName())
+        {
+            return false;
+        }
+
+        PolygonGroup* polygonGroup1 = batch1->GetPolygonGroup();
+        PolygonGroup* polygonGroup2 = batch2->GetPolygonGroup();
+        if (polygonGroup1 == nullptr || polygonGroup2 == nullptr || polygonGroup1->GetVertexCount() != polygonGroup2->GetVertexCount())
+        {
+            return false;
+        }
+        for (int32 v = 0; v < polygonGroup1->GetVertexCount(); ++v)
+        {
+            Vector3 coord1, coord2;
+            polygonGroup1->GetCoord(v, coord1);
+            polygonGroup2->GetCoord(v, coord2);
+            if (coord1 != coord2)
+            {
+                return false;
+            }
+        }
+    }
+
+    // batches sharing material keep sharing it
+    if (object1->GetRenderBatchCount() > 1)
+    {
+        bool shared1 = object1->GetRenderBatch(0)->GetMaterial() == object1->GetRenderBatch(1)->GetMaterial();
+        bool shared2 = object2->GetRenderBatch(0)->GetMaterial() == object2->GetRenderBatch(1)->GetMaterial();
+        return shared1 == shared2;
+    }
+    return true;
+}
+
+bool CompareEntities(Entity* entity1, Entity* entity2)
+{
+    if (entity1->GetName() != entity2->GetName() || entity1->GetID() != entity2->GetID() || entity1->GetChildrenCount() != entity2->GetChildrenCount())
+    {
+        return false;
+    }
+
+    WindComponent* wind1 = GetWindComponent(entity1);
+    WindComponent* wind2 = GetWindComponent(entity2);
+    if ((wind1 == nullptr) != (wind2 == nullptr))
+    {
+        return false;
+    }
+    if (wind1 != nullptr && (wind1->GetWindForce() != wind2->GetWindForce() || wind1->GetWindSpeed() != wind2->GetWindSpeed() || wind1->GetInfluenceBBox() != wind2->GetInfluenceBBox()))
+    {
+        return false;
+    }
+
+    SwitchComponent* switch1 = GetSwitchComponent(entity1);
+    SwitchComponent* switch2 = GetSwitchComponent(entity2);
+    if ((switch1 == nullptr) != (switch2 == nullptr) || (switch1 != nullptr && switch1->GetSwitchIndex() != switch2->GetSwitchIndex()))
+    {
+        return false;
+    }
+
+    WaveComponent* wave1 = GetWaveComponent(entity1);
+    WaveComponent* wave2 = GetWaveComponent(entity2);
+    if ((wave1 == nullptr) != (wave2 == nullptr) || (wave1 != nullptr && (wave1->GetWaveAmplitude() != wave2->GetWaveAmplitude() || wave1->GetInfluenceRadius() != wave2->GetInfluenceRadius())))
+    {
+        return false;
+    }
+
+    const Transform& transform1 = GetTransformComponent(entity1)->GetLocalTransform();
+    const Transform& transform2 = GetTransformComponent(entity2)->GetLocalTransform();
+    if (transform1.GetTranslation() != transform2.GetTranslation() || transform1.GetScale() != transform2.GetScale())
+    {
+        return false;
+    }
+
+    LodComponent* lod1 = GetLodComponent(entity1);
+    LodComponent* lod2 = GetLodComponent(entity2);
+    if ((lod1 == nullptr) != (lod2 == nullptr) || (lod1 != nullptr && lod1->GetLodLayerDistance(0) != lod2->GetLodLayerDistance(0)))
+    {
+        return false;
+    }
+
+    if (!CompareRenderObjects(GetRenderObject(entity1), GetRenderObject(entity2)))
+    {
+        return false;
+    }
+
+    KeyedArchive* props1 = GetCustomPropertiesArchieve(entity1);
+    KeyedArchive* props2 = GetCustomPropertiesArchieve(entity2);
+    if ((props1 == nullptr) != (props2 == nullptr) || (props1 != nullptr && props1->GetString("property") != props2->GetString("property")))
+    {
+        return false;
+    }
+
+    for (int32 i = 0; i < entity1->GetChildrenCount(); ++i)
+    {
+        if (!CompareEntities(entity1->GetChild(i), entity2->GetChild(i)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompareScenes(Scene* scene1, Scene* scene2)
+{
+    if (scene1->GetChildrenCount() != scene2->GetChildrenCount())
+    {
+        return false;
+    }
+    for (int32 i = 0; i < scene1->GetChildrenCount(); ++i)
+    {
+        if (!CompareEntities(scene1->GetChild(i), scene2->GetChild(i)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+DAVA_TESTCLASS (FlatSceneFileTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("FlatHierarchy.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (SaveLoadTest)
+    {
+        using namespace FlatSceneFileTestDetails;
+
+        FilePath flatScenePath = "~doc:/FlatSceneFileTest/flat.sc2";
+        FilePath nestedScenePath = "~doc:/FlatSceneFileTest/nested.sc2";
+        GetEngineContext()->fileSystem->CreateDirectory("~doc:/FlatSceneFileTest/", true);
+
+        ScopedPtr<Scene> scene(new Scene());
+        FillScene(scene);
+
+        TEST_VERIFY(scene->SaveScene(flatScenePath, false, true) == SceneFileV2::ERROR_NO_ERROR);
+        TEST_VERIFY(scene->SaveScene(nestedScenePath) == SceneFileV2::ERROR_NO_ERROR);
+        TEST_VERIFY(SceneFileV2::LoadSceneVersion(flatScenePath).version == FLAT_HIERARCHY_SCENE_VERSION);
+        TEST_VERIFY(SceneFileV2::LoadSceneVersion(nestedScenePath).version == SCENE_FILE_SAVED_VERSION);
+
+        ScopedPtr<Scene> flatScene(new Scene());
+        TEST_VERIFY(flatScene->LoadScene(flatScenePath) == SceneFileV2::ERROR_NO_ERROR);
+        TEST_VERIFY(CompareScenes(scene, flatScene));
+
+        ScopedPtr<Scene> nestedScene(new Scene());
+        TEST_VERIFY(nestedScene->LoadScene(nestedScenePath) == SceneFileV2::ERROR_NO_ERROR);
+        TEST_VERIFY(CompareScenes(nestedScene, flatScene));
+
+        // flat scene saved again in nested format stays the same
+        TEST_VERIFY(flatScene->SaveScene(nestedScenePath) == SceneFileV2::ERROR_NO_ERROR);
+        ScopedPtr<Scene> resavedScene(new Scene());
+        TEST_VERIFY(resavedScene->LoadScene(nestedScenePath) == SceneFileV2::ERROR_NO_ERROR);
+        TEST_VERIFY(CompareScenes(scene, resavedScene));
+
+        GetEngineContext()->fileSystem->DeleteDirectory("~doc:/FlatSceneFileTest/");
+    }
+
+    DAVA_TEST (PartialLoadTest)
+    {
+        using namespace FlatSceneFileTestDetails;
+
+        FilePath flatScenePath = "~doc:/FlatSceneFileTest/partial.sc2";
+        GetEngineContext()->fileSystem->CreateDirectory("~doc:/FlatSceneFileTest/", true);
+
+        ScopedPtr<Scene> scene(new Scene());
+        FillScene(scene);
+        TEST_VERIFY(scene->SaveScene(flatScenePath, false, true) == SceneFileV2::ERROR_NO_ERROR);
+
+        // skip subtree in the middle and the last one
+        ScopedPtr<Scene> partialScene(new Scene());
+        ScopedPtr<SceneFileV2> sceneFile(new SceneFileV2());
+        sceneFile->SetTopLevelEntityFilter([](const FastName& name) { return name == FastName("a"); });
+        TEST_VERIFY(sceneFile->LoadScene(flatScenePath, partialScene) == SceneFileV2::ERROR_NO_ERROR);
+
+        TEST_VERIFY(partialScene->GetChildrenCount() == 1);
+        if (partialScene->GetChildrenCount() == 1)
+        {
+            TEST_VERIFY(CompareEntities(scene->GetChild(0), partialScene->GetChild(0)));
+        }
+
+        // skip the first subtree
+        ScopedPtr<Scene> tailScene(new Scene());
+        ScopedPtr<SceneFileV2> tailSceneFile(new SceneFileV2());
+        tailSceneFile->SetTopLevelEntityFilter([](const FastName& name) { return name != FastName("a"); });
+        TEST_VERIFY(tailSceneFile->LoadScene(flatScenePath, tailScene) == SceneFileV2::ERROR_NO_ERROR);
+
+        TEST_VERIFY(tailScene->GetChildrenCount() == 2);
+        if (tailScene->GetChildrenCount() == 2)
+        {
+            TEST_VERIFY(CompareEntities(scene->GetChild(1), tailScene->GetChild(0)));
+            TEST_VERIFY(CompareEntities(scene->GetChild(2), tailScene->GetChild(1)));
+        }
+
+        GetEngineContext()->fileSystem->DeleteDirectory("~doc:/FlatSceneFileTest/");
+    }
+
+    DAVA_TEST (SceneArchiveTest)
+    {
+        using namespace FlatSceneFileTestDetails;
+
+        FilePath flatScenePath = "~doc:/FlatSceneFileTest/archive.sc2";
+        GetEngineContext()->fileSystem->CreateDirectory("~doc:/FlatSceneFileTest/", true);
+
+        ScopedPtr<Scene> scene(new Scene());
+        FillScene(scene);
+        TEST_VERIFY(scene->SaveScene(flatScenePath, false, true) == SceneFileV2::ERROR_NO_ERROR);
+
+        ScopedPtr<SceneFileV2> sceneFile(new SceneFileV2());
+        ScopedPtr<SceneArchive> archive(sceneFile->LoadSceneArchive(flatScenePath));
+        TEST_VERIFY(archive);
+        if (archive)
+        {
+            TEST_VERIFY(archive->children.size() == 3);
+            if (archive->children.size() == 3)
+            {
+                SceneArchive::SceneArchiveHierarchyNode* a = archive->children[0];
+                TEST_VERIFY(a->archive->GetString("name") == "a");
+                TEST_VERIFY(a->children.size() == 2);
+                TEST_VERIFY(a->archive->GetArchive("components")->GetUInt32("count") == 2); // transform and wind
+            }
+        }
+
+        GetEngineContext()->fileSystem->DeleteDirectory("~doc:/FlatSceneFileTest/");
+    }
+};
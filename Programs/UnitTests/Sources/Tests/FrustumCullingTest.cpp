@@ -0,0 +1,191 @@
+#include "UnitTests/UnitTests.h"
+#include "Base/ScopedPtr.h"
+#include "Render/Highlevel/Camera.h"
+#include "Render/Highlevel/Frustum.h"
+#include "Render/Highlevel/FrustumCulling.h"
+#include "Utils/Random.h"
+
+using namespace DAVA;
+
+namespace FrustumCullingTestDetails
+{
+void FillRandomBoxes(BoundingBoxSoA& boxes, Vector<AABBox3>& reference, uint32 count)
+{
+    Random* random = Random::Instance();
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Vector3 center(random->RandFloat32InBounds(-200.0f, 200.0f),
+                       random->RandFloat32InBounds(-200.0f, 200.0f),
+                       random->RandFloat32InBounds(-50.0f, 50.0f));
+        Vector3 halfSize(random->RandFloat32InBounds(0.0f, 20.0f),
+                         random->RandFloat32InBounds(0.0f, 20.0f),
+                         random->RandFloat32InBounds(0.0f, 20.0f));
+        AABBox3 box(center - halfSize, center + halfSize);
+        boxes.Add(box);
+        reference.push_back(box);
+    }
+}
+
+bool IsVisible(const Vector<uint32>& mask, uint32 index)
+{
+    return (mask[index / 32] & (1u << (index % 32))) != 0;
+}
+
+// Check mask against Frustum::Classify, padding bits should be cleared
+bool MatchesClassify(const Frustum& frustum, const Vector<AABBox3>& reference, const Vector<uint32>& mask)
+{
+    uint32 count = static_cast<uint32>(reference.size());
+    if (mask.size() != FrustumCulling::GetMaskWordCount(count))
+    {
+        return false;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        bool expected = frustum.Classify(reference[i]) != Frustum::EFR_OUTSIDE;
+        if (IsVisible(mask, i) != expected)
+        {
+            return false;
+        }
+    }
+
+    for (uint32 i = count; i < static_cast<uint32>(mask.size()) * 32; ++i)
+    {
+        if (IsVisible(mask, i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BuildFrustum(Frustum* frustum, const Vector3& position, const Vector3& target, bool ortho)
+{
+    ScopedPtr<Camera> camera(new Camera());
+    if (ortho)
+    {
+        camera->SetupOrtho(300.0f, 1.0f, 1.0f, 500.0f);
+    }
+    else
+    {
+        camera->SetupPerspective(70.0f, 0.75f, 1.0f, 300.0f);
+    }
+    camera->SetUp(Vector3(0.0f, 0.0f, 1.0f));
+    camera->SetPosition(position);
+    camera->SetTarget(target);
+    frustum->Build(camera->GetViewProjMatrix(), false);
+}
+}
+
+DAVA_TESTCLASS (FrustumCullingTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("FrustumCulling.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (AllImplementationsMatchClassify)
+    {
+        using namespace FrustumCullingTestDetails;
+
+        // odd count to have partially filled last mask word
+        const uint32 boxCount = 10007;
+
+        BoundingBoxSoA boxes;
+        Vector<AABBox3> reference;
+        FillRandomBoxes(boxes, reference, boxCount);
+
+        const FrustumCulling::eImplementation implementations[] = {
+            FrustumCulling::eImplementation::SCALAR,
+            FrustumCulling::eImplementation::SSE,
+            FrustumCulling::eImplementation::AVX,
+            FrustumCulling::eImplementation::NEON
+        };
+
+        ScopedPtr<Frustum> frustum(new Frustum());
+        for (uint32 cameraIndex = 0; cameraIndex < 8; ++cameraIndex)
+        {
+            float32 angle = PI_2 * cameraIndex / 8.0f;
+            Vector3 position(150.0f * std::cos(angle), 150.0f * std::sin(angle), 30.0f);
+            BuildFrustum(frustum, position, Vector3(0.0f, 0.0f, 0.0f), (cameraIndex % 2) != 0);
+
+            for (FrustumCulling::eImplementation impl : implementations)
+            {
+                if (!FrustumCulling::IsImplementationAvailable(impl))
+                {
+                    continue;
+                }
+
+                Vector<uint32> mask(FrustumCulling::GetMaskWordCount(boxCount), 0xffffffff);
+                FrustumCulling::CullRange(*frustum, boxes, 0, static_cast<uint32>(mask.size()), mask.data(), impl);
+                TEST_VERIFY(MatchesClassify(*frustum, reference, mask));
+            }
+
+            Vector<uint32> mask;
+            FrustumCulling::Cull(*frustum, boxes, mask);
+            TEST_VERIFY(MatchesClassify(*frustum, reference, mask));
+        }
+    }
+
+    DAVA_TEST (ParallelCullingMatchesClassify)
+    {
+        using namespace FrustumCullingTestDetails;
+
+        const uint32 boxCount = FrustumCulling::PARALLEL_CULLING_THRESHOLD * 4 + 13;
+
+        BoundingBoxSoA boxes;
+        Vector<AABBox3> reference;
+        FillRandomBoxes(boxes, reference, boxCount);
+
+        ScopedPtr<Frustum> frustum(new Frustum());
+        BuildFrustum(frustum, Vector3(-150.0f, -150.0f, 40.0f), Vector3(0.0f, 0.0f, 0.0f), false);
+
+        Vector<uint32> mask;
+        FrustumCulling::Cull(*frustum, boxes, mask);
+        TEST_VERIFY(MatchesClassify(*frustum, reference, mask));
+    }
+
+    DAVA_TEST (BoxStorageTest)
+    {
+        using namespace FrustumCullingTestDetails;
+
+        BoundingBoxSoA boxes;
+        Vector<AABBox3> reference;
+        FillRandomBoxes(boxes, reference, 100);
+
+        // remove the same ways owners remove objects: move last into removed slot or keep order
+        for (uint32 index : { 0u, 50u, 97u })
+        {
+            boxes.RemoveBySwapWithLast(index);
+            reference[index] = reference.back();
+            reference.pop_back();
+        }
+        for (uint32 index : { 3u, 40u, 93u })
+        {
+            boxes.Remove(index);
+            reference.erase(reference.begin() + index);
+        }
+
+        AABBox3 updated(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f));
+        boxes.Set(10, updated);
+        reference[10] = updated;
+
+        TEST_VERIFY(boxes.GetSize() == reference.size());
+        for (uint32 i = 0; i < boxes.GetSize(); ++i)
+        {
+            AABBox3 box = boxes.Get(i);
+            TEST_VERIFY(box.min == reference[i].min && box.max == reference[i].max);
+        }
+
+        ScopedPtr<Frustum> frustum(new Frustum());
+        BuildFrustum(frustum, Vector3(0.0f, -100.0f, 0.0f), Vector3(0.0f, 0.0f, 0.0f), false);
+
+        Vector<uint32> mask;
+        FrustumCulling::Cull(*frustum, boxes, mask);
+        TEST_VERIFY(MatchesClassify(*frustum, reference, mask));
+
+        boxes.Clear();
+        FrustumCulling::Cull(*frustum, boxes, mask);
+        TEST_VERIFY(boxes.GetSize() == 0 && mask.empty());
+    }
+};
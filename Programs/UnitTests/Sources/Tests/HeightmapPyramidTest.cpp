@@ -0,0 +1,191 @@
+#include "DAVAEngine.h"
+#include "UnitTests/UnitTests.h"
+
+#include "Math/MathConstants.h"
+#include "Render/Highlevel/Heightmap.h"
+#include "Render/Highlevel/HeightmapPyramid.h"
+
+#include <cmath>
+
+using namespace DAVA;
+
+namespace HeightmapPyramidTestDetails
+{
+const uint32 RAYS_COUNT = 1000;
+
+float32 RandomFloat(uint32& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float32>(state >> 8) / static_cast<float32>(1 << 24);
+}
+
+void FillHeights(Heightmap* heightmap, const Rect2i& rect, float32 phase, uint32& state)
+{
+    int32 size = heightmap->Size();
+    for (int32 y = rect.y; y < rect.y + rect.dy; ++y)
+    {
+        for (int32 x = rect.x; x < rect.x + rect.dx; ++x)
+        {
+            float32 hills = 0.5f + 0.3f * std::sin(x * 0.1f + phase) * std::cos(y * 0.07f) + 0.1f * RandomFloat(state);
+            heightmap->Data()[y * size + x] = static_cast<uint16>(hills * Heightmap::MAX_VALUE);
+        }
+    }
+}
+
+// Test every quad of heightmap, reference for pyramid traversal
+bool BruteForceRayCast(const Heightmap* heightmap, const AABBox3& bbox, const Ray3& ray, float32& resultT)
+{
+    float32 closestT = FLOAT_MAX;
+    uint16 size = static_cast<uint16>(heightmap->Size());
+    for (uint16 y = 0; y < size; ++y)
+    {
+        for (uint16 x = 0; x < size; ++x)
+        {
+            Vector3 p00 = heightmap->GetPoint(x, y, bbox);
+            Vector3 p01 = heightmap->GetPoint(x, y + 1, bbox);
+            Vector3 p10 = heightmap->GetPoint(x + 1, y, bbox);
+            Vector3 p11 = heightmap->GetPoint(x + 1, y + 1, bbox);
+
+            float32 t = 0.f;
+            if (Intersection::RayTriangle(ray, p00, p01, p11, t, 0.f, closestT))
+                closestT = t;
+            if (Intersection::RayTriangle(ray, p00, p11, p10, t, 0.f, closestT))
+                closestT = t;
+        }
+    }
+
+    resultT = closestT;
+    return closestT < FLOAT_MAX;
+}
+
+// Vertical, grazing and random rays from inside and outside of landscape box
+Vector<Ray3> CreateRays(const AABBox3& bbox)
+{
+    Vector<Ray3> rays;
+    uint32 state = 3;
+    Vector3 size = bbox.GetSize();
+    for (uint32 i = 0; i < RAYS_COUNT; ++i)
+    {
+        Vector3 origin(bbox.min.x + size.x * (RandomFloat(state) * 1.2f - 0.1f), bbox.min.y + size.y * (RandomFloat(state) * 1.2f - 0.1f), bbox.min.z + size.z * RandomFloat(state) * 1.5f);
+        Vector3 direction;
+        switch (i % 3)
+        {
+        case 0:
+            direction = Vector3(0.f, 0.f, -1.f);
+            break;
+        case 1:
+            direction = Vector3(RandomFloat(state) - 0.5f, RandomFloat(state) - 0.5f, -0.05f * RandomFloat(state));
+            break;
+        default:
+            direction = Vector3(RandomFloat(state) - 0.5f, RandomFloat(state) - 0.5f, RandomFloat(state) - 0.5f);
+            break;
+        }
+        rays.emplace_back(origin, direction);
+    }
+    return rays;
+}
+
+bool IsSameT(float32 expected, float32 actual)
+{
+    return (expected == actual) || (std::abs(expected - actual) <= 1e-3f * Max(1.f, expected));
+}
+
+uint32 CountMismatches(const HeightmapPyramid& pyramid, const Heightmap* heightmap, const AABBox3& bbox)
+{
+    uint32 mismatches = 0;
+    for (const Ray3& ray : CreateRays(bbox))
+    {
+        float32 expectedT = FLOAT_MAX;
+        float32 actualT = FLOAT_MAX;
+        bool expectedHit = BruteForceRayCast(heightmap, bbox, ray, expectedT);
+        bool actualHit = pyramid.RayCast(ray, actualT);
+        if (expectedHit != actualHit || !IsSameT(expectedT, actualT))
+            ++mismatches;
+    }
+    return mismatches;
+}
+}
+
+DAVA_TESTCLASS (HeightmapPyramidTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("HeightmapPyramid.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (RayCastTest)
+    {
+        using namespace HeightmapPyramidTestDetails;
+
+        // not power of two size makes border nodes partial
+        const int32 sizes[] = { 64, 61 };
+        for (int32 size : sizes)
+        {
+            uint32 state = 1;
+            ScopedPtr<Heightmap> heightmap(new Heightmap(size));
+            FillHeights(heightmap, Rect2i(0, 0, size, size), 0.f, state);
+            AABBox3 bbox(Vector3(-500.f, -400.f, 10.f), Vector3(500.f, 600.f, 110.f));
+
+            HeightmapPyramid pyramid;
+            pyramid.Build(heightmap, bbox);
+            TEST_VERIFY(CountMismatches(pyramid, heightmap, bbox) == 0);
+
+            // partial update gives the same results as if pyramid was built over changed heightmap
+            Rect2i changedRect(10, 5, 20, 12);
+            FillHeights(heightmap, changedRect, 1.f, state);
+            pyramid.Update(changedRect);
+            TEST_VERIFY(CountMismatches(pyramid, heightmap, bbox) == 0);
+        }
+    }
+
+    DAVA_TEST (BatchRayCastTest)
+    {
+        using namespace HeightmapPyramidTestDetails;
+
+        uint32 state = 1;
+        ScopedPtr<Heightmap> heightmap(new Heightmap(128));
+        FillHeights(heightmap, Rect2i(0, 0, 128, 128), 0.f, state);
+        AABBox3 bbox(Vector3(-100.f, -100.f, 0.f), Vector3(100.f, 100.f, 30.f));
+
+        HeightmapPyramid pyramid;
+        pyramid.Build(heightmap, bbox);
+
+        // batch is large enough to be cast on job workers
+        Vector<Ray3> rays = CreateRays(bbox);
+        Vector<float32> serialResults(rays.size());
+        Vector<float32> parallelResults(rays.size());
+        uint32 serialHits = pyramid.RayCast(rays.data(), uint32(rays.size()), serialResults.data(), false);
+        uint32 parallelHits = pyramid.RayCast(rays.data(), uint32(rays.size()), parallelResults.data(), true);
+        TEST_VERIFY(serialHits > 0 && serialHits < uint32(rays.size()));
+        TEST_VERIFY(serialHits == parallelHits);
+        TEST_VERIFY(serialResults == parallelResults);
+    }
+
+    DAVA_TEST (HeightAtPointTest)
+    {
+        using namespace HeightmapPyramidTestDetails;
+
+        uint32 state = 1;
+        ScopedPtr<Heightmap> heightmap(new Heightmap(64));
+        FillHeights(heightmap, Rect2i(0, 0, 64, 64), 0.f, state);
+        AABBox3 bbox(Vector3(-32.f, -32.f, 0.f), Vector3(32.f, 32.f, 50.f));
+
+        HeightmapPyramid pyramid;
+        pyramid.Build(heightmap, bbox);
+
+        // heights at points of heightmap are exact, vertical ray hits surface at the same height
+        float32 height = 0.f;
+        Vector3 point = heightmap->GetPoint(10, 20, bbox);
+        TEST_VERIFY(pyramid.GetHeightAtPoint(point, height));
+        TEST_VERIFY(std::abs(height - point.z) < 1e-3f);
+
+        Vector3 between(point.x + 0.3f, point.y + 0.6f, 0.f);
+        TEST_VERIFY(pyramid.GetHeightAtPoint(between, height));
+        float32 t = 0.f;
+        TEST_VERIFY(pyramid.RayCast(Ray3(Vector3(between.x, between.y, 100.f), Vector3(0.f, 0.f, -1.f)), t));
+        TEST_VERIFY(height >= bbox.min.z && height <= bbox.max.z);
+
+        TEST_VERIFY(pyramid.GetHeightAtPoint(bbox.max, height));
+        TEST_VERIFY(!pyramid.GetHeightAtPoint(Vector3(bbox.max.x + 1.f, 0.f, 0.f), height));
+    }
+};
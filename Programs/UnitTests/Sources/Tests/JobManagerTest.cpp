@@ -83,8 +83,115 @@ DAVA_TESTCLASS (JobManagerTest)
 
     DAVA_TEST (TestWorkerJobs)
     {
-        // TODO:
-        // ...
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        // more jobs than old fixed-size queue could hold
+        const uint32 jobsCount = 4096;
+        std::atomic<uint32> executed(0);
+        for (uint32 i = 0; i < jobsCount; ++i)
+        {
+            jobManager->CreateWorkerJob([&executed]() { executed++; });
+        }
+        jobManager->WaitWorkerJobs();
+
+        TEST_VERIFY(executed == jobsCount);
+        TEST_VERIFY(!jobManager->HasWorkerJobs());
+    }
+
+    DAVA_TEST (TestWorkerJobDependencies)
+    {
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        const uint32 chainLength = 100;
+        Vector<uint32> order;
+        JobHandle previous;
+        for (uint32 i = 0; i < chainLength; ++i)
+        {
+            // every job pushes its index only after previous one, so result should be sorted
+            previous = jobManager->CreateWorkerJob([&order, i]() { order.push_back(i); }, previous);
+        }
+        jobManager->WaitWorkerJob(previous);
+
+        TEST_VERIFY(previous.IsFinished());
+        TEST_VERIFY(order.size() == chainLength);
+        for (uint32 i = 0; i < order.size(); ++i)
+        {
+            TEST_VERIFY(order[i] == i);
+        }
+
+        // join job waits for several independent jobs
+        std::atomic<uint32> sum(0);
+        Vector<JobHandle> parts;
+        for (uint32 i = 1; i <= 10; ++i)
+        {
+            parts.push_back(jobManager->CreateWorkerJob([&sum, i]() { sum += i; }));
+        }
+        uint32 joinedSum = 0;
+        JobHandle join = jobManager->CreateWorkerJob([&sum, &joinedSum]() { joinedSum = sum; }, parts);
+        jobManager->WaitWorkerJob(join);
+
+        TEST_VERIFY(joinedSum == 55);
+    }
+
+    DAVA_TEST (TestWorkerJobChildren)
+    {
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        std::atomic<uint32> childrenExecuted(0);
+        JobHandle parent;
+        Mutex parentMutex;
+        {
+            LockGuard<Mutex> guard(parentMutex);
+            parent = jobManager->CreateWorkerJob([jobManager, &parent, &parentMutex, &childrenExecuted]() {
+                LockGuard<Mutex> guard(parentMutex);
+                for (uint32 i = 0; i < 64; ++i)
+                {
+                    jobManager->CreateChildWorkerJob(parent, [&childrenExecuted]() {
+                        Thread::Sleep(1);
+                        childrenExecuted++;
+                    });
+                }
+            });
+        }
+
+        bool continuationSawChildren = false;
+        JobHandle continuation = jobManager->CreateWorkerJob([&childrenExecuted, &continuationSawChildren]() {
+            continuationSawChildren = (childrenExecuted == 64);
+        },
+                                                             parent);
+
+        jobManager->WaitWorkerJob(parent);
+        TEST_VERIFY(childrenExecuted == 64);
+
+        jobManager->WaitWorkerJob(continuation);
+        TEST_VERIFY(continuationSawChildren);
+    }
+
+    DAVA_TEST (TestParallelFor)
+    {
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        const uint32 count = 100000;
+        Vector<uint32> values(count, 0);
+        jobManager->ParallelFor(0, count, 1000, [&values](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                values[i] += i;
+            }
+        });
+
+        bool allVisitedOnce = true;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            allVisitedOnce = allVisitedOnce && (values[i] == i);
+        }
+        TEST_VERIFY(allVisitedOnce);
+
+        // empty range and range smaller than grain
+        uint32 calls = 0;
+        jobManager->ParallelFor(10, 10, 1, [&calls](uint32, uint32) { calls++; });
+        jobManager->ParallelFor(0, 5, 100, [&calls](uint32 begin, uint32 end) { calls += (begin == 0 && end == 5) ? 1 : 100; });
+        TEST_VERIFY(calls == 1);
     }
 
     void ThreadFunc(JobManagerTestData * data)
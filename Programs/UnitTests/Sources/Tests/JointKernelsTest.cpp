@@ -0,0 +1,111 @@
+#include "DAVAEngine.h"
+#include "UnitTests/UnitTests.h"
+
+#include "Scene3D/SkeletonAnimation/JointKernels.h"
+#include "Scene3D/SkeletonAnimation/JointTransformStreams.h"
+
+#include <cstring>
+
+using namespace DAVA;
+
+namespace JointKernelsTestDetails
+{
+const uint32 JOINTS_COUNT = 103; // not a multiple of 4 to cover scalar tail
+
+float32 RandomFloat(uint32& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float32>(state >> 8) / static_cast<float32>(1 << 24) * 2.f - 1.f;
+}
+
+Quaternion RandomOrientation(uint32& state)
+{
+    Quaternion q(RandomFloat(state), RandomFloat(state), RandomFloat(state), RandomFloat(state));
+    q.Normalize();
+    return q;
+}
+
+bool IsBitwiseEqual(const JointTransformStreams& streams, uint32 index, const JointTransform& transform)
+{
+    Vector3 position = streams.GetPosition(index);
+    Vector4 orientation = streams.GetOrientation(index);
+    float32 scale = streams.GetScale(index);
+    float32 expectedScale = transform.GetScale();
+    return std::memcmp(&position, &transform.GetPosition(), sizeof(Vector3)) == 0
+    && std::memcmp(&orientation, transform.GetOrientation().data, sizeof(Vector4)) == 0
+    && std::memcmp(&scale, &expectedScale, sizeof(float32)) == 0
+    && (streams.orientationMask[index] != 0) == transform.HasOrientation();
+}
+}
+
+DAVA_TESTCLASS (JointKernelsTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("JointKernels.cpp")
+    DECLARE_COVERED_FILES("JointTransformStreams.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (AppendTransformsTest)
+    {
+        using namespace JointKernelsTestDetails;
+
+        // transforms with every combination of missing position, orientation and scale
+        uint32 state = 42;
+        Vector<JointTransform> first(JOINTS_COUNT);
+        Vector<JointTransform> second(JOINTS_COUNT);
+        JointTransformStreams firstStreams;
+        JointTransformStreams secondStreams;
+        firstStreams.Resize(JOINTS_COUNT);
+        secondStreams.Resize(JOINTS_COUNT);
+        for (uint32 i = 0; i < JOINTS_COUNT; ++i)
+        {
+            if (i % 5 != 0)
+                first[i].SetPosition(Vector3(RandomFloat(state), RandomFloat(state), RandomFloat(state)));
+            if (i % 3 != 0)
+                first[i].SetOrientation(RandomOrientation(state));
+            if (i % 7 != 0)
+                first[i].SetScale(RandomFloat(state) + 2.f);
+
+            second[i].SetPosition(Vector3(RandomFloat(state), RandomFloat(state), RandomFloat(state)));
+            if (i % 11 != 0)
+                second[i].SetOrientation(RandomOrientation(state));
+            second[i].SetScale(RandomFloat(state) + 2.f);
+
+            firstStreams.Set(i, first[i]);
+            secondStreams.Set(i, second[i]);
+        }
+
+        const JointKernels::eImplementation implementations[] = {
+            JointKernels::eImplementation::SCALAR,
+            JointKernels::eImplementation::SSE,
+            JointKernels::eImplementation::NEON
+        };
+        for (JointKernels::eImplementation implementation : implementations)
+        {
+            if (!JointKernels::IsImplementationAvailable(implementation))
+            {
+                continue;
+            }
+
+            // odd begin makes SIMD loop start unaligned
+            const uint32 begin = 1;
+            JointTransformStreams result;
+            result.Resize(JOINTS_COUNT);
+            JointKernels::AppendTransforms(firstStreams, secondStreams, result, begin, JOINTS_COUNT, implementation);
+
+            uint32 mismatches = 0;
+            for (uint32 i = begin; i < JOINTS_COUNT; ++i)
+            {
+                if (!IsBitwiseEqual(result, i, first[i].AppendTransform(second[i])))
+                {
+                    ++mismatches;
+                }
+            }
+            TEST_VERIFY(mismatches == 0);
+
+            // joints before begin are left untouched
+            TEST_VERIFY(result.GetPosition(0) == Vector3::Zero);
+        }
+    }
+};
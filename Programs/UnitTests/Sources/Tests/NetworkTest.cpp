@@ -7,12 +7,51 @@
 #include "Network/NetConfig.h"
 #include "Network/NetService.h"
 #include "Network/NetCore.h"
+#include "Network/Private/ProtoDecoder.h"
 
 #if !defined(DAVA_NETWORK_DISABLE)
 
 using namespace DAVA;
 using namespace DAVA::Net;
 
+namespace NetworkTestDetails
+{
+// Append data frame carrying `size` bytes of packet starting from `offset`, return size of encoded data
+size_t AppendDataFrame(Vector<uint8>& stream, uint32 channelId, uint32 packetId, const uint8* packet, size_t packetSize, size_t offset, size_t size)
+{
+    ProtoDecoder encoder;
+    ProtoHeader header;
+    size_t encoded = Min(encoder.EncodeDataFrame(&header, channelId, packetId, packetSize, offset), size);
+    header.frameSize = static_cast<uint16>(sizeof(ProtoHeader) + encoded);
+
+    const uint8* headerBytes = reinterpret_cast<const uint8*>(&header);
+    stream.insert(stream.end(), headerBytes, headerBytes + sizeof(ProtoHeader));
+    stream.insert(stream.end(), packet + offset, packet + offset + encoded);
+    return encoded;
+}
+
+// Decode whole stream, fill received packets, return last decode status
+ProtoDecoder::eDecodeStatus DecodeStream(ProtoDecoder& decoder, const Vector<uint8>& stream, Vector<std::pair<uint32, Vector<uint8>>>& packets)
+{
+    ProtoDecoder::eDecodeStatus status = ProtoDecoder::DECODE_INCOMPLETE;
+    size_t offset = 0;
+    while (offset < stream.size())
+    {
+        ProtoDecoder::DecodeResult result;
+        status = decoder.Decode(stream.data() + offset, stream.size() - offset, &result);
+        if (ProtoDecoder::DECODE_INVALID == status)
+            break;
+
+        offset += result.decodedSize;
+        if (ProtoDecoder::DECODE_OK == status && TYPE_DATA == result.type)
+        {
+            packets.emplace_back(result.channelId, Vector<uint8>(result.data, result.data + result.dataSize));
+        }
+    }
+    return status;
+}
+}
+
 struct Parcel
 {
     void* outbuf;
@@ -374,6 +413,97 @@ DAVA_TESTCLASS (NetworkTest)
         TEST_VERIFY(3 == config2.Services().size());
     }
 
+    DAVA_TEST (TestProtoDecoder)
+    {
+        using namespace NetworkTestDetails;
+
+        Vector<uint8> packetA(1000);
+        Vector<uint8> packetB(500);
+        for (size_t i = 0; i < packetA.size(); ++i)
+            packetA[i] = static_cast<uint8>(i);
+        for (size_t i = 0; i < packetB.size(); ++i)
+            packetB[i] = static_cast<uint8>(255 - i % 256);
+
+        // frames of packets from two channels are interleaved, the second packet is completed first
+        {
+            Vector<uint8> stream;
+            size_t offsetA = 0;
+            size_t offsetB = 0;
+            while (offsetA < packetA.size() || offsetB < packetB.size())
+            {
+                if (offsetA < packetA.size())
+                    offsetA += AppendDataFrame(stream, 1, 10, packetA.data(), packetA.size(), offsetA, 300);
+                if (offsetB < packetB.size())
+                    offsetB += AppendDataFrame(stream, 2, 20, packetB.data(), packetB.size(), offsetB, 200);
+            }
+
+            ProtoDecoder decoder;
+            decoder.AddChannel(1);
+            decoder.AddChannel(2);
+            Vector<std::pair<uint32, Vector<uint8>>> packets;
+            TEST_VERIFY(DecodeStream(decoder, stream, packets) == ProtoDecoder::DECODE_OK);
+            TEST_VERIFY(packets.size() == 2);
+            if (packets.size() == 2)
+            {
+                TEST_VERIFY(packets[0].first == 2 && packets[0].second == packetB);
+                TEST_VERIFY(packets[1].first == 1 && packets[1].second == packetA);
+            }
+        }
+
+        // data frame of unknown channel
+        {
+            Vector<uint8> stream;
+            AppendDataFrame(stream, 3, 1, packetA.data(), packetA.size(), 0, packetA.size());
+
+            ProtoDecoder decoder;
+            decoder.AddChannel(1);
+            Vector<std::pair<uint32, Vector<uint8>>> packets;
+            TEST_VERIFY(DecodeStream(decoder, stream, packets) == ProtoDecoder::DECODE_INVALID);
+        }
+
+        // total size changes in the middle of packet
+        {
+            Vector<uint8> stream;
+            AppendDataFrame(stream, 1, 1, packetA.data(), packetA.size(), 0, 300);
+            AppendDataFrame(stream, 1, 1, packetA.data(), packetA.size() - 1, 300, 300);
+
+            ProtoDecoder decoder;
+            decoder.AddChannel(1);
+            Vector<std::pair<uint32, Vector<uint8>>> packets;
+            TEST_VERIFY(DecodeStream(decoder, stream, packets) == ProtoDecoder::DECODE_INVALID);
+        }
+
+        // frame of another packet in the middle of packet
+        {
+            Vector<uint8> stream;
+            AppendDataFrame(stream, 1, 1, packetA.data(), packetA.size(), 0, 300);
+            AppendDataFrame(stream, 1, 2, packetA.data(), packetA.size(), 300, 300);
+
+            ProtoDecoder decoder;
+            decoder.AddChannel(1);
+            Vector<std::pair<uint32, Vector<uint8>>> packets;
+            TEST_VERIFY(DecodeStream(decoder, stream, packets) == ProtoDecoder::DECODE_INVALID);
+        }
+
+        // frame data overflows total size
+        {
+            Vector<uint8> stream;
+            AppendDataFrame(stream, 1, 1, packetA.data(), packetA.size(), 0, 900);
+            ProtoHeader header;
+            ProtoDecoder().EncodeDataFrame(&header, 1, 1, packetA.size(), 900);
+            header.frameSize = static_cast<uint16>(sizeof(ProtoHeader) + 200);
+            const uint8* headerBytes = reinterpret_cast<const uint8*>(&header);
+            stream.insert(stream.end(), headerBytes, headerBytes + sizeof(ProtoHeader));
+            stream.insert(stream.end(), packetB.begin(), packetB.begin() + 200);
+
+            ProtoDecoder decoder;
+            decoder.AddChannel(1);
+            Vector<std::pair<uint32, Vector<uint8>>> packets;
+            TEST_VERIFY(DecodeStream(decoder, stream, packets) == ProtoDecoder::DECODE_INVALID);
+            TEST_VERIFY(packets.empty());
+        }
+    }
+
     DAVA_TEST (TestEcho)
     {
         NetCore::Instance()->RegisterService(SERVICE_ECHO, MakeFunction(this, &NetworkTest::CreateEcho), MakeFunction(this, &NetworkTest::DeleteEcho));
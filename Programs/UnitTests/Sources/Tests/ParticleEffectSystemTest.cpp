@@ -0,0 +1,247 @@
+#include "DAVAEngine.h"
+#include "UnitTests/UnitTests.h"
+
+#include "Particles/ParticleEmitter.h"
+#include "Particles/ParticleEmitterInstance.h"
+#include "Particles/ParticleLayer.h"
+#include "Particles/ParticlePool.h"
+#include "Scene3D/Components/ParticleEffectComponent.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Systems/ParticleEffectSystem.h"
+
+using namespace DAVA;
+
+namespace ParticleEffectSystemTestDetails
+{
+const uint32 STRESS_EFFECTS_COUNT = 2000;
+const uint32 FRAMES_COUNT = 60;
+const float32 FRAME_TIME = 1.f / 30.f;
+
+template <class T>
+RefPtr<PropertyLine<T>> MakeValue(const T& value)
+{
+    return RefPtr<PropertyLine<T>>(new PropertyLineValue<T>(value));
+}
+
+// Emitter which particles depend on every kind of randomness: variations, random spin direction,
+// random radius of circle emitter and quasi-random emission angles
+ParticleEmitter* CreateEmitter()
+{
+    ParticleEmitter* emitter = new ParticleEmitter();
+    emitter->emitterType = ParticleEmitter::EMITTER_ONCIRCLE_VOLUME;
+    emitter->radius = MakeValue(2.f);
+    emitter->emissionRange = MakeValue(90.f);
+
+    ScopedPtr<ParticleLayer> layer(new ParticleLayer());
+    layer->isLooped = true;
+    layer->life = MakeValue(1.f);
+    layer->lifeVariation = MakeValue(0.5f);
+    layer->number = MakeValue(40.f);
+    layer->numberVariation = MakeValue(20.f);
+    layer->size = MakeValue(Vector2(1.f, 1.f));
+    layer->sizeVariation = MakeValue(Vector2(0.5f, 0.5f));
+    layer->velocity = MakeValue(3.f);
+    layer->velocityVariation = MakeValue(2.f);
+    layer->spin = MakeValue(45.f);
+    layer->spinVariation = MakeValue(45.f);
+    layer->randomSpinDirection = true;
+
+    RefPtr<PropertyLineKeyframes<float32>> forceOverLife(new PropertyLineKeyframes<float32>());
+    forceOverLife->AddValue(0.f, 0.f);
+    forceOverLife->AddValue(1.f, 1.f);
+    ScopedPtr<ParticleForceSimplified> gravity(new ParticleForceSimplified(MakeValue(Vector3(0.f, 0.f, -9.8f)), forceOverLife));
+    layer->AddSimplifiedForce(gravity);
+
+    emitter->AddLayer(layer);
+    return emitter;
+}
+
+// Emitter which particles run inner emitter, so effects add groups and acquire materials while they are updated
+ParticleEmitter* CreateSuperemitter(ParticleEmitter* innerEmitter)
+{
+    ParticleEmitter* emitter = new ParticleEmitter();
+
+    ScopedPtr<ParticleLayer> layer(new ParticleLayer());
+    layer->type = ParticleLayer::TYPE_SUPEREMITTER_PARTICLES;
+    layer->isLooped = true;
+    layer->life = MakeValue(1.f);
+    layer->number = MakeValue(4.f);
+    layer->velocity = MakeValue(2.f);
+    layer->innerEmitter = new ParticleEmitterInstance(innerEmitter);
+
+    emitter->AddLayer(layer);
+    return emitter;
+}
+
+ParticleEffectComponent* AddEffect(Scene* scene, ParticleEmitter* emitter, const Vector3& position, uint32 seed)
+{
+    ScopedPtr<Entity> entity(new Entity());
+    entity->GetComponent<TransformComponent>()->SetLocalTranslation(position);
+
+    ParticleEffectComponent* effect = new ParticleEffectComponent();
+    effect->SetRandomSeed(seed);
+    effect->AddEmitterInstance(emitter);
+    entity->AddComponent(effect);
+    scene->AddNode(entity);
+
+    effect->Start();
+    return effect;
+}
+
+void Simulate(Scene* scene)
+{
+    for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+    {
+        scene->particleEffectSystem->Process(FRAME_TIME);
+    }
+}
+
+bool IsSameState(ParticleEffectComponent* a, ParticleEffectComponent* b, ParticleLayer* layer)
+{
+    const AABBox3& boxA = a->GetRenderObject()->GetBoundingBox();
+    const AABBox3& boxB = b->GetRenderObject()->GetBoundingBox();
+    return a->GetActiveParticlesCount() == b->GetActiveParticlesCount()
+    && a->GetLayerActiveParticlesSquare(layer) == b->GetLayerActiveParticlesSquare(layer)
+    && boxA.min == boxB.min && boxA.max == boxB.max;
+}
+}
+
+DAVA_TESTCLASS (ParticleEffectSystemTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("ParticleEffectSystem.cpp")
+    DECLARE_COVERED_FILES("ParticlesRandom.cpp")
+    DECLARE_COVERED_FILES("ParticlePool.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (PoolRemoveKeepsOrderTest)
+    {
+        ParticlePool pool;
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            uint32 index = pool.Add();
+            pool.lifeTime[index] = 1.f;
+            pool.particles[index].seed = i;
+        }
+
+        for (uint32 index : { 0u, 3u, 4u, 9u })
+        {
+            pool.Kill(index);
+        }
+        TEST_VERIFY(pool.RemoveDead() == 4);
+        TEST_VERIFY(pool.GetSize() == 6);
+
+        // particles are drawn in emission order, so alive ones mustn't be reordered
+        const uint32 expected[] = { 1, 2, 5, 6, 7, 8 };
+        for (uint32 i = 0; i < pool.GetSize(); ++i)
+        {
+            TEST_VERIFY(pool.particles[i].seed == expected[i]);
+        }
+    }
+
+    DAVA_TEST (RandomSeedTest)
+    {
+        using namespace ParticleEffectSystemTestDetails;
+
+        ScopedPtr<ParticleEmitter> emitter(CreateEmitter());
+        ScopedPtr<Scene> scene(new Scene());
+
+        // effects at the same place with the same seed play identically, other seed gives other particles
+        ParticleEffectComponent* a = AddEffect(scene, emitter, Vector3::Zero, 42);
+        ParticleEffectComponent* b = AddEffect(scene, emitter, Vector3::Zero, 42);
+        ParticleEffectComponent* c = AddEffect(scene, emitter, Vector3::Zero, 43);
+        Simulate(scene);
+
+        ParticleLayer* layer = emitter->layers[0];
+        TEST_VERIFY(a->GetActiveParticlesCount() > 0);
+        TEST_VERIFY(IsSameState(a, b, layer));
+        TEST_VERIFY(!IsSameState(a, c, layer));
+
+        // restarted effect replays the same particles
+        ScopedPtr<Scene> restartScene(new Scene());
+        ParticleEffectComponent* d = AddEffect(restartScene, emitter, Vector3::Zero, 42);
+        Simulate(restartScene);
+        d->Stop();
+        d->Start();
+        Simulate(restartScene);
+        TEST_VERIFY(IsSameState(a, d, layer));
+    }
+
+    DAVA_TEST (ParallelUpdateStressTest)
+    {
+        using namespace ParticleEffectSystemTestDetails;
+
+        ScopedPtr<ParticleEmitter> emitter(CreateEmitter());
+        ScopedPtr<Scene> serialScene(new Scene());
+        ScopedPtr<Scene> parallelScene(new Scene());
+        serialScene->particleEffectSystem->SetParallelUpdate(false);
+        parallelScene->particleEffectSystem->SetParallelUpdate(true);
+
+        // thousands of effects sharing one emitter, so property lines and layers are read from many threads at once
+        Vector<ParticleEffectComponent*> serialEffects;
+        Vector<ParticleEffectComponent*> parallelEffects;
+        for (uint32 i = 0; i < STRESS_EFFECTS_COUNT; ++i)
+        {
+            Vector3 position(float32(i % 50) * 5.f, float32(i / 50) * 5.f, 0.f);
+            serialEffects.push_back(AddEffect(serialScene, emitter, position, i));
+            parallelEffects.push_back(AddEffect(parallelScene, emitter, position, i));
+        }
+
+        Simulate(serialScene);
+        Simulate(parallelScene);
+
+        ParticleLayer* layer = emitter->layers[0];
+        uint32 mismatchedEffects = 0;
+        uint32 particlesCount = 0;
+        for (uint32 i = 0; i < STRESS_EFFECTS_COUNT; ++i)
+        {
+            if (!IsSameState(serialEffects[i], parallelEffects[i], layer))
+            {
+                ++mismatchedEffects;
+            }
+            particlesCount += parallelEffects[i]->GetActiveParticlesCount();
+        }
+        TEST_VERIFY(mismatchedEffects == 0);
+        TEST_VERIFY(particlesCount > STRESS_EFFECTS_COUNT);
+    }
+
+    DAVA_TEST (ParallelSuperemitterTest)
+    {
+        using namespace ParticleEffectSystemTestDetails;
+
+        ScopedPtr<ParticleEmitter> innerEmitter(CreateEmitter());
+        ScopedPtr<ParticleEmitter> emitter(CreateSuperemitter(innerEmitter));
+        ScopedPtr<Scene> serialScene(new Scene());
+        ScopedPtr<Scene> parallelScene(new Scene());
+        serialScene->particleEffectSystem->SetParallelUpdate(false);
+        parallelScene->particleEffectSystem->SetParallelUpdate(true);
+
+        Vector<ParticleEffectComponent*> serialEffects;
+        Vector<ParticleEffectComponent*> parallelEffects;
+        for (uint32 i = 0; i < STRESS_EFFECTS_COUNT / 10; ++i)
+        {
+            Vector3 position(float32(i % 20) * 5.f, float32(i / 20) * 5.f, 0.f);
+            serialEffects.push_back(AddEffect(serialScene, emitter, position, i));
+            parallelEffects.push_back(AddEffect(parallelScene, emitter, position, i));
+        }
+
+        Simulate(serialScene);
+        Simulate(parallelScene);
+
+        // inner emitters are started after update in order of generated particles, whatever thread updated the effect
+        ParticleLayer* innerLayer = innerEmitter->layers[0];
+        uint32 mismatchedEffects = 0;
+        float32 innerParticlesSquare = 0.f;
+        for (size_t i = 0; i < serialEffects.size(); ++i)
+        {
+            if (!IsSameState(serialEffects[i], parallelEffects[i], innerLayer))
+            {
+                ++mismatchedEffects;
+            }
+            innerParticlesSquare += parallelEffects[i]->GetLayerActiveParticlesSquare(innerLayer);
+        }
+        TEST_VERIFY(mismatchedEffects == 0);
+        TEST_VERIFY(innerParticlesSquare > 0.f);
+    }
+};
@@ -0,0 +1,109 @@
+#include "DAVAEngine.h"
+#include "UnitTests/UnitTests.h"
+
+#include "Particles/ParticlePropertyLine.h"
+
+using namespace DAVA;
+
+namespace ParticlePropertyLineTestDetails
+{
+const uint32 SAMPLES_COUNT = 1000;
+
+RefPtr<PropertyLineKeyframes<float32>> MakeKeyframes()
+{
+    RefPtr<PropertyLineKeyframes<float32>> line(new PropertyLineKeyframes<float32>());
+    line->AddValue(0.1f, 0.f);
+    line->AddValue(0.33f, 1.f);
+    line->AddValue(0.4f, 0.25f);
+    line->AddValue(0.77f, 0.9f);
+    line->AddValue(0.9f, 0.5f);
+    return line;
+}
+
+float32 MaxError(PropertyLineKeyframes<float32>* line)
+{
+    float32 error = 0.f;
+    for (uint32 i = 0; i <= SAMPLES_COUNT; ++i)
+    {
+        float32 t = float32(i) / float32(SAMPLES_COUNT);
+        error = Max(error, Abs(line->GetValue(t) - line->GetKeyframesValue(t)));
+    }
+    return error;
+}
+}
+
+DAVA_TESTCLASS (ParticlePropertyLineTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("ParticlePropertyLine.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (BakeToleranceTest)
+    {
+        using namespace ParticlePropertyLineTestDetails;
+
+        const float32 tolerances[] = { 0.1f, 0.01f, 0.001f };
+        for (float32 tolerance : tolerances)
+        {
+            RefPtr<PropertyLineKeyframes<float32>> line = MakeKeyframes();
+            TEST_VERIFY(line->Bake(tolerance));
+            TEST_VERIFY(line->IsBaked());
+            TEST_VERIFY(MaxError(line.Get()) <= tolerance + 1e-6f);
+
+            // values out of keys range are clamped as for keyframes
+            TEST_VERIFY(line->GetValue(0.f) == 0.f);
+            TEST_VERIFY(line->GetValue(1.f) == 0.5f);
+        }
+
+        // tolerance which can't be reached with the largest table leaves the line not baked
+        RefPtr<PropertyLineKeyframes<float32>> line = MakeKeyframes();
+        TEST_VERIFY(!line->Bake(0.f, 2, 4));
+        TEST_VERIFY(!line->IsBaked());
+
+        // adding a key drops the table
+        TEST_VERIFY(line->Bake(0.01f));
+        line->AddValue(1.f, 0.f);
+        TEST_VERIFY(!line->IsBaked());
+    }
+
+    DAVA_TEST (GetValuesTest)
+    {
+        using namespace ParticlePropertyLineTestDetails;
+
+        Vector<float32> t(SAMPLES_COUNT);
+        for (uint32 i = 0; i < SAMPLES_COUNT; ++i)
+        {
+            t[i] = float32((i * 7919) % SAMPLES_COUNT) / float32(SAMPLES_COUNT);
+        }
+
+        RefPtr<PropertyLineKeyframes<float32>> keyframes = MakeKeyframes();
+        for (bool bake : { false, true })
+        {
+            if (bake)
+            {
+                keyframes->Bake(0.001f);
+            }
+
+            Vector<float32> values(SAMPLES_COUNT);
+            PropertyLine<float32>* line = keyframes.Get();
+            line->GetValues(t.data(), values.data(), SAMPLES_COUNT);
+            for (uint32 i = 0; i < SAMPLES_COUNT; ++i)
+            {
+                TEST_VERIFY(values[i] == line->GetValue(t[i]));
+            }
+        }
+
+        RefPtr<PropertyLine<float32>> modifiable(keyframes->Clone());
+        PropertyLineHelper::MakeModifiable(modifiable);
+        static_cast<ModifiablePropertyLine<float32>*>(modifiable.Get())->SetModificationLine(RefPtr<PropertyLine<float32>>(new PropertyLineValue<float32>(2.f)));
+        static_cast<ModifiablePropertyLine<float32>*>(modifiable.Get())->SetModifier(0.f);
+
+        Vector<float32> values(SAMPLES_COUNT);
+        modifiable->GetValues(t.data(), values.data(), SAMPLES_COUNT);
+        for (uint32 i = 0; i < SAMPLES_COUNT; ++i)
+        {
+            TEST_VERIFY(values[i] == 2.f * keyframes->GetValue(t[i]));
+        }
+    }
+};
@@ -0,0 +1,213 @@
+#include "UnitTests/UnitTests.h"
+#include "Base/ScopedPtr.h"
+#include "Render/Highlevel/Camera.h"
+#include "Render/Highlevel/RenderBatch.h"
+#include "Render/Highlevel/RenderBatchArray.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Render/Material/NMaterial.h"
+#include "Utils/Random.h"
+
+#include <algorithm>
+
+using namespace DAVA;
+
+namespace RenderBatchArrayTestDetails
+{
+const uint32 BATCH_COUNT = 2000;
+const uint32 BATCHES_PER_OBJECT = 3;
+const uint32 PARENT_MATERIALS_COUNT = 8;
+const uint32 MAX_BATCH_SORTING_KEY = 15;
+const uint32 FRAMES_COUNT = 5;
+
+class BatchSet
+{
+public:
+    BatchSet()
+    {
+        Random* random = Random::Instance();
+
+        for (uint32 i = 0; i < PARENT_MATERIALS_COUNT; ++i)
+        {
+            parents.push_back(new NMaterial());
+        }
+
+        uint32 objectCount = (BATCH_COUNT + BATCHES_PER_OBJECT - 1) / BATCHES_PER_OBJECT;
+        matrices.resize(objectCount);
+        for (uint32 i = 0; i < objectCount; ++i)
+        {
+            // Few objects share position, so batches with equal keys are present
+            Vector3 position(static_cast<float32>(random->Rand(200)) - 100.0f, static_cast<float32>(random->Rand(200)) - 100.0f, 0.0f);
+            matrices[i] = Matrix4::MakeTranslation(position);
+
+            RenderObject* object = new RenderObject();
+            object->SetWorldMatrixPtr(&matrices[i]);
+            object->SetWorldAABBox(AABBox3(position, 1.0f));
+            objects.push_back(object);
+        }
+
+        for (uint32 i = 0; i < BATCH_COUNT; ++i)
+        {
+            NMaterial* material = new NMaterial();
+            material->SetParent(parents[random->Rand(PARENT_MATERIALS_COUNT - 1)]);
+
+            RenderBatch* batch = new RenderBatch();
+            batch->SetMaterial(material);
+            batch->SetRenderObject(objects[i / BATCHES_PER_OBJECT]);
+            batch->SetSortingKey(random->Rand(MAX_BATCH_SORTING_KEY));
+            batches.push_back(batch);
+
+            SafeRelease(material);
+        }
+    }
+
+    ~BatchSet()
+    {
+        for (RenderBatch* batch : batches)
+        {
+            SafeRelease(batch);
+        }
+        for (RenderObject* object : objects)
+        {
+            SafeRelease(object);
+        }
+        for (NMaterial* parent : parents)
+        {
+            SafeRelease(parent);
+        }
+    }
+
+    Vector<RenderBatch*> batches;
+
+private:
+    Vector<NMaterial*> parents;
+    Vector<RenderObject*> objects;
+    Vector<Matrix4> matrices;
+};
+
+/**
+    Sorting as it was done before packed keys: key is written to batch and batches are compared through pointers.
+    std::stable_sort is used for every mode, former std::sort for material and front-to-back modes
+    gave the same key order but any order of batches with equal keys.
+*/
+void LegacySort(Vector<RenderBatch*>& batches, Camera* camera, uint32 sortFlags)
+{
+    Vector3 cameraPosition = camera->GetPosition();
+    Vector3 cameraDirection = camera->GetDirection();
+
+    for (RenderBatch* batch : batches)
+    {
+        if (sortFlags & RenderBatchArray::SORT_BY_MATERIAL)
+        {
+            uint32 materialIndex = batch->GetMaterial()->GetSortingKey();
+            batch->layerSortingKey = static_cast<pointer_size>((materialIndex & 0x0FFFFFFF) | (batch->GetSortingKey() << 28));
+        }
+        else if (sortFlags & RenderBatchArray::SORT_BY_DISTANCE_BACK_TO_FRONT)
+        {
+            Vector3 delta = batch->GetRenderObject()->GetWorldMatrixPtr()->GetTranslationVector() - cameraPosition;
+            uint32 distance = delta.DotProduct(cameraDirection) < 0 ? 0 : (static_cast<uint32>(delta.Length() * 1000.0f));
+            distance = distance + 31 - batch->GetSortingOffset();
+            batch->layerSortingKey = (distance & 0x0fffffff) | (batch->GetSortingKey() << 28);
+        }
+        else
+        {
+            Vector3 position = batch->GetRenderObject()->GetWorldBoundingBox().GetCenter();
+            uint32 distance = static_cast<uint32>((position - cameraPosition).Length() * 100.0f) + 31 - batch->GetSortingOffset();
+            uint32 distanceBits = (0x0fffffff - distance) & 0x0fffffff;
+            batch->layerSortingKey = distanceBits | (batch->GetSortingKey() << 28);
+        }
+    }
+
+    std::stable_sort(batches.begin(), batches.end(), [](const RenderBatch* a, const RenderBatch* b) {
+        return a->layerSortingKey > b->layerSortingKey;
+    });
+}
+
+bool IsSortedAsLegacy(RenderBatchArray& batchArray, const Vector<RenderBatch*>& input, Camera* camera, uint32 sortFlags)
+{
+    batchArray.Clear();
+    for (RenderBatch* batch : input)
+    {
+        batchArray.AddRenderBatch(batch);
+    }
+    batchArray.Sort(camera);
+
+    Vector<RenderBatch*> expected(input);
+    LegacySort(expected, camera, sortFlags);
+
+    if (batchArray.GetRenderBatchCount() != static_cast<uint32>(expected.size()))
+    {
+        return false;
+    }
+    for (uint32 i = 0; i < batchArray.GetRenderBatchCount(); ++i)
+    {
+        if (batchArray.Get(i) != expected[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Camera moves a little every frame and batches come in the same order (previous order is reused),
+// then in shuffled order (full sort)
+bool CheckSortMode(const BatchSet& batchSet, uint32 sortFlags)
+{
+    ScopedPtr<Camera> camera(new Camera());
+    camera->SetUp(Vector3(0.0f, 0.0f, 1.0f));
+    camera->SetDirection(Vector3(1.0f, 0.0f, 0.0f));
+
+    RenderBatchArray batchArray;
+    batchArray.SetSortingFlags(RenderBatchArray::SORT_ENABLED | sortFlags);
+
+    Vector<RenderBatch*> input(batchSet.batches);
+    for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+    {
+        camera->SetPosition(Vector3(frame * 0.5f, frame * 0.25f, 10.0f));
+        if (!IsSortedAsLegacy(batchArray, input, camera, sortFlags))
+        {
+            return false;
+        }
+    }
+
+    // Big camera jump breaks coherence of the previous order
+    camera->SetPosition(Vector3(-150.0f, 150.0f, 10.0f));
+    camera->SetDirection(Vector3(0.0f, -1.0f, 0.0f));
+    if (!IsSortedAsLegacy(batchArray, input, camera, sortFlags))
+    {
+        return false;
+    }
+
+    Random* random = Random::Instance();
+    for (uint32 i = static_cast<uint32>(input.size()) - 1; i > 0; --i)
+    {
+        std::swap(input[i], input[random->Rand(i)]);
+    }
+    return IsSortedAsLegacy(batchArray, input, camera, sortFlags);
+}
+}
+
+DAVA_TESTCLASS (RenderBatchArrayTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("RenderBatchArray.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (SortByMaterialTest)
+    {
+        RenderBatchArrayTestDetails::BatchSet batchSet;
+        TEST_VERIFY(RenderBatchArrayTestDetails::CheckSortMode(batchSet, RenderBatchArray::SORT_BY_MATERIAL));
+    }
+
+    DAVA_TEST (SortBackToFrontTest)
+    {
+        RenderBatchArrayTestDetails::BatchSet batchSet;
+        TEST_VERIFY(RenderBatchArrayTestDetails::CheckSortMode(batchSet, RenderBatchArray::SORT_BY_DISTANCE_BACK_TO_FRONT));
+    }
+
+    DAVA_TEST (SortFrontToBackTest)
+    {
+        RenderBatchArrayTestDetails::BatchSet batchSet;
+        TEST_VERIFY(RenderBatchArrayTestDetails::CheckSortMode(batchSet, RenderBatchArray::SORT_BY_DISTANCE_FRONT_TO_BACK));
+    }
+};
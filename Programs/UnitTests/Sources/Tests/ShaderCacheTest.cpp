@@ -0,0 +1,133 @@
+#include "DAVAEngine.h"
+#include "UnitTests/UnitTests.h"
+#include "Render/ShaderCache.h"
+#include "Render/RHI/rhi_ShaderSource.h"
+
+using namespace DAVA;
+
+namespace ShaderCacheTestDetails
+{
+const char* VERTEX_PROGRAM =
+"vertex_in\n"
+"{\n"
+"    float3 pos   : POSITION;\n"
+"    float4 color : COLOR;\n"
+"};\n"
+"vertex_out\n"
+"{\n"
+"    float4 pos   : SV_POSITION;\n"
+"    float4 color : COLOR;\n"
+"};\n"
+"\n"
+"[unique][dynamic] property float4x4   XForm;\n"
+"\n"
+"vertex_out\n"
+"vp_main( vertex_in input )\n"
+"{\n"
+"    vertex_out output;\n"
+"    output.pos   = mul( float4(input.pos.xyz,1.0), XForm );\n"
+"#if DOUBLE_COLOR\n"
+"    output.color = float4(input.color) * 2.0;\n"
+"#else\n"
+"    output.color = float4(input.color);\n"
+"#endif\n"
+"    return output;\n"
+"}\n";
+
+const char* STORAGE_DIRECTORY = "~doc:/ShaderCacheTest/";
+const char* ENGINE_STORAGE_DIRECTORY = "~doc:/ShaderSourceCache/";
+
+uint32 SourceHash(const char* text)
+{
+    return HashValue_N(text, static_cast<uint32>(strlen(text)));
+}
+}
+
+DAVA_TESTCLASS (ShaderCacheTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("rhi_ShaderSource.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    DAVA_TEST (StorageTest)
+    {
+        using namespace ShaderCacheTestDetails;
+
+        FileSystem* fileSystem = GetEngineContext()->fileSystem;
+        fileSystem->DeleteDirectory(STORAGE_DIRECTORY);
+
+        // sources stored by other format versions are wiped
+        FilePath staleFile = FilePath(STORAGE_DIRECTORY) + "v1/00000000-0.bin";
+        fileSystem->CreateDirectory(staleFile.GetDirectory(), true);
+        {
+            ScopedPtr<File> file(File::Create(staleFile, File::WRITE | File::CREATE));
+        }
+        TEST_VERIFY(fileSystem->Exists(staleFile));
+        rhi::ShaderSourceCache::SetStorageDirectory(STORAGE_DIRECTORY);
+        TEST_VERIFY(!fileSystem->Exists(staleFile));
+        TEST_VERIFY(fileSystem->EnumerateFilesInDirectory(STORAGE_DIRECTORY).empty());
+
+        FastName uid("ShaderCacheTest: DOUBLE_COLOR = 1");
+        std::vector<std::string> defines = { "DOUBLE_COLOR", "1" };
+        const rhi::ShaderSource* source = rhi::ShaderSourceCache::Add("ShaderCacheTest-vp.sl", uid, rhi::PROG_VERTEX, VERTEX_PROGRAM, defines);
+        TEST_VERIFY(source != nullptr);
+        TEST_VERIFY(rhi::ShaderSourceCache::Get(uid, SourceHash(VERTEX_PROGRAM)) == source);
+
+        String code = (source != nullptr) ? source->GetSourceCode(rhi::HostApi()) : String();
+        TEST_VERIFY(!code.empty());
+
+        // replace in-memory source with another text without storing it, so that the first one can only be read from storage
+        String changedProgram = String("// changed\n") + VERTEX_PROGRAM;
+        rhi::ShaderSourceCache::SetStorageDirectory("");
+        TEST_VERIFY(rhi::ShaderSourceCache::Add("ShaderCacheTest-vp.sl", uid, rhi::PROG_VERTEX, changedProgram.c_str(), defines) != nullptr);
+        rhi::ShaderSourceCache::SetStorageDirectory(STORAGE_DIRECTORY);
+
+        const rhi::ShaderSource* storedSource = rhi::ShaderSourceCache::Get(uid, SourceHash(VERTEX_PROGRAM));
+        TEST_VERIFY(storedSource != nullptr);
+        if (storedSource != nullptr)
+        {
+            TEST_VERIFY(storedSource->GetSourceCode(rhi::HostApi()) == code);
+            TEST_VERIFY(storedSource->ShaderVertexLayout().ElementCount() == 2);
+        }
+
+        // unknown source hash or uid isn't found
+        TEST_VERIFY(rhi::ShaderSourceCache::Get(uid, SourceHash("unknown")) == nullptr);
+        TEST_VERIFY(rhi::ShaderSourceCache::Get(FastName("ShaderCacheTest: unknown"), SourceHash(VERTEX_PROGRAM)) == nullptr);
+
+        // source built from changed text replaces the stale one in storage
+        TEST_VERIFY(rhi::ShaderSourceCache::Add("ShaderCacheTest-vp.sl", uid, rhi::PROG_VERTEX, changedProgram.c_str(), defines) != nullptr);
+        TEST_VERIFY(rhi::ShaderSourceCache::Get(uid, SourceHash(VERTEX_PROGRAM)) == nullptr);
+        TEST_VERIFY(fileSystem->EnumerateFilesInDirectory(STORAGE_DIRECTORY).size() == 1);
+
+        rhi::ShaderSourceCache::SetStorageDirectory(ENGINE_STORAGE_DIRECTORY);
+        fileSystem->DeleteDirectory(STORAGE_DIRECTORY);
+    }
+
+    DAVA_TEST (VariantsListTest)
+    {
+        using namespace ShaderDescriptorCache;
+
+        Vector<ShaderVariant> variants(2);
+        variants[0].name = FastName("~res:/Materials/Shaders/Default/materials");
+        variants[0].defines[FastName("VERTEX_LIT")] = 1;
+        variants[0].defines[FastName("ALPHATEST")] = 0;
+        variants[1].name = FastName("~res:/Materials/Shaders/Default/water");
+
+        FilePath path("~doc:/ShaderCacheTestVariants.yaml");
+        TEST_VERIFY(SaveVariants(path, variants));
+
+        Vector<ShaderVariant> loadedVariants = LoadVariants(path);
+        TEST_VERIFY(loadedVariants.size() == 2);
+        if (loadedVariants.size() == 2)
+        {
+            for (size_t i = 0; i < variants.size(); ++i)
+            {
+                TEST_VERIFY(loadedVariants[i].name == variants[i].name);
+                TEST_VERIFY(loadedVariants[i].defines == variants[i].defines);
+            }
+        }
+
+        GetEngineContext()->fileSystem->DeleteFile(path);
+    }
+};
@@ -0,0 +1,147 @@
+#include "DAVAEngine.h"
+#include "UnitTests/UnitTests.h"
+
+#include "Render/Highlevel/Heightmap.h"
+#include "Render/Highlevel/TiledHeightmap.h"
+
+using namespace DAVA;
+
+namespace TiledHeightmapTestDetails
+{
+const FilePath TILED_HEIGHTMAP_PATH("~doc:/TiledHeightmapTest.theightmap");
+
+Heightmap* CreateHeightmap(int32 size)
+{
+    Heightmap* heightmap = new Heightmap(size);
+    for (int32 i = 0; i < size * size; ++i)
+    {
+        heightmap->Data()[i] = static_cast<uint16>(i * 7919);
+    }
+    return heightmap;
+}
+
+bool IsRegionEqual(TiledHeightmap& tiled, const Heightmap* heightmap, const Rect2i& rect)
+{
+    Vector<uint16> heights(rect.dx * rect.dy);
+    tiled.ReadRegion(rect, heights.data());
+    for (int32 y = 0; y < rect.dy; ++y)
+    {
+        for (int32 x = 0; x < rect.dx; ++x)
+        {
+            if (heights[y * rect.dx + x] != heightmap->GetHeight(rect.x + x, rect.y + y))
+                return false;
+        }
+    }
+    return true;
+}
+}
+
+DAVA_TESTCLASS (TiledHeightmapTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("TiledHeightmap.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    ~TiledHeightmapTest()
+    {
+        FileSystem::Instance()->DeleteFile(TiledHeightmapTestDetails::TILED_HEIGHTMAP_PATH);
+    }
+
+    DAVA_TEST (ReadTest)
+    {
+        using namespace TiledHeightmapTestDetails;
+
+        // heightmap size isn't multiple of tile size, so border tiles are padded
+        ScopedPtr<Heightmap> heightmap(CreateHeightmap(100));
+        TEST_VERIFY(TiledHeightmap::Save(TILED_HEIGHTMAP_PATH, heightmap, 32));
+
+        TiledHeightmap tiled;
+        TEST_VERIFY(tiled.Open(TILED_HEIGHTMAP_PATH));
+        TEST_VERIFY(tiled.GetSize() == 100);
+        TEST_VERIFY(tiled.GetTileSize() == 32);
+        TEST_VERIFY(tiled.GetStats().residentTilesCount == 0);
+
+        TEST_VERIFY(IsRegionEqual(tiled, heightmap, Rect2i(0, 0, 100, 100)));
+        TEST_VERIFY(IsRegionEqual(tiled, heightmap, Rect2i(30, 61, 5, 39)));
+
+        TEST_VERIFY(tiled.GetHeightClamp(99, 0) == heightmap->GetHeight(99, 0));
+        TEST_VERIFY(tiled.GetHeightClamp(150, -3) == heightmap->GetHeight(99, 0));
+        TEST_VERIFY(tiled.GetHeightClamp(64, 33) == heightmap->GetHeight(64, 33));
+
+        // interpolation between heights of neighbour tiles
+        float32 expected = 0.5f * (float32(heightmap->GetHeight(31, 40)) + float32(heightmap->GetHeight(32, 40)));
+        TEST_VERIFY(FLOAT_EQUAL_EPS(tiled.GetHeightBilinear(31.5f, 40.0f), expected, 0.01f));
+        TEST_VERIFY(tiled.GetHeightBilinear(64.0f, 33.0f) == float32(heightmap->GetHeight(64, 33)));
+        TEST_VERIFY(tiled.GetHeightBilinear(99.5f, 99.5f) == float32(heightmap->GetHeight(99, 99)));
+    }
+
+    DAVA_TEST (MemoryBudgetTest)
+    {
+        using namespace TiledHeightmapTestDetails;
+
+        ScopedPtr<Heightmap> heightmap(CreateHeightmap(128));
+        TEST_VERIFY(TiledHeightmap::Save(TILED_HEIGHTMAP_PATH, heightmap, 16));
+
+        const uint32 tileBytes = 16 * 16 * sizeof(uint16);
+
+        TiledHeightmap tiled;
+        TEST_VERIFY(tiled.Open(TILED_HEIGHTMAP_PATH));
+        tiled.SetMemoryBudget(4 * tileBytes);
+
+        // 3x3 tiles around point, budget keeps only four of them
+        tiled.PrefetchAround(40, 40, 16);
+        TiledHeightmap::Stats stats = tiled.GetStats();
+        TEST_VERIFY(stats.loadsCount == 9);
+        TEST_VERIFY(stats.evictionsCount == 5);
+        TEST_VERIFY(stats.residentTilesCount == 4);
+        TEST_VERIFY(stats.residentBytes == 4 * tileBytes);
+
+        // the last prefetched tile is resident, the first one has been evicted
+        tiled.GetHeightClamp(48, 48);
+        TEST_VERIFY(tiled.GetStats().loadsCount == 9);
+        tiled.GetHeightClamp(16, 16);
+        TEST_VERIFY(tiled.GetStats().loadsCount == 10);
+
+        // region larger than budget is still read correctly
+        TEST_VERIFY(IsRegionEqual(tiled, heightmap, Rect2i(0, 0, 128, 128)));
+        TEST_VERIFY(tiled.GetStats().residentTilesCount == 4);
+
+        tiled.SetMemoryBudget(0);
+        TEST_VERIFY(tiled.GetStats().residentTilesCount == 1);
+    }
+
+    DAVA_TEST (WrongHeaderTest)
+    {
+        using namespace TiledHeightmapTestDetails;
+
+        // header of 64k x 64k heightmap with 1x1 tiles in a file without tile index
+        ScopedPtr<File> file(File::Create(TILED_HEIGHTMAP_PATH, File::CREATE | File::WRITE));
+        const char8 signature[4] = { 'T', 'H', 'M', 'P' };
+        const uint32 header[3] = { 1, 65536, 1 };
+        file->Write(signature, sizeof(signature));
+        file->Write(header, sizeof(header));
+        file.reset();
+
+        TiledHeightmap tiled;
+        TEST_VERIFY(!tiled.Open(TILED_HEIGHTMAP_PATH));
+        TEST_VERIFY(!tiled.IsOpen());
+    }
+
+    DAVA_TEST (BuildHeightmapTest)
+    {
+        using namespace TiledHeightmapTestDetails;
+
+        ScopedPtr<Heightmap> heightmap(CreateHeightmap(128));
+        TEST_VERIFY(TiledHeightmap::Save(TILED_HEIGHTMAP_PATH, heightmap, 32));
+
+        TiledHeightmap tiled;
+        TEST_VERIFY(tiled.Open(TILED_HEIGHTMAP_PATH));
+
+        ScopedPtr<Heightmap> resident(new Heightmap());
+        TEST_VERIFY(resident->BuildFromTiled(&tiled, 64));
+        TEST_VERIFY(resident->Size() == 64);
+        TEST_VERIFY(resident->GetHeight(0, 0) == heightmap->GetHeight(0, 0));
+        TEST_VERIFY(resident->GetHeight(63, 17) == heightmap->GetHeight(126, 34));
+    }
+};
@@ -0,0 +1,202 @@
+#include "DAVAEngine.h"
+
+#include "UI/Formula/Private/FormulaParser.h"
+#include "UI/Formula/Private/FormulaExecutor.h"
+#include "UI/Formula/Private/FormulaProgram.h"
+#include "UI/Formula/Private/FormulaException.h"
+#include "UI/Formula/Private/FormulaFormatter.h"
+
+#include "Reflection/ReflectionRegistrator.h"
+
+#include "UnitTests/UnitTests.h"
+
+using namespace DAVA;
+
+class FormulaProgramTestData : public ReflectionBase
+{
+    DAVA_VIRTUAL_REFLECTION(FormulaProgramTestData);
+
+public:
+    float flVal = 0.5f;
+    bool bVal = false;
+    String strVal = "Hello, world";
+    int intVal = 42;
+    Vector<int> array;
+    Map<String, int> map;
+    Any nested;
+
+    FormulaProgramTestData()
+    {
+        array.push_back(10);
+        array.push_back(20);
+        array.push_back(30);
+
+        map["a"] = 11;
+        map["b"] = 22;
+        map["c"] = 33;
+
+        nested = Any(FormulaParser("intVal * 2 + map.a").ParseExpression());
+    }
+
+    int sum(const std::shared_ptr<FormulaContext>& context, int a, int b)
+    {
+        return a + b;
+    }
+
+    String intToStr(const std::shared_ptr<FormulaContext>& context, int a)
+    {
+        return Format("*%d*", a);
+    }
+
+    String floatToStr(const std::shared_ptr<FormulaContext>& context, float a)
+    {
+        double var = static_cast<double>(a);
+        return Format("%.3f", var);
+    }
+};
+
+DAVA_VIRTUAL_REFLECTION_IMPL(FormulaProgramTestData)
+{
+    ReflectionRegistrator<FormulaProgramTestData>::Begin()
+    .Field("fl", &FormulaProgramTestData::flVal)
+    .Field("b", &FormulaProgramTestData::bVal)
+    .Field("str", &FormulaProgramTestData::strVal)
+    .Field("intVal", &FormulaProgramTestData::intVal)
+    .Field("array", &FormulaProgramTestData::array)
+    .Field("map", &FormulaProgramTestData::map)
+    .Field("nested", &FormulaProgramTestData::nested)
+    .Method("sum", &FormulaProgramTestData::sum)
+    .Method("intToStr", &FormulaProgramTestData::intToStr)
+    .Method("floatToStr", &FormulaProgramTestData::floatToStr)
+    .End();
+};
+
+namespace FormulaProgramTestDetails
+{
+struct Result
+{
+    String value;
+    Vector<void*> dependencies;
+};
+
+String ResultToString(const Any& res)
+{
+    return FormulaFormatter::AnyTypeToString(res) + ": " + FormulaFormatter::AnyToString(res);
+}
+
+Result CalculateWithExecutor(FormulaExpression* exp, const std::shared_ptr<FormulaContext>& context)
+{
+    Result result;
+    FormulaExecutor executor(context);
+    try
+    {
+        result.value = ResultToString(executor.Calculate(exp));
+        result.dependencies = executor.GetDependencies();
+    }
+    catch (const FormulaException& error)
+    {
+        result.value = error.GetFormattedMessage();
+    }
+    return result;
+}
+
+Result CalculateWithProgram(FormulaProgram& program, const std::shared_ptr<FormulaContext>& context)
+{
+    Result result;
+    try
+    {
+        result.value = ResultToString(program.Calculate(context));
+        result.dependencies = program.GetDependencies();
+    }
+    catch (const FormulaException& error)
+    {
+        result.value = error.GetFormattedMessage();
+    }
+    return result;
+}
+}
+
+DAVA_TESTCLASS (FormulaProgramTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("FormulaProgram.cpp")
+    END_FILES_COVERED_BY_TESTS()
+
+    // FormulaProgram::Calculate
+    DAVA_TEST (SameResultsAsExecutor)
+    {
+        using namespace FormulaProgramTestDetails;
+
+        const char* formulas[] = {
+            "5", "5 + 5", "7U-9U", "7L-9L", "1---2", "5 + 5.5", "2.0 * 5.5", "5.5 / 2", "7 % 2",
+            "not true", "6 > 5", "5 <= 4", "b or not b", "3 > 2 and intVal > 2",
+            "\"Hello,\" + \" world\" == str", "intToStr(5) == \"*5*\"",
+            "when true -> 0, 1", "when 5 == 2 -> 0, 1", "when b -> 0, intVal > 3 -> intVal, 2",
+            "map.b + intVal", "array[intVal - 41] * fl", "-fl", "fl * intVal - 3", "intVal % 5",
+            "sum(16, intVal * 2)", "floatToStr(55)", "floatToStr(fl)", "nested + 1",
+            "{a = 5; b = intVal}", "[1; 2; intVal]",
+
+            // errors
+            "5 + 5L", "5L + \"543543\"", "false * true", "not 5", "-true", "map.d", "unknown",
+            "array[5.5]", "sum(1, 2, 3)", "floatToStr(true)", "intVal / 0", "5 / 0", "fl % 2.0",
+            "intVal and true", "intVal.x", "when intVal -> 1, 2"
+        };
+
+        FormulaProgramTestData data;
+        std::shared_ptr<FormulaContext> context = std::make_shared<FormulaReflectionContext>(Reflection::Create(&data), std::shared_ptr<FormulaContext>());
+        for (const char* str : formulas)
+        {
+            std::shared_ptr<FormulaExpression> exp = FormulaParser(str).ParseExpression();
+            FormulaProgram program(exp);
+
+            Result expected = CalculateWithExecutor(exp.get(), context);
+            for (int32 i = 0; i < 2; i++) // program keeps its stacks between calculations
+            {
+                Result actual = CalculateWithProgram(program, context);
+                TEST_VERIFY_WITH_MESSAGE(actual.value == expected.value, str);
+                TEST_VERIFY_WITH_MESSAGE(actual.dependencies == expected.dependencies, str);
+            }
+        }
+    }
+
+    // FormulaProgram::FormulaProgram
+    DAVA_TEST (ConstantFolding)
+    {
+        TEST_VERIFY(FormulaProgram(FormulaParser("(5 + 5) * 3 - --2").ParseExpression()).GetInstructionsCount() == 1);
+        TEST_VERIFY(FormulaProgram(FormulaParser("when 5 == 2 -> 0, not false -> 1, 2").ParseExpression()).GetInstructionsCount() == 1);
+
+        // only constant operand is folded
+        TEST_VERIFY(FormulaProgram(FormulaParser("intVal + 2 * 3").ParseExpression()).GetInstructionsCount() == 4);
+
+        // error is reported on calculation
+        FormulaProgramTestData data;
+        std::shared_ptr<FormulaContext> context = std::make_shared<FormulaReflectionContext>(Reflection::Create(&data), std::shared_ptr<FormulaContext>());
+        FormulaProgram program(FormulaParser("1 / (2 - 2)").ParseExpression());
+        try
+        {
+            program.Calculate(context);
+            TEST_VERIFY(false);
+        }
+        catch (const FormulaException& error)
+        {
+            TEST_VERIFY(error.GetFormattedMessage() == "[1, 3] Division by zero '1 / (2 - 2)'");
+        }
+    }
+
+    // FormulaProgram::GetDependencies
+    DAVA_TEST (Dependencies)
+    {
+        FormulaProgramTestData data;
+        std::shared_ptr<FormulaContext> context = std::make_shared<FormulaReflectionContext>(Reflection::Create(&data), std::shared_ptr<FormulaContext>());
+
+        FormulaProgram program(FormulaParser("b and (array[1] == 1)").ParseExpression());
+        program.Calculate(context);
+        TEST_VERIFY(program.GetDependencies() == Vector<void*>({ &(data.bVal), &(data.array), &(data.array[1]) }));
+
+        data.intVal = 7;
+        FormulaProgram nestedProgram(FormulaParser("nested").ParseExpression());
+        TEST_VERIFY(nestedProgram.Calculate(context) == Any(25));
+        TEST_VERIFY(nestedProgram.GetDependencies() == Vector<void*>({ &(data.nested), &(data.intVal), &(data.map), &(data.map["a"]) }));
+    }
+};
@@ -3,6 +3,8 @@
 #include "UI/UIControl.h"
 #include "UI/Layouts/UILayoutSystem.h"
 #include "UI/Layouts/UIAnchorComponent.h"
+#include "UI/Layouts/UILinearLayoutComponent.h"
+#include "UI/Layouts/Private/Layouter.h"
 #include "UI/Layouts/UISizePolicyComponent.h"
 
 #include "UnitTests/UnitTests.h"
@@ -55,4 +57,59 @@ DAVA_TESTCLASS (UILayoutSystemTest)
         SafeRelease(parent);
         SafeRelease(child);
     }
+
+    DAVA_TEST (IncrementalLayout_ProcessesOnlyDirtyHierarchy)
+    {
+        const int32 itemsCount = 100;
+
+        UILayoutSystem* layoutSystem = GetEngineContext()->uiControlSystem->GetLayoutSystem();
+
+        UIControl* screen = MakeRoot("screen");
+        screen->SetSize(Vector2(200.0f, 2000.0f));
+
+        UIControl* list = MakeChild(screen, "list");
+        list->GetOrCreateComponent<UILinearLayoutComponent>()->SetOrientation(UILinearLayoutComponent::TOP_DOWN);
+
+        UIControl* panel = MakeChild(screen, "panel");
+        Vector<UIControl*> items;
+        for (int32 i = 0; i < itemsCount; ++i)
+        {
+            UIControl* item = MakeChild(list, "item");
+            item->SetSize(Vector2(100.0f, 10.0f));
+            items.push_back(item);
+
+            UIControl* panelItem = MakeChild(panel, "panelItem");
+            SafeRelease(panelItem);
+        }
+
+        // layout settles after a few passes, then nothing is visited at all
+        for (int32 pass = 0; pass < 5; ++pass)
+        {
+            layoutSystem->stats = UILayoutSystem::Stats();
+            layoutSystem->ProcessControlHierarhy(screen);
+        }
+        TEST_VERIFY(layoutSystem->stats.visitedControlsCount == 0);
+        TEST_VERIFY(FLOAT_EQUAL_EPS(items[50]->GetPosition().y, 500.0f, 0.01f));
+
+        // resized item relayouts only its list, panel items aren't even visited,
+        // list items are visited only if layout has moved them
+        items[50]->SetSize(Vector2(100.0f, 20.0f));
+        layoutSystem->stats = UILayoutSystem::Stats();
+        layoutSystem->sharedLayouter->ResetMeasuredControlsCount();
+        layoutSystem->ProcessControlHierarhy(screen);
+
+        UILayoutSystem::Stats stats = layoutSystem->GetFrameStats();
+        TEST_VERIFY(stats.visitedControlsCount == 3 + (itemsCount - 51));
+        TEST_VERIFY(stats.layoutsCount == 1);
+        TEST_VERIFY(stats.measuredControlsCount == itemsCount + 1);
+        TEST_VERIFY(FLOAT_EQUAL_EPS(items[51]->GetPosition().y, 520.0f, 0.01f));
+
+        for (UIControl* item : items)
+        {
+            SafeRelease(item);
+        }
+        SafeRelease(panel);
+        SafeRelease(list);
+        SafeRelease(screen);
+    }
 };
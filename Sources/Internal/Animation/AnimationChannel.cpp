@@ -4,9 +4,30 @@
 
 namespace DAVA
 {
+namespace AnimationChannelDetails
+{
+// Forward steps checked one by one before falling back to binary search.
+// Frame to frame animation time usually advances by less than one key interval.
+const uint32 LINEAR_SCAN_KEYS = 4;
+
+// Smallest-three quaternion is packed into three uint16 words:
+// bits 0-1 - index of dropped largest component, bits 2-46 - other components by 15 bits.
+const uint32 SMALLEST_THREE_BITS = 15;
+const uint32 SMALLEST_THREE_MAX = (1 << SMALLEST_THREE_BITS) - 1;
+const float32 SMALLEST_THREE_RANGE = 0.70710678f; //components except the largest are in [-1/sqrt(2), 1/sqrt(2)]
+const float32 SMALLEST_THREE_STEP = 2.f * SMALLEST_THREE_RANGE / float32(SMALLEST_THREE_MAX);
+
+uint32 AlignSize(uint32 size)
+{
+    return (size + 3) & ~3u;
+}
+}
+
 uint32 AnimationChannel::Bind(const uint8* _data)
 {
     keysData = nullptr;
+    valuesData = nullptr;
+    boundsMin = boundsStep = nullptr;
     dimension = 0;
     keyStride = keysCount = 0;
 
@@ -29,12 +50,101 @@ uint32 AnimationChannel::Bind(const uint8* _data)
 
         keysData = dataptr;
 
-        keyStride = uint32(sizeof(float32)) * (dimension + 1);
-        if (interpolation == INTERPOLATION_BEZIER)
-            keyStride += uint32(sizeof(float32) * 4); //four float32 as tangents
+        if (compression == COMPRESSION_NONE)
+        {
+            keyStride = uint32(sizeof(float32)) * (dimension + 1);
+            if (interpolation == INTERPOLATION_BEZIER)
+                keyStride += uint32(sizeof(float32) * 4); //four float32 as tangents
+
+            dataptr += keysCount * keyStride;
+        }
+        else
+        {
+            //compressed channel stores key times and key values in separate arrays
+            keyStride = uint32(sizeof(float32));
+            dataptr += keysCount * keyStride;
+
+            if (compression == COMPRESSION_QUANTIZED && interpolation == INTERPOLATION_LINEAR && dimension <= 4)
+            {
+                boundsMin = reinterpret_cast<const float32*>(dataptr);
+                boundsStep = boundsMin + dimension;
+                dataptr += 2 * dimension * sizeof(float32);
+
+                valuesData = dataptr;
+                dataptr += AnimationChannelDetails::AlignSize(keysCount * dimension * sizeof(uint16));
+            }
+            else if (compression == COMPRESSION_SMALLEST_THREE && interpolation == INTERPOLATION_SPHERICAL_LINEAR && dimension == 4)
+            {
+                valuesData = dataptr;
+                dataptr += AnimationChannelDetails::AlignSize(keysCount * 3 * sizeof(uint16));
+            }
+            else
+            {
+                DVASSERT(false, "Unsupported animation channel compression");
+
+                keysData = nullptr;
+                keysCount = 0;
+                return 0;
+            }
+        }
     }
 
-    return uint32(keysData - _data) + keysCount * keyStride;
+    return uint32(dataptr - _data);
+}
+
+void AnimationChannel::PackSmallestThree(const float32* quaternion, uint16* outData)
+{
+    using namespace AnimationChannelDetails;
+
+    uint32 largest = 0;
+    for (uint32 i = 1; i < 4; ++i)
+    {
+        if (std::abs(quaternion[i]) > std::abs(quaternion[largest]))
+            largest = i;
+    }
+
+    //q and -q is the same rotation, so the dropped component is always restored as positive
+    float32 sign = (quaternion[largest] < 0.f) ? -1.f : 1.f;
+
+    uint64 bits = largest;
+    uint32 shift = 2;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+
+        float32 normalized = (Clamp(sign * quaternion[i], -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE) + SMALLEST_THREE_RANGE) / SMALLEST_THREE_STEP;
+        uint64 quantized = uint64(Min(uint32(normalized + 0.5f), SMALLEST_THREE_MAX));
+        bits |= quantized << shift;
+        shift += SMALLEST_THREE_BITS;
+    }
+
+    outData[0] = uint16(bits);
+    outData[1] = uint16(bits >> 16);
+    outData[2] = uint16(bits >> 32);
+}
+
+void AnimationChannel::UnpackSmallestThree(const uint16* data, float32* outQuaternion)
+{
+    using namespace AnimationChannelDetails;
+
+    uint64 bits = uint64(data[0]) | (uint64(data[1]) << 16) | (uint64(data[2]) << 32);
+    uint32 largest = uint32(bits & 0x3);
+
+    float32 sum = 0.f;
+    uint32 shift = 2;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+
+        float32 value = float32(uint32(bits >> shift) & SMALLEST_THREE_MAX) * SMALLEST_THREE_STEP - SMALLEST_THREE_RANGE;
+        outQuaternion[i] = value;
+        sum += value * value;
+        shift += SMALLEST_THREE_BITS;
+    }
+
+    outQuaternion[largest] = std::sqrt(Max(0.f, 1.f - sum));
 }
 
 #define KEY_DATA_SIZE (dimension * sizeof(float32))
@@ -46,30 +156,74 @@ void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize)
 {
     DVASSERT(dataSize >= GetDimension());
 
-    uint32 k = startKey;
+    if (keysCount == 0)
+        return;
+
+    EvaluateInterval(time, FindNextKey(time, 0), outData);
+}
+
+void AnimationChannel::Evaluate(float32 time, Cursor* cursor, float32* outData, uint32 dataSize) const
+{
+    DVASSERT(cursor != nullptr);
+    DVASSERT(dataSize >= GetDimension());
+
+    if (keysCount == 0)
+        return;
+
+    uint32 k = FindNextKey(time, cursor->key);
+    cursor->key = (k > 0) ? (k - 1) : 0;
+
+    EvaluateInterval(time, k, outData);
+}
 
-    if (KEY_TIME(k) > time)
+uint32 AnimationChannel::FindNextKey(float32 time, uint32 hintKey) const
+{
+    uint32 begin = 0;
+    uint32 end = keysCount;
+
+    if (hintKey < keysCount && KEY_TIME(hintKey) <= time)
     {
-        k = 0;
-    }
+        uint32 scanEnd = Min(hintKey + AnimationChannelDetails::LINEAR_SCAN_KEYS, keysCount);
+        for (uint32 k = hintKey + 1; k < scanEnd; ++k)
+        {
+            if (KEY_TIME(k) > time)
+                return k;
+        }
 
-    for (; k < keysCount; ++k)
+        begin = scanEnd;
+    }
+    else if (hintKey < keysCount)
     {
-        if (KEY_TIME(k) > time)
-            break;
+        end = hintKey;
+    }
 
-        startKey = k;
+    //upper bound in [begin, end)
+    while (begin < end)
+    {
+        uint32 middle = begin + (end - begin) / 2;
+        if (KEY_TIME(middle) > time)
+            end = middle;
+        else
+            begin = middle + 1;
     }
 
+    return begin;
+}
+
+void AnimationChannel::EvaluateInterval(float32 time, uint32 k, float32* outData) const
+{
+    float32 buffer0[4];
+    float32 buffer1[4];
+
     if (k == 0)
     {
-        Memcpy(outData, KEY_DATA(0), KEY_DATA_SIZE);
+        Memcpy(outData, GetKeyValues(0, buffer0), KEY_DATA_SIZE);
         return;
     }
 
     if (k == keysCount)
     {
-        Memcpy(outData, KEY_DATA(keysCount - 1), KEY_DATA_SIZE);
+        Memcpy(outData, GetKeyValues(keysCount - 1, buffer0), KEY_DATA_SIZE);
         return;
     }
 
@@ -78,14 +232,17 @@ void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize)
     float32 time1 = KEY_TIME(k);
     float32 t = (time - time0) / (time1 - time0);
 
+    const float32* data0 = GetKeyValues(k0, buffer0);
+    const float32* data1 = GetKeyValues(k, buffer1);
+
     switch (interpolation)
     {
     case INTERPOLATION_LINEAR:
     {
         for (uint32 d = 0; d < uint32(dimension); ++d)
         {
-            float32 v0 = *(KEY_DATA(k0) + d);
-            float32 v1 = *(KEY_DATA(k) + d);
+            float32 v0 = *(data0 + d);
+            float32 v1 = *(data1 + d);
             *(outData + d) = Lerp(v0, v1, t);
         }
     }
@@ -95,8 +252,8 @@ void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize)
     {
         DVASSERT(dimension == 4); //should be quaternion
 
-        Quaternion q0(KEY_DATA(k0));
-        Quaternion q(KEY_DATA(k));
+        Quaternion q0(data0);
+        Quaternion q(data1);
         q.Slerp(q0, q, t);
         q.Normalize();
 
@@ -115,8 +272,32 @@ void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize)
     }
 }
 
+const float32* AnimationChannel::GetKeyValues(uint32 key, float32* buffer) const
+{
+    switch (compression)
+    {
+    case COMPRESSION_QUANTIZED:
+    {
+        DVASSERT(dimension <= 4);
+
+        const uint16* quantized = reinterpret_cast<const uint16*>(valuesData) + key * dimension;
+        for (uint32 d = 0; d < uint32(dimension); ++d)
+            buffer[d] = boundsMin[d] + float32(quantized[d]) * boundsStep[d];
+
+        return buffer;
+    }
+
+    case COMPRESSION_SMALLEST_THREE:
+        UnpackSmallestThree(reinterpret_cast<const uint16*>(valuesData) + key * 3, buffer);
+        return buffer;
+
+    default:
+        return KEY_DATA(key);
+    }
+}
+
 #undef KEY_DATA_SIZE
 #undef KEY_TIME
 #undef KEY_DATA
 #undef KEY_META
-}
+}
\ No newline at end of file
@@ -4,6 +4,14 @@
 
 namespace DAVA
 {
+/**
+    Keyframes of one animated value bound to immutable animation data.
+
+    Evaluation doesn't modify channel, so one channel (and the animation clip owning it)
+    may be evaluated by many animation instances from many threads at once.
+    Instances which evaluate channel frame by frame should keep their own `Cursor`,
+    so evaluation near the previous time doesn't search keys from the beginning.
+*/
 class AnimationChannel
 {
 public:
@@ -18,16 +26,57 @@ public:
         INTERPOLATION_COUNT
     };
 
+    /**
+        Storage of channel keys, layouts are described in 'AnimationBinaryFormat.md'.
+        Compressed keys are decompressed on the fly during evaluation.
+    */
+    enum eCompression : uint16
+    {
+        COMPRESSION_NONE = 0, //!< float32 key values
+        COMPRESSION_QUANTIZED, //!< 16-bit key values relative to channel bounds, linear interpolation only
+        COMPRESSION_SMALLEST_THREE, //!< 48-bit quaternions with the largest component dropped, spherical interpolation only
+
+        COMPRESSION_COUNT
+    };
+
+    /** Position of the last evaluation in channel keys, owned by animation instance. */
+    struct Cursor
+    {
+        uint32 key = 0; //!< index of key starting the last evaluated interval
+    };
+
     AnimationChannel() = default;
 
     uint32 Bind(const uint8* data);
+
+    /** Evaluate channel at `time`, key interval is found by binary search. */
     void Evaluate(float32 time, float32* outData, uint32 dataSize) const;
 
+    /**
+        Evaluate channel at `time` starting key search from `cursor` and move `cursor` to found key.
+        Time moving forward by less than a few keys is resolved by linear scan, any other seek by binary search.
+    */
+    void Evaluate(float32 time, Cursor* cursor, float32* outData, uint32 dataSize) const;
+
     uint32 GetDimension() const;
+    uint32 GetKeysCount() const;
+    eCompression GetCompression() const;
+
+    /** Pack normalized quaternion to three uint16 words of COMPRESSION_SMALLEST_THREE channel. */
+    static void PackSmallestThree(const float32* quaternion, uint16* outData);
+    static void UnpackSmallestThree(const uint16* data, float32* outQuaternion);
 
 private:
-    const DAVA::uint8* keysData = nullptr;
-    mutable uint32 startKey = 0;
+    /** Return index of the first key with time greater than `time`, or keys count if there is no such key. */
+    uint32 FindNextKey(float32 time, uint32 hintKey) const;
+    void EvaluateInterval(float32 time, uint32 k, float32* outData) const; // k - index returned by FindNextKey
+    /** Return pointer to values of `key`, compressed values are decompressed to `buffer`. */
+    const float32* GetKeyValues(uint32 key, float32* buffer) const;
+
+    const DAVA::uint8* keysData = nullptr; //keys or key times of compressed channel
+    const DAVA::uint8* valuesData = nullptr; //values of compressed channel
+    const float32* boundsMin = nullptr;
+    const float32* boundsStep = nullptr;
     uint32 keysCount = 0;
     uint32 keyStride = 0;
     uint16 compression = 0;
@@ -39,4 +88,14 @@ inline uint32 AnimationChannel::GetDimension() const
 {
     return uint32(dimension);
 }
-}
\ No newline at end of file
+
+inline uint32 AnimationChannel::GetKeysCount() const
+{
+    return keysCount;
+}
+
+inline AnimationChannel::eCompression AnimationChannel::GetCompression() const
+{
+    return eCompression(compression);
+}
+}
@@ -0,0 +1,254 @@
+#include "Animation/AnimationChannelEncoder.h"
+#include "Base/BaseMath.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+namespace AnimationChannelEncoderDetails
+{
+const uint32 QUANTIZED_MAX = 0xFFFF;
+const float32 QUANTIZATION_TOLERANCE_SHARE = 0.5f; // max part of tolerance spent on quantization, the rest is left to key reduction
+
+template <class T>
+void Write(Vector<uint8>& buffer, const T& value)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void AlignBuffer(Vector<uint8>& buffer, size_t channelStart)
+{
+    while (((buffer.size() - channelStart) & 0x3) != 0)
+        buffer.push_back(0);
+}
+
+// Value at `time` interpolated between keys in the same way as `AnimationChannel` does
+Vector4 Interpolate(const AnimationChannelEncoder::Key& key0, const AnimationChannelEncoder::Key& key1, float32 time, uint32 dimension, AnimationChannel::eInterpolation interpolation)
+{
+    float32 interval = key1.time - key0.time;
+    float32 t = (interval > 0.f) ? (time - key0.time) / interval : 0.f;
+
+    Vector4 result;
+    if (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR)
+    {
+        Quaternion q0(key0.value.data);
+        Quaternion q(key1.value.data);
+        q.Slerp(q0, q, t);
+        q.Normalize();
+        result = Vector4(q.x, q.y, q.z, q.w);
+    }
+    else
+    {
+        for (uint32 d = 0; d < dimension; ++d)
+            result.data[d] = Lerp(key0.value.data[d], key1.value.data[d], t);
+    }
+    return result;
+}
+
+float32 Difference(const Vector4& a, const Vector4& b, uint32 dimension, AnimationChannel::eInterpolation interpolation)
+{
+    float32 difference = 0.f;
+    float32 negatedDifference = 0.f;
+    for (uint32 d = 0; d < dimension; ++d)
+    {
+        difference = Max(difference, std::abs(a.data[d] - b.data[d]));
+        negatedDifference = Max(negatedDifference, std::abs(a.data[d] + b.data[d]));
+    }
+
+    if (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR)
+        return Min(difference, negatedDifference);
+
+    return difference;
+}
+
+struct QuantizationBounds
+{
+    float32 min[4];
+    float32 step[4];
+};
+
+QuantizationBounds CalculateBounds(const Vector<AnimationChannelEncoder::Key>& keys, uint32 dimension)
+{
+    QuantizationBounds bounds;
+    for (uint32 d = 0; d < dimension; ++d)
+    {
+        float32 minValue = keys.front().value.data[d];
+        float32 maxValue = minValue;
+        for (const AnimationChannelEncoder::Key& key : keys)
+        {
+            minValue = Min(minValue, key.value.data[d]);
+            maxValue = Max(maxValue, key.value.data[d]);
+        }
+
+        bounds.min[d] = minValue;
+        bounds.step[d] = (maxValue - minValue) / float32(QUANTIZED_MAX);
+    }
+    return bounds;
+}
+
+uint16 Quantize(float32 value, const QuantizationBounds& bounds, uint32 d)
+{
+    float32 normalized = (bounds.step[d] > 0.f) ? (value - bounds.min[d]) / bounds.step[d] : 0.f;
+    return uint16(Min(uint32(Max(normalized, 0.f) + 0.5f), QUANTIZED_MAX));
+}
+
+// Largest difference between key values and values restored by `AnimationChannel` after compression
+float32 QuantizationError(const Vector<AnimationChannelEncoder::Key>& keys, uint32 dimension, AnimationChannel::eInterpolation interpolation, AnimationChannel::eCompression compression, const QuantizationBounds& bounds)
+{
+    float32 error = 0.f;
+    for (const AnimationChannelEncoder::Key& key : keys)
+    {
+        Vector4 restored;
+        if (compression == AnimationChannel::COMPRESSION_QUANTIZED)
+        {
+            for (uint32 d = 0; d < dimension; ++d)
+                restored.data[d] = bounds.min[d] + float32(Quantize(key.value.data[d], bounds, d)) * bounds.step[d];
+        }
+        else
+        {
+            uint16 packed[3];
+            AnimationChannel::PackSmallestThree(key.value.data, packed);
+            AnimationChannel::UnpackSmallestThree(packed, restored.data);
+        }
+        error = Max(error, Difference(restored, key.value, dimension, interpolation));
+    }
+    return error;
+}
+
+bool IsRestorable(const Vector<AnimationChannelEncoder::Key>& keys, uint32 first, uint32 last, uint32 dimension, AnimationChannel::eInterpolation interpolation, float32 tolerance)
+{
+    for (uint32 k = first + 1; k < last; ++k)
+    {
+        Vector4 value = Interpolate(keys[first], keys[last], keys[k].time, dimension, interpolation);
+        if (Difference(value, keys[k].value, dimension, interpolation) > tolerance)
+            return false;
+    }
+    return true;
+}
+}
+
+Vector<AnimationChannelEncoder::Key> AnimationChannelEncoder::ReduceKeys(const Vector<Key>& keys, uint32 dimension, AnimationChannel::eInterpolation interpolation, float32 tolerance)
+{
+    using namespace AnimationChannelEncoderDetails;
+
+    uint32 keysCount = uint32(keys.size());
+    if (keysCount <= 2 || tolerance <= 0.f)
+        return keys;
+
+    Vector<Key> result;
+    result.push_back(keys.front());
+
+    //greedily extend every segment while all skipped keys are restorable
+    uint32 anchor = 0;
+    while (anchor < keysCount - 1)
+    {
+        uint32 next = anchor + 1;
+        for (uint32 candidate = anchor + 2; candidate < keysCount; ++candidate)
+        {
+            if (!IsRestorable(keys, anchor, candidate, dimension, interpolation, tolerance))
+                break;
+
+            next = candidate;
+        }
+
+        result.push_back(keys[next]);
+        anchor = next;
+    }
+
+    return result;
+}
+
+void AnimationChannelEncoder::WriteChannel(Vector<uint8>& buffer, uint32 dimension, AnimationChannel::eInterpolation interpolation, const Vector<Key>& sourceKeys, const Settings& settings)
+{
+    using namespace AnimationChannelEncoderDetails;
+
+    DVASSERT(dimension > 0 && dimension <= 4);
+    DVASSERT(interpolation == AnimationChannel::INTERPOLATION_LINEAR || interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
+
+    Vector<Key> keys = sourceKeys;
+    if (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR)
+    {
+        for (Key& key : keys)
+        {
+            Quaternion orientation(key.value.data);
+            orientation.Normalize();
+            key.value = Vector4(orientation.x, orientation.y, orientation.z, orientation.w);
+        }
+    }
+
+    AnimationChannel::eCompression compression = AnimationChannel::COMPRESSION_NONE;
+    if (settings.compress && !keys.empty())
+    {
+        if (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR && dimension == 4)
+            compression = AnimationChannel::COMPRESSION_SMALLEST_THREE;
+        else if (interpolation == AnimationChannel::INTERPOLATION_LINEAR)
+            compression = AnimationChannel::COMPRESSION_QUANTIZED;
+    }
+
+    // interpolation error of kept keys adds to quantization error of their values, so both share the tolerance.
+    // Bounds are taken over all keys, keys left by reduction are within them
+    QuantizationBounds bounds = {};
+    float32 reductionTolerance = settings.tolerance;
+    if (compression != AnimationChannel::COMPRESSION_NONE)
+    {
+        if (compression == AnimationChannel::COMPRESSION_QUANTIZED)
+            bounds = CalculateBounds(keys, dimension);
+
+        float32 quantizationError = QuantizationError(keys, dimension, interpolation, compression, bounds);
+        if (quantizationError > settings.tolerance * QUANTIZATION_TOLERANCE_SHARE)
+            compression = AnimationChannel::COMPRESSION_NONE; // channel range is too wide for 16-bit steps
+        else
+            reductionTolerance = settings.tolerance - quantizationError;
+    }
+
+    keys = ReduceKeys(keys, dimension, interpolation, reductionTolerance);
+    uint32 keysCount = uint32(keys.size());
+
+    size_t channelStart = buffer.size();
+    Write(buffer, uint32(AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE));
+    Write(buffer, uint8(dimension));
+    Write(buffer, uint8(interpolation));
+    Write(buffer, uint16(compression));
+    Write(buffer, keysCount);
+
+    if (compression == AnimationChannel::COMPRESSION_NONE)
+    {
+        for (const Key& key : keys)
+        {
+            Write(buffer, key.time);
+            for (uint32 d = 0; d < dimension; ++d)
+                Write(buffer, key.value.data[d]);
+        }
+        return;
+    }
+
+    for (const Key& key : keys)
+        Write(buffer, key.time);
+
+    if (compression == AnimationChannel::COMPRESSION_QUANTIZED)
+    {
+        for (uint32 d = 0; d < dimension; ++d)
+            Write(buffer, bounds.min[d]);
+        for (uint32 d = 0; d < dimension; ++d)
+            Write(buffer, bounds.step[d]);
+
+        for (const Key& key : keys)
+        {
+            for (uint32 d = 0; d < dimension; ++d)
+                Write(buffer, Quantize(key.value.data[d], bounds, d));
+        }
+    }
+    else
+    {
+        for (const Key& key : keys)
+        {
+            uint16 packed[3];
+            AnimationChannel::PackSmallestThree(key.value.data, packed);
+            for (uint16 word : packed)
+                Write(buffer, word);
+        }
+    }
+
+    AlignBuffer(buffer, channelStart);
+}
+}
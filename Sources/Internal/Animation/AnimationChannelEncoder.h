@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Animation/AnimationChannel.h"
+#include "Base/BaseTypes.h"
+#include "Math/Vector.h"
+
+namespace DAVA
+{
+/**
+    Writes animation channel data in format described in 'AnimationBinaryFormat.md'.
+    Used by animation exporters, the runtime only reads channels with `AnimationChannel`.
+*/
+namespace AnimationChannelEncoder
+{
+struct Key
+{
+    float32 time = 0.f;
+    Vector4 value; //!< first `dimension` components are used, quaternion is stored as (x, y, z, w)
+};
+
+struct Settings
+{
+    bool compress = true; //!< quantize key values, float32 values are written otherwise
+    float32 tolerance = 0.0005f; //!< largest error of key reduction and quantization together, 0 keeps every key lossless
+};
+
+/**
+    Remove keys which are restored by interpolation of remaining neighbour keys with error not greater than `tolerance`.
+    Error is the largest absolute difference of value components, quaternions are compared up to sign.
+*/
+Vector<Key> ReduceKeys(const Vector<Key>& keys, uint32 dimension, AnimationChannel::eInterpolation interpolation, float32 tolerance);
+
+/**
+    Append channel with `keys` to `buffer`. Keys should be sorted by time, quaternions are normalized before writing.
+    Linear channels are quantized relative to channel bounds, quaternion channels are stored as smallest-three.
+    Quantization may take up to half of `settings.tolerance`, key reduction gets the rest. Channel which quantization
+    error exceeds that share is written uncompressed.
+*/
+void WriteChannel(Vector<uint8>& buffer, uint32 dimension, AnimationChannel::eInterpolation interpolation, const Vector<Key>& keys, const Settings& settings = Settings());
+}
+}
@@ -57,7 +57,7 @@ AnimationClip* AnimationClip::Load(const FilePath& fileName)
         FileHeader header;
         file->Read(&header);
 
-        if (header.signature == ANIMATION_CLIP_FILE_SIGNATURE && header.version == 1)
+        if (header.signature == ANIMATION_CLIP_FILE_SIGNATURE && header.version >= 1 && header.version <= ANIMATION_CLIP_FILE_VERSION)
         {
             clip = new AnimationClip();
             clip->filepath = fileName;
@@ -68,6 +68,7 @@ AnimationClip* AnimationClip::Load(const FilePath& fileName)
             if (read != header.dataSize || CRC32::ForBuffer(dataBuff, header.dataSize) == header.crc32)
             {
                 clip->animationData = dataBuff;
+                clip->animationDataSize = header.dataSize;
 
                 clip->duration = *reinterpret_cast<float32*>(dataBuff);
                 dataBuff += 4;
@@ -158,6 +159,7 @@ void AnimationClip::Dump(std::ostream& stream) const
 
     stream << "AnimationClip:" << endl;
     stream << "Duration: " << duration << " s" << endl;
+    stream << "Data Size: " << animationDataSize << " bytes" << endl;
     stream << "Track Count: " << GetTrackCount() << endl;
     stream << endl;
 
@@ -175,6 +177,8 @@ void AnimationClip::Dump(std::ostream& stream) const
         {
             stream << "    Channel #" << c << endl;
             stream << "        target: " << nodes[t].track.GetChannelTarget(c) << endl;
+            stream << "        keys: " << nodes[t].track.GetChannel(c).GetKeysCount() << endl;
+            stream << "        compression: " << nodes[t].track.GetChannel(c).GetCompression() << endl;
             stream << endl;
         }
     }
@@ -9,6 +9,7 @@ namespace DAVA
 uint32 AnimationTrack::Bind(const uint8* _data)
 {
     channels.clear();
+    valuesSize = 0;
 
     const uint8* dataptr = _data;
     if (dataptr && *reinterpret_cast<const uint32*>(dataptr) == ANIMATION_TRACK_DATA_SIGNATURE)
@@ -31,9 +32,13 @@ uint32 AnimationTrack::Bind(const uint8* _data)
             if (boundData == 0)
             {
                 channels.clear();
+                valuesSize = 0;
                 return 0;
             }
 
+            channels[c].valueOffset = valuesSize;
+            valuesSize += channels[c].channel.GetDimension();
+
             dataptr += boundData;
         }
     }
@@ -47,6 +52,40 @@ void AnimationTrack::Evaluate(float32 time, uint32 channel, float32* outData, ui
     channels[channel].channel.Evaluate(time, outData, dataSize);
 }
 
+void AnimationTrack::Evaluate(float32 time, uint32 channel, AnimationChannel::Cursor* cursor, float32* outData, uint32 dataSize) const
+{
+    DVASSERT(channel < GetChannelsCount());
+    channels[channel].channel.Evaluate(time, cursor, outData, dataSize);
+}
+
+void AnimationTrack::EvaluateAll(float32 time, float32* outData, uint32 dataSize) const
+{
+    DVASSERT(dataSize >= valuesSize);
+    for (const Channel& c : channels)
+    {
+        if (c.valueOffset + c.channel.GetDimension() > dataSize)
+            break;
+
+        c.channel.Evaluate(time, outData + c.valueOffset, c.channel.GetDimension());
+    }
+}
+
+void AnimationTrack::EvaluateAll(float32 time, AnimationChannel::Cursor* cursors, float32* outData, uint32 dataSize) const
+{
+    DVASSERT(cursors != nullptr);
+    DVASSERT(dataSize >= valuesSize);
+
+    uint32 channelsCount = GetChannelsCount();
+    for (uint32 c = 0; c < channelsCount; ++c)
+    {
+        const AnimationChannel& channel = channels[c].channel;
+        if (channels[c].valueOffset + channel.GetDimension() > dataSize)
+            break;
+
+        channel.Evaluate(time, cursors + c, outData + channels[c].valueOffset, channel.GetDimension());
+    }
+}
+
 uint32 AnimationTrack::GetChannelsCount() const
 {
     return uint32(channels.size());
@@ -58,6 +97,12 @@ AnimationTrack::eChannelTarget AnimationTrack::GetChannelTarget(uint32 channel)
     return channels[channel].target;
 }
 
+const AnimationChannel& AnimationTrack::GetChannel(uint32 channel) const
+{
+    DVASSERT(channel < GetChannelsCount());
+    return channels[channel].channel;
+}
+
 uint32 AnimationTrack::GetChannelValueSize(uint32 channel) const
 {
     DVASSERT(channel < GetChannelsCount());
@@ -72,4 +117,15 @@ uint32 AnimationTrack::GetMaxChannelValueSize() const
 
     return maxChannelSize;
 }
+
+uint32 AnimationTrack::GetChannelValueOffset(uint32 channel) const
+{
+    DVASSERT(channel < GetChannelsCount());
+    return channels[channel].valueOffset;
+}
+
+uint32 AnimationTrack::GetValuesSize() const
+{
+    return valuesSize;
+}
 }
\ No newline at end of file
@@ -20,19 +20,33 @@ public:
 
     uint32 Bind(const uint8* data);
     void Evaluate(float32 time, uint32 channel, float32* outData, uint32 dataSize) const;
+    void Evaluate(float32 time, uint32 channel, AnimationChannel::Cursor* cursor, float32* outData, uint32 dataSize) const;
+
+    /**
+        Evaluate every channel at `time` in one pass. Value of channel `c` is written to `outData + GetChannelValueOffset(c)`,
+        `dataSize` should be at least `GetValuesSize()`, channels which values don't fit into `dataSize` aren't evaluated.
+        `cursors` mustn't be null and should point to `GetChannelsCount()` cursors.
+    */
+    void EvaluateAll(float32 time, float32* outData, uint32 dataSize) const;
+    void EvaluateAll(float32 time, AnimationChannel::Cursor* cursors, float32* outData, uint32 dataSize) const;
 
     uint32 GetChannelsCount() const;
     eChannelTarget GetChannelTarget(uint32 channel) const;
+    const AnimationChannel& GetChannel(uint32 channel) const;
 
     uint32 GetChannelValueSize(uint32 channel) const;
     uint32 GetMaxChannelValueSize() const;
+    uint32 GetChannelValueOffset(uint32 channel) const;
+    uint32 GetValuesSize() const;
 
 private:
     struct Channel
     {
         AnimationChannel channel;
+        uint32 valueOffset;
         eChannelTarget target;
     };
     Vector<Channel> channels;
+    uint32 valuesSize = 0;
 };
 }
@@ -29,38 +29,161 @@ void FastNameDB::SetMasterDB(FastNameDB* db)
     *localDBPtr = db;
 }
 
-void FastName::Init(const char* name)
+FastNameDB::Table::Table(uint32 capacity_)
+    : capacity(capacity_)
+    , names(new std::atomic<const CharT*>[capacity_])
+    , hashes(new uint32[capacity_])
 {
-    DVASSERT(nullptr != name);
+    for (uint32 i = 0; i < capacity; ++i)
+    {
+        names[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+FastNameDB::FastNameDB()
+{
+    for (Shard& shard : shards)
+    {
+        shard.tables.emplace_back(new Table(INITIAL_SHARD_CAPACITY));
+        shard.table.store(shard.tables.back().get(), std::memory_order_release);
+    }
+}
 
-    FastNameDB* db = FastNameDB::GetLocalDB();
-    LockGuard<FastNameDB::MutexT> guard(db->mutex);
+FastNameDB::~FastNameDB() = default;
 
-    // search if that name is already in hash
-    auto it = db->nameToIndexMap.find(name);
-    if (it != db->nameToIndexMap.end())
+uint32 FastNameDB::MixHash(size_t hash)
+{
+    // DavaHashString is weak in high bits, which are used to select shard
+    uint64 h = static_cast<uint64>(hash);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<uint32>(h);
+}
+
+const FastNameDB::CharT* FastNameDB::Find(const Table* table, const char* name, uint32 hash)
+{
+    const uint32 mask = table->capacity - 1;
+    for (uint32 i = hash & mask;; i = (i + 1) & mask)
     {
-        // already exist, so we just need to set the same index to this object
-        str = db->namesTable[it->second];
+        const CharT* entry = table->names[i].load(std::memory_order_acquire);
+        if (entry == nullptr)
+        {
+            return nullptr;
+        }
+        if (table->hashes[i] == hash && strcmp(entry, name) == 0)
+        {
+            return entry;
+        }
     }
-    else
+}
+
+void FastNameDB::Place(Table* table, const CharT* name, uint32 hash)
+{
+    const uint32 mask = table->capacity - 1;
+    uint32 i = hash & mask;
+    while (table->names[i].load(std::memory_order_relaxed) != nullptr)
     {
-        // string isn't in hash and it isn't in names table, so we need to copy it
-        // and find place for copied string in names table and set it
-        size_t nameLen = strlen(name);
-        FastNameDB::CharT* nameCopy = new FastNameDB::CharT[nameLen + 1];
-        memcpy(nameCopy, name, nameLen + 1);
+        i = (i + 1) & mask;
+    }
+    table->hashes[i] = hash;
+    table->names[i].store(name, std::memory_order_release);
+}
 
-        db->sizeOfNames += (nameLen * sizeof(FastNameDB::CharT));
+const FastNameDB::CharT* FastNameDB::Intern(const char* name, size_t hash)
+{
+    const uint32 mixedHash = MixHash(hash);
+    Shard& shard = shards[mixedHash >> (32 - SHARDS_BITS)];
 
-        // index will be a new row in names table
-        size_t index = db->namesTable.size();
+    // fast path for existing names, no locks
+    const CharT* found = Find(shard.table.load(std::memory_order_acquire), name, mixedHash);
+    if (found != nullptr)
+    {
+        return found;
+    }
+
+    LockGuard<MutexT> guard(shard.mutex);
 
-        db->namesTable.push_back(nameCopy);
-        db->nameToIndexMap.emplace(nameCopy, index);
+    // name could be inserted by another thread while we were waiting
+    Table* table = shard.table.load(std::memory_order_relaxed);
+    found = Find(table, name, mixedHash);
+    if (found != nullptr)
+    {
+        return found;
+    }
 
-        str = nameCopy;
+    if ((shard.count + 1) * 2 > table->capacity)
+    {
+        table = Grow(shard);
     }
+
+    const CharT* nameCopy = CopyName(shard, name);
+    Place(table, nameCopy, mixedHash);
+    ++shard.count;
+    return nameCopy;
+}
+
+const FastNameDB::CharT* FastNameDB::CopyName(Shard& shard, const char* name)
+{
+    size_t nameSize = strlen(name) + 1;
+    sizeOfNames.fetch_add((nameSize - 1) * sizeof(CharT), std::memory_order_relaxed);
+
+    CharT* nameCopy = nullptr;
+    if (nameSize > NAMES_CHUNK_SIZE / 4)
+    {
+        // long names get own chunk, so current chunk isn't wasted
+        shard.nameChunks.emplace_back(new CharT[nameSize]);
+        nameCopy = shard.nameChunks.back().get();
+        if (shard.nameChunks.size() > 1)
+        {
+            std::swap(shard.nameChunks.back(), shard.nameChunks[shard.nameChunks.size() - 2]);
+        }
+    }
+    else
+    {
+        if (shard.lastChunkUsed + nameSize > NAMES_CHUNK_SIZE)
+        {
+            shard.nameChunks.emplace_back(new CharT[NAMES_CHUNK_SIZE]);
+            shard.lastChunkUsed = 0;
+        }
+        nameCopy = shard.nameChunks.back().get() + shard.lastChunkUsed;
+        shard.lastChunkUsed += nameSize;
+    }
+
+    memcpy(nameCopy, name, nameSize * sizeof(CharT));
+    return nameCopy;
+}
+
+FastNameDB::Table* FastNameDB::Grow(Shard& shard)
+{
+    const Table* oldTable = shard.table.load(std::memory_order_relaxed);
+    std::unique_ptr<Table> newTable(new Table(oldTable->capacity * 2));
+    for (uint32 i = 0; i < oldTable->capacity; ++i)
+    {
+        const CharT* name = oldTable->names[i].load(std::memory_order_relaxed);
+        if (name != nullptr)
+        {
+            Place(newTable.get(), name, oldTable->hashes[i]);
+        }
+    }
+
+    // old table stays in `tables`, readers can still probe it
+    Table* result = newTable.get();
+    shard.tables.push_back(std::move(newTable));
+    shard.table.store(result, std::memory_order_release);
+    return result;
+}
+
+void FastName::Init(const char* name)
+{
+    DVASSERT(nullptr != name);
+    Init(name, DavaHashString(name));
+}
+
+void FastName::Init(const char* name, size_t hash)
+{
+    DVASSERT(nullptr != name);
+    str = FastNameDB::GetLocalDB()->Intern(name, hash);
 }
 
 template <>
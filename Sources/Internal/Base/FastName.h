@@ -5,8 +5,21 @@
 #include "Base/Any.h"
 #include "Concurrency/Spinlock.h"
 
+#include <atomic>
+
 namespace DAVA
 {
+/**
+    Interned strings storage used by FastName.
+
+    Names are stored in 64 shards, each shard is an open-addressing table with linear probing.
+    Lookup of existing name doesn't take any lock: tables are published with release stores
+    and names are never removed, so a reader sees either an inserted name or an empty slot.
+    Only insertion of a new name takes the lock of its shard. When a shard grows, the new table
+    replaces the old one and the old table is kept alive until FastNameDB is destroyed,
+    as concurrent readers may still probe it. Name strings are copied into append-only chunks
+    and never move, so `FastName::c_str()` stays valid for the whole DB lifetime.
+*/
 class FastNameDB final
 {
     friend class FastName;
@@ -19,44 +32,87 @@ public:
     void SetMasterDB(FastNameDB* masterDB);
 
 private:
-    FastNameDB()
-        : nameToIndexMap(8192 * 2)
+    static const uint32 SHARDS_BITS = 6;
+    static const uint32 SHARDS_COUNT = 1 << SHARDS_BITS;
+    static const uint32 INITIAL_SHARD_CAPACITY = 256;
+    static const size_t NAMES_CHUNK_SIZE = 16 * 1024;
+
+    struct Table
     {
-        namesTable.reserve(512);
-    }
+        explicit Table(uint32 capacity);
 
-    ~FastNameDB()
+        uint32 capacity; // power of two, at most half of slots are used
+        std::unique_ptr<std::atomic<const CharT*>[]> names;
+        std::unique_ptr<uint32[]> hashes; // written before name is published
+    };
+
+    struct Shard
     {
-        const size_t count = namesTable.size();
-        for (size_t i = 0; i < count; ++i)
-        {
-            SafeDeleteArray(namesTable[i]);
-        }
-    }
+        std::atomic<Table*> table{ nullptr };
+        uint32 count = 0;
+        MutexT mutex;
+
+        // current and retired tables, all guarded by mutex
+        Vector<std::unique_ptr<Table>> tables;
+
+        // append-only names storage, guarded by mutex
+        Vector<std::unique_ptr<CharT[]>> nameChunks;
+        size_t lastChunkUsed = NAMES_CHUNK_SIZE;
+    };
+
+    FastNameDB();
+    ~FastNameDB();
 
     static FastNameDB** GetLocalDBPtr();
+    static uint32 MixHash(size_t hash);
+    static const CharT* Find(const Table* table, const char* name, uint32 hash);
+    static void Place(Table* table, const CharT* name, uint32 hash);
+
+    const CharT* Intern(const char* name, size_t hash);
+    const CharT* CopyName(Shard& shard, const char* name);
+    Table* Grow(Shard& shard);
+
+    Array<Shard, SHARDS_COUNT> shards;
+    std::atomic<size_t> sizeOfNames{ 0 };
+};
+
+/**
+    String literal with hash computed at compile time, lets FastName skip hashing:
+    \code
+    static const FastNameLiteral diffuseLiteral("diffuse");
+    FastName diffuse(diffuseLiteral);
+    \endcode
+    Hash is the same as DavaHashString gives for the string.
+*/
+class FastNameLiteral
+{
+public:
+    template <size_t N>
+    DAVA_CONSTEXPR FastNameLiteral(const char (&str_)[N])
+        : str(str_)
+        , hash(Hash(str_))
+    {
+    }
 
-    struct FastNameDBHash
+    DAVA_CONSTEXPR const char* c_str() const
     {
-        size_t operator()(const char* str) const
-        {
-            return DavaHashString(str);
-        }
-    };
+        return str;
+    }
 
-    struct FastNameDBEqualTo
+    DAVA_CONSTEXPR size_t GetHash() const
     {
-        bool operator()(const char* left, const char* right) const
-        {
-            return (0 == strcmp(left, right));
-        }
-    };
+        return hash;
+    }
 
-    Vector<const CharT*> namesTable;
-    UnorderedMap<const CharT*, size_t, FastNameDBHash, FastNameDBEqualTo> nameToIndexMap;
+private:
+    // Single return statement form is required by C++11 constexpr rules
+    static DAVA_CONSTEXPR size_t Hash(const char* s, size_t result = 0)
+    {
+        return *s != '\0' ? Hash(s + 1, 5 * result + static_cast<size_t>(*s)) : result;
+    }
 
-    MutexT mutex;
-    size_t sizeOfNames = 0;
+    const char* str;
+    size_t hash;
 };
 
 class FastName
@@ -65,6 +121,7 @@ public:
     FastName();
     explicit FastName(const char* name);
     explicit FastName(const String& name);
+    explicit FastName(const FastNameLiteral& literal);
 
     bool operator<(const FastName& _name) const;
     bool operator==(const FastName& _name) const;
@@ -80,6 +137,7 @@ public:
 
 private:
     void Init(const char* name);
+    void Init(const char* name, size_t hash);
     const char* str = nullptr;
 };
 
@@ -95,6 +153,11 @@ inline FastName::FastName(const char* name)
     Init(name);
 }
 
+inline FastName::FastName(const FastNameLiteral& literal)
+{
+    Init(literal.c_str(), literal.GetHash());
+}
+
 inline bool FastName::operator==(const FastName& _name) const
 {
     return str == _name.str;
@@ -32,6 +32,8 @@ permitted provided that the following conditions are met:
 
 #include "Base/BaseTypes.h"
 
+#include <algorithm>
+
 namespace DAVA
 {
 inline void RadixSort(void* array, int offset, int end, int shift)
@@ -40,6 +42,61 @@ inline void RadixSort(void* array, int offset, int end, int shift)
 
     RadixSortImpl(static_cast<intptr_t*>(array), offset, end, shift);
 }
+
+/**
+    Stable LSD radix sort of `count` items by their 64-bit `key` member in ascending order.
+    `temp` should have room for `count` items. Byte passes where all keys share the same digit are skipped,
+    so sorting cost depends only on bytes that really vary. Sorted items are always returned in `items`.
+*/
+template <typename T>
+void RadixSortByKey64(T* items, T* temp, uint32 count)
+{
+    if (count < 2)
+    {
+        return;
+    }
+
+    uint32 histograms[8][256] = {};
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint64 key = items[i].key;
+        for (uint32 digit = 0; digit < 8; ++digit)
+        {
+            ++histograms[digit][(key >> (digit * 8)) & 0xff];
+        }
+    }
+
+    T* src = items;
+    T* dst = temp;
+    for (uint32 digit = 0; digit < 8; ++digit)
+    {
+        uint32 shift = digit * 8;
+        uint32* histogram = histograms[digit];
+        if (histogram[(items[0].key >> shift) & 0xff] == count)
+        {
+            continue;
+        }
+
+        uint32 offset = 0;
+        for (uint32 bucket = 0; bucket < 256; ++bucket)
+        {
+            uint32 bucketSize = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketSize;
+        }
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != items)
+    {
+        std::copy(src, src + count, items);
+    }
+}
 };
 
 #endif // __DAVAENGINE_BASE_RADIX_RADIX__
\ No newline at end of file
@@ -75,6 +75,18 @@ bool ZipCompressor::Decompress(const Vector<uint8>& in, Vector<uint8>& out) cons
     return true;
 }
 
+bool ZipCompressor::Decompress(const uint8* in, uint32 inSize, uint8* out, uint32 outSize) const
+{
+    uLong uncompressedSize = static_cast<uLong>(outSize);
+    int32 decompressResult = uncompress(out, &uncompressedSize, in, static_cast<uLong>(inSize));
+    if (decompressResult != Z_OK || uncompressedSize != outSize)
+    {
+        Logger::Error("can't uncompress rfc1951 buffer");
+        return false;
+    }
+    return true;
+}
+
 class ZipPrivateData
 {
 public:
@@ -17,6 +17,8 @@ public:
     bool Compress(const Vector<uint8>& in, Vector<uint8>& out) const override;
     // you should resize output to correct size before call this method
     bool Decompress(const Vector<uint8>& in, Vector<uint8>& out) const override;
+    // decompress `inSize` bytes into exactly `outSize` bytes
+    bool Decompress(const uint8* in, uint32 inSize, uint8* out, uint32 outSize) const;
 };
 
 class ZipFile final
@@ -520,6 +520,7 @@ void DLCManagerImpl::Initialize(const FilePath& dirToDownloadPacks_,
         localCacheMeta = dirToDownloadPacks_ + "local_copy_server_meta.meta";
         localCacheFileTable = dirToDownloadPacks_ + "local_copy_server_file_table.block";
         localCacheFooter = dirToDownloadPacks_ + "local_copy_server_footer.footer";
+        localFilesIndex = dirToDownloadPacks_ + "local_files_index.index";
         urlToSuperPack = urlToServerSuperpack_;
         hints = hints_;
 
@@ -2152,60 +2153,164 @@ void DLCManagerImpl::RecursiveScan(const FilePath& baseDir, const FilePath& dir,
         {
             if (path.GetExtension() == extDvpl)
             {
-                String fileName = path.GetAbsolutePathname();
-
-                FILE* f = FileAPI::OpenFile(fileName, "rb");
-                if (f == nullptr)
+                // only list file here, footer is read later if file isn't found in local file index
+                LocalFileInfo info;
+                if (FileAPI::GetFileSizeAndModificationTime(path.GetAbsolutePathname(), info.sizeOnDevice, info.modificationTime))
                 {
-                    Logger::Info("can't open file %s during scan", fileName.c_str());
-                    continue;
-                }
-
-                bool needDeleteIncompleteFile = false;
-                int32 footerSize = sizeof(PackFormat::LitePack::Footer);
-                if (0 == fseek(f, -footerSize, SEEK_END))
-                {
-                    PackFormat::LitePack::Footer footer;
-                    if (footerSize == fread(&footer, 1, footerSize, f))
-                    {
-                        LocalFileInfo info;
-                        info.sizeOnDevice = FileAPI::GetFileSize(fileName);
-                        info.relativeName = path.GetRelativePathname(baseDir);
-                        info.compressedSize = footer.sizeCompressed;
-                        info.crc32Hash = footer.crc32Compressed;
-                        files.push_back(info);
-                    }
-                    else
-                    {
-                        needDeleteIncompleteFile = true;
-                        Logger::Info("can't read footer in file: %s", fileName.c_str());
-                    }
+                    info.relativeName = path.GetRelativePathname(baseDir);
+                    files.push_back(info);
                 }
                 else
                 {
-                    needDeleteIncompleteFile = true;
-                    Logger::Info("can't seek to dvpl footer in file: %s", fileName.c_str());
-                }
-                FileAPI::Close(f);
-                if (needDeleteIncompleteFile)
-                {
-                    if (0 != FileAPI::RemoveFile(fileName))
-                    {
-                        Logger::Error("can't delete incomplete file: %s", fileName.c_str());
-                    }
+                    Logger::Info("can't get size of file %s during scan", path.GetAbsolutePathname().c_str());
                 }
             }
         }
     }
 }
 
+bool DLCManagerImpl::ReadFooter(const FilePath& baseDir, LocalFileInfo& info)
+{
+    String fileName = (baseDir + info.relativeName).GetAbsolutePathname();
+
+    FILE* f = FileAPI::OpenFile(fileName, "rb");
+    if (f == nullptr)
+    {
+        Logger::Info("can't open file %s during scan", fileName.c_str());
+        return false;
+    }
+
+    bool needDeleteIncompleteFile = false;
+    int32 footerSize = sizeof(PackFormat::LitePack::Footer);
+    if (0 == fseek(f, -footerSize, SEEK_END))
+    {
+        PackFormat::LitePack::Footer footer;
+        if (footerSize == fread(&footer, 1, footerSize, f))
+        {
+            info.compressedSize = footer.sizeCompressed;
+            info.crc32Hash = footer.crc32Compressed;
+        }
+        else
+        {
+            needDeleteIncompleteFile = true;
+            Logger::Info("can't read footer in file: %s", fileName.c_str());
+        }
+    }
+    else
+    {
+        needDeleteIncompleteFile = true;
+        Logger::Info("can't seek to dvpl footer in file: %s", fileName.c_str());
+    }
+    FileAPI::Close(f);
+    if (needDeleteIncompleteFile)
+    {
+        if (0 != FileAPI::RemoveFile(fileName))
+        {
+            Logger::Error("can't delete incomplete file: %s", fileName.c_str());
+        }
+        return false;
+    }
+    return true;
+}
+
+static const uint32 maxScanThreads = 4;
+static const size_t minFilesPerScanThread = 64;
+
+void DLCManagerImpl::ReadFooters(const FilePath& baseDir, Vector<LocalFileInfo>& files, const Vector<size_t>& fileIndexes, Vector<uint8>& readResults)
+{
+    Thread* thisThread = Thread::Current();
+    Atomic<uint32> nextIndex{ 0 };
+
+    auto readFooters = [&]()
+    {
+        for (uint32 i = nextIndex++; i < fileIndexes.size() && !thisThread->IsCancelling(); i = nextIndex++)
+        {
+            const size_t fileIndex = fileIndexes[i];
+            readResults[fileIndex] = ReadFooter(baseDir, files[fileIndex]) ? 1 : 0;
+        }
+    };
+
+    // footers are small, so on slow storage time is spent on opening of files, which goes faster in parallel
+    const size_t cpuCount = static_cast<size_t>(DeviceInfo::GetCpuCount());
+    const size_t threadsCount = std::max<size_t>(1, std::min({ fileIndexes.size() / minFilesPerScanThread, cpuCount, size_t(maxScanThreads) }));
+
+    Vector<Thread*> threads;
+    for (size_t i = 1; i < threadsCount; ++i)
+    {
+        Thread* thread = Thread::Create(readFooters);
+        thread->SetName(String("DLC(") + std::to_string(instanceIndex) + ")::ThreadScan" + std::to_string(i));
+        thread->Start();
+        threads.push_back(thread);
+    }
+
+    readFooters();
+
+    for (Thread* thread : threads)
+    {
+        thread->Join();
+        thread->Release();
+    }
+}
+
 void DLCManagerImpl::ScanFiles(const FilePath& dir, Vector<LocalFileInfo>& files)
 {
     if (FileSystem::Instance()->IsDirectory(dir))
     {
+        const int64 scanTime = DateTime::Now().GetTimestamp();
+
+        LocalFileIndex index;
+        const bool isIndexLoaded = index.Load(localFilesIndex);
+
         files.clear();
         files.reserve(hints.maxFilesToDownload);
         RecursiveScan(dir, dir, files);
+
+        Vector<size_t> changedFiles;
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            LocalFileInfo& info = files[i];
+            const LocalFileInfo* indexed = index.Find(info.relativeName, info.sizeOnDevice, info.modificationTime);
+            if (indexed != nullptr)
+            {
+                info.compressedSize = indexed->compressedSize;
+                info.crc32Hash = indexed->crc32Hash;
+            }
+            else
+            {
+                changedFiles.push_back(i);
+            }
+        }
+
+        Vector<uint8> readResults(files.size(), 1);
+        ReadFooters(dir, files, changedFiles, readResults);
+
+        if (Thread::Current()->IsCancelling())
+        {
+            return;
+        }
+
+        // remove files with broken footer, they are deleted from device already
+        size_t readCount = 0;
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            if (readResults[i] != 0)
+            {
+                if (readCount != i)
+                {
+                    files[readCount] = std::move(files[i]);
+                }
+                ++readCount;
+            }
+        }
+        files.resize(readCount);
+
+        Logger::Info("local file index %s, footers read from %u of %u files", isIndexLoaded ? "loaded" : "missing",
+                     static_cast<uint32>(changedFiles.size()), static_cast<uint32>(files.size()));
+
+        if (!isIndexLoaded || !changedFiles.empty() || index.GetCount() != files.size())
+        {
+            LocalFileIndex::Save(localFilesIndex, files, scanTime);
+        }
     }
 }
 
@@ -7,6 +7,7 @@
 #include "DLCManager/Private/RequestManager.h"
 #include "DLCManager/Private/PackRequest.h"
 #include "DLCManager/Private/DebugGestureListener.h"
+#include "DLCManager/Private/LocalFileIndex.h"
 #include "FileSystem/FilePath.h"
 #include "FileSystem/Private/PackFormatSpec.h"
 #include "FileSystem/Private/PackMetaData.h"
@@ -254,13 +255,7 @@ private:
     };
 
     // info to scan local pack files
-    struct LocalFileInfo
-    {
-        String relativeName;
-        uint64 sizeOnDevice = std::numeric_limits<uint64>::max();
-        uint32 compressedSize = std::numeric_limits<uint32>::max(); // file size can be 0 so use max value default
-        uint32 crc32Hash = std::numeric_limits<uint32>::max();
-    };
+    using LocalFileInfo = LocalFileIndex::Entry;
     // fill during scan local pack files, empty after finish scan
     Vector<LocalFileInfo> localFiles;
     // every bit mean file exist and size match with meta
@@ -273,6 +268,8 @@ private:
     void ThreadScanFunc();
     void ScanFiles(const FilePath& dir, Vector<LocalFileInfo>& files);
     void RecursiveScan(const FilePath& baseDir, const FilePath& dir, Vector<LocalFileInfo>& files);
+    bool ReadFooter(const FilePath& baseDir, LocalFileInfo& info);
+    void ReadFooters(const FilePath& baseDir, Vector<LocalFileInfo>& files, const Vector<size_t>& fileIndexes, Vector<uint8>& readResults);
 
     mutable std::ofstream log;
 
@@ -280,6 +277,7 @@ private:
     FilePath localCacheMeta;
     FilePath localCacheFileTable;
     FilePath localCacheFooter;
+    FilePath localFilesIndex;
     FilePath dirToDownloadedPacks;
     String urlToSuperPack;
     bool isProcessingEnabled = false;
@@ -0,0 +1,190 @@
+#include "DLCManager/Private/LocalFileIndex.h"
+#include "FileSystem/File.h"
+#include "FileSystem/FileAPIHelper.h"
+#include "Utils/CRC32.h"
+#include "Logger/Logger.h"
+
+namespace DAVA
+{
+namespace LocalFileIndexDetails
+{
+const Array<char8, 4> FILE_MARKER = { 'D', 'L', 'C', 'I' };
+const uint32 FILE_VERSION = 1;
+
+// file layout: Header, EntryRecord followed by name for every entry, crc32 of all previous bytes
+struct Header
+{
+    Array<char8, 4> marker;
+    uint32 version = 0;
+    uint32 entriesCount = 0;
+    uint32 reserved = 0;
+    int64 scanTime = 0;
+};
+
+struct EntryRecord
+{
+    uint64 sizeOnDevice = 0;
+    int64 modificationTime = 0;
+    uint32 compressedSize = 0;
+    uint32 crc32Hash = 0;
+    uint32 nameLength = 0;
+    uint32 reserved = 0;
+};
+
+template <typename T>
+void Append(Vector<uint8>& buffer, const T& value)
+{
+    const uint8* data = reinterpret_cast<const uint8*>(&value);
+    buffer.insert(buffer.end(), data, data + sizeof(T));
+}
+} // end namespace LocalFileIndexDetails
+
+bool LocalFileIndex::Load(const FilePath& path)
+{
+    using namespace LocalFileIndexDetails;
+
+    entries.clear();
+    scanTime = 0;
+
+    ScopedPtr<File> f(File::Create(path, File::OPEN | File::READ));
+    if (!f)
+    {
+        return false;
+    }
+
+    const uint64 fileSize = f->GetSize();
+    if (fileSize < sizeof(Header) + sizeof(uint32) || fileSize > std::numeric_limits<uint32>::max())
+    {
+        Logger::Info("local file index has wrong size: %llu", fileSize);
+        return false;
+    }
+
+    Vector<uint8> buffer(static_cast<size_t>(fileSize));
+    if (f->Read(buffer.data(), static_cast<uint32>(buffer.size())) != buffer.size())
+    {
+        Logger::Info("can't read local file index: %s", path.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    const size_t contentSize = buffer.size() - sizeof(uint32);
+    uint32 crc32 = 0;
+    Memcpy(&crc32, buffer.data() + contentSize, sizeof(crc32));
+    if (CRC32::ForBuffer(buffer.data(), contentSize) != crc32)
+    {
+        Logger::Info("local file index is corrupted: %s", path.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    Header header;
+    Memcpy(&header, buffer.data(), sizeof(header));
+    if (header.marker != FILE_MARKER || header.version != FILE_VERSION)
+    {
+        Logger::Info("local file index has unknown format: %s", path.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    entries.reserve(header.entriesCount);
+
+    size_t pos = sizeof(Header);
+    for (uint32 i = 0; i < header.entriesCount; ++i)
+    {
+        EntryRecord record;
+        if (contentSize - pos < sizeof(record))
+        {
+            break;
+        }
+        Memcpy(&record, buffer.data() + pos, sizeof(record));
+        pos += sizeof(record);
+
+        if (contentSize - pos < record.nameLength)
+        {
+            break;
+        }
+
+        Entry entry;
+        entry.relativeName.assign(reinterpret_cast<const char8*>(buffer.data() + pos), record.nameLength);
+        entry.sizeOnDevice = record.sizeOnDevice;
+        entry.modificationTime = record.modificationTime;
+        entry.compressedSize = record.compressedSize;
+        entry.crc32Hash = record.crc32Hash;
+        pos += record.nameLength;
+
+        String name = entry.relativeName;
+        entries.emplace(std::move(name), std::move(entry));
+    }
+
+    if (pos != contentSize || entries.size() != header.entriesCount)
+    {
+        Logger::Info("local file index is corrupted: %s", path.GetAbsolutePathname().c_str());
+        entries.clear();
+        return false;
+    }
+
+    scanTime = header.scanTime;
+    return true;
+}
+
+const LocalFileIndex::Entry* LocalFileIndex::Find(const String& relativeName, uint64 sizeOnDevice, int64 modificationTime) const
+{
+    auto it = entries.find(relativeName);
+    if (it != entries.end())
+    {
+        const Entry& entry = it->second;
+        if (entry.sizeOnDevice == sizeOnDevice && entry.modificationTime == modificationTime && modificationTime < scanTime)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool LocalFileIndex::Save(const FilePath& path, const Vector<Entry>& entries, int64 scanTime)
+{
+    using namespace LocalFileIndexDetails;
+
+    Vector<uint8> buffer;
+    buffer.reserve(sizeof(Header) + entries.size() * (sizeof(EntryRecord) + 64) + sizeof(uint32));
+
+    Header header;
+    header.marker = FILE_MARKER;
+    header.version = FILE_VERSION;
+    header.entriesCount = static_cast<uint32>(entries.size());
+    header.scanTime = scanTime;
+    Append(buffer, header);
+
+    for (const Entry& entry : entries)
+    {
+        EntryRecord record;
+        record.sizeOnDevice = entry.sizeOnDevice;
+        record.modificationTime = entry.modificationTime;
+        record.compressedSize = entry.compressedSize;
+        record.crc32Hash = entry.crc32Hash;
+        record.nameLength = static_cast<uint32>(entry.relativeName.size());
+        Append(buffer, record);
+        buffer.insert(buffer.end(), entry.relativeName.begin(), entry.relativeName.end());
+    }
+
+    Append(buffer, CRC32::ForBuffer(buffer.data(), buffer.size()));
+
+    const FilePath tmpPath = path.GetAbsolutePathname() + ".tmp";
+    {
+        ScopedPtr<File> f(File::Create(tmpPath, File::CREATE | File::WRITE));
+        if (!f || f->Write(buffer.data(), static_cast<uint32>(buffer.size())) != buffer.size())
+        {
+            Logger::Error("can't write local file index: %s", tmpPath.GetAbsolutePathname().c_str());
+            return false;
+        }
+    }
+
+    // rename doesn't replace existing file on some platforms
+    FileAPI::RemoveFile(path.GetAbsolutePathname());
+    if (0 != FileAPI::RenameFile(tmpPath.GetAbsolutePathname(), path.GetAbsolutePathname()))
+    {
+        Logger::Error("can't rename local file index: %s", tmpPath.GetAbsolutePathname().c_str());
+        FileAPI::RemoveFile(tmpPath.GetAbsolutePathname());
+        return false;
+    }
+
+    return true;
+}
+} // end namespace DAVA
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "FileSystem/FilePath.h"
+
+namespace DAVA
+{
+/**
+    Compact on-disk index of downloaded .dvpl files: relative name, size and modification time of every file
+    with size and crc32 of compressed content from its `PackFormat::LitePack::Footer`.
+    DLCManager uses it on startup to reopen only files that were changed since index was saved.
+*/
+class LocalFileIndex final
+{
+public:
+    struct Entry
+    {
+        String relativeName;
+        uint64 sizeOnDevice = std::numeric_limits<uint64>::max();
+        int64 modificationTime = 0;
+        uint32 compressedSize = std::numeric_limits<uint32>::max(); // file size can be 0 so use max value default
+        uint32 crc32Hash = std::numeric_limits<uint32>::max();
+    };
+
+    /** Load index from `path`, return false and leave index empty if file is missing or corrupted */
+    bool Load(const FilePath& path);
+
+    /**
+        Find entry of file with `relativeName` if file wasn't changed since it was indexed, return nullptr otherwise.
+        File modified not earlier than scan time of index could be modified again without change of its
+        size and modification time, so such entries are treated as changed.
+    */
+    const Entry* Find(const String& relativeName, uint64 sizeOnDevice, int64 modificationTime) const;
+
+    size_t GetCount() const;
+
+    /**
+        Write `entries` to `path` through temporary file, so index is never left half written.
+        `scanTime` is time (seconds since epoch) when files were listed.
+    */
+    static bool Save(const FilePath& path, const Vector<Entry>& entries, int64 scanTime);
+
+private:
+    UnorderedMap<String, Entry> entries;
+    int64 scanTime = 0;
+};
+
+inline size_t LocalFileIndex::GetCount() const
+{
+    return entries.size();
+}
+} // end namespace DAVA
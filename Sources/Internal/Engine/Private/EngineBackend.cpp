@@ -358,10 +358,6 @@ void EngineBackend::OnGameLoopStopped()
     DVASSERT(justCreatedWindows.empty());
 
     engine->gameLoopStopped.Emit();
-    if (!IsConsoleMode())
-    {
-        rhi::ShaderSourceCache::Save("~doc:/ShaderSource.bin");
-    }
 
     Logger::Info("EngineBackend::OnGameLoopStopped: leave");
 }
@@ -686,7 +682,6 @@ void EngineBackend::HandleAppSuspended(const MainDispatcherEvent& e)
         // Please NEVER add some additional `if` checks here.
         if (Renderer::IsInitialized())
             rhi::SuspendRendering();
-        rhi::ShaderSourceCache::Save("~doc:/ShaderSource.bin");
         engine->suspended.Emit();
 
         Logger::Info("EngineBackend::HandleAppSuspended: leave");
@@ -809,7 +804,15 @@ void EngineBackend::InitRenderer(Window* w)
 
     w->InitCustomRenderParams(rendererParams);
 
-    rhi::ShaderSourceCache::Load("~doc:/ShaderSource.bin");
+    // every shader source is stored as soon as it's built, so nothing is lost if app is killed
+    rhi::ShaderSourceCache::SetStorageDirectory("~doc:/ShaderSourceCache/");
+
+    // single file cache written by former versions is never read again
+    const FilePath legacyShaderSourceCache("~doc:/ShaderSource.bin");
+    if (context->fileSystem->IsFile(legacyShaderSourceCache))
+    {
+        context->fileSystem->DeleteFile(legacyShaderSourceCache);
+    }
     Renderer::Initialize(renderer, rendererParams);
     context->renderSystem2D->Init();
 
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/Type.h"
+#include "Functional/Function.h"
+
+namespace DAVA
+{
+class Component;
+class Entity;
+
+/**
+    Opt-in storage which groups entities by archetype: set of registered component types they have.
+
+    Entities of every archetype are kept in chunks of `CHUNK_CAPACITY` rows. Chunk is structure of arrays:
+    column of entities and one column per registered type of the archetype, so iteration over entities
+    with given types goes linearly through memory without looking up components in every entity.
+
+    Two kinds of types can be registered:
+    - component types: components stay owned by entities and never move, because a lot of code (and components themselves)
+      keeps raw pointers to them, so their columns hold pointers. Only the first component of every type is stored for entity.
+    - data types: trivially copyable structures stored by value right in chunk columns. They are attached to entities
+      with `SetData` and are moved together with the row when entity changes archetype.
+    Entity with no registered components and no data isn't stored.
+
+    Usually used through `Scene::RegisterArchetypeComponent` and `Scene::ForEach`, which keep storage in sync with scene.
+    Entities and components mustn't be added or removed while storage is iterated.
+*/
+class ArchetypeStorage final
+{
+public:
+    static const uint32 CHUNK_CAPACITY = 128;
+    static const uint32 MAX_REGISTERED_TYPES = 64;
+
+    struct Chunk
+    {
+        uint32 count = 0;
+        Entity* entities[CHUNK_CAPACITY];
+        /**
+            `CHUNK_CAPACITY` values of every type of archetype, one column after another:
+            pointers for component types and values for data types.
+        */
+        Vector<uint8> columns;
+
+        uint8* GetColumn(int32 offset) const;
+    };
+
+    struct Archetype
+    {
+        uint64 mask = 0;
+        /** Byte offset of column of every registered type in chunks, -1 for types which archetype doesn't have. */
+        Vector<int32> columns;
+        uint32 chunkSize = 0;
+        Vector<std::unique_ptr<Chunk>> chunks;
+    };
+
+    ArchetypeStorage();
+    ~ArchetypeStorage();
+
+    /** Start storing components of `type`, entities should be updated after that with `UpdateEntity`. */
+    void RegisterComponentType(const Type* type);
+    bool IsRegisteredComponentType(const Type* type) const;
+    /** Whether any component or data type is registered, otherwise storage is empty and needn't be kept in sync. */
+    bool HasRegisteredTypes() const;
+
+    /** Start storing values of trivially copyable type `T` attached to entities with `SetData`. */
+    template <typename T>
+    void RegisterDataType();
+    bool IsRegisteredDataType(const Type* type) const;
+
+    /** Attach `value` of registered data type to stored entity or overwrite attached one, entity is stored if it wasn't. */
+    template <typename T>
+    void SetData(Entity* entity, const T& value);
+    /** Return data of type `T` attached to entity, nullptr if there is no such data. Pointer is valid until entity changes archetype. */
+    template <typename T>
+    T* GetData(Entity* entity);
+    template <typename T>
+    void RemoveData(Entity* entity);
+
+    /**
+        Move entity to archetype matching its current components and attached data, or remove it if it has neither.
+        `ignoredComponent` is treated as already removed from entity.
+    */
+    void UpdateEntity(Entity* entity, Component* ignoredComponent = nullptr);
+    void RemoveEntity(Entity* entity);
+    void Clear();
+
+    uint32 GetEntitiesCount() const;
+    uint32 GetArchetypesCount() const;
+
+    /** Call `fn(entity, T*...)` for every stored entity which has all of `Ts` components or data. */
+    template <typename... Ts, typename Fn>
+    void ForEach(Fn&& fn);
+
+    /**
+        Call `fn(entity, T*...)` for every stored entity which has all of `Ts` components or data.
+        Chunks are processed in parallel on worker threads, so `fn` should touch only given entity, components and data.
+    */
+    template <typename... Ts, typename Fn>
+    void ParallelForEach(Fn&& fn);
+
+private:
+    struct Location
+    {
+        Archetype* archetype = nullptr;
+        uint32 chunk = 0;
+        uint32 row = 0;
+    };
+
+    struct ChunkRef
+    {
+        const Archetype* archetype = nullptr;
+        const Chunk* chunk = nullptr;
+    };
+
+    struct RegisteredType
+    {
+        const Type* type = nullptr;
+        /** Size of value in column: pointer size for component types. */
+        uint32 size = 0;
+        bool isComponent = false;
+    };
+
+    /** Access to column values: components are stored by pointer, data by value. */
+    template <typename T, bool IsComponent = std::is_base_of<Component, T>::value>
+    struct ColumnAccess;
+
+    int32 GetTypeIndex(const Type* type) const;
+    void RegisterType(const Type* type, uint32 size, bool isComponent);
+    uint8* GetCell(const Location& location, int32 typeIndex) const;
+    uint8* AddData(Entity* entity, int32 typeIndex);
+    uint8* GetData(Entity* entity, int32 typeIndex) const;
+    void RemoveData(Entity* entity, int32 typeIndex);
+    void MoveEntity(Entity* entity, uint64 mask, Component* ignoredComponent);
+    bool GetQueryMask(const int32* queryTypeIndices, uint32 count, uint64& mask) const;
+    void CollectChunks(uint64 queryMask, Vector<ChunkRef>& chunks) const;
+    void ParallelFor(uint32 count, const Function<void(uint32)>& fn);
+
+    Archetype* GetOrCreateArchetype(uint64 mask);
+    void AddRow(Archetype* archetype, Entity* entity, Location& location);
+    void RemoveRow(const Location& location);
+    void CopyData(const Location& from, const Location& to);
+    void FillRow(const Location& location, Entity* entity, Component* ignoredComponent);
+
+    template <typename... Ts, typename Fn, size_t... Indices>
+    static void ProcessChunk(const Archetype* archetype, const Chunk* chunk, const int32* queryTypeIndices, Fn& fn, std::index_sequence<Indices...>);
+
+    /** Index of registered component type by runtime component id, -1 for not registered types. */
+    Vector<int32> typeIndices;
+    UnorderedMap<const Type*, int32> dataTypeIndices;
+    Vector<RegisteredType> registeredTypes;
+    /** Bits of registered data types in archetype masks. */
+    uint64 dataMask = 0;
+
+    Vector<std::unique_ptr<Archetype>> archetypes;
+    UnorderedMap<uint64, Archetype*> archetypesByMask;
+    UnorderedMap<Entity*, Location> locations;
+
+    uint32 iterationsCount = 0;
+};
+}
+
+#include "Entity/Private/ArchetypeStorage_impl.h"
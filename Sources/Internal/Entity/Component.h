@@ -16,6 +16,12 @@ namespace DAVA
 {
 class Entity;
 
+namespace FlatHierarchy
+{
+class ValueWriter;
+class ValueReader;
+}
+
 class Component : public Serializable, public InspBase
 {
     DAVA_ENABLE_CLASS_ALLOCATION_TRACKING(ALLOC_POOL_COMPONENT)
@@ -31,6 +37,14 @@ public:
     void Serialize(KeyedArchive* archive, SerializationContext* serializationContext) override;
     void Deserialize(KeyedArchive* archive, SerializationContext* serializationContext) override;
 
+    /**
+        Writes component as plain values to flat scene hierarchy. Returns false if component can't be written
+        this way, then it is stored with Serialize. Default implementation returns false.
+    */
+    virtual bool SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext);
+    /** Reads values written by SaveFlat. It is called after component is added to entity as Deserialize is. */
+    virtual bool LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext);
+
     inline Entity* GetEntity() const;
     virtual void SetEntity(Entity* entity);
 
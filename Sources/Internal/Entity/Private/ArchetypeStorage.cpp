@@ -0,0 +1,387 @@
+#include "Entity/ArchetypeStorage.h"
+#include "Engine/Engine.h"
+#include "Entity/Component.h"
+#include "Entity/ComponentManager.h"
+#include "Job/JobManager.h"
+#include "Scene3D/Entity.h"
+
+namespace DAVA
+{
+ArchetypeStorage::ArchetypeStorage() = default;
+
+ArchetypeStorage::~ArchetypeStorage() = default;
+
+void ArchetypeStorage::RegisterComponentType(const Type* type)
+{
+    DVASSERT(iterationsCount == 0);
+
+    ComponentManager* componentManager = GetEngineContext()->componentManager;
+    DVASSERT(componentManager->IsRegisteredSceneComponent(type));
+
+    if (IsRegisteredComponentType(type))
+    {
+        return;
+    }
+
+    uint32 runtimeId = componentManager->GetRuntimeComponentId(type);
+    if (typeIndices.size() <= runtimeId)
+    {
+        typeIndices.resize(Max(runtimeId + 1, componentManager->GetSceneComponentsCount()), -1);
+    }
+    typeIndices[runtimeId] = static_cast<int32>(registeredTypes.size());
+    RegisterType(type, sizeof(Component*), true);
+}
+
+void ArchetypeStorage::RegisterType(const Type* type, uint32 size, bool isComponent)
+{
+    DVASSERT(iterationsCount == 0);
+
+    if (!isComponent)
+    {
+        if (IsRegisteredDataType(type))
+        {
+            return;
+        }
+        dataMask |= uint64(1) << registeredTypes.size();
+        dataTypeIndices.emplace(type, static_cast<int32>(registeredTypes.size()));
+    }
+
+    DVASSERT(registeredTypes.size() < MAX_REGISTERED_TYPES, "Too many types registered in ArchetypeStorage");
+
+    RegisteredType registered;
+    registered.type = type;
+    registered.size = size;
+    registered.isComponent = isComponent;
+    registeredTypes.push_back(registered);
+
+    // existing archetypes have no values of new type
+    for (std::unique_ptr<Archetype>& archetype : archetypes)
+    {
+        archetype->columns.push_back(-1);
+    }
+}
+
+bool ArchetypeStorage::IsRegisteredComponentType(const Type* type) const
+{
+    int32 typeIndex = GetTypeIndex(type);
+    return typeIndex >= 0 && registeredTypes[typeIndex].isComponent;
+}
+
+bool ArchetypeStorage::IsRegisteredDataType(const Type* type) const
+{
+    int32 typeIndex = GetTypeIndex(type);
+    return typeIndex >= 0 && !registeredTypes[typeIndex].isComponent;
+}
+
+int32 ArchetypeStorage::GetTypeIndex(const Type* type) const
+{
+    ComponentManager* componentManager = GetEngineContext()->componentManager;
+    if (!componentManager->IsRegisteredSceneComponent(type))
+    {
+        auto found = dataTypeIndices.find(type);
+        return (found != dataTypeIndices.end()) ? found->second : -1;
+    }
+
+    uint32 runtimeId = componentManager->GetRuntimeComponentId(type);
+    return (runtimeId < typeIndices.size()) ? typeIndices[runtimeId] : -1;
+}
+
+uint8* ArchetypeStorage::GetCell(const Location& location, int32 typeIndex) const
+{
+    const Chunk* chunk = location.archetype->chunks[location.chunk].get();
+    return chunk->GetColumn(location.archetype->columns[typeIndex]) + location.row * registeredTypes[typeIndex].size;
+}
+
+bool ArchetypeStorage::GetQueryMask(const int32* queryTypeIndices, uint32 count, uint64& mask) const
+{
+    mask = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (queryTypeIndices[i] < 0)
+        {
+            DVASSERT(false, "Component type isn't registered in ArchetypeStorage");
+            return false;
+        }
+        mask |= uint64(1) << queryTypeIndices[i];
+    }
+    return true;
+}
+
+void ArchetypeStorage::CollectChunks(uint64 queryMask, Vector<ChunkRef>& chunks) const
+{
+    for (const std::unique_ptr<Archetype>& archetype : archetypes)
+    {
+        if ((archetype->mask & queryMask) == queryMask)
+        {
+            for (const std::unique_ptr<Chunk>& chunk : archetype->chunks)
+            {
+                chunks.push_back({ archetype.get(), chunk.get() });
+            }
+        }
+    }
+}
+
+void ArchetypeStorage::ParallelFor(uint32 count, const Function<void(uint32)>& fn)
+{
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (jobManager != nullptr && count > 1)
+    {
+        jobManager->ParallelFor(0, count, 1, [&fn](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                fn(i);
+            }
+        });
+    }
+    else
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            fn(i);
+        }
+    }
+}
+
+ArchetypeStorage::Archetype* ArchetypeStorage::GetOrCreateArchetype(uint64 mask)
+{
+    auto found = archetypesByMask.find(mask);
+    if (found != archetypesByMask.end())
+    {
+        return found->second;
+    }
+
+    std::unique_ptr<Archetype> archetype(new Archetype());
+    archetype->mask = mask;
+    archetype->columns.resize(registeredTypes.size(), -1);
+
+    // every column takes multiple of `CHUNK_CAPACITY` bytes, so columns start aligned for any value with fundamental alignment
+    uint32 offset = 0;
+    for (size_t i = 0; i < registeredTypes.size(); ++i)
+    {
+        if ((mask & (uint64(1) << i)) != 0)
+        {
+            archetype->columns[i] = static_cast<int32>(offset);
+            offset += registeredTypes[i].size * CHUNK_CAPACITY;
+        }
+    }
+    archetype->chunkSize = offset;
+
+    Archetype* result = archetype.get();
+    archetypes.push_back(std::move(archetype));
+    archetypesByMask.emplace(mask, result);
+    return result;
+}
+
+void ArchetypeStorage::AddRow(Archetype* archetype, Entity* entity, Location& location)
+{
+    if (archetype->chunks.empty() || archetype->chunks.back()->count == CHUNK_CAPACITY)
+    {
+        std::unique_ptr<Chunk> chunk(new Chunk());
+        chunk->columns.resize(archetype->chunkSize, 0);
+        archetype->chunks.push_back(std::move(chunk));
+    }
+
+    Chunk* chunk = archetype->chunks.back().get();
+    location.archetype = archetype;
+    location.chunk = static_cast<uint32>(archetype->chunks.size() - 1);
+    location.row = chunk->count++;
+    chunk->entities[location.row] = entity;
+}
+
+void ArchetypeStorage::RemoveRow(const Location& location)
+{
+    Archetype* archetype = location.archetype;
+    Chunk* chunk = archetype->chunks[location.chunk].get();
+    Chunk* lastChunk = archetype->chunks.back().get();
+    uint32 lastRow = lastChunk->count - 1;
+
+    // keep rows dense: move the last row of archetype to the removed one
+    if (chunk != lastChunk || location.row != lastRow)
+    {
+        Entity* movedEntity = lastChunk->entities[lastRow];
+        chunk->entities[location.row] = movedEntity;
+
+        Location& movedLocation = locations[movedEntity];
+        for (size_t i = 0; i < registeredTypes.size(); ++i)
+        {
+            if (archetype->columns[i] >= 0)
+            {
+                std::memcpy(GetCell(location, static_cast<int32>(i)), GetCell(movedLocation, static_cast<int32>(i)), registeredTypes[i].size);
+            }
+        }
+
+        movedLocation.chunk = location.chunk;
+        movedLocation.row = location.row;
+    }
+
+    --lastChunk->count;
+    if (lastChunk->count == 0)
+    {
+        archetype->chunks.pop_back();
+    }
+}
+
+void ArchetypeStorage::FillRow(const Location& location, Entity* entity, Component* ignoredComponent)
+{
+    const Vector<int32>& columns = location.archetype->columns;
+
+    for (size_t i = 0; i < registeredTypes.size(); ++i)
+    {
+        if (columns[i] >= 0 && registeredTypes[i].isComponent)
+        {
+            const Type* type = registeredTypes[i].type;
+            Component* component = entity->GetComponent(type, 0);
+            if (component != nullptr && component == ignoredComponent)
+            {
+                component = entity->GetComponent(type, 1);
+            }
+            DVASSERT(component != nullptr);
+            std::memcpy(GetCell(location, static_cast<int32>(i)), &component, sizeof(Component*));
+        }
+    }
+}
+
+void ArchetypeStorage::CopyData(const Location& from, const Location& to)
+{
+    uint64 commonData = from.archetype->mask & to.archetype->mask & dataMask;
+    for (size_t i = 0; i < registeredTypes.size(); ++i)
+    {
+        if ((commonData & (uint64(1) << i)) != 0)
+        {
+            std::memcpy(GetCell(to, static_cast<int32>(i)), GetCell(from, static_cast<int32>(i)), registeredTypes[i].size);
+        }
+    }
+}
+
+void ArchetypeStorage::UpdateEntity(Entity* entity, Component* ignoredComponent)
+{
+    DVASSERT(iterationsCount == 0);
+
+    const Type* ignoredType = (ignoredComponent != nullptr) ? ignoredComponent->GetType() : nullptr;
+
+    uint64 mask = 0;
+    for (size_t i = 0; i < registeredTypes.size(); ++i)
+    {
+        if (!registeredTypes[i].isComponent)
+        {
+            continue;
+        }
+
+        uint32 count = entity->GetComponentCount(registeredTypes[i].type);
+        if (registeredTypes[i].type == ignoredType && count > 0)
+        {
+            --count;
+        }
+        if (count > 0)
+        {
+            mask |= uint64(1) << i;
+        }
+    }
+
+    // attached data stays with entity
+    auto found = locations.find(entity);
+    if (found != locations.end())
+    {
+        mask |= found->second.archetype->mask & dataMask;
+    }
+
+    MoveEntity(entity, mask, ignoredComponent);
+}
+
+void ArchetypeStorage::MoveEntity(Entity* entity, uint64 mask, Component* ignoredComponent)
+{
+    auto found = locations.find(entity);
+    if (mask == 0)
+    {
+        if (found != locations.end())
+        {
+            RemoveRow(found->second);
+            locations.erase(found);
+        }
+        return;
+    }
+
+    if (found != locations.end())
+    {
+        if (found->second.archetype->mask == mask)
+        {
+            // same archetype, but first component of some type could be replaced
+            FillRow(found->second, entity, ignoredComponent);
+            return;
+        }
+
+        Location previous = found->second;
+        AddRow(GetOrCreateArchetype(mask), entity, found->second);
+        CopyData(previous, found->second);
+        RemoveRow(previous);
+    }
+    else
+    {
+        found = locations.emplace(entity, Location()).first;
+        AddRow(GetOrCreateArchetype(mask), entity, found->second);
+    }
+
+    FillRow(found->second, entity, ignoredComponent);
+}
+
+uint8* ArchetypeStorage::AddData(Entity* entity, int32 typeIndex)
+{
+    DVASSERT(iterationsCount == 0);
+    DVASSERT(!registeredTypes[typeIndex].isComponent);
+
+    uint64 mask = uint64(1) << typeIndex;
+    auto found = locations.find(entity);
+    if (found != locations.end())
+    {
+        mask |= found->second.archetype->mask;
+    }
+
+    MoveEntity(entity, mask, nullptr);
+    return GetCell(locations[entity], typeIndex);
+}
+
+uint8* ArchetypeStorage::GetData(Entity* entity, int32 typeIndex) const
+{
+    DVASSERT(!registeredTypes[typeIndex].isComponent);
+
+    auto found = locations.find(entity);
+    if (found == locations.end() || found->second.archetype->columns[typeIndex] < 0)
+    {
+        return nullptr;
+    }
+    return GetCell(found->second, typeIndex);
+}
+
+void ArchetypeStorage::RemoveData(Entity* entity, int32 typeIndex)
+{
+    DVASSERT(iterationsCount == 0);
+    DVASSERT(!registeredTypes[typeIndex].isComponent);
+
+    auto found = locations.find(entity);
+    if (found != locations.end() && found->second.archetype->columns[typeIndex] >= 0)
+    {
+        MoveEntity(entity, found->second.archetype->mask & ~(uint64(1) << typeIndex), nullptr);
+    }
+}
+
+void ArchetypeStorage::RemoveEntity(Entity* entity)
+{
+    DVASSERT(iterationsCount == 0);
+
+    auto found = locations.find(entity);
+    if (found != locations.end())
+    {
+        RemoveRow(found->second);
+        locations.erase(found);
+    }
+}
+
+void ArchetypeStorage::Clear()
+{
+    DVASSERT(iterationsCount == 0);
+
+    locations.clear();
+    archetypesByMask.clear();
+    archetypes.clear();
+}
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Debug/DVAssert.h"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace DAVA
+{
+template <typename T>
+struct ArchetypeStorage::ColumnAccess<T, true>
+{
+    static T* Get(uint8* column, uint32 row)
+    {
+        return static_cast<T*>(reinterpret_cast<Component**>(column)[row]);
+    }
+};
+
+template <typename T>
+struct ArchetypeStorage::ColumnAccess<T, false>
+{
+    static T* Get(uint8* column, uint32 row)
+    {
+        return reinterpret_cast<T*>(column) + row;
+    }
+};
+
+inline uint8* ArchetypeStorage::Chunk::GetColumn(int32 offset) const
+{
+    DVASSERT(offset >= 0);
+    return const_cast<uint8*>(columns.data()) + offset;
+}
+
+inline bool ArchetypeStorage::HasRegisteredTypes() const
+{
+    return !registeredTypes.empty();
+}
+
+template <typename T>
+void ArchetypeStorage::RegisterDataType()
+{
+    static_assert(!std::is_base_of<Component, T>::value, "Components should be registered with RegisterComponentType");
+    static_assert(std::is_trivially_copyable<T>::value, "Data is moved between chunks with memcpy");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Chunk columns are aligned only for fundamental alignment");
+    RegisterType(Type::Instance<T>(), sizeof(T), false);
+}
+
+template <typename T>
+void ArchetypeStorage::SetData(Entity* entity, const T& value)
+{
+    int32 typeIndex = GetTypeIndex(Type::Instance<T>());
+    DVASSERT(typeIndex >= 0, "Data type isn't registered in ArchetypeStorage");
+    if (typeIndex >= 0)
+    {
+        std::memcpy(AddData(entity, typeIndex), &value, sizeof(T));
+    }
+}
+
+template <typename T>
+T* ArchetypeStorage::GetData(Entity* entity)
+{
+    int32 typeIndex = GetTypeIndex(Type::Instance<T>());
+    return (typeIndex >= 0) ? reinterpret_cast<T*>(GetData(entity, typeIndex)) : nullptr;
+}
+
+template <typename T>
+void ArchetypeStorage::RemoveData(Entity* entity)
+{
+    int32 typeIndex = GetTypeIndex(Type::Instance<T>());
+    if (typeIndex >= 0)
+    {
+        RemoveData(entity, typeIndex);
+    }
+}
+
+inline uint32 ArchetypeStorage::GetEntitiesCount() const
+{
+    return static_cast<uint32>(locations.size());
+}
+
+inline uint32 ArchetypeStorage::GetArchetypesCount() const
+{
+    return static_cast<uint32>(archetypes.size());
+}
+
+template <typename... Ts, typename Fn, size_t... Indices>
+void ArchetypeStorage::ProcessChunk(const Archetype* archetype, const Chunk* chunk, const int32* queryTypeIndices, Fn& fn, std::index_sequence<Indices...>)
+{
+    uint8* columns[sizeof...(Ts)] = { chunk->GetColumn(archetype->columns[queryTypeIndices[Indices]])... };
+    for (uint32 row = 0, count = chunk->count; row < count; ++row)
+    {
+        fn(chunk->entities[row], ColumnAccess<Ts>::Get(columns[Indices], row)...);
+    }
+}
+
+template <typename... Ts, typename Fn>
+void ArchetypeStorage::ForEach(Fn&& fn)
+{
+    static_assert(sizeof...(Ts) > 0, "At least one component or data type should be specified");
+
+    const int32 queryTypeIndices[] = { GetTypeIndex(Type::Instance<Ts>())... };
+    uint64 queryMask = 0;
+    if (!GetQueryMask(queryTypeIndices, sizeof...(Ts), queryMask))
+    {
+        return;
+    }
+
+    ++iterationsCount;
+    for (const std::unique_ptr<Archetype>& archetype : archetypes)
+    {
+        if ((archetype->mask & queryMask) == queryMask)
+        {
+            for (const std::unique_ptr<Chunk>& chunk : archetype->chunks)
+            {
+                ProcessChunk<Ts...>(archetype.get(), chunk.get(), queryTypeIndices, fn, std::index_sequence_for<Ts...>());
+            }
+        }
+    }
+    --iterationsCount;
+}
+
+template <typename... Ts, typename Fn>
+void ArchetypeStorage::ParallelForEach(Fn&& fn)
+{
+    static_assert(sizeof...(Ts) > 0, "At least one component or data type should be specified");
+
+    const int32 queryTypeIndices[] = { GetTypeIndex(Type::Instance<Ts>())... };
+    uint64 queryMask = 0;
+    if (!GetQueryMask(queryTypeIndices, sizeof...(Ts), queryMask))
+    {
+        return;
+    }
+
+    Vector<ChunkRef> chunks;
+    CollectChunks(queryMask, chunks);
+
+    ++iterationsCount;
+    ParallelFor(static_cast<uint32>(chunks.size()), [&chunks, &queryTypeIndices, &fn](uint32 index) {
+        ProcessChunk<Ts...>(chunks[index].archetype, chunks[index].chunk, queryTypeIndices, fn, std::index_sequence_for<Ts...>());
+    });
+    --iterationsCount;
+}
+}
@@ -56,4 +56,14 @@ void Component::Deserialize(KeyedArchive* archive, SerializationContext* seriali
 {
     // Do we need this?
 }
+
+bool Component::SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext)
+{
+    return false;
+}
+
+bool Component::LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext)
+{
+    return false;
+}
 }
@@ -159,5 +159,27 @@ uint64 GetFileSize(const String& fileName)
     return std::numeric_limits<uint64>::max();
 }
 
+bool GetFileSizeAndModificationTime(const String& fileName, uint64& size, int64& modificationTime)
+{
+    Stat fileStat;
+
+#ifdef __DAVAENGINE_WINDOWS__
+    WideString p = UTF8Utils::EncodeToWideString(fileName);
+    int32 result = FileStat(p.c_str(), &fileStat);
+#else
+    int32 result = FileStat(fileName.c_str(), &fileStat);
+#endif
+    if (result == 0)
+    {
+        size = static_cast<uint64>(fileStat.st_size);
+        modificationTime = static_cast<int64>(fileStat.st_mtime);
+        return true;
+    }
+
+    LogError(errno, fileName, __FUNCTION__);
+
+    return false;
+}
+
 } // end namespace FileAPI
 } // end namespace DAVA
@@ -42,5 +42,12 @@ bool IsDirectory(const String& dirName);
 	return std::numeric_limits<uint64>::max() on error
 */
 uint64 GetFileSize(const String& fileName);
+
+/**
+	fileName - utf8 string
+	fill size and last modification time (seconds since epoch) of file with one stat call
+	return false on error
+*/
+bool GetFileSizeAndModificationTime(const String& fileName, uint64& size, int64& modificationTime);
 }
 }
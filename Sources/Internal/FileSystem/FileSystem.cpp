@@ -956,7 +956,7 @@ bool FileSystem::ReadFileContents(const FilePath& pathname, Vector<uint8>& buffe
     return true;
 }
 
-void FileSystem::Mount(const FilePath& archiveName, const String& attachPath)
+void FileSystem::Mount(const FilePath& archiveName, const String& attachPath, bool useMemoryMapping)
 {
     DVASSERT(!attachPath.empty());
 
@@ -964,7 +964,7 @@ void FileSystem::Mount(const FilePath& archiveName, const String& attachPath)
     {
         ResourceArchiveItem item;
         item.attachPath = attachPath;
-        item.archive.reset(new ResourceArchive(archiveName));
+        item.archive.reset(new ResourceArchive(archiveName, useMemoryMapping));
         item.archiveFilePath = archiveName;
 
         {
@@ -986,6 +986,17 @@ bool FileSystem::IsMounted(const FilePath& archiveName) const
     return resArchiveMap.find(archiveName.GetBasename()) != end(resArchiveMap);
 }
 
+bool FileSystem::LoadFileViewFromMountedArchive(const FilePath& archiveName, const String& relativeFilePath, ResourceArchive::FileView& view) const
+{
+    LockGuard<Mutex> lock(accessArchiveMap);
+    auto it = resArchiveMap.find(archiveName.GetBasename());
+    if (it == end(resArchiveMap))
+    {
+        return false;
+    }
+    return it->second.archive->LoadFileView(relativeFilePath, view);
+}
+
 int32 FileSystem::Spawn(const String& command)
 {
     int32 retCode = 0;
@@ -223,11 +223,12 @@ public:
 
 		\param[in] archiveName pathname or local filename of archive we want to attach
 		\param[in] attachPath path we attach our archive
+		\param[in] useMemoryMapping read .dvpk archive through memory mapping (see ResourceArchive)
 
         can throw std::runtime_exception in case of error
         thread safe
 	*/
-    virtual void Mount(const FilePath& archiveName, const String& attachPath);
+    virtual void Mount(const FilePath& archiveName, const String& attachPath, bool useMemoryMapping = false);
 
     /**
         \brief Function to detach ResourceArchive from filesystem
@@ -245,6 +246,19 @@ public:
     */
     virtual bool IsMounted(const FilePath& archiveName) const;
 
+    /**
+        \brief Function to load file from mounted ResourceArchive as read-only view
+
+        \param[in] archiveName filename of mounted archive
+        \param[in] relativeFilePath path of file inside archive
+        \param[out] view file content, uncompressed files of memory mapped archives are returned without copy
+        \returns true if file was found and loaded
+
+        view stays valid after archive is unmounted
+        thread safe
+    */
+    bool LoadFileViewFromMountedArchive(const FilePath& archiveName, const String& relativeFilePath, ResourceArchive::FileView& view) const;
+
     /**
 	 \brief Invokes the command processor to execute a command
 	 \param[in] command contains the system command to be executed
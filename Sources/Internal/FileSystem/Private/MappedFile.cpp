@@ -0,0 +1,112 @@
+#include "FileSystem/Private/MappedFile.h"
+#include "FileSystem/FilePath.h"
+#include "Logger/Logger.h"
+
+#if defined(__DAVAENGINE_WIN32__)
+#include "Utils/UTF8Utils.h"
+#include <windows.h>
+#elif defined(__DAVAENGINE_POSIX__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace DAVA
+{
+std::shared_ptr<MappedFile> MappedFile::Open(const FilePath& path)
+{
+    String fileName = path.GetAbsolutePathname();
+    std::shared_ptr<MappedFile> result(new MappedFile());
+
+#if defined(__DAVAENGINE_WIN32__)
+    WideString fileNameWide = UTF8Utils::EncodeToWideString(fileName);
+    HANDLE fileHandle = ::CreateFileW(fileNameWide.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return nullptr;
+    }
+    result->fileHandle = fileHandle;
+
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        return nullptr;
+    }
+
+    HANDLE mappingHandle = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+    {
+        Logger::Error("can't create file mapping for %s: error %u", fileName.c_str(), ::GetLastError());
+        return nullptr;
+    }
+    result->mappingHandle = mappingHandle;
+
+    void* view = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        Logger::Error("can't map view of %s: error %u", fileName.c_str(), ::GetLastError());
+        return nullptr;
+    }
+
+    result->data = static_cast<const uint8*>(view);
+    result->size = static_cast<uint64>(fileSize.QuadPart);
+    return result;
+
+#elif defined(__DAVAENGINE_POSIX__)
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size == 0)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+
+    size_t fileSize = static_cast<size_t>(fileStat.st_size);
+    void* view = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    // mapping keeps its own reference to the file
+    ::close(fd);
+    if (view == MAP_FAILED)
+    {
+        Logger::Error("can't mmap %s: errno %d", fileName.c_str(), errno);
+        return nullptr;
+    }
+
+    result->data = static_cast<const uint8*>(view);
+    result->size = static_cast<uint64>(fileSize);
+    return result;
+
+#else
+    return nullptr;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(__DAVAENGINE_WIN32__)
+    if (data != nullptr)
+    {
+        ::UnmapViewOfFile(data);
+    }
+    if (mappingHandle != nullptr)
+    {
+        ::CloseHandle(mappingHandle);
+    }
+    if (fileHandle != nullptr)
+    {
+        ::CloseHandle(fileHandle);
+    }
+#elif defined(__DAVAENGINE_POSIX__)
+    if (data != nullptr)
+    {
+        ::munmap(const_cast<uint8*>(data), static_cast<size_t>(size));
+    }
+#endif
+}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+class FilePath;
+
+/**
+    Read-only memory mapping of a whole file.
+
+    Mapping is supported for regular files on Win32 and POSIX platforms. Files which can't be mapped
+    (e.g. resources inside Android apk or any path on unsupported platform) make `Open` return nullptr,
+    so callers should fall back to `File` reads.
+    Mapped bytes are never modified, so they can be read from any thread.
+*/
+class MappedFile final
+{
+public:
+    /** Map file, return nullptr on failure. */
+    static std::shared_ptr<MappedFile> Open(const FilePath& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8* GetData() const;
+    uint64 GetSize() const;
+
+private:
+    MappedFile() = default;
+
+    const uint8* data = nullptr;
+    uint64 size = 0;
+#if defined(__DAVAENGINE_WIN32__)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+inline const uint8* MappedFile::GetData() const
+{
+    return data;
+}
+
+inline uint64 MappedFile::GetSize() const
+{
+    return size;
+}
+}
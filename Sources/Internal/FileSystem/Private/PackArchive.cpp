@@ -5,11 +5,24 @@
 #include "Utils/CRC32.h"
 #include "Logger/Logger.h"
 #include "Base/Exception.h"
+#include "Concurrency/LockGuard.h"
+#include "Concurrency/Mutex.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
 
 #include <mutex>
 
 namespace DAVA
 {
+namespace PackArchiveDetails
+{
+// neighbour entries separated by less than this gap are read with one request
+const uint64 MAX_SPAN_GAP = 64 * 1024;
+// spans don't grow above this size, so reading and decompression overlap
+const uint64 MAX_SPAN_SIZE = 4 * 1024 * 1024;
+}
+
 void PackArchive::ExtractFileTableData(const PackFormat::PackFile::FooterBlock& footerBlock,
                                        const Vector<uint8>& tmpBuffer,
                                        String& fileNames,
@@ -86,9 +99,10 @@ void PackArchive::FillFilesInfo(const PackFormat::PackFile& packFile,
                   });
 }
 
-PackArchive::PackArchive(RefPtr<File>& file_, const FilePath& archiveName_)
+PackArchive::PackArchive(RefPtr<File>& file_, const FilePath& archiveName_, std::shared_ptr<MappedFile> mapping_)
     : archiveName(archiveName_)
     , file(file_)
+    , mapping(std::move(mapping_))
 {
     using namespace PackFormat;
 
@@ -214,6 +228,17 @@ bool PackArchive::LoadFile(const String& relativeFilePath, Vector<uint8>& output
     const FileTableEntry& fileEntry = *mapFileData.find(relativeFilePath)->second;
     output.resize(fileEntry.originalSize);
 
+    if (mapping)
+    {
+        // no intermediate buffer: copy or decompress straight from mapped bytes
+        if (!DecompressMapped(fileEntry, relativeFilePath, output.data()))
+        {
+            return false;
+        }
+        CheckCrc32(fileEntry, relativeFilePath, output.data(), output.size());
+        return true;
+    }
+
     if (!file)
     {
         DAVA_THROW(DAVA::Exception, "can't open: " + relativeFilePath + " from pack: " + archiveName.GetStringValue());
@@ -277,14 +302,259 @@ bool PackArchive::LoadFile(const String& relativeFilePath, Vector<uint8>& output
     break;
     } // end switch
 
+    CheckCrc32(fileEntry, relativeFilePath, output.data(), output.size());
+
+    return true;
+}
+
+bool PackArchive::LoadFileView(const String& relativeFilePath, ResourceArchive::FileView& view) const
+{
+    using namespace PackFormat;
+
+    if (!mapping)
+    {
+        return ResourceArchiveImpl::LoadFileView(relativeFilePath, view);
+    }
+
+    auto it = mapFileData.find(relativeFilePath);
+    if (it == mapFileData.end())
+    {
+        return false;
+    }
+
+    const FileTableEntry& fileEntry = *it->second;
+    if (fileEntry.type == Compressor::Type::None)
+    {
+        const uint8* content = GetMappedContent(fileEntry, relativeFilePath);
+        if (content == nullptr)
+        {
+            return false;
+        }
+        CheckCrc32(fileEntry, relativeFilePath, content, fileEntry.originalSize);
+
+        // view shares ownership of the mapping, so archive can be unmounted while view is alive
+        view = ResourceArchive::FileView(mapping, content, fileEntry.originalSize);
+        return true;
+    }
+
+    std::shared_ptr<Vector<uint8>> buffer = std::make_shared<Vector<uint8>>(fileEntry.originalSize);
+    if (!DecompressMapped(fileEntry, relativeFilePath, buffer->data()))
+    {
+        return false;
+    }
+    CheckCrc32(fileEntry, relativeFilePath, buffer->data(), buffer->size());
+
+    const uint8* data = buffer->data();
+    view = ResourceArchive::FileView(std::move(buffer), data, fileEntry.originalSize);
+    return true;
+}
+
+void PackArchive::LoadFiles(const Vector<String>& relativeFilePaths, const ResourceArchive::FileLoadedCallback& callback) const
+{
+    using namespace PackFormat;
+    using namespace PackArchiveDetails;
+
+    struct Request
+    {
+        uint32 index;
+        const FileTableEntry* entry;
+    };
+
+    Vector<Request> requests;
+    requests.reserve(relativeFilePaths.size());
+    for (uint32 i = 0; i < static_cast<uint32>(relativeFilePaths.size()); ++i)
+    {
+        auto it = mapFileData.find(relativeFilePaths[i]);
+        if (it != mapFileData.end())
+        {
+            requests.push_back({ i, it->second });
+        }
+        else
+        {
+            Vector<uint8> empty;
+            callback(i, false, empty);
+        }
+    }
+
+    // read pack front to back
+    std::sort(requests.begin(), requests.end(), [](const Request& l, const Request& r) {
+        return l.entry->startPosition < r.entry->startPosition;
+    });
+
+    Mutex crcErrorLock;
+    String crcError;
+
+    auto processRequest = [&](const Request& request, const uint8* stored) {
+        const FileTableEntry& fileEntry = *request.entry;
+        const String& relativeFilePath = relativeFilePaths[request.index];
+
+        Vector<uint8> content(fileEntry.originalSize);
+        bool loaded = (stored != nullptr) && DecompressEntry(fileEntry, relativeFilePath, stored, content.data());
+        if (loaded)
+        {
+            try
+            {
+                CheckCrc32(fileEntry, relativeFilePath, content.data(), content.size());
+            }
+            catch (const FileCrc32FromPackNotMatch& ex)
+            {
+                LockGuard<Mutex> lock(crcErrorLock);
+                if (crcError.empty())
+                {
+                    crcError = ex.what();
+                }
+                loaded = false;
+            }
+        }
+
+        if (!loaded)
+        {
+            content.clear();
+        }
+        callback(request.index, loaded, content);
+    };
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    Vector<JobHandle> jobs;
+
+    size_t spanBegin = 0;
+    while (spanBegin < requests.size())
+    {
+        // join neighbour entries into one contiguous span
+        uint64 spanStart = requests[spanBegin].entry->startPosition;
+        uint64 spanEnd = spanStart + GetStoredSize(*requests[spanBegin].entry);
+        size_t spanFinish = spanBegin + 1;
+        while (spanFinish < requests.size())
+        {
+            const FileTableEntry& next = *requests[spanFinish].entry;
+            uint64 nextEnd = next.startPosition + GetStoredSize(next);
+            if (next.startPosition > spanEnd + MAX_SPAN_GAP || std::max(spanEnd, nextEnd) - spanStart > MAX_SPAN_SIZE)
+            {
+                break;
+            }
+            spanEnd = std::max(spanEnd, nextEnd);
+            ++spanFinish;
+        }
+
+        // spans of mapped archive are read by decompression itself, otherwise read them here while workers decompress previous ones
+        std::shared_ptr<Vector<uint8>> spanBuffer;
+        const uint8* spanData = nullptr;
+        if (mapping)
+        {
+            if (spanEnd <= mapping->GetSize())
+            {
+                spanData = mapping->GetData() + spanStart;
+            }
+        }
+        else
+        {
+            spanBuffer = std::make_shared<Vector<uint8>>(static_cast<size_t>(spanEnd - spanStart));
+            uint32 spanSize = static_cast<uint32>(spanBuffer->size());
+            if (file && file->Seek(spanStart, File::SEEK_FROM_START) && file->Read(spanBuffer->data(), spanSize) == spanSize)
+            {
+                spanData = spanBuffer->data();
+            }
+        }
+
+        if (spanData == nullptr)
+        {
+            Logger::Error("can't read %u files from pack: %s", static_cast<uint32>(spanFinish - spanBegin), archiveName.GetStringValue().c_str());
+        }
+
+        auto decompressSpan = [&processRequest, &requests, spanBuffer, spanData, spanStart, spanBegin, spanFinish]() {
+            for (size_t i = spanBegin; i < spanFinish; ++i)
+            {
+                const uint8* stored = (spanData != nullptr) ? spanData + (requests[i].entry->startPosition - spanStart) : nullptr;
+                processRequest(requests[i], stored);
+            }
+        };
+
+        if (jobManager != nullptr)
+        {
+            jobs.push_back(jobManager->CreateWorkerJob(decompressSpan));
+        }
+        else
+        {
+            decompressSpan();
+        }
+
+        spanBegin = spanFinish;
+    }
+
+    for (const JobHandle& job : jobs)
+    {
+        jobManager->WaitWorkerJob(job);
+    }
+
+    if (!crcError.empty())
+    {
+        throw FileCrc32FromPackNotMatch(crcError, __FILE__, __LINE__);
+    }
+}
+
+uint64 PackArchive::GetStoredSize(const PackFormat::FileTableEntry& fileEntry)
+{
+    return (fileEntry.type == Compressor::Type::None) ? fileEntry.originalSize : fileEntry.compressedSize;
+}
+
+bool PackArchive::IsMemoryMapped() const
+{
+    return mapping != nullptr;
+}
+
+const uint8* PackArchive::GetMappedContent(const PackFormat::FileTableEntry& fileEntry, const String& relativeFilePath) const
+{
+    uint64 storedSize = GetStoredSize(fileEntry);
+    if (fileEntry.startPosition > mapping->GetSize() || storedSize > mapping->GetSize() - fileEntry.startPosition)
+    {
+        Logger::Error("can't load file: %s course: content is out of mapped pack file", relativeFilePath.c_str());
+        return nullptr;
+    }
+    return mapping->GetData() + fileEntry.startPosition;
+}
+
+bool PackArchive::DecompressMapped(const PackFormat::FileTableEntry& fileEntry, const String& relativeFilePath, uint8* output) const
+{
+    const uint8* content = GetMappedContent(fileEntry, relativeFilePath);
+    if (content == nullptr)
+    {
+        return false;
+    }
+    return DecompressEntry(fileEntry, relativeFilePath, content, output);
+}
+
+bool PackArchive::DecompressEntry(const PackFormat::FileTableEntry& fileEntry, const String& relativeFilePath, const uint8* content, uint8* output) const
+{
+    bool decompressed = true;
+    switch (fileEntry.type)
+    {
+    case Compressor::Type::None:
+        std::copy_n(content, fileEntry.originalSize, output);
+        break;
+    case Compressor::Type::Lz4:
+    case Compressor::Type::Lz4HC:
+        decompressed = LZ4Compressor().Decompress(content, fileEntry.compressedSize, output, fileEntry.originalSize);
+        break;
+    case Compressor::Type::RFC1951:
+        decompressed = ZipCompressor().Decompress(content, fileEntry.compressedSize, output, fileEntry.originalSize);
+        break;
+    }
+
+    if (!decompressed)
+    {
+        Logger::Error("can't load file: %s  course: decompress error", relativeFilePath.c_str());
+    }
+    return decompressed;
+}
+
+void PackArchive::CheckCrc32(const PackFormat::FileTableEntry& fileEntry, const String& relativeFilePath, const uint8* content, size_t size) const
+{
     // check crc32 for file content
-    if (fileEntry.originalCrc32 != 0 && fileEntry.originalCrc32 != CRC32::ForBuffer(output.data(), output.size()))
+    if (fileEntry.originalCrc32 != 0 && fileEntry.originalCrc32 != CRC32::ForBuffer(content, size))
     {
         String msg = "original crc32 not match for: " + relativeFilePath + " during decompress from pack: " + archiveName.GetStringValue();
         throw FileCrc32FromPackNotMatch(msg, __FILE__, __LINE__);
     }
-
-    return true;
 }
 
 uint32 PackArchive::GetFileIndex(const String& releativeFilePath) const
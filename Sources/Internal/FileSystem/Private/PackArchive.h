@@ -3,6 +3,7 @@
 #include "FileSystem/Private/ResourceArchivePrivate.h"
 #include "FileSystem/Private/PackFormatSpec.h"
 #include "FileSystem/Private/PackMetaData.h"
+#include "FileSystem/Private/MappedFile.h"
 #include "FileSystem/File.h"
 
 namespace DAVA
@@ -10,12 +11,19 @@ namespace DAVA
 class PackArchive final : public ResourceArchiveImpl
 {
 public:
-    PackArchive(RefPtr<File>& file_, const FilePath& archiveName);
+    /**
+        If `mapping` is not null files are loaded from memory mapped archive instead of `file_`.
+    */
+    PackArchive(RefPtr<File>& file_, const FilePath& archiveName, std::shared_ptr<MappedFile> mapping = nullptr);
 
     const Vector<ResourceArchive::FileInfo>& GetFilesInfo() const override;
     const ResourceArchive::FileInfo* GetFileInfo(const String& relativeFilePath) const override;
     bool HasFile(const String& relativeFilePath) const override;
     bool LoadFile(const String& relativeFilePath, Vector<uint8>& output) const override;
+    bool LoadFileView(const String& relativeFilePath, ResourceArchive::FileView& view) const override;
+    void LoadFiles(const Vector<String>& relativeFilePaths, const ResourceArchive::FileLoadedCallback& callback) const override;
+
+    bool IsMemoryMapped() const;
 
     /**
 		return index of struct with file info, usefull for meta data
@@ -43,8 +51,15 @@ public:
                               Vector<ResourceArchive::FileInfo>& filesInfo);
 
 private:
+    const uint8* GetMappedContent(const PackFormat::FileTableEntry& fileEntry, const String& relativeFilePath) const;
+    static uint64 GetStoredSize(const PackFormat::FileTableEntry& fileEntry);
+    bool DecompressEntry(const PackFormat::FileTableEntry& fileEntry, const String& relativeFilePath, const uint8* content, uint8* output) const;
+    bool DecompressMapped(const PackFormat::FileTableEntry& fileEntry, const String& relativeFilePath, uint8* output) const;
+    void CheckCrc32(const PackFormat::FileTableEntry& fileEntry, const String& relativeFilePath, const uint8* content, size_t size) const;
+
     const FilePath archiveName;
     mutable RefPtr<File> file;
+    std::shared_ptr<MappedFile> mapping;
     PackFormat::PackFile packFile;
     std::unique_ptr<PackMetaData> packMeta;
     UnorderedMap<String, const PackFormat::FileTableEntry*> mapFileData;
@@ -13,6 +13,31 @@ public:
     virtual const ResourceArchive::FileInfo* GetFileInfo(const String& relativeFilePath) const = 0;
     virtual bool HasFile(const String& relativeFilePath) const = 0;
     virtual bool LoadFile(const String& relativeFilePath, Vector<uint8>& output) const = 0;
+
+    // default implementation loads files one by one on the calling thread
+    virtual void LoadFiles(const Vector<String>& relativeFilePaths, const ResourceArchive::FileLoadedCallback& callback) const
+    {
+        for (uint32 i = 0; i < static_cast<uint32>(relativeFilePaths.size()); ++i)
+        {
+            Vector<uint8> content;
+            bool loaded = LoadFile(relativeFilePaths[i], content);
+            callback(i, loaded, content);
+        }
+    }
+
+    // default implementation loads file into own buffer
+    virtual bool LoadFileView(const String& relativeFilePath, ResourceArchive::FileView& view) const
+    {
+        std::shared_ptr<Vector<uint8>> buffer = std::make_shared<Vector<uint8>>();
+        if (!LoadFile(relativeFilePath, *buffer))
+        {
+            return false;
+        }
+        const uint8* data = buffer->data();
+        uint32 size = static_cast<uint32>(buffer->size());
+        view = ResourceArchive::FileView(std::move(buffer), data, size);
+        return true;
+    }
 };
 
 } // end namespace DAVA
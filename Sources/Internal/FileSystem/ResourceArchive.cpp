@@ -1,11 +1,14 @@
 #include "FileSystem/ResourceArchive.h"
 #include "FileSystem/Private/ZipArchive.h"
 #include "FileSystem/Private/PackArchive.h"
+#include "FileSystem/Private/MappedFile.h"
 #include "FileSystem/File.h"
 #include "FileSystem/FileSystem.h"
 #include "Logger/Logger.h"
 #include "Base/Exception.h"
 
+#include <atomic>
+
 //     +---------------+       +-------------------+
 //     |ResourceArchive+-------+ResourceArchiveImpl|
 //     +---------------+       +-------------------+
@@ -19,7 +22,7 @@
 
 namespace DAVA
 {
-ResourceArchive::ResourceArchive(const FilePath& archiveName)
+ResourceArchive::ResourceArchive(const FilePath& archiveName, bool useMemoryMapping)
 {
     const String& fileName = archiveName.GetAbsolutePathname();
 
@@ -51,7 +54,16 @@ ResourceArchive::ResourceArchive(const FilePath& archiveName)
 
     if (PackFormat::FILE_MARKER == lastFourBytes)
     {
-        impl.reset(new PackArchive(f, fileName));
+        std::shared_ptr<MappedFile> mapping;
+        if (useMemoryMapping)
+        {
+            mapping = MappedFile::Open(archiveName);
+            if (!mapping)
+            {
+                Logger::Warning("can't map resource archive: %s, fall back to file reads", fileName.c_str());
+            }
+        }
+        impl.reset(new PackArchive(f, fileName, mapping));
     }
     else
     {
@@ -97,6 +109,32 @@ bool ResourceArchive::LoadFile(const String& relativeFilePath,
     return impl->LoadFile(relativeFilePath, output);
 }
 
+bool ResourceArchive::LoadFileView(const String& relativeFilePath, FileView& view) const
+{
+    return impl->LoadFileView(relativeFilePath, view);
+}
+
+void ResourceArchive::LoadFiles(const Vector<String>& relativeFilePaths, const FileLoadedCallback& callback) const
+{
+    impl->LoadFiles(relativeFilePaths, callback);
+}
+
+bool ResourceArchive::LoadFiles(const Vector<String>& relativeFilePaths, Vector<Vector<uint8>>& outputs) const
+{
+    outputs.clear();
+    outputs.resize(relativeFilePaths.size());
+
+    std::atomic<bool> allLoaded(true);
+    impl->LoadFiles(relativeFilePaths, [&outputs, &allLoaded](uint32 requestIndex, bool loaded, Vector<uint8>& content) {
+        outputs[requestIndex] = std::move(content);
+        if (!loaded)
+        {
+            allLoaded = false;
+        }
+    });
+    return allLoaded;
+}
+
 bool ResourceArchive::UnpackToFolder(const FilePath& dir) const
 {
     Vector<uint8> content;
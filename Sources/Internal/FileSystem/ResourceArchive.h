@@ -2,6 +2,7 @@
 
 #include "Compression/Compressor.h"
 #include "Base/Exception.h"
+#include "Functional/Function.h"
 
 namespace DAVA
 {
@@ -23,7 +24,41 @@ class FilePath;
 class ResourceArchive final
 {
 public:
-    explicit ResourceArchive(const FilePath& filePath);
+    /**
+        Read-only view of file content loaded from archive.
+
+        For memory mapped .dvpk archives uncompressed files point directly into the mapping without any copy,
+        otherwise view owns buffer with decompressed content. View keeps its memory alive by itself,
+        so it stays valid after archive is destroyed or unmounted.
+    */
+    class FileView final
+    {
+    public:
+        FileView() = default;
+        FileView(std::shared_ptr<const void> owner, const uint8* data, uint32 size);
+
+        const uint8* GetData() const;
+        uint32 GetSize() const;
+        bool IsEmpty() const;
+
+        const uint8* begin() const;
+        const uint8* end() const;
+
+        void Reset();
+
+    private:
+        std::shared_ptr<const void> owner;
+        const uint8* data = nullptr;
+        uint32 size = 0;
+    };
+
+    /**
+        Open archive. If `useMemoryMapping` is true and archive is .dvpk file which can be memory mapped,
+        files are read from the mapping: compressed files are decompressed straight from mapped bytes
+        and `LoadFileView` returns uncompressed files without copy.
+        Loading from mapped archive doesn't touch shared file handle, so it is thread safe.
+    */
+    explicit ResourceArchive(const FilePath& filePath, bool useMemoryMapping = false);
     ~ResourceArchive();
 
     struct FileInfo
@@ -44,9 +79,73 @@ public:
     bool HasFile(const String& relativeFilePath) const;
     bool LoadFile(const String& relativeFilePath, Vector<uint8>& outputFileContent) const;
 
+    /**
+        Load file content as read-only view, return false if file not found or can't be loaded.
+        Can throw FileCrc32FromPackNotMatch same as `LoadFile`.
+    */
+    bool LoadFileView(const String& relativeFilePath, FileView& view) const;
+
+    /**
+        Called once per file requested from `LoadFiles`, can be called from several JobManager workers concurrently.
+        `content` is empty if file wasn't loaded, otherwise it can be moved out.
+    */
+    using FileLoadedCallback = Function<void(uint32 requestIndex, bool loaded, Vector<uint8>& content)>;
+
+    /**
+        Load several files at once and return when all of them are processed.
+        For .dvpk archives requests are sorted by position in pack, neighbour files are read with one contiguous read
+        and decompressed on JobManager workers while next spans are being read.
+        Can throw FileCrc32FromPackNotMatch after all files are processed.
+    */
+    void LoadFiles(const Vector<String>& relativeFilePaths, const FileLoadedCallback& callback) const;
+
+    /**
+        Same as above, `outputs[i]` receives content of `relativeFilePaths[i]`. Return true if all files were loaded.
+    */
+    bool LoadFiles(const Vector<String>& relativeFilePaths, Vector<Vector<uint8>>& outputs) const;
+
     bool UnpackToFolder(const FilePath& dir) const;
 
 private:
     std::unique_ptr<ResourceArchiveImpl> impl;
 };
+
+inline ResourceArchive::FileView::FileView(std::shared_ptr<const void> owner_, const uint8* data_, uint32 size_)
+    : owner(std::move(owner_))
+    , data(data_)
+    , size(size_)
+{
+}
+
+inline const uint8* ResourceArchive::FileView::GetData() const
+{
+    return data;
+}
+
+inline uint32 ResourceArchive::FileView::GetSize() const
+{
+    return size;
+}
+
+inline bool ResourceArchive::FileView::IsEmpty() const
+{
+    return size == 0;
+}
+
+inline const uint8* ResourceArchive::FileView::begin() const
+{
+    return data;
+}
+
+inline const uint8* ResourceArchive::FileView::end() const
+{
+    return data + size;
+}
+
+inline void ResourceArchive::FileView::Reset()
+{
+    owner.reset();
+    data = nullptr;
+    size = 0;
+}
 } // end namespace DAVA
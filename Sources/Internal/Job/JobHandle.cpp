@@ -0,0 +1,73 @@
+#include "Job/JobHandle.h"
+#include "Job/Private/WorkerJob.h"
+
+namespace DAVA
+{
+JobHandle::JobHandle(JobDetails::WorkerJob* job_)
+    : job(job_)
+{
+    if (job != nullptr)
+    {
+        job->Retain();
+    }
+}
+
+JobHandle::JobHandle(const JobHandle& other)
+    : job(other.job)
+{
+    if (job != nullptr)
+    {
+        job->Retain();
+    }
+}
+
+JobHandle::JobHandle(JobHandle&& other)
+    : job(other.job)
+{
+    other.job = nullptr;
+}
+
+JobHandle::~JobHandle()
+{
+    if (job != nullptr)
+    {
+        job->Release();
+    }
+}
+
+JobHandle& JobHandle::operator=(const JobHandle& other)
+{
+    if (this != &other)
+    {
+        if (other.job != nullptr)
+        {
+            other.job->Retain();
+        }
+        if (job != nullptr)
+        {
+            job->Release();
+        }
+        job = other.job;
+    }
+    return *this;
+}
+
+JobHandle& JobHandle::operator=(JobHandle&& other)
+{
+    if (this != &other)
+    {
+        if (job != nullptr)
+        {
+            job->Release();
+        }
+        job = other.job;
+        other.job = nullptr;
+    }
+    return *this;
+}
+
+bool JobHandle::IsFinished() const
+{
+    return (job == nullptr) || job->IsFinished();
+}
+}
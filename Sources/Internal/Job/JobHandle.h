@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+namespace JobDetails
+{
+struct WorkerJob;
+}
+
+/**
+    Handle of the worker job created by JobManager.
+
+    Handle keeps job's bookkeeping data alive, so it can be safely queried, waited for
+    (see `JobManager::WaitWorkerJob`) or used as dependency or parent of other jobs
+    even after the job has been finished.
+
+    Default constructed handle is invalid and is treated as already finished job.
+*/
+class JobHandle final
+{
+public:
+    JobHandle() = default;
+    JobHandle(const JobHandle& other);
+    JobHandle(JobHandle&& other);
+    ~JobHandle();
+
+    JobHandle& operator=(const JobHandle& other);
+    JobHandle& operator=(JobHandle&& other);
+
+    /** Return true if handle refers to a job. */
+    bool IsValid() const;
+
+    /** Return true if job and all of its children have been executed. Invalid handle is always finished. */
+    bool IsFinished() const;
+
+    bool operator==(const JobHandle& other) const;
+    bool operator!=(const JobHandle& other) const;
+
+private:
+    friend class JobManager;
+    explicit JobHandle(JobDetails::WorkerJob* job);
+
+    JobDetails::WorkerJob* job = nullptr;
+};
+
+inline bool JobHandle::IsValid() const
+{
+    return job != nullptr;
+}
+
+inline bool JobHandle::operator==(const JobHandle& other) const
+{
+    return job == other.job;
+}
+
+inline bool JobHandle::operator!=(const JobHandle& other) const
+{
+    return job != other.job;
+}
+}
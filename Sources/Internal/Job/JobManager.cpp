@@ -5,12 +5,27 @@
 #include "Debug/ProfilerMarkerNames.h"
 #include "Engine/Engine.h"
 #include "Concurrency/LockGuard.h"
+#include "Concurrency/ThreadLocalPtr.h"
 #include "Concurrency/UniqueLock.h"
 #include "Job/JobThread.h"
+#include "Job/Private/WorkerJob.h"
 #include "Platform/DeviceInfo.h"
 
 namespace DAVA
 {
+namespace JobManagerDetails
+{
+// how many times idle worker yields before going to sleep
+const uint32 WORKER_SPIN_COUNT = 64;
+
+void KeepWorker(JobThread*)
+{
+}
+
+// worker thread the current thread is, nullptr for non-worker threads
+ThreadLocalPtr<JobThread> currentWorker(&KeepWorker);
+}
+
 JobManager::JobManager(Engine* e)
     : engine(e)
     , mainJobIDCounter(1)
@@ -22,10 +37,16 @@ JobManager::JobManager(Engine* e)
 
     for (uint32 i = 0; i < cpuCoresCount; ++i)
     {
-        JobThread* thread = new JobThread(&workerQueue, &workerDoneSem);
+        JobThread* thread = new JobThread(this, i);
         workerThreads.push_back(thread);
     }
 
+    // start threads only when all of them are created: workers steal from each other
+    for (JobThread* thread : workerThreads)
+    {
+        thread->Start();
+    }
+
     e->update.Connect(this, &JobManager::Update);
 }
 
@@ -41,12 +62,26 @@ JobManager::~JobManager()
     mainJobIDCounter = 0;
     mainCV.NotifyAll();
 
+    workersCancel = true;
+    {
+        LockGuard<Mutex> guard(workerSleepMutex);
+        workerSleepCV.NotifyAll();
+    }
+
     for (uint32 i = 0; i < workerThreads.size(); ++i)
     {
         SafeDelete(workerThreads[i]);
     }
 
     workerThreads.clear();
+
+    // drop jobs that were not executed
+    LockGuard<Mutex> guard(injectedJobsMutex);
+    for (JobDetails::WorkerJob* job : injectedJobs)
+    {
+        job->Release();
+    }
+    injectedJobs.clear();
 }
 
 void JobManager::Update(float32 /*frameDelta*/)
@@ -235,17 +270,191 @@ bool JobManager::HasMainJobID(uint32 mainJobID)
     return (mainJobID > mainJobLastExecutedID);
 }
 
-void JobManager::CreateWorkerJob(const Function<void()>& fn)
+JobHandle JobManager::CreateWorkerJob(const Function<void()>& fn)
 {
-    workerQueue.Push(fn);
-    workerQueue.Signal();
+    return CreateWorkerJobImpl(fn, nullptr, nullptr, 0);
 }
 
-void JobManager::WaitWorkerJobs()
+JobHandle JobManager::CreateWorkerJob(const Function<void()>& fn, const JobHandle& dependency)
+{
+    return CreateWorkerJobImpl(fn, nullptr, &dependency, 1);
+}
+
+JobHandle JobManager::CreateWorkerJob(const Function<void()>& fn, const Vector<JobHandle>& dependencies)
+{
+    return CreateWorkerJobImpl(fn, nullptr, dependencies.data(), dependencies.size());
+}
+
+JobHandle JobManager::CreateChildWorkerJob(const JobHandle& parent, const Function<void()>& fn)
+{
+    return CreateWorkerJobImpl(fn, parent.job, nullptr, 0);
+}
+
+JobHandle JobManager::CreateWorkerJobImpl(const Function<void()>& fn, JobDetails::WorkerJob* parent, const JobHandle* dependencies, size_t dependenciesCount)
+{
+    JobDetails::WorkerJob* job = new JobDetails::WorkerJob();
+    job->fn = fn;
+
+    if (parent != nullptr)
+    {
+        DVASSERT(!parent->IsFinished() && "Child job can be added only to unfinished parent");
+        parent->unfinishedCount.fetch_add(1, std::memory_order_relaxed);
+        job->parent = parent;
+    }
+
+    unfinishedJobsCount++;
+    JobHandle handle(job);
+
+    // extra dependency guards job from being scheduled until all real dependencies are registered
+    job->pendingDependencies.store(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < dependenciesCount; ++i)
+    {
+        JobDetails::WorkerJob* dependency = dependencies[i].job;
+        if (dependency != nullptr)
+        {
+            LockGuard<Spinlock> guard(dependency->continuationsLock);
+            if (!dependency->finished)
+            {
+                job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+                dependency->continuations.push_back(job);
+            }
+        }
+    }
+
+    if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        Schedule(job);
+    }
+
+    return handle;
+}
+
+void JobManager::Schedule(JobDetails::WorkerJob* job)
+{
+    queuedJobsCount++;
+
+    JobThread* worker = JobManagerDetails::currentWorker.Get();
+    if (worker != nullptr && worker->GetWorkerIndex() < workerThreads.size() && workerThreads[worker->GetWorkerIndex()] == worker)
+    {
+        worker->GetDeque().Push(job);
+    }
+    else
+    {
+        LockGuard<Mutex> guard(injectedJobsMutex);
+        injectedJobs.push_back(job);
+    }
+
+    if (sleepingWorkersCount > 0)
+    {
+        LockGuard<Mutex> guard(workerSleepMutex);
+        workerSleepCV.NotifyOne();
+    }
+}
+
+void JobManager::ExecuteJob(JobDetails::WorkerJob* job)
+{
+    if (job->fn != nullptr)
+    {
+        job->fn();
+        job->fn = nullptr;
+    }
+
+    FinishJob(job);
+}
+
+void JobManager::FinishJob(JobDetails::WorkerJob* job)
+{
+    if (job->unfinishedCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        // some children are still running, last of them will finish this job
+        return;
+    }
+
+    Vector<JobDetails::WorkerJob*> continuations;
+    {
+        LockGuard<Spinlock> guard(job->continuationsLock);
+        job->finished = true;
+        continuations.swap(job->continuations);
+    }
+
+    for (JobDetails::WorkerJob* continuation : continuations)
+    {
+        if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            Schedule(continuation);
+        }
+    }
+
+    JobDetails::WorkerJob* parent = job->parent;
+    job->Release();
+
+    unfinishedJobsCount--;
+    if (waitingThreadsCount > 0)
+    {
+        LockGuard<Mutex> guard(jobFinishedMutex);
+        jobFinishedCV.NotifyAll();
+    }
+    if (mainThreadWaiting)
+    {
+        workerDoneSem.Post();
+    }
+
+    if (parent != nullptr)
+    {
+        FinishJob(parent);
+    }
+}
+
+JobDetails::WorkerJob* JobManager::FindJob(JobThread* worker)
 {
-    while (HasWorkerJobs())
+    JobDetails::WorkerJob* job = nullptr;
+
+    if (worker != nullptr)
     {
-        if (Thread::IsMainThread())
+        job = worker->GetDeque().Pop();
+    }
+
+    if (job == nullptr)
+    {
+        LockGuard<Mutex> guard(injectedJobsMutex);
+        if (!injectedJobs.empty())
+        {
+            job = injectedJobs.front();
+            injectedJobs.pop_front();
+        }
+    }
+
+    if (job == nullptr && !workerThreads.empty())
+    {
+        size_t count = workerThreads.size();
+        size_t start = (worker != nullptr) ? worker->NextRandom() : stealCounter++;
+        for (size_t i = 0; i < count && job == nullptr; ++i)
+        {
+            JobThread* victim = workerThreads[(start + i) % count];
+            if (victim != worker)
+            {
+                job = victim->GetDeque().Steal();
+            }
+        }
+    }
+
+    if (job != nullptr)
+    {
+        queuedJobsCount--;
+    }
+
+    return job;
+}
+
+template <typename Predicate>
+void JobManager::WaitUntil(Predicate isDone)
+{
+    JobThread* worker = JobManagerDetails::currentWorker.Get();
+    bool isMainThread = Thread::IsMainThread();
+
+    while (!isDone())
+    {
+        if (isMainThread)
         {
             // We want to be able to wait worker jobs, but at the same time
             // allow any worker job execute main job. Potentially this will cause
@@ -258,12 +467,126 @@ void JobManager::WaitWorkerJobs()
             Update();
         }
 
-        workerDoneSem.Wait();
+        // help workers instead of sleeping
+        JobDetails::WorkerJob* job = FindJob(worker);
+        if (job != nullptr)
+        {
+            ExecuteJob(job);
+        }
+        else if (worker != nullptr)
+        {
+            // jobs we are waiting for are executed by other workers right now
+            Thread::Yield();
+        }
+        else if (isMainThread)
+        {
+            mainThreadWaiting = true;
+            if (!isDone())
+            {
+                workerDoneSem.Wait();
+            }
+            mainThreadWaiting = false;
+        }
+        else
+        {
+            UniqueLock<Mutex> lock(jobFinishedMutex);
+            waitingThreadsCount++;
+            if (!isDone() && queuedJobsCount == 0)
+            {
+                jobFinishedCV.Wait(lock);
+            }
+            waitingThreadsCount--;
+        }
     }
 }
 
+void JobManager::WaitWorkerJob(const JobHandle& handle)
+{
+    WaitUntil([&handle]() { return handle.IsFinished(); });
+}
+
+void JobManager::WaitWorkerJobs()
+{
+    WaitUntil([this]() { return unfinishedJobsCount == 0; });
+}
+
 bool JobManager::HasWorkerJobs()
 {
-    return !workerQueue.IsEmpty();
+    return unfinishedJobsCount > 0;
+}
+
+void JobManager::ParallelFor(uint32 begin, uint32 end, uint32 grainSize, const Function<void(uint32, uint32)>& fn)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    grainSize = std::max(grainSize, 1u);
+    if (workerThreads.empty() || (end - begin) <= grainSize)
+    {
+        fn(begin, end);
+        return;
+    }
+
+    // Root job isn't scheduled: calling thread splits the range and executes leftmost chunk itself,
+    // all other chunks are children of the root, so waiting for the root waits for the whole range.
+    JobDetails::WorkerJob* root = new JobDetails::WorkerJob();
+    unfinishedJobsCount++;
+    JobHandle rootHandle(root);
+
+    ParallelForRange(root, begin, end, grainSize, fn);
+    FinishJob(root);
+
+    WaitWorkerJob(rootHandle);
+}
+
+void JobManager::ParallelForRange(JobDetails::WorkerJob* root, uint32 begin, uint32 end, uint32 grainSize, const Function<void(uint32, uint32)>& fn)
+{
+    while ((end - begin) > grainSize)
+    {
+        uint32 middle = begin + (end - begin) / 2;
+        CreateWorkerJobImpl([this, root, middle, end, grainSize, &fn]() {
+            ParallelForRange(root, middle, end, grainSize, fn);
+        },
+                            root, nullptr, 0);
+        end = middle;
+    }
+
+    fn(begin, end);
+}
+
+void JobManager::WorkerThreadFunc(JobThread* worker)
+{
+    JobManagerDetails::currentWorker.Reset(worker);
+
+    uint32 spinCount = 0;
+    while (!workersCancel)
+    {
+        JobDetails::WorkerJob* job = FindJob(worker);
+        if (job != nullptr)
+        {
+            ExecuteJob(job);
+            spinCount = 0;
+        }
+        else if (++spinCount < JobManagerDetails::WORKER_SPIN_COUNT)
+        {
+            Thread::Yield();
+        }
+        else
+        {
+            spinCount = 0;
+
+            UniqueLock<Mutex> lock(workerSleepMutex);
+            sleepingWorkersCount++;
+            if (queuedJobsCount == 0 && !workersCancel)
+            {
+                workerSleepCV.Wait(lock);
+            }
+            sleepingWorkersCount--;
+        }
+    }
+
+    JobManagerDetails::currentWorker.Reset(nullptr);
 }
 }
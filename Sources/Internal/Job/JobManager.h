@@ -2,11 +2,14 @@
 
 #include "Base/BaseTypes.h"
 #include "Concurrency/Atomic.h"
+#include "Concurrency/ConditionVariable.h"
 #include "Concurrency/Mutex.h"
 #include "Concurrency/Semaphore.h"
 #include "Concurrency/Thread.h"
 #include "Functional/Function.h"
-#include "Job/JobQueue.h"
+#include "Job/JobHandle.h"
+
+#include <atomic>
 
 namespace DAVA
 {
@@ -59,8 +62,30 @@ public:
 
     /*! Add function to execute in the worker-thread.
 		\param [in] fn Function to execute.
+		\return Handle of created job. It can be used to wait for this job or as dependency/parent of other jobs.
+	*/
+    JobHandle CreateWorkerJob(const Function<void()>& fn);
+
+    /*! Add function to execute in the worker-thread after `dependency` job (and all of its children) is finished.
+		\param [in] fn Function to execute.
+		\param [in] dependency Job that should be finished before `fn` is started. Invalid handle means no dependency.
+	*/
+    JobHandle CreateWorkerJob(const Function<void()>& fn, const JobHandle& dependency);
+
+    /*! Add function to execute in the worker-thread after all `dependencies` are finished. */
+    JobHandle CreateWorkerJob(const Function<void()>& fn, const Vector<JobHandle>& dependencies);
+
+    /*! Add function to execute in the worker-thread as child of `parent` job.
+        Parent job is treated as finished only when all of its children are finished.
+        Should be called while parent is still unfinished, usually from parent's function.
+	*/
+    JobHandle CreateChildWorkerJob(const JobHandle& parent, const Function<void()>& fn);
+
+    /*! Wait until job referenced by `handle` and all of its children are executed.
+        Waiting thread helps executing worker jobs meanwhile. If it is the main thread,
+        main-thread jobs are processed as well, so worker job can safely wait for main jobs.
 	*/
-    void CreateWorkerJob(const Function<void()>& fn);
+    void WaitWorkerJob(const JobHandle& handle);
 
     /*! Wait until all worker-thread jobs are executed. */
     void WaitWorkerJobs();
@@ -70,6 +95,12 @@ public:
 	*/
     bool HasWorkerJobs();
 
+    /*! Split range [begin, end) into chunks of at least `grainSize` elements and call `fn(chunkBegin, chunkEnd)`
+        for every chunk on worker threads. Calling thread participates in execution and returns when whole range is processed.
+        Range is split recursively, so idle workers steal big halves instead of contending for small chunks.
+	*/
+    void ParallelFor(uint32 begin, uint32 end, uint32 grainSize, const Function<void(uint32, uint32)>& fn);
+
 protected:
     struct MainJob
     {
@@ -98,7 +129,39 @@ protected:
     MainJob curMainJob;
 
     Semaphore workerDoneSem;
-    JobQueueWorker workerQueue;
     Vector<JobThread*> workerThreads;
+
+private:
+    friend class JobThread;
+
+    JobHandle CreateWorkerJobImpl(const Function<void()>& fn, JobDetails::WorkerJob* parent, const JobHandle* dependencies, size_t dependenciesCount);
+    void Schedule(JobDetails::WorkerJob* job);
+    void ExecuteJob(JobDetails::WorkerJob* job);
+    void FinishJob(JobDetails::WorkerJob* job);
+    JobDetails::WorkerJob* FindJob(JobThread* worker);
+    template <typename Predicate>
+    void WaitUntil(Predicate isDone);
+    void ParallelForRange(JobDetails::WorkerJob* root, uint32 begin, uint32 end, uint32 grainSize, const Function<void(uint32, uint32)>& fn);
+    void WorkerThreadFunc(JobThread* worker);
+
+    // jobs created from non-worker threads, workers grab them together with stealing
+    Mutex injectedJobsMutex;
+    Deque<JobDetails::WorkerJob*> injectedJobs;
+
+    // sleeping workers are woken when new jobs are scheduled
+    Mutex workerSleepMutex;
+    ConditionVariable workerSleepCV;
+    std::atomic<int32> sleepingWorkersCount{ 0 };
+
+    // threads blocked in WaitUntil are woken when any job is finished
+    Mutex jobFinishedMutex;
+    ConditionVariable jobFinishedCV;
+    std::atomic<int32> waitingThreadsCount{ 0 };
+    std::atomic<bool> mainThreadWaiting{ false };
+
+    std::atomic<int32> queuedJobsCount{ 0 }; // scheduled, but not yet taken for execution
+    std::atomic<int32> unfinishedJobsCount{ 0 }; // created, but not yet finished
+    std::atomic<uint32> stealCounter{ 0 };
+    std::atomic<bool> workersCancel{ false };
 };
 }
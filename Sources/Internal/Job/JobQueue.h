@@ -8,6 +8,10 @@
 
 namespace DAVA
 {
+/**
+    Legacy fixed-size worker queue guarded by a single spinlock.
+    JobManager uses per-thread work-stealing deques instead, this class is kept for comparison benchmarks.
+*/
 class JobQueueWorker
 {
 public:
@@ -1,48 +1,37 @@
-#include "JobThread.h"
+#include "Job/JobThread.h"
+#include "Job/JobManager.h"
 
 namespace DAVA
 {
-JobThread::JobThread(JobQueueWorker* _workerQueue, Semaphore* _workerDoneSem)
-    : workerQueue(_workerQueue)
-    , workerDoneSem(_workerDoneSem)
-    , threadCancel(false)
-    , threadFinished(false)
+JobThread::JobThread(JobManager* jobManager_, uint32 workerIndex_)
+    : jobManager(jobManager_)
+    , workerIndex(workerIndex_)
+    , randomState(0x9E3779B9u * (workerIndex_ + 1))
 {
     thread = Thread::Create(MakeFunction(this, &JobThread::ThreadFunc));
     thread->SetName("DAVA::JobThread");
-    thread->Start();
 }
 
 JobThread::~JobThread()
 {
-    // cancel thread
-    threadCancel = true;
-    while (!threadFinished)
-    {
-        workerQueue->Broadcast();
-        Thread::Sleep(10); // sleep 10 ms until other check
-    }
-
-    // join and release thread
+    // JobManager should have already requested cancel and woken all workers
     thread->Join();
     SafeRelease(thread);
-}
 
-void JobThread::ThreadFunc()
-{
-    while (!threadCancel)
+    // drop jobs that were not executed
+    while (JobDetails::WorkerJob* job = deque.Pop())
     {
-        workerQueue->Wait();
-
-        while (workerQueue->PopAndExec())
-        {
-        }
-
-        workerDoneSem->Post();
+        job->Release();
     }
+}
 
-    threadFinished = true;
+void JobThread::Start()
+{
+    thread->Start();
 }
 
-};
-;
\ No newline at end of file
+void JobThread::ThreadFunc()
+{
+    jobManager->WorkerThreadFunc(this);
+}
+}
@@ -1,26 +1,54 @@
 #pragma once
 
-#include "Concurrency/Semaphore.h"
 #include "Concurrency/Thread.h"
-#include "JobQueue.h"
+#include "Job/Private/WorkStealingDeque.h"
+#include "Job/Private/WorkerJob.h"
 
 namespace DAVA
 {
+class JobManager;
 class JobThread
 {
 public:
-    JobThread(JobQueueWorker* workerQueue, Semaphore* workerDoneSem);
+    JobThread(JobManager* jobManager, uint32 workerIndex);
     ~JobThread();
 
-    void Cancel();
+    void Start();
+
+    uint32 GetWorkerIndex() const;
+
+    /** Deque of jobs spawned by this worker. `Push` and `Pop` may be called only from the worker thread itself. */
+    JobDetails::WorkStealingDeque<JobDetails::WorkerJob*>& GetDeque();
+
+    /** Return next pseudo-random number, used to pick steal victims. */
+    uint32 NextRandom();
 
 protected:
     Thread* thread;
-    JobQueueWorker* workerQueue;
-    Semaphore* workerDoneSem;
-    volatile bool threadCancel;
-    volatile bool threadFinished;
+    JobManager* jobManager;
+    uint32 workerIndex;
+    uint32 randomState;
+    JobDetails::WorkStealingDeque<JobDetails::WorkerJob*> deque;
 
     void ThreadFunc();
 };
+
+inline uint32 JobThread::GetWorkerIndex() const
+{
+    return workerIndex;
+}
+
+inline JobDetails::WorkStealingDeque<JobDetails::WorkerJob*>& JobThread::GetDeque()
+{
+    return deque;
+}
+
+inline uint32 JobThread::NextRandom()
+{
+    // xorshift32
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
 }
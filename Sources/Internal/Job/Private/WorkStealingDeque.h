@@ -0,0 +1,203 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Debug/DVAssert.h"
+#include "Math/MathHelpers.h"
+
+#include <atomic>
+
+namespace DAVA
+{
+namespace JobDetails
+{
+/**
+    Chase-Lev work-stealing deque of pointers.
+
+    Only the owner thread may call `Push` and `Pop` - both work on the bottom end of the deque without locks.
+    Any other thread may call `Steal`, which takes items from the top end with a single CAS.
+    Storage grows when it gets full; retired buffers are kept until the deque is destroyed,
+    because a concurrent thief may still read from them.
+
+    Implementation follows "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Nardelli).
+*/
+template <typename T>
+class WorkStealingDeque final
+{
+    static_assert(std::is_pointer<T>::value, "WorkStealingDeque can hold only pointers");
+
+public:
+    explicit WorkStealingDeque(uint32 initialCapacity = 1024);
+    ~WorkStealingDeque();
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /** Push item to the bottom of the deque. Owner thread only. */
+    void Push(T item);
+
+    /** Pop item from the bottom of the deque. Owner thread only. Returns nullptr if deque is empty. */
+    T Pop();
+
+    /** Steal item from the top of the deque. Can be called from any thread. Returns nullptr if deque is empty or race was lost. */
+    T Steal();
+
+    /** Return approximate count of items in the deque. */
+    int64 GetApproximateSize() const;
+
+private:
+    struct Buffer
+    {
+        Buffer(int64 capacity_)
+            : capacity(capacity_)
+            , mask(capacity_ - 1)
+            , items(new std::atomic<T>[static_cast<size_t>(capacity_)])
+        {
+        }
+
+        ~Buffer()
+        {
+            delete[] items;
+        }
+
+        T Get(int64 index) const
+        {
+            return items[index & mask].load(std::memory_order_relaxed);
+        }
+
+        void Put(int64 index, T item)
+        {
+            items[index & mask].store(item, std::memory_order_relaxed);
+        }
+
+        int64 capacity;
+        int64 mask;
+        std::atomic<T>* items;
+    };
+
+    Buffer* Grow(Buffer* buffer, int64 bottomIndex, int64 topIndex);
+
+    // top and bottom are padded to different cache lines, so thieves don't invalidate line of owner's index.
+    // Padding is used instead of alignas: deque lives in heap objects, and over-aligned new isn't supported before C++17.
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    uint8 topPadding[CACHE_LINE_SIZE];
+    std::atomic<int64> top;
+    uint8 bottomPadding[CACHE_LINE_SIZE - sizeof(std::atomic<int64>)];
+    std::atomic<int64> bottom;
+    uint8 bufferPadding[CACHE_LINE_SIZE - sizeof(std::atomic<int64>)];
+    std::atomic<Buffer*> buffer;
+    Vector<Buffer*> retiredBuffers;
+};
+
+template <typename T>
+WorkStealingDeque<T>::WorkStealingDeque(uint32 initialCapacity)
+    : top(0)
+    , bottom(0)
+{
+    DVASSERT(IsPowerOf2(initialCapacity) && "Capacity of WorkStealingDeque should be pow of two");
+    buffer.store(new Buffer(initialCapacity), std::memory_order_relaxed);
+}
+
+template <typename T>
+WorkStealingDeque<T>::~WorkStealingDeque()
+{
+    delete buffer.load(std::memory_order_relaxed);
+    for (Buffer* b : retiredBuffers)
+    {
+        delete b;
+    }
+}
+
+template <typename T>
+void WorkStealingDeque<T>::Push(T item)
+{
+    int64 b = bottom.load(std::memory_order_relaxed);
+    int64 t = top.load(std::memory_order_acquire);
+    Buffer* a = buffer.load(std::memory_order_relaxed);
+
+    if (b - t > a->capacity - 1)
+    {
+        a = Grow(a, b, t);
+    }
+
+    a->Put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+template <typename T>
+T WorkStealingDeque<T>::Pop()
+{
+    int64 b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* a = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64 t = top.load(std::memory_order_relaxed);
+
+    T item = nullptr;
+    if (t <= b)
+    {
+        item = a->Get(b);
+        if (t == b)
+        {
+            // last item: race with thieves
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    return item;
+}
+
+template <typename T>
+T WorkStealingDeque<T>::Steal()
+{
+    int64 t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64 b = bottom.load(std::memory_order_acquire);
+
+    T item = nullptr;
+    if (t < b)
+    {
+        Buffer* a = buffer.load(std::memory_order_acquire);
+        item = a->Get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+    }
+
+    return item;
+}
+
+template <typename T>
+int64 WorkStealingDeque<T>::GetApproximateSize() const
+{
+    int64 b = bottom.load(std::memory_order_relaxed);
+    int64 t = top.load(std::memory_order_relaxed);
+    return (b > t) ? (b - t) : 0;
+}
+
+template <typename T>
+typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::Grow(Buffer* a, int64 b, int64 t)
+{
+    Buffer* newBuffer = new Buffer(a->capacity * 2);
+    for (int64 i = t; i < b; ++i)
+    {
+        newBuffer->Put(i, a->Get(i));
+    }
+
+    retiredBuffers.push_back(a);
+    buffer.store(newBuffer, std::memory_order_release);
+    return newBuffer;
+}
+
+} // namespace JobDetails
+} // namespace DAVA
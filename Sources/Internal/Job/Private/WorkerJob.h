@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Concurrency/LockGuard.h"
+#include "Concurrency/Spinlock.h"
+#include "Functional/Function.h"
+
+#include <atomic>
+
+namespace DAVA
+{
+namespace JobDetails
+{
+/**
+    Bookkeeping data of a single worker job.
+
+    `unfinishedCount` counts the job itself plus all of its unfinished children, job is finished when it drops to zero.
+    `pendingDependencies` counts unfinished jobs this job waits for, job is scheduled when it drops to zero.
+    Lifetime is controlled by intrusive `refCount`: one reference is held by scheduler until job is finished,
+    and one by every JobHandle.
+*/
+struct WorkerJob
+{
+    Function<void()> fn;
+    WorkerJob* parent = nullptr;
+
+    std::atomic<int32> refCount{ 1 };
+    std::atomic<int32> unfinishedCount{ 1 };
+    std::atomic<int32> pendingDependencies{ 0 };
+
+    Spinlock continuationsLock;
+    Vector<WorkerJob*> continuations;
+    bool finished = false; // guarded by continuationsLock
+
+    void Retain()
+    {
+        refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Release()
+    {
+        if (refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    bool IsFinished() const
+    {
+        return unfinishedCount.load(std::memory_order_acquire) == 0;
+    }
+};
+
+} // namespace JobDetails
+} // namespace DAVA
@@ -35,6 +35,9 @@ public:
     bool AddTransport(eTransportType type, const Endpoint& endpoint);
     bool AddService(uint32 serviceId);
 
+    // Max bytes of frames that are passed to transport in one write, at least one frame is passed anyway
+    void SetSendBudget(size_t bytes);
+
     eNetworkRole Role() const
     {
         return role;
@@ -48,11 +51,16 @@ public:
     {
         return services;
     }
+    size_t SendBudget() const
+    {
+        return sendBudget;
+    }
 
 private:
     eNetworkRole role;
     Vector<TransportConfig> transports;
     Vector<uint32> services;
+    size_t sendBudget = DEFAULT_SEND_BUDGET;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -26,7 +26,8 @@ enum eMiscConst
     // Increase read timeout when memory profiling enabled to reduce connection breaks on timeout
     DEFAULT_READ_TIMEOUT = 120 * 1000,
 #endif
-    DEFAULT_ANNOUNCE_TIME_PERIOD_SEC = 5
+    DEFAULT_ANNOUNCE_TIME_PERIOD_SEC = 5,
+    DEFAULT_SEND_BUDGET = 256 * 1024 // Max bytes of frames passed to transport in one write
 };
 
 } // namespace Net
@@ -34,6 +34,7 @@ NetConfig NetConfig::Mirror(const IPAddress& addr) const
     NetConfig result(SERVER_ROLE == role ? CLIENT_ROLE : SERVER_ROLE);
     result.transports = transports;
     result.services = services;
+    result.sendBudget = sendBudget;
     for (Vector<TransportConfig>::iterator i = result.transports.begin(), e = result.transports.end(); i != e; ++i)
     {
         uint16 port = (*i).endpoint.Port();
@@ -71,5 +72,11 @@ bool NetConfig::AddService(uint32 serviceId)
     return false;
 }
 
+void NetConfig::SetSendBudget(size_t bytes)
+{
+    DVASSERT(bytes > 0);
+    sendBudget = bytes;
+}
+
 } // namespace Net
 } // namespace DAVA
@@ -65,6 +65,7 @@ bool NetController::ApplyConfig(const NetConfig& config, size_t trIndex)
 
     role = config.Role();
     serviceIds = config.Services();
+    sendBudget = config.SendBudget();
     if (SERVER_ROLE == role)
     {
         servers.reserve(trConfig.size());
@@ -85,6 +86,7 @@ bool NetController::ApplyConfig(const NetConfig& config, size_t trIndex)
         {
             ProtoDriver* driver = new ProtoDriver(loop, role, registrar, serviceContext);
             driver->SetTransport(tr, &*serviceIds.begin(), serviceIds.size());
+            driver->SetSendBudget(sendBudget);
             clients.push_back(ClientEntry(tr, driver));
         }
     }
@@ -190,6 +192,7 @@ void NetController::OnTransportSpawned(IServerTransport* parent, IClientTranspor
 
     ProtoDriver* driver = new ProtoDriver(loop, role, registrar, serviceContext);
     driver->SetTransport(child, &*serviceIds.begin(), serviceIds.size());
+    driver->SetSendBudget(sendBudget);
     clients.push_back(ClientEntry(child, driver, parent));
 
     child->Start(this);
@@ -77,6 +77,7 @@ private:
     Function<void(IController*)> stopHandler;
     bool isTerminating;
     uint32 readTimeout = 0;
+    size_t sendBudget = DEFAULT_SEND_BUDGET;
 
     Atomic<Status> status{ NOT_STARTED };
 
@@ -7,12 +7,15 @@ namespace DAVA
 namespace Net
 {
 ProtoDecoder::ProtoDecoder()
-    : totalDataSize(0)
-    , accumulatedSize(0)
-    , curFrameSize(0)
+    : curFrameSize(0)
 {
 }
 
+void ProtoDecoder::AddChannel(uint32 channelId)
+{
+    accumulators[channelId];
+}
+
 ProtoDecoder::eDecodeStatus ProtoDecoder::Decode(const void* buffer, size_t length, DecodeResult* result)
 {
     DVASSERT(buffer != NULL && result != NULL);
@@ -61,6 +64,9 @@ size_t ProtoDecoder::EncodeControlFrame(ProtoHeader* header, uint32 type, uint32
     {
     case TYPE_CHANNEL_QUERY:
     case TYPE_CHANNEL_ALLOW:
+        header->channelId = channelId;
+        header->packetId = PROTO_VERSION;
+        break;
     case TYPE_CHANNEL_DENY:
         header->channelId = channelId;
         break;
@@ -74,28 +80,45 @@ size_t ProtoDecoder::EncodeControlFrame(ProtoHeader* header, uint32 type, uint32
 
 ProtoDecoder::eDecodeStatus ProtoDecoder::ProcessDataFrame(ProtoHeader* header, DecodeResult* result)
 {
-    if (0 == totalDataSize)
+    // Channel id comes from other side, so unknown channels are rejected instead of growing accumulators
+    UnorderedMap<uint32, PacketAccumulator>::iterator found = accumulators.find(header->channelId);
+    if (found == accumulators.end())
+    {
+        return DECODE_INVALID;
+    }
+
+    PacketAccumulator& packet = found->second;
+    if (0 == packet.totalDataSize)
     {
-        accumulatedSize = 0;
-        totalDataSize = static_cast<size_t>(header->totalSize);
-        if (accum.size() < totalDataSize)
-            accum.resize(totalDataSize);
+        // Empty packets are never encoded
+        if (0 == header->totalSize)
+        {
+            return DECODE_INVALID;
+        }
+        packet.packetId = header->packetId;
+        packet.accumulatedSize = 0;
+        packet.totalDataSize = static_cast<size_t>(header->totalSize);
+        if (packet.accum.size() < packet.totalDataSize)
+            packet.accum.resize(packet.totalDataSize);
     }
-    // TODO: maybe I should compare channel ID and packet ID with initial values
+    // All frames of packet carry the same packet ID and total size, data mustn't exceed total size
     DVASSERT(curFrameSize >= sizeof(ProtoHeader));
     size_type packetSize = curFrameSize - sizeof(ProtoHeader);
-    DVASSERT(accum.size() >= accumulatedSize + packetSize);
-    Memcpy(&*accum.begin() + accumulatedSize, curFrame + sizeof(ProtoHeader), packetSize);
-    accumulatedSize += packetSize;
-    if (accumulatedSize == totalDataSize)
+    if (header->packetId != packet.packetId || header->totalSize != packet.totalDataSize || packetSize > packet.totalDataSize - packet.accumulatedSize)
+    {
+        return DECODE_INVALID;
+    }
+    Memcpy(&*packet.accum.begin() + packet.accumulatedSize, curFrame + sizeof(ProtoHeader), packetSize);
+    packet.accumulatedSize += packetSize;
+    if (packet.accumulatedSize == packet.totalDataSize)
     {
         result->type = TYPE_DATA;
         result->channelId = header->channelId;
         result->packetId = header->packetId;
-        result->dataSize = totalDataSize;
-        result->data = &*accum.begin();
+        result->dataSize = packet.totalDataSize;
+        result->data = &*packet.accum.begin();
 
-        totalDataSize = 0;
+        packet.totalDataSize = 0;
         return DECODE_OK;
     }
     return DECODE_INCOMPLETE;
@@ -108,9 +131,11 @@ ProtoDecoder::eDecodeStatus ProtoDecoder::ProcessControlFrame(ProtoHeader* heade
     {
     case TYPE_CHANNEL_QUERY:
         result->channelId = header->channelId;
+        result->packetId = header->packetId; // Protocol version
         break;
     case TYPE_CHANNEL_ALLOW:
         result->channelId = header->channelId;
+        result->packetId = header->packetId; // Protocol version
         break;
     case TYPE_CHANNEL_DENY:
         result->channelId = header->channelId;
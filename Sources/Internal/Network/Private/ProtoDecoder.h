@@ -30,6 +30,9 @@ public:
 public:
     ProtoDecoder();
 
+    // Data frames are accepted only for added channels
+    void AddChannel(uint32 channelId);
+
     eDecodeStatus Decode(const void* buffer, size_t length, DecodeResult* result);
     size_t EncodeDataFrame(ProtoHeader* header, uint32 channelId, uint32 packetId, size_t packetSize, size_t encodedSize) const;
     size_t EncodeControlFrame(ProtoHeader* header, uint32 type, uint32 channelId, uint32 packetId) const;
@@ -43,9 +46,16 @@ private:
     eDecodeStatus CheckHeader(const ProtoHeader* header) const;
 
 private:
-    size_t totalDataSize;
-    size_t accumulatedSize;
-    Vector<uint8> accum;
+    // Frames of packets from different channels may be interleaved, so data packet is gathered per channel
+    struct PacketAccumulator
+    {
+        uint32 packetId = 0;
+        size_t totalDataSize = 0;
+        size_t accumulatedSize = 0;
+        Vector<uint8> accum;
+    };
+
+    UnorderedMap<uint32, PacketAccumulator> accumulators;
 
     uint8 curFrame[PROTO_MAX_FRAME_SIZE];
     size_t curFrameSize;
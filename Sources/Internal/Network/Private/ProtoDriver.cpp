@@ -1,7 +1,10 @@
+#include <algorithm>
+
 #include <Functional/Function.h>
 #include <Debug/DVAssert.h>
 #include <Concurrency/Atomic.h>
 #include <Concurrency/LockGuard.h>
+#include <Logger/Logger.h>
 
 #include <Network/Base/IOLoop.h>
 #include <Network/ServiceRegistrar.h>
@@ -20,11 +23,9 @@ ProtoDriver::ProtoDriver(IOLoop* aLoop, eNetworkRole aRole, const ServiceRegistr
     , registrar(aRegistrar)
     , serviceContext(aServiceContext)
     , transport(NULL)
-    , whatIsSending()
     , pendingPong(false)
 {
     DVASSERT(loop != NULL);
-    Memset(&curPacket, 0, sizeof(curPacket));
 }
 
 ProtoDriver::~ProtoDriver()
@@ -44,6 +45,7 @@ void ProtoDriver::SetTransport(IClientTransport* aTransport, const uint32* sourc
     for (size_t i = 0; i < channelCount; ++i)
     {
         channels.push_back(std::make_shared<Channel>(sourceChannels[i], this));
+        proto.AddChannel(sourceChannels[i]);
     }
 }
 
@@ -57,15 +59,12 @@ void ProtoDriver::SendData(uint32 channelId, const void* buffer, size_t length,
         *outPacketId = packet.packetId;
 
     // This method may be invoked from different threads
+    // Packet is queued before trying sender lock, so sender that is just finishing will see it
+    EnqueuePacket(&packet);
     if (true == senderLock.TryLock())
     {
         // TODO: consider optimization when called from IOLoop's thread
-        curPacket = packet;
-        loop->Post(MakeFunction(this, &ProtoDriver::SendCurPacket));
-    }
-    else
-    {
-        EnqueuePacket(&packet);
+        loop->Post(MakeFunction(this, &ProtoDriver::SendFrames));
     }
 }
 
@@ -73,15 +72,11 @@ void ProtoDriver::SendControl(uint32 code, uint32 channelId, uint32 packetId)
 {
     ProtoHeader header;
     proto.EncodeControlFrame(&header, code, channelId, packetId);
-    if (true == senderLock.TryLock()) // Control frame can be sent directly without queueing
+    // No need for mutex locking as control frames are always sent from handlers
+    controlQueue.push_back(header);
+    if (true == senderLock.TryLock()) // Control frame can be sent directly
     {
-        curControl = header;
-        SendCurControl();
-    }
-    else
-    {
-        // No need for mutex locking as control frames are always sent from handlers
-        controlQueue.push_back(header);
+        SendFrames();
     }
 }
 
@@ -183,29 +178,8 @@ bool ProtoDriver::OnDataReceived(const void* buffer, size_t length)
 
 void ProtoDriver::OnSendComplete()
 {
-    if (SENDING_DATA_FRAME == whatIsSending)
-    {
-        curPacket.sentLength += curPacket.chunkLength;
-        if (curPacket.sentLength == curPacket.dataLength)
-        {
-            std::shared_ptr<Channel> ch = GetChannel(curPacket.channelId);
-            ch->service->OnPacketSent(ch, curPacket.data, curPacket.dataLength);
-            curPacket.data = NULL;
-        }
-    }
-
-    if (true == DequeueControl(&curControl)) // First send control packets if any
-    {
-        SendCurControl();
-    }
-    else if (curPacket.data != NULL || true == DequeuePacket(&curPacket)) // Send current packet further or send new packet
-    {
-        SendCurPacket();
-    }
-    else
-    {
-        senderLock.Unlock(); // Nothing to send, unlock sender
-    }
+    CompleteSentPackets();
+    SendFrames(); // Send further or unlock sender if nothing to send
 }
 
 bool ProtoDriver::OnTimeout()
@@ -238,6 +212,12 @@ bool ProtoDriver::ProcessChannelQuery(ProtoDecoder::DecodeResult* result)
     DVASSERT(SERVER_ROLE == role);
 
     std::shared_ptr<Channel> ch = GetChannel(result->channelId);
+    if (ch != NULL && result->packetId != PROTO_VERSION)
+    {
+        Logger::Error("[ProtoDriver] channel %u is denied: protocol version %u of other side, %u expected", result->channelId, result->packetId, PROTO_VERSION);
+        SendControl(TYPE_CHANNEL_DENY, result->channelId, 0);
+        return true;
+    }
     if (ch != NULL)
     {
         DVASSERT(NULL == ch->service);
@@ -265,6 +245,12 @@ bool ProtoDriver::ProcessChannelAllow(ProtoDecoder::DecodeResult* result)
     DVASSERT(CLIENT_ROLE == role);
 
     std::shared_ptr<Channel> ch = GetChannel(result->channelId);
+    if (result->packetId != PROTO_VERSION)
+    {
+        // Other side would send frames this side can't decode
+        Logger::Error("[ProtoDriver] channel %u is closed: protocol version %u of other side, %u expected", result->channelId, result->packetId, PROTO_VERSION);
+        return false;
+    }
     if (ch != NULL && ch->service != NULL)
     {
         ch->confirmed = true;
@@ -295,11 +281,15 @@ bool ProtoDriver::ProcessDeliveryAck(ProtoDecoder::DecodeResult* result)
 {
     std::shared_ptr<Channel> ch = GetChannel(result->channelId);
     DVASSERT(ch != NULL && ch->service != NULL);
-    DVASSERT(false == pendingAckQueue.empty());
-    if (ch != NULL && ch->service != NULL && false == pendingAckQueue.empty())
+    // Packets of different channels are interleaved, so only acknowledgements of one channel come in order
+    Deque<PendingAck>::iterator pendingAck = std::find_if(pendingAckQueue.begin(), pendingAckQueue.end(), [result](const PendingAck& ack) {
+        return ack.channelId == result->channelId;
+    });
+    DVASSERT(pendingAck != pendingAckQueue.end());
+    if (ch != NULL && ch->service != NULL && pendingAck != pendingAckQueue.end())
     {
-        uint32 pendingId = pendingAckQueue.front();
-        pendingAckQueue.pop_front();
+        uint32 pendingId = pendingAck->packetId;
+        pendingAckQueue.erase(pendingAck);
         DVASSERT(pendingId == result->packetId);
         if (pendingId == result->packetId)
         {
@@ -312,47 +302,125 @@ bool ProtoDriver::ProcessDeliveryAck(ProtoDecoder::DecodeResult* result)
 
 void ProtoDriver::ClearQueues()
 {
-    if (curPacket.data != NULL)
+    for (Packet& packet : activePackets)
     {
-        std::shared_ptr<Channel> ch = GetChannel(curPacket.channelId);
-        ch->service->OnPacketSent(ch, curPacket.data, curPacket.dataLength);
-
-        curPacket.data = NULL;
-    }
-    for (Deque<Packet>::iterator i = dataQueue.begin(), e = dataQueue.end(); i != e; ++i)
-    {
-        Packet& packet = *i;
         std::shared_ptr<Channel> ch = GetChannel(packet.channelId);
         ch->service->OnPacketSent(ch, packet.data, packet.dataLength);
     }
-    dataQueue.clear();
+    activePackets.clear();
+    nextActivePacket = 0;
+
+    Deque<Packet> queuedPackets;
+    for (std::shared_ptr<Channel>& ch : channels)
+    {
+        {
+            LockGuard<Mutex> lock(queueMutex);
+            queuedPackets.swap(ch->dataQueue);
+        }
+        for (Packet& packet : queuedPackets)
+        {
+            ch->service->OnPacketSent(ch, packet.data, packet.dataLength);
+        }
+        queuedPackets.clear();
+    }
     pendingAckQueue.clear();
     controlQueue.clear();
     senderLock.Unlock();
 }
 
-void ProtoDriver::SendCurPacket()
+void ProtoDriver::SendFrames()
 {
-    DVASSERT(curPacket.sentLength < curPacket.dataLength);
+    size_t frameCount = 0;
+    size_t bufferCount = 0;
+    size_t sendSize = 0;
+
+    // Acknowledgements are expected only for packets whose first frame is really passed to transport
+    PendingAck firstFrameAcks[MAX_FRAMES_PER_SEND];
+    size_t firstFrameCount = 0;
+
+    // Control frames go first as they are tiny and other side may wait for them
+    while (frameCount < MAX_FRAMES_PER_SEND && true == DequeueControl(&sendHeaders[frameCount]))
+    {
+        sendBuffers[bufferCount++] = CreateBuffer(&sendHeaders[frameCount]);
+        sendSize += sizeof(ProtoHeader);
+        frameCount += 1;
+    }
+
+    // Take one frame from every active packet in turn, so big packet doesn't block other channels,
+    // and pack frames into one write until budget is spent
+    bool frameAdded = true;
+    while (true == frameAdded && frameCount < MAX_FRAMES_PER_SEND && (0 == frameCount || sendSize < sendBudget))
+    {
+        ActivateQueuedPackets();
+
+        frameAdded = false;
+        const size_t packetCount = activePackets.size();
+        const size_t firstPacket = nextActivePacket;
+        for (size_t i = 0; i < packetCount && frameCount < MAX_FRAMES_PER_SEND && (0 == frameCount || sendSize < sendBudget); ++i)
+        {
+            const size_t index = (firstPacket + i) % packetCount;
+            Packet& packet = activePackets[index];
+            if (packet.sentLength == packet.dataLength)
+                continue;
+
+            if (0 == packet.sentLength)
+            {
+                firstFrameAcks[firstFrameCount++] = PendingAck{ packet.channelId, packet.packetId };
+            }
 
-    whatIsSending = SENDING_DATA_FRAME;
-    curPacket.chunkLength = proto.EncodeDataFrame(&header, curPacket.channelId, curPacket.packetId, curPacket.dataLength, curPacket.sentLength);
+            ProtoHeader* header = &sendHeaders[frameCount];
+            size_t chunkLength = proto.EncodeDataFrame(header, packet.channelId, packet.packetId, packet.dataLength, packet.sentLength);
+            sendBuffers[bufferCount++] = CreateBuffer(header);
+            sendBuffers[bufferCount++] = CreateBuffer(packet.data + packet.sentLength, chunkLength);
+            packet.sentLength += chunkLength;
+            sendSize += sizeof(ProtoHeader) + chunkLength;
+            frameCount += 1;
+            frameAdded = true;
 
-    Buffer buffers[2];
-    buffers[0] = CreateBuffer(&header);
-    buffers[1] = CreateBuffer(curPacket.data + curPacket.sentLength, curPacket.chunkLength);
-    if (0 == transport->Send(buffers, 2) && 0 == curPacket.sentLength)
+            nextActivePacket = index + 1;
+        }
+    }
+
+    if (frameCount > 0)
     {
-        pendingAckQueue.push_back(curPacket.packetId);
+        if (0 == transport->Send(sendBuffers, bufferCount))
+        {
+            pendingAckQueue.insert(pendingAckQueue.end(), firstFrameAcks, firstFrameAcks + firstFrameCount);
+        }
+    }
+    else
+    {
+        senderLock.Unlock(); // Nothing to send, unlock sender
+        // Packet could be queued by other thread while sender was locked
+        if (true == HasQueuedPackets() && true == senderLock.TryLock())
+        {
+            SendFrames();
+        }
     }
 }
 
-void ProtoDriver::SendCurControl()
+void ProtoDriver::CompleteSentPackets()
 {
-    whatIsSending = SENDING_CONTROL_FRAME;
-
-    Buffer buffer = CreateBuffer(&curControl);
-    transport->Send(&buffer, 1);
+    // Last frames of completely encoded packets were in completed write
+    size_t activeCount = 0;
+    size_t nextActiveCount = 0;
+    for (size_t i = 0, n = activePackets.size(); i < n; ++i)
+    {
+        Packet& packet = activePackets[i];
+        if (packet.sentLength == packet.dataLength)
+        {
+            std::shared_ptr<Channel> ch = GetChannel(packet.channelId);
+            ch->service->OnPacketSent(ch, packet.data, packet.dataLength);
+        }
+        else
+        {
+            if (i < nextActivePacket)
+                nextActiveCount += 1;
+            activePackets[activeCount++] = packet;
+        }
+    }
+    activePackets.resize(activeCount);
+    nextActivePacket = nextActiveCount;
 }
 
 void ProtoDriver::PreparePacket(Packet* packet, uint32 channelId, const void* buffer, size_t length)
@@ -365,28 +433,51 @@ void ProtoDriver::PreparePacket(Packet* packet, uint32 channelId, const void* bu
     packet->packetId = ++nextPacketId;
     packet->dataLength = length;
     packet->sentLength = 0;
-    packet->chunkLength = 0;
     packet->data = static_cast<uint8*>(const_cast<void*>(buffer));
 }
 
-bool ProtoDriver::EnqueuePacket(Packet* packet)
+void ProtoDriver::EnqueuePacket(Packet* packet)
 {
-    bool queueWasEmpty = false;
+    std::shared_ptr<Channel>& ch = GetChannel(packet->channelId);
+    DVASSERT(ch != nullptr);
+    if (ch != nullptr)
+    {
+        LockGuard<Mutex> lock(queueMutex);
+        ch->dataQueue.push_back(*packet);
+    }
+}
 
+bool ProtoDriver::HasQueuedPackets()
+{
     LockGuard<Mutex> lock(queueMutex);
-    queueWasEmpty = dataQueue.empty();
-    dataQueue.push_back(*packet);
-    return queueWasEmpty;
+    for (const std::shared_ptr<Channel>& ch : channels)
+    {
+        if (false == ch->dataQueue.empty())
+            return true;
+    }
+    return false;
 }
 
-bool ProtoDriver::DequeuePacket(Packet* dest)
+void ProtoDriver::ActivateQueuedPackets()
 {
+    // Packets of one channel are transferred one by one to keep their order
     LockGuard<Mutex> lock(queueMutex);
-    if (false == dataQueue.empty())
+    for (std::shared_ptr<Channel>& ch : channels)
     {
-        *dest = dataQueue.front();
-        dataQueue.pop_front();
-        return true;
+        if (false == ch->dataQueue.empty() && false == IsChannelSending(ch->channelId))
+        {
+            activePackets.push_back(ch->dataQueue.front());
+            ch->dataQueue.pop_front();
+        }
+    }
+}
+
+bool ProtoDriver::IsChannelSending(uint32 channelId) const
+{
+    for (const Packet& packet : activePackets)
+    {
+        if (packet.channelId == channelId && packet.sentLength < packet.dataLength)
+            return true;
     }
     return false;
 }
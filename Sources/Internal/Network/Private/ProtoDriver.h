@@ -4,6 +4,7 @@
 #include <Base/BaseTypes.h>
 #include <Concurrency/Mutex.h>
 #include <Concurrency/Spinlock.h>
+#include <Debug/DVAssert.h>
 
 #include <Network/Base/Endpoint.h>
 #include <Network/NetworkCommon.h>
@@ -28,8 +29,13 @@ private:
         uint32 packetId;
         uint8* data = nullptr; // Data
         size_t dataLength; //  and its length
-        size_t sentLength; // Number of bytes that have been already transfered
-        size_t chunkLength; // Number of bytes transfered during last operation
+        size_t sentLength; // Number of bytes that have been already passed to transport
+    };
+
+    struct PendingAck
+    {
+        uint32 channelId;
+        uint32 packetId;
     };
 
     struct Channel : public IChannel
@@ -42,22 +48,21 @@ private:
 
         bool confirmed; // Channel is confirmed by other side
         uint32 channelId;
+        Deque<Packet> dataQueue; // Packets waiting to be transferred, guarded by driver's queueMutex
         Endpoint remoteEndpoint;
         ProtoDriver* driver = nullptr;
         IChannelListener* service = nullptr;
     };
 
-    enum eSendingFrameType
-    {
-        SENDING_DATA_FRAME = false,
-        SENDING_CONTROL_FRAME = true
-    };
+    // Header and data of data frame take two transport buffers, so up to 32 buffers are passed in one write
+    static const size_t MAX_FRAMES_PER_SEND = 16;
 
 public:
     ProtoDriver(IOLoop* aLoop, eNetworkRole aRole, const ServiceRegistrar& aRegistrar, void* aServiceContext);
     ~ProtoDriver();
 
     void SetTransport(IClientTransport* aTransport, const uint32* sourceChannels, size_t channelCount);
+    void SetSendBudget(size_t bytes);
     void SendData(uint32 channelId, const void* buffer, size_t length, uint32* outPacketId);
 
     void ReleaseServices();
@@ -80,12 +85,14 @@ private:
 
     void ClearQueues();
 
-    void SendCurPacket();
-    void SendCurControl();
+    void SendFrames();
+    void CompleteSentPackets();
 
     void PreparePacket(Packet* packet, uint32 channelId, const void* buffer, size_t length);
-    bool EnqueuePacket(Packet* packet);
-    bool DequeuePacket(Packet* dest);
+    void EnqueuePacket(Packet* packet);
+    bool HasQueuedPackets();
+    void ActivateQueuedPackets();
+    bool IsChannelSending(uint32 channelId) const;
     bool DequeueControl(ProtoHeader* dest);
 
 private:
@@ -98,18 +105,22 @@ private:
 
     Spinlock senderLock;
     Mutex queueMutex;
-    eSendingFrameType whatIsSending;
     bool pendingPong;
+    size_t sendBudget = DEFAULT_SEND_BUDGET;
 
-    Packet curPacket;
-    Deque<Packet> dataQueue;
-    Deque<uint32> pendingAckQueue;
+    // Packets taken from channel queues: at most one packet per channel is being encoded,
+    // completely encoded packets stay here until write with their last frame is completed
+    Vector<Packet> activePackets;
+    size_t nextActivePacket = 0; // Where next write starts round-robin over active packets
+    Deque<PendingAck> pendingAckQueue;
 
-    ProtoHeader curControl;
     Deque<ProtoHeader> controlQueue;
 
+    // Frames of current write operation
+    ProtoHeader sendHeaders[MAX_FRAMES_PER_SEND];
+    Buffer sendBuffers[MAX_FRAMES_PER_SEND * 2];
+
     ProtoDecoder proto;
-    ProtoHeader header;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -121,6 +132,12 @@ inline ProtoDriver::Channel::Channel(uint32 id, ProtoDriver* aDriver)
 {
 }
 
+inline void ProtoDriver::SetSendBudget(size_t bytes)
+{
+    DVASSERT(bytes > 0);
+    sendBudget = bytes;
+}
+
 inline bool ProtoDriver::Channel::Send(const void* data, size_t length, uint32 flags, uint32* outPacketId)
 {
     if (driver != nullptr)
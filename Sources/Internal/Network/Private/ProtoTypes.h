@@ -18,6 +18,12 @@ struct ProtoHeader
     uint32 totalSize = 0; // Total size of user data
 };
 
+// Version of protocol is passed in packetId field of CHANNEL_QUERY and CHANNEL_ALLOW frames,
+// peers with different versions don't open channels.
+// Version 1: packets are sent one by one, version field is zero.
+// Version 2: frames of packets from different channels are interleaved.
+const uint32 PROTO_VERSION = 2;
+
 const size_t PROTO_MAX_FRAME_SIZE = 1024 * 64 - 1;
 const size_t PROTO_MAX_FRAME_DATA_SIZE = PROTO_MAX_FRAME_SIZE - sizeof(ProtoHeader);
 
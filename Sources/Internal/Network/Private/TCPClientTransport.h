@@ -63,7 +63,7 @@ private:
     static const size_t INBUF_SIZE = 10 * 1024;
     uint8 inbuf[INBUF_SIZE];
 
-    static const size_t SENDBUF_COUNT = 2;
+    static const size_t SENDBUF_COUNT = TCPSocket::MAX_WRITE_BUFFERS;
     Buffer sendBuffers[SENDBUF_COUNT];
     size_t sendBufferCount;
 };
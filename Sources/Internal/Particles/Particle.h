@@ -2,24 +2,16 @@
 
 #include "Base/BaseTypes.h"
 #include "Base/BaseMath.h"
-#include "Base/AllocatorFactory.h"
 
 namespace DAVA
 {
+/**
+    Particle state which isn't touched by simulation kernels every frame.
+    Life, position, speed, rotation and bounding radius are stored in streams of `ParticlePool`.
+*/
 struct Particle
 {
-    IMPLEMENT_POOL_ALLOCATOR(Particle, 1000);
-
-    Particle* next = nullptr;
-
-    float32 life = 0.0f;
-    float32 lifeTime = 0.0f;
-
-    Vector3 position = {};
-    Vector3 speed = {};
-
-    float32 angle = 0.0f;
-    float32 spin = 0.0f;
+    uint32 seed = 0; // stable random index of particle for noise lookups in forces
 
     int32 frame = 0;
     float32 animTime = 0.0f;
@@ -36,7 +28,6 @@ struct Particle
     float32 baseNoiseVScrollSpeed = 0.0f;
     float32 currNoiseVOffset = 0.0f;
 
-    float32 currRadius = 0.0f; //for bbox computation
     float32 alphaRemap = 0.0f;
     Vector2 baseSize = {}, currSize = {};
 
@@ -129,6 +129,8 @@ ParticleEmitter* ParticleEmitter::Clone()
     clonedEmitter->emitterType = this->emitterType;
     clonedEmitter->shortEffect = shortEffect;
     clonedEmitter->generateOnSurface = generateOnSurface;
+    clonedEmitter->bakePropertyLines = bakePropertyLines;
+    clonedEmitter->bakeTolerance = bakeTolerance;
     clonedEmitter->shockwaveMode = shockwaveMode;
 
     clonedEmitter->layers.resize(layers.size());
@@ -355,6 +357,14 @@ bool ParticleEmitter::LoadFromYaml(const FilePath& filename, bool preserveInheri
         if (generateOnSurfaceNode)
             generateOnSurface = generateOnSurfaceNode->AsBool();
 
+        const YamlNode* bakePropertyLinesNode = emitterNode->Get("bakePropertyLines");
+        if (bakePropertyLinesNode)
+            bakePropertyLines = bakePropertyLinesNode->AsBool();
+
+        const YamlNode* bakeToleranceNode = emitterNode->Get("bakeTolerance");
+        if (bakeToleranceNode)
+            bakeTolerance = bakeToleranceNode->AsFloat();
+
         const YamlNode* shockwaveModeNode = emitterNode->Get("shockwaveMode");
         shockwaveMode = SHOCKWAVE_DISABLED;
         if (shockwaveModeNode)
@@ -428,6 +438,11 @@ bool ParticleEmitter::LoadFromYaml(const FilePath& filename, bool preserveInheri
     // Yuri Coder, 2013/01/15. The "name" node for Layer was just added and may not exist for
     // old yaml files. Generate the default name for nodes with empty names.
     UpdateEmptyLayerNames();
+
+    if (bakePropertyLines)
+    {
+        BakePropertyLines();
+    }
     return true;
 }
 
@@ -444,6 +459,11 @@ void ParticleEmitter::SaveToYaml(const FilePath& filename)
     emitterYamlNode->Set("shortEffect", shortEffect);
     emitterYamlNode->Set("generateOnSurface", generateOnSurface);
     emitterYamlNode->Set("shockwaveMode", GetEmitterShockwaveModeName());
+    if (bakePropertyLines)
+    {
+        emitterYamlNode->Set("bakePropertyLines", bakePropertyLines);
+        emitterYamlNode->Set("bakeTolerance", bakeTolerance);
+    }
 
     // Write the property lines.
     PropertyLineYamlWriter::WritePropertyLineToYamlNode<float32>(emitterYamlNode, "emissionAngle", this->emissionAngle);
@@ -489,6 +509,23 @@ void ParticleEmitter::GetModifableLines(List<ModifiablePropertyLineBase*>& modif
     }
 }
 
+void ParticleEmitter::BakePropertyLines()
+{
+    PropertyLineHelper::Bake(emissionVector.Get(), bakeTolerance);
+    PropertyLineHelper::Bake(emissionVelocityVector.Get(), bakeTolerance);
+    PropertyLineHelper::Bake(emissionRange.Get(), bakeTolerance);
+    PropertyLineHelper::Bake(radius.Get(), bakeTolerance);
+    PropertyLineHelper::Bake(innerRadius.Get(), bakeTolerance);
+    PropertyLineHelper::Bake(emissionAngle.Get(), bakeTolerance);
+    PropertyLineHelper::Bake(emissionAngleVariation.Get(), bakeTolerance);
+    PropertyLineHelper::Bake(size.Get(), bakeTolerance);
+    PropertyLineHelper::Bake(colorOverLife.Get(), bakeTolerance);
+    for (ParticleLayer* layer : layers)
+    {
+        layer->BakePropertyLines(bakeTolerance);
+    }
+}
+
 String ParticleEmitter::GetEmitterTypeName()
 {
     switch (this->emitterType)
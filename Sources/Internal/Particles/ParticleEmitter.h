@@ -83,6 +83,12 @@ public:
 
     void GetModifableLines(List<ModifiablePropertyLineBase*>& modifiables);
 
+    /**
+        Bake keyframed property lines of the emitter and its layers into lookup tables with `bakeTolerance`.
+        Called on load for emitters with `bakePropertyLines` set.
+    */
+    void BakePropertyLines();
+
     void Cleanup(bool needCleanupLayers = true);
     void CleanupLayers();
 
@@ -107,6 +113,8 @@ public:
     eShockwaveMode shockwaveMode = SHOCKWAVE_DISABLED;
     bool shortEffect = false;
     bool generateOnSurface = false;
+    bool bakePropertyLines = false;
+    float32 bakeTolerance = 0.001f; // largest difference between baked and keyframed values
 
 protected:
     virtual ~ParticleEmitter();
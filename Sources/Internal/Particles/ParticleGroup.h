@@ -3,6 +3,8 @@
 #include "ParticleEmitter.h"
 #include "ParticleLayer.h"
 #include "Particle.h"
+#include "ParticlePool.h"
+#include "ParticlesRandom.h"
 #include "Render/Material/NMaterial.h"
 
 namespace DAVA
@@ -42,7 +44,7 @@ struct ParticleGroup
     ParticleEmitter* emitter = nullptr;
     ParticleLayer* layer = nullptr;
     NMaterial* material = nullptr;
-    Particle* head = nullptr;
+    ParticlePool particles;
 
     Vector3 spawnPosition;
 
@@ -56,6 +58,7 @@ struct ParticleGroup
     float32 particlesToGenerate = 0.0f;
 
     uint16 particlesGenerated = 0;
+    uint32 randomSeed = 0; // base of quasi-random sequences of generated particles, drawn from effect random generator
 
     bool finishingGroup = false;
     bool visibleLod = true;
@@ -69,9 +72,18 @@ struct ParentInfo
     Vector2 size;
 };
 
+// Inner emitter of superemitter particle, started after the update which generated the particle
+struct PendingEmitter
+{
+    ParticleEmitter* emitter = nullptr;
+    int32 positionSource = 0;
+};
+
 struct ParticleEffectData
 {
     Vector<ParentInfo> infoSources;
     List<ParticleGroup> groups;
+    Vector<PendingEmitter> pendingEmitters; // emitters create groups and acquire materials, so they aren't run by update jobs
+    ParticlesRandom::Generator random; // all randomness of effect simulation, reseeded when effect starts
 };
 }
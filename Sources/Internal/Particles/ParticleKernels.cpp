@@ -0,0 +1,505 @@
+#include "Particles/ParticleKernels.h"
+#include "Particles/ParticlePool.h"
+#include "Debug/DVAssert.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PARTICLE_KERNELS_SSE
+#include <emmintrin.h>
+#endif
+
+// vdivq_f32 is available only on AArch64
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#define PARTICLE_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace DAVA
+{
+namespace ParticleKernelsDetails
+{
+using ParticleKernels::eImplementation;
+
+const uint32 LANES = 4;
+
+inline uint32 GetSimdCount(uint32 count)
+{
+    return count - count % LANES;
+}
+
+void AdvanceLifeScalar(ParticlePool& pool, float32 dt, uint32 begin, uint32 end)
+{
+    float32* life = pool.life.data();
+    for (uint32 i = begin; i < end; ++i)
+    {
+        life[i] += dt;
+    }
+}
+
+void ComputeOverLifeScalar(const ParticlePool& pool, float32* overLife, uint32 begin, uint32 end)
+{
+    const float32* life = pool.life.data();
+    const float32* lifeTime = pool.lifeTime.data();
+    for (uint32 i = begin; i < end; ++i)
+    {
+        overLife[i] = life[i] / lifeTime[i];
+    }
+}
+
+void IntegrateScalar(ParticlePool& pool, const float32* velocityScale, const float32* spinScale, float32 dt, uint32 begin, uint32 end)
+{
+    for (uint32 i = begin; i < end; ++i)
+    {
+        float32 t = velocityScale[i] * dt;
+        pool.positionX[i] += pool.speedX[i] * t;
+        pool.positionY[i] += pool.speedY[i] * t;
+        pool.positionZ[i] += pool.speedZ[i] * t;
+        pool.angle[i] += pool.spin[i] * spinScale[i] * dt;
+    }
+}
+
+void AccumulateForceScalar(const Vector3& force, const float32* scale, float32* accelerationX, float32* accelerationY, float32* accelerationZ, uint32 begin, uint32 end)
+{
+    for (uint32 i = begin; i < end; ++i)
+    {
+        accelerationX[i] += force.x * scale[i];
+        accelerationY[i] += force.y * scale[i];
+        accelerationZ[i] += force.z * scale[i];
+    }
+}
+
+void AccelerateScalar(ParticlePool& pool, const float32* accelerationX, const float32* accelerationY, const float32* accelerationZ, float32 dt, uint32 begin, uint32 end)
+{
+    for (uint32 i = begin; i < end; ++i)
+    {
+        pool.speedX[i] += accelerationX[i] * dt;
+        pool.speedY[i] += accelerationY[i] * dt;
+        pool.speedZ[i] += accelerationZ[i] * dt;
+    }
+}
+
+void AddToBoundsScalar(const ParticlePool& pool, const Vector3& offset, AABBox3& bbox, uint32 begin, uint32 end)
+{
+    for (uint32 i = begin; i < end; ++i)
+    {
+        Vector3 position = pool.GetPosition(i) + offset;
+        Vector3 size(pool.radius[i], pool.radius[i], pool.radius[i]);
+        bbox.AddPoint(position - size);
+        bbox.AddPoint(position + size);
+    }
+}
+
+#if defined(PARTICLE_KERNELS_SSE)
+void AdvanceLifeSSE(ParticlePool& pool, float32 dt, uint32 count)
+{
+    float32* life = pool.life.data();
+    const __m128 vdt = _mm_set1_ps(dt);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        _mm_storeu_ps(life + i, _mm_add_ps(_mm_loadu_ps(life + i), vdt));
+    }
+}
+
+void ComputeOverLifeSSE(const ParticlePool& pool, float32* overLife, uint32 count)
+{
+    const float32* life = pool.life.data();
+    const float32* lifeTime = pool.lifeTime.data();
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        _mm_storeu_ps(overLife + i, _mm_div_ps(_mm_loadu_ps(life + i), _mm_loadu_ps(lifeTime + i)));
+    }
+}
+
+void IntegrateSSE(ParticlePool& pool, const float32* velocityScale, const float32* spinScale, float32 dt, uint32 count)
+{
+    const __m128 vdt = _mm_set1_ps(dt);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        __m128 t = _mm_mul_ps(_mm_loadu_ps(velocityScale + i), vdt);
+        _mm_storeu_ps(&pool.positionX[i], _mm_add_ps(_mm_loadu_ps(&pool.positionX[i]), _mm_mul_ps(_mm_loadu_ps(&pool.speedX[i]), t)));
+        _mm_storeu_ps(&pool.positionY[i], _mm_add_ps(_mm_loadu_ps(&pool.positionY[i]), _mm_mul_ps(_mm_loadu_ps(&pool.speedY[i]), t)));
+        _mm_storeu_ps(&pool.positionZ[i], _mm_add_ps(_mm_loadu_ps(&pool.positionZ[i]), _mm_mul_ps(_mm_loadu_ps(&pool.speedZ[i]), t)));
+
+        __m128 rotation = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&pool.spin[i]), _mm_loadu_ps(spinScale + i)), vdt);
+        _mm_storeu_ps(&pool.angle[i], _mm_add_ps(_mm_loadu_ps(&pool.angle[i]), rotation));
+    }
+}
+
+void AccumulateForceSSE(const Vector3& force, const float32* scale, float32* accelerationX, float32* accelerationY, float32* accelerationZ, uint32 count)
+{
+    const __m128 fx = _mm_set1_ps(force.x);
+    const __m128 fy = _mm_set1_ps(force.y);
+    const __m128 fz = _mm_set1_ps(force.z);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        __m128 s = _mm_loadu_ps(scale + i);
+        _mm_storeu_ps(accelerationX + i, _mm_add_ps(_mm_loadu_ps(accelerationX + i), _mm_mul_ps(fx, s)));
+        _mm_storeu_ps(accelerationY + i, _mm_add_ps(_mm_loadu_ps(accelerationY + i), _mm_mul_ps(fy, s)));
+        _mm_storeu_ps(accelerationZ + i, _mm_add_ps(_mm_loadu_ps(accelerationZ + i), _mm_mul_ps(fz, s)));
+    }
+}
+
+void AccelerateSSE(ParticlePool& pool, const float32* accelerationX, const float32* accelerationY, const float32* accelerationZ, float32 dt, uint32 count)
+{
+    const __m128 vdt = _mm_set1_ps(dt);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        _mm_storeu_ps(&pool.speedX[i], _mm_add_ps(_mm_loadu_ps(&pool.speedX[i]), _mm_mul_ps(_mm_loadu_ps(accelerationX + i), vdt)));
+        _mm_storeu_ps(&pool.speedY[i], _mm_add_ps(_mm_loadu_ps(&pool.speedY[i]), _mm_mul_ps(_mm_loadu_ps(accelerationY + i), vdt)));
+        _mm_storeu_ps(&pool.speedZ[i], _mm_add_ps(_mm_loadu_ps(&pool.speedZ[i]), _mm_mul_ps(_mm_loadu_ps(accelerationZ + i), vdt)));
+    }
+}
+
+void AddToBoundsSSE(const ParticlePool& pool, const Vector3& offset, AABBox3& bbox, uint32 count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    const __m128 ox = _mm_set1_ps(offset.x);
+    const __m128 oy = _mm_set1_ps(offset.y);
+    const __m128 oz = _mm_set1_ps(offset.z);
+    __m128 minX = _mm_set1_ps(bbox.min.x);
+    __m128 minY = _mm_set1_ps(bbox.min.y);
+    __m128 minZ = _mm_set1_ps(bbox.min.z);
+    __m128 maxX = _mm_set1_ps(bbox.max.x);
+    __m128 maxY = _mm_set1_ps(bbox.max.y);
+    __m128 maxZ = _mm_set1_ps(bbox.max.z);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        __m128 r = _mm_loadu_ps(&pool.radius[i]);
+        __m128 x = _mm_add_ps(_mm_loadu_ps(&pool.positionX[i]), ox);
+        __m128 y = _mm_add_ps(_mm_loadu_ps(&pool.positionY[i]), oy);
+        __m128 z = _mm_add_ps(_mm_loadu_ps(&pool.positionZ[i]), oz);
+        minX = _mm_min_ps(minX, _mm_sub_ps(x, r));
+        minY = _mm_min_ps(minY, _mm_sub_ps(y, r));
+        minZ = _mm_min_ps(minZ, _mm_sub_ps(z, r));
+        maxX = _mm_max_ps(maxX, _mm_add_ps(x, r));
+        maxY = _mm_max_ps(maxY, _mm_add_ps(y, r));
+        maxZ = _mm_max_ps(maxZ, _mm_add_ps(z, r));
+    }
+
+    alignas(16) float32 lanes[6][LANES];
+    _mm_store_ps(lanes[0], minX);
+    _mm_store_ps(lanes[1], minY);
+    _mm_store_ps(lanes[2], minZ);
+    _mm_store_ps(lanes[3], maxX);
+    _mm_store_ps(lanes[4], maxY);
+    _mm_store_ps(lanes[5], maxZ);
+    for (uint32 l = 0; l < LANES; ++l)
+    {
+        bbox.AddPoint(Vector3(lanes[0][l], lanes[1][l], lanes[2][l]));
+        bbox.AddPoint(Vector3(lanes[3][l], lanes[4][l], lanes[5][l]));
+    }
+}
+#endif
+
+#if defined(PARTICLE_KERNELS_NEON)
+// vmulq + vaddq instead of vmlaq/vfmaq to keep the same rounding as scalar code
+
+void AdvanceLifeNEON(ParticlePool& pool, float32 dt, uint32 count)
+{
+    float32* life = pool.life.data();
+    const float32x4_t vdt = vdupq_n_f32(dt);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        vst1q_f32(life + i, vaddq_f32(vld1q_f32(life + i), vdt));
+    }
+}
+
+void ComputeOverLifeNEON(const ParticlePool& pool, float32* overLife, uint32 count)
+{
+    const float32* life = pool.life.data();
+    const float32* lifeTime = pool.lifeTime.data();
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        vst1q_f32(overLife + i, vdivq_f32(vld1q_f32(life + i), vld1q_f32(lifeTime + i)));
+    }
+}
+
+void IntegrateNEON(ParticlePool& pool, const float32* velocityScale, const float32* spinScale, float32 dt, uint32 count)
+{
+    const float32x4_t vdt = vdupq_n_f32(dt);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        float32x4_t t = vmulq_f32(vld1q_f32(velocityScale + i), vdt);
+        vst1q_f32(&pool.positionX[i], vaddq_f32(vld1q_f32(&pool.positionX[i]), vmulq_f32(vld1q_f32(&pool.speedX[i]), t)));
+        vst1q_f32(&pool.positionY[i], vaddq_f32(vld1q_f32(&pool.positionY[i]), vmulq_f32(vld1q_f32(&pool.speedY[i]), t)));
+        vst1q_f32(&pool.positionZ[i], vaddq_f32(vld1q_f32(&pool.positionZ[i]), vmulq_f32(vld1q_f32(&pool.speedZ[i]), t)));
+
+        float32x4_t rotation = vmulq_f32(vmulq_f32(vld1q_f32(&pool.spin[i]), vld1q_f32(spinScale + i)), vdt);
+        vst1q_f32(&pool.angle[i], vaddq_f32(vld1q_f32(&pool.angle[i]), rotation));
+    }
+}
+
+void AccumulateForceNEON(const Vector3& force, const float32* scale, float32* accelerationX, float32* accelerationY, float32* accelerationZ, uint32 count)
+{
+    const float32x4_t fx = vdupq_n_f32(force.x);
+    const float32x4_t fy = vdupq_n_f32(force.y);
+    const float32x4_t fz = vdupq_n_f32(force.z);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        float32x4_t s = vld1q_f32(scale + i);
+        vst1q_f32(accelerationX + i, vaddq_f32(vld1q_f32(accelerationX + i), vmulq_f32(fx, s)));
+        vst1q_f32(accelerationY + i, vaddq_f32(vld1q_f32(accelerationY + i), vmulq_f32(fy, s)));
+        vst1q_f32(accelerationZ + i, vaddq_f32(vld1q_f32(accelerationZ + i), vmulq_f32(fz, s)));
+    }
+}
+
+void AccelerateNEON(ParticlePool& pool, const float32* accelerationX, const float32* accelerationY, const float32* accelerationZ, float32 dt, uint32 count)
+{
+    const float32x4_t vdt = vdupq_n_f32(dt);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        vst1q_f32(&pool.speedX[i], vaddq_f32(vld1q_f32(&pool.speedX[i]), vmulq_f32(vld1q_f32(accelerationX + i), vdt)));
+        vst1q_f32(&pool.speedY[i], vaddq_f32(vld1q_f32(&pool.speedY[i]), vmulq_f32(vld1q_f32(accelerationY + i), vdt)));
+        vst1q_f32(&pool.speedZ[i], vaddq_f32(vld1q_f32(&pool.speedZ[i]), vmulq_f32(vld1q_f32(accelerationZ + i), vdt)));
+    }
+}
+
+void AddToBoundsNEON(const ParticlePool& pool, const Vector3& offset, AABBox3& bbox, uint32 count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    const float32x4_t ox = vdupq_n_f32(offset.x);
+    const float32x4_t oy = vdupq_n_f32(offset.y);
+    const float32x4_t oz = vdupq_n_f32(offset.z);
+    float32x4_t minX = vdupq_n_f32(bbox.min.x);
+    float32x4_t minY = vdupq_n_f32(bbox.min.y);
+    float32x4_t minZ = vdupq_n_f32(bbox.min.z);
+    float32x4_t maxX = vdupq_n_f32(bbox.max.x);
+    float32x4_t maxY = vdupq_n_f32(bbox.max.y);
+    float32x4_t maxZ = vdupq_n_f32(bbox.max.z);
+    for (uint32 i = 0; i < count; i += LANES)
+    {
+        float32x4_t r = vld1q_f32(&pool.radius[i]);
+        float32x4_t x = vaddq_f32(vld1q_f32(&pool.positionX[i]), ox);
+        float32x4_t y = vaddq_f32(vld1q_f32(&pool.positionY[i]), oy);
+        float32x4_t z = vaddq_f32(vld1q_f32(&pool.positionZ[i]), oz);
+        minX = vminq_f32(minX, vsubq_f32(x, r));
+        minY = vminq_f32(minY, vsubq_f32(y, r));
+        minZ = vminq_f32(minZ, vsubq_f32(z, r));
+        maxX = vmaxq_f32(maxX, vaddq_f32(x, r));
+        maxY = vmaxq_f32(maxY, vaddq_f32(y, r));
+        maxZ = vmaxq_f32(maxZ, vaddq_f32(z, r));
+    }
+
+    bbox.AddPoint(Vector3(vminvq_f32(minX), vminvq_f32(minY), vminvq_f32(minZ)));
+    bbox.AddPoint(Vector3(vmaxvq_f32(maxX), vmaxvq_f32(maxY), vmaxvq_f32(maxZ)));
+}
+#endif
+
+void CheckImplementation(eImplementation implementation)
+{
+    DVASSERT(ParticleKernels::IsImplementationAvailable(implementation), "Requested particle kernels implementation is not available");
+}
+}
+
+namespace ParticleKernels
+{
+bool IsImplementationAvailable(eImplementation implementation)
+{
+    switch (implementation)
+    {
+    case eImplementation::SCALAR:
+        return true;
+#if defined(PARTICLE_KERNELS_SSE)
+    case eImplementation::SSE:
+        return true;
+#endif
+#if defined(PARTICLE_KERNELS_NEON)
+    case eImplementation::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+eImplementation GetBestImplementation()
+{
+#if defined(PARTICLE_KERNELS_SSE)
+    return eImplementation::SSE;
+#elif defined(PARTICLE_KERNELS_NEON)
+    return eImplementation::NEON;
+#else
+    return eImplementation::SCALAR;
+#endif
+}
+
+void AdvanceLife(ParticlePool& pool, float32 dt, eImplementation implementation)
+{
+    using namespace ParticleKernelsDetails;
+
+    uint32 count = pool.GetSize();
+    uint32 processed = 0;
+    switch (implementation)
+    {
+#if defined(PARTICLE_KERNELS_SSE)
+    case eImplementation::SSE:
+        processed = GetSimdCount(count);
+        AdvanceLifeSSE(pool, dt, processed);
+        break;
+#endif
+#if defined(PARTICLE_KERNELS_NEON)
+    case eImplementation::NEON:
+        processed = GetSimdCount(count);
+        AdvanceLifeNEON(pool, dt, processed);
+        break;
+#endif
+    default:
+        CheckImplementation(implementation);
+        break;
+    }
+    AdvanceLifeScalar(pool, dt, processed, count);
+}
+
+void ComputeOverLife(const ParticlePool& pool, float32* overLife, eImplementation implementation)
+{
+    using namespace ParticleKernelsDetails;
+
+    uint32 count = pool.GetSize();
+    uint32 processed = 0;
+    switch (implementation)
+    {
+#if defined(PARTICLE_KERNELS_SSE)
+    case eImplementation::SSE:
+        processed = GetSimdCount(count);
+        ComputeOverLifeSSE(pool, overLife, processed);
+        break;
+#endif
+#if defined(PARTICLE_KERNELS_NEON)
+    case eImplementation::NEON:
+        processed = GetSimdCount(count);
+        ComputeOverLifeNEON(pool, overLife, processed);
+        break;
+#endif
+    default:
+        CheckImplementation(implementation);
+        break;
+    }
+    ComputeOverLifeScalar(pool, overLife, processed, count);
+}
+
+void SampleLine(PropertyLine<float32>* line, const float32* overLife, uint32 count, float32* values)
+{
+    if (line == nullptr)
+    {
+        std::fill(values, values + count, 1.0f);
+        return;
+    }
+
+    line->GetValues(overLife, values, count);
+}
+
+void Integrate(ParticlePool& pool, const float32* velocityScale, const float32* spinScale, float32 dt, eImplementation implementation)
+{
+    using namespace ParticleKernelsDetails;
+
+    uint32 count = pool.GetSize();
+    uint32 processed = 0;
+    switch (implementation)
+    {
+#if defined(PARTICLE_KERNELS_SSE)
+    case eImplementation::SSE:
+        processed = GetSimdCount(count);
+        IntegrateSSE(pool, velocityScale, spinScale, dt, processed);
+        break;
+#endif
+#if defined(PARTICLE_KERNELS_NEON)
+    case eImplementation::NEON:
+        processed = GetSimdCount(count);
+        IntegrateNEON(pool, velocityScale, spinScale, dt, processed);
+        break;
+#endif
+    default:
+        CheckImplementation(implementation);
+        break;
+    }
+    IntegrateScalar(pool, velocityScale, spinScale, dt, processed, count);
+}
+
+void AccumulateForce(const Vector3& force, const float32* scale, uint32 count, float32* accelerationX, float32* accelerationY, float32* accelerationZ, eImplementation implementation)
+{
+    using namespace ParticleKernelsDetails;
+
+    uint32 processed = 0;
+    switch (implementation)
+    {
+#if defined(PARTICLE_KERNELS_SSE)
+    case eImplementation::SSE:
+        processed = GetSimdCount(count);
+        AccumulateForceSSE(force, scale, accelerationX, accelerationY, accelerationZ, processed);
+        break;
+#endif
+#if defined(PARTICLE_KERNELS_NEON)
+    case eImplementation::NEON:
+        processed = GetSimdCount(count);
+        AccumulateForceNEON(force, scale, accelerationX, accelerationY, accelerationZ, processed);
+        break;
+#endif
+    default:
+        CheckImplementation(implementation);
+        break;
+    }
+    AccumulateForceScalar(force, scale, accelerationX, accelerationY, accelerationZ, processed, count);
+}
+
+void Accelerate(ParticlePool& pool, const float32* accelerationX, const float32* accelerationY, const float32* accelerationZ, float32 dt, eImplementation implementation)
+{
+    using namespace ParticleKernelsDetails;
+
+    uint32 count = pool.GetSize();
+    uint32 processed = 0;
+    switch (implementation)
+    {
+#if defined(PARTICLE_KERNELS_SSE)
+    case eImplementation::SSE:
+        processed = GetSimdCount(count);
+        AccelerateSSE(pool, accelerationX, accelerationY, accelerationZ, dt, processed);
+        break;
+#endif
+#if defined(PARTICLE_KERNELS_NEON)
+    case eImplementation::NEON:
+        processed = GetSimdCount(count);
+        AccelerateNEON(pool, accelerationX, accelerationY, accelerationZ, dt, processed);
+        break;
+#endif
+    default:
+        CheckImplementation(implementation);
+        break;
+    }
+    AccelerateScalar(pool, accelerationX, accelerationY, accelerationZ, dt, processed, count);
+}
+
+void AddToBounds(const ParticlePool& pool, const Vector3& offset, AABBox3& bbox, eImplementation implementation)
+{
+    using namespace ParticleKernelsDetails;
+
+    uint32 count = pool.GetSize();
+    uint32 processed = 0;
+    switch (implementation)
+    {
+#if defined(PARTICLE_KERNELS_SSE)
+    case eImplementation::SSE:
+        processed = GetSimdCount(count);
+        AddToBoundsSSE(pool, offset, bbox, processed);
+        break;
+#endif
+#if defined(PARTICLE_KERNELS_NEON)
+    case eImplementation::NEON:
+        processed = GetSimdCount(count);
+        AddToBoundsNEON(pool, offset, bbox, processed);
+        break;
+#endif
+    default:
+        CheckImplementation(implementation);
+        break;
+    }
+    AddToBoundsScalar(pool, offset, bbox, processed, count);
+}
+}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/AABBox3.h"
+#include "Math/Vector.h"
+#include "Particles/ParticlePropertyLine.h"
+
+namespace DAVA
+{
+class ParticlePool;
+
+/**
+    Batch update kernels over particle streams of `ParticlePool`.
+
+    Every kernel performs exactly the same floating point operations in the same order as per-particle update did,
+    so all implementations produce bit-identical results. SIMD implementations process 4 particles per iteration,
+    the tail is processed by scalar code.
+*/
+namespace ParticleKernels
+{
+enum class eImplementation
+{
+    SCALAR = 0, //!< reference implementation, always available
+    SSE, //!< 4 particles per iteration
+    NEON, //!< 4 particles per iteration, AArch64 only
+};
+
+/** Return true if implementation has been compiled in for current target. */
+bool IsImplementationAvailable(eImplementation implementation);
+
+/** Return the widest implementation available for current target. */
+eImplementation GetBestImplementation();
+
+/** Add `dt` to life of every particle. */
+void AdvanceLife(ParticlePool& pool, float32 dt, eImplementation implementation);
+
+/** Write life / lifeTime of every particle to `overLife`. */
+void ComputeOverLife(const ParticlePool& pool, float32* overLife, eImplementation implementation);
+
+/** Write value of `line` at every `overLife` to `values`, or 1 if there is no line. */
+void SampleLine(PropertyLine<float32>* line, const float32* overLife, uint32 count, float32* values);
+
+/**
+    Move every particle by its speed and rotate it by its spin:
+    `position += speed * (velocityScale * dt)`, `angle += spin * spinScale * dt`.
+*/
+void Integrate(ParticlePool& pool, const float32* velocityScale, const float32* spinScale, float32 dt, eImplementation implementation);
+
+/** Add `force * scale[i]` to acceleration of every particle. */
+void AccumulateForce(const Vector3& force, const float32* scale, uint32 count, float32* accelerationX, float32* accelerationY, float32* accelerationZ, eImplementation implementation);
+
+/** Apply accumulated acceleration to every particle: `speed += acceleration * dt`. */
+void Accelerate(ParticlePool& pool, const float32* accelerationX, const float32* accelerationY, const float32* accelerationZ, float32 dt, eImplementation implementation);
+
+/** Extend `bbox` with sphere of every particle, spheres are moved by `offset`. */
+void AddToBounds(const ParticlePool& pool, const Vector3& offset, AABBox3& bbox, eImplementation implementation);
+}
+}
@@ -167,6 +167,7 @@ ParticleLayer* ParticleLayer::Clone()
 
     if (stripeSizeOverLife)
         dstLayer->stripeSizeOverLife.Set(stripeSizeOverLife->Clone());
+    dstLayer->maxStripeOverLife = maxStripeOverLife;
 
     if (stripeTextureTileOverLife)
         dstLayer->stripeTextureTileOverLife.Set(stripeTextureTileOverLife->Clone());
@@ -520,6 +521,7 @@ void ParticleLayer::SetAlphaRemap(const FilePath& spritePath_)
 void ParticleLayer::LoadFromYaml(const FilePath& configPath, const YamlNode* node, bool preserveInheritPosition)
 {
     stripeSizeOverLife = PropertyLineYamlReader::CreatePropertyLine<float32>(node->Get("stripeSizeOverLifeProp"));
+    UpdateMaxStripeSizeOverLife();
     stripeTextureTileOverLife = PropertyLineYamlReader::CreatePropertyLine<float32>(node->Get("stripeTextureTileOverLife"));
     stripeColorOverLife = PropertyLineYamlReader::CreatePropertyLine<Color>(node->Get("stripeColorOverLife"));
     stripeNoiseUScrollSpeedOverLife = PropertyLineYamlReader::CreatePropertyLine<float32>(node->Get("stripeNoiseUScrollSpeedOverLife"));
@@ -1408,6 +1410,60 @@ void ParticleLayer::GetModifableLines(List<ModifiablePropertyLineBase*>& modifia
     }
 }
 
+void ParticleLayer::BakePropertyLines(float32 tolerance)
+{
+    PropertyLineHelper::Bake(stripeSizeOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(stripeTextureTileOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(stripeNoiseUScrollSpeedOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(stripeNoiseVScrollSpeedOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(stripeColorOverLife.Get(), tolerance);
+
+    PropertyLineHelper::Bake(alphaRemapOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(gradientMiddlePointLine.Get(), tolerance);
+
+    PropertyLineHelper::Bake(flowSpeed.Get(), tolerance);
+    PropertyLineHelper::Bake(flowSpeedVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(flowOffset.Get(), tolerance);
+    PropertyLineHelper::Bake(flowOffsetVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(noiseScale.Get(), tolerance);
+    PropertyLineHelper::Bake(noiseScaleVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(noiseScaleOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(noiseUScrollSpeed.Get(), tolerance);
+    PropertyLineHelper::Bake(noiseUScrollSpeedVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(noiseUScrollSpeedOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(noiseVScrollSpeed.Get(), tolerance);
+    PropertyLineHelper::Bake(noiseVScrollSpeedVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(noiseVScrollSpeedOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(life.Get(), tolerance);
+    PropertyLineHelper::Bake(lifeVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(number.Get(), tolerance);
+    PropertyLineHelper::Bake(numberVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(size.Get(), tolerance);
+    PropertyLineHelper::Bake(sizeVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(sizeOverLifeXY.Get(), tolerance);
+    PropertyLineHelper::Bake(velocity.Get(), tolerance);
+    PropertyLineHelper::Bake(velocityVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(velocityOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(spin.Get(), tolerance);
+    PropertyLineHelper::Bake(spinVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(spinOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(colorRandom.Get(), tolerance);
+    PropertyLineHelper::Bake(gradientColorForWhite.Get(), tolerance);
+    PropertyLineHelper::Bake(gradientColorForBlack.Get(), tolerance);
+    PropertyLineHelper::Bake(gradientColorForMiddle.Get(), tolerance);
+    PropertyLineHelper::Bake(alphaOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(colorOverLife.Get(), tolerance);
+    PropertyLineHelper::Bake(angle.Get(), tolerance);
+    PropertyLineHelper::Bake(angleVariation.Get(), tolerance);
+    PropertyLineHelper::Bake(animSpeedOverLife.Get(), tolerance);
+
+    for (ParticleForceSimplified* force : forcesSimplified)
+    {
+        PropertyLineHelper::Bake(force->force.Get(), tolerance);
+        PropertyLineHelper::Bake(force->forceOverLife.Get(), tolerance);
+    }
+}
+
 void ParticleLayer::AddSimplifiedForce(ParticleForceSimplified* force)
 {
     SafeRetain(force);
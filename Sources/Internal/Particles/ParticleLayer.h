@@ -39,7 +39,7 @@ struct ParticleLayer : public BaseObject
     float32 stripeFadeDistanceFromTop = 0.0f;
     RefPtr<PropertyLine<Color>> stripeColorOverLife;
 
-    float32 maxStripeOverLife = 0.0f;
+    float32 maxStripeOverLife = 1.0f;
 
     enum eType
     {
@@ -83,7 +83,12 @@ struct ParticleLayer : public BaseObject
     void RemoveSimplifiedForce(int32 forceIndex);
     void CleanupSimplifiedForces();
 
-    float32 CalculateMaxStripeSizeOverLife();
+    /**
+        Recalculate max value of `stripeSizeOverLife`, should be called after the line is changed.
+        Effect system calls it when stripe groups start, so stripe update on worker threads only reads the value.
+    */
+    void UpdateMaxStripeSizeOverLife();
+    float32 GetMaxStripeSizeOverLife() const;
     void AddForce(ParticleForce* force);
     void RemoveForce(ParticleForce* force);
     void RemoveForce(int32 forceIndex);
@@ -91,6 +96,9 @@ struct ParticleLayer : public BaseObject
 
     void GetModifableLines(List<ModifiablePropertyLineBase*>& modifiables);
 
+    /** Bake keyframed property lines of the layer into lookup tables, see `PropertyLineKeyframes::Bake`. */
+    void BakePropertyLines(float32 tolerance);
+
     // Convert from Layer Type to its name and vice versa.
     eType StringToLayerType(const String& layerTypeName, eType defaultLayerType);
     String LayerTypeToString(eType layerType, const String& defaultLayerTypeName);
@@ -236,7 +244,6 @@ struct ParticleLayer : public BaseObject
     bool enableFlow = false;
     bool enableFlowAnimation = false;
     bool usePerspectiveMapping = false;
-    bool isMaxStripeOverLifeDirty = true;
 
     bool useThreePointGradient = false;
     bool applyGlobalForces = false;
@@ -271,16 +278,16 @@ public:
     DAVA_VIRTUAL_REFLECTION(ParticleLayer, BaseObject);
 };
 
-inline float32 ParticleLayer::CalculateMaxStripeSizeOverLife()
+inline void ParticleLayer::UpdateMaxStripeSizeOverLife()
 {
     using Key = PropertyLine<float32>::PropertyKey;
 
-    if (!isMaxStripeOverLifeDirty)
-        return maxStripeOverLife;
-    if (stripeSizeOverLife.Get() == nullptr)
-        return 1.0f;
+    if (stripeSizeOverLife.Get() == nullptr || stripeSizeOverLife->GetValues().empty())
+    {
+        maxStripeOverLife = 1.0f;
+        return;
+    }
 
-    isMaxStripeOverLifeDirty = false;
     const Vector<Key>& keys = stripeSizeOverLife->GetValues();
     auto max = std::max_element(keys.begin(), keys.end(),
                                 [](const Key& a, const Key& b)
@@ -289,6 +296,10 @@ inline float32 ParticleLayer::CalculateMaxStripeSizeOverLife()
                                 }
                                 );
     maxStripeOverLife = (*max).value;
+}
+
+inline float32 ParticleLayer::GetMaxStripeSizeOverLife() const
+{
     return maxStripeOverLife;
 }
 
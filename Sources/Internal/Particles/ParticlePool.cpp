@@ -0,0 +1,78 @@
+#include "Particles/ParticlePool.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+uint32 ParticlePool::Add()
+{
+    uint32 index = size++;
+    if (life.size() < size)
+    {
+        // streams never shrink, so memory of dead particles is reused
+        life.resize(size);
+        lifeTime.resize(size);
+        positionX.resize(size);
+        positionY.resize(size);
+        positionZ.resize(size);
+        speedX.resize(size);
+        speedY.resize(size);
+        speedZ.resize(size);
+        angle.resize(size);
+        spin.resize(size);
+        radius.resize(size);
+        particles.resize(size);
+    }
+
+    life[index] = 0.0f;
+    lifeTime[index] = 0.0f;
+    positionX[index] = positionY[index] = positionZ[index] = 0.0f;
+    speedX[index] = speedY[index] = speedZ[index] = 0.0f;
+    angle[index] = 0.0f;
+    spin[index] = 0.0f;
+    radius[index] = 0.0f;
+    particles[index] = Particle();
+    return index;
+}
+
+void ParticlePool::Move(uint32 from, uint32 to)
+{
+    life[to] = life[from];
+    lifeTime[to] = lifeTime[from];
+    positionX[to] = positionX[from];
+    positionY[to] = positionY[from];
+    positionZ[to] = positionZ[from];
+    speedX[to] = speedX[from];
+    speedY[to] = speedY[from];
+    speedZ[to] = speedZ[from];
+    angle[to] = angle[from];
+    spin[to] = spin[from];
+    radius[to] = radius[from];
+    particles[to] = particles[from];
+}
+
+uint32 ParticlePool::RemoveDead()
+{
+    // single compaction pass, alive particles keep their relative order
+    uint32 alive = 0;
+    for (uint32 index = 0; index < size; ++index)
+    {
+        if (life[index] < lifeTime[index])
+        {
+            if (alive != index)
+            {
+                Move(index, alive);
+            }
+            ++alive;
+        }
+    }
+
+    uint32 removed = size - alive;
+    size = alive;
+    return removed;
+}
+
+void ParticlePool::Clear()
+{
+    size = 0;
+}
+}
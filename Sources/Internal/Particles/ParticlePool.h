@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/Vector.h"
+#include "Particles/Particle.h"
+
+namespace DAVA
+{
+/**
+    Particles of one particle group stored as structure of arrays.
+
+    State updated by simulation kernels every frame (life, position, speed, rotation and bounding radius) lives
+    in separate float streams, so kernels can load 4 particles with a single SIMD load.
+    The rest of particle state is kept in `Particle` records of parallel `particles` array.
+
+    Particles are kept in order of emission: new particles are appended and removal compacts the rest ones
+    without reordering them, so storage is always dense and memory of removed particles is reused by new ones
+    instead of allocating every particle on the heap. Particles are drawn from the newest to the oldest one,
+    as they were drawn from the head of the former linked list.
+    Index of a particle is valid only until the next removal. Streams may be longer than `GetSize()`,
+    elements past it are dead particles kept for reuse.
+*/
+class ParticlePool final
+{
+public:
+    /** Append particle with zeroed state and return its index. */
+    uint32 Add();
+
+    /** Remove every particle which life is over keeping order of the rest ones, return count of removed particles. */
+    uint32 RemoveDead();
+
+    void Clear();
+    uint32 GetSize() const;
+    bool IsEmpty() const;
+
+    Vector3 GetPosition(uint32 index) const;
+    void SetPosition(uint32 index, const Vector3& position);
+    Vector3 GetSpeed(uint32 index) const;
+    void SetSpeed(uint32 index, const Vector3& speed);
+    float32 GetOverLife(uint32 index) const;
+
+    /** Make particle at `index` dead, it's removed by the next `RemoveDead`. */
+    void Kill(uint32 index);
+
+    Vector<float32> life;
+    Vector<float32> lifeTime;
+    Vector<float32> positionX;
+    Vector<float32> positionY;
+    Vector<float32> positionZ;
+    Vector<float32> speedX;
+    Vector<float32> speedY;
+    Vector<float32> speedZ;
+    Vector<float32> angle;
+    Vector<float32> spin;
+    Vector<float32> radius; // for bbox computation
+    Vector<Particle> particles;
+
+private:
+    void Move(uint32 from, uint32 to);
+
+    uint32 size = 0;
+};
+
+inline uint32 ParticlePool::GetSize() const
+{
+    return size;
+}
+
+inline bool ParticlePool::IsEmpty() const
+{
+    return size == 0;
+}
+
+inline Vector3 ParticlePool::GetPosition(uint32 index) const
+{
+    return Vector3(positionX[index], positionY[index], positionZ[index]);
+}
+
+inline void ParticlePool::SetPosition(uint32 index, const Vector3& position)
+{
+    positionX[index] = position.x;
+    positionY[index] = position.y;
+    positionZ[index] = position.z;
+}
+
+inline Vector3 ParticlePool::GetSpeed(uint32 index) const
+{
+    return Vector3(speedX[index], speedY[index], speedZ[index]);
+}
+
+inline void ParticlePool::SetSpeed(uint32 index, const Vector3& speed)
+{
+    speedX[index] = speed.x;
+    speedY[index] = speed.y;
+    speedZ[index] = speed.z;
+}
+
+inline float32 ParticlePool::GetOverLife(uint32 index) const
+{
+    return life[index] / lifeTime[index];
+}
+
+inline void ParticlePool::Kill(uint32 index)
+{
+    life[index] = lifeTime[index] + 0.1f;
+}
+}
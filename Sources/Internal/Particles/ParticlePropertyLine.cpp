@@ -152,6 +152,30 @@ Color PropertyValueHelper::MakeUnityValue<Color>()
     return Color();
 }
 
+template <>
+float32 PropertyValueHelper::MaxAbsDifference<float32>(const float32& a, const float32& b)
+{
+    return Abs(a - b);
+}
+
+template <>
+float32 PropertyValueHelper::MaxAbsDifference<Vector2>(const Vector2& a, const Vector2& b)
+{
+    return Max(Abs(a.x - b.x), Abs(a.y - b.y));
+}
+
+template <>
+float32 PropertyValueHelper::MaxAbsDifference<Vector3>(const Vector3& a, const Vector3& b)
+{
+    return Max(Max(Abs(a.x - b.x), Abs(a.y - b.y)), Abs(a.z - b.z));
+}
+
+template <>
+float32 PropertyValueHelper::MaxAbsDifference<Color>(const Color& a, const Color& b)
+{
+    return Max(Max(Abs(a.r - b.r), Abs(a.g - b.g)), Max(Abs(a.b - b.b), Abs(a.a - b.a)));
+}
+
 Color ColorFromYamlNode(const YamlNode* node)
 {
     Color c;
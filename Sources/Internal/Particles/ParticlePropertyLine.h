@@ -4,6 +4,7 @@
 #include "FileSystem/YamlParser.h"
 #include "FileSystem/YamlNode.h"
 #include "Base/RefPtr.h"
+#include <algorithm>
 #include <limits>
 
 namespace DAVA
@@ -29,7 +30,17 @@ public:
         return keys;
     }
 
-    virtual const T& GetValue(float32 t) = 0;
+    /** Return value of the line at `t`. Doesn't change the line, so can be called from several threads at once. */
+    virtual T GetValue(float32 t) = 0;
+
+    /** Write values of the line at `count` points `t` to `values`. Same as `GetValue` for every point, but with one virtual call. */
+    virtual void GetValues(const float32* t, T* values, uint32 count)
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            values[i] = GetValue(t[i]);
+        }
+    }
 
     virtual PropertyLine<T>* Clone()
     {
@@ -42,6 +53,10 @@ class PropertyValueHelper
 public:
     template <class T>
     static T MakeUnityValue();
+
+    /** Return the largest absolute difference between components of `a` and `b`. */
+    template <class T>
+    static float32 MaxAbsDifference(const T& a, const T& b);
 };
 
 template <class T>
@@ -61,11 +76,18 @@ public:
         PropertyLine<T>::keys.push_back(v);
     }
 
-    const T& GetValue(float32 /*t*/)
+    using PropertyLine<T>::GetValues;
+
+    T GetValue(float32 /*t*/)
     {
         return PropertyLine<T>::keys[0].value;
     }
 
+    void GetValues(const float32* /*t*/, T* values, uint32 count)
+    {
+        std::fill(values, values + count, PropertyLine<T>::keys[0].value);
+    }
+
     PropertyLine<T>* Clone()
     {
         return new PropertyLineValue<T>(PropertyLine<T>::keys[0].value);
@@ -81,9 +103,46 @@ protected:
     }
 
 public:
-    T resultValue;
+    static const uint32 BAKE_MIN_RESOLUTION = 64;
+    static const uint32 BAKE_MAX_RESOLUTION = 256;
+
+    using PropertyLine<T>::GetValues;
+
+    T GetValue(float32 t)
+    {
+        return bakedValues.empty() ? GetKeyframesValue(t) : GetBakedValue(t);
+    }
+
+    void GetValues(const float32* t, T* values, uint32 count)
+    {
+        if (bakedValues.empty())
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                values[i] = GetKeyframesValue(t[i]);
+            }
+        }
+        else
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                values[i] = GetBakedValue(t[i]);
+            }
+        }
+    }
 
-    const T& GetValue(float32 t)
+    /**
+        Sample the line into a table of equally spaced values, after that values are linearly interpolated from the table
+        instead of searching keys. Resolution is doubled from `minResolution` up to `maxResolution` until difference
+        between the table and the keys is not greater than `tolerance`. Return false and keep evaluating keys
+        if the tolerance can't be reached or the line has less than two keys.
+        Table is dropped by `AddValue`, call `ResetBaked` after changing keys directly.
+    */
+    bool Bake(float32 tolerance, uint32 minResolution = BAKE_MIN_RESOLUTION, uint32 maxResolution = BAKE_MAX_RESOLUTION);
+    void ResetBaked();
+    bool IsBaked() const;
+
+    T GetKeyframesValue(float32 t) const
     {
         int32 keysSize = static_cast<int32>(PropertyLine<T>::keys.size());
         DVASSERT(keysSize);
@@ -100,8 +159,7 @@ public:
             if (t < PropertyLine<T>::keys[1].t)
             {
                 float ti = (t - PropertyLine<T>::keys[0].t) / (PropertyLine<T>::keys[1].t - PropertyLine<T>::keys[0].t);
-                resultValue = PropertyLine<T>::keys[0].value + (PropertyLine<T>::keys[1].value - PropertyLine<T>::keys[0].value) * ti;
-                return resultValue;
+                return PropertyLine<T>::keys[0].value + (PropertyLine<T>::keys[1].value - PropertyLine<T>::keys[0].value) * ti;
             }
             else
             {
@@ -115,12 +173,11 @@ public:
             int32 l = BinaryFind(t, 0, static_cast<int32>(PropertyLine<T>::keys.size()) - 1);
 
             float ti = (t - PropertyLine<T>::keys[l].t) / (PropertyLine<T>::keys[l + 1].t - PropertyLine<T>::keys[l].t);
-            resultValue = PropertyLine<T>::keys[l].value + (PropertyLine<T>::keys[l + 1].value - PropertyLine<T>::keys[l].value) * ti;
+            return PropertyLine<T>::keys[l].value + (PropertyLine<T>::keys[l + 1].value - PropertyLine<T>::keys[l].value) * ti;
         }
-        return resultValue;
     }
 
-    int32 BinaryFind(float32 t, int32 l, int32 r)
+    int32 BinaryFind(float32 t, int32 l, int32 r) const
     {
         if (l + 1 == r) // we've found a solution
         {
@@ -140,16 +197,87 @@ public:
         key.t = t;
         key.value = value;
         PropertyLine<T>::keys.push_back(key);
+        ResetBaked();
     }
 
     PropertyLine<T>* Clone()
     {
         PropertyLineKeyframes<T>* clone = new PropertyLineKeyframes<T>();
         clone->keys = PropertyLine<T>::keys;
+        clone->bakedValues = bakedValues;
+        clone->bakedStartT = bakedStartT;
+        clone->bakedScale = bakedScale;
         return clone;
     }
+
+private:
+    T GetBakedValue(float32 t) const
+    {
+        uint32 lastIndex = static_cast<uint32>(bakedValues.size()) - 1;
+        float32 position = Clamp((t - bakedStartT) * bakedScale, 0.0f, static_cast<float32>(lastIndex));
+        uint32 index = Min(static_cast<uint32>(position), lastIndex - 1);
+        float32 ti = position - static_cast<float32>(index);
+        return bakedValues[index] + (bakedValues[index + 1] - bakedValues[index]) * ti;
+    }
+
+    Vector<T> bakedValues;
+    float32 bakedStartT = 0.0f;
+    float32 bakedScale = 0.0f;
 };
 
+template <class T>
+bool PropertyLineKeyframes<T>::Bake(float32 tolerance, uint32 minResolution, uint32 maxResolution)
+{
+    ResetBaked();
+
+    const Vector<typename PropertyLine<T>::PropertyKey>& keys = PropertyLine<T>::keys;
+    if (keys.size() < 2 || !(keys.back().t > keys.front().t))
+    {
+        return false;
+    }
+
+    float32 startT = keys.front().t;
+    float32 range = keys.back().t - startT;
+    for (uint32 resolution = Max(minResolution, 2u); resolution <= maxResolution; resolution *= 2)
+    {
+        Vector<T> values(resolution);
+        for (uint32 i = 0; i < resolution; ++i)
+        {
+            values[i] = GetKeyframesValue(startT + range * static_cast<float32>(i) / static_cast<float32>(resolution - 1));
+        }
+        bakedValues.swap(values);
+        bakedStartT = startT;
+        bakedScale = static_cast<float32>(resolution - 1) / range;
+
+        // both the keys and the table are piecewise linear and the table is exact at its points,
+        // so the difference between them is the largest at one of the keys
+        float32 error = 0.0f;
+        for (const typename PropertyLine<T>::PropertyKey& key : keys)
+        {
+            error = Max(error, PropertyValueHelper::MaxAbsDifference(key.value, GetBakedValue(key.t)));
+        }
+        if (error <= tolerance)
+        {
+            return true;
+        }
+    }
+
+    ResetBaked();
+    return false;
+}
+
+template <class T>
+void PropertyLineKeyframes<T>::ResetBaked()
+{
+    bakedValues.clear();
+}
+
+template <class T>
+bool PropertyLineKeyframes<T>::IsBaked() const
+{
+    return !bakedValues.empty();
+}
+
 class ModifiablePropertyLineBase
 {
 public:
@@ -198,11 +326,13 @@ public:
     {
         return valueLine;
     }
-    const T& GetValue(float32 t);
+    using PropertyLine<T>::GetValues;
+
+    T GetValue(float32 t);
+    void GetValues(const float32* t, T* values, uint32 count);
     virtual PropertyLine<T>* Clone();
 
 protected:
-    T resultValue; //well - this how ProertyLine itself work - err
     T modifier;
     RefPtr<PropertyLine<T>> modificationLine;
     RefPtr<PropertyLine<T>> valueLine;
@@ -218,17 +348,28 @@ void ModifiablePropertyLine<T>::SetModifier(float32 v)
 }
 
 template <class T>
-const T& ModifiablePropertyLine<T>::GetValue(float32 t)
+T ModifiablePropertyLine<T>::GetValue(float32 t)
 {
     if (!valueLine)
     {
-        resultValue = T();
+        return T();
     }
-    else
+    return modifier * (valueLine->GetValue(t));
+}
+
+template <class T>
+void ModifiablePropertyLine<T>::GetValues(const float32* t, T* values, uint32 count)
+{
+    if (!valueLine)
+    {
+        std::fill(values, values + count, T());
+        return;
+    }
+    valueLine->GetValues(t, values, count);
+    for (uint32 i = 0; i < count; ++i)
     {
-        resultValue = modifier * (valueLine->GetValue(t));
+        values[i] = modifier * values[i];
     }
-    return resultValue;
 }
 
 template <class T>
@@ -543,6 +684,14 @@ public:
         return line;
     }
 
+    /** Bake value line of `line` into lookup table if it has keyframes, see `PropertyLineKeyframes::Bake`. */
+    template <class T>
+    static bool Bake(PropertyLine<T>* line, float32 tolerance)
+    {
+        PropertyLineKeyframes<T>* keyframes = dynamic_cast<PropertyLineKeyframes<T>*>(GetValueLine(line));
+        return keyframes != nullptr && keyframes->Bake(tolerance);
+    }
+
     template <class T>
     static RefPtr<PropertyLine<T>> RemoveModifiable(RefPtr<PropertyLine<T>>& line)
     {
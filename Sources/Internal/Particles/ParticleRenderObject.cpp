@@ -4,9 +4,20 @@
 #include "Render/DynamicBufferAllocator.h"
 #include "Render/Renderer.h"
 #include "Time/SystemTimer.h"
+#include "Engine/Engine.h"
+#include "Job/JobManager.h"
+
+#include <algorithm>
 
 namespace DAVA
 {
+namespace ParticleRenderObjectDetails
+{
+// vertices of smaller batches are written on the calling thread
+const uint32 PARALLEL_MIN_QUADS = 4096;
+const uint32 PARALLEL_GRAIN_QUADS = 1024;
+}
+
 ParticleRenderObject::ParticleRenderObject(ParticleEffectData* effect)
     : effectData(effect)
     , sortingOffset(15)
@@ -283,188 +294,218 @@ void ParticleRenderObject::AppendRenderBatch(NMaterial* material, uint32 indexCo
 
 void ParticleRenderObject::AppendParticleGroup(List<ParticleGroup>::iterator begin, List<ParticleGroup>::iterator end, uint32 particlesCount, const Vector3& cameraDirection, Vector3* basisVectors)
 {
+    using namespace ParticleRenderObjectDetails;
+
     if (!particlesCount)
         return; //hmmm?
 
     uint32 vertexStride = GetVertexStride(begin->layer); // If you change vertex layout, don't forget to change the stride.
 
-    uint32 verteciesToAllocate = particlesCount * 4;
-    DynamicBufferAllocator::AllocResultVB target = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, verteciesToAllocate);
-    uint8* currpos = target.data;
-
-    uint32 verteciesAppended = 0;
-    uint32 particleStride = vertexStride * 4;
-
     if (begin->material && begin->layer->useThreePointGradient)
         SetupThreePontGradient(*begin, begin->material);
 
+    // every particle is drawn as one quad per basis, quads of all groups are numbered in drawing order
+    quadGroups.clear();
+    uint32 quadsCount = 0;
     for (auto it = begin; it != end; ++it)
     {
         const ParticleGroup& group = *it;
         if (!CheckGroup(group))
             continue; //if no material was set up, or empty group, or layer rendering is disabled or sprite is removed - don't draw anyway
 
-        //prepare basis indexes
-        int32 basisCount = 0;
-        int32 basises[4]; //4 basises max per particle
-        basisCount = PrepareBasisIndexes(group, basises);
-
-        Particle* current = group.head;
-        while (current)
-        {
-            float32* pT = group.layer->sprite->GetTextureVerts(current->frame);
-            Color currColor = current->color;
-            if (group.layer->colorOverLife)
-                currColor = group.layer->colorOverLife->GetValue(current->life / current->lifeTime);
-            if (group.layer->alphaOverLife)
-                currColor.a = group.layer->alphaOverLife->GetValue(current->life / current->lifeTime);
-            uint32 color = rhi::NativeColorRGBA(currColor.r, currColor.g, currColor.b, Min(currColor.a, 1.0f));
-            float32 sin_angle;
-            float32 cos_angle;
-            SinCosFast(-current->angle, sin_angle, cos_angle); //- is because artists consider positive rotation to be clockwise
+        QuadGroup quadGroup;
+        quadGroup.group = &group;
+        quadGroup.basisCount = PrepareBasisIndexes(group, quadGroup.basises);
+        quadGroup.firstQuad = quadsCount;
+        quadsCount += group.particles.GetSize() * static_cast<uint32>(quadGroup.basisCount);
+        if (quadGroup.basisCount > 0)
+            quadGroups.push_back(quadGroup);
+    }
 
-            for (int32 i = 0; i < basisCount; i++)
-            {
-                if (verteciesAppended + 4 > target.allocatedVertices)
-                {
-                    uint32 vLayout = SelectLayout(*group.layer);
-                    AppendRenderBatch(group.material, verteciesAppended / 4 * 6, vLayout, target);
-                    verteciesToAllocate -= verteciesAppended;
-                    verteciesAppended = 0;
+    // buffers are allocated and batches are appended here, so their order doesn't depend on how quads are written
+    quadRanges.clear();
+    uint32 quadsAllocated = 0;
+    while (quadsAllocated < quadsCount)
+    {
+        DynamicBufferAllocator::AllocResultVB target = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, (quadsCount - quadsAllocated) * 4);
+        uint32 rangeQuads = Min(target.allocatedVertices / 4, quadsCount - quadsAllocated);
+        DVASSERT(rangeQuads > 0);
+        if (rangeQuads == 0)
+            break;
+
+        quadRanges.push_back({ target.data, quadsAllocated, rangeQuads });
+        AppendRenderBatch(begin->material, rangeQuads * 6, SelectLayout(*begin->layer), target);
+        quadsAllocated += rangeQuads;
+    }
 
-                    target = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, verteciesToAllocate);
-                    currpos = target.data;
-                }
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    const ParticleLayer& batchLayer = *begin->layer;
+    auto writeQuads = [&](uint32 beginQuad, uint32 endQuad) {
+        WriteParticleQuads(beginQuad, endQuad, batchLayer, vertexStride, cameraDirection, basisVectors);
+    };
+    if (jobManager != nullptr && jobManager->GetWorkersCount() > 1 && quadsAllocated >= PARALLEL_MIN_QUADS)
+    {
+        jobManager->ParallelFor(0, quadsAllocated, PARALLEL_GRAIN_QUADS, writeQuads);
+    }
+    else
+    {
+        writeQuads(0, quadsAllocated);
+    }
+}
 
-                float32* verts[4];
-                verts[0] = reinterpret_cast<float32*>(currpos);
-                verts[1] = reinterpret_cast<float32*>(currpos + vertexStride);
-                verts[2] = reinterpret_cast<float32*>(currpos + 2 * vertexStride);
-                verts[3] = reinterpret_cast<float32*>(currpos + 3 * vertexStride);
+void ParticleRenderObject::WriteParticleQuads(uint32 beginQuad, uint32 endQuad, const ParticleLayer& batchLayer, uint32 vertexStride, const Vector3& cameraDirection, const Vector3* basisVectors) const
+{
+    auto groupIt = std::upper_bound(quadGroups.begin(), quadGroups.end(), beginQuad, [](uint32 quad, const QuadGroup& group) { return quad < group.firstQuad; }) - 1;
+    auto rangeIt = std::upper_bound(quadRanges.begin(), quadRanges.end(), beginQuad, [](uint32 quad, const QuadRange& range) { return quad < range.firstQuad; }) - 1;
+    uint32 particleStride = vertexStride * 4;
 
-                Vector3 ex = basisVectors[basises[i] * 2];
-                Vector3 ey = basisVectors[basises[i] * 2 + 1];
-                //TODO: rethink this code - it should be easier
-                if (group.layer->isLong) //note that for now it's just a copy of long implementatio - later rethink it;
-                {
-                    ey = current->speed;
-                    float32 vel = ey.Length();
-                    float32 base = 0.0f;
-                    if (vel < EPSILON)
-                        ey = Vector3(0.0f, 0.0f, 1.0f);
-                    else
-                        base = group.layer->scaleVelocityBase / vel;
-                    ex = ey.CrossProduct(cameraDirection);
-                    ex.Normalize();
-                    ey *= (base + group.layer->scaleVelocityFactor); //optimized ex=(svBase+svFactor*vel)/vel
-                }
+    for (uint32 quad = beginQuad; quad < endQuad; ++quad)
+    {
+        // groups without particles take no quads, so several groups may start at the same quad
+        while (quad >= groupIt->firstQuad + groupIt->group->particles.GetSize() * static_cast<uint32>(groupIt->basisCount))
+            ++groupIt;
+        if (quad >= rangeIt->firstQuad + rangeIt->quadsCount)
+            ++rangeIt;
+
+        const ParticleGroup& group = *groupIt->group;
+        uint32 groupQuad = quad - groupIt->firstQuad;
+        // particles are drawn from the newest one, which is the last in pool
+        uint32 p = group.particles.GetSize() - 1 - groupQuad / static_cast<uint32>(groupIt->basisCount);
+        int32 basis = groupIt->basises[groupQuad % static_cast<uint32>(groupIt->basisCount)];
+        uint8* currpos = rangeIt->data + (quad - rangeIt->firstQuad) * particleStride;
+
+        const ParticlePool& particles = group.particles;
+        const Particle* current = &particles.particles[p];
+        float32* pT = group.layer->sprite->GetTextureVerts(current->frame);
+        Color currColor = current->color;
+        if (group.layer->colorOverLife)
+            currColor = group.layer->colorOverLife->GetValue(particles.GetOverLife(p));
+        if (group.layer->alphaOverLife)
+            currColor.a = group.layer->alphaOverLife->GetValue(particles.GetOverLife(p));
+        uint32 color = rhi::NativeColorRGBA(currColor.r, currColor.g, currColor.b, Min(currColor.a, 1.0f));
+        float32 sin_angle;
+        float32 cos_angle;
+        SinCosFast(-particles.angle[p], sin_angle, cos_angle); //- is because artists consider positive rotation to be clockwise
+
+        float32* verts[4];
+        verts[0] = reinterpret_cast<float32*>(currpos);
+        verts[1] = reinterpret_cast<float32*>(currpos + vertexStride);
+        verts[2] = reinterpret_cast<float32*>(currpos + 2 * vertexStride);
+        verts[3] = reinterpret_cast<float32*>(currpos + 3 * vertexStride);
+
+        Vector3 ex = basisVectors[basis * 2];
+        Vector3 ey = basisVectors[basis * 2 + 1];
+        //TODO: rethink this code - it should be easier
+        if (group.layer->isLong) //note that for now it's just a copy of long implementatio - later rethink it;
+        {
+            ey = particles.GetSpeed(p);
+            float32 vel = ey.Length();
+            float32 base = 0.0f;
+            if (vel < EPSILON)
+                ey = Vector3(0.0f, 0.0f, 1.0f);
+            else
+                base = group.layer->scaleVelocityBase / vel;
+            ex = ey.CrossProduct(cameraDirection);
+            ex.Normalize();
+            ey *= (base + group.layer->scaleVelocityFactor); //optimized ex=(svBase+svFactor*vel)/vel
+        }
 
-                Vector3 left = ex * cos_angle + ey * sin_angle;
-                Vector3 right = -left;
-                Vector3 top = ey * (-cos_angle) + ex * sin_angle;
-                Vector3 bot = -top;
+        Vector3 left = ex * cos_angle + ey * sin_angle;
+        Vector3 right = -left;
+        Vector3 top = ey * (-cos_angle) + ex * sin_angle;
+        Vector3 bot = -top;
 
-                float32 fresnelToAlpha = 0.0f;
-                if (begin->layer->useFresnelToAlpha)
-                {
-                    Vector3 viewNormal = left.CrossProduct(top);
-                    float32 dot = cameraDirection.DotProduct(viewNormal);
-                    dot = 1.0f - Abs(dot);
-                    fresnelToAlpha = FresnelShlick(dot, group.layer->fresnelToAlphaBias, group.layer->fresnelToAlphaPower);
-                }
+        float32 fresnelToAlpha = 0.0f;
+        if (batchLayer.useFresnelToAlpha)
+        {
+            Vector3 viewNormal = left.CrossProduct(top);
+            float32 dot = cameraDirection.DotProduct(viewNormal);
+            dot = 1.0f - Abs(dot);
+            fresnelToAlpha = FresnelShlick(dot, group.layer->fresnelToAlphaBias, group.layer->fresnelToAlphaPower);
+        }
 
-                left *= 0.5f * current->currSize.x * (1 + group.layer->layerPivotPoint.x);
-                right *= 0.5f * current->currSize.x * (1 - group.layer->layerPivotPoint.x);
-                top *= 0.5f * current->currSize.y * (1 + group.layer->layerPivotPoint.y);
-                bot *= 0.5f * current->currSize.y * (1 - group.layer->layerPivotPoint.y);
+        left *= 0.5f * current->currSize.x * (1 + group.layer->layerPivotPoint.x);
+        right *= 0.5f * current->currSize.x * (1 - group.layer->layerPivotPoint.x);
+        top *= 0.5f * current->currSize.y * (1 + group.layer->layerPivotPoint.y);
+        bot *= 0.5f * current->currSize.y * (1 - group.layer->layerPivotPoint.y);
 
-                Vector3 particlePosition = current->position;
-                if (group.layer->GetInheritPosition())
-                    particlePosition += effectData->infoSources[group.positionSource].position;
-                Array<Vector3, 4> quadPos = { particlePosition + left + bot, particlePosition + right + bot, particlePosition + left + top, particlePosition + right + top };
-                uint32 ptrOffset = 0;
+        Vector3 particlePosition = particles.GetPosition(p);
+        if (group.layer->GetInheritPosition())
+            particlePosition += effectData->infoSources[group.positionSource].position;
+        Array<Vector3, 4> quadPos = { particlePosition + left + bot, particlePosition + right + bot, particlePosition + left + top, particlePosition + right + top };
+        uint32 ptrOffset = 0;
 
-                for (int32 i = 0; i < 4; i++)
-                {
-                    verts[i][ptrOffset + 0] = quadPos[i].x; // Position xyz.
-                    verts[i][ptrOffset + 1] = quadPos[i].y;
-                    verts[i][ptrOffset + 2] = quadPos[i].z;
-
-                    verts[i][ptrOffset + 3] = pT[i * 2]; // VS_TEXCOORD0 xy + color.
-                    verts[i][ptrOffset + 4] = pT[i * 2 + 1];
-                    uint32* cp = reinterpret_cast<uint32*>(verts[i]) + (ptrOffset + 5);
-                    *cp = color;
-                }
-                ptrOffset += 6;
+        for (int32 i = 0; i < 4; i++)
+        {
+            verts[i][ptrOffset + 0] = quadPos[i].x; // Position xyz.
+            verts[i][ptrOffset + 1] = quadPos[i].y;
+            verts[i][ptrOffset + 2] = quadPos[i].z;
+
+            verts[i][ptrOffset + 3] = pT[i * 2]; // VS_TEXCOORD0 xy + color.
+            verts[i][ptrOffset + 4] = pT[i * 2 + 1];
+            uint32* cp = reinterpret_cast<uint32*>(verts[i]) + (ptrOffset + 5);
+            *cp = color;
+        }
+        ptrOffset += 6;
 
-                if (begin->layer->enableFrameBlend)
-                {
-                    int32 nextFrame = current->frame + 1;
-                    if (nextFrame >= group.layer->sprite->GetFrameCount())
-                    {
-                        if (group.layer->loopSpriteAnimation)
-                            nextFrame = 0;
-                        else
-                            nextFrame = group.layer->sprite->GetFrameCount() - 1;
-                    }
-                    float32* pT = group.layer->sprite->GetTextureVerts(nextFrame);
+        if (batchLayer.enableFrameBlend)
+        {
+            int32 nextFrame = current->frame + 1;
+            if (nextFrame >= group.layer->sprite->GetFrameCount())
+            {
+                if (group.layer->loopSpriteAnimation)
+                    nextFrame = 0;
+                else
+                    nextFrame = group.layer->sprite->GetFrameCount() - 1;
+            }
+            float32* pT = group.layer->sprite->GetTextureVerts(nextFrame);
 
-                    for (int32 i = 0; i < 4; i++) // VS_TEXCOORD1 xy + time.
-                    {
-                        verts[i][ptrOffset] = *(pT++);
-                        verts[i][ptrOffset + 1] = *(pT++);
-                        verts[i][ptrOffset + 2] = current->animTime;
-                    }
-                    ptrOffset += 3;
-                }
-                if (begin->layer->enableFlow && begin->layer->flowmap.get() != nullptr)
-                {
-                    float32* flowUV = group.layer->flowmap->GetTextureVerts(current->frame);
-                    for (int32 i = 0; i < 4; i++) // VS_TEXCOORD2.xy, z - speed, w - offset.
-                    {
-                        verts[i][ptrOffset + 0] = flowUV[i * 2];
-                        verts[i][ptrOffset + 1] = flowUV[i * 2 + 1];
-                        verts[i][ptrOffset + 2] = current->currFlowSpeed;
-                        verts[i][ptrOffset + 3] = current->currFlowOffset;
-                    }
-                    ptrOffset += 4;
-                }
-                if (begin->layer->enableNoise && begin->layer->noise.get() != nullptr)
-                {
-                    float32* noiseUV = group.layer->noise->GetTextureVerts(current->frame);
-                    for (int32 i = 0; i < 4; ++i)
-                    {
-                        verts[i][ptrOffset + 0] = noiseUV[i * 2]; // VS_TEXCOORD0 xy + color.
-                        verts[i][ptrOffset + 1] = noiseUV[i * 2 + 1];
-                        verts[i][ptrOffset + 2] = current->currNoiseScale;
-                        if (begin->layer->enableNoiseScroll)
-                        {
-                            verts[i][ptrOffset + 0] += current->currNoiseUOffset;
-                            verts[i][ptrOffset + 1] += current->currNoiseVOffset;
-                        }
-                    }
-                    ptrOffset += 3;
-                }
-                if (begin->layer->enableAlphaRemap || begin->layer->useFresnelToAlpha)
+            for (int32 i = 0; i < 4; i++) // VS_TEXCOORD1 xy + time.
+            {
+                verts[i][ptrOffset] = *(pT++);
+                verts[i][ptrOffset + 1] = *(pT++);
+                verts[i][ptrOffset + 2] = current->animTime;
+            }
+            ptrOffset += 3;
+        }
+        if (batchLayer.enableFlow && batchLayer.flowmap.get() != nullptr)
+        {
+            float32* flowUV = group.layer->flowmap->GetTextureVerts(current->frame);
+            for (int32 i = 0; i < 4; i++) // VS_TEXCOORD2.xy, z - speed, w - offset.
+            {
+                verts[i][ptrOffset + 0] = flowUV[i * 2];
+                verts[i][ptrOffset + 1] = flowUV[i * 2 + 1];
+                verts[i][ptrOffset + 2] = current->currFlowSpeed;
+                verts[i][ptrOffset + 3] = current->currFlowOffset;
+            }
+            ptrOffset += 4;
+        }
+        if (batchLayer.enableNoise && batchLayer.noise.get() != nullptr)
+        {
+            float32* noiseUV = group.layer->noise->GetTextureVerts(current->frame);
+            for (int32 i = 0; i < 4; ++i)
+            {
+                verts[i][ptrOffset + 0] = noiseUV[i * 2]; // VS_TEXCOORD0 xy + color.
+                verts[i][ptrOffset + 1] = noiseUV[i * 2 + 1];
+                verts[i][ptrOffset + 2] = current->currNoiseScale;
+                if (batchLayer.enableNoiseScroll)
                 {
-                    for (int32 i = 0; i < 4; ++i)
-                    {
-                        verts[i][ptrOffset + 0] = fresnelToAlpha;
-                        verts[i][ptrOffset + 1] = current->alphaRemap;
-                        verts[i][ptrOffset + 2] = 0.0f;
-                    }
-                    ptrOffset += 3;
+                    verts[i][ptrOffset + 0] += current->currNoiseUOffset;
+                    verts[i][ptrOffset + 1] += current->currNoiseVOffset;
                 }
-                currpos += particleStride;
-                verteciesAppended += 4;
             }
-            current = current->next;
+            ptrOffset += 3;
+        }
+        if (batchLayer.enableAlphaRemap || batchLayer.useFresnelToAlpha)
+        {
+            for (int32 i = 0; i < 4; ++i)
+            {
+                verts[i][ptrOffset + 0] = fresnelToAlpha;
+                verts[i][ptrOffset + 1] = current->alphaRemap;
+                verts[i][ptrOffset + 2] = 0.0f;
+            }
+            ptrOffset += 3;
         }
-    }
-
-    if (verteciesAppended)
-    {
-        AppendRenderBatch(begin->material, verteciesAppended / 4 * 6, SelectLayout(*begin->layer), target);
     }
 }
 
@@ -489,22 +530,21 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
         if (basisCount == 0)
             continue;
 
-        Particle* currentParticle = group.head;
-        while (currentParticle)
+        ParticlePool& particles = group.particles;
+        for (uint32 p = particles.GetSize(); p-- > 0;)
         {
             StripeData& data = group.stripe;
             if (!data.isActive)
-            {
-                currentParticle = currentParticle->next;
                 continue;
-            }
+
+            Particle* currentParticle = &particles.particles[p];
 
             float32* pT = group.layer->sprite->GetTextureVerts(currentParticle->frame);
             Color currColor = currentParticle->color;
             if (group.layer->colorOverLife)
-                currColor = group.layer->colorOverLife->GetValue(currentParticle->life / currentParticle->lifeTime);
+                currColor = group.layer->colorOverLife->GetValue(particles.GetOverLife(p));
             if (group.layer->alphaOverLife)
-                currColor.a = group.layer->alphaOverLife->GetValue(currentParticle->life / currentParticle->lifeTime);
+                currColor.a = group.layer->alphaOverLife->GetValue(particles.GetOverLife(p));
 
             StripeNode& base = data.baseNode;
             List<StripeNode>& nodes = data.stripeNodes;
@@ -567,10 +607,10 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
                 float32 tile = 1.0f;
                 if (group.layer->stripeTextureTileOverLife)
                     tile = group.layer->stripeTextureTileOverLife->GetValue(0.0f);
-                float32 startU = currentParticle->life * group.layer->stripeUScrollSpeed;
-                float32 startV = currentParticle->life * group.layer->stripeVScrollSpeed;
+                float32 startU = particles.life[p] * group.layer->stripeUScrollSpeed;
+                float32 startV = particles.life[p] * group.layer->stripeVScrollSpeed;
                 if (Abs(data.uvOffset) > EPSILON)
-                    startV += data.uvOffset * tile + currentParticle->life * group.layer->stripeVScrollSpeed;
+                    startV += data.uvOffset * tile + particles.life[p] * group.layer->stripeVScrollSpeed;
 
                 Vector3 uv1 = Vector3(startU, startV, 0.0f);
                 Vector3 uv2 = Vector3(startU + 1.0f, startV, 0.0f);
@@ -642,9 +682,9 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
                     tile = 1.0f;
                     if (group.layer->stripeTextureTileOverLife)
                         tile = group.layer->stripeTextureTileOverLife->GetValue(overLifeTime);
-                    float32 v = distance * tile + currentParticle->life * group.layer->stripeVScrollSpeed;
+                    float32 v = distance * tile + particles.life[p] * group.layer->stripeVScrollSpeed;
                     if (Abs(data.uvOffset) > EPSILON)
-                        v += data.uvOffset * tile + currentParticle->life * group.layer->stripeVScrollSpeed;
+                        v += data.uvOffset * tile + particles.life[p] * group.layer->stripeVScrollSpeed;
 
                     if (group.layer->usePerspectiveMapping)
                     {
@@ -674,7 +714,6 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
                 baseVertex += vCountInBasis;
             }
             AppendRenderBatch(begin->material, iCount, SelectLayout(*begin->layer), vb, ib.buffer, ib.baseIndex);
-            currentParticle = currentParticle->next;
         }
     }
 }
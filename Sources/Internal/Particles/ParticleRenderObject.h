@@ -73,6 +73,27 @@ private:
     };
     Map<uint32, LayoutElement> layoutsData;
 
+    /** Particles of one group which quads are written to vertex buffers of current batch. */
+    struct QuadGroup
+    {
+        const ParticleGroup* group = nullptr;
+        uint32 firstQuad = 0;
+        int32 basisCount = 0;
+        int32 basises[4]; //4 basises max per particle
+    };
+    /** Quads written to one allocated vertex buffer. */
+    struct QuadRange
+    {
+        uint8* data;
+        uint32 firstQuad;
+        uint32 quadsCount;
+    };
+    Vector<QuadGroup> quadGroups;
+    Vector<QuadRange> quadRanges;
+
+    /** Write vertices of quads [beginQuad, endQuad) of `quadGroups` to `quadRanges`, called from worker threads for big batches. */
+    void WriteParticleQuads(uint32 beginQuad, uint32 endQuad, const ParticleLayer& batchLayer, uint32 vertexStride, const Vector3& cameraDirection, const Vector3* basisVectors) const;
+
     uint32 GetVertexStride(ParticleLayer* layer);
     int32 CalculateParticleCount(const ParticleGroup& group);
     uint32 SelectLayout(const ParticleLayer& layer);
@@ -107,6 +128,6 @@ inline bool ParticleRenderObject::CheckIfSimpleParticle(ParticleLayer* layer) co
 
 inline bool ParticleRenderObject::CheckGroup(const ParticleGroup& group) const
 {
-    return group.material && group.head && !group.layer->isDisabled && group.layer->sprite;
+    return group.material && !group.particles.IsEmpty() && !group.layer->isDisabled && group.layer->sprite;
 }
 }
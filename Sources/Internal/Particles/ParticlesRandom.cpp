@@ -43,5 +43,16 @@ float32 VanDerCorputRnd(float32 min, float32 max, uint32 n, uint32 base)
 {
     return (max - min) * VanDerCorputRnd(n, base) + min;
 }
+
+uint32 Hash(uint32 value)
+{
+    // finalizer of MurmurHash3
+    value ^= value >> 16;
+    value *= 0x85ebca6b;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35;
+    value ^= value >> 16;
+    return value;
+}
 }
 }
\ No newline at end of file
@@ -10,5 +10,58 @@ float32 HammersleyRnd(uint32 n);
 float32 HammersleyRnd(float32 min, float32 max, uint32 n);
 float32 VanDerCorputRnd(uint32 n, uint32 base);
 float32 VanDerCorputRnd(float32 min, float32 max, uint32 n, uint32 base);
+
+/** Scramble bits of `value`, close values give unrelated results. */
+uint32 Hash(uint32 value);
+
+/**
+    Small deterministic random generator (xorshift).
+
+    Every particle effect owns one, so sequence of random values an effect gets depends only on its seed,
+    not on other effects or on the order and threads effects are updated on.
+*/
+class Generator
+{
+public:
+    explicit Generator(uint32 seed = 0);
+
+    void Seed(uint32 seed);
+
+    /** Return uniformly distributed 32-bit value. */
+    uint32 Rand();
+
+    /** Return uniformly distributed value in [0, 1). */
+    float32 RandFloat();
+
+private:
+    uint32 state = 0;
+};
+
+inline Generator::Generator(uint32 seed)
+{
+    Seed(seed);
+}
+
+inline void Generator::Seed(uint32 seed)
+{
+    state = Hash(seed);
+    if (state == 0)
+    {
+        state = 0x9e3779b9; // xorshift never leaves zero state
+    }
+}
+
+inline uint32 Generator::Rand()
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+inline float32 Generator::RandFloat()
+{
+    return static_cast<float32>(Rand() >> 8) * (1.0f / 16777216.0f);
+}
 }
 }
@@ -258,6 +258,12 @@ class NonSerializableComponent
 {
 };
 
+/** Says that all data of type derived from Component and marked by this Meta is stored in its reflected fields,
+    so flat scene format may serialize it field by field instead of through KeyedArchive */
+class FlatSerializableComponent
+{
+};
+
 /** Indicate field in current type, that will return tooltip */
 class Tooltip
 {
@@ -267,6 +267,12 @@ using NonExportableComponent = Meta<Metas::NonExportableComponent>;
 */
 using NonSerializableComponent = Meta<Metas::NonSerializableComponent>;
 
+/**
+    \ingroup metas
+    Says that component marked by this Meta can be stored in flat scene format through its reflected fields
+*/
+using FlatSerializableComponent = Meta<Metas::FlatSerializableComponent>;
+
 using Tooltip = Meta<Metas::Tooltip>;
 using IntColor = Meta<Metas::IntColor>;
 
@@ -93,7 +93,7 @@ public:
     bool IsInside(const Vector3& point, const float32 radius) const;
 
     //! \brief function return real plane count in this frustum
-    inline int32 GetPlaneCount()
+    inline int32 GetPlaneCount() const
     {
         return planeCount;
     }
@@ -105,6 +105,11 @@ public:
         return planeArray[i];
     }
 
+    inline const Plane& GetPlane(int32 i) const
+    {
+        return planeArray[i];
+    }
+
     //
     void DebugDraw(RenderHelper* drawer);
 
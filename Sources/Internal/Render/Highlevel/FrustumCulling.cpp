@@ -0,0 +1,378 @@
+#include "Render/Highlevel/FrustumCulling.h"
+#include "Render/Highlevel/Frustum.h"
+#include "Debug/DVAssert.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
+
+#if defined(__AVX__)
+#define FRUSTUM_CULLING_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define FRUSTUM_CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FRUSTUM_CULLING_NEON
+#include <arm_neon.h>
+#endif
+
+namespace DAVA
+{
+uint32 BoundingBoxSoA::Add(const AABBox3& box)
+{
+    uint32 index = size;
+    Reserve(size + 1);
+    ++size;
+    Set(index, box);
+    return index;
+}
+
+void BoundingBoxSoA::Set(uint32 index, const AABBox3& box)
+{
+    DVASSERT(index < size);
+    minX[index] = box.min.x;
+    minY[index] = box.min.y;
+    minZ[index] = box.min.z;
+    maxX[index] = box.max.x;
+    maxY[index] = box.max.y;
+    maxZ[index] = box.max.z;
+}
+
+AABBox3 BoundingBoxSoA::Get(uint32 index) const
+{
+    DVASSERT(index < size);
+    return AABBox3(Vector3(minX[index], minY[index], minZ[index]), Vector3(maxX[index], maxY[index], maxZ[index]));
+}
+
+void BoundingBoxSoA::RemoveBySwapWithLast(uint32 index)
+{
+    DVASSERT(index < size);
+    uint32 last = size - 1;
+    if (index != last)
+    {
+        Set(index, Get(last));
+    }
+
+    // keep padding zeroed
+    minX[last] = minY[last] = minZ[last] = 0.0f;
+    maxX[last] = maxY[last] = maxZ[last] = 0.0f;
+    --size;
+}
+
+void BoundingBoxSoA::Remove(uint32 index)
+{
+    DVASSERT(index < size);
+    for (uint32 i = index + 1; i < size; ++i)
+    {
+        Set(i - 1, Get(i));
+    }
+    RemoveBySwapWithLast(size - 1);
+}
+
+void BoundingBoxSoA::Clear()
+{
+    size = 0;
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+}
+
+void BoundingBoxSoA::Reserve(uint32 count)
+{
+    size_t paddedCount = ((count + PADDING - 1) / PADDING) * PADDING;
+    if (paddedCount > minX.size())
+    {
+        minX.resize(paddedCount, 0.0f);
+        minY.resize(paddedCount, 0.0f);
+        minZ.resize(paddedCount, 0.0f);
+        maxX.resize(paddedCount, 0.0f);
+        maxY.resize(paddedCount, 0.0f);
+        maxZ.resize(paddedCount, 0.0f);
+    }
+}
+
+namespace FrustumCullingDetails
+{
+/**
+    Frustum planes prepared for batch test.
+    For every plane we select coordinate arrays of the box corner which is the farthest along the plane normal
+    (the same `minTest` point `Frustum::Classify` uses), so kernels don't need per-box selects.
+*/
+struct CullingPlanes
+{
+    uint32 count = 0;
+    float32 nx[6];
+    float32 ny[6];
+    float32 nz[6];
+    float32 d[6];
+    const float32* x[6];
+    const float32* y[6];
+    const float32* z[6];
+};
+
+void PreparePlanes(const Frustum& frustum, const BoundingBoxSoA& boxes, CullingPlanes& planes)
+{
+    planes.count = static_cast<uint32>(frustum.GetPlaneCount());
+    DVASSERT(planes.count <= 6);
+
+    for (uint32 i = 0; i < planes.count; ++i)
+    {
+        const Plane& plane = frustum.GetPlane(static_cast<int32>(i));
+        planes.nx[i] = plane.n.x;
+        planes.ny[i] = plane.n.y;
+        planes.nz[i] = plane.n.z;
+        planes.d[i] = plane.d;
+        planes.x[i] = (plane.n.x >= 0.0f) ? boxes.GetMinX() : boxes.GetMaxX();
+        planes.y[i] = (plane.n.y >= 0.0f) ? boxes.GetMinY() : boxes.GetMaxY();
+        planes.z[i] = (plane.n.z >= 0.0f) ? boxes.GetMinZ() : boxes.GetMaxZ();
+    }
+}
+
+// All kernels evaluate distance as ((nx * x + ny * y) + nz * z) + d without fused operations,
+// which is the same sequence Plane::DistanceToPoint uses, so results are bit-exact with Frustum::Classify.
+
+void CullWordsScalar(const CullingPlanes& planes, uint32 firstWord, uint32 wordCount, uint32* mask)
+{
+    for (uint32 w = firstWord; w < firstWord + wordCount; ++w)
+    {
+        uint32 visible = 0;
+        for (uint32 bit = 0; bit < 32; ++bit)
+        {
+            uint32 i = w * 32 + bit;
+            bool outside = false;
+            for (uint32 p = 0; p < planes.count; ++p)
+            {
+                float32 dist = planes.nx[p] * planes.x[p][i] + planes.ny[p] * planes.y[p][i] + planes.nz[p] * planes.z[p][i] + planes.d[p];
+                if (dist > 0.0f)
+                {
+                    outside = true;
+                    break;
+                }
+            }
+            visible |= (outside ? 0u : 1u) << bit;
+        }
+        mask[w] = visible;
+    }
+}
+
+#if defined(FRUSTUM_CULLING_SSE)
+void CullWordsSSE(const CullingPlanes& planes, uint32 firstWord, uint32 wordCount, uint32* mask)
+{
+    const __m128 zero = _mm_setzero_ps();
+    for (uint32 w = firstWord; w < firstWord + wordCount; ++w)
+    {
+        uint32 visible = 0;
+        for (uint32 bit = 0; bit < 32; bit += 4)
+        {
+            uint32 i = w * 32 + bit;
+            __m128 outside = zero;
+            for (uint32 p = 0; p < planes.count; ++p)
+            {
+                __m128 dist = _mm_mul_ps(_mm_set1_ps(planes.nx[p]), _mm_loadu_ps(planes.x[p] + i));
+                dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(planes.ny[p]), _mm_loadu_ps(planes.y[p] + i)));
+                dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(planes.nz[p]), _mm_loadu_ps(planes.z[p] + i)));
+                dist = _mm_add_ps(dist, _mm_set1_ps(planes.d[p]));
+                outside = _mm_or_ps(outside, _mm_cmpgt_ps(dist, zero));
+            }
+            uint32 outsideBits = static_cast<uint32>(_mm_movemask_ps(outside));
+            visible |= (~outsideBits & 0xfu) << bit;
+        }
+        mask[w] = visible;
+    }
+}
+#endif
+
+#if defined(FRUSTUM_CULLING_AVX)
+void CullWordsAVX(const CullingPlanes& planes, uint32 firstWord, uint32 wordCount, uint32* mask)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    for (uint32 w = firstWord; w < firstWord + wordCount; ++w)
+    {
+        uint32 visible = 0;
+        for (uint32 bit = 0; bit < 32; bit += 8)
+        {
+            uint32 i = w * 32 + bit;
+            __m256 outside = zero;
+            for (uint32 p = 0; p < planes.count; ++p)
+            {
+                __m256 dist = _mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), _mm256_loadu_ps(planes.x[p] + i));
+                dist = _mm256_add_ps(dist, _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), _mm256_loadu_ps(planes.y[p] + i)));
+                dist = _mm256_add_ps(dist, _mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), _mm256_loadu_ps(planes.z[p] + i)));
+                dist = _mm256_add_ps(dist, _mm256_set1_ps(planes.d[p]));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, zero, _CMP_GT_OQ));
+            }
+            uint32 outsideBits = static_cast<uint32>(_mm256_movemask_ps(outside));
+            visible |= (~outsideBits & 0xffu) << bit;
+        }
+        mask[w] = visible;
+    }
+}
+#endif
+
+#if defined(FRUSTUM_CULLING_NEON)
+void CullWordsNEON(const CullingPlanes& planes, uint32 firstWord, uint32 wordCount, uint32* mask)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const uint32 laneBitsData[4] = { 1, 2, 4, 8 };
+    const uint32x4_t laneBits = vld1q_u32(laneBitsData);
+
+    for (uint32 w = firstWord; w < firstWord + wordCount; ++w)
+    {
+        uint32 visible = 0;
+        for (uint32 bit = 0; bit < 32; bit += 4)
+        {
+            uint32 i = w * 32 + bit;
+            uint32x4_t outside = vdupq_n_u32(0);
+            for (uint32 p = 0; p < planes.count; ++p)
+            {
+                // vmulq + vaddq instead of vmlaq/vfmaq to keep the same rounding as scalar code
+                float32x4_t dist = vmulq_f32(vdupq_n_f32(planes.nx[p]), vld1q_f32(planes.x[p] + i));
+                dist = vaddq_f32(dist, vmulq_f32(vdupq_n_f32(planes.ny[p]), vld1q_f32(planes.y[p] + i)));
+                dist = vaddq_f32(dist, vmulq_f32(vdupq_n_f32(planes.nz[p]), vld1q_f32(planes.z[p] + i)));
+                dist = vaddq_f32(dist, vdupq_n_f32(planes.d[p]));
+                outside = vorrq_u32(outside, vcgtq_f32(dist, zero));
+            }
+            uint32x4_t bits = vandq_u32(outside, laneBits);
+            uint32x2_t pairs = vorr_u32(vget_low_u32(bits), vget_high_u32(bits));
+            uint32 outsideBits = vget_lane_u32(pairs, 0) | vget_lane_u32(pairs, 1);
+            visible |= (~outsideBits & 0xfu) << bit;
+        }
+        mask[w] = visible;
+    }
+}
+#endif
+
+void CullWords(const CullingPlanes& planes, uint32 firstWord, uint32 wordCount, uint32* mask, FrustumCulling::eImplementation implementation)
+{
+    switch (implementation)
+    {
+#if defined(FRUSTUM_CULLING_SSE)
+    case FrustumCulling::eImplementation::SSE:
+        CullWordsSSE(planes, firstWord, wordCount, mask);
+        break;
+#endif
+#if defined(FRUSTUM_CULLING_AVX)
+    case FrustumCulling::eImplementation::AVX:
+        CullWordsAVX(planes, firstWord, wordCount, mask);
+        break;
+#endif
+#if defined(FRUSTUM_CULLING_NEON)
+    case FrustumCulling::eImplementation::NEON:
+        CullWordsNEON(planes, firstWord, wordCount, mask);
+        break;
+#endif
+    default:
+        DVASSERT(implementation == FrustumCulling::eImplementation::SCALAR, "Requested culling implementation is not available");
+        CullWordsScalar(planes, firstWord, wordCount, mask);
+        break;
+    }
+}
+
+void ClearPaddingBits(uint32 boxCount, uint32 firstWord, uint32 wordCount, uint32* mask)
+{
+    uint32 lastWord = boxCount / 32;
+    uint32 tailBits = boxCount % 32;
+    if (tailBits != 0 && lastWord >= firstWord && lastWord < firstWord + wordCount)
+    {
+        mask[lastWord] &= (1u << tailBits) - 1;
+    }
+}
+
+const uint32 PARALLEL_GRAIN_WORDS = 128;
+}
+
+namespace FrustumCulling
+{
+bool IsImplementationAvailable(eImplementation implementation)
+{
+    switch (implementation)
+    {
+    case eImplementation::SCALAR:
+        return true;
+#if defined(FRUSTUM_CULLING_SSE)
+    case eImplementation::SSE:
+        return true;
+#endif
+#if defined(FRUSTUM_CULLING_AVX)
+    case eImplementation::AVX:
+        return true;
+#endif
+#if defined(FRUSTUM_CULLING_NEON)
+    case eImplementation::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+eImplementation GetBestImplementation()
+{
+#if defined(FRUSTUM_CULLING_AVX)
+    return eImplementation::AVX;
+#elif defined(FRUSTUM_CULLING_SSE)
+    return eImplementation::SSE;
+#elif defined(FRUSTUM_CULLING_NEON)
+    return eImplementation::NEON;
+#else
+    return eImplementation::SCALAR;
+#endif
+}
+
+void CullRange(const Frustum& frustum, const BoundingBoxSoA& boxes, uint32 firstWord, uint32 wordCount, uint32* visibilityMask, eImplementation implementation)
+{
+    using namespace FrustumCullingDetails;
+
+    DVASSERT(firstWord + wordCount <= GetMaskWordCount(boxes.GetSize()));
+    if (wordCount == 0)
+    {
+        return;
+    }
+
+    CullingPlanes planes;
+    PreparePlanes(frustum, boxes, planes);
+    CullWords(planes, firstWord, wordCount, visibilityMask, implementation);
+    ClearPaddingBits(boxes.GetSize(), firstWord, wordCount, visibilityMask);
+}
+
+void Cull(const Frustum& frustum, const BoundingBoxSoA& boxes, Vector<uint32>& visibilityMask)
+{
+    using namespace FrustumCullingDetails;
+
+    uint32 wordCount = GetMaskWordCount(boxes.GetSize());
+    visibilityMask.resize(wordCount);
+    if (wordCount == 0)
+    {
+        return;
+    }
+
+    CullingPlanes planes;
+    PreparePlanes(frustum, boxes, planes);
+
+    eImplementation implementation = GetBestImplementation();
+    uint32* mask = visibilityMask.data();
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (jobManager != nullptr && jobManager->GetWorkersCount() > 1 && boxes.GetSize() >= PARALLEL_CULLING_THRESHOLD)
+    {
+        // every job writes its own range of mask words, so no synchronization is needed
+        jobManager->ParallelFor(0, wordCount, PARALLEL_GRAIN_WORDS, [&planes, mask, implementation](uint32 begin, uint32 end) {
+            CullWords(planes, begin, end - begin, mask, implementation);
+        });
+    }
+    else
+    {
+        CullWords(planes, 0, wordCount, mask, implementation);
+    }
+
+    ClearPaddingBits(boxes.GetSize(), 0, wordCount, mask);
+}
+}
+}
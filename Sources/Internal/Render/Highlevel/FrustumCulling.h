@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/AABBox3.h"
+
+namespace DAVA
+{
+class Frustum;
+
+/**
+    Axis aligned bounding boxes stored as structure of arrays.
+
+    Every coordinate lives in its own contiguous array, so batch culling can load 4 or 8 boxes with a single SIMD load.
+    Arrays are always padded up to a multiple of `PADDING` elements, so culling kernels can process whole mask words
+    without tail handling.
+*/
+class BoundingBoxSoA final
+{
+public:
+    static const uint32 PADDING = 32;
+
+    /** Append box and return its index. */
+    uint32 Add(const AABBox3& box);
+
+    /** Replace box at `index`. */
+    void Set(uint32 index, const AABBox3& box);
+
+    /** Return box at `index`. */
+    AABBox3 Get(uint32 index) const;
+
+    /** Remove box at `index` by moving the last box into its place. */
+    void RemoveBySwapWithLast(uint32 index);
+
+    /** Remove box at `index` keeping order of the rest boxes. */
+    void Remove(uint32 index);
+
+    void Clear();
+    uint32 GetSize() const;
+
+    const float32* GetMinX() const;
+    const float32* GetMinY() const;
+    const float32* GetMinZ() const;
+    const float32* GetMaxX() const;
+    const float32* GetMaxY() const;
+    const float32* GetMaxZ() const;
+
+private:
+    void Reserve(uint32 count);
+
+    uint32 size = 0;
+    Vector<float32> minX;
+    Vector<float32> minY;
+    Vector<float32> minZ;
+    Vector<float32> maxX;
+    Vector<float32> maxY;
+    Vector<float32> maxZ;
+};
+
+/**
+    Batch frustum culling of boxes stored in `BoundingBoxSoA`.
+
+    Result is a visibility bitmask: bit `i % 32` of word `i / 32` is set if box `i` is not outside of the frustum,
+    i.e. exactly when `Frustum::Classify` for the same box returns `EFR_INSIDE` or `EFR_INTERSECT`.
+    Bits of padding boxes are always cleared.
+*/
+namespace FrustumCulling
+{
+enum class eImplementation
+{
+    SCALAR = 0, //!< reference implementation, always available
+    SSE, //!< 4 boxes per iteration
+    AVX, //!< 8 boxes per iteration
+    NEON, //!< 4 boxes per iteration
+};
+
+/** Minimal count of boxes to split culling between JobManager workers. */
+static const uint32 PARALLEL_CULLING_THRESHOLD = 16384;
+
+/** Return true if implementation has been compiled in for current target. */
+bool IsImplementationAvailable(eImplementation implementation);
+
+/** Return the widest implementation available for current target. */
+eImplementation GetBestImplementation();
+
+/** Return count of uint32 words in visibility mask for `boxCount` boxes. */
+inline uint32 GetMaskWordCount(uint32 boxCount)
+{
+    return (boxCount + 31) / 32;
+}
+
+/**
+    Cull words [firstWord, firstWord + wordCount) of `boxes` on the calling thread with specified implementation
+    and write them to `visibilityMask[firstWord...]`.
+*/
+void CullRange(const Frustum& frustum, const BoundingBoxSoA& boxes, uint32 firstWord, uint32 wordCount, uint32* visibilityMask, eImplementation implementation);
+
+/**
+    Cull all `boxes` with the best available implementation. `visibilityMask` is resized to `GetMaskWordCount(boxes.GetSize())`.
+    If there are at least `PARALLEL_CULLING_THRESHOLD` boxes work is split across JobManager workers.
+*/
+void Cull(const Frustum& frustum, const BoundingBoxSoA& boxes, Vector<uint32>& visibilityMask);
+}
+
+inline uint32 BoundingBoxSoA::GetSize() const
+{
+    return size;
+}
+
+inline const float32* BoundingBoxSoA::GetMinX() const
+{
+    return minX.data();
+}
+
+inline const float32* BoundingBoxSoA::GetMinY() const
+{
+    return minY.data();
+}
+
+inline const float32* BoundingBoxSoA::GetMinZ() const
+{
+    return minZ.data();
+}
+
+inline const float32* BoundingBoxSoA::GetMaxX() const
+{
+    return maxX.data();
+}
+
+inline const float32* BoundingBoxSoA::GetMaxY() const
+{
+    return maxY.data();
+}
+
+inline const float32* BoundingBoxSoA::GetMaxZ() const
+{
+    return maxZ.data();
+}
+}
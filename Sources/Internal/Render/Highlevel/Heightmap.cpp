@@ -1,4 +1,5 @@
 #include "Render/Highlevel/Heightmap.h"
+#include "Render/Highlevel/TiledHeightmap.h"
 #include "Render/Image/Image.h"
 #include "Render/Image/ImageSystem.h"
 #include "Reflection/ReflectionRegistrator.h"
@@ -200,6 +201,40 @@ bool Heightmap::Load(const FilePath& filePathname)
     return true;
 }
 
+bool Heightmap::BuildFromTiled(TiledHeightmap* tiledHeightmap, int32 maxSize)
+{
+    DVASSERT(tiledHeightmap != nullptr);
+    DVASSERT(IsPowerOf2(maxSize));
+
+    const int32 tiledSize = int32(tiledHeightmap->GetSize());
+    if (tiledSize == 0)
+    {
+        Logger::Error("Heightmap::BuildFromTiled: tiled heightmap isn't open");
+        return false;
+    }
+
+    // non power of two tiled heightmap is cropped the same way as in `LoadNotPow2`
+    const int32 croppedSize = 1 << HighestBitIndex(tiledSize);
+    const int32 mapSize = Min(croppedSize, maxSize);
+    const int32 step = croppedSize / mapSize;
+
+    ReallocateData(mapSize);
+
+    Vector<uint16> row(tiledSize);
+    for (int32 y = 0; y < mapSize; ++y)
+    {
+        tiledHeightmap->ReadRegion(Rect2i(0, y * step, tiledSize, 1), row.data());
+
+        uint16* dst = data + y * mapSize;
+        for (int32 x = 0; x < mapSize; ++x)
+        {
+            dst[x] = row[x * step];
+        }
+    }
+
+    return true;
+}
+
 void Heightmap::LoadNotPow2(File* file, int32 readMapSize, int32 readTileSize)
 {
     int32 mapSize = 1 << HighestBitIndex(readMapSize);
@@ -7,6 +7,7 @@
 namespace DAVA
 {
 class Image;
+class TiledHeightmap;
 class Heightmap : public BaseObject
 {
 protected:
@@ -21,6 +22,12 @@ public:
     bool BuildFromImage(const Image* image);
     void SaveToImage(const FilePath& filename);
 
+    /**
+        Build heightmap from opened `tiledHeightmap`, downsampled to power of two size not greater than `maxSize`.
+        Heights are read row by row, so memory budget of tiled heightmap should fit one row of tiles.
+    */
+    bool BuildFromTiled(TiledHeightmap* tiledHeightmap, int32 maxSize);
+
     virtual void Save(const FilePath& filePathname);
     virtual bool Load(const FilePath& filePathname);
 
@@ -31,6 +38,7 @@ public:
 
     int32 Size() const;
     uint16* Data();
+    const uint16* Data() const;
 
     int32 GetTileSize() const;
     void SetTileSize(int32 newSize);
@@ -78,6 +86,11 @@ inline uint16* Heightmap::Data()
     return data;
 }
 
+inline const uint16* Heightmap::Data() const
+{
+    return data;
+}
+
 inline int32 Heightmap::Size() const
 {
     return size;
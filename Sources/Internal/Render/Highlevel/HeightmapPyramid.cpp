@@ -0,0 +1,474 @@
+#include "Render/Highlevel/HeightmapPyramid.h"
+#include "Render/Highlevel/Heightmap.h"
+#include "Debug/DVAssert.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
+#include "Math/MathConstants.h"
+
+#include <array>
+#include <cmath>
+
+namespace DAVA
+{
+namespace HeightmapPyramidDetails
+{
+const uint32 PARALLEL_GRAIN_RAYS = 64;
+const float32 QUAD_RANGE_PADDING = 1e-3f;
+
+inline float32 SafeInverse(float32 value)
+{
+    // huge finite value instead of infinity, so `0 * inverse` doesn't give NaN for rays parallel to box planes
+    return (value != 0.f) ? 1.f / value : FLOAT_MAX;
+}
+
+/** Clip ray segment [0, maxT] by `box`, return false if nothing is left. */
+inline bool ClipRay(const Vector3& origin, const Vector3& invDirection, const AABBox3& box, float32 maxT, float32& tEnter, float32& tExit)
+{
+    float32 t0 = 0.f;
+    float32 t1 = maxT;
+    for (uint32 axis = 0; axis < 3; ++axis)
+    {
+        float32 a = (box.min.data[axis] - origin.data[axis]) * invDirection.data[axis];
+        float32 b = (box.max.data[axis] - origin.data[axis]) * invDirection.data[axis];
+        if (a > b)
+        {
+            std::swap(a, b);
+        }
+
+        t0 = Max(t0, a);
+        t1 = Min(t1, b);
+        if (t0 > t1)
+        {
+            return false;
+        }
+    }
+
+    tEnter = t0;
+    tExit = t1;
+    return true;
+}
+
+/**
+    Split ray interval [t0, t1] by plane `mid` of one axis: `intervals[0]` gets part of lower side, `intervals[1]` of upper one.
+    Both parts use the same crossing point, so together they always cover the whole interval.
+*/
+inline void SplitInterval(float32 origin, float32 direction, float32 invDirection, float32 mid, float32 t0, float32 t1, float32 intervals[2][2])
+{
+    if (direction != 0.f)
+    {
+        float32 tMid = (mid - origin) * invDirection;
+        uint32 near = (direction > 0.f) ? 0 : 1;
+        intervals[near][0] = t0;
+        intervals[near][1] = Min(t1, tMid);
+        intervals[1 - near][0] = Max(t0, tMid);
+        intervals[1 - near][1] = t1;
+    }
+    else
+    {
+        // ray parallel to the plane is entirely on one side of it, or on both if it lies in the plane
+        intervals[0][0] = t0;
+        intervals[0][1] = (origin <= mid) ? t1 : t0 - 1.f;
+        intervals[1][0] = t0;
+        intervals[1][1] = (origin >= mid) ? t1 : t0 - 1.f;
+    }
+}
+
+struct TraversalEntry
+{
+    uint32 level;
+    uint32 x;
+    uint32 y;
+    float32 tEnter;
+    float32 tExit;
+};
+}
+
+void HeightmapPyramid::Build(const Heightmap* heightmap, const AABBox3& landscapeBox)
+{
+    Clear();
+
+    if (heightmap == nullptr || heightmap->Size() == 0)
+    {
+        return;
+    }
+
+    heights = heightmap->Data();
+    heightmapSize = uint32(heightmap->Size());
+
+    bbox = landscapeBox;
+    bboxSize = bbox.max - bbox.min;
+    boxPadding = Max(Max(bboxSize.x, bboxSize.y), bboxSize.z) * 1e-5f;
+    pointToQuad = Vector2(float32(heightmapSize) / bboxSize.x, float32(heightmapSize) / bboxSize.y);
+    quadSize = Vector2(bboxSize.x / float32(heightmapSize), bboxSize.y / float32(heightmapSize));
+    heightScale = bboxSize.z / float32(Heightmap::MAX_VALUE);
+
+    uint32 levelSize = (heightmapSize + LEAF_SIZE_QUADS - 1) / LEAF_SIZE_QUADS;
+    uint32 nodesCount = 0;
+    for (;;)
+    {
+        levels.push_back({ nodesCount, levelSize });
+        nodesCount += levelSize * levelSize;
+        if (levelSize == 1)
+        {
+            break;
+        }
+        levelSize = (levelSize + 1) / 2;
+    }
+    DVASSERT(levels.size() <= MAX_LEVELS_COUNT);
+
+    nodes.resize(nodesCount);
+    Update(Rect2i(0, 0, -1, -1));
+}
+
+void HeightmapPyramid::Update(const Rect2i& heightmapRect)
+{
+    if (IsEmpty())
+    {
+        return;
+    }
+
+    uint32 x0 = 0;
+    uint32 y0 = 0;
+    uint32 x1 = levels[0].size - 1;
+    uint32 y1 = levels[0].size - 1;
+
+    // negative size means the whole heightmap, as for `LandscapeSubdivision::UpdatePatchInfo`
+    if (heightmapRect.dx >= 0 && heightmapRect.dy >= 0)
+    {
+        // texel is a corner of quads on both sides of it
+        int32 lastTexel = int32(heightmapSize) - 1;
+        x0 = uint32(Clamp(heightmapRect.x - 1, 0, lastTexel)) / LEAF_SIZE_QUADS;
+        y0 = uint32(Clamp(heightmapRect.y - 1, 0, lastTexel)) / LEAF_SIZE_QUADS;
+        x1 = Min(uint32(Clamp(heightmapRect.x + heightmapRect.dx, 0, lastTexel)) / LEAF_SIZE_QUADS, x1);
+        y1 = Min(uint32(Clamp(heightmapRect.y + heightmapRect.dy, 0, lastTexel)) / LEAF_SIZE_QUADS, y1);
+    }
+
+    UpdateLeaves(x0, y0, x1, y1);
+    for (uint32 level = 1; level < uint32(levels.size()); ++level)
+    {
+        x0 >>= 1;
+        y0 >>= 1;
+        x1 >>= 1;
+        y1 >>= 1;
+        UpdateNodes(level, x0, y0, x1, y1);
+    }
+}
+
+void HeightmapPyramid::Clear()
+{
+    nodes.clear();
+    levels.clear();
+    heights = nullptr;
+    heightmapSize = 0;
+}
+
+void HeightmapPyramid::UpdateLeaves(uint32 x0, uint32 y0, uint32 x1, uint32 y1)
+{
+    const Level& level = levels[0];
+    uint32 lastTexel = heightmapSize - 1;
+    for (uint32 y = y0; y <= y1; ++y)
+    {
+        uint32 texelY0 = y * LEAF_SIZE_QUADS;
+        uint32 texelY1 = Min(texelY0 + LEAF_SIZE_QUADS, lastTexel);
+        for (uint32 x = x0; x <= x1; ++x)
+        {
+            uint32 texelX0 = x * LEAF_SIZE_QUADS;
+            uint32 texelX1 = Min(texelX0 + LEAF_SIZE_QUADS, lastTexel);
+
+            uint16 minHeight = uint16(Heightmap::MAX_VALUE);
+            uint16 maxHeight = 0;
+            for (uint32 ty = texelY0; ty <= texelY1; ++ty)
+            {
+                const uint16* row = heights + ty * heightmapSize;
+                for (uint32 tx = texelX0; tx <= texelX1; ++tx)
+                {
+                    minHeight = Min(minHeight, row[tx]);
+                    maxHeight = Max(maxHeight, row[tx]);
+                }
+            }
+
+            Node& node = nodes[level.offset + y * level.size + x];
+            node.minHeight = minHeight;
+            node.maxHeight = maxHeight;
+        }
+    }
+}
+
+void HeightmapPyramid::UpdateNodes(uint32 levelIndex, uint32 x0, uint32 y0, uint32 x1, uint32 y1)
+{
+    const Level& level = levels[levelIndex];
+    const Level& childLevel = levels[levelIndex - 1];
+    for (uint32 y = y0; y <= y1; ++y)
+    {
+        for (uint32 x = x0; x <= x1; ++x)
+        {
+            uint16 minHeight = uint16(Heightmap::MAX_VALUE);
+            uint16 maxHeight = 0;
+            for (uint32 cy = y * 2; cy < Min(y * 2 + 2, childLevel.size); ++cy)
+            {
+                for (uint32 cx = x * 2; cx < Min(x * 2 + 2, childLevel.size); ++cx)
+                {
+                    const Node& child = nodes[childLevel.offset + cy * childLevel.size + cx];
+                    minHeight = Min(minHeight, child.minHeight);
+                    maxHeight = Max(maxHeight, child.maxHeight);
+                }
+            }
+
+            Node& node = nodes[level.offset + y * level.size + x];
+            node.minHeight = minHeight;
+            node.maxHeight = maxHeight;
+        }
+    }
+}
+
+float32 HeightmapPyramid::GetQuadX(uint32 x) const
+{
+    return bbox.min.x + float32(x) * quadSize.x;
+}
+
+float32 HeightmapPyramid::GetQuadY(uint32 y) const
+{
+    return bbox.min.y + float32(y) * quadSize.y;
+}
+
+float32 HeightmapPyramid::GetPointHeight(uint32 x, uint32 y) const
+{
+    uint32 lastTexel = heightmapSize - 1;
+    return bbox.min.z + float32(heights[Min(x, lastTexel) + Min(y, lastTexel) * heightmapSize]) * heightScale;
+}
+
+AABBox3 HeightmapPyramid::GetNodeBox(uint32 level, uint32 x, uint32 y) const
+{
+    uint32 nodeSizeQuads = LEAF_SIZE_QUADS << level;
+    uint32 quadX0 = x * nodeSizeQuads;
+    uint32 quadY0 = y * nodeSizeQuads;
+    uint32 quadX1 = Min(quadX0 + nodeSizeQuads, heightmapSize);
+    uint32 quadY1 = Min(quadY0 + nodeSizeQuads, heightmapSize);
+
+    const Node& node = GetNode(level, x, y);
+    Vector3 padding(boxPadding, boxPadding, boxPadding);
+    Vector3 boxMin(GetQuadX(quadX0), GetQuadY(quadY0), bbox.min.z + float32(node.minHeight) * heightScale);
+    Vector3 boxMax(GetQuadX(quadX1), GetQuadY(quadY1), bbox.min.z + float32(node.maxHeight) * heightScale);
+    return AABBox3(boxMin - padding, boxMax + padding);
+}
+
+bool HeightmapPyramid::RayCastLeaf(const Ray3& ray, uint32 x, uint32 y, float32 tEnter, float32 tExit, float32& resultT) const
+{
+    using namespace HeightmapPyramidDetails;
+
+    // only quads under ray segment inside the leaf box are tested
+    Vector3 enterPoint = ray.ToPoint(tEnter);
+    Vector3 exitPoint = ray.ToPoint(tExit);
+    float32 enterX = (enterPoint.x - bbox.min.x) * pointToQuad.x;
+    float32 enterY = (enterPoint.y - bbox.min.y) * pointToQuad.y;
+    float32 exitX = (exitPoint.x - bbox.min.x) * pointToQuad.x;
+    float32 exitY = (exitPoint.y - bbox.min.y) * pointToQuad.y;
+
+    int32 leafX0 = int32(x * LEAF_SIZE_QUADS);
+    int32 leafY0 = int32(y * LEAF_SIZE_QUADS);
+    int32 leafX1 = int32(Min((x + 1) * LEAF_SIZE_QUADS, heightmapSize)) - 1;
+    int32 leafY1 = int32(Min((y + 1) * LEAF_SIZE_QUADS, heightmapSize)) - 1;
+
+    int32 quadX0 = Clamp(int32(std::floor(Min(enterX, exitX) - QUAD_RANGE_PADDING)), leafX0, leafX1);
+    int32 quadY0 = Clamp(int32(std::floor(Min(enterY, exitY) - QUAD_RANGE_PADDING)), leafY0, leafY1);
+    int32 quadX1 = Clamp(int32(std::floor(Max(enterX, exitX) + QUAD_RANGE_PADDING)), leafX0, leafX1);
+    int32 quadY1 = Clamp(int32(std::floor(Max(enterY, exitY) + QUAD_RANGE_PADDING)), leafY0, leafY1);
+
+    float32 segmentMinZ = Min(enterPoint.z, exitPoint.z) - boxPadding;
+    float32 segmentMaxZ = Max(enterPoint.z, exitPoint.z) + boxPadding;
+
+    bool hit = false;
+    for (int32 qy = quadY0; qy <= quadY1; ++qy)
+    {
+        float32 y0 = GetQuadY(uint32(qy));
+        float32 y1 = GetQuadY(uint32(qy + 1));
+        for (int32 qx = quadX0; qx <= quadX1; ++qx)
+        {
+            float32 x0 = GetQuadX(uint32(qx));
+            float32 x1 = GetQuadX(uint32(qx + 1));
+
+            Vector3 p00(x0, y0, GetPointHeight(uint32(qx), uint32(qy)));
+            Vector3 p01(x0, y1, GetPointHeight(uint32(qx), uint32(qy + 1)));
+            Vector3 p10(x1, y0, GetPointHeight(uint32(qx + 1), uint32(qy)));
+            Vector3 p11(x1, y1, GetPointHeight(uint32(qx + 1), uint32(qy + 1)));
+
+            // skip quad if ray segment inside the leaf is entirely above or below it
+            float32 quadMinZ = Min(Min(p00.z, p01.z), Min(p10.z, p11.z));
+            float32 quadMaxZ = Max(Max(p00.z, p01.z), Max(p10.z, p11.z));
+            if (quadMinZ > segmentMaxZ || quadMaxZ < segmentMinZ)
+            {
+                continue;
+            }
+
+            float32 t = 0.f;
+            if (Intersection::RayTriangle(ray, p00, p01, p11, t, 0.f, resultT))
+            {
+                resultT = t;
+                hit = true;
+            }
+            if (Intersection::RayTriangle(ray, p00, p11, p10, t, 0.f, resultT))
+            {
+                resultT = t;
+                hit = true;
+            }
+        }
+    }
+    return hit;
+}
+
+bool HeightmapPyramid::RayCast(const Ray3& rayInObjectSpace, float32& resultT) const
+{
+    using namespace HeightmapPyramidDetails;
+
+    if (IsEmpty())
+    {
+        return false;
+    }
+
+    const Vector3& origin = rayInObjectSpace.origin;
+    const Vector3& direction = rayInObjectSpace.direction;
+    Vector3 invDirection(SafeInverse(direction.x), SafeInverse(direction.y), SafeInverse(direction.z));
+
+    // every visited node is replaced by at most 4 children, so stack never grows more than by 3 entries per level
+    std::array<TraversalEntry, 3 * MAX_LEVELS_COUNT + 1> stack;
+    uint32 stackSize = 0;
+
+    float32 closestT = FLOAT_MAX;
+    uint32 rootLevel = uint32(levels.size()) - 1;
+    float32 tEnter = 0.f;
+    float32 tExit = 0.f;
+    if (ClipRay(origin, invDirection, GetNodeBox(rootLevel, 0, 0), closestT, tEnter, tExit))
+    {
+        stack[stackSize++] = { rootLevel, 0, 0, tEnter, tExit };
+    }
+
+    while (stackSize > 0)
+    {
+        TraversalEntry entry = stack[--stackSize];
+        if (entry.tEnter > closestT)
+        {
+            continue;
+        }
+
+        if (entry.level == 0)
+        {
+            RayCastLeaf(rayInObjectSpace, entry.x, entry.y, entry.tEnter, entry.tExit, closestT);
+            continue;
+        }
+
+        // children intervals are parts of the node interval on both sides of its middle lines, clipped by children heights
+        uint32 childLevel = entry.level - 1;
+        uint32 childLevelSize = levels[childLevel].size;
+        uint32 childSizeQuads = LEAF_SIZE_QUADS << childLevel;
+        float32 intervalsX[2][2];
+        float32 intervalsY[2][2];
+        SplitInterval(origin.x, direction.x, invDirection.x, GetQuadX((entry.x * 2 + 1) * childSizeQuads), entry.tEnter, entry.tExit, intervalsX);
+        SplitInterval(origin.y, direction.y, invDirection.y, GetQuadY((entry.y * 2 + 1) * childSizeQuads), entry.tEnter, entry.tExit, intervalsY);
+
+        TraversalEntry children[4];
+        uint32 childrenCount = 0;
+        for (uint32 j = 0; j < 2 && entry.y * 2 + j < childLevelSize; ++j)
+        {
+            for (uint32 i = 0; i < 2 && entry.x * 2 + i < childLevelSize; ++i)
+            {
+                uint32 cx = entry.x * 2 + i;
+                uint32 cy = entry.y * 2 + j;
+                tEnter = Max(intervalsX[i][0], intervalsY[j][0]);
+                tExit = Min(Min(intervalsX[i][1], intervalsY[j][1]), closestT);
+                if (tEnter > tExit)
+                {
+                    continue;
+                }
+
+                const Node& node = GetNode(childLevel, cx, cy);
+                float32 a = (bbox.min.z + float32(node.minHeight) * heightScale - boxPadding - origin.z) * invDirection.z;
+                float32 b = (bbox.min.z + float32(node.maxHeight) * heightScale + boxPadding - origin.z) * invDirection.z;
+                tEnter = Max(tEnter, Min(a, b));
+                tExit = Min(tExit, Max(a, b));
+                if (tEnter > tExit)
+                {
+                    continue;
+                }
+
+                // insertion sort by distance descending, so the nearest child is popped first
+                uint32 k = childrenCount++;
+                for (; k > 0 && children[k - 1].tEnter < tEnter; --k)
+                {
+                    children[k] = children[k - 1];
+                }
+                children[k] = { childLevel, cx, cy, tEnter, tExit };
+            }
+        }
+
+        for (uint32 i = 0; i < childrenCount; ++i)
+        {
+            stack[stackSize++] = children[i];
+        }
+    }
+
+    if (closestT < FLOAT_MAX)
+    {
+        resultT = closestT;
+        return true;
+    }
+    return false;
+}
+
+uint32 HeightmapPyramid::RayCast(const Ray3* raysInObjectSpace, uint32 count, float32* resultsT, bool allowParallel) const
+{
+    using namespace HeightmapPyramidDetails;
+
+    auto castRays = [this, raysInObjectSpace, resultsT](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i)
+        {
+            resultsT[i] = FLOAT_MAX;
+            RayCast(raysInObjectSpace[i], resultsT[i]);
+        }
+    };
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (allowParallel && jobManager != nullptr && jobManager->GetWorkersCount() > 1 && count >= PARALLEL_RAYCAST_THRESHOLD)
+    {
+        // every job writes its own range of results
+        jobManager->ParallelFor(0, count, PARALLEL_GRAIN_RAYS, castRays);
+    }
+    else
+    {
+        castRays(0, count);
+    }
+
+    uint32 hitsCount = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        hitsCount += (resultsT[i] < FLOAT_MAX) ? 1 : 0;
+    }
+    return hitsCount;
+}
+
+bool HeightmapPyramid::GetHeightAtPoint(const Vector3& point, float32& height) const
+{
+    if (IsEmpty() || (point.x > bbox.max.x) || (point.x < bbox.min.x) || (point.y > bbox.max.y) || (point.y < bbox.min.y))
+    {
+        return false;
+    }
+
+    float32 fx = (point.x - bbox.min.x) * pointToQuad.x;
+    float32 fy = (point.y - bbox.min.y) * pointToQuad.y;
+    uint32 x = Min(uint32(fx), heightmapSize);
+    uint32 y = Min(uint32(fy), heightmapSize);
+    float32 dx = fx - float32(x);
+    float32 dy = fy - float32(y);
+
+    uint32 lastTexel = heightmapSize - 1;
+    const uint16* row0 = heights + Min(y, lastTexel) * heightmapSize;
+    const uint16* row1 = heights + Min(y + 1, lastTexel) * heightmapSize;
+    uint32 x0 = Min(x, lastTexel);
+    uint32 x1 = Min(x + 1, lastTexel);
+
+    float32 h0 = float32(row0[x0]) * (1.f - dx) + float32(row0[x1]) * dx;
+    float32 h1 = float32(row1[x0]) * (1.f - dx) + float32(row1[x1]) * dx;
+    height = bbox.min.z + (h0 * (1.f - dy) + h1 * dy) * heightScale;
+    return true;
+}
+}
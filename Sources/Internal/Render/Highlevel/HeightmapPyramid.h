@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/AABBox3.h"
+#include "Math/Math2D.h"
+#include "Math/Ray.h"
+#include "Math/Vector.h"
+
+namespace DAVA
+{
+class Heightmap;
+
+/**
+    Min-max mip pyramid over heightmap, used for ray casts and height queries against landscape.
+
+    Leaf node covers `LEAF_SIZE_QUADS` x `LEAF_SIZE_QUADS` heightmap quads and stores min and max height of
+    their corners, every next level merges 2x2 nodes of the previous one up to a single root node.
+    Ray cast walks the pyramid front to back, skipping nodes which bounding box isn't hit by the ray or which
+    are farther than the closest hit found so far, and tests quad triangles only inside hit leaves.
+
+    Landscape geometry is made of `Heightmap::GetPoint` points: quad (x, y) is split into triangles
+    (p00, p01, p11) and (p00, p11, p10), heights of the last row and column are clamped.
+
+    All const functions only read pyramid and heightmap data, so any number of threads may call them at once.
+    `Build`, `Update` and `Clear` must not run concurrently with readers, the same as modification of heightmap data.
+*/
+class HeightmapPyramid final
+{
+public:
+    static const uint32 LEAF_SIZE_QUADS = 4;
+    static const uint32 MAX_LEVELS_COUNT = 16;
+
+    /** Ray casts batch of at least this size is split across JobManager workers. */
+    static const uint32 PARALLEL_RAYCAST_THRESHOLD = 256;
+
+    /**
+        Build pyramid over `heightmap` placed in `bbox`. Heightmap is not retained and should outlive the pyramid
+        or the next `Build` / `Clear` call.
+    */
+    void Build(const Heightmap* heightmap, const AABBox3& bbox);
+
+    /** Recalculate nodes covering `heightmapRect` after heights in it have been changed. */
+    void Update(const Rect2i& heightmapRect);
+
+    void Clear();
+    bool IsEmpty() const;
+
+    /**
+        Find the closest intersection of ray given in landscape object space with landscape surface.
+        Return true and write ray parameter of intersection to `resultT` if it's found, `resultT` is kept otherwise.
+        Intersections at negative `t` are ignored.
+    */
+    bool RayCast(const Ray3& rayInObjectSpace, float32& resultT) const;
+
+    /**
+        Cast `count` rays given in landscape object space, write parameter of the closest intersection of every ray
+        to `resultsT`, or `FLOAT_MAX` if ray misses landscape. Return count of rays which hit landscape.
+        Large batches are processed on JobManager workers if `allowParallel` is true.
+    */
+    uint32 RayCast(const Ray3* raysInObjectSpace, uint32 count, float32* resultsT, bool allowParallel = true) const;
+
+    /**
+        Write bilinearly interpolated landscape height at `point.xy` given in object space to `height`.
+        Return false if point is out of landscape bounds.
+    */
+    bool GetHeightAtPoint(const Vector3& point, float32& height) const;
+
+private:
+    struct Node
+    {
+        uint16 minHeight;
+        uint16 maxHeight;
+    };
+
+    struct Level
+    {
+        uint32 offset;
+        uint32 size;
+    };
+
+    void UpdateLeaves(uint32 x0, uint32 y0, uint32 x1, uint32 y1);
+    void UpdateNodes(uint32 level, uint32 x0, uint32 y0, uint32 x1, uint32 y1);
+
+    const Node& GetNode(uint32 level, uint32 x, uint32 y) const;
+    AABBox3 GetNodeBox(uint32 level, uint32 x, uint32 y) const;
+    float32 GetQuadX(uint32 x) const;
+    float32 GetQuadY(uint32 y) const;
+    float32 GetPointHeight(uint32 x, uint32 y) const;
+
+    bool RayCastLeaf(const Ray3& ray, uint32 x, uint32 y, float32 tEnter, float32 tExit, float32& resultT) const;
+
+    Vector<Node> nodes;
+    Vector<Level> levels;
+
+    const uint16* heights = nullptr;
+    uint32 heightmapSize = 0;
+
+    AABBox3 bbox;
+    Vector3 bboxSize;
+    float32 boxPadding = 0.f; // node boxes are extended a bit, so rays touching node bounds aren't lost to rounding
+    Vector2 pointToQuad; // heightmap size divided by bbox size
+    Vector2 quadSize;
+    float32 heightScale = 0.f; // bbox height divided by `Heightmap::MAX_VALUE`
+};
+
+inline bool HeightmapPyramid::IsEmpty() const
+{
+    return levels.empty();
+}
+
+inline const HeightmapPyramid::Node& HeightmapPyramid::GetNode(uint32 level, uint32 x, uint32 y) const
+{
+    const Level& l = levels[level];
+    return nodes[l.offset + y * l.size + x];
+}
+}
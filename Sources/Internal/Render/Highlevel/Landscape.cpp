@@ -6,6 +6,7 @@
 #include "Scene3D/Systems/FoliageSystem.h"
 #include "Render/Highlevel/Landscape.h"
 #include "Render/Highlevel/Heightmap.h"
+#include "Render/Highlevel/TiledHeightmap.h"
 #include "Render/Highlevel/RenderPassNames.h"
 #include "Render/Image/Image.h"
 #include "Render/Image/ImageSystem.h"
@@ -209,6 +210,7 @@ void Landscape::ReleaseGeometryData()
     indices.clear();
 
     subdivision->ReleaseInternalData();
+    heightPyramid.Clear();
 
     quadsInWidthPow2 = 0;
 
@@ -285,6 +287,7 @@ bool Landscape::BuildHeightmap()
 
     bool retValue = false;
     SafeRelease(heightmap);
+    isTiledHeightmap = false;
 
     if (DAVA::TextureDescriptor::IsSourceTextureExtension(heightmapPath.GetExtension()))
     {
@@ -312,6 +315,17 @@ bool Landscape::BuildHeightmap()
         heightmap = new Heightmap();
         retValue = heightmap->Load(heightmapPath);
     }
+    else if (heightmapPath.IsEqualToExtension(TiledHeightmap::FileExtension()))
+    {
+        // tiled file is read once, all height queries are served by the resident copy
+        TiledHeightmap tiledHeightmap;
+        if (tiledHeightmap.Open(heightmapPath))
+        {
+            heightmap = new Heightmap();
+            retValue = heightmap->BuildFromTiled(&tiledHeightmap, TILED_HEIGHTMAP_RESIDENT_SIZE);
+            isTiledHeightmap = retValue;
+        }
+    }
 
     return retValue;
 }
@@ -342,6 +356,7 @@ void Landscape::AllocateGeometryData()
     heightmapSizef = float32(heightmapSize);
 
     subdivision->BuildSubdivision(heightmap, bbox, PATCH_SIZE_QUADS, minSubdivLevel, (renderMode == RENDERMODE_INSTANCING_MORPHING));
+    heightPyramid.Build(heightmap, bbox);
 
     (renderMode == RENDERMODE_NO_INSTANCING) ? AllocateGeometryDataNoInstancing() : AllocateGeometryDataInstancing();
 }
@@ -414,6 +429,8 @@ Vector<Image*> Landscape::CreateHeightTextureData(Heightmap* heightmap, RenderMo
     DVASSERT(IsPowerOf2(hmSize));
     DVASSERT(renderMode != RENDERMODE_NO_INSTANCING);
 
+    const Rect2i heightmapRect(0, 0, hmSize, hmSize);
+
     Vector<Image*> dataOut;
     if (renderMode == RENDERMODE_INSTANCING_MORPHING)
     {
@@ -422,50 +439,18 @@ Vector<Image*> Landscape::CreateHeightTextureData(Heightmap* heightmap, RenderMo
         dataOut.reserve(HighestBitIndex(hmSize));
 
         uint32 mipSize = hmSize;
-        uint32 step = 1;
         uint32 mipLevel = 0;
         uint32* mipData = new uint32[mipSize * mipSize]; //RGBA8888
 
         while (mipSize)
         {
-            uint16* mipDataPtr = reinterpret_cast<uint16*>(mipData);
-            for (uint32 y = 0; y < mipSize; ++y)
-            {
-                uint32 mipLastIndex = mipSize - 1;
-                uint16 yy = y * step;
-                uint16 y1 = yy;
-                uint16 y2 = yy;
-                if ((y & 0x1) && y != mipLastIndex)
-                {
-                    y1 -= step;
-                    y2 += step;
-                }
-
-                for (uint32 x = 0; x < mipSize; ++x)
-                {
-                    uint16 xx = x * step;
-                    uint16 x1 = xx;
-                    uint16 x2 = xx;
-                    if ((x & 0x1) && x != mipLastIndex)
-                    {
-                        x1 += step;
-                        x2 -= step;
-                    }
-
-                    *mipDataPtr++ = heightmap->GetHeight(xx, yy);
-
-                    uint16 h1 = heightmap->GetHeightClamp(x1, y1);
-                    uint16 h2 = heightmap->GetHeightClamp(x2, y2);
-                    *mipDataPtr++ = (h1 + h2) / 2;
-                }
-            }
+            UpdateHeightTextureData(mipLevel, heightmapRect, reinterpret_cast<uint8*>(mipData));
 
             Image* mipImg = Image::CreateFromData(mipSize, mipSize, FORMAT_RGBA8888, reinterpret_cast<uint8*>(mipData));
             mipImg->mipmapLevel = mipLevel;
             dataOut.push_back(mipImg);
 
             mipSize >>= 1;
-            step <<= 1;
             mipLevel++;
         }
 
@@ -479,15 +464,7 @@ Vector<Image*> Landscape::CreateHeightTextureData(Heightmap* heightmap, RenderMo
             DVASSERT(rhi::TextureFormatSupported(rhi::TEXTURE_FORMAT_R32F, rhi::PROG_VERTEX));
 
             float32* texData = new float32[hmSize * hmSize];
-            float32* texDataPtr = texData;
-
-            for (uint32 y = 0; y < hmSize; ++y)
-            {
-                for (uint32 x = 0; x < hmSize; ++x)
-                {
-                    *texDataPtr++ = float32(heightmap->GetHeight(x, y)) / Heightmap::MAX_VALUE;
-                }
-            }
+            UpdateHeightTextureData(0, heightmapRect, reinterpret_cast<uint8*>(texData));
 
             heightImage = Image::CreateFromData(hmSize, hmSize, FORMAT_R32F, reinterpret_cast<uint8*>(texData));
             SafeDeleteArray(texData);
@@ -504,6 +481,78 @@ Vector<Image*> Landscape::CreateHeightTextureData(Heightmap* heightmap, RenderMo
     return dataOut;
 }
 
+void Landscape::UpdateHeightTextureData(uint32 level, const Rect2i& heightmapRect, uint8* levelData) const
+{
+    const uint32 hmSize = GetHeightmapSize();
+    const uint32 mipSize = hmSize >> level;
+    const uint32 step = 1 << level;
+    const uint32 mipLastIndex = mipSize - 1;
+
+    if (renderMode == RENDERMODE_INSTANCING_MORPHING)
+    {
+        // mip texel stores height at its point and average of two neighbour points one step away
+        uint32 xBegin = Max(uint32(heightmapRect.x) >> level, 1u) - 1;
+        uint32 yBegin = Max(uint32(heightmapRect.y) >> level, 1u) - 1;
+        uint32 xEnd = Min((uint32(heightmapRect.x + heightmapRect.dx - 1) >> level) + 1, mipLastIndex);
+        uint32 yEnd = Min((uint32(heightmapRect.y + heightmapRect.dy - 1) >> level) + 1, mipLastIndex);
+
+        for (uint32 y = yBegin; y <= yEnd; ++y)
+        {
+            uint16* mipDataPtr = reinterpret_cast<uint16*>(levelData) + (y * mipSize + xBegin) * 2;
+
+            uint16 yy = y * step;
+            uint16 y1 = yy;
+            uint16 y2 = yy;
+            if ((y & 0x1) && y != mipLastIndex)
+            {
+                y1 -= step;
+                y2 += step;
+            }
+
+            for (uint32 x = xBegin; x <= xEnd; ++x)
+            {
+                uint16 xx = x * step;
+                uint16 x1 = xx;
+                uint16 x2 = xx;
+                if ((x & 0x1) && x != mipLastIndex)
+                {
+                    x1 += step;
+                    x2 -= step;
+                }
+
+                *mipDataPtr++ = heightmap->GetHeight(xx, yy);
+
+                uint16 h1 = heightmap->GetHeightClamp(x1, y1);
+                uint16 h2 = heightmap->GetHeightClamp(x2, y2);
+                *mipDataPtr++ = (h1 + h2) / 2;
+            }
+        }
+    }
+    else
+    {
+        DVASSERT(level == 0);
+
+        uint32 x0 = uint32(heightmapRect.x);
+        uint32 x1 = uint32(heightmapRect.x + heightmapRect.dx - 1);
+        uint32 y1 = uint32(heightmapRect.y + heightmapRect.dy - 1);
+        for (uint32 y = uint32(heightmapRect.y); y <= y1; ++y)
+        {
+            if (floatHeightTexture)
+            {
+                float32* texDataPtr = reinterpret_cast<float32*>(levelData) + y * hmSize + x0;
+                for (uint32 x = x0; x <= x1; ++x)
+                {
+                    *texDataPtr++ = float32(heightmap->GetHeight(x, y)) / Heightmap::MAX_VALUE;
+                }
+            }
+            else
+            {
+                Memcpy(reinterpret_cast<uint16*>(levelData) + y * hmSize + x0, heightmap->Data() + y * hmSize + x0, (x1 - x0 + 1) * sizeof(uint16));
+            }
+        }
+    }
+}
+
 Texture* Landscape::CreateTangentTexture()
 {
     DAVA_MEMORY_PROFILER_CLASS_ALLOC_SCOPE();
@@ -519,6 +568,8 @@ Texture* Landscape::CreateTangentTexture()
     LockGuard<Mutex> lock(restoreDataMutex);
     for (Image* img : textureData)
     {
+        bufferRestoreData.emplace_back();
+
         auto& restore = bufferRestoreData.back();
         restore.bufferType = RestoreBufferData::RESTORE_TEXTURE;
         restore.buffer = tx->handle;
@@ -544,32 +595,45 @@ Vector<Image*> Landscape::CreateTangentBasisTextureData()
     Vector<Image*> dataOut;
     {
         uint32* normalTangntData = new uint32[hmSize * hmSize]; //RGBA8888
-        uint8* normalTangntDataPtr = reinterpret_cast<uint8*>(normalTangntData);
-
-        Vector3 normal, tangent;
-        for (uint32 y = 0; y < hmSize; ++y)
-        {
-            for (uint32 x = 0; x < hmSize; ++x)
-            {
-                GetTangentBasis(x, y, normal, tangent);
-
-                normal = normal * 0.5f + 0.5f;
-                tangent = tangent * 0.5 + 0.5f;
-
-                *normalTangntDataPtr++ = uint8(normal.x * 255.f);
-                *normalTangntDataPtr++ = uint8(normal.y * 255.f);
-                *normalTangntDataPtr++ = uint8(tangent.y * 255.f);
-                *normalTangntDataPtr++ = uint8(tangent.z * 255.f);
-            }
-        }
+        UpdateTangentBasisTextureData(Rect2i(0, 0, hmSize, hmSize), reinterpret_cast<uint8*>(normalTangntData));
 
         Image* basisImage = Image::CreateFromData(hmSize, hmSize, FORMAT_RGBA8888, reinterpret_cast<uint8*>(normalTangntData));
+        SafeDeleteArray(normalTangntData);
         dataOut.push_back(basisImage);
     }
 
     return dataOut;
 }
 
+void Landscape::UpdateTangentBasisTextureData(const Rect2i& heightmapRect, uint8* data) const
+{
+    const uint32 hmSize = GetHeightmapSize();
+
+    // basis at point depends on heights of its four neighbours
+    uint32 x0 = Max(uint32(heightmapRect.x), 1u) - 1;
+    uint32 y0 = Max(uint32(heightmapRect.y), 1u) - 1;
+    uint32 x1 = Min(uint32(heightmapRect.x + heightmapRect.dx), hmSize - 1);
+    uint32 y1 = Min(uint32(heightmapRect.y + heightmapRect.dy), hmSize - 1);
+
+    Vector3 normal, tangent;
+    for (uint32 y = y0; y <= y1; ++y)
+    {
+        uint8* normalTangntDataPtr = data + (y * hmSize + x0) * 4;
+        for (uint32 x = x0; x <= x1; ++x)
+        {
+            GetTangentBasis(x, y, normal, tangent);
+
+            normal = normal * 0.5f + 0.5f;
+            tangent = tangent * 0.5 + 0.5f;
+
+            *normalTangntDataPtr++ = uint8(normal.x * 255.f);
+            *normalTangntDataPtr++ = uint8(normal.y * 255.f);
+            *normalTangntDataPtr++ = uint8(tangent.y * 255.f);
+            *normalTangntDataPtr++ = uint8(tangent.z * 255.f);
+        }
+    }
+}
+
 void Landscape::GetTangentBasis(uint32 x, uint32 y, Vector3& normalOut, Vector3& tangentOut) const
 {
     DVASSERT(heightmap);
@@ -624,30 +688,13 @@ bool Landscape::GetHeightAtPoint(const Vector3& point, float32& value) const
         return false;
     }
 
-    int32 hmSize = GetHeightmapSize();
-    if (hmSize == 0)
+    if (heightPyramid.IsEmpty())
     {
         Logger::Error("[Landscape::GetHeightAtPoint] Trying to get height at point using empty heightmap data!");
         return false;
     }
 
-    float32 fx = static_cast<float32>(hmSize) * (point.x - bbox.min.x) / (bbox.max.x - bbox.min.x);
-    float32 fy = static_cast<float32>(hmSize) * (point.y - bbox.min.y) / (bbox.max.y - bbox.min.y);
-    uint16 x = static_cast<uint16>(fx);
-    uint16 y = static_cast<uint16>(fy);
-
-    Vector3 h00 = heightmap->GetPoint(x, y, bbox);
-    Vector3 h01 = heightmap->GetPoint(x + 1, y, bbox);
-    Vector3 h10 = heightmap->GetPoint(x, y + 1, bbox);
-    Vector3 h11 = heightmap->GetPoint(x + 1, y + 1, bbox);
-
-    float32 dx = fx - static_cast<float32>(x);
-    float32 dy = fy - static_cast<float32>(y);
-    float32 h0 = h00.z * (1.0f - dx) + h01.z * dx;
-    float32 h1 = h10.z * (1.0f - dx) + h11.z * dx;
-    value = (h0 * (1.0f - dy) + h1 * dy);
-
-    return true;
+    return heightPyramid.GetHeightAtPoint(point, value);
 }
 
 bool Landscape::PlacePoint(const Vector3& worldPoint, Vector3& result, Vector3* normal) const
@@ -1424,15 +1471,19 @@ void Landscape::Save(KeyedArchive* archive, SerializationContext* serializationC
     uint64 matKey = landscapeMaterial->GetNodeID();
     archive->SetUInt64("matname", matKey);
 
-    //TODO: remove code in future. Need for transition from *.png to *.heightmap
-    if (!heightmapPath.IsEqualToExtension(Heightmap::FileExtension()))
+    // resident heightmap of tiled one is only its downsampled copy, so tiled heightmap file is kept as is
+    if (!isTiledHeightmap)
     {
-        heightmapPath.ReplaceExtension(Heightmap::FileExtension());
-    }
+        //TODO: remove code in future. Need for transition from *.png to *.heightmap
+        if (!heightmapPath.IsEqualToExtension(Heightmap::FileExtension()))
+        {
+            heightmapPath.ReplaceExtension(Heightmap::FileExtension());
+        }
 
-    if (heightmap != nullptr)
-    {
-        heightmap->Save(heightmapPath);
+        if (heightmap != nullptr)
+        {
+            heightmap->Save(heightmapPath);
+        }
     }
     archive->SetString("hmap", heightmapPath.GetRelativePathname(serializationContext->GetScenePath()));
     archive->SetByteArrayAsType("bbox", bbox);
@@ -1506,12 +1557,19 @@ Heightmap* Landscape::GetHeightmap()
     return heightmap;
 }
 
+bool Landscape::IsTiledHeightmap() const
+{
+    return isTiledHeightmap;
+}
+
 void Landscape::SetHeightmap(DAVA::Heightmap* height)
 {
     DAVA_MEMORY_PROFILER_CLASS_ALLOC_SCOPE();
 
     SafeRelease(heightmap);
     heightmap = SafeRetain(height);
+    // heights don't come from tiled heightmap file anymore
+    isTiledHeightmap = false;
 
     RebuildLandscape();
 }
@@ -1661,31 +1719,40 @@ void Landscape::UpdatePart(const Rect2i& rect)
 {
     DAVA_MEMORY_PROFILER_CLASS_ALLOC_SCOPE();
 
+    if (isTiledHeightmap)
+    {
+        // edits of downsampled copy can't be saved back to tiled file
+        DVASSERT(false, "Landscape built from tiled heightmap is read-only");
+        return;
+    }
+
     subdivision->UpdatePatchInfo(rect);
+    heightPyramid.Update(rect);
 
     switch (renderMode)
     {
     case RENDERMODE_INSTANCING:
     case RENDERMODE_INSTANCING_MORPHING:
     {
-        Vector<Image*> heightTextureData = CreateHeightTextureData(heightmap, renderMode);
-
-        for (Image* img : heightTextureData)
+        // restore data keeps texture levels, so only texels depending on changed heights are regenerated
+        const uint32 hmSize = GetHeightmapSize();
+        LockGuard<Mutex> lock(restoreDataMutex);
+        for (RestoreBufferData& restore : bufferRestoreData)
         {
-            heightTexture->TexImage(img->mipmapLevel, img->width, img->height, img->data, img->dataSize, img->cubeFaceID);
-            img->Release();
-        }
-        heightTextureData.clear();
+            if (restore.bufferType != RestoreBufferData::RESTORE_TEXTURE)
+                continue;
 
-        if (isRequireTangentBasis)
-        {
-            Vector<Image*> tangentTextureData = CreateTangentBasisTextureData();
-            for (Image* img : tangentTextureData)
+            uint32 levelSize = hmSize >> restore.level;
+            if (restore.buffer == heightTexture->handle)
             {
-                tangentTexture->TexImage(img->mipmapLevel, img->width, img->height, img->data, img->dataSize, img->cubeFaceID);
-                img->Release();
+                UpdateHeightTextureData(restore.level, rect, restore.data);
+                heightTexture->TexImage(restore.level, levelSize, levelSize, restore.data, restore.dataSize, Texture::INVALID_CUBEMAP_FACE);
+            }
+            else if (isRequireTangentBasis && restore.buffer == tangentTexture->handle)
+            {
+                UpdateTangentBasisTextureData(rect, restore.data);
+                tangentTexture->TexImage(restore.level, levelSize, levelSize, restore.data, restore.dataSize, Texture::INVALID_CUBEMAP_FACE);
             }
-            tangentTextureData.clear();
         }
     }
     break;
@@ -1699,215 +1766,13 @@ void Landscape::UpdatePart(const Rect2i& rect)
     }
 }
 
-void Landscape::RecursiveRayTrace(uint32 level, uint32 x, uint32 y, const Ray3& rayInObjectSpace, float32& resultT)
-{
-#if 0
-	const LandscapeSubdivision::SubdivisionPatchInfo& subdivPatchInfo = subdivision->GetPatchInfo(level, x, y);
-	const LandscapeSubdivision::PatchQuadInfo& patchQuadInfo = subdivision->GetPatchQuadInfo(level, x, y);
-
-	float32 tMin, tMax;
-	bool currentPatchIntersects = Intersection::RayBox(rayInObjectSpace, patchQuadInfo.bbox, tMin, tMax);
-
-	if (currentPatchIntersects)
-	{
-		if (level == subdivision->GetLevelCount() - 1)
-		{
-			int32 hmSize = heightmap->Size();
-			uint32 patchSize = hmSize >> level;
-
-			uint32 xx = x * patchSize;
-			uint32 yy = y * patchSize;
-
-			float32 localResult = FLT_MAX;
-			/*int32 collisionCellX2 = -1;
-			int32 collisionCellY2 = -1;
-
-			float32 localResult2 = FLT_MAX;
-			// Bruteforce algorithm
-			{
-			for (uint32 y0 = yy; y0 < yy + patchSize; y0 ++)
-			{
-			for (uint32 x0 = xx; x0 < xx + patchSize; x0 ++)
-			{
-			uint32 x1 = x0 + 1;
-			uint32 y1 = y0 + 1;
-
-			Vector3 p00 = heightmap->GetPoint(x0, y0, bbox);
-			Vector3 p01 = heightmap->GetPoint(x0, y1, bbox);
-			Vector3 p10 = heightmap->GetPoint(x1, y0, bbox);
-			Vector3 p11 = heightmap->GetPoint(x1, y1, bbox);
-
-			float32 t1, t2;
-			if (Intersection::RayTriangle(rayInObjectSpace, p00, p01, p11, t1))
-			{
-			if (t1 < localResult2)
-			{
-			localResult2 = t1;
-			collisionCellX2 = x0;
-			collisionCellY2 = y0;
-			}
-			}
-
-			if (Intersection::RayTriangle(rayInObjectSpace, p00, p11, p10, t2))
-			{
-			if (t2 < localResult2)
-			{
-			localResult2 = t2;
-			collisionCellX2 = x0;
-			collisionCellY2 = y0;
-
-			}
-			}
-			}
-			}
-			}
-
-			//Logger::Debug("bf res: %d %d" , collisionCellX2, collisionCellY2);
-
-			//DVASSERT(FLOAT_EQUAL(localResult2, localResult));
-			resultT = Min(resultT, localResult2);*/
-			float32 localResult3 = FLT_MAX;
-			{
-				Vector3 grid00 = heightmap->GetPoint(xx, yy, bbox);
-				Vector3 gridCellSize = heightmap->GetPoint(xx + 1, yy + 1, bbox) - grid00;
-
-				auto GetPosToVoxel = [patchSize, grid00, gridCellSize](const Vector3 & point, int32 axis)
-				{
-					int32 pos = static_cast<int32>((point.data[axis] - grid00.data[axis]) / (float32)gridCellSize.data[axis]);
-					return Clamp(pos, 0, (int32)patchSize - 1);
-				};
-
-				auto GetVoxelToPos = [patchSize, grid00, gridCellSize](int32 voxel, int32 axis)
-				{
-					float32 pos = (float32)(voxel)* gridCellSize.data[axis] + grid00.data[axis];
-					return pos;
-				};
-
-
-
-				Vector3 patchIntersect = rayInObjectSpace.origin + rayInObjectSpace.direction * tMin;
-
-
-				float32 width[3] = { gridCellSize.x, gridCellSize.y, gridCellSize.z };
-
-
-				// Set up 3D DDA for ray
-				float32 nextCrossingT[3], deltaT[3];
-				int32 step[3], out[3], pos[3];
-				for (int axis = 0; axis < 2; ++axis)
-				{
-					// Compute current voxel for axis
-					pos[axis] = GetPosToVoxel(patchIntersect, axis);
-					if (rayInObjectSpace.direction.data[axis] >= 0)
-					{
-						// Handle ray with positive direction for voxel stepping
-						nextCrossingT[axis] = tMin + (GetVoxelToPos(pos[axis] + 1, axis) - patchIntersect.data[axis]) / rayInObjectSpace.direction.data[axis];
-						deltaT[axis] = width[axis] / rayInObjectSpace.direction.data[axis];
-						step[axis] = 1;
-						out[axis] = patchSize;
-					}
-					else
-					{
-						// Handle ray with negative direction for voxel stepping
-						nextCrossingT[axis] = tMin + (GetVoxelToPos(pos[axis], axis) - patchIntersect.data[axis]) / rayInObjectSpace.direction.data[axis];
-						deltaT[axis] = -width[axis] / rayInObjectSpace.direction.data[axis];
-						step[axis] = -1;
-						out[axis] = -1;
-					}
-				}
-
-				bool hitSomething = false;
-				for (;;)
-				{
-					//Logger::Debug("na: %d %d", xx + pos[0], yy + pos[1]);
-					// Check for intersection in current voxel and advance to next
-					Vector3 p00 = heightmap->GetPoint(xx + pos[0], yy + pos[1], bbox);
-					Vector3 p01 = heightmap->GetPoint(xx + pos[0], yy + pos[1] + 1, bbox);
-					Vector3 p10 = heightmap->GetPoint(xx + pos[0] + 1, yy + pos[1], bbox);
-					Vector3 p11 = heightmap->GetPoint(xx + pos[0] + 1, yy + pos[1] + 1, bbox);
-
-					float32 t1, t2;
-					if (Intersection::RayTriangle(rayInObjectSpace, p00, p01, p11, t1))
-					{
-						if (t1 < localResult3)
-						{
-							localResult3 = t1;
-						}
-					}
-
-					if (Intersection::RayTriangle(rayInObjectSpace, p00, p11, p10, t2))
-					{
-						if (t2 < localResult3)
-						{
-							localResult3 = t2;
-						}
-					}
-
-
-					// Advance to next voxel
-
-					// Find _stepAxis_ for stepping to next voxel
-					/*int bits = (   (nextCrossingT[0] < nextCrossingT[1]) << 2)  // X < Y
-					+ ((nextCrossingT[0] < nextCrossingT[2]) << 1)  // X < Z
-					+ ((nextCrossingT[1] < nextCrossingT[2]));      // Y < Z
-					//    0 - ZYX
-					//    7 - XYZ
-
-
-					const int cmpToAxis[8] = { 2, 1, 2, 1, 2, 2, 0, 0 };
-					int stepAxis = cmpToAxis[bits];
-					*/
-
-
-					int32 stepAxis = 0;
-					if (nextCrossingT[0] < nextCrossingT[1])stepAxis = 0;
-					else stepAxis = 1;
-
-					if (tMax < nextCrossingT[stepAxis])
-						break;
-					pos[stepAxis] += step[stepAxis];
-					if (pos[stepAxis] == out[stepAxis])
-						break;
-					nextCrossingT[stepAxis] += deltaT[stepAxis];
-				}
-			}
-			//if (!FLOAT_EQUAL(localResult2, localResult3))
-			//            {
-			//                int i = 0;
-			//                Logger::Error("DDA Algorithm mistake");
-			//            }
-
-			resultT = Min(resultT, localResult3);
-
-
-		} // End of intersection code
-
-
-		  // If level is not final go deeper
-		if ((level < subdivision->GetLevelCount() - 1))
-		{
-			uint32 x2 = x << 1;
-			uint32 y2 = y << 1;
-
-			RecursiveRayTrace(level + 1, x2 + 0, y2 + 0, rayInObjectSpace, resultT);
-			RecursiveRayTrace(level + 1, x2 + 1, y2 + 0, rayInObjectSpace, resultT);
-			RecursiveRayTrace(level + 1, x2 + 0, y2 + 1, rayInObjectSpace, resultT);
-			RecursiveRayTrace(level + 1, x2 + 1, y2 + 1, rayInObjectSpace, resultT);
-		}
-	}
-#endif
+bool Landscape::RayTrace(const Ray3& rayInObjectSpace, float32& resultT) const
+{
+    return heightPyramid.RayCast(rayInObjectSpace, resultT);
 }
 
-bool Landscape::RayTrace(const Ray3& rayInObjectSpace, float32& resultT)
+uint32 Landscape::RayCast(const Ray3* raysInObjectSpace, uint32 count, float32* resultsT) const
 {
-    float32 localResultT = FLOAT_MAX;
-    RecursiveRayTrace(0, 0, 0, rayInObjectSpace, localResultT);
-
-    if (localResultT < FLOAT_MAX)
-    {
-        resultT = localResultT;
-        return true;
-    }
-    return false;
+    return heightPyramid.RayCast(raysInObjectSpace, count, resultsT);
 }
 }
@@ -8,6 +8,7 @@
 #include "Render/Highlevel/RenderObject.h"
 #include "FileSystem/FilePath.h"
 #include "MemoryManager/MemoryProfiler.h"
+#include "Render/Highlevel/HeightmapPyramid.h"
 #include "Render/Highlevel/LandscapeSubdivision.h"
 #include "Concurrency/Mutex.h"
 
@@ -41,6 +42,9 @@ public:
     static const int32 TEXTURE_SIZE_FULL_TILED = 2048;
     static const int32 CUSTOM_COLOR_TEXTURE_SIZE = 2048;
 
+    /** Max size of resident heightmap built for rendering and ray casts from tiled heightmap file. */
+    static const int32 TILED_HEIGHTMAP_RESIDENT_SIZE = 2048;
+
     const static FastName PARAM_TEXTURE_TILING;
     const static FastName PARAM_TILE_COLOR0;
     const static FastName PARAM_TILE_COLOR1;
@@ -75,6 +79,9 @@ public:
     /**
         \brief Builds landscape from heightmap image and bounding box of this landscape block
         \param[in] landscapeBox axial-aligned bounding box of the landscape block
+        Heightmap may be `TiledHeightmap` file. In this case it's read once into resident copy downsampled
+        to `TILED_HEIGHTMAP_RESIDENT_SIZE`, which serves rendering, ray casts and height queries.
+        Such landscape is read-only: `UpdatePart` isn't allowed and `Save` keeps the tiled file as is.
      */
     virtual void BuildLandscapeFromHeightmapImage(const FilePath& heightmapPathname, const AABBox3& landscapeBox);
 
@@ -101,6 +108,8 @@ public:
 
     Heightmap* GetHeightmap();
     virtual void SetHeightmap(Heightmap* height);
+    /** Return true if heightmap is downsampled copy of tiled heightmap file, see `BuildLandscapeFromHeightmapImage`. */
+    bool IsTiledHeightmap() const;
 
     NMaterial* GetMaterial();
     void SetMaterial(NMaterial* material);
@@ -131,8 +140,20 @@ public:
     void SetRenderMode(RenderMode mode);
     void UpdateMaterialFlags();
 
-    void RecursiveRayTrace(uint32 level, uint32 x, uint32 y, const Ray3& rayInObjectSpace, float32& resultT);
-    bool RayTrace(const Ray3& rayInObjectSpace, float32& resultT);
+    /**
+        Find the closest intersection of ray given in landscape object space with landscape surface.
+        Return true and write ray parameter of intersection to `resultT` if it's found.
+        Ray casts and height queries only read landscape data, so they may be called from several threads at once,
+        but not concurrently with heightmap modification, `UpdatePart` or landscape rebuild.
+    */
+    bool RayTrace(const Ray3& rayInObjectSpace, float32& resultT) const;
+
+    /**
+        Cast batch of rays given in landscape object space, write parameter of the closest intersection of every ray
+        to `resultsT`, or `FLOAT_MAX` if ray misses landscape. Return count of rays which hit landscape.
+        Large batches are processed on JobManager workers.
+    */
+    uint32 RayCast(const Ray3* raysInObjectSpace, uint32 count, float32* resultsT) const;
 
 protected:
     void AddPatchToRender(uint32 level, uint32 x, uint32 y);
@@ -183,7 +204,9 @@ protected:
 
     FilePath heightmapPath;
     Heightmap* heightmap = nullptr;
+    bool isTiledHeightmap = false; // heightmap is read-only copy of tiled heightmap file
     LandscapeSubdivision* subdivision = nullptr;
+    HeightmapPyramid heightPyramid;
 
     NMaterial* landscapeMaterial = nullptr;
     FoliageSystem* foliageSystem = nullptr;
@@ -276,9 +299,12 @@ protected:
 
     Texture* CreateHeightTexture(Heightmap* heightmap, RenderMode renderMode);
     Vector<Image*> CreateHeightTextureData(Heightmap* heightmap, RenderMode renderMode);
+    // Rewrite texels of height texture `level` which depend on heights in `heightmapRect`
+    void UpdateHeightTextureData(uint32 level, const Rect2i& heightmapRect, uint8* levelData) const;
 
     Texture* CreateTangentTexture();
     Vector<Image*> CreateTangentBasisTextureData();
+    void UpdateTangentBasisTextureData(const Rect2i& heightmapRect, uint8* data) const;
 
     void DrawLandscapeInstancing();
     void DrawPatchInstancing(uint32 level, uint32 xx, uint32 yy, const Vector4& neighborLevel, float32 patchMorph = 0.f, const Vector4& neighborMorph = Vector4());
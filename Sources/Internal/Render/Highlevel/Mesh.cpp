@@ -3,6 +3,7 @@
 #include "Render/3D/PolygonGroup.h"
 #include "Render/Highlevel/ShadowVolume.h"
 #include "Render/Material/NMaterial.h"
+#include "Base/TemplateHelpers.h"
 
 namespace DAVA
 {
@@ -59,6 +60,11 @@ void Mesh::Load(KeyedArchive* archive, SerializationContext* serializationContex
     RenderObject::Load(archive, serializationContext);
 }
 
+bool Mesh::SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext)
+{
+    return IsPointerToExactClass<Mesh>(this) && SaveFlatValues(writer, serializationContext);
+}
+
 void Mesh::BakeGeometry(const Matrix4& transform)
 {
     uint32 size = static_cast<uint32>(renderBatchArray.size());
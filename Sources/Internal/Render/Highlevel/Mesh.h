@@ -29,6 +29,7 @@ public:
 
     virtual void Save(KeyedArchive* archive, SerializationContext* serializationContext);
     virtual void Load(KeyedArchive* archive, SerializationContext* serializationContext);
+    bool SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext) override;
 
     virtual void BakeGeometry(const Matrix4& transform);
 
@@ -6,6 +6,7 @@
 #include "Render/Highlevel/RenderPassNames.h"
 #include "Render/Highlevel/SpeedTreeObject.h"
 #include "Scene3D/SceneFileV2.h"
+#include "Scene3D/SceneFile/FlatHierarchy.h"
 #include "Debug/DVAssert.h"
 #include "Reflection/ReflectionRegistrator.h"
 #include "Reflection/ReflectedMeta.h"
@@ -190,6 +191,37 @@ void RenderBatch::Load(KeyedArchive* archive, SerializationContext* serializatio
     BaseObject::LoadObject(archive);
 }
 
+void RenderBatch::SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext)
+{
+    writer.Write(aabbox);
+    writer.Write(sortingKey);
+    writer.Write(dataSource != nullptr ? dataSource->GetNodeID() : DataNode::INVALID_ID);
+    writer.Write(material != nullptr ? material->GetNodeID() : DataNode::INVALID_ID);
+}
+
+bool RenderBatch::LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext)
+{
+    uint64 dataSourceID = DataNode::INVALID_ID;
+    uint64 materialID = DataNode::INVALID_ID;
+    if (!reader.Read(aabbox) || !reader.Read(sortingKey) || !reader.Read(dataSourceID) || !reader.Read(materialID))
+    {
+        return false;
+    }
+
+    PolygonGroup* pg = static_cast<PolygonGroup*>(serializationContext->GetDataBlock(dataSourceID));
+    if (pg != dataSource)
+    {
+        SafeRelease(dataSource);
+        dataSource = SafeRetain(pg);
+    }
+
+    SetMaterial(static_cast<NMaterial*>(serializationContext->GetDataBlock(materialID)));
+    if (material)
+        material->PreBuildMaterial(PASS_FORWARD);
+
+    return true;
+}
+
 void RenderBatch::UpdateAABBoxFromSource()
 {
     if (NULL != dataSource)
@@ -20,6 +20,12 @@ class RenderObject;
 class RenderBatch;
 class NMaterial;
 
+namespace FlatHierarchy
+{
+class ValueWriter;
+class ValueReader;
+}
+
 class RenderBatch : public BaseObject
 {
 protected:
@@ -47,6 +53,10 @@ public:
     virtual void Save(KeyedArchive* archive, SerializationContext* serializationContext);
     virtual void Load(KeyedArchive* archive, SerializationContext* serializationContext);
 
+    /** Writes values stored by RenderBatch::Save as plain values to flat scene hierarchy. */
+    void SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext);
+    bool LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext);
+
     /*
         \brief This is additional sorting key. It should be from 0 to 15.
      */
@@ -1,9 +1,16 @@
 #include "Render/Highlevel/RenderBatchArray.h"
 #include "Render/Highlevel/RenderSystem.h"
 #include "Render/Highlevel/RenderPass.h"
+#include "Base/Radix/Radix.h"
 
 namespace DAVA
 {
+namespace RenderBatchArrayDetails
+{
+// Insertion sort over previous frame order gives up after this amount of moves per batch and falls back to radix sort
+const uint32 MAX_COHERENT_MOVES_PER_BATCH = 4;
+}
+
 RenderBatchArray::RenderBatchArray()
     : sortFlags(0)
 {
@@ -11,9 +18,118 @@ RenderBatchArray::RenderBatchArray()
     //renderBatchArray.reserve(4096);
 }
 
-bool RenderBatchArray::MaterialCompareFunction(const RenderBatch* a, const RenderBatch* b)
+uint64 RenderBatchArray::MakeSortKey(uint32 layerSortingKey, uint32 index)
+{
+    return (static_cast<uint64>(~layerSortingKey) << 32) | index;
+}
+
+void RenderBatchArray::BuildMaterialKeys()
+{
+    uint32 count = static_cast<uint32>(renderBatchArray.size());
+    for (uint32 i = 0; i < count; ++i)
+    {
+        RenderBatch* batch = renderBatchArray[i];
+        uint32 materialIndex = batch->GetMaterial()->GetSortingKey();
+        //VI: sorting key has the following layout: (s:4)(m:28)
+        uint32 layerSortingKey = (materialIndex & 0x0FFFFFFF) | (batch->GetSortingKey() << 28);
+        sortItems[i] = { MakeSortKey(layerSortingKey, i), batch };
+    }
+}
+
+void RenderBatchArray::BuildBackToFrontKeys(Camera* camera)
+{
+    Vector3 cameraPosition = camera->GetPosition();
+    Vector3 cameraDirection = camera->GetDirection();
+
+    uint32 count = static_cast<uint32>(renderBatchArray.size());
+    for (uint32 i = 0; i < count; ++i)
+    {
+        RenderBatch* batch = renderBatchArray[i];
+        Vector3 delta = batch->GetRenderObject()->GetWorldMatrixPtr()->GetTranslationVector() - cameraPosition;
+        uint32 distance = delta.DotProduct(cameraDirection) < 0 ? 0 : (static_cast<uint32>(delta.Length() * 1000.0f)); //x1000.0f is to prevent resorting of nearby objects (still 26 km range)
+        distance = distance + 31 - batch->GetSortingOffset();
+        uint32 layerSortingKey = (distance & 0x0fffffff) | (batch->GetSortingKey() << 28);
+        sortItems[i] = { MakeSortKey(layerSortingKey, i), batch };
+    }
+}
+
+void RenderBatchArray::BuildFrontToBackKeys(Camera* camera)
 {
-    return a->layerSortingKey > b->layerSortingKey;
+    Vector3 cameraPosition = camera->GetPosition();
+
+    uint32 count = static_cast<uint32>(renderBatchArray.size());
+    for (uint32 i = 0; i < count; ++i)
+    {
+        RenderBatch* batch = renderBatchArray[i];
+        RenderObject* renderObject = batch->GetRenderObject();
+        Vector3 position = renderObject->GetWorldBoundingBox().GetCenter();
+        uint32 distance = static_cast<uint32>((position - cameraPosition).Length() * 100.0f) + 31 - batch->GetSortingOffset();
+        uint32 distanceBits = (0x0fffffff - distance) & 0x0fffffff;
+        uint32 layerSortingKey = distanceBits | (batch->GetSortingKey() << 28);
+        sortItems[i] = { MakeSortKey(layerSortingKey, i), batch };
+    }
+}
+
+/**
+    Camera and scene usually change a little between frames, so when the same batches come in the same order
+    as last frame, previous sorted order is applied and fixed with insertion sort. That costs near linear time
+    for almost sorted arrays; if the order changed too much we give up and return false.
+*/
+bool RenderBatchArray::SortItemsWithPreviousOrder()
+{
+    using namespace RenderBatchArrayDetails;
+
+    uint32 count = static_cast<uint32>(sortItems.size());
+    if (prevUnsortedBatches.size() != count || !std::equal(renderBatchArray.begin(), renderBatchArray.end(), prevUnsortedBatches.begin()))
+    {
+        return false;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        sortItemsTemp[i] = sortItems[prevSortedOrder[i]];
+    }
+
+    uint64 movesLeft = static_cast<uint64>(count) * MAX_COHERENT_MOVES_PER_BATCH;
+    for (uint32 i = 1; i < count; ++i)
+    {
+        SortItem item = sortItemsTemp[i];
+        uint32 j = i;
+        while (j > 0 && sortItemsTemp[j - 1].key > item.key)
+        {
+            if (movesLeft == 0)
+            {
+                return false;
+            }
+            --movesLeft;
+
+            sortItemsTemp[j] = sortItemsTemp[j - 1];
+            --j;
+        }
+        sortItemsTemp[j] = item;
+    }
+
+    sortItems.swap(sortItemsTemp);
+    return true;
+}
+
+void RenderBatchArray::SortItems()
+{
+    uint32 count = static_cast<uint32>(sortItems.size());
+    sortItemsTemp.resize(count);
+
+    if (!SortItemsWithPreviousOrder())
+    {
+        RadixSortByKey64(sortItems.data(), sortItemsTemp.data(), count);
+    }
+
+    prevUnsortedBatches.assign(renderBatchArray.begin(), renderBatchArray.end());
+    prevSortedOrder.resize(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        renderBatchArray[i] = sortItems[i].batch;
+        prevSortedOrder[i] = static_cast<uint32>(sortItems[i].key);
+    }
 }
 
 void RenderBatchArray::Sort(Camera* camera)
@@ -23,60 +139,29 @@ void RenderBatchArray::Sort(Camera* camera)
 
     if ((sortFlags & SORT_THIS_FRAME) == SORT_THIS_FRAME)
     {
-        if (sortFlags & SORT_BY_MATERIAL)
+        if (sortFlags & (SORT_BY_MATERIAL | SORT_BY_DISTANCE_BACK_TO_FRONT | SORT_BY_DISTANCE_FRONT_TO_BACK))
         {
-            //Vector3 cameraPosition = camera->GetPosition();
-
-            for (RenderBatch* batch : renderBatchArray)
-            {
-                //pointer_size renderObjectId = (pointer_size)batch->GetRenderObject();
-                //RenderObject * renderObject = batch->GetRenderObject();
-                //Vector3 position = renderObject->GetWorldBoundingBox().GetCenter();
-                //float32 distance = (position - cameraPosition).Length();
-                //uint32 distanceBits = (0xFFFF - ((uint32)distance) & 0xFFFF);
-                uint32 materialIndex = batch->GetMaterial()->GetSortingKey();
-                //VI: sorting key has the following layout: (m:8)(s:4)(d:20)
-                //batch->layerSortingKey = (pointer_size)((materialIndex << 20) | (batch->GetSortingKey() << 28) | (distanceBits));
-                batch->layerSortingKey = static_cast<pointer_size>((materialIndex & 0x0FFFFFFF) | (batch->GetSortingKey() << 28));
-                //batch->layerSortingKey = (pointer_size)((batch->GetMaterial()->GetSortingKey() << 20) | (batch->GetSortingKey() << 28) | (renderObjectId & 0x000FFFFF));
-            }
+            sortItems.resize(renderBatchArray.size());
+        }
 
-            std::sort(renderBatchArray.begin(), renderBatchArray.end(), MaterialCompareFunction);
+        if (sortFlags & SORT_BY_MATERIAL)
+        {
+            BuildMaterialKeys();
+            SortItems();
 
             sortFlags &= ~SORT_REQUIRED;
         }
         else if (sortFlags & SORT_BY_DISTANCE_BACK_TO_FRONT)
         {
-            Vector3 cameraPosition = camera->GetPosition();
-            Vector3 cameraDirection = camera->GetDirection();
-
-            for (RenderBatch* batch : renderBatchArray)
-            {
-                Vector3 delta = batch->GetRenderObject()->GetWorldMatrixPtr()->GetTranslationVector() - cameraPosition;
-                uint32 distance = delta.DotProduct(cameraDirection) < 0 ? 0 : (static_cast<uint32>(delta.Length() * 1000.0f)); //x1000.0f is to prevent resorting of nearby objects (still 26 km range)
-                distance = distance + 31 - batch->GetSortingOffset();
-                batch->layerSortingKey = (distance & 0x0fffffff) | (batch->GetSortingKey() << 28);
-            }
-
-            std::stable_sort(renderBatchArray.begin(), renderBatchArray.end(), MaterialCompareFunction);
+            BuildBackToFrontKeys(camera);
+            SortItems();
 
             sortFlags |= SORT_REQUIRED;
         }
         else if (sortFlags & SORT_BY_DISTANCE_FRONT_TO_BACK)
         {
-            Vector3 cameraPosition = camera->GetPosition();
-
-            for (RenderBatch* batch : renderBatchArray)
-            {
-                RenderObject* renderObject = batch->GetRenderObject();
-                Vector3 position = renderObject->GetWorldBoundingBox().GetCenter();
-                uint32 distance = static_cast<uint32>((position - cameraPosition).Length() * 100.0f) + 31 - batch->GetSortingOffset();
-                uint32 distanceBits = 0x0fffffff - distance & 0x0fffffff;
-
-                batch->layerSortingKey = distanceBits | (batch->GetSortingKey() << 28);
-            }
-
-            std::sort(renderBatchArray.begin(), renderBatchArray.end(), MaterialCompareFunction);
+            BuildFrontToBackKeys(camera);
+            SortItems();
 
             sortFlags |= SORT_REQUIRED;
         }
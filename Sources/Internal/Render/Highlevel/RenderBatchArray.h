@@ -33,9 +33,34 @@ public:
     inline void SetSortingFlags(uint32 flags);
 
 private:
+    /**
+        Packed sort key stored next to batch, so sorting never touches batches, materials or objects.
+        Key layout from high bits to low: (~layer:4)(~material or ~distance:28)(stable id:32).
+        Layer and material/distance parts are inverted to keep previous descending order with ascending radix sort,
+        stable id is the index of batch in unsorted array, so equal keys keep their insertion order.
+    */
+    struct SortItem
+    {
+        uint64 key;
+        RenderBatch* batch;
+    };
+
+    static uint64 MakeSortKey(uint32 layerSortingKey, uint32 index);
+    void BuildMaterialKeys();
+    void BuildBackToFrontKeys(Camera* camera);
+    void BuildFrontToBackKeys(Camera* camera);
+    void SortItems();
+    bool SortItemsWithPreviousOrder();
+
     Vector<RenderBatch*> renderBatchArray;
     uint32 sortFlags;
-    static bool MaterialCompareFunction(const RenderBatch* a, const RenderBatch* b);
+
+    Vector<SortItem> sortItems;
+    Vector<SortItem> sortItemsTemp;
+
+    // frame-to-frame coherence: unsorted input and resulting order of the previous sort
+    Vector<RenderBatch*> prevUnsortedBatches;
+    Vector<uint32> prevSortedOrder;
 };
 
 inline void RenderBatchArray::Clear()
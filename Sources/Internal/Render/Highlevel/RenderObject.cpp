@@ -1,5 +1,6 @@
 #include "Render/Highlevel/RenderObject.h"
 #include "Base/ObjectFactory.h"
+#include "Base/TemplateHelpers.h"
 #include "Base/GlobalEnum.h"
 #include "Debug/DVAssert.h"
 #include "Utils/Utils.h"
@@ -7,6 +8,7 @@
 #include "Render/Renderer.h"
 #include "Reflection/ReflectionRegistrator.h"
 #include "Reflection/ReflectedMeta.h"
+#include "Scene3D/SceneFile/FlatHierarchy.h"
 
 ENUM_DECLARE(DAVA::RenderObject::eType)
 {
@@ -367,6 +369,73 @@ void RenderObject::Load(KeyedArchive* archive, SerializationContext* serializati
     BaseObject::LoadObject(archive);
 }
 
+bool RenderObject::SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext)
+{
+    return IsPointerToExactClass<RenderObject>(this) && SaveFlatValues(writer, serializationContext);
+}
+
+bool RenderObject::SaveFlatValues(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext)
+{
+    uint32 renderBatchCount = 0;
+    for (const RenderBatchWithOptions& batch : renderBatchArray)
+    {
+        if (batch.renderBatch != nullptr)
+        {
+            if (!IsPointerToExactClass<RenderBatch>(batch.renderBatch))
+            {
+                return false;
+            }
+            ++renderBatchCount;
+        }
+    }
+
+    writer.Write(debugFlags);
+    writer.Write(staticOcclusionIndex);
+    writer.Write(flags & RenderObject::SERIALIZATION_CRITERIA);
+    writer.Write(renderBatchCount);
+    for (const RenderBatchWithOptions& batch : renderBatchArray)
+    {
+        if (batch.renderBatch != nullptr)
+        {
+            writer.Write(batch.lodIndex);
+            writer.Write(batch.switchIndex);
+            batch.renderBatch->SaveFlat(writer, serializationContext);
+        }
+    }
+    return true;
+}
+
+bool RenderObject::LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext)
+{
+    uint32 savedFlags = 0;
+    uint32 renderBatchCount = 0;
+    if (!reader.Read(debugFlags) || !reader.Read(staticOcclusionIndex) || !reader.Read(savedFlags) || !reader.Read(renderBatchCount))
+    {
+        return false;
+    }
+
+    flags = ((savedFlags & RenderObject::SERIALIZATION_CRITERIA) | (flags & ~RenderObject::SERIALIZATION_CRITERIA));
+
+    for (uint32 i = 0; i < renderBatchCount; ++i)
+    {
+        int32 batchLodIndex = -1;
+        int32 batchSwitchIndex = -1;
+        if (!reader.Read(batchLodIndex) || !reader.Read(batchSwitchIndex))
+        {
+            return false;
+        }
+
+        ScopedPtr<RenderBatch> batch(new RenderBatch());
+        if (!batch->LoadFlat(reader, serializationContext))
+        {
+            return false;
+        }
+        AddRenderBatch(batch, batchLodIndex, batchSwitchIndex);
+    }
+
+    return true;
+}
+
 void RenderObject::BindDynamicParameters(Camera* camera, RenderBatch* batch)
 {
     DVASSERT(worldTransform != 0);
@@ -15,6 +15,12 @@ const static uint16 INVALID_STATIC_OCCLUSION_INDEX = uint16(-1);
 
 class RenderBatch;
 
+namespace FlatHierarchy
+{
+class ValueWriter;
+class ValueReader;
+}
+
 struct RenderBatchWithOptions : public InspBase
 {
     RenderBatch* renderBatch = nullptr;
@@ -169,6 +175,13 @@ public:
     virtual void Save(KeyedArchive* archive, SerializationContext* serializationContext);
     virtual void Load(KeyedArchive* archive, SerializationContext* serializationContext);
 
+    /**
+        Writes render object as plain values to flat scene hierarchy. Returns false for derived classes
+        and batches which store more than RenderObject and RenderBatch do, such objects are stored with Save.
+    */
+    virtual bool SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext);
+    virtual bool LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext);
+
     void SetOwnerDebugInfo(const FastName& str)
     {
         ownerDebugInfo = str;
@@ -281,6 +294,7 @@ protected:
     void InternalRemoveRenderBatchFromCollection(Vector<RenderBatchWithOptions>& collection, RenderBatch* batch);
     void UpdateActiveRenderBatchesFromCollection(const Vector<RenderBatchWithOptions>& collection);
     void UpdateActiveRenderBatches();
+    bool SaveFlatValues(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext);
 
     static const int32 DEFAULT_RENDEROBJECT_FLAGS = eFlags::VISIBLE | eFlags::VISIBLE_STATIC_OCCLUSION | eFlags::VISIBLE_QUALITY;
 
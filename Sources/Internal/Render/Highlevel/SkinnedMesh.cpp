@@ -1,4 +1,4 @@
-#include "Scene3D/SkeletonAnimation/JointTransform.h"
+#include "Scene3D/SkeletonAnimation/JointTransformStreams.h"
 #include "Render/Highlevel/SkinnedMesh.h"
 #include "Render/Renderer.h"
 
@@ -93,7 +93,7 @@ void SkinnedMesh::BindDynamicParameters(Camera* camera, RenderBatch* batch)
     RenderObject::BindDynamicParameters(camera, batch);
 }
 
-void SkinnedMesh::UpdateJointTransforms(const Vector<JointTransform>& finalTransforms)
+void SkinnedMesh::UpdateJointTransforms(const JointTransformStreams& finalTransforms)
 {
     for (auto& jointsData : jointTargetsData)
     {
@@ -103,11 +103,10 @@ void SkinnedMesh::UpdateJointTransforms(const Vector<JointTransform>& finalTrans
         for (uint32 j = 0; j < data.jointsDataCount; ++j)
         {
             uint32 transformIndex = targets[j];
-            DVASSERT(transformIndex < uint32(finalTransforms.size()));
+            DVASSERT(transformIndex < finalTransforms.GetSize());
 
-            const JointTransform& finalTransform = finalTransforms[transformIndex];
-            data.positions[j] = Vector4(Vector3(finalTransform.GetPosition().data), finalTransform.GetScale());
-            data.quaternions[j] = Vector4(finalTransform.GetOrientation().data);
+            data.positions[j] = Vector4(finalTransforms.GetPosition(transformIndex), finalTransforms.GetScale(transformIndex));
+            data.quaternions[j] = finalTransforms.GetOrientation(transformIndex);
         }
     }
 }
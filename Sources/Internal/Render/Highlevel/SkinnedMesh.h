@@ -15,7 +15,7 @@ class PolygonGroup;
 class RenderBatch;
 class ShadowVolume;
 class NMaterial;
-class JointTransform;
+class JointTransformStreams;
 class SkinnedMesh : public RenderObject
 {
 public:
@@ -41,7 +41,7 @@ public:
     void BindDynamicParameters(Camera* camera, RenderBatch* batch) override;
 
     void SetBoundingBox(const AABBox3& box);
-    void UpdateJointTransforms(const Vector<JointTransform>& finalTransforms);
+    void UpdateJointTransforms(const JointTransformStreams& finalTransforms);
 
     void SetJointTargets(RenderBatch* batch, const JointTargets& jointTargets);
 
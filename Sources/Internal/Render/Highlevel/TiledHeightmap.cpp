@@ -0,0 +1,490 @@
+#include "Render/Highlevel/TiledHeightmap.h"
+#include "Render/Highlevel/Heightmap.h"
+#include "Base/ScopedPtr.h"
+#include "Concurrency/LockGuard.h"
+#include "FileSystem/File.h"
+#include "FileSystem/Private/MappedFile.h"
+#include "Logger/Logger.h"
+
+namespace DAVA
+{
+namespace TiledHeightmapDetails
+{
+const char8 SIGNATURE[4] = { 'T', 'H', 'M', 'P' };
+const uint32 VERSION = 1;
+const String FILE_EXTENSION(".theightmap");
+
+uint64 AlignOffset(uint64 offset)
+{
+    const uint64 alignment = TiledHeightmap::TILE_ALIGNMENT;
+    return (offset + alignment - 1) / alignment * alignment;
+}
+}
+
+const String& TiledHeightmap::FileExtension()
+{
+    return TiledHeightmapDetails::FILE_EXTENSION;
+}
+
+bool TiledHeightmap::Save(const FilePath& filePath, const Heightmap* heightmap, uint32 tileSize)
+{
+    using namespace TiledHeightmapDetails;
+
+    DVASSERT(heightmap != nullptr);
+    DVASSERT(IsPowerOf2(tileSize) && tileSize <= MAX_TILE_SIZE);
+
+    const uint32 size = uint32(heightmap->Size());
+    if (size == 0)
+    {
+        Logger::Error("TiledHeightmap::Save: heightmap is empty");
+        return false;
+    }
+
+    tileSize = Min(tileSize, size);
+    const uint32 tilesPerSide = (size + tileSize - 1) / tileSize;
+    const uint64 tileBytes = uint64(tileSize) * tileSize * sizeof(uint16);
+
+    ScopedPtr<File> file(File::Create(filePath, File::CREATE | File::WRITE));
+    if (!file)
+    {
+        Logger::Error("TiledHeightmap::Save: failed to create file %s", filePath.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    FileHeader header;
+    Memcpy(header.signature, SIGNATURE, sizeof(header.signature));
+    header.version = VERSION;
+    header.size = size;
+    header.tileSize = tileSize;
+
+    Vector<uint64> tileOffsets(tilesPerSide * tilesPerSide);
+    uint64 offset = AlignOffset(sizeof(FileHeader) + tileOffsets.size() * sizeof(uint64));
+    for (uint64& tileOffset : tileOffsets)
+    {
+        tileOffset = offset;
+        offset = AlignOffset(offset + tileBytes);
+    }
+
+    bool written = (file->Write(&header) == sizeof(header));
+    written = written && (file->Write(tileOffsets.data(), uint32(tileOffsets.size() * sizeof(uint64))) == tileOffsets.size() * sizeof(uint64));
+
+    const uint16* data = heightmap->Data();
+    Vector<uint16> tileHeights(tileSize * tileSize);
+    Vector<uint8> padding(TILE_ALIGNMENT, 0);
+    for (uint32 tileIndex = 0; written && tileIndex < tileOffsets.size(); ++tileIndex)
+    {
+        uint32 x0 = (tileIndex % tilesPerSide) * tileSize;
+        uint32 y0 = (tileIndex / tilesPerSide) * tileSize;
+        for (uint32 y = 0; y < tileSize; ++y)
+        {
+            const uint16* srcRow = data + Min(y0 + y, size - 1) * size;
+            uint16* dstRow = tileHeights.data() + y * tileSize;
+            for (uint32 x = 0; x < tileSize; ++x)
+            {
+                dstRow[x] = srcRow[Min(x0 + x, size - 1)];
+            }
+        }
+
+        uint64 position = file->GetPos();
+        written = file->Write(padding.data(), uint32(tileOffsets[tileIndex] - position)) == tileOffsets[tileIndex] - position;
+        written = written && (file->Write(tileHeights.data(), uint32(tileBytes)) == tileBytes);
+    }
+
+    if (!written)
+    {
+        Logger::Error("TiledHeightmap::Save: failed to write file %s", filePath.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+TiledHeightmap::TiledHeightmap() = default;
+
+TiledHeightmap::~TiledHeightmap()
+{
+    Close();
+}
+
+bool TiledHeightmap::Open(const FilePath& filePath)
+{
+    using namespace TiledHeightmapDetails;
+
+    Close();
+
+    LockGuard<Mutex> lock(mutex);
+
+    RefPtr<File> f(File::Create(filePath, File::OPEN | File::READ));
+    if (!f)
+    {
+        Logger::Error("TiledHeightmap::Open: failed to open file %s", filePath.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    FileHeader header;
+    if (f->Read(&header) != sizeof(header) || Memcmp(header.signature, SIGNATURE, sizeof(SIGNATURE)) != 0 || header.version != VERSION
+        || header.size == 0 || header.tileSize == 0 || !IsPowerOf2(header.tileSize))
+    {
+        Logger::Error("TiledHeightmap::Open: wrong file format %s", filePath.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    const uint32 headerTilesPerSide = (header.size + header.tileSize - 1) / header.tileSize;
+    const uint64 tilesCount = uint64(headerTilesPerSide) * headerTilesPerSide;
+    const uint64 tileBytes = uint64(header.tileSize) * header.tileSize * sizeof(uint16);
+    const uint64 fileSize = f->GetSize();
+
+    // check header against file size before tile index is allocated, so broken header can't request huge allocation
+    if (header.tileSize > header.size || header.tileSize > MAX_TILE_SIZE || tileBytes > fileSize
+        || tilesCount > (fileSize - sizeof(header)) / sizeof(uint64))
+    {
+        Logger::Error("TiledHeightmap::Open: header doesn't match file size %s", filePath.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    Vector<uint64> offsets(static_cast<size_t>(tilesCount));
+    uint32 offsetsBytes = uint32(offsets.size() * sizeof(uint64));
+    if (f->Read(offsets.data(), offsetsBytes) != offsetsBytes)
+    {
+        Logger::Error("TiledHeightmap::Open: failed to read tile index %s", filePath.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    for (uint64 tileOffset : offsets)
+    {
+        if (tileOffset + tileBytes > fileSize)
+        {
+            Logger::Error("TiledHeightmap::Open: tile index is out of file bounds %s", filePath.GetAbsolutePathname().c_str());
+            return false;
+        }
+    }
+
+    mapping = MappedFile::Open(filePath);
+    if (!mapping)
+    {
+        Logger::Warning("TiledHeightmap::Open: can't map %s, fall back to file reads", filePath.GetAbsolutePathname().c_str());
+    }
+
+    file = f;
+    size = header.size;
+    tileSize = header.tileSize;
+    tilesPerSide = headerTilesPerSide;
+    tileOffsets = std::move(offsets);
+    tileToSlot.assign(tileOffsets.size(), uint32(INVALID_INDEX));
+    stats = Stats();
+
+    return true;
+}
+
+void TiledHeightmap::Close()
+{
+    LockGuard<Mutex> lock(mutex);
+
+    file = nullptr;
+    mapping.reset();
+
+    size = 0;
+    tileSize = 0;
+    tilesPerSide = 0;
+    tileOffsets.clear();
+
+    tileToSlot.clear();
+    slots.clear();
+    freeSlots.clear();
+    lruHead = INVALID_INDEX;
+    lruTail = INVALID_INDEX;
+    stats = Stats();
+}
+
+bool TiledHeightmap::IsOpen() const
+{
+    LockGuard<Mutex> lock(mutex);
+    return size != 0;
+}
+
+bool TiledHeightmap::IsMapped() const
+{
+    LockGuard<Mutex> lock(mutex);
+    return mapping != nullptr;
+}
+
+uint32 TiledHeightmap::GetSize() const
+{
+    LockGuard<Mutex> lock(mutex);
+    return size;
+}
+
+uint32 TiledHeightmap::GetTileSize() const
+{
+    LockGuard<Mutex> lock(mutex);
+    return tileSize;
+}
+
+void TiledHeightmap::SetMemoryBudget(uint32 bytes)
+{
+    LockGuard<Mutex> lock(mutex);
+    memoryBudget = bytes;
+    EvictTiles(GetMaxResidentTilesCount());
+
+    for (uint32 slotIndex : freeSlots)
+    {
+        Vector<uint16>().swap(slots[slotIndex].heights);
+    }
+}
+
+uint32 TiledHeightmap::GetMemoryBudget() const
+{
+    LockGuard<Mutex> lock(mutex);
+    return memoryBudget;
+}
+
+void TiledHeightmap::Prefetch(const Rect2i& heightmapRect)
+{
+    LockGuard<Mutex> lock(mutex);
+    if (size == 0)
+        return;
+
+    int32 x0 = Max(heightmapRect.x, 0);
+    int32 y0 = Max(heightmapRect.y, 0);
+    int32 x1 = Min(heightmapRect.x + heightmapRect.dx, int32(size)) - 1;
+    int32 y1 = Min(heightmapRect.y + heightmapRect.dy, int32(size)) - 1;
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    for (uint32 tileY = uint32(y0) / tileSize; tileY <= uint32(y1) / tileSize; ++tileY)
+    {
+        for (uint32 tileX = uint32(x0) / tileSize; tileX <= uint32(x1) / tileSize; ++tileX)
+        {
+            AcquireTile(tileX, tileY);
+        }
+    }
+}
+
+void TiledHeightmap::PrefetchAround(int32 x, int32 y, int32 radius)
+{
+    Prefetch(Rect2i(x - radius, y - radius, 2 * radius + 1, 2 * radius + 1));
+}
+
+uint16 TiledHeightmap::GetHeightClamp(int32 x, int32 y)
+{
+    LockGuard<Mutex> lock(mutex);
+    return GetHeightClampLocked(x, y);
+}
+
+float32 TiledHeightmap::GetHeightBilinear(float32 x, float32 y)
+{
+    int32 x0 = int32(std::floor(x));
+    int32 y0 = int32(std::floor(y));
+    float32 dx = x - float32(x0);
+    float32 dy = y - float32(y0);
+
+    LockGuard<Mutex> lock(mutex);
+    float32 h00 = float32(GetHeightClampLocked(x0, y0));
+    float32 h10 = float32(GetHeightClampLocked(x0 + 1, y0));
+    float32 h01 = float32(GetHeightClampLocked(x0, y0 + 1));
+    float32 h11 = float32(GetHeightClampLocked(x0 + 1, y0 + 1));
+
+    float32 h0 = h00 * (1.f - dx) + h10 * dx;
+    float32 h1 = h01 * (1.f - dx) + h11 * dx;
+    return h0 * (1.f - dy) + h1 * dy;
+}
+
+uint16 TiledHeightmap::GetHeightClampLocked(int32 x, int32 y)
+{
+    DVASSERT(size != 0);
+
+    uint32 cx = uint32(Clamp(x, 0, int32(size) - 1));
+    uint32 cy = uint32(Clamp(y, 0, int32(size) - 1));
+
+    const uint16* tile = AcquireTile(cx / tileSize, cy / tileSize);
+    if (tile == nullptr)
+        return 0;
+
+    return tile[(cy % tileSize) * tileSize + cx % tileSize];
+}
+
+void TiledHeightmap::ReadRegion(const Rect2i& heightmapRect, uint16* heights)
+{
+    LockGuard<Mutex> lock(mutex);
+    DVASSERT(heightmapRect.x >= 0 && heightmapRect.y >= 0);
+    DVASSERT(heightmapRect.x + heightmapRect.dx <= int32(size) && heightmapRect.y + heightmapRect.dy <= int32(size));
+
+    if (heightmapRect.dx <= 0 || heightmapRect.dy <= 0)
+        return;
+
+    const uint32 x0 = uint32(heightmapRect.x);
+    const uint32 y0 = uint32(heightmapRect.y);
+    const uint32 x1 = x0 + uint32(heightmapRect.dx);
+    const uint32 y1 = y0 + uint32(heightmapRect.dy);
+
+    // copy region tile by tile, so every tile is loaded once even if it's evicted right after
+    for (uint32 tileY = y0 / tileSize; tileY <= (y1 - 1) / tileSize; ++tileY)
+    {
+        for (uint32 tileX = x0 / tileSize; tileX <= (x1 - 1) / tileSize; ++tileX)
+        {
+            uint32 fromX = Max(tileX * tileSize, x0);
+            uint32 toX = Min((tileX + 1) * tileSize, x1);
+            uint32 fromY = Max(tileY * tileSize, y0);
+            uint32 toY = Min((tileY + 1) * tileSize, y1);
+
+            const uint16* tile = AcquireTile(tileX, tileY);
+            for (uint32 y = fromY; y < toY; ++y)
+            {
+                uint16* dst = heights + (y - y0) * heightmapRect.dx + (fromX - x0);
+                if (tile != nullptr)
+                {
+                    Memcpy(dst, tile + (y - tileY * tileSize) * tileSize + (fromX - tileX * tileSize), (toX - fromX) * sizeof(uint16));
+                }
+                else
+                {
+                    Memset(dst, 0, (toX - fromX) * sizeof(uint16));
+                }
+            }
+        }
+    }
+}
+
+TiledHeightmap::Stats TiledHeightmap::GetStats() const
+{
+    LockGuard<Mutex> lock(mutex);
+    return stats;
+}
+
+const uint16* TiledHeightmap::AcquireTile(uint32 tileX, uint32 tileY)
+{
+    DVASSERT(tileX < tilesPerSide && tileY < tilesPerSide);
+
+    uint32 tileIndex = tileY * tilesPerSide + tileX;
+    uint32 slotIndex = tileToSlot[tileIndex];
+    if (slotIndex != INVALID_INDEX)
+    {
+        if (slotIndex != lruHead)
+        {
+            UnlinkSlot(slotIndex);
+            LinkSlotFront(slotIndex);
+        }
+        return slots[slotIndex].heights.data();
+    }
+
+    EvictTiles(GetMaxResidentTilesCount() - 1);
+
+    if (freeSlots.empty())
+    {
+        slotIndex = uint32(slots.size());
+        slots.emplace_back();
+    }
+    else
+    {
+        slotIndex = freeSlots.back();
+        freeSlots.pop_back();
+    }
+
+    // heights buffer of evicted tile is reused
+    TileSlot& slot = slots[slotIndex];
+    slot.heights.resize(tileSize * tileSize);
+    if (!ReadTile(tileIndex, slot.heights.data()))
+    {
+        freeSlots.push_back(slotIndex);
+        return nullptr;
+    }
+
+    slot.tileIndex = tileIndex;
+    tileToSlot[tileIndex] = slotIndex;
+    LinkSlotFront(slotIndex);
+
+    stats.residentTilesCount++;
+    stats.residentBytes += tileSize * tileSize * sizeof(uint16);
+    stats.loadsCount++;
+
+    return slot.heights.data();
+}
+
+bool TiledHeightmap::ReadTile(uint32 tileIndex, uint16* heights)
+{
+    const uint32 tileBytes = tileSize * tileSize * sizeof(uint16);
+    const uint64 offset = tileOffsets[tileIndex];
+
+    if (mapping)
+    {
+        Memcpy(heights, mapping->GetData() + offset, tileBytes);
+        return true;
+    }
+
+    if (!file->Seek(int64(offset), File::SEEK_FROM_START) || file->Read(heights, tileBytes) != tileBytes)
+    {
+        Logger::Error("TiledHeightmap: failed to read tile %u", tileIndex);
+        return false;
+    }
+
+    return true;
+}
+
+void TiledHeightmap::EvictTiles(uint32 maxTilesCount)
+{
+    while (stats.residentTilesCount > maxTilesCount)
+    {
+        uint32 slotIndex = lruTail;
+        DVASSERT(slotIndex != INVALID_INDEX);
+
+        UnlinkSlot(slotIndex);
+
+        TileSlot& slot = slots[slotIndex];
+        tileToSlot[slot.tileIndex] = INVALID_INDEX;
+        slot.tileIndex = INVALID_INDEX;
+        freeSlots.push_back(slotIndex);
+
+        stats.residentTilesCount--;
+        stats.residentBytes -= tileSize * tileSize * sizeof(uint16);
+        stats.evictionsCount++;
+    }
+}
+
+void TiledHeightmap::LinkSlotFront(uint32 slotIndex)
+{
+    TileSlot& slot = slots[slotIndex];
+    slot.prev = INVALID_INDEX;
+    slot.next = lruHead;
+    if (lruHead != INVALID_INDEX)
+    {
+        slots[lruHead].prev = slotIndex;
+    }
+    lruHead = slotIndex;
+    if (lruTail == INVALID_INDEX)
+    {
+        lruTail = slotIndex;
+    }
+}
+
+void TiledHeightmap::UnlinkSlot(uint32 slotIndex)
+{
+    TileSlot& slot = slots[slotIndex];
+    if (slot.prev != INVALID_INDEX)
+    {
+        slots[slot.prev].next = slot.next;
+    }
+    else
+    {
+        lruHead = slot.next;
+    }
+
+    if (slot.next != INVALID_INDEX)
+    {
+        slots[slot.next].prev = slot.prev;
+    }
+    else
+    {
+        lruTail = slot.prev;
+    }
+
+    slot.prev = INVALID_INDEX;
+    slot.next = INVALID_INDEX;
+}
+
+uint32 TiledHeightmap::GetMaxResidentTilesCount() const
+{
+    if (tileSize == 0)
+        return 0;
+
+    return Max(memoryBudget / (tileSize * tileSize * uint32(sizeof(uint16))), 1u);
+}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/RefPtr.h"
+#include "Concurrency/Mutex.h"
+#include "FileSystem/FilePath.h"
+#include "Math/Math2D.h"
+
+namespace DAVA
+{
+class File;
+class Heightmap;
+class MappedFile;
+
+/**
+    Heightmap streamed by square tiles from disk, with resident tiles limited by memory budget.
+
+    Unlike `Heightmap`, which keeps `size` x `size` heights in memory (128 MB for 8k x 8k terrain),
+    tiled heightmap keeps only recently used tiles. Tiles are paged in on demand by height queries or ahead of them
+    by `Prefetch` around camera or query region, least recently used tiles are evicted when resident tiles exceed
+    the budget.
+
+    File format (little-endian):
+        FileHeader
+        uint64 tileOffsets[tilesPerSide * tilesPerSide] - tile index, offset of every tile from file start, row-major
+        tiles - `tileSize` x `tileSize` uint16 heights each, row-major, starting at `TILE_ALIGNMENT` aligned offsets
+    Border tiles of heightmap which size isn't multiple of tile size are padded with heights of the last row and column.
+
+    Tile index is read once by `Open`. File is memory-mapped if possible, so tile loads copy heights from the mapping
+    instead of going through file reads.
+
+    All functions are guarded by internal mutex, so tiled heightmap can be queried from any thread.
+    Querying many heights one by one is slow because of locking, use `ReadRegion` for batches.
+*/
+class TiledHeightmap final
+{
+public:
+    static const uint32 DEFAULT_TILE_SIZE = 256;
+    static const uint32 DEFAULT_MEMORY_BUDGET = 32 * 1024 * 1024;
+    static const uint32 TILE_ALIGNMENT = 4096;
+    static const uint32 MAX_TILE_SIZE = 32768; ///< Bytes of the largest tile fit `uint32`
+
+    struct Stats
+    {
+        uint32 residentTilesCount = 0;
+        uint32 residentBytes = 0;
+        uint32 loadsCount = 0; ///< Tiles read from file since `Open`
+        uint32 evictionsCount = 0; ///< Tiles evicted since `Open`
+    };
+
+    static const String& FileExtension();
+
+    /** Write `heightmap` to `filePath` in tiled format. `tileSize` should be power of two not greater than `MAX_TILE_SIZE`. */
+    static bool Save(const FilePath& filePath, const Heightmap* heightmap, uint32 tileSize = DEFAULT_TILE_SIZE);
+
+    TiledHeightmap();
+    ~TiledHeightmap();
+
+    TiledHeightmap(const TiledHeightmap&) = delete;
+    TiledHeightmap& operator=(const TiledHeightmap&) = delete;
+
+    /** Open tiled heightmap file and read its header and tile index, no tiles are loaded yet. */
+    bool Open(const FilePath& filePath);
+    void Close();
+
+    bool IsOpen() const;
+    bool IsMapped() const;
+
+    uint32 GetSize() const;
+    uint32 GetTileSize() const;
+
+    /** Set max size of resident tiles, at least one tile is kept resident. Excess tiles are evicted immediately. */
+    void SetMemoryBudget(uint32 bytes);
+    uint32 GetMemoryBudget() const;
+
+    /**
+        Load tiles covering `heightmapRect` clipped to heightmap bounds.
+        If they don't fit into memory budget, tiles loaded first are evicted.
+    */
+    void Prefetch(const Rect2i& heightmapRect);
+
+    /** Load tiles within `radius` heightmap points around point (`x`, `y`). */
+    void PrefetchAround(int32 x, int32 y, int32 radius);
+
+    /** Return height at point (`x`, `y`) clamped to heightmap bounds, loading its tile if needed. */
+    uint16 GetHeightClamp(int32 x, int32 y);
+
+    /** Return height at fractional point (`x`, `y`) interpolated between four neighbour heights, which are read under one lock. */
+    float32 GetHeightBilinear(float32 x, float32 y);
+
+    /**
+        Copy heights of `heightmapRect` to `heights`, row by row with `heightmapRect.dx` stride.
+        Rect should be within heightmap bounds.
+    */
+    void ReadRegion(const Rect2i& heightmapRect, uint16* heights);
+
+    Stats GetStats() const;
+
+private:
+    static const uint32 INVALID_INDEX = uint32(-1);
+
+    struct FileHeader
+    {
+        char8 signature[4];
+        uint32 version;
+        uint32 size;
+        uint32 tileSize;
+    };
+
+    // Resident tile, linked into LRU list by slot indices
+    struct TileSlot
+    {
+        Vector<uint16> heights;
+        uint32 tileIndex = INVALID_INDEX;
+        uint32 prev = INVALID_INDEX;
+        uint32 next = INVALID_INDEX;
+    };
+
+    const uint16* AcquireTile(uint32 tileX, uint32 tileY);
+    uint16 GetHeightClampLocked(int32 x, int32 y);
+    bool ReadTile(uint32 tileIndex, uint16* heights);
+    void EvictTiles(uint32 maxTilesCount);
+
+    void LinkSlotFront(uint32 slotIndex);
+    void UnlinkSlot(uint32 slotIndex);
+
+    uint32 GetMaxResidentTilesCount() const;
+
+    mutable Mutex mutex;
+
+    RefPtr<File> file;
+    std::shared_ptr<MappedFile> mapping;
+
+    uint32 size = 0;
+    uint32 tileSize = 0;
+    uint32 tilesPerSide = 0;
+    Vector<uint64> tileOffsets;
+
+    Vector<uint32> tileToSlot; // slot of every tile, `INVALID_INDEX` if tile isn't resident
+    Vector<TileSlot> slots;
+    Vector<uint32> freeSlots;
+    uint32 lruHead = INVALID_INDEX; // most recently used slot
+    uint32 lruTail = INVALID_INDEX; // least recently used slot
+
+    uint32 memoryBudget = DEFAULT_MEMORY_BUDGET;
+    Stats stats;
+};
+}
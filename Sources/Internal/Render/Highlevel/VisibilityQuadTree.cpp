@@ -201,6 +201,37 @@ void QuadTree::MarkObjectDirty(RenderObject* object)
     }
 }
 
+void QuadTree::AddNodeObject(uint16 nodeId, RenderObject* object)
+{
+    nodes[nodeId].objects.push_back(object);
+    nodes[nodeId].objectBoxes.Add(object->GetWorldBoundingBox());
+}
+
+void QuadTree::RemoveNodeObject(uint16 nodeId, RenderObject* object, bool keepOrder)
+{
+    QuadTreeNode& node = nodes[nodeId];
+    uint32 index = FindNodeObject(nodeId, object);
+    if (keepOrder)
+    {
+        node.objects.erase(node.objects.begin() + index);
+        node.objectBoxes.Remove(index);
+    }
+    else
+    {
+        node.objects[index] = node.objects.back();
+        node.objects.pop_back();
+        node.objectBoxes.RemoveBySwapWithLast(index);
+    }
+}
+
+uint32 QuadTree::FindNodeObject(uint16 nodeId, RenderObject* object) const
+{
+    const Vector<RenderObject*>& objects = nodes[nodeId].objects;
+    Vector<RenderObject*>::const_iterator it = std::find(objects.begin(), objects.end(), object);
+    DVASSERT(it != objects.end());
+    return static_cast<uint32>(it - objects.begin());
+}
+
 void QuadTree::RecalculateNodeZLimits(uint16 nodeId)
 {
     QuadTreeNode& currNode = nodes[nodeId];
@@ -245,13 +276,13 @@ void QuadTree::AddRenderObject(RenderObject* renderObject)
     if ((renderObject->GetFlags() & RenderObject::ALWAYS_CLIPPING_VISIBLE) || (!worldBox.IsInside(objBox)))
     {
         //object is somehow outside the world - just add to root
-        nodes[0].objects.push_back(renderObject);
+        AddNodeObject(0, renderObject);
         renderObject->SetTreeNodeIndex(0);
         renderObject->RemoveFlag(RenderObject::TREE_NODE_NEED_UPDATE);
         return;
     }
     uint16 nodeToAdd = FindObjectAddNode(0, renderObject->GetWorldBoundingBox());
-    nodes[nodeToAdd].objects.push_back(renderObject);
+    AddNodeObject(nodeToAdd, renderObject);
     renderObject->SetTreeNodeIndex(nodeToAdd);
     renderObject->RemoveFlag(RenderObject::TREE_NODE_NEED_UPDATE);
 }
@@ -274,9 +305,8 @@ void QuadTree::RemoveRenderObject(RenderObject* renderObject)
     uint16 currIndex = renderObject->GetTreeNodeIndex();
     DVASSERT(currIndex != INVALID_TREE_NODE_INDEX);
     renderObject->SetTreeNodeIndex(INVALID_TREE_NODE_INDEX);
-    Vector<RenderObject*>::iterator it = std::find(nodes[currIndex].objects.begin(), nodes[currIndex].objects.end(), renderObject);
-    DVASSERT(it != nodes[currIndex].objects.end());
-    nodes[currIndex].objects.erase(it);
+    // visible objects are collected in node order, so removed object shouldn't change order of the rest ones
+    RemoveNodeObject(currIndex, renderObject, true);
 
     if (renderObject->GetFlags() & RenderObject::TREE_NODE_NEED_UPDATE)
     {
@@ -374,20 +404,9 @@ void QuadTree::ObjectUpdated(RenderObject* renderObject)
 
     if (reverseIndex != baseIndex)
     {
-        //remove from base
-        int32 objectsSize = static_cast<int32>(nodes[baseIndex].objects.size());
-        int32 objIndex = 0;
-        for (; objIndex < objectsSize; ++objIndex)
-        {
-            if (nodes[baseIndex].objects[objIndex] == renderObject)
-                break;
-        }
-        DVASSERT(objIndex < objectsSize);
-        if (objectsSize > 1)
-            nodes[baseIndex].objects[objIndex] = nodes[baseIndex].objects[objectsSize - 1];
-        nodes[baseIndex].objects.resize(objectsSize - 1);
-        //and add to target
-        nodes[reverseIndex].objects.push_back(renderObject);
+        //remove from base and add to target
+        RemoveNodeObject(baseIndex, renderObject, false);
+        AddNodeObject(reverseIndex, renderObject);
         renderObject->SetTreeNodeIndex(reverseIndex);
 
         /*only now we can climb back and remove/mark nodes*/
@@ -417,6 +436,7 @@ void QuadTree::ObjectUpdated(RenderObject* renderObject)
     }
     else
     {
+        nodes[baseIndex].objectBoxes.Set(FindNodeObject(baseIndex, renderObject), objBox);
         MarkNodeDirty(baseIndex);
     }
     //as object change can wrap any of parent boxes
@@ -469,6 +489,27 @@ void QuadTree::ProcessNodeClipping(uint16 nodeId, uint8 clippingFlags, Vector<Re
             }
         }
     }
+    else if (objectsSize >= BATCH_CULLING_MIN_OBJECTS)
+    {
+        // objects are tested against all planes at once, which is still exact as they lie inside the node
+        FrustumCulling::Cull(*currFrustum, currNode.objectBoxes, visibilityMask);
+        for (int32 i = 0; i < objectsSize; ++i)
+        {
+            RenderObject* obj = currNode.objects[i];
+            uint32 flags = obj->GetFlags();
+            if ((flags & currVisibilityCriteria) == currVisibilityCriteria)
+            {
+                bool insideFrustum = (visibilityMask[i / 32] & (1u << (i % 32))) != 0;
+                if ((flags & RenderObject::ALWAYS_CLIPPING_VISIBLE) || insideFrustum)
+                {
+                    visibilityArray.push_back(obj);
+#if defined(__DAVAENGINE_RENDERSTATS__)
+                    ++Renderer::GetRenderStats().visibleRenderObjects;
+#endif
+                }
+            }
+        }
+    }
     else
     {
         for (int32 i = 0; i < objectsSize; ++i)
@@ -694,20 +735,9 @@ void QuadTree::Update()
             uint16 targetNode = FindObjectAddNode(startNode, object->GetWorldBoundingBox());
             if (startNode != targetNode)
             {
-                //remove from base
-                int32 objectsSize = static_cast<int32>(nodes[startNode].objects.size());
-                int32 objIndex = 0;
-                for (; objIndex < objectsSize; ++objIndex)
-                {
-                    if (nodes[startNode].objects[objIndex] == object)
-                        break;
-                }
-                DVASSERT(objIndex < objectsSize);
-                if (objectsSize > 1)
-                    nodes[startNode].objects[objIndex] = nodes[startNode].objects[objectsSize - 1];
-                nodes[startNode].objects.resize(objectsSize - 1);
-                //and add to target
-                nodes[targetNode].objects.push_back(object);
+                //remove from base and add to target
+                RemoveNodeObject(startNode, object, false);
+                AddNodeObject(targetNode, object);
                 object->SetTreeNodeIndex(targetNode);
             }
         }
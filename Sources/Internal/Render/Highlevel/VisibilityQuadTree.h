@@ -2,6 +2,7 @@
 
 #include "Base/BaseObject.h"
 #include "Math/AABBox3.h"
+#include "Render/Highlevel/FrustumCulling.h"
 #include "Render/Highlevel/RenderHierarchy.h"
 #include "Render/UniqueStateSet.h"
 
@@ -59,6 +60,7 @@ public:
         const static uint16 START_CLIP_PLANE_OFFSET = 4;
         uint16 nodeInfo; // format : ddddddddddzccñ where c - numChildNodes, z - dirtyZ, d - depth
         Vector<RenderObject*> objects;
+        BoundingBoxSoA objectBoxes; // world boxes of `objects` in the same order, for batch culling
         QuadTreeNode();
         void Reset();
     };
@@ -75,6 +77,10 @@ private:
     void RecalculateNodeZLimits(uint16 nodeId);
     void MarkNodeDirty(uint16 nodeId);
     void MarkObjectDirty(RenderObject* object);
+    void AddNodeObject(uint16 nodeId, RenderObject* object);
+    /** Removing object keeps order of the rest objects of node only if `keepOrder` is set, otherwise the last object takes its place. */
+    void RemoveNodeObject(uint16 nodeId, RenderObject* object, bool keepOrder);
+    uint32 FindNodeObject(uint16 nodeId, RenderObject* object) const;
     void DebugDrawNode(uint16 nodeId);
     void BroadPhaseCollisions(const Ray3& rayInWorldSpace, Vector<BroadPhaseCollision>& broadPhaseCollisions);
 
@@ -83,6 +89,7 @@ private:
 private:
     static const int32 RECALCULATE_Z_PER_FRAME = 10;
     static const int32 RECALCULATE_OBJECTS_PER_FRAME = 10;
+    static const int32 BATCH_CULLING_MIN_OBJECTS = 4; // smaller nodes are cheaper to test object by object
 
     Vector<BroadPhaseCollision> broadPhaseCollisions;
     Vector<QuadTreeNode> nodes;
@@ -91,6 +98,7 @@ private:
     List<RenderObject*> dirtyObjects;
     List<RenderObject*> worldInitObjects;
     std::queue<uint16> broadPhaseQueue;
+    Vector<uint32> visibilityMask;
 
 #if (DAVA_DEBUG_DRAW_OCTREE)
     UniqueHandle debugDrawStateHandle = InvalidUniqueHandle;
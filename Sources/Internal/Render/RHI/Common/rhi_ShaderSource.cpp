@@ -7,6 +7,7 @@
 #include "Logger/Logger.h"
 using DAVA::Logger;
 #include "FileSystem/DynamicMemoryFile.h"
+#include "FileSystem/FileList.h"
 #include "FileSystem/FileSystem.h"
 using DAVA::DynamicMemoryFile;
 #include "Utils/Utils.h"
@@ -29,117 +30,97 @@ namespace rhi
 {
 //==============================================================================
 
-class ShaderFileCallback : public DAVA::PreProc::FileCallback
+// include files shared by all shader sources, could be used from several threads at once
+class ShaderIncludeCache
 {
 public:
-    ShaderFileCallback(const char* base_dir)
-    {
-        inclDir.emplace_back(base_dir);
-    }
+    using FileData = std::shared_ptr<const std::vector<char>>;
 
-    ~ShaderFileCallback()
+    ShaderIncludeCache(const char* base_dir)
     {
-        ClearCache();
+        inclDir.emplace_back(base_dir);
     }
 
-    bool Open(const char* file_name) override
+    FileData Get(const char* file_name)
     {
-        bool success = false;
+        LockGuard<Mutex> guard(mutex);
 
-        for (size_t k = 0; k != _file.size(); ++k)
-        {
-            if (_file[k].name == file_name)
-            {
-                _cur_data = _file[k].data;
-                _cur_data_sz = _file[k].data_sz;
-                success = true;
-                break;
-            }
-        }
+        auto it = _file.find(file_name);
+        if (it != _file.end())
+            return it->second;
 
-        if (!success)
+        for (const std::string& d : inclDir)
         {
-            DAVA::File* in = nullptr;
-
-            for (const std::string& d : inclDir)
-            {
-                in = DAVA::File::Create(d + "/" + file_name, DAVA::File::READ | DAVA::File::OPEN);
-
-                if (in)
-                    break;
-            }
+            DAVA::File* in = DAVA::File::Create(d + "/" + file_name, DAVA::File::READ | DAVA::File::OPEN);
 
             if (in)
             {
-                file_t f;
-
-                f.name = file_name;
-                f.data_sz = unsigned(in->GetSize());
-                f.data = ::malloc(f.data_sz);
-
-                in->Read(f.data, f.data_sz);
+                std::shared_ptr<std::vector<char>> data = std::make_shared<std::vector<char>>(size_t(in->GetSize()));
+                if (!data->empty())
+                    in->Read(data->data(), unsigned(data->size()));
                 in->Release();
 
-                _file.push_back(f);
-                _cur_data = f.data;
-                _cur_data_sz = f.data_sz;
-
-                success = true;
+                _file.emplace(file_name, data);
+                return data;
             }
         }
 
-        return success;
+        return FileData();
     }
 
-    void Close() override
+    void AddIncludeDirectory(const char* dir)
     {
-        _cur_data = nullptr;
-        _cur_data_sz = 0;
+        LockGuard<Mutex> guard(mutex);
+        inclDir.emplace_back(dir);
     }
 
-    unsigned Size() const override
+    void ClearCache()
     {
-        return _cur_data_sz;
+        // data is shared with preprocessors which are running right now
+        LockGuard<Mutex> guard(mutex);
+        _file.clear();
     }
 
-    unsigned Read(unsigned max_sz, void* dst) override
+private:
+    Mutex mutex;
+    std::unordered_map<std::string, FileData> _file;
+    std::vector<std::string> inclDir;
+};
+
+static ShaderIncludeCache ShaderIncludes("~res:/Materials/Shaders");
+
+// created for every preprocessor run, keeps currently opened include
+class ShaderFileCallback : public DAVA::PreProc::FileCallback
+{
+public:
+    bool Open(const char* file_name) override
     {
-        DVASSERT(_cur_data);
-        DVASSERT(max_sz <= _cur_data_sz);
-        memcpy(dst, _cur_data, max_sz);
-        return max_sz;
+        _cur_file = ShaderIncludes.Get(file_name);
+        return (_cur_file != nullptr);
     }
 
-    void AddIncludeDirectory(const char* dir)
+    void Close() override
     {
-        inclDir.emplace_back(dir);
+        _cur_file.reset();
     }
 
-    void ClearCache()
+    unsigned Size() const override
     {
-        for (size_t k = 0; k != _file.size(); ++k)
-        {
-            ::free(_file[k].data);
-        }
-        _file.clear();
+        return (_cur_file) ? unsigned(_cur_file->size()) : 0;
     }
 
-private:
-    struct file_t
+    unsigned Read(unsigned max_sz, void* dst) override
     {
-        std::string name;
-        unsigned data_sz;
-        void* data;
-    };
-    std::vector<file_t> _file;
-    const void* _cur_data;
-    unsigned _cur_data_sz;
+        DVASSERT(_cur_file);
+        DVASSERT(max_sz <= _cur_file->size());
+        memcpy(dst, _cur_file->data(), max_sz);
+        return max_sz;
+    }
 
-    std::vector<std::string> inclDir;
+private:
+    ShaderIncludeCache::FileData _cur_file;
 };
 
-static ShaderFileCallback ShaderSourceFileCallback("~res:/Materials/Shaders");
-
 //==============================================================================
 
 ShaderSource::ShaderSource(const char* filename)
@@ -171,7 +152,8 @@ bool ShaderSource::Construct(ProgType progType, const char* srcText)
 bool ShaderSource::Construct(ProgType progType, const char* srcText, const std::vector<std::string>& defines)
 {
     bool success = false;
-    DAVA::PreProc pre_proc(&ShaderSourceFileCallback);
+    ShaderFileCallback fileCallback;
+    DAVA::PreProc pre_proc(&fileCallback);
     std::vector<char> src;
 
     DVASSERT(defines.size() % 2 == 0);
@@ -1520,13 +1502,14 @@ ReadUI4(DAVA::File* f, uint32* x)
 static inline bool
 ReadS0(DAVA::File* f, std::string* str)
 {
-    char s0[128 * 1024];
+    // strings are read on worker threads too, so keep buffer off the stack
     uint32 sz = 0;
     if (ReadUI4(f, &sz))
     {
-        if (f->Read(s0, sz) == sz)
+        str->resize(sz);
+        if (sz == 0 || f->Read(&(*str)[0], sz) == sz)
         {
-            *str = s0;
+            str->resize(strlen(str->c_str()));
             return true;
         }
     }
@@ -1653,15 +1636,15 @@ WriteUI4(DAVA::File* f, uint32 x)
 static inline bool
 WriteS0(DAVA::File* f, const char* str)
 {
-    char s0[128 * 1024];
-    uint32 sz = L_ALIGNED_SIZE(strlen(str) + 1, sizeof(uint32));
+    size_t len = strlen(str);
+    uint32 sz = uint32(L_ALIGNED_SIZE(len + 1, sizeof(uint32)));
+    std::vector<char> s0(sz, 0x00);
 
-    memset(s0, 0x00, sz);
-    strcpy(s0, str);
+    memcpy(s0.data(), str, len);
 
     if (WriteUI4(f, sz))
     {
-        return (f->Write(s0, sz) == sz);
+        return (f->Write(s0.data(), sz) == sz);
     }
     return false;
 }
@@ -1742,10 +1725,11 @@ const DAVA::String& ShaderSource::GetSourceCode(Api targetApi) const
 
     if (code[targetApi].empty() && (ast != nullptr))
     {
-        static sl::Allocator alloc;
-        static sl::HLSLGenerator hlsl_gen(&alloc);
-        static sl::GLESGenerator gles_gen(&alloc);
-        static sl::MSLGenerator mtl_gen(&alloc);
+        // generators keep state while generating, code could be generated on several threads at once
+        sl::Allocator alloc;
+        sl::HLSLGenerator hlsl_gen(&alloc);
+        sl::GLESGenerator gles_gen(&alloc);
+        sl::MSLGenerator mtl_gen(&alloc);
 
         bool codeGenerated = false;
         const char* main = (type == PROG_VERTEX) ? "vp_main" : "fp_main";
@@ -1898,12 +1882,12 @@ void ShaderSource::Reset()
 
 void ShaderSource::AddIncludeDirectory(const char* dir)
 {
-    ShaderSourceFileCallback.AddIncludeDirectory(dir);
+    ShaderIncludes.AddIncludeDirectory(dir);
 }
 
 void ShaderSource::PurgeIncludesCache()
 {
-    ShaderSourceFileCallback.ClearCache();
+    ShaderIncludes.ClearCache();
 }
 
 //------------------------------------------------------------------------------
@@ -2021,65 +2005,81 @@ void ShaderSource::Dump() const
 const uint32 ShaderSourceCache::FormatVersion = 8;
 
 Mutex shaderSourceEntryMutex;
-std::vector<ShaderSourceCache::entry_t> ShaderSourceCache::Entry;
+std::unordered_map<FastName, std::vector<ShaderSourceCache::entry_t>> ShaderSourceCache::Entry;
+static std::string shaderSourceStorageDirectory;
+static std::vector<ShaderSource*> retiredShaderSources; // replaced sources, pointers to them may be still in use
 
-const ShaderSource* ShaderSourceCache::Get(FastName uid, uint32 srcHash)
+ShaderSourceCache::entry_t* ShaderSourceCache::Find(FastName uid, uint32 api)
 {
-    LockGuard<Mutex> guard(shaderSourceEntryMutex);
-
-    //    Logger::Info("get-shader-src (host-api = %i)",HostApi());
-    //    Logger::Info("  uid= \"%s\"",uid.c_str());
-    const ShaderSource* src = nullptr;
-    Api api = HostApi();
-
-    for (std::vector<entry_t>::const_iterator e = Entry.begin(), e_end = Entry.end(); e != e_end; ++e)
+    auto it = Entry.find(uid);
+    if (it != Entry.end())
     {
-        if (e->uid == uid && e->api == api && e->srcHash == srcHash)
+        for (entry_t& e : it->second)
         {
-            src = e->src;
-            break;
+            if (e.api == api)
+                return &e;
         }
     }
-    //    Logger::Info("  %s",(src)?"found":"not found");
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+// should be called with shaderSourceEntryMutex locked
+
+const ShaderSource* ShaderSourceCache::Insert(FastName uid, uint32 api, uint32 srcHash, ShaderSource* src)
+{
+    entry_t* e = Find(uid, api);
+    if (e)
+    {
+        retiredShaderSources.push_back(e->src);
+        e->src = src;
+        e->srcHash = srcHash;
+    }
+    else
+    {
+        entry_t entry;
+        entry.uid = uid;
+        entry.api = api;
+        entry.srcHash = srcHash;
+        entry.src = src;
 
+        Entry[uid].push_back(entry);
+    }
     return src;
 }
 
 //------------------------------------------------------------------------------
+
+const ShaderSource* ShaderSourceCache::Get(FastName uid, uint32 srcHash)
+{
+    {
+        LockGuard<Mutex> guard(shaderSourceEntryMutex);
+
+        const entry_t* e = Find(uid, HostApi());
+        if (e && e->srcHash == srcHash)
+            return e->src;
+    }
+
+    return LoadFromStorage(uid, srcHash);
+}
+
+//------------------------------------------------------------------------------
+
 const ShaderSource* ShaderSourceCache::Add(const char* filename, FastName uid, ProgType progType, const char* srcText, const std::vector<std::string>& defines)
 {
     ShaderSource* src = new ShaderSource(filename);
 
     if (src->Construct(progType, srcText, defines))
     {
-        LockGuard<Mutex> guard(shaderSourceEntryMutex);
-
         uint32 api = HostApi();
         uint32 srcHash = DAVA::HashValue_N(srcText, unsigned(strlen(srcText)));
 
-        bool doAdd = true;
-        for (std::vector<entry_t>::iterator e = Entry.begin(), e_end = Entry.end(); e != e_end; ++e)
-        {
-            if ((e->uid == uid) && (e->api == api))
-            {
-                DAVA::SafeDelete(e->src);
-                e->src = src;
-                e->srcHash = srcHash;
-                doAdd = false;
-                break;
-            }
-        }
-
-        if (doAdd)
-        {
-            entry_t e;
-            e.uid = uid;
-            e.api = api;
-            e.srcHash = srcHash;
-            e.src = src;
+        // code is generated lazily, do it while source isn't visible to other threads
+        src->GetSourceCode(Api(api));
+        SaveToStorage(uid, srcHash, src);
 
-            Entry.push_back(e);
-        }
+        LockGuard<Mutex> guard(shaderSourceEntryMutex);
+        Insert(uid, api, srcHash, src);
     }
     else
     {
@@ -2092,118 +2092,164 @@ const ShaderSource* ShaderSourceCache::Add(const char* filename, FastName uid, P
 
 //------------------------------------------------------------------------------
 
-void ShaderSourceCache::Clear()
+void ShaderSourceCache::SetStorageDirectory(const char* dir)
 {
+    using namespace DAVA;
+
     LockGuard<Mutex> guard(shaderSourceEntryMutex);
 
-    for (std::vector<entry_t>::const_iterator e = Entry.begin(), e_end = Entry.end(); e != e_end; ++e)
-        delete e->src;
-    Entry.clear();
+    shaderSourceStorageDirectory = dir;
+    if (!shaderSourceStorageDirectory.empty())
+    {
+        FilePath rootPath(shaderSourceStorageDirectory);
+        rootPath.MakeDirectoryPathname();
+        FilePath path = rootPath + Format("v%u/", FormatVersion);
+
+        // sources of other format versions are never read again, so wipe them when format changes
+        FileSystem* fileSystem = FileSystem::Instance();
+        if (!fileSystem->IsDirectory(path))
+        {
+            ScopedPtr<FileList> fileList(new FileList(rootPath));
+            for (uint32 i = 0; i < fileList->GetCount(); ++i)
+            {
+                if (fileList->IsNavigationDirectory(i))
+                    continue;
+
+                if (fileList->IsDirectory(i))
+                    fileSystem->DeleteDirectory(fileList->GetPathname(i), true);
+                else
+                    fileSystem->DeleteFile(fileList->GetPathname(i));
+            }
+        }
+
+        fileSystem->CreateDirectory(path, true);
+        shaderSourceStorageDirectory = path.GetStringValue();
+    }
 }
 
 //------------------------------------------------------------------------------
 
-void ShaderSourceCache::Save(const char* fileName)
+// one file per uid and api: source saved after shader text change replaces the stale one
+
+static std::string
+StorageFileName(const std::string& dir, FastName uid, uint32 api)
 {
-    using namespace DAVA;
+    uint32 uidHash = DAVA::HashValue_N(uid.c_str(), unsigned(strlen(uid.c_str())));
+    return dir + DAVA::Format("%08X-%u.bin", uidHash, api);
+}
 
-    static const FilePath cacheTempFile("~doc:/shader_source_cache_temp.bin");
+//------------------------------------------------------------------------------
 
-    File* file = File::Create(cacheTempFile, File::WRITE | File::CREATE);
-    if (file)
-    {
-        Logger::Info("saving cached-shaders (%u): ", Entry.size());
+const ShaderSource* ShaderSourceCache::LoadFromStorage(FastName uid, uint32 srcHash)
+{
+    using namespace DAVA;
 
+    uint32 api = HostApi();
+    std::string fileName;
+    {
         LockGuard<Mutex> guard(shaderSourceEntryMutex);
-        bool success = true;
+        if (shaderSourceStorageDirectory.empty())
+            return nullptr;
+        fileName = StorageFileName(shaderSourceStorageDirectory, uid, api);
+    }
 
-        SCOPE_EXIT
-        {
-            SafeRelease(file);
+    ScopedPtr<File> file(File::Create(fileName, File::READ | File::OPEN));
+    if (!file)
+        return nullptr;
 
-            if (success)
-            {
-                FileSystem::Instance()->MoveFile(cacheTempFile, fileName, true);
-            }
-            else
-            {
-                FileSystem::Instance()->DeleteFile(cacheTempFile);
-            }
-        };
-        
-#define WRITE_CHECK(exp) if (!exp) { success = false; return; }
+    // file name is a hash, so check that file really contains requested source
+    uint32 formatVersion = 0;
+    uint32 fileApi = 0;
+    uint32 fileSrcHash = 0;
+    std::string fileUid;
 
-        WRITE_CHECK(WriteUI4(file, FormatVersion));
-        WRITE_CHECK(WriteUI4(file, static_cast<uint32>(Entry.size())));
-        for (std::vector<entry_t>::const_iterator e = Entry.begin(), e_end = Entry.end(); e != e_end; ++e)
-        {
-            WRITE_CHECK(WriteS0(file, e->uid.c_str()));
-            WRITE_CHECK(WriteUI4(file, e->api));
-            WRITE_CHECK(WriteUI4(file, e->srcHash));
-            WRITE_CHECK(e->src->Save(Api(e->api), file));
-        }
-        
-#undef WRITE_CHECK
+    bool success = ReadUI4(file, &formatVersion) && formatVersion == FormatVersion
+    && ReadUI4(file, &fileApi) && fileApi == api
+    && ReadUI4(file, &fileSrcHash);
+
+    // source of the same uid built from older shader text, it's replaced when new source is added
+    if (success && fileSrcHash != srcHash)
+        return nullptr;
+
+    ShaderSource* src = new ShaderSource();
+    success = success && ReadS0(file, &fileUid) && fileUid == uid.c_str() && src->Load(Api(api), file);
+
+    if (!success)
+    {
+        Logger::Warning("ignoring invalid cached shader-source %s", fileName.c_str());
+        delete src;
+        return nullptr;
     }
+
+    LockGuard<Mutex> guard(shaderSourceEntryMutex);
+
+    // same source could be loaded by another thread meanwhile
+    const entry_t* e = Find(uid, api);
+    if (e && e->srcHash == srcHash)
+    {
+        delete src;
+        return e->src;
+    }
+
+    return Insert(uid, api, srcHash, src);
 }
 
 //------------------------------------------------------------------------------
 
-void ShaderSourceCache::Load(const char* fileName)
+void ShaderSourceCache::SaveToStorage(FastName uid, uint32 srcHash, const ShaderSource* src)
 {
     using namespace DAVA;
 
-    ScopedPtr<File> file(File::Create(fileName, File::READ | File::OPEN));
+    uint32 api = HostApi();
+    std::string fileName;
+    {
+        LockGuard<Mutex> guard(shaderSourceEntryMutex);
+        if (shaderSourceStorageDirectory.empty())
+            return;
+        fileName = StorageFileName(shaderSourceStorageDirectory, uid, api);
+    }
 
+    // write to temporary file first, so that readers never see partially written source
+    std::string tempFileName = fileName + ".tmp";
+    File* file = File::Create(tempFileName, File::WRITE | File::CREATE);
     if (file)
     {
-        Clear();
-
-        bool success = true;
-        SCOPE_EXIT
-        {
-            if (!success)
-            {
-                Clear();
-                Logger::Warning("ShaderSource-Cache failed to load, ignoring cached shaders\n");
-            }
-        };
-        
-#define READ_CHECK(exp) if (!exp) { success = false; return; }
-
-        uint32 formatVersion = 0;
-        READ_CHECK(ReadUI4(file, &formatVersion));
-
-        if (formatVersion == FormatVersion)
+        bool success = WriteUI4(file, FormatVersion)
+        && WriteUI4(file, api)
+        && WriteUI4(file, srcHash)
+        && WriteS0(file, uid.c_str())
+        && src->Save(Api(api), file);
+        SafeRelease(file);
+
+        if (success)
         {
-            LockGuard<Mutex> guard(shaderSourceEntryMutex);
-
-            uint32 entryCount = 0;
-            READ_CHECK(ReadUI4(file, &entryCount));
-            Entry.resize(entryCount);
-            Logger::Info("loading cached-shaders (%u): ", Entry.size());
-
-            for (std::vector<entry_t>::iterator e = Entry.begin(), e_end = Entry.end(); e != e_end; ++e)
-            {
-                std::string str;
-                READ_CHECK(ReadS0(file, &str));
-                e->uid = FastName(str.c_str());
-                READ_CHECK(ReadUI4(file, &e->api));
-                READ_CHECK(ReadUI4(file, &e->srcHash));
-                e->src = new ShaderSource();
-
-                READ_CHECK(e->src->Load(Api(e->api), file));
-            }
+            FileSystem::Instance()->MoveFile(tempFileName, fileName, true);
         }
         else
         {
-            Logger::Warning("ShaderSource-Cache version mismatch, ignoring cached shaders\n");
-            success = false;
+            Logger::Warning("failed to store shader-source %s", fileName.c_str());
+            FileSystem::Instance()->DeleteFile(tempFileName);
         }
-        
-#undef READ_CHECK
     }
 }
 
+//------------------------------------------------------------------------------
+
+void ShaderSourceCache::Clear()
+{
+    LockGuard<Mutex> guard(shaderSourceEntryMutex);
+
+    for (const auto& uidEntries : Entry)
+    {
+        for (const entry_t& e : uidEntries.second)
+            delete e.src;
+    }
+    Entry.clear();
+
+    for (ShaderSource* src : retiredShaderSources)
+        delete src;
+    retiredShaderSources.clear();
+}
+
 //==============================================================================
 } // namespace rhi
@@ -123,9 +123,18 @@ public:
     static const ShaderSource* Get(FastName uid, uint32 srcHash);
     static const ShaderSource* Add(const char* filename, FastName uid, ProgType progType, const char* srcText, const std::vector<std::string>& defines);
 
+    /** Delete all sources, including ones replaced by `Add`. No source returned before may be used after it. */
     static void Clear();
-    static void Save(const char* fileName);
-    static void Load(const char* fileName);
+
+    /**
+        Enable persistent storage of shader sources in given directory (empty string disables it).
+        Every source is stored in its own file addressed by uid (which includes defines) and api, in subdirectory
+        of current format version; other contents of the directory are deleted when format version changes.
+        `Add` writes the file right after source is constructed replacing source built from older text,
+        `Get` reads it when source isn't in memory.
+        Replaced sources stay alive until `Clear`, since other threads may still use them.
+    */
+    static void SetStorageDirectory(const char* dir);
 
 private:
     struct
@@ -137,7 +146,12 @@ private:
         ShaderSource* src = nullptr;
     };
 
-    static std::vector<entry_t> Entry;
+    static entry_t* Find(FastName uid, uint32 api);
+    static const ShaderSource* Insert(FastName uid, uint32 api, uint32 srcHash, ShaderSource* src);
+    static const ShaderSource* LoadFromStorage(FastName uid, uint32 srcHash);
+    static void SaveToStorage(FastName uid, uint32 srcHash, const ShaderSource* src);
+
+    static std::unordered_map<FastName, std::vector<entry_t>> Entry;
     static const uint32 FormatVersion;
 };
 
@@ -41,8 +41,10 @@ struct DynamicPropertyBinding
 class ShaderDescriptor;
 namespace ShaderDescriptorCache
 {
+struct ShaderVariant;
 ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<FastName, int32>& defines);
 void ReloadShaders();
+Vector<ShaderVariant> GetBuiltVariants();
 }
 
 class ShaderDescriptor
@@ -114,6 +116,7 @@ private:
 
     friend ShaderDescriptor* ShaderDescriptorCache::GetShaderDescriptor(const FastName& name, const UnorderedMap<FastName, int32>& defines);
     friend void ShaderDescriptorCache::ReloadShaders();
+    friend Vector<ShaderDescriptorCache::ShaderVariant> ShaderDescriptorCache::GetBuiltVariants();
 };
 
 inline bool ShaderDescriptor::IsValid()
@@ -1,7 +1,11 @@
 #include "Render/ShaderCache.h"
 #include "Render/RHI/rhi_ShaderCache.h"
 #include "FileSystem/FileSystem.h"
+#include "FileSystem/KeyedArchive.h"
 #include "Concurrency/LockGuard.h"
+#include "Concurrency/Spinlock.h"
+#include "Engine/Engine.h"
+#include "Job/JobManager.h"
 #include "Logger/Logger.h"
 #include "Utils/StringFormat.h"
 #include "Render/RHI/rhi_ShaderSource.h"
@@ -24,11 +28,50 @@ struct ShaderSourceCode
     uint32 fSrcHash = 0;
 };
 
+// vertex and fragment programs of variant, built without touching rhi pipeline states
+struct ShaderPrograms
+{
+    FastName vProgUid;
+    FastName fProgUid;
+    Vector<String> progDefines;
+    ShaderSourceCode sourceCode;
+    const rhi::ShaderSource* vSource = nullptr;
+    const rhi::ShaderSource* fSource = nullptr;
+    bool isCached = false;
+};
+
+struct DescriptorsShard
+{
+    Spinlock lock;
+    Map<Vector<size_t>, ShaderDescriptor*> descriptors;
+};
+
+struct ProgramsBuild
+{
+    Mutex mutex;
+    uint32 users = 0;
+};
+
 namespace
 {
-Map<Vector<size_t>, ShaderDescriptor*> shaderDescriptors;
+const uint32 DESCRIPTORS_SHARDS_COUNT = 16;
+
+// built descriptors, every shard is locked only to find or insert descriptor
+DescriptorsShard descriptorsShards[DESCRIPTORS_SHARDS_COUNT];
+
 Map<FastName, ShaderSourceCode> shaderSourceCodes;
-Mutex shaderCacheMutex;
+Mutex sourceCodesMutex;
+
+// programs being compiled right now by their vertex program uid, so that the same programs aren't compiled twice
+Map<FastName, ProgramsBuild*> programsBuilds;
+Mutex programsBuildsMutex;
+
+// rhi program binaries and pipeline states aren't thread-safe, so descriptors are created one at a time
+Mutex pipelineStateMutex;
+
+Vector<JobHandle> prefetchJobs;
+Mutex prefetchJobsMutex;
+
 bool loadingNotifyEnabled = false;
 bool initialized = false;
 }
@@ -42,6 +85,7 @@ void Initialize()
 void Uninitialize()
 {
     DVASSERT(initialized);
+    WaitPrefetch();
     Clear();
     initialized = false;
 }
@@ -49,7 +93,7 @@ void Uninitialize()
 void Clear()
 {
     DVASSERT(initialized);
-    LockGuard<Mutex> guard(shaderCacheMutex);
+    LockGuard<Mutex> guard(sourceCodesMutex);
     shaderSourceCodes.clear();
 }
 
@@ -57,11 +101,13 @@ void ClearDynamicBindigs()
 {
     DVASSERT(initialized);
 
-    LockGuard<Mutex> guard(shaderCacheMutex);
-
-    for (auto& it : shaderDescriptors)
+    for (DescriptorsShard& shard : descriptorsShards)
     {
-        it.second->ClearDynamicBindings();
+        LockGuard<Spinlock> guard(shard.lock);
+        for (auto& it : shard.descriptors)
+        {
+            it.second->ClearDynamicBindings();
+        }
     }
 }
 
@@ -164,8 +210,10 @@ void LoadFromSource(const String& source, ShaderSourceCode& sourceCode)
     sourceCode.fSrcHash = HashValue_N(sourceCode.fragmentProgText.data(), static_cast<uint32>(strlen(sourceCode.fragmentProgText.data())));
 }
 
-const ShaderSourceCode& GetSourceCode(const FastName& name)
+ShaderSourceCode GetSourceCode(const FastName& name)
 {
+    LockGuard<Mutex> guard(sourceCodesMutex);
+
     auto sourceIt = shaderSourceCodes.find(name);
     if (sourceIt != shaderSourceCodes.end()) //source found
         return sourceIt->second;
@@ -174,6 +222,44 @@ const ShaderSourceCode& GetSourceCode(const FastName& name)
     return shaderSourceCodes.at(name);
 }
 
+DescriptorsShard& GetDescriptorsShard(const Vector<size_t>& key)
+{
+    uint32 hash = HashValue_N(reinterpret_cast<const char*>(key.data()), static_cast<uint32>(key.size() * sizeof(size_t)));
+    return descriptorsShards[hash % DESCRIPTORS_SHARDS_COUNT];
+}
+
+ShaderDescriptor* FindDescriptor(DescriptorsShard& shard, const Vector<size_t>& key)
+{
+    LockGuard<Spinlock> guard(shard.lock);
+
+    auto descriptorIt = shard.descriptors.find(key);
+    return (descriptorIt != shard.descriptors.end()) ? descriptorIt->second : nullptr;
+}
+
+ProgramsBuild* BeginProgramsBuild(const FastName& vProgUid)
+{
+    LockGuard<Mutex> guard(programsBuildsMutex);
+
+    ProgramsBuild*& build = programsBuilds[vProgUid];
+    if (build == nullptr)
+    {
+        build = new ProgramsBuild();
+    }
+    ++build->users;
+    return build;
+}
+
+void EndProgramsBuild(const FastName& vProgUid, ProgramsBuild* build)
+{
+    LockGuard<Mutex> guard(programsBuildsMutex);
+
+    if (--build->users == 0)
+    {
+        programsBuilds.erase(vProgUid);
+        delete build;
+    }
+}
+
 void SetLoadingNotifyEnabled(bool enable)
 {
     loadingNotifyEnabled = enable;
@@ -189,20 +275,9 @@ void SetLoadingNotifyEnabled(bool enable)
 #define LOG_TRACE_USAGE(...)
 #endif
 
-ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<FastName, int32>& defines)
+void BuildPrograms(const FastName& name, const UnorderedMap<FastName, int32>& defines, bool notifyLoading, ShaderPrograms& programs)
 {
-    DVASSERT(initialized);
-
-    LockGuard<Mutex> guard(shaderCacheMutex);
-
-    Vector<size_t> key = BuildFlagsKey(name, defines);
-
-    auto descriptorIt = shaderDescriptors.find(key);
-    if (descriptorIt != shaderDescriptors.end())
-        return descriptorIt->second;
-
-    //not found - create new shader
-    Vector<String> progDefines;
+    Vector<String>& progDefines = programs.progDefines;
     progDefines.reserve(defines.size() * 2);
     String resName(name.c_str());
     resName += "  defines: ";
@@ -231,35 +306,71 @@ ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<F
     for (size_t i = 0; i != progDefines.size(); i += 2)
         resName += Format("%s = %s, ", progDefines[i + 0].c_str(), progDefines[i + 1].c_str());
 
-    if (loadingNotifyEnabled)
+    if (notifyLoading)
     {
         Logger::Error("Forbidden call to GetShaderDescriptor %s", resName.c_str());
     }
 
-    FastName vProgUid, fProgUid;
-    vProgUid = FastName(String("vSource: ") + resName);
-    fProgUid = FastName(String("fSource: ") + resName);
+    programs.vProgUid = FastName(String("vSource: ") + resName);
+    programs.fProgUid = FastName(String("fSource: ") + resName);
 
-    ShaderSourceCode sourceCode = GetSourceCode(name);
+    programs.sourceCode = GetSourceCode(name);
+    const ShaderSourceCode& sourceCode = programs.sourceCode;
     const uint32 vSrcHash = HashValue_N(sourceCode.vertexProgText.data(), static_cast<uint32>(strlen(sourceCode.vertexProgText.data())));
     const uint32 fSrcHash = HashValue_N(sourceCode.fragmentProgText.data(), static_cast<uint32>(strlen(sourceCode.fragmentProgText.data())));
 
-    const rhi::ShaderSource* vSource = rhi::ShaderSourceCache::Get(vProgUid, vSrcHash);
-    const rhi::ShaderSource* fSource = rhi::ShaderSourceCache::Get(fProgUid, fSrcHash);
+    // wait if the same programs are being compiled by another thread, they will be in cache after that
+    ProgramsBuild* build = BeginProgramsBuild(programs.vProgUid);
+    {
+        LockGuard<Mutex> guard(build->mutex);
 
-    bool isCachedShader = false;
+        programs.vSource = rhi::ShaderSourceCache::Get(programs.vProgUid, vSrcHash);
+        programs.fSource = rhi::ShaderSourceCache::Get(programs.fProgUid, fSrcHash);
 
-    if (!vSource || !fSource)
-    {
-        LOG_TRACE_USAGE("building \"%s\"", vProgUid.c_str());
-        vSource = rhi::ShaderSourceCache::Add(sourceCode.vertexProgSourcePath.GetFrameworkPath().c_str(), vProgUid, rhi::PROG_VERTEX, sourceCode.vertexProgText.data(), progDefines);
-        fSource = rhi::ShaderSourceCache::Add(sourceCode.fragmentProgSourcePath.GetFrameworkPath().c_str(), fProgUid, rhi::PROG_FRAGMENT, sourceCode.fragmentProgText.data(), progDefines);
-    }
-    else
-    {
-        LOG_TRACE_USAGE("using cached \"%s\"", vProgUid.c_str());
-        isCachedShader = true;
+        if (!programs.vSource || !programs.fSource)
+        {
+            LOG_TRACE_USAGE("building \"%s\"", programs.vProgUid.c_str());
+            programs.vSource = rhi::ShaderSourceCache::Add(sourceCode.vertexProgSourcePath.GetFrameworkPath().c_str(), programs.vProgUid, rhi::PROG_VERTEX, sourceCode.vertexProgText.data(), progDefines);
+            programs.fSource = rhi::ShaderSourceCache::Add(sourceCode.fragmentProgSourcePath.GetFrameworkPath().c_str(), programs.fProgUid, rhi::PROG_FRAGMENT, sourceCode.fragmentProgText.data(), progDefines);
+        }
+        else
+        {
+            LOG_TRACE_USAGE("using cached \"%s\"", programs.vProgUid.c_str());
+            programs.isCached = true;
+        }
     }
+    EndProgramsBuild(programs.vProgUid, build);
+}
+
+ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<FastName, int32>& defines)
+{
+    DVASSERT(initialized);
+
+    Vector<size_t> key = BuildFlagsKey(name, defines);
+    DescriptorsShard& shard = GetDescriptorsShard(key);
+
+    ShaderDescriptor* res = FindDescriptor(shard, key);
+    if (res != nullptr)
+        return res;
+
+    //not found - compile programs concurrently with other threads, then create new shader
+    ShaderPrograms programs;
+    BuildPrograms(name, defines, loadingNotifyEnabled, programs);
+
+    LockGuard<Mutex> guard(pipelineStateMutex);
+
+    // descriptor could be created by another thread while programs were compiled
+    res = FindDescriptor(shard, key);
+    if (res != nullptr)
+        return res;
+
+    FastName vProgUid = programs.vProgUid;
+    FastName fProgUid = programs.fProgUid;
+    const Vector<String>& progDefines = programs.progDefines;
+    const ShaderSourceCode& sourceCode = programs.sourceCode;
+    const rhi::ShaderSource* vSource = programs.vSource;
+    const rhi::ShaderSource* fSource = programs.fSource;
+    bool isCachedShader = programs.isCached;
 
     if (!vSource || !fSource)
     {
@@ -272,11 +383,13 @@ ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<F
         rhi::PipelineState::Descriptor psDesc;
         psDesc.vprogUid = vProgUid;
         psDesc.fprogUid = fProgUid;
-        ShaderDescriptor* res = new ShaderDescriptor(rhi::HPipelineState(rhi::InvalidHandle), vProgUid, fProgUid);
+        res = new ShaderDescriptor(rhi::HPipelineState(rhi::InvalidHandle), vProgUid, fProgUid);
         res->sourceName = name;
         res->defines = defines;
         res->valid = false;
-        shaderDescriptors[key] = res;
+
+        LockGuard<Spinlock> shardGuard(shard.lock);
+        shard.descriptors[key] = res;
         return res;
     }
 
@@ -322,7 +435,7 @@ ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<F
         piplineState = rhi::AcquireRenderPipelineState(psDesc);
     }
 
-    ShaderDescriptor* res = new ShaderDescriptor(piplineState, vProgUid, fProgUid);
+    res = new ShaderDescriptor(piplineState, vProgUid, fProgUid);
     res->sourceName = name;
     res->defines = defines;
     res->valid = piplineState.IsValid(); //later add another conditions
@@ -338,23 +451,156 @@ ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<F
         DAVA::Logger::Info("  fprog-uid = %s", fProgUid.c_str());
     }
 
-    shaderDescriptors[key] = res;
+    LockGuard<Spinlock> shardGuard(shard.lock);
+    shard.descriptors[key] = res;
     return res;
 }
 
+void Prefetch(const Vector<ShaderVariant>& variants)
+{
+    DVASSERT(initialized);
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (jobManager == nullptr)
+    {
+        for (const ShaderVariant& variant : variants)
+        {
+            ShaderPrograms programs;
+            BuildPrograms(variant.name, variant.defines, false, programs);
+        }
+        return;
+    }
+
+    std::shared_ptr<Vector<ShaderVariant>> variantsCopy = std::make_shared<Vector<ShaderVariant>>(variants);
+    JobHandle job = jobManager->CreateWorkerJob([jobManager, variantsCopy]() {
+        jobManager->ParallelFor(0, static_cast<uint32>(variantsCopy->size()), 1, [&variantsCopy](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                const ShaderVariant& variant = (*variantsCopy)[i];
+                ShaderPrograms programs;
+                BuildPrograms(variant.name, variant.defines, false, programs);
+            }
+        });
+    });
+
+    LockGuard<Mutex> guard(prefetchJobsMutex);
+    prefetchJobs.push_back(job);
+}
+
+void WaitPrefetch()
+{
+    Vector<JobHandle> jobs;
+    {
+        LockGuard<Mutex> guard(prefetchJobsMutex);
+        jobs.swap(prefetchJobs);
+    }
+
+    for (const JobHandle& job : jobs)
+    {
+        GetEngineContext()->jobManager->WaitWorkerJob(job);
+    }
+}
+
+Vector<ShaderVariant> GetBuiltVariants()
+{
+    DVASSERT(initialized);
+
+    Vector<ShaderVariant> variants;
+    for (DescriptorsShard& shard : descriptorsShards)
+    {
+        LockGuard<Spinlock> guard(shard.lock);
+        for (const auto& it : shard.descriptors)
+        {
+            ShaderVariant variant;
+            variant.name = it.second->sourceName;
+            variant.defines = it.second->defines;
+            variants.push_back(std::move(variant));
+        }
+    }
+    return variants;
+}
+
+bool SaveVariants(const FilePath& path, const Vector<ShaderVariant>& variants)
+{
+    ScopedPtr<KeyedArchive> archive(new KeyedArchive());
+    archive->SetUInt32("count", static_cast<uint32>(variants.size()));
+    for (size_t i = 0; i < variants.size(); ++i)
+    {
+        ScopedPtr<KeyedArchive> definesArchive(new KeyedArchive());
+        for (const auto& define : variants[i].defines)
+        {
+            definesArchive->SetInt32(define.first.c_str(), define.second);
+        }
+
+        ScopedPtr<KeyedArchive> variantArchive(new KeyedArchive());
+        variantArchive->SetFastName("name", variants[i].name);
+        variantArchive->SetArchive("defines", definesArchive);
+        archive->SetArchive(Format("variant_%u", static_cast<uint32>(i)), variantArchive);
+    }
+    return archive->SaveToYamlFile(path);
+}
+
+Vector<ShaderVariant> LoadVariants(const FilePath& path)
+{
+    Vector<ShaderVariant> variants;
+
+    ScopedPtr<KeyedArchive> archive(new KeyedArchive());
+    if (!archive->LoadFromYamlFile(path))
+    {
+        return variants;
+    }
+
+    uint32 count = archive->GetUInt32("count");
+    variants.reserve(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        KeyedArchive* variantArchive = archive->GetArchive(Format("variant_%u", i));
+        if (variantArchive == nullptr)
+        {
+            continue;
+        }
+
+        ShaderVariant variant;
+        variant.name = variantArchive->GetFastName("name");
+        KeyedArchive* definesArchive = variantArchive->GetArchive("defines");
+        if (definesArchive != nullptr)
+        {
+            for (const auto& define : definesArchive->GetArchieveData())
+            {
+                variant.defines[FastName(define.first)] = define.second->AsInt32();
+            }
+        }
+        variants.push_back(std::move(variant));
+    }
+    return variants;
+}
+
 void ReloadShaders()
 {
     DVASSERT(initialized);
 
-    LockGuard<Mutex> guard(shaderCacheMutex);
-    shaderSourceCodes.clear();
+    WaitPrefetch();
+
+    LockGuard<Mutex> guard(pipelineStateMutex);
+    {
+        LockGuard<Mutex> sourcesGuard(sourceCodesMutex);
+        shaderSourceCodes.clear();
+    }
     rhi::ShaderSource::PurgeIncludesCache();
 
-    //reload shaders
-    for (auto& shaderDescr : shaderDescriptors)
+    Vector<ShaderDescriptor*> shaders;
+    for (DescriptorsShard& shard : descriptorsShards)
     {
-        ShaderDescriptor* shader = shaderDescr.second;
+        LockGuard<Spinlock> shardGuard(shard.lock);
+        for (const auto& it : shard.descriptors)
+        {
+            shaders.push_back(it.second);
+        }
+    }
 
+    //reload shaders
+    for (ShaderDescriptor* shader : shaders)
+    {
         /*Sources*/
         ShaderSourceCode sourceCode = GetSourceCode(shader->sourceName);
         rhi::ShaderSource vSource(sourceCode.vertexProgSourcePath.GetFrameworkPath().c_str());
@@ -6,8 +6,17 @@
 
 namespace DAVA
 {
+class FilePath;
+
 namespace ShaderDescriptorCache
 {
+/** Shader with set of defines, e.g. one of material variants. */
+struct ShaderVariant
+{
+    FastName name;
+    UnorderedMap<FastName, int32> defines;
+};
+
 void Initialize();
 void Uninitialize();
 void Clear();
@@ -16,7 +25,31 @@ void ClearDynamicBindigs();
 void ReloadShaders();
 
 void SetLoadingNotifyEnabled(bool enable);
+
+/**
+    Return descriptor for given shader and defines, build it if necessary.
+    Lookup of already built descriptor takes only short lock of one cache shard, so it never waits for
+    other descriptors being built. Shader programs of different variants are compiled concurrently,
+    only creation of pipeline state is serialized.
+*/
 ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<FastName, int32>& defines);
+
+/**
+    Compile shader programs of given variants on worker threads, return immediately.
+    Compiled programs are kept in rhi::ShaderSourceCache (and its storage, if enabled), so that later
+    `GetShaderDescriptor` for these variants only creates pipeline state.
+    Variant requested with `GetShaderDescriptor` while its programs are being compiled waits for them instead of compiling again.
+*/
+void Prefetch(const Vector<ShaderVariant>& variants);
+
+/** Wait until all variants passed to `Prefetch` are compiled. */
+void WaitPrefetch();
+
+/** Variants of all descriptors built so far, e.g. to be saved with `SaveVariants` and prefetched on next start. */
+Vector<ShaderVariant> GetBuiltVariants();
+
+bool SaveVariants(const FilePath& path, const Vector<ShaderVariant>& variants);
+Vector<ShaderVariant> LoadVariants(const FilePath& path);
 Vector<size_t> BuildFlagsKey(const FastName& name, const UnorderedMap<FastName, int32>& defines);
 size_t GetUniqueFlagKey(FastName flagName);
 };
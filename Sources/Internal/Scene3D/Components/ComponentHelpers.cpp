@@ -29,6 +29,8 @@
 #include "Scene3D/Components/Waypoint/EdgeComponent.h"
 #include "Scene3D/Components/Controller/SnapToLandscapeControllerComponent.h"
 #include "Scene3D/Components/GeoDecalComponent.h"
+#include "Reflection/ReflectedMeta.h"
+#include "Reflection/ReflectedTypeDB.h"
 
 namespace DAVA
 {
@@ -42,6 +44,31 @@ bool HasComponent(const Entity* fromEntity, const Type* componentType)
     return false;
 }
 
+bool IsSerializableComponent(Component* component)
+{
+    const ReflectedType* refType = ReflectedTypeDB::GetByType(component->GetType());
+
+    DVASSERT(refType != nullptr);
+
+    ReflectedMeta* meta = refType->GetStructure()->meta.get();
+    if (meta != nullptr && meta->GetMeta<M::NonSerializableComponent>() != nullptr)
+    {
+        return false;
+    }
+
+    //don't save empty custom properties
+    if (component->GetType()->Is<CustomPropertiesComponent>())
+    {
+        CustomPropertiesComponent* customProps = CastIfEqual<CustomPropertiesComponent*>(component);
+        if (customProps && customProps->GetArchive()->Count() <= 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 RenderComponent* GetRenderComponent(const Entity* fromEntity)
 {
     if (fromEntity)
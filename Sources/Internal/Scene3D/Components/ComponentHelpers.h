@@ -40,6 +40,7 @@ class StaticOcclusionDebugDrawComponent;
 class GeoDecalComponent;
 
 bool HasComponent(const Entity* fromEntity, const Type* componentType);
+bool IsSerializableComponent(Component* component);
 
 ParticleEffectComponent* GetEffectComponent(const Entity* fromEntity);
 AnimationComponent* GetAnimationComponent(const Entity* fromEntity);
@@ -13,6 +13,8 @@
 #include "Reflection/ReflectedMeta.h"
 #include <Math/Transform.h>
 
+#include <atomic>
+
 namespace DAVA
 {
 DAVA_VIRTUAL_REFLECTION_IMPL(ParticleEffectComponent)
@@ -34,6 +36,9 @@ DAVA_VIRTUAL_REFLECTION_IMPL(ParticleEffectComponent)
 
 ParticleEffectComponent::ParticleEffectComponent()
 {
+    static std::atomic<uint32> createdComponentsCount = { 0 };
+    randomSeed = ParticlesRandom::Hash(createdComponentsCount++);
+
     effectData.infoSources.resize(1);
     effectData.infoSources[0].size = Vector2(1, 1);
 
@@ -129,7 +134,9 @@ bool ParticleEffectComponent::IsPaused()
 
 void ParticleEffectComponent::Step(float32 delta)
 {
-    GetEntity()->GetScene()->particleEffectSystem->UpdateEffect(this, delta, delta);
+    ParticleEffectSystem* system = GetEntity()->GetScene()->particleEffectSystem;
+    system->UpdateEffect(this, delta, delta, system->updateBuffers);
+    system->RunPendingEmitters(this);
 }
 
 void ParticleEffectComponent::Restart(bool isDeleteAllParticles)
@@ -153,13 +160,7 @@ void ParticleEffectComponent::StopWhenEmpty(bool value /*= true*/)
 
 void ParticleEffectComponent::ClearGroup(ParticleGroup& group)
 {
-    Particle* current = group.head;
-    while (current)
-    {
-        Particle* next = current->next;
-        delete current;
-        current = next;
-    }
+    group.particles.Clear();
     group.layer->Release();
     group.emitter->Release();
 }
@@ -171,6 +172,7 @@ void ParticleEffectComponent::ClearCurrentGroups()
         ClearGroup(*it);
     }
     effectData.groups.clear();
+    effectData.pendingEmitters.clear();
 }
 
 void ParticleEffectComponent::SetRenderObjectVisible(bool visible)
@@ -581,11 +583,10 @@ float32 ParticleEffectComponent::GetLayerActiveParticlesSquare(ParticleLayer* la
     {
         if (it->layer == layer)
         {
-            Particle* currParticle = it->head;
-            while (currParticle)
+            const ParticlePool& particles = it->particles;
+            for (uint32 i = 0, count = particles.GetSize(); i < count; ++i)
             {
-                square += currParticle->currSize.x * currParticle->currSize.y;
-                currParticle = currParticle->next;
+                square += particles.particles[i].currSize.x * particles.particles[i].currSize.y;
             }
         }
     }
@@ -91,6 +91,11 @@ public:
     float32 GetStartFromTime() const;
     void SetStartFromTime(float32 time);
 
+    /** Random values used by effect simulation are generated from this seed every time effect is started,
+        so two effects with the same seed and emitters play identically. Unique for every component by default. */
+    uint32 GetRandomSeed() const;
+    void SetRandomSeed(uint32 seed);
+
     inline eState GetAnimationState() const;
     inline ParticleRenderObject* GetRenderObject() const;
 
@@ -123,6 +128,7 @@ private:
     int32 desiredLodLevel = 1;
     int32 activeLodLevel = 1;
     float32 startFromTime = 0.0f;
+    uint32 randomSeed = 0;
 
     bool stopWhenEmpty = false; //if true effect is considered finished when no particles left, otherwise effect is considered finished if time>effectDuration
     bool clearOnRestart = true; // when effect is restarted repeatsCount
@@ -172,6 +178,16 @@ inline void ParticleEffectComponent::SetStartFromTime(float32 time)
     startFromTime = Clamp(time, 0.0f, effectDuration);
 }
 
+inline uint32 ParticleEffectComponent::GetRandomSeed() const
+{
+    return randomSeed;
+}
+
+inline void ParticleEffectComponent::SetRandomSeed(uint32 seed)
+{
+    randomSeed = seed;
+}
+
 ParticleEffectComponent::eState ParticleEffectComponent::GetAnimationState() const
 {
     return state;
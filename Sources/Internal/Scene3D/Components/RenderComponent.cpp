@@ -2,6 +2,7 @@
 #include "Reflection/ReflectionRegistrator.h"
 #include "Reflection/ReflectedMeta.h"
 #include "Base/ObjectFactory.h"
+#include "Scene3D/SceneFile/FlatHierarchy.h"
 
 namespace DAVA
 {
@@ -110,4 +111,41 @@ void RenderComponent::Deserialize(KeyedArchive* archive, SerializationContext* s
 
     Component::Deserialize(archive, serializationContext);
 }
+
+bool RenderComponent::SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext)
+{
+    // empty class name means there is no render object
+    if (nullptr == renderObject)
+    {
+        writer.Write(String());
+        return true;
+    }
+
+    writer.Write(renderObject->GetClassName());
+    return renderObject->SaveFlat(writer, serializationContext);
+}
+
+bool RenderComponent::LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext)
+{
+    String className;
+    if (!reader.Read(className))
+    {
+        return false;
+    }
+    if (className.empty())
+    {
+        return true;
+    }
+
+    RenderObject* ro = ObjectFactory::Instance()->New<RenderObject>(className);
+    if (nullptr == ro)
+    {
+        return false;
+    }
+
+    bool loaded = ro->LoadFlat(reader, serializationContext);
+    SetRenderObject(ro);
+    ro->Release();
+    return loaded;
+}
 };
@@ -22,6 +22,8 @@ public:
     Component* Clone(Entity* toEntity) override;
     void Serialize(KeyedArchive* archive, SerializationContext* serializationContext) override;
     void Deserialize(KeyedArchive* archive, SerializationContext* serializationContext) override;
+    bool SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext) override;
+    bool LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext) override;
     void GetDataNodes(Set<DataNode*>& dataNodes) override;
     void OptimizeBeforeExport() override;
 
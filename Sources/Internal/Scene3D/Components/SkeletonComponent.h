@@ -10,6 +10,7 @@
 #include "Scene3D/Entity.h"
 #include "Scene3D/SceneFile/SerializationContext.h"
 #include "Scene3D/SkeletonAnimation/JointTransform.h"
+#include "Scene3D/SkeletonAnimation/JointTransformStreams.h"
 #include "Scene3D/SkeletonAnimation/SkeletonPose.h"
 
 namespace DAVA
@@ -82,9 +83,10 @@ private:
     //transforms info
     Vector<JointTransform> localSpaceTransforms;
     Vector<JointTransform> objectSpaceTransforms;
-    Vector<JointTransform> finalTransforms;
-    //bind pose
-    Vector<JointTransform> inverseBindTransforms;
+    //copies of object space and bind pose transforms as streams for joint kernels
+    JointTransformStreams objectSpaceStreams;
+    JointTransformStreams inverseBindStreams;
+    JointTransformStreams finalTransforms;
     //bounding boxes
     Vector<AABBox3> objectSpaceBoxes;
 
@@ -9,7 +9,7 @@ namespace DAVA
 {
 DAVA_VIRTUAL_REFLECTION_IMPL(SwitchComponent)
 {
-    ReflectionRegistrator<SwitchComponent>::Begin()[M::CantBeCreatedManualyComponent()]
+    ReflectionRegistrator<SwitchComponent>::Begin()[M::CantBeCreatedManualyComponent(), M::FlatSerializableComponent()]
     .ConstructorByPointer()
     .Field("newSwitchIndex", &SwitchComponent::GetSwitchIndex, &SwitchComponent::SetSwitchIndex)[M::DisplayName("Switch index")]
     .End();
@@ -6,6 +6,7 @@
 #include "Scene3D/Components/SingleComponents/TransformSingleComponent.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Scene.h"
+#include "Scene3D/SceneFile/FlatHierarchy.h"
 
 namespace DAVA
 {
@@ -136,6 +137,43 @@ void TransformComponent::Deserialize(KeyedArchive* archive, SerializationContext
     Component::Deserialize(archive, sceneFile);
 }
 
+bool TransformComponent::SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext)
+{
+    writer.Write(localTransform.GetTranslation());
+    writer.Write(localTransform.GetScale());
+    writer.Write(localTransform.GetRotation());
+    writer.Write(worldTransform.GetTranslation());
+    writer.Write(worldTransform.GetScale());
+    writer.Write(worldTransform.GetRotation());
+    return true;
+}
+
+bool TransformComponent::LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext)
+{
+    Vector3 translation;
+    Vector3 scale;
+    Quaternion rotation;
+
+    if (!reader.Read(translation) || !reader.Read(scale) || !reader.Read(rotation))
+    {
+        return false;
+    }
+    localTransform.SetTranslation(translation);
+    localTransform.SetScale(scale);
+    localTransform.SetRotation(rotation);
+
+    if (!reader.Read(translation) || !reader.Read(scale) || !reader.Read(rotation))
+    {
+        return false;
+    }
+    worldTransform.SetTranslation(translation);
+    worldTransform.SetScale(scale);
+    worldTransform.SetRotation(rotation);
+
+    worldMatrix = TransformUtils::ToMatrix(worldTransform);
+    return true;
+}
+
 void TransformComponent::MarkLocalChanged()
 {
     if (entity && entity->GetScene() && entity->GetScene()->transformSingleComponent)
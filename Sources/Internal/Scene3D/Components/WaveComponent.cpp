@@ -13,7 +13,7 @@ namespace DAVA
 {
 DAVA_VIRTUAL_REFLECTION_IMPL(WaveComponent)
 {
-    ReflectionRegistrator<WaveComponent>::Begin()
+    ReflectionRegistrator<WaveComponent>::Begin()[M::FlatSerializableComponent()]
     .ConstructorByPointer()
     .Field("amplitude", &WaveComponent::GetWaveAmplitude, &WaveComponent::SetWaveAmplitude)[M::DisplayName("Amplitude")]
     .Field("lenght", &WaveComponent::GetWaveLenght, &WaveComponent::SetWaveLenght)[M::DisplayName("Lenght")]
@@ -12,7 +12,7 @@ namespace DAVA
 {
 DAVA_VIRTUAL_REFLECTION_IMPL(WindComponent)
 {
-    ReflectionRegistrator<WindComponent>::Begin()[M::CantBeCreatedManualyComponent()]
+    ReflectionRegistrator<WindComponent>::Begin()[M::CantBeCreatedManualyComponent(), M::FlatSerializableComponent()]
     .ConstructorByPointer()
     .Field("influenceBbox", &WindComponent::GetInfluenceBBox, &WindComponent::SetInfluenceBBox)[M::DisplayName("Influence Bounding Box")]
     .Field("windForce", &WindComponent::GetWindForce, &WindComponent::SetWindForce)[M::DisplayName("Wind force")]
@@ -480,26 +480,8 @@ void Entity::Save(KeyedArchive* archive, SerializationContext* serializationCont
     uint32 savedIndex = 0;
     for (Component* c : components)
     {
-        const ReflectedType* refType = ReflectedTypeDB::GetByType(c->GetType());
-
-        DVASSERT(refType != nullptr);
-
-        ReflectedMeta* meta = refType->GetStructure()->meta.get();
-
-        bool isSerializable = meta == nullptr || meta->GetMeta<M::NonSerializableComponent>() == nullptr;
-
-        if (isSerializable)
+        if (IsSerializableComponent(c))
         {
-            //don't save empty custom properties
-            if (c->GetType()->Is<CustomPropertiesComponent>())
-            {
-                CustomPropertiesComponent* customProps = CastIfEqual<CustomPropertiesComponent*>(c);
-                if (customProps && customProps->GetArchive()->Count() <= 0)
-                {
-                    continue;
-                }
-            }
-
             KeyedArchive* compArch = new KeyedArchive();
             c->Serialize(compArch, serializationContext);
             compsArch->SetArchive(KeyedArchive::GenKeyFromIndex(savedIndex), compArch);
@@ -47,6 +47,8 @@ public:
     Component* Clone(Entity* toEntity) override;
     void Serialize(KeyedArchive* archive, SerializationContext* serializationContext) override;
     void Deserialize(KeyedArchive* archive, SerializationContext* serializationContext) override;
+    bool SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext) override;
+    bool LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext) override;
 
 private:
     int32 currentLod = INVALID_LOD_LAYER;
@@ -1,6 +1,7 @@
 #include "Scene3D/Lod/LodComponent.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Components/ComponentHelpers.h"
+#include "Scene3D/SceneFile/FlatHierarchy.h"
 #include "Render/Highlevel/RenderObject.h"
 #include "Utils/StringFormat.h"
 #include "Reflection/ReflectionRegistrator.h"
@@ -84,4 +85,23 @@ void LodComponent::Deserialize(KeyedArchive* archive, SerializationContext* seri
 
     Component::Deserialize(archive, serializationContext);
 }
+
+bool LodComponent::SaveFlat(FlatHierarchy::ValueWriter& writer, SerializationContext* serializationContext)
+{
+    for (float32 distance : distances)
+    {
+        writer.Write(distance);
+    }
+    return true;
+}
+
+bool LodComponent::LoadFlat(FlatHierarchy::ValueReader& reader, SerializationContext* serializationContext)
+{
+    bool read = true;
+    for (uint32 i = 0; i < MAX_LOD_LAYERS && read; ++i)
+    {
+        read = reader.Read(distances[i]);
+    }
+    return read;
+}
 }
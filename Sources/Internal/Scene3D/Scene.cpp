@@ -489,6 +489,11 @@ void Scene::RegisterEntity(Entity* entity)
         entity->SetSceneID(sceneId);
     }
 
+    if (archetypeStorage.HasRegisteredTypes())
+    {
+        archetypeStorage.UpdateEntity(entity);
+    }
+
     for (auto& system : systems)
     {
         system->RegisterEntity(entity);
@@ -517,6 +522,11 @@ void Scene::UnregisterEntity(Entity* entity)
     {
         system->UnregisterEntity(entity);
     }
+
+    if (archetypeStorage.HasRegisteredTypes())
+    {
+        archetypeStorage.RemoveEntity(entity);
+    }
 }
 
 void Scene::RegisterEntitiesInSystemRecursively(SceneSystem* system, Entity* entity)
@@ -526,9 +536,37 @@ void Scene::RegisterEntitiesInSystemRecursively(SceneSystem* system, Entity* ent
         RegisterEntitiesInSystemRecursively(system, entity->GetChild(i));
 }
 
+void Scene::RegisterArchetypeComponent(const Type* type)
+{
+    if (archetypeStorage.IsRegisteredComponentType(type))
+    {
+        return;
+    }
+
+    archetypeStorage.RegisterComponentType(type);
+
+    for (int32 i = 0, sz = GetChildrenCount(); i < sz; ++i)
+    {
+        UpdateArchetypeEntitiesRecursively(GetChild(i));
+    }
+}
+
+void Scene::UpdateArchetypeEntitiesRecursively(Entity* entity)
+{
+    archetypeStorage.UpdateEntity(entity);
+    for (int32 i = 0, sz = entity->GetChildrenCount(); i < sz; ++i)
+        UpdateArchetypeEntitiesRecursively(entity->GetChild(i));
+}
+
 void Scene::RegisterComponent(Entity* entity, Component* component)
 {
     DVASSERT(entity && component);
+
+    if (archetypeStorage.IsRegisteredComponentType(component->GetType()))
+    {
+        archetypeStorage.UpdateEntity(entity);
+    }
+
     uint32 systemsCount = static_cast<uint32>(systems.size());
     for (uint32 k = 0; k < systemsCount; ++k)
     {
@@ -544,6 +582,12 @@ void Scene::UnregisterComponent(Entity* entity, Component* component)
     {
         systems[k]->UnregisterComponent(entity, component);
     }
+
+    // component is still attached to entity at this point
+    if (archetypeStorage.IsRegisteredComponentType(component->GetType()))
+    {
+        archetypeStorage.UpdateEntity(entity, component);
+    }
 }
 
 void Scene::AddSystem(SceneSystem* sceneSystem, const ComponentMask& componentMask, uint32 processFlags /*= 0*/, SceneSystem* insertBeforeSceneForProcess /* = nullptr */, SceneSystem* insertBeforeSceneForInput /* = nullptr*/, SceneSystem* insertBeforeSceneForFixedProcess)
@@ -832,7 +876,7 @@ SceneFileV2::eError Scene::LoadScene(const DAVA::FilePath& pathname)
     return ret;
 }
 
-SceneFileV2::eError Scene::SaveScene(const DAVA::FilePath& pathname, bool saveForGame /*= false*/)
+SceneFileV2::eError Scene::SaveScene(const DAVA::FilePath& pathname, bool saveForGame /*= false*/, bool flatHierarchy /*= false*/)
 {
     std::function<void(Entity*)> resolveId = [&](Entity* entity)
     {
@@ -846,6 +890,7 @@ SceneFileV2::eError Scene::SaveScene(const DAVA::FilePath& pathname, bool saveFo
     ScopedPtr<SceneFileV2> file(new SceneFileV2());
     file->EnableDebugLog(false);
     file->EnableSaveForGame(saveForGame);
+    file->EnableFlatHierarchy(flatHierarchy);
     return file->SaveScene(pathname, this);
 }
 
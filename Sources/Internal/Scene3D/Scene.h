@@ -3,6 +3,7 @@
 #include "Base/BaseMath.h"
 #include "Base/BaseTypes.h"
 #include "Base/Observer.h"
+#include "Entity/ArchetypeStorage.h"
 #include "Entity/SceneSystem.h"
 #include "Entity/SingletonComponent.h"
 #include "Render/Highlevel/Camera.h"
@@ -274,6 +275,30 @@ public:
     void RemoveSingletonComponent(SingletonComponent* component);
     Vector<SingletonComponent*> singletonComponents;
 
+    /**
+     * @brief Starts keeping components of type T in chunked archetype storage, so they can be iterated with `ForEach`.
+     * @details Entities already added to the scene are put into the storage immediately,
+     * later they're kept in sync by entity and component registration.
+     */
+    template <class T>
+    void RegisterArchetypeComponent();
+    /** @brief Starts keeping components of specified type in chunked archetype storage. */
+    void RegisterArchetypeComponent(const Type* type);
+    /**
+     * @brief Calls `fn(entity, T*...)` for every entity in the scene which has all of `Ts` components or data.
+     * @note All `Ts` should be registered with `RegisterArchetypeComponent` or `archetypeStorage.RegisterDataType`,
+     * entities, components and data mustn't be added or removed from `fn`.
+     */
+    template <typename... Ts, typename Fn>
+    void ForEach(Fn&& fn);
+    /**
+     * @brief Same as `ForEach`, but chunks of entities are processed in parallel on worker threads.
+     * @note `fn` should touch only given entity and its components.
+     */
+    template <typename... Ts, typename Fn>
+    void ParallelForEach(Fn&& fn);
+    ArchetypeStorage archetypeStorage;
+
     /**
         \brief Overloaded GetScene returns this, instead of normal functionality.
      */
@@ -415,13 +440,15 @@ public:
      * 
      * @param pathname Path where the scene will be saved
      * @param saveForGame Optional flag indicating whether to save the scene in game-ready format (default: false)
+     * @param flatHierarchy Optional flag indicating whether to save entities as flat hierarchy block (default: false)
      * 
      * @return SceneFileV2::eError Error code indicating the result of the save operation
      * 
      * @details This method serializes the current scene state into a file at the specified location.
      * When saveForGame is true, the scene is optimized for game runtime usage.
+     * When flatHierarchy is true, the scene is saved with FLAT_HIERARCHY_SCENE_VERSION which loads faster.
      */
-    virtual SceneFileV2::eError SaveScene(const DAVA::FilePath& pathname, bool saveForGame = false);
+    virtual SceneFileV2::eError SaveScene(const DAVA::FilePath& pathname, bool saveForGame = false, bool flatHierarchy = false);
 
     /**
      * @brief Performs optimization of the scene before exporting
@@ -519,6 +546,8 @@ protected:
      * depth-first manner.
      */
     void RegisterEntitiesInSystemRecursively(SceneSystem* system, Entity* entity);
+    /** @brief Recursively puts the specified entity and all its children into archetype storage. */
+    void UpdateArchetypeEntitiesRecursively(Entity* entity);
 
     /**
     * @brief Removes a specified system from the given storage vector
@@ -568,6 +597,24 @@ T* Scene::GetSystem()
     return res;
 }
 
+template <class T>
+void Scene::RegisterArchetypeComponent()
+{
+    RegisterArchetypeComponent(Type::Instance<T>());
+}
+
+template <typename... Ts, typename Fn>
+void Scene::ForEach(Fn&& fn)
+{
+    archetypeStorage.ForEach<Ts...>(std::forward<Fn>(fn));
+}
+
+template <typename... Ts, typename Fn>
+void Scene::ParallelForEach(Fn&& fn)
+{
+    archetypeStorage.ParallelForEach<Ts...>(std::forward<Fn>(fn));
+}
+
 template <class T>
 T* Scene::GetSingletonComponent()
 {
@@ -0,0 +1,935 @@
+#include "Scene3D/SceneFile/FlatHierarchy.h"
+
+#include "Base/ObjectFactory.h"
+#include "Base/ScopedPtr.h"
+#include "Entity/Component.h"
+#include "FileSystem/DynamicMemoryFile.h"
+#include "FileSystem/File.h"
+#include "FileSystem/KeyedArchive.h"
+#include "Logger/Logger.h"
+#include "Math/AABBox3.h"
+#include "Math/Color.h"
+#include "Math/Matrix3.h"
+#include "Math/Matrix4.h"
+#include "Math/Quaternion.h"
+#include "Math/Vector.h"
+#include "Reflection/ReflectedMeta.h"
+#include "Reflection/ReflectedTypeDB.h"
+#include "Reflection/Reflection.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Components/UnregisteredComponent.h"
+#include "Scene3D/Entity.h"
+
+namespace DAVA
+{
+namespace FlatHierarchy
+{
+namespace FlatHierarchyDetails
+{
+static const String COMPONENT_TYPENAME_KEY = "comp.typename";
+static const uint32 INVALID_TYPE_INDEX = static_cast<uint32>(-1);
+
+template <typename T>
+bool ReadAny(ValueReader& reader, Any& value)
+{
+    T v;
+    if (!reader.Read(v))
+    {
+        return false;
+    }
+    value.Set(v);
+    return true;
+}
+
+bool GetValueType(const Any& value, eValueType& valueType)
+{
+    if (value.CanGet<bool>())
+        valueType = eValueType::BOOL;
+    else if (value.CanGet<int32>())
+        valueType = eValueType::INT32;
+    else if (value.CanGet<uint32>())
+        valueType = eValueType::UINT32;
+    else if (value.CanGet<int64>())
+        valueType = eValueType::INT64;
+    else if (value.CanGet<uint64>())
+        valueType = eValueType::UINT64;
+    else if (value.CanGet<float32>())
+        valueType = eValueType::FLOAT32;
+    else if (value.CanGet<float64>())
+        valueType = eValueType::FLOAT64;
+    else if (value.CanGet<Vector2>())
+        valueType = eValueType::VECTOR2;
+    else if (value.CanGet<Vector3>())
+        valueType = eValueType::VECTOR3;
+    else if (value.CanGet<Vector4>())
+        valueType = eValueType::VECTOR4;
+    else if (value.CanGet<Color>())
+        valueType = eValueType::COLOR;
+    else if (value.CanGet<Quaternion>())
+        valueType = eValueType::QUATERNION;
+    else if (value.CanGet<Matrix3>())
+        valueType = eValueType::MATRIX3;
+    else if (value.CanGet<Matrix4>())
+        valueType = eValueType::MATRIX4;
+    else if (value.CanGet<AABBox3>())
+        valueType = eValueType::AABBOX3;
+    else if (value.CanGet<String>())
+        valueType = eValueType::STRING;
+    else if (value.CanGet<FastName>())
+        valueType = eValueType::FASTNAME;
+    else
+        return false;
+
+    return true;
+}
+
+template <typename T>
+bool ReadTable(File* file, Vector<T>& table, uint32 count)
+{
+    table.resize(count);
+    uint32 size = static_cast<uint32>(sizeof(T) * count);
+    return size == 0 || file->Read(table.data(), size) == size;
+}
+
+template <typename T>
+bool WriteTable(File* file, const Vector<T>& table)
+{
+    uint32 size = static_cast<uint32>(sizeof(T) * table.size());
+    return size == 0 || file->Write(table.data(), size) == size;
+}
+}
+
+ValueWriter::ValueWriter(BlockWriter* blockWriter_, Vector<uint8>* blob_)
+    : blockWriter(blockWriter_)
+    , blob(blob_)
+{
+}
+
+// Math types aren't trivially copyable, they are stored as sequence of their float32 components
+void ValueWriter::WriteFloats(const float32* values, uint32 count)
+{
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Write(values[i]);
+    }
+}
+
+void ValueWriter::Write(const Vector2& value)
+{
+    WriteFloats(value.data, 2);
+}
+
+void ValueWriter::Write(const Vector3& value)
+{
+    WriteFloats(value.data, 3);
+}
+
+void ValueWriter::Write(const Vector4& value)
+{
+    WriteFloats(value.data, 4);
+}
+
+void ValueWriter::Write(const Quaternion& value)
+{
+    WriteFloats(value.data, 4);
+}
+
+void ValueWriter::Write(const Matrix3& value)
+{
+    WriteFloats(value.data, 9);
+}
+
+void ValueWriter::Write(const Matrix4& value)
+{
+    WriteFloats(value.data, 16);
+}
+
+void ValueWriter::Write(const AABBox3& value)
+{
+    Write(value.min);
+    Write(value.max);
+}
+
+void ValueWriter::Write(const String& value)
+{
+    Write(blockWriter->AddString(value));
+}
+
+void ValueWriter::Write(const FastName& value)
+{
+    Write(value.IsValid() ? blockWriter->AddString(value.c_str()) : INVALID_STRING_INDEX);
+}
+
+ValueReader::ValueReader(const BlockReader* blockReader_, const uint8* data, uint32 size)
+    : blockReader(blockReader_)
+    , ptr(data)
+    , end(data + size)
+{
+}
+
+bool ValueReader::ReadFloats(float32* values, uint32 count)
+{
+    bool read = true;
+    for (uint32 i = 0; i < count && read; ++i)
+    {
+        read = Read(values[i]);
+    }
+    return read;
+}
+
+bool ValueReader::Read(Vector2& value)
+{
+    return ReadFloats(value.data, 2);
+}
+
+bool ValueReader::Read(Vector3& value)
+{
+    return ReadFloats(value.data, 3);
+}
+
+bool ValueReader::Read(Vector4& value)
+{
+    return ReadFloats(value.data, 4);
+}
+
+bool ValueReader::Read(Quaternion& value)
+{
+    return ReadFloats(value.data, 4);
+}
+
+bool ValueReader::Read(Matrix3& value)
+{
+    return ReadFloats(value.data, 9);
+}
+
+bool ValueReader::Read(Matrix4& value)
+{
+    return ReadFloats(value.data, 16);
+}
+
+bool ValueReader::Read(AABBox3& value)
+{
+    return Read(value.min) && Read(value.max);
+}
+
+bool ValueReader::ReadStringIndex(uint32& index)
+{
+    return Read(index) && (index == INVALID_STRING_INDEX || index < blockReader->header.stringsCount);
+}
+
+bool ValueReader::Read(String& value)
+{
+    uint32 index = 0;
+    if (!ReadStringIndex(index))
+    {
+        return false;
+    }
+    value = (index == INVALID_STRING_INDEX) ? "" : blockReader->GetString(index);
+    return true;
+}
+
+bool ValueReader::Read(FastName& value)
+{
+    uint32 index = 0;
+    if (!ReadStringIndex(index))
+    {
+        return false;
+    }
+    value = (index == INVALID_STRING_INDEX) ? FastName() : FastName(blockReader->GetString(index));
+    return true;
+}
+
+BlockWriter::BlockWriter(SerializationContext* serializationContext_)
+    : serializationContext(serializationContext_)
+{
+}
+
+uint32 BlockWriter::AddString(const String& str)
+{
+    auto it = stringIndices.find(str);
+    if (it != stringIndices.end())
+    {
+        return it->second;
+    }
+
+    uint32 index = stringsCount++;
+    strings.insert(strings.end(), str.begin(), str.end());
+    strings.push_back('\0');
+    stringIndices.emplace(str, index);
+    return index;
+}
+
+uint32 BlockWriter::AddEntity(const FastName& name, uint32 id, uint32 flags, uint32 childrenCount)
+{
+    EntityRecord record;
+    record.nameIndex = AddString(name.IsValid() ? name.c_str() : "");
+    record.id = id;
+    record.flags = flags;
+    record.childrenCount = childrenCount;
+    record.firstComponent = static_cast<uint32>(components.size());
+
+    entities.push_back(record);
+    return static_cast<uint32>(entities.size() - 1);
+}
+
+void BlockWriter::EndEntity(uint32 entityIndex)
+{
+    entities[entityIndex].subtreeSize = static_cast<uint32>(entities.size()) - entityIndex;
+}
+
+uint32 BlockWriter::GetTypeIndex(const String& typeName, eComponentEncoding encoding)
+{
+    auto it = typeIndices.find(typeName);
+    if (it != typeIndices.end())
+    {
+        return it->second;
+    }
+
+    TypeData type;
+    type.record.nameIndex = AddString(typeName);
+    type.record.encoding = encoding;
+    type.record.firstField = static_cast<uint32>(fields.size());
+    types.push_back(std::move(type));
+
+    uint32 index = static_cast<uint32>(types.size() - 1);
+    typeIndices.emplace(typeName, index);
+    return index;
+}
+
+/**
+    Returns index of reflection-encoded type of component or INVALID_TYPE_INDEX if component should be stored
+    as archive. Field layout is taken from the first met component of the type.
+*/
+uint32 BlockWriter::GetReflectedTypeIndex(Component* component)
+{
+    using namespace FlatHierarchyDetails;
+
+    const ReflectedType* refType = ReflectedTypeDB::GetByType(component->GetType());
+    const ReflectedMeta* meta = refType->GetStructure()->meta.get();
+    if (meta == nullptr || meta->GetMeta<M::FlatSerializableComponent>() == nullptr)
+    {
+        return INVALID_TYPE_INDEX;
+    }
+
+    const String& typeName = ObjectFactory::Instance()->GetName(component);
+    auto it = typeIndices.find(typeName);
+    if (it != typeIndices.end())
+    {
+        return (types[it->second].record.encoding == eComponentEncoding::REFLECTION) ? it->second : INVALID_TYPE_INDEX;
+    }
+
+    Vector<FieldRecord> typeFields;
+    Reflection ref = Reflection::Create(ReflectedObject(component));
+    for (const Reflection::Field& field : ref.GetFields())
+    {
+        if (field.ref.IsReadonly() || field.ref.GetMeta<M::ReadOnly>() != nullptr)
+        {
+            continue;
+        }
+
+        FieldRecord record;
+        if (!GetValueType(field.ref.GetValue(), record.valueType))
+        {
+            Logger::Warning("[FlatHierarchy] field %s of %s has unsupported type, component is stored as archive", field.key.Cast<String>().c_str(), typeName.c_str());
+            return INVALID_TYPE_INDEX;
+        }
+        record.nameIndex = AddString(field.key.Cast<String>());
+        typeFields.push_back(record);
+    }
+
+    uint32 index = GetTypeIndex(typeName, eComponentEncoding::REFLECTION);
+    types[index].record.fieldsCount = static_cast<uint32>(typeFields.size());
+    fields.insert(fields.end(), typeFields.begin(), typeFields.end());
+    return index;
+}
+
+void BlockWriter::WriteReflectedComponent(Component* component, uint32 typeIndex)
+{
+    using namespace FlatHierarchyDetails;
+
+    // fields are enumerated in the same order as in GetReflectedTypeIndex
+    uint32 fieldIndex = types[typeIndex].record.firstField;
+    ValueWriter writer(this, &types[typeIndex].blob);
+
+    Reflection ref = Reflection::Create(ReflectedObject(component));
+    for (const Reflection::Field& field : ref.GetFields())
+    {
+        if (field.ref.IsReadonly() || field.ref.GetMeta<M::ReadOnly>() != nullptr)
+        {
+            continue;
+        }
+
+        Any value = field.ref.GetValue();
+        switch (fields[fieldIndex++].valueType)
+        {
+        case eValueType::BOOL:
+            writer.Write(value.Get<bool>());
+            break;
+        case eValueType::INT32:
+            writer.Write(value.Get<int32>());
+            break;
+        case eValueType::UINT32:
+            writer.Write(value.Get<uint32>());
+            break;
+        case eValueType::INT64:
+            writer.Write(value.Get<int64>());
+            break;
+        case eValueType::UINT64:
+            writer.Write(value.Get<uint64>());
+            break;
+        case eValueType::FLOAT32:
+            writer.Write(value.Get<float32>());
+            break;
+        case eValueType::FLOAT64:
+            writer.Write(value.Get<float64>());
+            break;
+        case eValueType::VECTOR2:
+            writer.Write(value.Get<Vector2>());
+            break;
+        case eValueType::VECTOR3:
+            writer.Write(value.Get<Vector3>());
+            break;
+        case eValueType::VECTOR4:
+            writer.Write(value.Get<Vector4>());
+            break;
+        case eValueType::COLOR:
+            writer.Write(value.Get<Color>());
+            break;
+        case eValueType::QUATERNION:
+            writer.Write(value.Get<Quaternion>());
+            break;
+        case eValueType::MATRIX3:
+            writer.Write(value.Get<Matrix3>());
+            break;
+        case eValueType::MATRIX4:
+            writer.Write(value.Get<Matrix4>());
+            break;
+        case eValueType::AABBOX3:
+            writer.Write(value.Get<AABBox3>());
+            break;
+        case eValueType::STRING:
+            writer.Write(value.Get<String>());
+            break;
+        case eValueType::FASTNAME:
+            writer.Write(value.Get<FastName>());
+            break;
+        default:
+            DVASSERT(false);
+            break;
+        }
+    }
+
+    DVASSERT(fieldIndex == types[typeIndex].record.firstField + types[typeIndex].record.fieldsCount);
+}
+
+void BlockWriter::AddComponent(Component* component)
+{
+    using namespace FlatHierarchyDetails;
+
+    ComponentRecord record;
+
+    uint32 typeIndex = GetReflectedTypeIndex(component);
+    if (typeIndex != INVALID_TYPE_INDEX)
+    {
+        record.offset = types[typeIndex].blob.size();
+        WriteReflectedComponent(component, typeIndex);
+    }
+    else
+    {
+        String typeName;
+        eCustomComponentData dataType = eCustomComponentData::VALUES;
+
+        componentValues.clear();
+        ValueWriter writer(this, &componentValues);
+        if (component->SaveFlat(writer, serializationContext))
+        {
+            typeName = ObjectFactory::Instance()->GetName(component);
+        }
+        else
+        {
+            ScopedPtr<KeyedArchive> archive(new KeyedArchive());
+            component->Serialize(archive, serializationContext);
+
+            // type name goes to type table
+            typeName = archive->GetString(COMPONENT_TYPENAME_KEY);
+            archive->DeleteKey(COMPONENT_TYPENAME_KEY);
+
+            ScopedPtr<DynamicMemoryFile> buffer(DynamicMemoryFile::Create(File::CREATE | File::WRITE));
+            archive->Save(buffer);
+
+            dataType = eCustomComponentData::ARCHIVE;
+            componentValues.assign(buffer->GetData(), buffer->GetData() + buffer->GetSize());
+        }
+
+        typeIndex = GetTypeIndex(typeName, eComponentEncoding::CUSTOM);
+        DVASSERT(types[typeIndex].record.encoding == eComponentEncoding::CUSTOM);
+
+        Vector<uint8>& blob = types[typeIndex].blob;
+        record.offset = blob.size();
+        blob.push_back(static_cast<uint8>(dataType));
+        blob.insert(blob.end(), componentValues.begin(), componentValues.end());
+    }
+
+    record.typeIndex = typeIndex;
+    record.size = static_cast<uint32>(types[typeIndex].blob.size() - record.offset);
+
+    components.push_back(record);
+    entities.back().componentsCount++;
+}
+
+bool BlockWriter::Save(File* file) const
+{
+    using namespace FlatHierarchyDetails;
+
+    BlockHeader header;
+    header.stringsCount = stringsCount;
+    header.stringsSize = static_cast<uint32>(strings.size());
+    header.typesCount = static_cast<uint32>(types.size());
+    header.fieldsCount = static_cast<uint32>(fields.size());
+    header.entitiesCount = static_cast<uint32>(entities.size());
+    header.componentsCount = static_cast<uint32>(components.size());
+
+    Vector<TypeRecord> typeRecords;
+    typeRecords.reserve(types.size());
+    for (const TypeData& type : types)
+    {
+        TypeRecord record = type.record;
+        record.blobOffset = header.blobsSize;
+        record.blobSize = type.blob.size();
+        header.blobsSize += record.blobSize;
+        typeRecords.push_back(record);
+    }
+
+    bool written = file->Write(&header, sizeof(BlockHeader)) == sizeof(BlockHeader);
+    written = written && WriteTable(file, strings);
+    written = written && WriteTable(file, typeRecords);
+    written = written && WriteTable(file, fields);
+    written = written && WriteTable(file, entities);
+    written = written && WriteTable(file, components);
+    for (const TypeData& type : types)
+    {
+        written = written && WriteTable(file, type.blob);
+    }
+
+    return written;
+}
+
+BlockReader::BlockReader(SerializationContext* serializationContext_)
+    : serializationContext(serializationContext_)
+{
+}
+
+bool BlockReader::ReadTables(File* file)
+{
+    using namespace FlatHierarchyDetails;
+
+    if (file->Read(&header, sizeof(BlockHeader)) != sizeof(BlockHeader) || header.marker != BLOCK_MARKER)
+    {
+        Logger::Error("[FlatHierarchy] block header is not valid in file %s", file->GetFilename().GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    bool read = ReadTable(file, strings, header.stringsSize);
+    read = read && ReadTable(file, types, header.typesCount);
+    read = read && ReadTable(file, fields, header.fieldsCount);
+    read = read && ReadTable(file, entities, header.entitiesCount);
+    read = read && ReadTable(file, components, header.componentsCount);
+    if (!read)
+    {
+        Logger::Error("[FlatHierarchy] failed to read tables from file %s", file->GetFilename().GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    stringOffsets.clear();
+    stringOffsets.reserve(header.stringsCount);
+    uint32 stringStart = 0;
+    for (uint32 i = 0; i < header.stringsSize; ++i)
+    {
+        if (strings[i] == '\0')
+        {
+            stringOffsets.push_back(stringStart);
+            stringStart = i + 1;
+        }
+    }
+
+    bool valid = stringOffsets.size() == header.stringsCount && stringStart == header.stringsSize;
+    // sums of untrusted values may overflow, so they are checked by subtraction
+    for (const TypeRecord& type : types)
+    {
+        valid = valid && type.nameIndex < header.stringsCount;
+        valid = valid && (type.encoding == eComponentEncoding::REFLECTION || type.encoding == eComponentEncoding::CUSTOM);
+        valid = valid && type.firstField <= header.fieldsCount && type.fieldsCount <= header.fieldsCount - type.firstField;
+        valid = valid && type.blobOffset <= header.blobsSize && type.blobSize <= header.blobsSize - type.blobOffset;
+    }
+    for (const FieldRecord& field : fields)
+    {
+        valid = valid && field.nameIndex < header.stringsCount;
+    }
+    for (uint32 i = 0; i < header.entitiesCount; ++i)
+    {
+        const EntityRecord& entity = entities[i];
+        valid = valid && entity.nameIndex < header.stringsCount && entity.subtreeSize > 0 && entity.subtreeSize <= header.entitiesCount - i;
+        valid = valid && entity.firstComponent <= header.componentsCount && entity.componentsCount <= header.componentsCount - entity.firstComponent;
+    }
+    for (const ComponentRecord& component : components)
+    {
+        valid = valid && component.typeIndex < header.typesCount;
+        valid = valid && component.offset <= types[component.typeIndex].blobSize && component.size <= types[component.typeIndex].blobSize - component.offset;
+    }
+    if (!valid)
+    {
+        Logger::Error("[FlatHierarchy] tables are corrupted in file %s", file->GetFilename().GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    fieldNames.clear();
+    fieldNames.reserve(fields.size());
+    for (const FieldRecord& field : fields)
+    {
+        fieldNames.emplace_back(GetString(field.nameIndex));
+    }
+
+    loadedBlobs.clear();
+    loadedBlobs.resize(types.size());
+    blobsPosition = file->GetPos();
+    return true;
+}
+
+bool BlockReader::ReadBlobs(File* file, uint32 firstEntity, uint32 entitiesCount)
+{
+    DVASSERT(firstEntity + entitiesCount <= entities.size());
+
+    uint32 componentsBegin = 0;
+    uint32 componentsEnd = 0;
+    if (entitiesCount > 0)
+    {
+        const EntityRecord& last = entities[firstEntity + entitiesCount - 1];
+        componentsBegin = entities[firstEntity].firstComponent;
+        componentsEnd = last.firstComponent + last.componentsCount;
+    }
+
+    // components of consecutive entities are consecutive in every type blob
+    uint32 typesCount = static_cast<uint32>(types.size());
+    Vector<uint64> rangeBegin(typesCount, std::numeric_limits<uint64>::max());
+    Vector<uint64> rangeEnd(typesCount, 0);
+    for (uint32 i = componentsBegin; i < componentsEnd; ++i)
+    {
+        const ComponentRecord& component = components[i];
+        rangeBegin[component.typeIndex] = Min(rangeBegin[component.typeIndex], component.offset);
+        rangeEnd[component.typeIndex] = Max(rangeEnd[component.typeIndex], component.offset + component.size);
+    }
+
+    for (uint32 t = 0; t < typesCount; ++t)
+    {
+        LoadedBlob& blob = loadedBlobs[t];
+        if (rangeBegin[t] >= rangeEnd[t])
+        {
+            blob.begin = 0;
+            blob.data.clear();
+            continue;
+        }
+
+        uint32 size = static_cast<uint32>(rangeEnd[t] - rangeBegin[t]);
+        blob.begin = rangeBegin[t];
+        blob.data.resize(size);
+        if (!file->Seek(blobsPosition + types[t].blobOffset + rangeBegin[t], File::SEEK_FROM_START) || file->Read(blob.data.data(), size) != size)
+        {
+            Logger::Error("[FlatHierarchy] failed to read component blob from file %s", file->GetFilename().GetAbsolutePathname().c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+FastName BlockReader::GetEntityName(uint32 index) const
+{
+    return FastName(GetString(entities[index].nameIndex));
+}
+
+const char* BlockReader::GetString(uint32 index) const
+{
+    return strings.data() + stringOffsets[index];
+}
+
+const uint8* BlockReader::GetComponentData(const ComponentRecord& component) const
+{
+    const LoadedBlob& blob = loadedBlobs[component.typeIndex];
+    if (component.offset < blob.begin || component.offset + component.size > blob.begin + blob.data.size())
+    {
+        return nullptr;
+    }
+    return blob.data.data() + (component.offset - blob.begin);
+}
+
+/**
+    Creates component described by record. Reflection-encoded components are read completely, for others
+    `state` receives data to be passed to RestoreComponent after component is added to entity.
+    Types unknown to ObjectFactory are created as UnregisteredComponent if they are stored as archive,
+    otherwise they are skipped and `component` is set to nullptr. Returns false if data is corrupted.
+*/
+bool BlockReader::CreateComponent(const ComponentRecord& record, Component*& component, ComponentState& state) const
+{
+    using namespace FlatHierarchyDetails;
+
+    component = nullptr;
+
+    const TypeRecord& type = types[record.typeIndex];
+    const char* typeName = GetString(type.nameIndex);
+
+    const uint8* data = GetComponentData(record);
+    if (data == nullptr)
+    {
+        Logger::Error("[FlatHierarchy] data of %s component is not loaded", typeName);
+        return false;
+    }
+
+    if (type.encoding == eComponentEncoding::REFLECTION)
+    {
+        component = ObjectFactory::Instance()->New<Component>(typeName);
+        if (component == nullptr)
+        {
+            Logger::Warning("[FlatHierarchy] component %s is not registered and will be skipped", typeName);
+        }
+        else if (!ReadReflectedComponent(component, type, data, record.size))
+        {
+            Logger::Error("[FlatHierarchy] failed to read %s component", typeName);
+            SafeDelete(component);
+            return false;
+        }
+        return true;
+    }
+
+    DVASSERT(type.encoding == eComponentEncoding::CUSTOM);
+    if (record.size == 0 || data[0] > static_cast<uint8>(eCustomComponentData::ARCHIVE))
+    {
+        Logger::Error("[FlatHierarchy] data of %s component is corrupted", typeName);
+        return false;
+    }
+
+    eCustomComponentData dataType = static_cast<eCustomComponentData>(data[0]);
+    data += 1;
+    uint32 archiveSize = record.size - 1;
+
+    if (dataType == eCustomComponentData::VALUES)
+    {
+        component = ObjectFactory::Instance()->New<Component>(typeName);
+        if (component == nullptr)
+        {
+            Logger::Warning("[FlatHierarchy] component %s is not registered and will be skipped", typeName);
+            return true;
+        }
+
+        state.values = data;
+        state.valuesSize = archiveSize;
+        return true;
+    }
+
+    ScopedPtr<KeyedArchive> componentArchive(new KeyedArchive());
+    if (!componentArchive->Load(data, archiveSize))
+    {
+        Logger::Error("[FlatHierarchy] failed to load archive of %s component", typeName);
+        return false;
+    }
+
+    componentArchive->SetString(COMPONENT_TYPENAME_KEY, typeName);
+    component = ObjectFactory::Instance()->New<Component>(typeName);
+    if (component == nullptr)
+    {
+        component = new UnregisteredComponent();
+    }
+
+    state.archive = SafeRetain(componentArchive.get());
+    return true;
+}
+
+/** Reads data left by CreateComponent into component which is already added to entity. */
+bool BlockReader::RestoreComponent(Component* component, ComponentState& state) const
+{
+    if (state.archive != nullptr)
+    {
+        component->Deserialize(state.archive, serializationContext);
+        SafeRelease(state.archive);
+        return true;
+    }
+
+    if (state.values != nullptr)
+    {
+        ValueReader reader(this, state.values, state.valuesSize);
+        if (!component->LoadFlat(reader, serializationContext) || !reader.IsEnd())
+        {
+            Logger::Error("[FlatHierarchy] failed to read values of %s component", ObjectFactory::Instance()->GetName(component).c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BlockReader::ReadReflectedComponent(Component* component, const TypeRecord& type, const uint8* data, uint32 size) const
+{
+    using namespace FlatHierarchyDetails;
+
+    ValueReader reader(this, data, size);
+
+    Reflection ref = Reflection::Create(ReflectedObject(component));
+    for (uint32 i = 0; i < type.fieldsCount; ++i)
+    {
+        const FieldRecord& field = fields[type.firstField + i];
+
+        Any value;
+        bool read = false;
+        switch (field.valueType)
+        {
+        case eValueType::BOOL:
+            read = ReadAny<bool>(reader, value);
+            break;
+        case eValueType::INT32:
+            read = ReadAny<int32>(reader, value);
+            break;
+        case eValueType::UINT32:
+            read = ReadAny<uint32>(reader, value);
+            break;
+        case eValueType::INT64:
+            read = ReadAny<int64>(reader, value);
+            break;
+        case eValueType::UINT64:
+            read = ReadAny<uint64>(reader, value);
+            break;
+        case eValueType::FLOAT32:
+            read = ReadAny<float32>(reader, value);
+            break;
+        case eValueType::FLOAT64:
+            read = ReadAny<float64>(reader, value);
+            break;
+        case eValueType::VECTOR2:
+            read = ReadAny<Vector2>(reader, value);
+            break;
+        case eValueType::VECTOR3:
+            read = ReadAny<Vector3>(reader, value);
+            break;
+        case eValueType::VECTOR4:
+            read = ReadAny<Vector4>(reader, value);
+            break;
+        case eValueType::COLOR:
+            read = ReadAny<Color>(reader, value);
+            break;
+        case eValueType::QUATERNION:
+            read = ReadAny<Quaternion>(reader, value);
+            break;
+        case eValueType::MATRIX3:
+            read = ReadAny<Matrix3>(reader, value);
+            break;
+        case eValueType::MATRIX4:
+            read = ReadAny<Matrix4>(reader, value);
+            break;
+        case eValueType::AABBOX3:
+            read = ReadAny<AABBox3>(reader, value);
+            break;
+        case eValueType::STRING:
+            read = ReadAny<String>(reader, value);
+            break;
+        case eValueType::FASTNAME:
+            read = ReadAny<FastName>(reader, value);
+            break;
+        default:
+            break;
+        }
+
+        if (!read)
+        {
+            return false;
+        }
+
+        Reflection fieldRef = ref.GetField(fieldNames[type.firstField + i]);
+        if (!fieldRef.IsValid() || !fieldRef.SetValue(value))
+        {
+            Logger::Warning("[FlatHierarchy] can't set field %s of %s", fieldNames[type.firstField + i].c_str(), GetString(type.nameIndex));
+        }
+    }
+
+    return reader.IsEnd();
+}
+
+bool BlockReader::LoadComponents(uint32 entityIndex, Entity* entity) const
+{
+    const EntityRecord& record = entities[entityIndex];
+
+    bool result = true;
+    for (uint32 i = 0; i < record.componentsCount; ++i)
+    {
+        const ComponentRecord& componentRecord = components[record.firstComponent + i];
+
+        Component* component = nullptr;
+        ComponentState state;
+        if (!CreateComponent(componentRecord, component, state))
+        {
+            result = false;
+            continue;
+        }
+        if (component == nullptr)
+        {
+            continue;
+        }
+
+        if (component->GetType()->Is<TransformComponent>())
+        {
+            entity->RemoveComponent(component->GetType());
+        }
+
+        entity->AddComponent(component);
+        result &= RestoreComponent(component, state);
+    }
+
+    return result;
+}
+
+/**
+    Builds archive in the same layout as Entity::Save does, with "#childrenCount" as in nested hierarchy,
+    for the code which works with raw scene archives.
+*/
+KeyedArchive* BlockReader::CreateEntityArchive(uint32 entityIndex) const
+{
+    const EntityRecord& record = entities[entityIndex];
+
+    KeyedArchive* archive = new KeyedArchive();
+    archive->SetString("##name", "Entity");
+    archive->SetString("name", GetString(record.nameIndex));
+    archive->SetUInt32("id", record.id);
+    archive->SetUInt32("flags", record.flags);
+    archive->SetInt32("#childrenCount", static_cast<int32>(record.childrenCount));
+
+    ScopedPtr<KeyedArchive> componentsArchive(new KeyedArchive());
+    uint32 savedIndex = 0;
+    for (uint32 i = 0; i < record.componentsCount; ++i)
+    {
+        Component* component = nullptr;
+        ComponentState state;
+        if (!CreateComponent(components[record.firstComponent + i], component, state) || component == nullptr)
+        {
+            continue;
+        }
+
+        KeyedArchive* componentArchive = state.archive;
+        if (componentArchive == nullptr && RestoreComponent(component, state))
+        {
+            componentArchive = new KeyedArchive();
+            component->Serialize(componentArchive, serializationContext);
+        }
+        SafeDelete(component);
+
+        if (componentArchive == nullptr)
+        {
+            continue;
+        }
+
+        componentsArchive->SetArchive(KeyedArchive::GenKeyFromIndex(savedIndex++), componentArchive);
+        SafeRelease(componentArchive);
+    }
+
+    componentsArchive->SetUInt32("count", savedIndex);
+    archive->SetArchive("components", componentsArchive);
+    return archive;
+}
+} // namespace FlatHierarchy
+} // namespace DAVA
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/FastName.h"
+
+namespace DAVA
+{
+class AABBox3;
+class Component;
+class Entity;
+class File;
+class KeyedArchive;
+class Quaternion;
+class SerializationContext;
+class Vector2;
+class Vector3;
+class Vector4;
+struct Matrix3;
+struct Matrix4;
+
+/**
+    Binary entity hierarchy stored by SceneFileV2 since FLAT_HIERARCHY_SCENE_VERSION.
+
+    Block consists of:
+    - header with sizes of all tables;
+    - string table with entity names, component type names, field names and String/FastName field values;
+    - component type table: type name, encoding and location of type blob;
+    - field table: name and value type of every serialized field of reflection-encoded types;
+    - entity table in depth-first order. Every entity knows size of its subtree, so any subtree is
+      a contiguous range of entities and can be skipped without touching its data;
+    - component table: components of entity go one after another, each one points into its type blob;
+    - one contiguous blob per component type.
+
+    Components marked with M::FlatSerializableComponent are stored as raw values of their reflected fields,
+    the field layout is written once per type. Other components are stored as values written by
+    Component::SaveFlat, or as binary KeyedArchive produced by Component::Serialize if component
+    can't be written as values. As entities are written in depth-first order, components of any subtree occupy
+    a contiguous range in every type blob, so loading a subtree reads only these ranges.
+*/
+namespace FlatHierarchy
+{
+static const uint32 BLOCK_MARKER = 0x54414c46; // 'FLAT'
+static const uint32 INVALID_STRING_INDEX = static_cast<uint32>(-1);
+
+enum class eComponentEncoding : uint32
+{
+    REFLECTION = 0,
+    CUSTOM = 2 // every component starts with eCustomComponentData
+};
+
+enum class eCustomComponentData : uint8
+{
+    VALUES = 0, // values written by Component::SaveFlat
+    ARCHIVE = 1 // binary KeyedArchive
+};
+
+enum class eValueType : uint32
+{
+    BOOL = 0,
+    INT32,
+    UINT32,
+    INT64,
+    UINT64,
+    FLOAT32,
+    FLOAT64,
+    VECTOR2,
+    VECTOR3,
+    VECTOR4,
+    COLOR,
+    QUATERNION,
+    MATRIX3,
+    MATRIX4,
+    AABBOX3,
+    STRING,
+    FASTNAME
+};
+
+struct BlockHeader
+{
+    uint32 marker = BLOCK_MARKER;
+    uint32 stringsCount = 0;
+    uint32 stringsSize = 0;
+    uint32 typesCount = 0;
+    uint32 fieldsCount = 0;
+    uint32 entitiesCount = 0;
+    uint32 componentsCount = 0;
+    uint32 reserved = 0;
+    uint64 blobsSize = 0;
+};
+
+struct TypeRecord
+{
+    uint32 nameIndex = 0;
+    eComponentEncoding encoding = eComponentEncoding::CUSTOM;
+    uint32 firstField = 0;
+    uint32 fieldsCount = 0;
+    uint64 blobOffset = 0;
+    uint64 blobSize = 0;
+};
+
+struct FieldRecord
+{
+    uint32 nameIndex = 0;
+    eValueType valueType = eValueType::BOOL;
+};
+
+struct EntityRecord
+{
+    uint32 nameIndex = 0;
+    uint32 id = 0;
+    uint32 flags = 0;
+    uint32 childrenCount = 0;
+    uint32 subtreeSize = 1; // including entity itself
+    uint32 firstComponent = 0;
+    uint32 componentsCount = 0;
+};
+
+struct ComponentRecord
+{
+    uint32 typeIndex = 0;
+    uint32 size = 0;
+    uint64 offset = 0; // from the beginning of type blob
+};
+
+class BlockWriter;
+class BlockReader;
+
+/**
+    Writes values of component to its type blob. Math types are written as sequences of float32 components,
+    String and FastName values are written as indices in string table of the block.
+*/
+class ValueWriter final
+{
+public:
+    ValueWriter(BlockWriter* blockWriter, Vector<uint8>* blob);
+
+    template <typename T>
+    void Write(const T& value);
+    void Write(const Vector2& value);
+    void Write(const Vector3& value);
+    void Write(const Vector4& value);
+    void Write(const Quaternion& value);
+    void Write(const Matrix3& value);
+    void Write(const Matrix4& value);
+    void Write(const AABBox3& value);
+    void Write(const String& value);
+    void Write(const FastName& value);
+
+private:
+    void WriteFloats(const float32* values, uint32 count);
+
+    BlockWriter* blockWriter = nullptr;
+    Vector<uint8>* blob = nullptr;
+};
+
+/** Reads values written by ValueWriter, every `Read` returns false if data is over or corrupted. */
+class ValueReader final
+{
+public:
+    ValueReader(const BlockReader* blockReader, const uint8* data, uint32 size);
+
+    template <typename T>
+    bool Read(T& value);
+    bool Read(Vector2& value);
+    bool Read(Vector3& value);
+    bool Read(Vector4& value);
+    bool Read(Quaternion& value);
+    bool Read(Matrix3& value);
+    bool Read(Matrix4& value);
+    bool Read(AABBox3& value);
+    bool Read(String& value);
+    bool Read(FastName& value);
+
+    /** Whether all values were read. */
+    bool IsEnd() const;
+
+private:
+    bool ReadFloats(float32* values, uint32 count);
+    bool ReadStringIndex(uint32& index);
+
+    const BlockReader* blockReader = nullptr;
+    const uint8* ptr = nullptr;
+    const uint8* end = nullptr;
+};
+
+/**
+    Collects entities and components in depth-first order and writes them as flat hierarchy block.
+    Usage: call `AddEntity` for entity, `AddComponent` for each of its components, then process
+    children recursively and call `EndEntity` with index returned by `AddEntity`.
+*/
+class BlockWriter final
+{
+public:
+    explicit BlockWriter(SerializationContext* serializationContext);
+
+    uint32 AddEntity(const FastName& name, uint32 id, uint32 flags, uint32 childrenCount);
+    void AddComponent(Component* component);
+    void EndEntity(uint32 entityIndex);
+
+    bool Save(File* file) const;
+
+private:
+    friend class ValueWriter;
+
+    struct TypeData
+    {
+        TypeRecord record;
+        Vector<uint8> blob;
+    };
+
+    uint32 AddString(const String& str);
+    uint32 GetReflectedTypeIndex(Component* component);
+    uint32 GetTypeIndex(const String& typeName, eComponentEncoding encoding);
+    void WriteReflectedComponent(Component* component, uint32 typeIndex);
+
+    SerializationContext* serializationContext = nullptr;
+
+    Vector<char> strings;
+    uint32 stringsCount = 0;
+    UnorderedMap<String, uint32> stringIndices;
+
+    Vector<TypeData> types;
+    UnorderedMap<String, uint32> typeIndices;
+    Vector<FieldRecord> fields;
+
+    Vector<EntityRecord> entities;
+    Vector<ComponentRecord> components;
+
+    Vector<uint8> componentValues; // values of custom encoded component before it is known whether they are written
+};
+
+/**
+    Reads flat hierarchy block.
+    `ReadTables` reads everything except component blobs. Before entity components could be created with
+    `LoadComponents` blob ranges for entity should be read with `ReadBlobs`; usually that is done once
+    for the whole subtree which is going to be loaded.
+*/
+class BlockReader final
+{
+public:
+    explicit BlockReader(SerializationContext* serializationContext);
+
+    bool ReadTables(File* file);
+    bool ReadBlobs(File* file, uint32 firstEntity, uint32 entitiesCount);
+
+    uint32 GetEntitiesCount() const;
+    const EntityRecord& GetEntity(uint32 index) const;
+    FastName GetEntityName(uint32 index) const;
+
+    bool LoadComponents(uint32 entityIndex, Entity* entity) const;
+    KeyedArchive* CreateEntityArchive(uint32 entityIndex) const;
+
+    /** Position right after the block. */
+    uint64 GetEndPosition() const;
+
+private:
+    friend class ValueReader;
+
+    struct LoadedBlob
+    {
+        uint64 begin = 0;
+        Vector<uint8> data;
+    };
+
+    // What is left to read after component is created
+    struct ComponentState
+    {
+        KeyedArchive* archive = nullptr; // to be passed to Component::Deserialize
+        const uint8* values = nullptr; // or to Component::LoadFlat
+        uint32 valuesSize = 0;
+    };
+
+    const char* GetString(uint32 index) const;
+    const uint8* GetComponentData(const ComponentRecord& component) const;
+    bool CreateComponent(const ComponentRecord& record, Component*& component, ComponentState& state) const;
+    bool RestoreComponent(Component* component, ComponentState& state) const;
+    bool ReadReflectedComponent(Component* component, const TypeRecord& type, const uint8* data, uint32 size) const;
+
+    SerializationContext* serializationContext = nullptr;
+
+    BlockHeader header;
+    uint64 blobsPosition = 0;
+
+    Vector<char> strings;
+    Vector<uint32> stringOffsets;
+    Vector<TypeRecord> types;
+    Vector<FieldRecord> fields;
+    Vector<FastName> fieldNames;
+    Vector<EntityRecord> entities;
+    Vector<ComponentRecord> components;
+
+    Vector<LoadedBlob> loadedBlobs;
+};
+
+template <typename T>
+void ValueWriter::Write(const T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "value is written as raw bytes");
+    const uint8* bytes = reinterpret_cast<const uint8*>(&value);
+    blob->insert(blob->end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool ValueReader::Read(T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "value is read as raw bytes");
+    if (static_cast<size_t>(end - ptr) < sizeof(T))
+    {
+        return false;
+    }
+    Memcpy(&value, ptr, sizeof(T));
+    ptr += sizeof(T);
+    return true;
+}
+
+inline bool ValueReader::IsEnd() const
+{
+    return ptr == end;
+}
+
+inline uint32 BlockReader::GetEntitiesCount() const
+{
+    return static_cast<uint32>(entities.size());
+}
+
+inline const EntityRecord& BlockReader::GetEntity(uint32 index) const
+{
+    return entities[index];
+}
+
+inline uint64 BlockReader::GetEndPosition() const
+{
+    return blobsPosition + header.blobsSize;
+}
+} // namespace FlatHierarchy
+} // namespace DAVA
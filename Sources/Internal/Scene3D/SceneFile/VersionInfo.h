@@ -28,8 +28,9 @@ static const int32 TRANSFORM_REFACTORING_SCENE_VERSION = 24; // TransformCompone
 static const int32 WORLD_OF_TANKS_BLITZ_6_2_VERSION = 25;
 static const int32 WORLD_OF_TANKS_BLITZ_7_8_VERSION = 30;
 static const int32 WORLD_OF_TANKS_BLITZ_11_8_0_VERSION = 48;
+static const int32 FLAT_HIERARCHY_SCENE_VERSION = 49; // datanodes as in version 25, entities as flat table with per-component-type blobs
 
-static const int32 SCENE_FILE_CURRENT_VERSION = WORLD_OF_TANKS_BLITZ_11_8_0_VERSION;
+static const int32 SCENE_FILE_CURRENT_VERSION = FLAT_HIERARCHY_SCENE_VERSION;
 static const int32 SCENE_FILE_SAVED_VERSION = WORLD_OF_TANKS_BLITZ_6_2_VERSION;
 static const int32 SCENE_FILE_MINIMAL_SUPPORTED_VERSION = 9;
 
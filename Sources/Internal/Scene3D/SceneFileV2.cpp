@@ -34,6 +34,7 @@
 #include "Scene3D/Components/RenderComponent.h"
 
 #include "Scene3D/Scene.h"
+#include "Scene3D/SceneFile/FlatHierarchy.h"
 #include "Scene3D/Systems/QualitySettingsSystem.h"
 
 #include "Scene3D/Converters/SpeedTreeConverter.h"
@@ -48,6 +49,29 @@
 
 namespace DAVA
 {
+namespace SceneFileV2Details
+{
+// top-level entities of flat hierarchy are read in ranges of about this size to limit memory used by component blobs
+const uint32 FLAT_HIERARCHY_READ_RANGE_ENTITIES = 4096;
+
+SceneArchive::SceneArchiveHierarchyNode* CreateArchiveNode(const FlatHierarchy::BlockReader& reader, uint32& entityIndex)
+{
+    SceneArchive::SceneArchiveHierarchyNode* node = new SceneArchive::SceneArchiveHierarchyNode();
+    node->archive = reader.CreateEntityArchive(entityIndex);
+
+    const FlatHierarchy::EntityRecord& record = reader.GetEntity(entityIndex);
+    uint32 subtreeEnd = entityIndex + record.subtreeSize;
+    ++entityIndex;
+
+    node->children.reserve(record.childrenCount);
+    while (entityIndex < subtreeEnd)
+    {
+        node->children.push_back(CreateArchiveNode(reader, entityIndex));
+    }
+    return node;
+}
+}
+
 SceneFileV2::SceneFileV2() //-V730 no need to init descriptor
 {
     isDebugLogEnabled = false;
@@ -67,6 +91,16 @@ void SceneFileV2::EnableSaveForGame(bool _isSaveForGame)
     isSaveForGame = _isSaveForGame;
 }
 
+void SceneFileV2::EnableFlatHierarchy(bool _isFlatHierarchy)
+{
+    isFlatHierarchy = _isFlatHierarchy;
+}
+
+void SceneFileV2::SetTopLevelEntityFilter(const Function<bool(const FastName&)>& filter)
+{
+    topLevelEntityFilter = filter;
+}
+
 void SceneFileV2::EnableDebugLog(bool _isDebugLogEnabled)
 {
     isDebugLogEnabled = _isDebugLogEnabled;
@@ -104,8 +138,9 @@ SceneFileV2::eError SceneFileV2::SaveScene(const FilePath& filename, Scene* scen
     header.signature[2] = 'V';
     header.signature[3] = '2';
 
-    header.version = SCENE_FILE_SAVED_VERSION;
-    header.nodeCount = scene->GetChildrenCount();
+    header.version = isFlatHierarchy ? FLAT_HIERARCHY_SCENE_VERSION : SCENE_FILE_SAVED_VERSION;
+    // entities of flat hierarchy are counted inside of its block
+    header.nodeCount = isFlatHierarchy ? 0 : scene->GetChildrenCount();
 
     if (scene->GetGlobalMaterial())
     {
@@ -302,14 +337,26 @@ SceneFileV2::eError SceneFileV2::SaveScene(const FilePath& filename, Scene* scen
         Logger::FrameworkDebug("+ save hierarchy");
     }
 
-    for (int ci = 0; ci < scene->GetChildrenCount(); ++ci)
+    if (isFlatHierarchy)
     {
-        if (!SaveHierarchy(scene->GetChild(ci), file, 1))
+        if (!SaveFlatHierarchy(scene, file))
         {
-            Logger::Error("SceneFileV2::SaveScene failed to save hierarchy file: %s", filename.GetAbsolutePathname().c_str());
+            Logger::Error("SceneFileV2::SaveScene failed to save flat hierarchy file: %s", filename.GetAbsolutePathname().c_str());
+            SetError(ERROR_FILE_WRITE_ERROR);
             return GetError();
         }
     }
+    else
+    {
+        for (int ci = 0; ci < scene->GetChildrenCount(); ++ci)
+        {
+            if (!SaveHierarchy(scene->GetChild(ci), file, 1))
+            {
+                Logger::Error("SceneFileV2::SaveScene failed to save hierarchy file: %s", filename.GetAbsolutePathname().c_str());
+                return GetError();
+            }
+        }
+    }
 
     if (!file->Flush())
     {
@@ -507,7 +554,10 @@ SceneFileV2::eError SceneFileV2::LoadScene(const FilePath& filename, Scene* scen
     serializationContext.SetScene(scene);
     serializationContext.SetDefaultMaterialQuality(NMaterialQualityName::DEFAULT_QUALITY_NAME);
 
-    if (header.version <= WORLD_OF_TANKS_BLITZ_6_2_VERSION)
+    // flat hierarchy scenes keep datanodes in the same layout as version 25 ones
+    const bool isFlatHierarchyFile = header.version >= FLAT_HIERARCHY_SCENE_VERSION;
+
+    if (header.version <= WORLD_OF_TANKS_BLITZ_6_2_VERSION || isFlatHierarchyFile)
     {
         int32 dataNodeCount = 0;
         uint32 result = file->Read(&dataNodeCount, sizeof(int32));
@@ -569,20 +619,32 @@ SceneFileV2::eError SceneFileV2::LoadScene(const FilePath& filename, Scene* scen
         ApplyFogQuality(globalMaterial);
         scene->SetGlobalMaterial(globalMaterial);
 
-        scene->children.reserve(header.nodeCount);
-        for (int ci = 0; ci < header.nodeCount; ++ci)
+        if (isFlatHierarchyFile)
         {
-            const bool loaded = LoadHierarchy(0, scene, file, 1);
-            if (!loaded)
+            if (!LoadFlatHierarchy(scene, file))
             {
-                Logger::Error("SceneFileV2::LoadScene LoadHierarchy failed in file: %s", filename.GetAbsolutePathname().c_str());
+                Logger::Error("SceneFileV2::LoadScene LoadFlatHierarchy failed in file: %s", filename.GetAbsolutePathname().c_str());
                 SetError(ERROR_FILE_READ_ERROR);
                 return GetError();
             }
         }
+        else
+        {
+            scene->children.reserve(header.nodeCount);
+            for (int ci = 0; ci < header.nodeCount; ++ci)
+            {
+                const bool loaded = LoadHierarchy(0, scene, file, 1);
+                if (!loaded)
+                {
+                    Logger::Error("SceneFileV2::LoadScene LoadHierarchy failed in file: %s", filename.GetAbsolutePathname().c_str());
+                    SetError(ERROR_FILE_READ_ERROR);
+                    return GetError();
+                }
+            }
+        }
     }
 
-    if (header.version >= WORLD_OF_TANKS_BLITZ_7_8_VERSION)
+    if (header.version >= WORLD_OF_TANKS_BLITZ_7_8_VERSION && !isFlatHierarchyFile)
     {
         ScopedPtr<KeyedArchive> sceneArchive(new KeyedArchive());
         if (!sceneArchive->Load(file))
@@ -857,6 +919,23 @@ SceneArchive* SceneFileV2::LoadSceneArchive(const FilePath& filename)
         }
         res->children.push_back(child);
     }
+    if (loadNodes && header.version >= FLAT_HIERARCHY_SCENE_VERSION)
+    {
+        FlatHierarchy::BlockReader reader(&serializationContext);
+        loadNodes = reader.ReadTables(file) && reader.ReadBlobs(file, 0, reader.GetEntitiesCount());
+        if (loadNodes)
+        {
+            uint32 entityIndex = 0;
+            while (entityIndex < reader.GetEntitiesCount())
+            {
+                res->children.push_back(SceneFileV2Details::CreateArchiveNode(reader, entityIndex));
+            }
+        }
+        else
+        {
+            Logger::Error("SceneFileV2::LoadScene LoadFlatHierarchy failed in file %s", file->GetFilename().GetAbsolutePathname().c_str());
+        }
+    }
     if (!loadNodes)
     {
         for (SceneArchive::SceneArchiveHierarchyNode* iter : res->children)
@@ -1148,6 +1227,37 @@ bool SceneFileV2::SaveHierarchy(Entity* node, File* file, int32 level)
     return true;
 }
 
+bool SceneFileV2::SaveFlatHierarchy(Scene* scene, File* file)
+{
+    FlatHierarchy::BlockWriter writer(&serializationContext);
+    for (Entity* child : scene->children)
+    {
+        AddToFlatHierarchy(writer, child);
+    }
+    return writer.Save(file);
+}
+
+void SceneFileV2::AddToFlatHierarchy(FlatHierarchy::BlockWriter& writer, Entity* node)
+{
+    // entity class isn't stored, LoadFlatEntity creates every entity as plain Entity
+    DVASSERT(IsPointerToExactClass<Entity>(node));
+
+    uint32 entityIndex = writer.AddEntity(node->GetName(), node->GetID(), node->GetFlags(), node->GetChildrenCount());
+    for (Component* c : node->components)
+    {
+        if (IsSerializableComponent(c))
+        {
+            writer.AddComponent(c);
+        }
+    }
+
+    for (Entity* child : node->children)
+    {
+        AddToFlatHierarchy(writer, child);
+    }
+    writer.EndEntity(entityIndex);
+}
+
 bool SceneFileV2::GetNestedParticleEmitterNodes(Entity* entity, Vector<VariantType>* result)
 {
     for (int childrenIndex = 0; childrenIndex < entity->GetChildrenCount(); ++childrenIndex)
@@ -1278,6 +1388,90 @@ bool SceneFileV2::LoadHierarchy(Scene* scene, Entity* parent, File* file, int32
     return resultLoad;
 }
 
+bool SceneFileV2::LoadFlatHierarchy(Scene* scene, File* file)
+{
+    using namespace SceneFileV2Details;
+
+    FlatHierarchy::BlockReader reader(&serializationContext);
+    if (!reader.ReadTables(file))
+    {
+        return false;
+    }
+
+    bool loaded = true;
+    const uint32 entitiesCount = reader.GetEntitiesCount();
+    uint32 entityIndex = 0;
+    while (loaded && entityIndex < entitiesCount)
+    {
+        // consecutive accepted top-level subtrees are read with one request per component type
+        uint32 rangeBegin = entityIndex;
+        bool rejected = false;
+        while (entityIndex < entitiesCount && entityIndex - rangeBegin < FLAT_HIERARCHY_READ_RANGE_ENTITIES)
+        {
+            rejected = topLevelEntityFilter && !topLevelEntityFilter(reader.GetEntityName(entityIndex));
+            if (rejected)
+            {
+                break;
+            }
+            entityIndex += reader.GetEntity(entityIndex).subtreeSize;
+        }
+
+        if (entityIndex > rangeBegin)
+        {
+            loaded = reader.ReadBlobs(file, rangeBegin, entityIndex - rangeBegin);
+            for (uint32 i = rangeBegin; loaded && i < entityIndex;)
+            {
+                i = LoadFlatEntity(reader, scene, scene, i, loaded);
+            }
+        }
+
+        if (rejected)
+        {
+            entityIndex += reader.GetEntity(entityIndex).subtreeSize;
+        }
+    }
+
+    return loaded && file->Seek(reader.GetEndPosition(), File::SEEK_FROM_START);
+}
+
+uint32 SceneFileV2::LoadFlatEntity(const FlatHierarchy::BlockReader& reader, Scene* scene, Entity* parent, uint32 entityIndex, bool& loaded)
+{
+    const FlatHierarchy::EntityRecord& record = reader.GetEntity(entityIndex);
+    const uint32 subtreeEnd = entityIndex + record.subtreeSize;
+
+    // "LandscapeNode", "Camera" and "LightNode" classes handled by LoadHierarchy exist only in old nested files,
+    // they are loaded as plain entities with landscape, camera or light component, which are stored here as components
+    Entity* node = new Entity();
+    node->SetScene(scene);
+    node->name = reader.GetEntityName(entityIndex);
+    node->id = record.id;
+    node->sceneId = scene->GetSceneID();
+    node->flags = record.flags & ~Entity::TRANSFORM_DIRTY;
+    loaded &= reader.LoadComponents(entityIndex, node);
+
+    // entities invisible for current quality are dropped with their subtrees, so subtrees are not decoded at all
+    bool keepUnusedQualityEntities = QualitySettingsSystem::Instance()->GetKeepUnusedEntities();
+    if (keepUnusedQualityEntities || QualitySettingsSystem::Instance()->IsQualityVisible(node))
+    {
+        parent->AddNode(node);
+
+        node->children.reserve(record.childrenCount);
+        uint32 childIndex = entityIndex + 1;
+        for (uint32 ci = 0; ci < record.childrenCount && childIndex < subtreeEnd; ++ci)
+        {
+            childIndex = LoadFlatEntity(reader, scene, node, childIndex, loaded);
+        }
+        loaded &= (childIndex == subtreeEnd);
+
+        ParticleEffectComponent* effect = node->GetComponent<ParticleEffectComponent>();
+        if (effect && (effect->loadedVersion == 0))
+            effect->CollapseOldEffect(&serializationContext);
+    }
+
+    SafeRelease(node);
+    return subtreeEnd;
+}
+
 void SceneFileV2::FixLodForLodsystem2(Entity* entity)
 {
     LodComponent* lod = GetLodComponent(entity);
@@ -8,6 +8,7 @@
 #include "Render/3D/StaticMesh.h"
 #include "Scene3D/SceneFile/SerializationContext.h"
 #include "Scene3D/SceneFile/VersionInfo.h"
+#include "Functional/Function.h"
 #include "Utils/Utils.h"
 
 namespace DAVA
@@ -63,6 +64,11 @@ namespace DAVA
 */
 
 class NMaterial;
+namespace FlatHierarchy
+{
+class BlockReader;
+class BlockWriter;
+}
 class Scene;
 
 class SceneArchive : public BaseObject
@@ -171,6 +177,18 @@ public:
      * When enabled, certain scene data might be preprocessed or optimized for runtime performance.
      */
     void EnableSaveForGame(bool _isSaveForGame);
+    /**
+     * @brief Sets whether entities should be saved as flat hierarchy block
+     * @param[in] _isFlatHierarchy If true, scene is saved with FLAT_HIERARCHY_SCENE_VERSION: entities are stored as flat table
+     *                             with per-component-type blobs instead of nested KeyedArchive per entity
+     */
+    void EnableFlatHierarchy(bool _isFlatHierarchy);
+    /**
+     * @brief Sets filter for top-level entities of scenes saved with flat hierarchy
+     * @param[in] filter Function receiving name of top-level entity. Subtrees rejected by filter are not read from file at all.
+     *                   Empty function loads all entities. Scenes with nested hierarchy ignore the filter.
+     */
+    void SetTopLevelEntityFilter(const Function<bool(const FastName&)>& filter);
 
     // Material * GetMaterial(int32 index);
     // StaticMesh * GetStaticMesh(int32 index);
@@ -384,6 +402,24 @@ private:
 
     bool LoadHierarchy(Scene* scene, Entity* node, File* file, int32 level);
 
+    /**
+     * @brief Saves all children of scene as flat hierarchy block
+     * @param scene Scene which children are saved
+     * @param file The file to write the block to
+     * @return true if block was saved successfully, false otherwise
+     */
+    bool SaveFlatHierarchy(Scene* scene, File* file);
+    void AddToFlatHierarchy(FlatHierarchy::BlockWriter& writer, Entity* node);
+
+    /**
+     * @brief Loads flat hierarchy block into scene, skipping subtrees rejected by top-level entity filter
+     * @param scene Scene where entities are added
+     * @param file The file to read the block from
+     * @return true if hierarchy was loaded successfully, false otherwise
+     */
+    bool LoadFlatHierarchy(Scene* scene, File* file);
+    uint32 LoadFlatEntity(const FlatHierarchy::BlockReader& reader, Scene* scene, Entity* parent, uint32 entityIndex, bool& loaded);
+
     /**
      * @brief Fixes the Level of Detail (LOD) settings for entities using LOD System 2
      * @param[in] entity Pointer to the Entity whose LOD settings need to be fixed
@@ -448,6 +484,8 @@ private:
 
     bool isDebugLogEnabled;
     bool isSaveForGame;
+    bool isFlatHierarchy = false;
+    Function<bool(const FastName&)> topLevelEntityFilter;
     eError lastError;
 
     SerializationContext serializationContext;
@@ -85,6 +85,8 @@ public:
      * 
      * This function computes the final skeleton pose by evaluating the blend tree at the specified
      * phase using the provided blend parameters. The result is written to the outPose parameter.
+     * Animation clips are shared between blend trees read-only, so blend trees of different
+     * instances playing the same clips may be evaluated concurrently.
      */
     void EvaluatePose(uint32 phaseIndex, float32 phase, const Vector<const float32*>& parameters, SkeletonPose* outPose) const;
     /**
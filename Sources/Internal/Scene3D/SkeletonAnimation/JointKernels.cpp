@@ -0,0 +1,282 @@
+#include "Scene3D/SkeletonAnimation/JointKernels.h"
+#include "Scene3D/SkeletonAnimation/JointTransformStreams.h"
+#include "Debug/DVAssert.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define JOINT_KERNELS_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define JOINT_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace DAVA
+{
+namespace JointKernelsDetails
+{
+using JointKernels::eImplementation;
+
+const uint32 LANES = 4;
+
+inline uint32 GetSimdEnd(uint32 begin, uint32 end)
+{
+    return begin + (end - begin) / LANES * LANES;
+}
+
+// Same operations as JointTransform::AppendTransform, Quaternion::ApplyToVectorFast and Quaternion::Mul
+void AppendTransformsScalar(const JointTransformStreams& a, const JointTransformStreams& b, JointTransformStreams& r, uint32 begin, uint32 end)
+{
+    for (uint32 i = begin; i < end; ++i)
+    {
+        float32 qx = a.orientationX[i];
+        float32 qy = a.orientationY[i];
+        float32 qz = a.orientationZ[i];
+        float32 qw = a.orientationW[i];
+        float32 vx = b.positionX[i];
+        float32 vy = b.positionY[i];
+        float32 vz = b.positionZ[i];
+
+        float32 tx = 2.0f * (qy * vz - vy * qz);
+        float32 ty = 2.0f * (qz * vx - qx * vz);
+        float32 tz = 2.0f * (qx * vy - qy * vx);
+        float32 rx = (vx + qw * tx) + (qy * tz - ty * qz);
+        float32 ry = (vy + qw * ty) + (qz * tx - qx * tz);
+        float32 rz = (vz + qw * tz) + (qx * ty - qy * tx);
+
+        float32 s = a.scale[i];
+        r.positionX[i] = a.positionX[i] + rx * s;
+        r.positionY[i] = a.positionY[i] + ry * s;
+        r.positionZ[i] = a.positionZ[i] + rz * s;
+        r.scale[i] = s * b.scale[i];
+
+        uint32 maskA = a.orientationMask[i];
+        uint32 maskB = b.orientationMask[i];
+        r.orientationMask[i] = maskA | maskB;
+        if (maskA != 0 && maskB != 0)
+        {
+            float32 px = b.orientationX[i];
+            float32 py = b.orientationY[i];
+            float32 pz = b.orientationZ[i];
+            float32 pw = b.orientationW[i];
+
+            float32 A = (qw + qx) * (pw + px);
+            float32 B = (qz - qy) * (py - pz);
+            float32 C = (qx - qw) * (py + pz);
+            float32 D = (qy + qz) * (px - pw);
+            float32 E = (qx + qz) * (px + py);
+            float32 F = (qx - qz) * (px - py);
+            float32 G = (qw + qy) * (pw - pz);
+            float32 H = (qw - qy) * (pw + pz);
+
+            r.orientationW[i] = B + (-E - F + G + H) * 0.5f;
+            r.orientationX[i] = A - (E + F + G + H) * 0.5f;
+            r.orientationY[i] = -C + (E - F + G - H) * 0.5f;
+            r.orientationZ[i] = -D + (E - F - G + H) * 0.5f;
+        }
+        else
+        {
+            const JointTransformStreams& source = (maskA != 0) ? a : b;
+            r.orientationX[i] = source.orientationX[i];
+            r.orientationY[i] = source.orientationY[i];
+            r.orientationZ[i] = source.orientationZ[i];
+            r.orientationW[i] = source.orientationW[i];
+        }
+    }
+}
+
+#if defined(JOINT_KERNELS_SSE)
+inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+inline __m128 LoadMask(const uint32* mask)
+{
+    return _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask)));
+}
+
+void AppendTransformsSSE(const JointTransformStreams& a, const JointTransformStreams& b, JointTransformStreams& r, uint32 begin, uint32 end)
+{
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    for (uint32 i = begin; i < end; i += LANES)
+    {
+        __m128 qx = _mm_loadu_ps(&a.orientationX[i]);
+        __m128 qy = _mm_loadu_ps(&a.orientationY[i]);
+        __m128 qz = _mm_loadu_ps(&a.orientationZ[i]);
+        __m128 qw = _mm_loadu_ps(&a.orientationW[i]);
+        __m128 vx = _mm_loadu_ps(&b.positionX[i]);
+        __m128 vy = _mm_loadu_ps(&b.positionY[i]);
+        __m128 vz = _mm_loadu_ps(&b.positionZ[i]);
+
+        __m128 tx = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qy, vz), _mm_mul_ps(vy, qz)));
+        __m128 ty = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qz, vx), _mm_mul_ps(qx, vz)));
+        __m128 tz = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qx, vy), _mm_mul_ps(qy, vx)));
+        __m128 rx = _mm_add_ps(_mm_add_ps(vx, _mm_mul_ps(qw, tx)), _mm_sub_ps(_mm_mul_ps(qy, tz), _mm_mul_ps(ty, qz)));
+        __m128 ry = _mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(qw, ty)), _mm_sub_ps(_mm_mul_ps(qz, tx), _mm_mul_ps(qx, tz)));
+        __m128 rz = _mm_add_ps(_mm_add_ps(vz, _mm_mul_ps(qw, tz)), _mm_sub_ps(_mm_mul_ps(qx, ty), _mm_mul_ps(qy, tx)));
+
+        __m128 s = _mm_loadu_ps(&a.scale[i]);
+        _mm_storeu_ps(&r.positionX[i], _mm_add_ps(_mm_loadu_ps(&a.positionX[i]), _mm_mul_ps(rx, s)));
+        _mm_storeu_ps(&r.positionY[i], _mm_add_ps(_mm_loadu_ps(&a.positionY[i]), _mm_mul_ps(ry, s)));
+        _mm_storeu_ps(&r.positionZ[i], _mm_add_ps(_mm_loadu_ps(&a.positionZ[i]), _mm_mul_ps(rz, s)));
+        _mm_storeu_ps(&r.scale[i], _mm_mul_ps(s, _mm_loadu_ps(&b.scale[i])));
+
+        __m128 px = _mm_loadu_ps(&b.orientationX[i]);
+        __m128 py = _mm_loadu_ps(&b.orientationY[i]);
+        __m128 pz = _mm_loadu_ps(&b.orientationZ[i]);
+        __m128 pw = _mm_loadu_ps(&b.orientationW[i]);
+
+        __m128 A = _mm_mul_ps(_mm_add_ps(qw, qx), _mm_add_ps(pw, px));
+        __m128 B = _mm_mul_ps(_mm_sub_ps(qz, qy), _mm_sub_ps(py, pz));
+        __m128 C = _mm_mul_ps(_mm_sub_ps(qx, qw), _mm_add_ps(py, pz));
+        __m128 D = _mm_mul_ps(_mm_add_ps(qy, qz), _mm_sub_ps(px, pw));
+        __m128 E = _mm_mul_ps(_mm_add_ps(qx, qz), _mm_add_ps(px, py));
+        __m128 F = _mm_mul_ps(_mm_sub_ps(qx, qz), _mm_sub_ps(px, py));
+        __m128 G = _mm_mul_ps(_mm_add_ps(qw, qy), _mm_sub_ps(pw, pz));
+        __m128 H = _mm_mul_ps(_mm_sub_ps(qw, qy), _mm_add_ps(pw, pz));
+
+        __m128 negE = _mm_xor_ps(E, signBit);
+        __m128 mw = _mm_add_ps(B, _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_sub_ps(negE, F), G), H), half));
+        __m128 mx = _mm_sub_ps(A, _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(E, F), G), H), half));
+        __m128 my = _mm_add_ps(_mm_xor_ps(C, signBit), _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_sub_ps(E, F), G), H), half));
+        __m128 mz = _mm_add_ps(_mm_xor_ps(D, signBit), _mm_mul_ps(_mm_add_ps(_mm_sub_ps(_mm_sub_ps(E, F), G), H), half));
+
+        // product if both transforms have orientation, otherwise orientation of the one having it
+        __m128 maskA = LoadMask(&a.orientationMask[i]);
+        __m128 maskB = LoadMask(&b.orientationMask[i]);
+        __m128 both = _mm_and_ps(maskA, maskB);
+        _mm_storeu_ps(&r.orientationX[i], Select(both, mx, Select(maskA, qx, px)));
+        _mm_storeu_ps(&r.orientationY[i], Select(both, my, Select(maskA, qy, py)));
+        _mm_storeu_ps(&r.orientationZ[i], Select(both, mz, Select(maskA, qz, pz)));
+        _mm_storeu_ps(&r.orientationW[i], Select(both, mw, Select(maskA, qw, pw)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&r.orientationMask[i]), _mm_castps_si128(_mm_or_ps(maskA, maskB)));
+    }
+}
+#endif
+
+#if defined(JOINT_KERNELS_NEON)
+void AppendTransformsNEON(const JointTransformStreams& a, const JointTransformStreams& b, JointTransformStreams& r, uint32 begin, uint32 end)
+{
+    const float32x4_t two = vdupq_n_f32(2.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (uint32 i = begin; i < end; i += LANES)
+    {
+        float32x4_t qx = vld1q_f32(&a.orientationX[i]);
+        float32x4_t qy = vld1q_f32(&a.orientationY[i]);
+        float32x4_t qz = vld1q_f32(&a.orientationZ[i]);
+        float32x4_t qw = vld1q_f32(&a.orientationW[i]);
+        float32x4_t vx = vld1q_f32(&b.positionX[i]);
+        float32x4_t vy = vld1q_f32(&b.positionY[i]);
+        float32x4_t vz = vld1q_f32(&b.positionZ[i]);
+
+        // separate multiplies and adds instead of fused vmlaq_f32 keep results equal to scalar code
+        float32x4_t tx = vmulq_f32(two, vsubq_f32(vmulq_f32(qy, vz), vmulq_f32(vy, qz)));
+        float32x4_t ty = vmulq_f32(two, vsubq_f32(vmulq_f32(qz, vx), vmulq_f32(qx, vz)));
+        float32x4_t tz = vmulq_f32(two, vsubq_f32(vmulq_f32(qx, vy), vmulq_f32(qy, vx)));
+        float32x4_t rx = vaddq_f32(vaddq_f32(vx, vmulq_f32(qw, tx)), vsubq_f32(vmulq_f32(qy, tz), vmulq_f32(ty, qz)));
+        float32x4_t ry = vaddq_f32(vaddq_f32(vy, vmulq_f32(qw, ty)), vsubq_f32(vmulq_f32(qz, tx), vmulq_f32(qx, tz)));
+        float32x4_t rz = vaddq_f32(vaddq_f32(vz, vmulq_f32(qw, tz)), vsubq_f32(vmulq_f32(qx, ty), vmulq_f32(qy, tx)));
+
+        float32x4_t s = vld1q_f32(&a.scale[i]);
+        vst1q_f32(&r.positionX[i], vaddq_f32(vld1q_f32(&a.positionX[i]), vmulq_f32(rx, s)));
+        vst1q_f32(&r.positionY[i], vaddq_f32(vld1q_f32(&a.positionY[i]), vmulq_f32(ry, s)));
+        vst1q_f32(&r.positionZ[i], vaddq_f32(vld1q_f32(&a.positionZ[i]), vmulq_f32(rz, s)));
+        vst1q_f32(&r.scale[i], vmulq_f32(s, vld1q_f32(&b.scale[i])));
+
+        float32x4_t px = vld1q_f32(&b.orientationX[i]);
+        float32x4_t py = vld1q_f32(&b.orientationY[i]);
+        float32x4_t pz = vld1q_f32(&b.orientationZ[i]);
+        float32x4_t pw = vld1q_f32(&b.orientationW[i]);
+
+        float32x4_t A = vmulq_f32(vaddq_f32(qw, qx), vaddq_f32(pw, px));
+        float32x4_t B = vmulq_f32(vsubq_f32(qz, qy), vsubq_f32(py, pz));
+        float32x4_t C = vmulq_f32(vsubq_f32(qx, qw), vaddq_f32(py, pz));
+        float32x4_t D = vmulq_f32(vaddq_f32(qy, qz), vsubq_f32(px, pw));
+        float32x4_t E = vmulq_f32(vaddq_f32(qx, qz), vaddq_f32(px, py));
+        float32x4_t F = vmulq_f32(vsubq_f32(qx, qz), vsubq_f32(px, py));
+        float32x4_t G = vmulq_f32(vaddq_f32(qw, qy), vsubq_f32(pw, pz));
+        float32x4_t H = vmulq_f32(vsubq_f32(qw, qy), vaddq_f32(pw, pz));
+
+        float32x4_t mw = vaddq_f32(B, vmulq_f32(vaddq_f32(vaddq_f32(vsubq_f32(vnegq_f32(E), F), G), H), half));
+        float32x4_t mx = vsubq_f32(A, vmulq_f32(vaddq_f32(vaddq_f32(vaddq_f32(E, F), G), H), half));
+        float32x4_t my = vaddq_f32(vnegq_f32(C), vmulq_f32(vsubq_f32(vaddq_f32(vsubq_f32(E, F), G), H), half));
+        float32x4_t mz = vaddq_f32(vnegq_f32(D), vmulq_f32(vaddq_f32(vsubq_f32(vsubq_f32(E, F), G), H), half));
+
+        uint32x4_t maskA = vld1q_u32(&a.orientationMask[i]);
+        uint32x4_t maskB = vld1q_u32(&b.orientationMask[i]);
+        uint32x4_t both = vandq_u32(maskA, maskB);
+        vst1q_f32(&r.orientationX[i], vbslq_f32(both, mx, vbslq_f32(maskA, qx, px)));
+        vst1q_f32(&r.orientationY[i], vbslq_f32(both, my, vbslq_f32(maskA, qy, py)));
+        vst1q_f32(&r.orientationZ[i], vbslq_f32(both, mz, vbslq_f32(maskA, qz, pz)));
+        vst1q_f32(&r.orientationW[i], vbslq_f32(both, mw, vbslq_f32(maskA, qw, pw)));
+        vst1q_u32(&r.orientationMask[i], vorrq_u32(maskA, maskB));
+    }
+}
+#endif
+}
+
+namespace JointKernels
+{
+bool IsImplementationAvailable(eImplementation implementation)
+{
+    switch (implementation)
+    {
+    case eImplementation::SCALAR:
+        return true;
+#if defined(JOINT_KERNELS_SSE)
+    case eImplementation::SSE:
+        return true;
+#endif
+#if defined(JOINT_KERNELS_NEON)
+    case eImplementation::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+eImplementation GetBestImplementation()
+{
+#if defined(JOINT_KERNELS_SSE)
+    return eImplementation::SSE;
+#elif defined(JOINT_KERNELS_NEON)
+    return eImplementation::NEON;
+#else
+    return eImplementation::SCALAR;
+#endif
+}
+
+void AppendTransforms(const JointTransformStreams& first, const JointTransformStreams& second, JointTransformStreams& result, uint32 begin, uint32 end, eImplementation implementation)
+{
+    using namespace JointKernelsDetails;
+
+    DVASSERT(&result != &first && &result != &second);
+    DVASSERT(end <= first.GetSize() && end <= second.GetSize() && end <= result.GetSize());
+
+    uint32 processed = begin;
+    switch (implementation)
+    {
+#if defined(JOINT_KERNELS_SSE)
+    case eImplementation::SSE:
+        processed = GetSimdEnd(begin, end);
+        AppendTransformsSSE(first, second, result, begin, processed);
+        break;
+#endif
+#if defined(JOINT_KERNELS_NEON)
+    case eImplementation::NEON:
+        processed = GetSimdEnd(begin, end);
+        AppendTransformsNEON(first, second, result, begin, processed);
+        break;
+#endif
+    default:
+        break;
+    }
+    AppendTransformsScalar(first, second, result, processed, end);
+}
+}
+}
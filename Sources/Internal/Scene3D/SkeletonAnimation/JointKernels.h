@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+class JointTransformStreams;
+
+/**
+    Batch kernels over joint transforms stored in `JointTransformStreams`.
+
+    Every kernel performs exactly the same floating point operations in the same order as `JointTransform` does,
+    so all implementations produce bit-identical results. SIMD implementations process 4 joints per iteration,
+    the tail is processed by scalar code.
+*/
+namespace JointKernels
+{
+enum class eImplementation
+{
+    SCALAR = 0, //!< reference implementation, always available
+    SSE, //!< 4 joints per iteration
+    NEON, //!< 4 joints per iteration
+};
+
+/** Return true if implementation has been compiled in for current target. */
+bool IsImplementationAvailable(eImplementation implementation);
+
+/** Return the widest implementation available for current target. */
+eImplementation GetBestImplementation();
+
+/**
+    Write `first[i].AppendTransform(second[i])` to `result[i]` for every joint in [begin, end).
+    `result` may not be the same object as `first` or `second`.
+*/
+void AppendTransforms(const JointTransformStreams& first, const JointTransformStreams& second, JointTransformStreams& result, uint32 begin, uint32 end, eImplementation implementation);
+}
+}
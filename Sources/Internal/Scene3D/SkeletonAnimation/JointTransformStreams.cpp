@@ -0,0 +1,20 @@
+#include "Scene3D/SkeletonAnimation/JointTransformStreams.h"
+
+namespace DAVA
+{
+void JointTransformStreams::Resize(uint32 count)
+{
+    size = count;
+
+    uint32 paddedCount = (count + 3) & ~3u;
+    positionX.assign(paddedCount, 0.0f);
+    positionY.assign(paddedCount, 0.0f);
+    positionZ.assign(paddedCount, 0.0f);
+    scale.assign(paddedCount, 1.0f);
+    orientationX.assign(paddedCount, 0.0f);
+    orientationY.assign(paddedCount, 0.0f);
+    orientationZ.assign(paddedCount, 0.0f);
+    orientationW.assign(paddedCount, 1.0f);
+    orientationMask.assign(paddedCount, 0);
+}
+}
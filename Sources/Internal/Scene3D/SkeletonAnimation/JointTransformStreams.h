@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/Vector.h"
+#include "Scene3D/SkeletonAnimation/JointTransform.h"
+
+namespace DAVA
+{
+/**
+    Joint transforms of one skeleton stored as structure of arrays, so joint kernels can load 4 joints with a single SIMD load.
+
+    Streams are padded to a multiple of 4 joints, padding joints hold identity transforms.
+    Orientation presence is stored as a mask (all bits set if transform has orientation),
+    which is required to compose transforms exactly as `JointTransform::AppendTransform` does.
+*/
+class JointTransformStreams final
+{
+public:
+    /** Resize streams to `count` joints and reset every joint to identity transform. */
+    void Resize(uint32 count);
+    uint32 GetSize() const;
+
+    void Set(uint32 index, const JointTransform& transform);
+
+    Vector3 GetPosition(uint32 index) const;
+    Vector4 GetOrientation(uint32 index) const;
+    float32 GetScale(uint32 index) const;
+
+    Vector<float32> positionX;
+    Vector<float32> positionY;
+    Vector<float32> positionZ;
+    Vector<float32> scale;
+    Vector<float32> orientationX;
+    Vector<float32> orientationY;
+    Vector<float32> orientationZ;
+    Vector<float32> orientationW;
+    Vector<uint32> orientationMask;
+
+private:
+    uint32 size = 0;
+};
+
+inline uint32 JointTransformStreams::GetSize() const
+{
+    return size;
+}
+
+inline void JointTransformStreams::Set(uint32 index, const JointTransform& transform)
+{
+    const Vector3& position = transform.GetPosition();
+    const Quaternion& orientation = transform.GetOrientation();
+
+    positionX[index] = position.x;
+    positionY[index] = position.y;
+    positionZ[index] = position.z;
+    scale[index] = transform.GetScale();
+    orientationX[index] = orientation.x;
+    orientationY[index] = orientation.y;
+    orientationZ[index] = orientation.z;
+    orientationW[index] = orientation.w;
+    orientationMask[index] = transform.HasOrientation() ? 0xffffffff : 0;
+}
+
+inline Vector3 JointTransformStreams::GetPosition(uint32 index) const
+{
+    return Vector3(positionX[index], positionY[index], positionZ[index]);
+}
+
+inline Vector4 JointTransformStreams::GetOrientation(uint32 index) const
+{
+    return Vector4(orientationX[index], orientationY[index], orientationZ[index], orientationW[index]);
+}
+
+inline float32 JointTransformStreams::GetScale(uint32 index) const
+{
+    return scale[index];
+}
+}
@@ -34,6 +34,8 @@ void SkeletonAnimation::BindSkeleton(const SkeletonComponent* skeleton)
     for (SkeletonAnimationClip& clip : animationClips)
     {
         clip.boundTracks.clear();
+        clip.boundTrackCursors.clear();
+        uint32 cursorsCount = 0;
 
         uint32 trackCount = clip.animationClip->GetTrackCount();
         uint32 jointCount = skeleton->GetJointsCount();
@@ -48,9 +50,13 @@ void SkeletonAnimation::BindSkeleton(const SkeletonComponent* skeleton)
             if (track != nullptr)
             {
                 clip.boundTracks.emplace_back(std::make_pair(j, track));
+                clip.boundTrackCursors.emplace_back(cursorsCount);
+                cursorsCount += track->GetChannelsCount();
                 maxJointIndex = Max(maxJointIndex, j);
             }
         }
+
+        clip.cursors.assign(cursorsCount, AnimationChannel::Cursor());
     }
 }
 
@@ -89,7 +95,9 @@ void SkeletonAnimation::EvaluatePose(float32 animationLocalTime, SkeletonPose* o
         uint32 jointIndex = clip->boundTracks[t].first;
         const AnimationTrack* track = clip->boundTracks[t].second;
 
-        outPose->SetTransform(jointIndex, EvaluateJointTransform(animationLocalTime, track));
+        AnimationChannel::Cursor* cursors = clip->cursors.data() + clip->boundTrackCursors[t];
+
+        outPose->SetTransform(jointIndex, EvaluateJointTransform(animationLocalTime, track, cursors));
     }
 }
 
@@ -137,33 +145,39 @@ float32 SkeletonAnimation::GetDuration() const
 
 //////////////////////////////////////////////////////////////////////////
 
-JointTransform SkeletonAnimation::EvaluateJointTransform(float32 time, const AnimationTrack* track)
+JointTransform SkeletonAnimation::EvaluateJointTransform(float32 time, const AnimationTrack* track, AnimationChannel::Cursor* cursors)
 {
-    static const uint32 MAX_CHANNEL_VALUE_SIZE = 4;
-    DVASSERT(MAX_CHANNEL_VALUE_SIZE >= track->GetMaxChannelValueSize());
+    static const uint32 MAX_TRACK_VALUES_SIZE = 16;
+    DVASSERT(MAX_TRACK_VALUES_SIZE >= track->GetValuesSize());
+
+    Array<float32, MAX_TRACK_VALUES_SIZE> workData;
+    track->EvaluateAll(time, cursors, workData.data(), uint32(workData.size()));
 
     JointTransform transform;
-    Array<float32, MAX_CHANNEL_VALUE_SIZE> workData;
     for (uint32 c = 0; c < track->GetChannelsCount(); ++c)
     {
-        track->Evaluate(time, c, workData.data(), uint32(workData.size()));
+        // channels which don't fit into work data aren't evaluated
+        if (track->GetChannelValueOffset(c) + track->GetChannelValueSize(c) > MAX_TRACK_VALUES_SIZE)
+            break;
+
+        const float32* value = workData.data() + track->GetChannelValueOffset(c);
 
         AnimationTrack::eChannelTarget target = track->GetChannelTarget(c);
         switch (target)
         {
         case AnimationTrack::CHANNEL_TARGET_POSITION:
             DVASSERT(track->GetChannelValueSize(c) == 3);
-            transform.SetPosition(Vector3(workData.data()));
+            transform.SetPosition(Vector3(value));
             break;
 
         case AnimationTrack::CHANNEL_TARGET_ORIENTATION:
             DVASSERT(track->GetChannelValueSize(c) == 4);
-            transform.SetOrientation(Quaternion(workData.data()));
+            transform.SetOrientation(Quaternion(value));
             break;
 
         case AnimationTrack::CHANNEL_TARGET_SCALE:
             DVASSERT(track->GetChannelValueSize(c) == 1);
-            transform.SetScale(*workData.data());
+            transform.SetScale(*value);
             break;
 
         default:
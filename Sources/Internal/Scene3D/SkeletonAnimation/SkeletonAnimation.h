@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Animation/AnimationChannel.h"
 #include "Base/BaseTypes.h"
 #include "Scene3D/Components/SkeletonComponent.h"
 
@@ -64,6 +65,9 @@ public:
      * @details This function computes the skeleton pose at the given animation time by interpolating
      * between keyframes and updating joint transformations. The result is written to the provided
      * outPose parameter.
+     *
+     * Key search state is kept per skeleton animation, animation clips are only read. So different skeleton
+     * animations of the same clip can be evaluated concurrently.
      */
     void EvaluatePose(float32 animationLocalTime, SkeletonPose* outPose);
     /**
@@ -98,6 +102,8 @@ protected:
         UnorderedSet<uint32> jointsIgnoreMask;
 
         Vector<std::pair<uint32, const AnimationTrack*>> boundTracks; //[jointIndex, track]
+        Vector<uint32> boundTrackCursors; //index of first channel cursor of bound track in 'cursors'
+        Vector<AnimationChannel::Cursor> cursors;
         const AnimationTrack* rootNodeTrack = nullptr; //for root-node transform extraction
         uint32 rootNodePositionChannel = std::numeric_limits<uint32>::max();
 
@@ -111,13 +117,14 @@ protected:
      * 
      * @param time The time point (in seconds) at which to evaluate the joint transform
      * @param track Pointer to the animation track containing keyframe data
+     * @param cursors Key cursors of every track channel, updated by evaluation
      * @return JointTransform The interpolated transformation of the joint at the specified time
      * 
      * @details This static function interpolates between keyframes in the animation track
      * to determine the exact position, rotation and scale of a joint at any given time
      * during the animation sequence.
      */
-    static JointTransform EvaluateJointTransform(float32 time, const AnimationTrack* track);
+    static JointTransform EvaluateJointTransform(float32 time, const AnimationTrack* track, AnimationChannel::Cursor* cursors);
     /**
      * @brief Evaluates the root position of the skeleton at a given animation time
      * @param[in] clip The skeleton animation clip to evaluate
@@ -9,9 +9,9 @@
 #include "Particles/ParticlesRandom.h"
 #include "Particles/ParticleForces.h"
 #include "Particles/ParticleForce.h"
+#include "Particles/ParticleForceSimplified.h"
 #include "Scene3D/Systems/EventSystem.h"
 #include "Time/SystemTimer.h"
-#include "Utils/Random.h"
 #include "Core/PerformanceSettings.h"
 #include "Scene3D/Components/ComponentHelpers.h"
 #include "Scene3D/Lod/LodComponent.h"
@@ -25,11 +25,16 @@
 #include "Scene3D/Systems/QualitySettingsSystem.h"
 #include "Engine/Engine.h"
 #include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
 
 namespace DAVA
 {
 namespace ParticleEffectSystemDetails
 {
+// fewer effects are updated on the calling thread, job overhead isn't worth it
+const uint32 PARALLEL_UPDATE_MIN_EFFECTS = 16;
+const uint32 PARALLEL_UPDATE_GRAIN_EFFECTS = 4;
+
 Matrix3 GenerateEmitterRotationMatrix(Vector3 vector, float32 power)
 {
     Vector3 axis(vector.y, -vector.x, 0);
@@ -219,6 +224,12 @@ void ParticleEffectSystem::RunEmitter(ParticleEffectComponent* effect, ParticleE
         group.positionSource = positionSource;
         group.loopLayerStartTime = group.layer->startTime;
         group.loopDuration = group.layer->endTime;
+        group.randomSeed = effect->effectData.random.Rand();
+
+        if (layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
+        {
+            layer->UpdateMaxStripeSizeOverLife();
+        }
 
         if (layer->sprite && (layer->type != ParticleLayer::TYPE_SUPEREMITTER_PARTICLES))
         {
@@ -250,6 +261,16 @@ void ParticleEffectSystem::RunEmitter(ParticleEffectComponent* effect, ParticleE
     }
 }
 
+void ParticleEffectSystem::RunPendingEmitters(ParticleEffectComponent* effect)
+{
+    // inner emitters are run in order their particles were generated, so results don't depend on update threads
+    for (const PendingEmitter& pending : effect->effectData.pendingEmitters)
+    {
+        RunEmitter(effect, pending.emitter, Vector3(0, 0, 0), pending.positionSource);
+    }
+    effect->effectData.pendingEmitters.clear();
+}
+
 void ParticleEffectSystem::RunEffect(ParticleEffectComponent* effect)
 {
     if (QualitySettingsSystem::Instance()->IsOptionEnabled(QualitySettingsSystem::QUALITY_OPTION_DISABLE_EFFECTS))
@@ -292,6 +313,7 @@ void ParticleEffectSystem::AddToActive(ParticleEffectComponent* effect)
     {
         //add to active effects and to render
         activeComponents.push_back(effect);
+        effect->effectData.random.Seed(effect->randomSeed);
         for (Map<String, float32>::iterator it = globalExternalValues.begin(), e = globalExternalValues.end(); it != e; ++it)
             effect->SetExtertnalValue((*it).first, (*it).second);
         Scene* scene = GetScene();
@@ -405,10 +427,10 @@ void ParticleEffectSystem::Process(float32 timeElapsed)
     float32 speedMult = 1.0f + (perfSettings->GetPsPerformanceSpeedMult() - 1.0f) * (1 - currPSValue);
     float32 shortEffectTime = timeElapsed * speedMult;
 
-    size_t componentsCount = activeComponents.size();
-    for (size_t i = 0; i < componentsCount; i++)
+    // effects are started on the calling thread, starting adds effect groups and acquires materials
+    updatedEffects.clear();
+    for (ParticleEffectComponent* effect : activeComponents)
     {
-        ParticleEffectComponent* effect = activeComponents[i];
         if (effect->activeLodLevel != effect->desiredLodLevel)
             UpdateActiveLod(effect);
         if (effect->state == ParticleEffectComponent::STATE_STARTING)
@@ -416,9 +438,24 @@ void ParticleEffectSystem::Process(float32 timeElapsed)
             RunEffect(effect);
         }
 
+        if (!effect->isPaused)
+            updatedEffects.push_back(effect);
+    }
+
+    UpdateEffects(updatedEffects, timeElapsed, shortEffectTime);
+
+    for (ParticleEffectComponent* effect : updatedEffects)
+    {
+        RunPendingEmitters(effect);
+    }
+
+    // restarts and stops are applied in order of active effects, however simulation was split between threads
+    size_t componentsCount = activeComponents.size();
+    for (size_t i = 0; i < componentsCount; i++)
+    {
+        ParticleEffectComponent* effect = activeComponents[i];
         if (effect->isPaused)
             continue;
-        UpdateEffect(effect, timeElapsed * effect->playbackSpeed, shortEffectTime * effect->playbackSpeed);
 
         bool effectEnded = effect->stopWhenEmpty ? effect->effectData.groups.empty() : (effect->time > effect->effectDuration);
         if (effectEnded)
@@ -474,42 +511,68 @@ void ParticleEffectSystem::UpdateActiveLod(ParticleEffectComponent* effect)
             ParticleGroup& group = *it;
             if (group.layer->degradeStrategy == ParticleLayer::DEGRADE_REMOVE)
             {
-                Particle* current = group.head;
-                while (current)
-                {
-                    Particle* next = current->next;
-                    delete current;
-                    current = next;
-                }
-                group.head = nullptr;
+                group.particles.Clear();
             }
             else if (group.layer->degradeStrategy == ParticleLayer::DEGRADE_CUT_PARTICLES)
             {
-                Particle* current = group.head;
-                Particle* prev = nullptr;
-                int32 i = 0;
-                while (current)
+                //cut every second particle, all particles in pool are alive between updates, so only cut ones are removed
+                for (uint32 i = 1; i < group.particles.GetSize(); i += 2)
                 {
-                    Particle* next = current->next;
-                    if (i % 2) //cut every second particle
-                    {
-                        delete current;
-                        group.activeParticleCount--;
-                        if (prev)
-                            prev->next = next;
-                        else
-                            group.head = next;
-                    }
-                    prev = current;
-                    current = next;
-                    i++;
+                    group.particles.Kill(i);
                 }
+                group.activeParticleCount -= static_cast<int32>(group.particles.RemoveDead());
             }
         }
     }
 }
 
-void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime)
+void ParticleEffectSystem::UpdateEffects(const Vector<ParticleEffectComponent*>& effects, float32 deltaTime, float32 shortEffectTime)
+{
+    using namespace ParticleEffectSystemDetails;
+
+    uint32 effectsCount = static_cast<uint32>(effects.size());
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (parallelUpdate && jobManager != nullptr && jobManager->GetWorkersCount() > 1 && effectsCount >= PARALLEL_UPDATE_MIN_EFFECTS)
+    {
+        // every effect keeps its bbox, random generator and groups to itself, so effects are updated independently
+        jobManager->ParallelFor(0, effectsCount, PARALLEL_UPDATE_GRAIN_EFFECTS, [&](uint32 begin, uint32 end) {
+            UpdateBuffers* buffers = AcquireUpdateBuffers();
+            for (uint32 i = begin; i < end; ++i)
+            {
+                ParticleEffectComponent* effect = effects[i];
+                UpdateEffect(effect, deltaTime * effect->playbackSpeed, shortEffectTime * effect->playbackSpeed, *buffers);
+            }
+            ReleaseUpdateBuffers(buffers);
+        });
+    }
+    else
+    {
+        for (ParticleEffectComponent* effect : effects)
+        {
+            UpdateEffect(effect, deltaTime * effect->playbackSpeed, shortEffectTime * effect->playbackSpeed, updateBuffers);
+        }
+    }
+}
+
+ParticleEffectSystem::UpdateBuffers* ParticleEffectSystem::AcquireUpdateBuffers()
+{
+    LockGuard<Mutex> lock(workerUpdateBuffersMutex);
+    if (workerUpdateBuffers.empty())
+    {
+        return new UpdateBuffers();
+    }
+    UpdateBuffers* buffers = workerUpdateBuffers.back().release();
+    workerUpdateBuffers.pop_back();
+    return buffers;
+}
+
+void ParticleEffectSystem::ReleaseUpdateBuffers(UpdateBuffers* buffers)
+{
+    LockGuard<Mutex> lock(workerUpdateBuffersMutex);
+    workerUpdateBuffers.emplace_back(buffers);
+}
+
+void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime, UpdateBuffers& buffers)
 {
     effect->time += deltaTime;
     const Matrix4* worldTransformPtr;
@@ -526,8 +589,9 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
 
     AABBox3 bbox;
     List<ParticleGroup>::iterator it = effect->effectData.groups.begin();
-    Random* random = GetEngineContext()->random;
+    ParticlesRandom::Generator& random = effect->effectData.random;
     bool isInverseCalculated = false;
+    Matrix4 invWorld;
     while (it != effect->effectData.groups.end())
     {
         ParticleGroup& group = *it;
@@ -543,22 +607,22 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
         if ((!group.finishingGroup) && (group.layer->isLooped) && (currLoopTime > group.loopDuration)) //restart loop
         {
             group.loopStartTime = group.time;
-            group.loopLayerStartTime = group.layer->deltaTime + group.layer->deltaVariation * static_cast<float32>(random->RandFloat());
-            group.loopDuration = group.loopLayerStartTime + (group.layer->endTime - group.layer->startTime) + group.layer->loopVariation * static_cast<float32>(random->RandFloat());
+            group.loopLayerStartTime = group.layer->deltaTime + group.layer->deltaVariation * random.RandFloat();
+            group.loopDuration = group.loopLayerStartTime + (group.layer->endTime - group.layer->startTime) + group.layer->loopVariation * random.RandFloat();
             currLoopTime = 0;
         }
 
         //prepare forces as they will now actually change in time even for already generated particles
-        static Vector<Vector3> currSimplifiedForceValues;
-        int32 simplifiedForcesCount;
+        Vector<Vector3>& currSimplifiedForceValues = buffers.simplifiedForceValues;
+        int32 simplifiedForcesCount = 0;
 
-        static Vector<ParticleForce*> effectAlignCurrForces;
-        static Vector<ParticleForce*> worldAlignCurrForces;
+        Vector<ParticleForce*>& effectAlignCurrForces = buffers.effectAlignForces;
+        Vector<ParticleForce*>& worldAlignCurrForces = buffers.worldAlignForces;
         uint32 forcesCountWorldAlign = 0;
         uint32 effectAlignForcesCount = 0;
 
-        static Matrix4 invWorld;
-        if (group.head)
+        ParticlePool& particles = group.particles;
+        if (!particles.IsEmpty())
         {
             simplifiedForcesCount = static_cast<int32>(group.layer->GetSimplifiedParticleForces().size());
             if (simplifiedForcesCount)
@@ -578,6 +642,7 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
             {
                 effectAlignCurrForces.resize(allForcesCount);
                 worldAlignCurrForces.resize(allForcesCount);
+                buffers.worldAlignForcePositions.resize(allForcesCount);
                 for (uint32 i = 0; i < allForcesCount; ++i)
                 {
                     DAVA::ParticleForce* currForce = group.layer->GetParticleForces()[i];
@@ -586,7 +651,7 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
 
                     if (currForce->worldAlign)
                     {
-                        currForce->worldPosition = currForce->position + worldTransformPtr->GetTranslationVector(); // Ignore emitter rotation.
+                        buffers.worldAlignForcePositions[forcesCountWorldAlign] = currForce->position + worldTransformPtr->GetTranslationVector(); // Ignore emitter rotation.
                         worldAlignCurrForces[forcesCountWorldAlign] = currForce;
                         ++forcesCountWorldAlign;
                     }
@@ -604,71 +669,64 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
             }
         }
 
-        Particle* current = group.head;
-        Particle* prev = nullptr;
+        ParticleKernels::AdvanceLife(particles, dt, kernelsImplementation);
+        particles.RemoveDead();
 
-        while (current)
+        uint32 particlesCount = particles.GetSize();
+        group.activeParticleCount = static_cast<int32>(particlesCount);
+        if (particlesCount > 0)
         {
-            current->life += dt;
-            if (current->life >= current->lifeTime)
-            {
-                Particle* next = current->next;
-                if (prev == nullptr)
-                    group.head = next;
-                else
-                    prev->next = next;
-                delete current;
-                current = next;
-                continue;
-            }
-            group.activeParticleCount++;
-
-            float32 overLifeTime = current->life / current->lifeTime;
+            buffers.Resize(particlesCount);
+            float32* overLife = buffers.overLife.data();
+            ParticleKernels::ComputeOverLife(particles, overLife, kernelsImplementation);
 
             if (group.layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE)
             {
-                UpdateRegularParticleData(effect, current, group, overLifeTime, simplifiedForcesCount, currSimplifiedForceValues, dt, bbox, effectAlignCurrForces, effectAlignForcesCount, worldAlignCurrForces, forcesCountWorldAlign, *worldTransformPtr, invWorld, currLoopTimeNormalized);
+                UpdateRegularParticlesData(group, buffers, simplifiedForcesCount, dt, effectAlignForcesCount, forcesCountWorldAlign, *worldTransformPtr, invWorld, currLoopTimeNormalized);
             }
 
-            if (group.layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
+            for (uint32 i = 0; i < particlesCount; ++i)
             {
-                effect->effectData.infoSources[current->positionTarget].position = current->position;
-                effect->effectData.infoSources[current->positionTarget].size = current->currSize;
-            }
+                Particle& current = particles.particles[i];
 
-            if (group.layer->enableNoise && group.layer->noise.get() != nullptr)
-            {
-                if (group.layer->noiseScaleOverLife != nullptr)
-                    current->currNoiseScale = current->baseNoiseScale * group.layer->noiseScaleOverLife->GetValue(overLifeTime);
+                if (group.layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
+                {
+                    effect->effectData.infoSources[current.positionTarget].position = particles.GetPosition(i);
+                    effect->effectData.infoSources[current.positionTarget].size = current.currSize;
+                }
 
-                DAVA::float32 overLifeScale = 1.0f;
-                if (group.layer->noiseUScrollSpeedOverLife != nullptr)
+                if (group.layer->enableNoise && group.layer->noise.get() != nullptr)
                 {
-                    overLifeScale = group.layer->noiseUScrollSpeedOverLife->GetValue(overLifeTime);
+                    if (group.layer->noiseScaleOverLife != nullptr)
+                        current.currNoiseScale = current.baseNoiseScale * group.layer->noiseScaleOverLife->GetValue(overLife[i]);
+
+                    DAVA::float32 overLifeScale = 1.0f;
+                    if (group.layer->noiseUScrollSpeedOverLife != nullptr)
+                    {
+                        overLifeScale = group.layer->noiseUScrollSpeedOverLife->GetValue(overLife[i]);
+                    }
+                    current.currNoiseUOffset += current.baseNoiseUScrollSpeed * overLifeScale * deltaTime;
+
+                    overLifeScale = 1.0f;
+                    if (group.layer->noiseVScrollSpeedOverLife != nullptr)
+                    {
+                        overLifeScale = group.layer->noiseVScrollSpeedOverLife->GetValue(overLife[i]);
+                    }
+                    current.currNoiseVOffset += current.baseNoiseVScrollSpeed * overLifeScale * deltaTime;
                 }
-                current->currNoiseUOffset += current->baseNoiseUScrollSpeed * overLifeScale * deltaTime;
 
-                overLifeScale = 1.0f;
-                if (group.layer->noiseVScrollSpeedOverLife != nullptr)
+                if (group.layer->enableAlphaRemap && group.layer->alphaRemapSprite.get() != nullptr && group.layer->alphaRemapOverLife != nullptr)
                 {
-                    overLifeScale = group.layer->noiseVScrollSpeedOverLife->GetValue(overLifeTime);
+                    float32 lookup = overLife[i] * group.layer->alphaRemapLoopCount;
+                    float32 intPart;
+                    current.alphaRemap = group.layer->alphaRemapOverLife->GetValue(modff(lookup, &intPart));
                 }
-                current->currNoiseVOffset += current->baseNoiseVScrollSpeed * overLifeScale * deltaTime;
-            }
 
-            if (group.layer->enableAlphaRemap && group.layer->alphaRemapSprite.get() != nullptr && group.layer->alphaRemapOverLife != nullptr)
-            {
-                float32 lookup = overLifeTime * group.layer->alphaRemapLoopCount;
-                float32 intPart;
-                current->alphaRemap = group.layer->alphaRemapOverLife->GetValue(modff(lookup, &intPart));
+                if (group.layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
+                    UpdateStripe(particles.GetPosition(i), particles.GetSpeed(i), effect->effectData, group, deltaTime, bbox, currSimplifiedForceValues, simplifiedForcesCount, group.layer->IsLodActive(effect->activeLodLevel));
             }
-
-            if (group.layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
-                UpdateStripe(current, effect->effectData, group, deltaTime, bbox, currSimplifiedForceValues, simplifiedForcesCount, group.layer->IsLodActive(effect->activeLodLevel));
-
-            prev = current;
-            current = current->next;
         }
+
         bool allowParticleGeneration = !group.finishingGroup;
         allowParticleGeneration &= (currLoopTime > group.loopLayerStartTime);
         allowParticleGeneration &= group.visibleLod;
@@ -676,13 +734,17 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
         {
             if (group.layer->type == ParticleLayer::TYPE_SINGLE_PARTICLE || group.layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
             {
-                if (!group.head)
+                if (particles.IsEmpty())
                 {
-                    current = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
-                    if (group.layer->GetInheritPosition())
-                        AddParticleToBBox(current->position + effect->effectData.infoSources[group.positionSource].position, current->currRadius, bbox);
-                    else
-                        AddParticleToBBox(current->position, current->currRadius, bbox);
+                    uint32 index = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
+                    if (group.layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
+                    {
+                        // other layers add all particles to bbox below
+                        if (group.layer->GetInheritPosition())
+                            AddParticleToBBox(particles.GetPosition(index) + effect->effectData.infoSources[group.positionSource].position, particles.radius[index], bbox);
+                        else
+                            AddParticleToBBox(particles.GetPosition(index), particles.radius[index], bbox);
+                    }
                 }
             }
             else
@@ -692,23 +754,25 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
                 if (group.layer->number)
                     newParticles = group.layer->number->GetValue(currLoopTime);
                 if (group.layer->numberVariation)
-                    newParticles += group.layer->numberVariation->GetValue(currLoopTime) * static_cast<float32>(random->RandFloat());
+                    newParticles += group.layer->numberVariation->GetValue(currLoopTime) * random.RandFloat();
                 newParticles *= dt;
                 group.particlesToGenerate += newParticles;
 
                 while (group.particlesToGenerate >= 1.0f)
                 {
                     group.particlesToGenerate -= 1.0f;
-                    current = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
-                    if (group.layer->GetInheritPosition())
-                        AddParticleToBBox(current->position + effect->effectData.infoSources[group.positionSource].position, current->currRadius, bbox);
-                    else
-                        AddParticleToBBox(current->position, current->currRadius, bbox);
+                    GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
                 }
             }
         }
 
-        if (group.finishingGroup && (group.head == nullptr))
+        if (group.layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE)
+        {
+            Vector3 offset = group.layer->GetInheritPosition() ? effect->effectData.infoSources[group.positionSource].position : Vector3::Zero;
+            ParticleKernels::AddToBounds(particles, offset, bbox, kernelsImplementation);
+        }
+
+        if (group.finishingGroup && particles.IsEmpty())
         {
             DAVA::SafeRelease(group.emitter);
             DAVA::SafeRelease(group.layer);
@@ -727,12 +791,12 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
     effect->effectRenderObject->SetAABBox(bbox);
 }
 
-void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive)
+void ParticleEffectSystem::UpdateStripe(const Vector3& particlePosition, const Vector3& particleSpeed, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive)
 {
     ParticleLayer* layer = group.layer;
     StripeData& data = group.stripe;
     Vector3 prevBasePosition = data.baseNode.position;
-    data.baseNode.position = particle->position;
+    data.baseNode.position = particlePosition;
     data.isActive = isActive;
 
     if (layer->GetInheritPosition())
@@ -745,11 +809,11 @@ void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData&
         data.baseNode.position = effectData.infoSources[group.positionSource].position;
     }
 
-    data.baseNode.speed = particle->speed;
+    data.baseNode.speed = particleSpeed;
 
     bool shouldInsert = data.stripeNodes.empty() || (data.baseNode.position - data.stripeNodes.front().position).SquareLength() > layer->stripeVertexSpawnStep * layer->stripeVertexSpawnStep;
 
-    float32 radius = layer->stripeStartSize * layer->CalculateMaxStripeSizeOverLife();
+    float32 radius = layer->stripeStartSize * layer->GetMaxStripeSizeOverLife();
 
     if (shouldInsert)
     {
@@ -814,7 +878,7 @@ void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData&
         else
         {
             float32 delta = (data.baseNode.position - prevBasePosition).Length();
-            if (particle->speed.DotProduct(data.baseNode.position - prevBasePosition) <= 0)
+            if (particleSpeed.DotProduct(data.baseNode.position - prevBasePosition) <= 0)
             {
                 data.uvOffset -= delta;
             }
@@ -833,213 +897,277 @@ void ParticleEffectSystem::AddParticleToBBox(const Vector3& position, float radi
     bbox.AddPoint(position + sz);
 }
 
-Particle* ParticleEffectSystem::GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform)
+uint32 ParticleEffectSystem::GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform)
 {
-    Particle* particle = new Particle();
-    particle->life = 0.0f;
+    ParticlePool& particles = group.particles;
+    uint32 index = particles.Add();
+    Particle& particle = particles.particles[index];
+    particle.seed = group.randomSeed + group.particlesGenerated;
+    ParticlesRandom::Generator& random = effect->effectData.random;
 
-    particle->color = Color();
+    particle.color = Color();
     if (group.layer->colorRandom)
     {
-        particle->color = group.layer->colorRandom->GetValue(static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle.color = group.layer->colorRandom->GetValue(random.RandFloat());
     }
     if (group.emitter->colorOverLife)
     {
-        particle->color *= group.emitter->colorOverLife->GetValue(group.time);
+        particle.color *= group.emitter->colorOverLife->GetValue(group.time);
     }
 
-    particle->lifeTime = 0.0f;
+    float32 lifeTime = 0.0f;
     if (group.layer->life)
-        particle->lifeTime += group.layer->life->GetValue(currLoopTime);
+        lifeTime += group.layer->life->GetValue(currLoopTime);
     if (group.layer->lifeVariation)
-        particle->lifeTime += (group.layer->lifeVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        lifeTime += (group.layer->lifeVariation->GetValue(currLoopTime) * random.RandFloat());
 
     // Flow.
-    particle->baseFlowSpeed = 0.0f;
+    particle.baseFlowSpeed = 0.0f;
     if (group.layer->flowSpeed)
-        particle->baseFlowSpeed += group.layer->flowSpeed->GetValue(currLoopTime);
+        particle.baseFlowSpeed += group.layer->flowSpeed->GetValue(currLoopTime);
     if (group.layer->flowSpeedVariation)
-        particle->baseFlowSpeed += (group.layer->flowSpeedVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currFlowSpeed = particle->baseFlowSpeed;
+        particle.baseFlowSpeed += (group.layer->flowSpeedVariation->GetValue(currLoopTime) * random.RandFloat());
+    particle.currFlowSpeed = particle.baseFlowSpeed;
 
-    particle->baseFlowOffset = 0.0f;
+    particle.baseFlowOffset = 0.0f;
     if (group.layer->flowOffset)
-        particle->baseFlowOffset += group.layer->flowOffset->GetValue(currLoopTime);
+        particle.baseFlowOffset += group.layer->flowOffset->GetValue(currLoopTime);
     if (group.layer->flowOffsetVariation)
-        particle->baseFlowOffset += (group.layer->flowOffsetVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currFlowOffset = particle->baseFlowOffset;
+        particle.baseFlowOffset += (group.layer->flowOffsetVariation->GetValue(currLoopTime) * random.RandFloat());
+    particle.currFlowOffset = particle.baseFlowOffset;
 
     // Noise.
-    particle->baseNoiseScale = 0.0f;
+    particle.baseNoiseScale = 0.0f;
     if (group.layer->noiseScale)
-        particle->baseNoiseScale += group.layer->noiseScale->GetValue(currLoopTime);
+        particle.baseNoiseScale += group.layer->noiseScale->GetValue(currLoopTime);
     if (group.layer->noiseScaleVariation)
-        particle->baseNoiseScale += (group.layer->noiseScaleVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currNoiseScale = particle->baseNoiseScale;
+        particle.baseNoiseScale += (group.layer->noiseScaleVariation->GetValue(currLoopTime) * random.RandFloat());
+    particle.currNoiseScale = particle.baseNoiseScale;
 
-    particle->baseNoiseUScrollSpeed = 0.0f;
+    particle.baseNoiseUScrollSpeed = 0.0f;
     if (group.layer->noiseUScrollSpeed)
-        particle->baseNoiseUScrollSpeed += group.layer->noiseUScrollSpeed->GetValue(currLoopTime);
+        particle.baseNoiseUScrollSpeed += group.layer->noiseUScrollSpeed->GetValue(currLoopTime);
     if (group.layer->noiseUScrollSpeedVariation)
-        particle->baseNoiseUScrollSpeed += (group.layer->noiseUScrollSpeedVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currNoiseUOffset = particle->baseNoiseUScrollSpeed;
+        particle.baseNoiseUScrollSpeed += (group.layer->noiseUScrollSpeedVariation->GetValue(currLoopTime) * random.RandFloat());
+    particle.currNoiseUOffset = particle.baseNoiseUScrollSpeed;
 
-    particle->baseNoiseVScrollSpeed = 0.0f;
+    particle.baseNoiseVScrollSpeed = 0.0f;
     if (group.layer->noiseVScrollSpeed)
-        particle->baseNoiseVScrollSpeed += group.layer->noiseVScrollSpeed->GetValue(currLoopTime);
+        particle.baseNoiseVScrollSpeed += group.layer->noiseVScrollSpeed->GetValue(currLoopTime);
     if (group.layer->noiseVScrollSpeedVariation)
-        particle->baseNoiseVScrollSpeed += (group.layer->noiseVScrollSpeedVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currNoiseVOffset = particle->baseNoiseVScrollSpeed;
+        particle.baseNoiseVScrollSpeed += (group.layer->noiseVScrollSpeedVariation->GetValue(currLoopTime) * random.RandFloat());
+    particle.currNoiseVOffset = particle.baseNoiseVScrollSpeed;
 
     // size
-    particle->baseSize = Vector2(1.0f, 1.0f);
+    particle.baseSize = Vector2(1.0f, 1.0f);
     if (group.layer->size)
-        particle->baseSize = group.layer->size->GetValue(currLoopTime);
+        particle.baseSize = group.layer->size->GetValue(currLoopTime);
     if (group.layer->sizeVariation)
-        particle->baseSize += (group.layer->sizeVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->baseSize *= effect->effectData.infoSources[group.positionSource].size;
+        particle.baseSize += (group.layer->sizeVariation->GetValue(currLoopTime) * random.RandFloat());
+    particle.baseSize *= effect->effectData.infoSources[group.positionSource].size;
 
-    particle->currSize = particle->baseSize;
+    particle.currSize = particle.baseSize;
     if (group.layer->sizeOverLifeXY)
-        particle->currSize *= group.layer->sizeOverLifeXY->GetValue(0);
-    Vector2 pivotSize = particle->currSize * group.layer->layerPivotSizeOffsets;
-    particle->currRadius = pivotSize.Length();
+        particle.currSize *= group.layer->sizeOverLifeXY->GetValue(0);
+    Vector2 pivotSize = particle.currSize * group.layer->layerPivotSizeOffsets;
+    float32 radius = pivotSize.Length();
 
-    particle->angle = 0.0f;
-    particle->spin = 0.0f;
+    float32 angle = 0.0f;
+    float32 spin = 0.0f;
     if (group.layer->angle)
-        particle->angle = DegToRad(group.layer->angle->GetValue(currLoopTime));
+        angle = DegToRad(group.layer->angle->GetValue(currLoopTime));
     if (group.layer->angleVariation)
-        particle->angle += DegToRad(group.layer->angleVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        angle += DegToRad(group.layer->angleVariation->GetValue(currLoopTime) * random.RandFloat());
     if (group.layer->spin)
-        particle->spin = DegToRad(group.layer->spin->GetValue(currLoopTime));
+        spin = DegToRad(group.layer->spin->GetValue(currLoopTime));
     if (group.layer->spinVariation)
-        particle->spin += DegToRad(group.layer->spinVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        spin += DegToRad(group.layer->spinVariation->GetValue(currLoopTime) * random.RandFloat());
     if (group.layer->randomSpinDirection)
     {
-        int32 dir = Rand() & 1;
-        particle->spin *= (dir)*2 - 1;
+        int32 dir = random.Rand() & 1;
+        spin *= (dir)*2 - 1;
     }
-    particle->frame = 0;
-    particle->animTime = 0;
+    particle.frame = 0;
+    particle.animTime = 0;
     if (group.layer->randomFrameOnStart && group.layer->sprite)
     {
-        particle->frame = static_cast<int32>(static_cast<float32>(GetEngineContext()->random->RandFloat()) * static_cast<float32>(group.layer->sprite->GetFrameCount()));
+        particle.frame = static_cast<int32>(random.RandFloat() * static_cast<float32>(group.layer->sprite->GetFrameCount()));
     }
 
-    PrepareEmitterParameters(particle, group, worldTransform);
+    Vector3 position;
+    Vector3 speed;
+    PrepareEmitterParameters(position, speed, group, worldTransform, random);
 
     float32 vel = 0.0f;
     if (group.layer->velocity)
         vel += group.layer->velocity->GetValue(currLoopTime);
     if (group.layer->velocityVariation)
-        vel += (group.layer->velocityVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->speed *= vel;
+        vel += (group.layer->velocityVariation->GetValue(currLoopTime) * random.RandFloat());
+    speed *= vel;
 
     if (!group.layer->GetInheritPosition()) //just generate at correct position
     {
-        particle->position += effect->effectData.infoSources[group.positionSource].position;
+        position += effect->effectData.infoSources[group.positionSource].position;
     }
 
-    particle->next = group.head;
-    group.head = particle;
+    particles.lifeTime[index] = lifeTime;
+    particles.SetPosition(index, position);
+    particles.SetSpeed(index, speed);
+    particles.angle[index] = angle;
+    particles.spin[index] = spin;
+    particles.radius[index] = radius;
     group.activeParticleCount++;
     if (group.layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
     {
         ParentInfo info;
-        info.position = particle->position;
-        info.size = particle->currSize;
+        info.position = position;
+        info.size = particle.currSize;
         effect->effectData.infoSources.push_back(info);
-        particle->positionTarget = static_cast<int32>(effect->effectData.infoSources.size() - 1);
+        particle.positionTarget = static_cast<int32>(effect->effectData.infoSources.size() - 1);
         ParticleEmitter* innerEmitter = group.layer->innerEmitter->GetEmitter();
         if (innerEmitter)
-            RunEmitter(effect, innerEmitter, Vector3(0, 0, 0), particle->positionTarget);
+        {
+            PendingEmitter pending;
+            pending.emitter = innerEmitter;
+            pending.positionSource = particle.positionTarget;
+            effect->effectData.pendingEmitters.push_back(pending);
+        }
     }
 
     group.particlesGenerated++;
-    return particle;
+    return index;
 }
 
-void ParticleEffectSystem::UpdateRegularParticleData(ParticleEffectComponent* effect, Particle* particle, const ParticleGroup& group, float32 overLife, int32 simplifiedForcesCount, Vector<Vector3>& currSimplifiedForceValues, float32 dt, AABBox3& bbox, const Vector<ParticleForce*>& effectAlignForces, uint32 effectAlignForcesCount, const Vector<ParticleForce*>& worldAlignForces, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife)
+void ParticleEffectSystem::UpdateRegularParticlesData(ParticleGroup& group, UpdateBuffers& buffers, int32 simplifiedForcesCount, float32 dt, uint32 effectAlignForcesCount, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife)
 {
-    float32 currVelocityOverLife = 1.0f;
-    if (group.layer->velocityOverLife)
-        currVelocityOverLife = group.layer->velocityOverLife->GetValue(overLife);
-    Vector3 prevParticlePosition = particle->position;
-    particle->position += particle->speed * (currVelocityOverLife * dt);
+    ParticlePool& particles = group.particles;
+    ParticleLayer* layer = group.layer;
+    uint32 count = particles.GetSize();
+    const float32* overLife = buffers.overLife.data();
+    const Vector<Vector3>& currSimplifiedForceValues = buffers.simplifiedForceValues;
+    const Vector<ParticleForce*>& effectAlignForces = buffers.effectAlignForces;
+    const Vector<ParticleForce*>& worldAlignForces = buffers.worldAlignForces;
+
+    // prepare per-particle scales of property lines, then run batch kernels over the whole group
+    float32* velocityScale = buffers.velocityScale.data();
+    float32* spinScale = buffers.spinScale.data();
+    ParticleKernels::SampleLine(layer->velocityOverLife.Get(), overLife, count, velocityScale);
+    ParticleKernels::SampleLine(layer->spinOverLife.Get(), overLife, count, spinScale);
+
+    bool applyForces = (worldAlignForcesCount > 0) || (effectAlignForcesCount > 0) || layer->applyGlobalForces;
+    if (applyForces)
+    {
+        std::copy(particles.positionX.begin(), particles.positionX.begin() + count, buffers.prevPositionX.begin());
+        std::copy(particles.positionY.begin(), particles.positionY.begin() + count, buffers.prevPositionY.begin());
+        std::copy(particles.positionZ.begin(), particles.positionZ.begin() + count, buffers.prevPositionZ.begin());
+    }
 
-    float32 currSpinOverLife = 1.0f;
-    if (group.layer->spinOverLife)
-        currSpinOverLife = group.layer->spinOverLife->GetValue(overLife);
-    particle->angle += particle->spin * currSpinOverLife * dt;
+    ParticleKernels::Integrate(particles, velocityScale, spinScale, dt, kernelsImplementation);
 
-    Vector3 acceleration(0.0f, 0.0f, 0.0f);
-    for (int32 i = 0; i < simplifiedForcesCount; ++i)
+    if (simplifiedForcesCount > 0)
     {
-        acceleration += (group.layer->GetSimplifiedParticleForces()[i]->forceOverLife) ? (currSimplifiedForceValues[i] * group.layer->GetSimplifiedParticleForces()[i]->forceOverLife->GetValue(overLife)) : currSimplifiedForceValues[i];
-    }
+        std::fill(buffers.accelerationX.begin(), buffers.accelerationX.begin() + count, 0.0f);
+        std::fill(buffers.accelerationY.begin(), buffers.accelerationY.begin() + count, 0.0f);
+        std::fill(buffers.accelerationZ.begin(), buffers.accelerationZ.begin() + count, 0.0f);
 
-    for (uint32 i = 0; i < worldAlignForcesCount; ++i)
-        ParticleForces::ApplyForce(worldAlignForces[i], particle->speed, particle->position, dt, overLife, layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particle, prevParticlePosition, worldAlignForces[i]->worldPosition);
+        float32* forceScale = buffers.forceScale.data();
+        for (int32 i = 0; i < simplifiedForcesCount; ++i)
+        {
+            ParticleKernels::SampleLine(layer->GetSimplifiedParticleForces()[i]->forceOverLife.Get(), overLife, count, forceScale);
+            ParticleKernels::AccumulateForce(currSimplifiedForceValues[i], forceScale, count, buffers.accelerationX.data(), buffers.accelerationY.data(), buffers.accelerationZ.data(), kernelsImplementation);
+        }
+    }
 
-    if (effectAlignForcesCount > 0)
+    // forces with shapes, collisions and noise stay per-particle
+    if (applyForces)
     {
-        Vector3 effectSpacePosition;
-        Vector3 prevEffectSpacePosition;
-        Vector3 effectSpaceSpeed;
-        effectSpacePosition = particle->position * invWorld;
-        effectSpaceSpeed = particle->speed * Matrix3(invWorld);
-        if (group.layer->GetPlaneCollisiontForcesCount() > 0)
-            prevEffectSpacePosition = prevParticlePosition * invWorld;
+        for (uint32 p = 0; p < count; ++p)
+        {
+            Vector3 prevParticlePosition(buffers.prevPositionX[p], buffers.prevPositionY[p], buffers.prevPositionZ[p]);
+            Vector3 position = particles.GetPosition(p);
+            Vector3 speed = particles.GetSpeed(p);
 
-        for (uint32 i = 0; i < effectAlignForcesCount; ++i)
-            ParticleForces::ApplyForce(effectAlignForces[i], effectSpaceSpeed, effectSpacePosition, dt, overLife, layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particle, prevEffectSpacePosition, effectAlignForces[i]->position);
+            for (uint32 i = 0; i < worldAlignForcesCount; ++i)
+                ParticleForces::ApplyForce(worldAlignForces[i], speed, position, dt, overLife[p], layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particles, p, prevParticlePosition, buffers.worldAlignForcePositions[i]);
 
-        particle->speed = effectSpaceSpeed * Matrix3(world);
-        if (group.layer->GetAlterPositionForcesCount() > 0)
-            particle->position = effectSpacePosition * world;
-    }
+            if (effectAlignForcesCount > 0)
+            {
+                Vector3 effectSpacePosition;
+                Vector3 prevEffectSpacePosition;
+                Vector3 effectSpaceSpeed;
+                effectSpacePosition = position * invWorld;
+                effectSpaceSpeed = speed * Matrix3(invWorld);
+                if (layer->GetPlaneCollisiontForcesCount() > 0)
+                    prevEffectSpacePosition = prevParticlePosition * invWorld;
+
+                for (uint32 i = 0; i < effectAlignForcesCount; ++i)
+                    ParticleForces::ApplyForce(effectAlignForces[i], effectSpaceSpeed, effectSpacePosition, dt, overLife[p], layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particles, p, prevEffectSpacePosition, effectAlignForces[i]->position);
+
+                speed = effectSpaceSpeed * Matrix3(world);
+                if (layer->GetAlterPositionForcesCount() > 0)
+                    position = effectSpacePosition * world;
+            }
 
-    if (group.layer->applyGlobalForces)
-        ApplyGlobalForces(particle, dt, overLife, layerOverLife, prevParticlePosition);
+            particles.SetPosition(p, position);
+            particles.SetSpeed(p, speed);
 
-    particle->speed += acceleration * dt;
+            if (layer->applyGlobalForces)
+                ApplyGlobalForces(particles, p, dt, overLife[p], layerOverLife, prevParticlePosition);
+        }
+    }
 
-    if (group.layer->sizeOverLifeXY)
+    if (simplifiedForcesCount > 0)
     {
-        particle->currSize = particle->baseSize * group.layer->sizeOverLifeXY->GetValue(overLife);
-        Vector2 pivotSize = particle->currSize * group.layer->layerPivotSizeOffsets;
-        particle->currRadius = pivotSize.Length();
+        ParticleKernels::Accelerate(particles, buffers.accelerationX.data(), buffers.accelerationY.data(), buffers.accelerationZ.data(), dt, kernelsImplementation);
     }
-    if (group.layer->GetInheritPosition())
-        AddParticleToBBox(particle->position + effect->effectData.infoSources[group.positionSource].position, particle->currRadius, bbox);
-    else
-        AddParticleToBBox(particle->position, particle->currRadius, bbox);
 
-    if (group.layer->frameOverLifeEnabled && group.layer->sprite)
+    if (layer->sizeOverLifeXY)
     {
-        float32 animDelta = group.layer->frameOverLifeFPS;
-        if (group.layer->animSpeedOverLife)
-            animDelta *= group.layer->animSpeedOverLife->GetValue(overLife);
-        particle->animTime += animDelta * dt;
+        Vector2* sizeOverLife = buffers.sizeOverLife.data();
+        layer->sizeOverLifeXY->GetValues(overLife, sizeOverLife, count);
+        for (uint32 p = 0; p < count; ++p)
+        {
+            Particle& particle = particles.particles[p];
+            particle.currSize = particle.baseSize * sizeOverLife[p];
+            Vector2 pivotSize = particle.currSize * layer->layerPivotSizeOffsets;
+            particles.radius[p] = pivotSize.Length();
+        }
+    }
 
-        while (particle->animTime > 1.0f)
+    if (layer->frameOverLifeEnabled && layer->sprite)
+    {
+        float32* animSpeedScale = buffers.animSpeedScale.data();
+        if (layer->animSpeedOverLife)
+            layer->animSpeedOverLife->GetValues(overLife, animSpeedScale, count);
+
+        for (uint32 p = 0; p < count; ++p)
         {
-            particle->frame++;
-            particle->animTime -= 1.0f;
-            if (particle->frame >= group.layer->sprite->GetFrameCount())
+            Particle& particle = particles.particles[p];
+            float32 animDelta = layer->frameOverLifeFPS;
+            if (layer->animSpeedOverLife)
+                animDelta *= animSpeedScale[p];
+            particle.animTime += animDelta * dt;
+
+            while (particle.animTime > 1.0f)
             {
-                if (group.layer->loopSpriteAnimation)
-                    particle->frame = 0;
-                else
-                    particle->frame = group.layer->sprite->GetFrameCount() - 1;
+                particle.frame++;
+                particle.animTime -= 1.0f;
+                if (particle.frame >= layer->sprite->GetFrameCount())
+                {
+                    if (layer->loopSpriteAnimation)
+                        particle.frame = 0;
+                    else
+                        particle.frame = layer->sprite->GetFrameCount() - 1;
+                }
             }
         }
     }
 }
 
-void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, float32 overLife, float32 layerOverLife, Vector3 prevParticlePosition)
+void ParticleEffectSystem::ApplyGlobalForces(ParticlePool& particles, uint32 index, float32 dt, float32 overLife, float32 layerOverLife, Vector3 prevParticlePosition)
 {
+    Vector3 position = particles.GetPosition(index);
+    Vector3 speed = particles.GetSpeed(index);
     for (auto& forcePair : globalForces)
     {
         ParticleEffectComponent* effect = forcePair.first;
@@ -1049,8 +1177,8 @@ void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, flo
         for (ParticleForce* force : forcePair.second.worldAlignForces)
         {
             Vector3 forceWorldPosition = worldTransformPtr->GetTranslationVector() + force->position;
-            if (force->isInfinityRange || (forceWorldPosition - particle->position).SquareLength() < force->GetSquaredRadius())
-                ParticleForces::ApplyForce(force, particle->speed, particle->position, dt, overLife, layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particle, prevParticlePosition, forceWorldPosition);
+            if (force->isInfinityRange || (forceWorldPosition - position).SquareLength() < force->GetSquaredRadius())
+                ParticleForces::ApplyForce(force, speed, position, dt, overLife, layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particles, index, prevParticlePosition, forceWorldPosition);
         }
 
         if (!forcePair.second.effectAlignForces.empty())
@@ -1064,7 +1192,7 @@ void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, flo
                     break;
                 }
                 Vector3 forceWorldPosition = worldTransformPtr->GetTranslationVector() + force->position; // Do not rotate global forces if force position is not zero.
-                float32 sqrDist = (forceWorldPosition - particle->position).SquareLength();
+                float32 sqrDist = (forceWorldPosition - position).SquareLength();
                 if (sqrDist < force->GetSquaredRadius())
                 {
                     inForceBoundingSphere = true;
@@ -1076,29 +1204,29 @@ void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, flo
 
             Matrix4 invWorld = GetInverseWithRemovedScale(*worldTransformPtr);
 
-            Vector3 effectSpacePosition = particle->position * invWorld;
+            Vector3 effectSpacePosition = position * invWorld;
             Vector3 prevEffectSpacePosition = prevParticlePosition * invWorld;
-            Vector3 effectSpaceSpeed = particle->speed * Matrix3(invWorld);
+            Vector3 effectSpaceSpeed = speed * Matrix3(invWorld);
             bool transformPosition = false;
             for (ParticleForce* force : forcePair.second.effectAlignForces)
             {
                 if (force->CanAlterPosition())
                     transformPosition = true;
-                ParticleForces::ApplyForce(force, effectSpaceSpeed, effectSpacePosition, dt, overLife, layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particle, prevEffectSpacePosition, force->position);
+                ParticleForces::ApplyForce(force, effectSpaceSpeed, effectSpacePosition, dt, overLife, layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particles, index, prevEffectSpacePosition, force->position);
             }
-            particle->speed = effectSpaceSpeed * Matrix3(*worldTransformPtr);
+            speed = effectSpaceSpeed * Matrix3(*worldTransformPtr);
             if (transformPosition)
-                particle->position = effectSpacePosition * (*worldTransformPtr);
+                position = effectSpacePosition * (*worldTransformPtr);
         }
     }
+    particles.SetPosition(index, position);
+    particles.SetSpeed(index, speed);
 }
 
-void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, ParticleGroup& group, const Matrix4& worldTransform)
+void ParticleEffectSystem::PrepareEmitterParameters(Vector3& position, Vector3& speed, ParticleGroup& group, const Matrix4& worldTransform, ParticlesRandom::Generator& random)
 {
     //calculate position new particle position in emitter space (for point leave it V3(0,0,0))
-    uintptr_t uptr = reinterpret_cast<uintptr_t>(&group);
-    uint32 offset = static_cast<uint32>(uptr);
-    uint32 ind = group.particlesGenerated + offset;
+    uint32 ind = group.particlesGenerated + group.randomSeed;
 
     bool isCircleEmitter = group.emitter->emitterType == ParticleEmitter::EMITTER_ONCIRCLE_VOLUME || group.emitter->emitterType == ParticleEmitter::EMITTER_ONCIRCLE_EDGES;
     bool isSphereEmitter = group.emitter->emitterType == ParticleEmitter::EMITTER_SPHERE;
@@ -1109,7 +1237,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         if (group.emitter->size)
         {
             Vector3 currSize = group.emitter->size->GetValue(group.time);
-            particle->position = Vector3(currSize.x * (ParticlesRandom::VanDerCorputRnd(ind, 3) - 0.5f), currSize.y * (ParticlesRandom::VanDerCorputRnd(ind, 2) - 0.5f), currSize.z * (ParticlesRandom::VanDerCorputRnd(ind, 5) - 0.5f));
+            position = Vector3(currSize.x * (ParticlesRandom::VanDerCorputRnd(ind, 3) - 0.5f), currSize.y * (ParticlesRandom::VanDerCorputRnd(ind, 2) - 0.5f), currSize.z * (ParticlesRandom::VanDerCorputRnd(ind, 5) - 0.5f));
         }
     }
     else if (isCircleEmitter)
@@ -1128,13 +1256,13 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         float32 curAngle = angleBase + angleVariation * ParticlesRandom::VanDerCorputRnd(ind, 3);
         if (group.emitter->emitterType == ParticleEmitter::EMITTER_ONCIRCLE_VOLUME)
         {
-            float32 rndRadiusNorm = std::sqrt(static_cast<float32>(GetEngineContext()->random->RandFloat())); // Better distribution on circle.
+            float32 rndRadiusNorm = std::sqrt(random.RandFloat()); // Better distribution on circle.
             curRadius = Lerp(innerRadius, curRadius, rndRadiusNorm);
         }
         float32 sinAngle = 0.0f;
         float32 cosAngle = 0.0f;
         SinCosFast(curAngle, sinAngle, cosAngle);
-        particle->position = Vector3(curRadius * cosAngle, curRadius * sinAngle, 0.0f);
+        position = Vector3(curRadius * cosAngle, curRadius * sinAngle, 0.0f);
     }
     else if (isSphereEmitter)
     {
@@ -1148,7 +1276,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         float32 phi = std::acos(2.0f * v - 1.0f);
         if (!group.emitter->generateOnSurface)
         {
-            float32 rndRadiusNorm = std::sqrt(static_cast<float32>(GetEngineContext()->random->RandFloat())); // Better distribution on circle.
+            float32 rndRadiusNorm = std::sqrt(random.RandFloat()); // Better distribution on circle.
             curRadius = Lerp(innerRadius, curRadius, rndRadiusNorm);
         }
         float32 cosPhi = 0.0f;
@@ -1159,7 +1287,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         float32 x = radTimesSinTheta * cosPhi;
         float32 y = radTimesSinTheta * sinPhi;
         float32 z = curRadius * std::cos(theta);
-        particle->position = Vector3(x, y, z);
+        position = Vector3(x, y, z);
     }
 
     //current emission vector and it's length
@@ -1180,11 +1308,11 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
     if ((isCircleEmitter && group.emitter->shockwaveMode != ParticleEmitter::SHOCKWAVE_DISABLED)
         || (isSphereEmitter && group.emitter->shockwaveMode == ParticleEmitter::SHOCKWAVE_NORMAL))
     {
-        particle->speed = particle->position;
-        float32 spl = particle->speed.SquareLength();
+        speed = position;
+        float32 spl = speed.SquareLength();
         if (spl > EPSILON)
         {
-            particle->speed *= currVelPower / std::sqrt(spl);
+            speed *= currVelPower / std::sqrt(spl);
         }
     }
     else if (isSphereEmitter && group.emitter->shockwaveMode == ParticleEmitter::SHOCKWAVE_HORIZONTAL)
@@ -1202,7 +1330,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         else
             sinTheta = 1.0f; // theta = pi * 0.5
 
-        float32 phi = static_cast<float32>(GetEngineContext()->random->RandFloat()) * PI_2;
+        float32 phi = random.RandFloat() * PI_2;
         float32 cosPhi = 0.0f;
         float32 sinPhi = 0.0f;
         SinCosFast(phi, sinPhi, cosPhi);
@@ -1210,7 +1338,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         Vector3 newVel;
         newVel = Vector3(cosPhi * sinTheta, sinPhi * sinTheta, cosTheta);
         newVel *= currVelPower;
-        particle->speed = newVel;
+        speed = newVel;
     }
     else
     {
@@ -1219,10 +1347,10 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
             float32 theta = ParticlesRandom::VanDerCorputRnd(ind, 3) * DegToRad(group.emitter->emissionRange->GetValue(group.time)) * 0.5f;
             float32 phi = ParticlesRandom::VanDerCorputRnd(ind, 4) * PI_2;
             float32 sinTheta = std::sin(theta);
-            particle->speed = Vector3(currVelPower * std::cos(phi) * sinTheta, currVelPower * std::sin(phi) * sinTheta, currVelPower * std::cos(theta));
+            speed = Vector3(currVelPower * std::cos(phi) * sinTheta, currVelPower * std::sin(phi) * sinTheta, currVelPower * std::cos(theta));
         }
         else
-            particle->speed = Vector3(0, 0, currVelPower);
+            speed = Vector3(0, 0, currVelPower);
     }
 
     //now transform position and speed by emissionVector and worldTransfrom rotations - preserving length
@@ -1233,19 +1361,19 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
     {
         if (currEmissionVector.z < 0)
         {
-            particle->position = particle->position * PIRotationAroundX;
+            position = position * PIRotationAroundX;
 
             if (!hasCustomEmissionVector)
-                particle->speed = particle->speed * PIRotationAroundX;
+                speed = speed * PIRotationAroundX;
         }
     }
     else
     {
         Matrix3 rotation = ParticleEffectSystemDetails::GenerateEmitterRotationMatrix(currEmissionVector, currEmissionPower);
-        particle->position = particle->position * rotation;
+        position = position * rotation;
 
         if (!hasCustomEmissionVector)
-            particle->speed = particle->speed * rotation;
+            speed = speed * rotation;
     }
 
     if (hasCustomEmissionVector)
@@ -1253,16 +1381,35 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         if ((std::abs(currVelVector.x) < EPSILON) && (std::abs(currVelVector.y) < EPSILON))
         {
             if (currVelVector.z < 0)
-                particle->speed = particle->speed * PIRotationAroundX;
+                speed = speed * PIRotationAroundX;
         }
         else
         {
-            particle->speed = particle->speed * ParticleEffectSystemDetails::GenerateEmitterRotationMatrix(currVelVector, currVelPower);
+            speed = speed * ParticleEffectSystemDetails::GenerateEmitterRotationMatrix(currVelVector, currVelPower);
         }
     }
-    particle->position += group.spawnPosition;
-    TransformPerserveLength(particle->speed, newTransform);
-    TransformPerserveLength(particle->position, newTransform); //note - from now emitter position is not effected by scale anymore (artist request)
+    position += group.spawnPosition;
+    TransformPerserveLength(speed, newTransform);
+    TransformPerserveLength(position, newTransform); //note - from now emitter position is not effected by scale anymore (artist request)
+}
+
+void ParticleEffectSystem::UpdateBuffers::Resize(uint32 count)
+{
+    if (overLife.size() < count)
+    {
+        overLife.resize(count);
+        velocityScale.resize(count);
+        spinScale.resize(count);
+        forceScale.resize(count);
+        accelerationX.resize(count);
+        accelerationY.resize(count);
+        accelerationZ.resize(count);
+        prevPositionX.resize(count);
+        prevPositionY.resize(count);
+        prevPositionZ.resize(count);
+        animSpeedScale.resize(count);
+        sizeOverLife.resize(count);
+    }
 }
 
 void ParticleEffectSystem::SetGlobalExtertnalValue(const String& name, float32 value)
@@ -1292,7 +1439,10 @@ void ParticleEffectSystem::SimulateEffect(ParticleEffectComponent* effect)
     static const float32 delta = 0.0333f;
     uint32 frames = static_cast<uint32>(effect->GetStartFromTime() * particleSystemFps);
     for (uint32 i = 0; i < frames; ++i)
-        UpdateEffect(effect, delta, delta);
+    {
+        UpdateEffect(effect, delta, delta, updateBuffers);
+        RunPendingEmitters(effect);
+    }
 }
 
 void ParticleEffectSystem::ExtractGlobalForces(ParticleEffectComponent* effect)
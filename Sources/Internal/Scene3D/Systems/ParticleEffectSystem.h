@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Base/BaseTypes.h"
+#include "Concurrency/Mutex.h"
 #include "Entity/SceneSystem.h"
+#include "Particles/ParticleKernels.h"
 #include "Scene3D/Components/ParticleEffectComponent.h"
 
 namespace DAVA
@@ -178,6 +180,31 @@ public:
      */
     inline bool GetAllowLodDegrade() const;
 
+    /**
+     * @brief Sets implementation of batch kernels used to update particles
+     * @param[in] implementation Kernels implementation, must be available for current target
+     * @details All implementations produce the same results, scalar one is useful for comparison and debugging.
+     */
+    inline void SetKernelsImplementation(ParticleKernels::eImplementation implementation);
+    /**
+     * @brief Gets implementation of batch kernels used to update particles
+     * @return Current kernels implementation, the best available one by default
+     */
+    inline ParticleKernels::eImplementation GetKernelsImplementation() const;
+
+    /**
+     * @brief Sets whether effects are simulated on JobManager worker threads
+     * @param[in] parallel If true, active effects are split into ranges updated by workers, otherwise all effects are updated on the calling thread
+     * @details Every effect is still updated by a single thread and has its own random generator,
+     *          so results don't depend on this setting. Enabled by default.
+     */
+    inline void SetParallelUpdate(bool parallel);
+    /**
+     * @brief Gets whether effects are simulated on JobManager worker threads
+     * @return true if parallel update is enabled, false otherwise
+     */
+    inline bool GetParallelUpdate() const;
+
     /**
      * @brief Returns a reference to the vector containing pairs of MaterialData and corresponding NMaterial instances
      * @return Const reference to vector of pairs containing MaterialData and corresponding NMaterial pointers
@@ -193,6 +220,31 @@ public:
     void PrebuildMaterials(ParticleEffectComponent* component);
 
 protected:
+    /** Per-particle temporary arrays of the group being updated and per-group force lists, kept between updates to avoid allocations.
+        Every thread updating effects uses its own set. */
+    struct UpdateBuffers
+    {
+        Vector<float32> overLife;
+        Vector<float32> velocityScale;
+        Vector<float32> spinScale;
+        Vector<float32> forceScale;
+        Vector<float32> accelerationX;
+        Vector<float32> accelerationY;
+        Vector<float32> accelerationZ;
+        Vector<float32> prevPositionX;
+        Vector<float32> prevPositionY;
+        Vector<float32> prevPositionZ;
+        Vector<float32> animSpeedScale;
+        Vector<Vector2> sizeOverLife;
+
+        Vector<Vector3> simplifiedForceValues;
+        Vector<ParticleForce*> effectAlignForces;
+        Vector<ParticleForce*> worldAlignForces;
+        Vector<Vector3> worldAlignForcePositions;
+
+        void Resize(uint32 count);
+    };
+
     /**
      * @brief Run particle effect
      * @param effect Effect component to run
@@ -218,54 +270,58 @@ protected:
      * based on current viewing conditions (like distance from camera, performance settings, etc.)
      */
     void UpdateActiveLod(ParticleEffectComponent* effect);
+    /**
+     * @brief Updates given effects, split into ranges between worker threads if parallel update is enabled
+     * @param effects Effects to update, every effect is updated by exactly one thread
+     * @param deltaTime Time elapsed since the last update in seconds, before applying playback speed of effects
+     * @param shortEffectTime Time threshold for short-living effects optimization, before applying playback speed of effects
+     */
+    void UpdateEffects(const Vector<ParticleEffectComponent*>& effects, float32 deltaTime, float32 shortEffectTime);
     /**
      * Updates the particle effect state.
      * @param effect The particle effect component to update
      * @param deltaTime Time elapsed since the last update in seconds
      * @param shortEffectTime Time threshold for short-living effects optimization
+     * @param buffers Temporary arrays owned by the calling thread
      */
-    void UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime);
+    void UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime, UpdateBuffers& buffers);
     /**
      * @brief Generates a new particle in the specified particle effect group
      * @param effect Pointer to the particle effect component that owns the particle
      * @param group Reference to the particle group where the new particle will be created
      * @param currLoopTime Current time within the effect's loop cycle
      * @param worldTransform World transformation matrix for positioning the particle
-     * @return Pointer to the newly generated particle, or nullptr if generation fails
+     * @return Index of the newly generated particle in the group's particle pool
      */
-    Particle* GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform);
+    uint32 GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform);
     /**
-     * @brief Updates the data for a regular particle within a particle effect system
-     * @param effect Pointer to the particle effect component being updated
-     * @param particle Pointer to the particle being updated
-     * @param group The particle group containing parameters for the particle
-     * @param overLife Current life progress of the particle (0.0 to 1.0)
-     * @param simplifiedForcesCount Number of simplified forces affecting the particle
-     * @param currSimplifiedForceValues Vector containing current values of simplified forces
+     * @brief Updates all regular (non-stripe) particles of the group with batch kernels
+     * @param group The particle group which particles are updated
+     * @param buffers Temporary arrays with life progress of every particle, current values of simplified forces and lists of forces
+     * @param simplifiedForcesCount Number of simplified forces affecting the particles
      * @param dt Delta time for the current update
-     * @param bbox Reference to the bounding box to be updated with particle position
-     * @param effectAlignForces Vector of forces aligned to the effect's coordinate system
-     * @param effectAlignForcesCount Number of effect-aligned forces
-     * @param worldAlignForces Vector of forces aligned to the world coordinate system
-     * @param worldAlignForcesCount Number of world-aligned forces
+     * @param effectAlignForcesCount Number of effect-aligned forces in `buffers`
+     * @param worldAlignForcesCount Number of world-aligned forces in `buffers`
      * @param world World transformation matrix
      * @param invWorld Inverse world transformation matrix
      * @param layerOverLife Current life progress of the particle layer (0.0 to 1.0)
      */
-    void UpdateRegularParticleData(ParticleEffectComponent* effect, Particle* particle, const ParticleGroup& group, float32 overLife, int32 simplifiedForcesCount, Vector<Vector3>& currSimplifiedForceValues, float32 dt, AABBox3& bbox, const Vector<ParticleForce*>& effectAlignForces, uint32 effectAlignForcesCount, const Vector<ParticleForce*>& worldAlignForces, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife);
+    void UpdateRegularParticlesData(ParticleGroup& group, UpdateBuffers& buffers, int32 simplifiedForcesCount, float32 dt, uint32 effectAlignForcesCount, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife);
 
     /**
      * @brief Prepares parameters for a particle emitter based on given particle, group, and transformation.
      * 
-     * @param particle Pointer to the particle instance that needs parameter preparation
+     * @param[out] position Position of the new particle
+     * @param[out] speed Speed of the new particle
      * @param group Reference to the particle group containing emission settings and properties
      * @param worldTransform Matrix representing the world transformation for particle positioning
+     * @param random Random generator of the effect owning the group
      * 
      * @details This function sets up necessary parameters for particle emission, including
      * position, orientation, and other emission-related properties based on the provided
      * world transformation and group settings.
      */
-    void PrepareEmitterParameters(Particle* particle, ParticleGroup& group, const Matrix4& worldTransform);
+    void PrepareEmitterParameters(Vector3& position, Vector3& speed, ParticleGroup& group, const Matrix4& worldTransform, ParticlesRandom::Generator& random);
     /**
      * @brief Extends the given bounding box to include a particle's sphere volume
      * @param[in] position The center position of the particle in 3D space
@@ -284,19 +340,29 @@ protected:
      */
     void RunEmitter(ParticleEffectComponent* effect, ParticleEmitter* emitter, const Vector3& spawnPosition, int32 positionSource = 0);
 
+    /**
+     * @brief Runs inner emitters of superemitter particles generated by the last update of the effect
+     * @param effect The particle effect component which pending emitters are run
+     * @details Running emitter adds groups to the effect and acquires shared materials, so update jobs only queue
+     *          emitters and this function is called on the calling thread after the update.
+     */
+    void RunPendingEmitters(ParticleEffectComponent* effect);
+
 private:
     /**
      * @brief Applies global forces to a particle during its lifetime
-     * @param particle Pointer to the particle to apply forces to
+     * @param particles Pool containing the particle
+     * @param index Index of the particle in the pool
      * @param dt Time delta since last update
      * @param overLife Current normalized lifetime of the particle (0.0 to 1.0)
      * @param layerOverLife Current normalized lifetime of the layer containing the particle (0.0 to 1.0)
      * @param prevParticlePosition Previous position of the particle in world space
      */
-    void ApplyGlobalForces(Particle* particle, float32 dt, float32 overLife, float32 layerOverLife, Vector3 prevParticlePosition);
+    void ApplyGlobalForces(ParticlePool& particles, uint32 index, float32 dt, float32 overLife, float32 layerOverLife, Vector3 prevParticlePosition);
     /**
      * @brief Updates a particle stripe with the given parameters
-     * @param[in,out] particle Pointer to the particle to be updated
+     * @param[in] particlePosition Position of the stripe particle
+     * @param[in] particleSpeed Speed of the stripe particle
      * @param[in] effectData Effect data containing particle system parameters
      * @param[in,out] group Particle group the particle belongs to
      * @param[in] dt Delta time for the update
@@ -305,7 +371,7 @@ private:
      * @param[in] forcesCount Number of forces in the currForceValues array
      * @param[in] isActive Flag indicating if the particle system is active
      */
-    void UpdateStripe(Particle* particle, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive);
+    void UpdateStripe(const Vector3& particlePosition, const Vector3& particleSpeed, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive);
     /**
      * @brief Simulates a single frame of the particle effect.
      * 
@@ -357,6 +423,16 @@ private: //materials stuff
 
     bool allowLodDegrade;
     bool is2DMode;
+
+    UpdateBuffers* AcquireUpdateBuffers();
+    void ReleaseUpdateBuffers(UpdateBuffers* buffers);
+
+    UpdateBuffers updateBuffers; // used by the calling thread
+    Vector<std::unique_ptr<UpdateBuffers>> workerUpdateBuffers; // unused sets of worker threads
+    Mutex workerUpdateBuffersMutex;
+    Vector<ParticleEffectComponent*> updatedEffects;
+    ParticleKernels::eImplementation kernelsImplementation = ParticleKernels::GetBestImplementation();
+    bool parallelUpdate = true;
 };
 
 /**
@@ -383,4 +459,25 @@ inline bool ParticleEffectSystem::GetAllowLodDegrade() const
 {
     return allowLodDegrade;
 }
+
+inline void ParticleEffectSystem::SetKernelsImplementation(ParticleKernels::eImplementation implementation)
+{
+    DVASSERT(ParticleKernels::IsImplementationAvailable(implementation));
+    kernelsImplementation = implementation;
+}
+
+inline ParticleKernels::eImplementation ParticleEffectSystem::GetKernelsImplementation() const
+{
+    return kernelsImplementation;
+}
+
+inline void ParticleEffectSystem::SetParallelUpdate(bool parallel)
+{
+    parallelUpdate = parallel;
+}
+
+inline bool ParticleEffectSystem::GetParallelUpdate() const
+{
+    return parallelUpdate;
+}
 };
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "Animation/AnimationTrack.h"
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Engine/Engine.h"
+#include "Job/JobManager.h"
 #include "Render/Highlevel/SkinnedMesh.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Components/ComponentHelpers.h"
@@ -16,10 +18,18 @@
 
 namespace DAVA
 {
+namespace SkeletonSystemDetails
+{
+// smaller crowds are updated on the calling thread
+const uint32 PARALLEL_UPDATE_MIN_SKELETONS = 16;
+const uint32 PARALLEL_UPDATE_GRAIN_SKELETONS = 8;
+}
+
 SkeletonSystem::SkeletonSystem(Scene* scene)
     : SceneSystem(scene)
 {
     scene->GetEventSystem()->RegisterSystemForEvent(this, EventSystem::SKELETON_CONFIG_CHANGED);
+    scene->RegisterArchetypeComponent<SkeletonComponent>();
 }
 
 SkeletonSystem::~SkeletonSystem()
@@ -72,27 +82,62 @@ void SkeletonSystem::Process(float32 timeElapsed)
     UpdateTestSkeletons();
 #endif
 
-    for (int32 i = 0, sz = static_cast<int32>(entities.size()); i < sz; ++i)
-    {
-        SkeletonComponent* component = GetSkeletonComponent(entities[i]);
+    using namespace SkeletonSystemDetails;
 
-        if (component != nullptr)
+    // rebuild skeletons and collect updated ones on the calling thread
+    updatedSkeletons.clear();
+    uint32 iteratedCount = 0;
+    GetScene()->ForEach<SkeletonComponent>([this, &iteratedCount](Entity* entity, SkeletonComponent* component) {
+        ++iteratedCount;
+        if (component->configUpdated)
         {
-            if (component->configUpdated)
+            RebuildSkeleton(component);
+        }
+
+        if (component->startJoint != SkeletonComponent::INVALID_JOINT_INDEX)
+        {
+            UpdatedSkeleton updated;
+            updated.skeleton = component;
+            RenderObject* ro = GetRenderObject(entity);
+            if (ro != nullptr && (RenderObject::TYPE_SKINNED_MESH == ro->GetType()))
             {
-                RebuildSkeleton(GetSkeletonComponent(entities[i]));
+                updated.skinnedMesh = static_cast<SkinnedMesh*>(ro);
             }
+            updatedSkeletons.push_back(updated);
+        }
+    });
+    DVASSERT(iteratedCount == entities.size(), "skeleton entities in archetype storage differ from entities added to system");
 
-            if (component->startJoint != SkeletonComponent::INVALID_JOINT_INDEX)
+    // every skeleton touches only its own component and mesh, so skeletons are updated independently
+    auto updateSkeletons = [this](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i)
+        {
+            UpdateJointTransforms(updatedSkeletons[i].skeleton);
+            if (updatedSkeletons[i].skinnedMesh != nullptr)
             {
-                UpdateJointTransforms(component);
-                RenderObject* ro = GetRenderObject(entities[i]);
-                if (ro != nullptr && (RenderObject::TYPE_SKINNED_MESH == ro->GetType()))
-                {
-                    UpdateSkinnedMesh(component, static_cast<SkinnedMesh*>(ro));
-                }
+                UpdateSkinnedMeshData(updatedSkeletons[i].skeleton, updatedSkeletons[i].skinnedMesh);
             }
         }
+    };
+
+    uint32 updatedCount = static_cast<uint32>(updatedSkeletons.size());
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (parallelUpdate && jobManager != nullptr && jobManager->GetWorkersCount() > 1 && updatedCount >= PARALLEL_UPDATE_MIN_SKELETONS)
+    {
+        jobManager->ParallelFor(0, updatedCount, PARALLEL_UPDATE_GRAIN_SKELETONS, updateSkeletons);
+    }
+    else
+    {
+        updateSkeletons(0, updatedCount);
+    }
+
+    RenderSystem* renderSystem = GetScene()->GetRenderSystem();
+    for (const UpdatedSkeleton& updated : updatedSkeletons)
+    {
+        if (updated.skinnedMesh != nullptr)
+        {
+            renderSystem->MarkForUpdate(updated.skinnedMesh);
+        }
     }
 
     DrawSkeletons(GetScene()->renderSystem->GetDebugDrawer());
@@ -100,9 +145,7 @@ void SkeletonSystem::Process(float32 timeElapsed)
 
 void SkeletonSystem::DrawSkeletons(RenderHelper* drawer)
 {
-    for (Entity* entity : entities)
-    {
-        SkeletonComponent* component = GetSkeletonComponent(entity);
+    GetScene()->ForEach<SkeletonComponent>([drawer](Entity* entity, SkeletonComponent* component) {
         if (component->drawSkeleton)
         {
             const Matrix4& worldTransform = GetTransformComponent(entity)->GetWorldMatrix();
@@ -134,7 +177,7 @@ void SkeletonSystem::DrawSkeletons(RenderHelper* drawer)
                 //drawer->DrawAABoxTransformed(component->objectSpaceBoxes[i], worldTransform, DAVA::Color::Red, RenderHelper::eDrawType::DRAW_WIRE_NO_DEPTH);
             }
         }
-    }
+    });
 }
 
 void SkeletonSystem::UpdateJointTransforms(SkeletonComponent* skeleton)
@@ -142,6 +185,7 @@ void SkeletonSystem::UpdateJointTransforms(SkeletonComponent* skeleton)
     DVASSERT(!skeleton->configUpdated);
 
     uint32 count = skeleton->GetJointsCount();
+    uint32 firstUpdatedJoint = count;
     for (uint32 currJoint = skeleton->startJoint; currJoint < count; ++currJoint)
     {
         uint32 parentJoint = skeleton->jointInfo[currJoint] & SkeletonComponent::INFO_PARENT_MASK;
@@ -157,8 +201,9 @@ void SkeletonSystem::UpdateJointTransforms(SkeletonComponent* skeleton)
                 skeleton->objectSpaceTransforms[currJoint] = skeleton->objectSpaceTransforms[parentJoint].AppendTransform(skeleton->localSpaceTransforms[currJoint]);
             }
 
-            //calculate final transform including bindTransform
-            skeleton->finalTransforms[currJoint] = skeleton->objectSpaceTransforms[currJoint].AppendTransform(skeleton->inverseBindTransforms[currJoint]);
+            //final transforms including bindTransform are calculated by kernel below
+            skeleton->objectSpaceStreams.Set(currJoint, skeleton->objectSpaceTransforms[currJoint]);
+            firstUpdatedJoint = Min(firstUpdatedJoint, currJoint);
 
             if (!skeleton->jointsArray[currJoint].bbox.IsEmpty())
             {
@@ -180,9 +225,21 @@ void SkeletonSystem::UpdateJointTransforms(SkeletonComponent* skeleton)
         }
     }
     skeleton->startJoint = SkeletonComponent::INVALID_JOINT_INDEX;
+
+    //joints after the first updated one are recomputed all together, not updated joints get the same values
+    if (firstUpdatedJoint < count)
+    {
+        JointKernels::AppendTransforms(skeleton->objectSpaceStreams, skeleton->inverseBindStreams, skeleton->finalTransforms, firstUpdatedJoint, count, kernelsImplementation);
+    }
 }
 
 void SkeletonSystem::UpdateSkinnedMesh(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject)
+{
+    UpdateSkinnedMeshData(skeleton, skinnedMeshObject);
+    GetScene()->GetRenderSystem()->MarkForUpdate(skinnedMeshObject);
+}
+
+void SkeletonSystem::UpdateSkinnedMeshData(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject)
 {
     DVASSERT(!skeleton->configUpdated);
 
@@ -199,8 +256,6 @@ void SkeletonSystem::UpdateSkinnedMesh(SkeletonComponent* skeleton, SkinnedMesh*
 
     skinnedMeshObject->UpdateJointTransforms(skeleton->finalTransforms);
     skinnedMeshObject->SetBoundingBox(resBox); //TODO: *Skinning* decide on bbox calculation
-
-    GetScene()->GetRenderSystem()->MarkForUpdate(skinnedMeshObject);
 }
 
 void SkeletonSystem::RebuildSkeleton(SkeletonComponent* skeleton)
@@ -211,8 +266,9 @@ void SkeletonSystem::RebuildSkeleton(SkeletonComponent* skeleton)
     skeleton->jointInfo.resize(jointsCount);
     skeleton->localSpaceTransforms.resize(jointsCount);
     skeleton->objectSpaceTransforms.resize(jointsCount);
-    skeleton->finalTransforms.resize(jointsCount);
-    skeleton->inverseBindTransforms.resize(jointsCount);
+    skeleton->objectSpaceStreams.Resize(uint32(jointsCount));
+    skeleton->inverseBindStreams.Resize(uint32(jointsCount));
+    skeleton->finalTransforms.Resize(uint32(jointsCount));
     skeleton->objectSpaceBoxes.resize(jointsCount);
 
     DVASSERT(skeleton->jointsArray.size() < SkeletonComponent::INFO_PARENT_MASK);
@@ -236,7 +292,7 @@ void SkeletonSystem::RebuildSkeleton(SkeletonComponent* skeleton)
             skeleton->objectSpaceTransforms[i] = skeleton->objectSpaceTransforms[skeleton->jointsArray[i].parentIndex].AppendTransform(localTransform);
         }
 
-        skeleton->inverseBindTransforms[i].Construct(skeleton->jointsArray[i].bindTransformInv);
+        skeleton->inverseBindStreams.Set(i, JointTransform(skeleton->jointsArray[i].bindTransformInv));
     }
 
     skeleton->startJoint = 0;
@@ -247,38 +303,33 @@ void SkeletonSystem::UpdateTestSkeletons(float32 timeElapsed)
     static float32 t = 0;
     t += timeElapsed;
 
-    for (Entity* entity : entities)
-    {
-        SkeletonComponent* component = GetSkeletonComponent(entity);
-        if (component != nullptr)
-        {
-            static const FastName SOFT_SKINNED_ENTITY_NAME("TestSoftSkinned");
+    GetScene()->ForEach<SkeletonComponent>([](Entity* entity, SkeletonComponent* component) {
+        static const FastName SOFT_SKINNED_ENTITY_NAME("TestSoftSkinned");
 
-            if (entity->GetName() == SOFT_SKINNED_ENTITY_NAME)
+        if (entity->GetName() == SOFT_SKINNED_ENTITY_NAME)
+        {
+            //Manipulate test soft skinned mesh in 'Debug Functions' in RE
+            uint32 jointCount = component->GetJointsCount();
+            for (uint32 j = 1; j < jointCount; ++j)
             {
-                //Manipulate test soft skinned mesh in 'Debug Functions' in RE
-                uint32 jointCount = component->GetJointsCount();
-                for (uint32 j = 1; j < jointCount; ++j)
-                {
-                    component->GetJoint(j).bindTransform.GetTranslationVector();
+                component->GetJoint(j).bindTransform.GetTranslationVector();
 
-                    Vector3 position = component->GetJoint(j).bindTransform.GetTranslationVector();
-                    position.z += 5.f * sinf(float32(j + t));
+                Vector3 position = component->GetJoint(j).bindTransform.GetTranslationVector();
+                position.z += 5.f * sinf(float32(j + t));
 
-                    JointTransform transform;
-                    transform.SetPosition(position);
+                JointTransform transform;
+                transform.SetPosition(position);
 
-                    component->SetJointTransform(j, transform);
-                }
+                component->SetJointTransform(j, transform);
             }
-            else
+        }
+        else
+        {
+            for (uint32 i = 0, sz = component->GetJointsCount(); i < sz; ++i)
             {
-                for (uint32 i = 0, sz = component->GetJointsCount(); i < sz; ++i)
-                {
-                    component->SetJointOrientation(i, Quaternion::MakeRotationFastY(t));
-                }
+                component->SetJointOrientation(i, Quaternion::MakeRotationFastY(t));
             }
         }
-    }
+    });
 }
 }
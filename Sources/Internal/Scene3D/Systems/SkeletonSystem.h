@@ -2,7 +2,9 @@
 #define __DAVAENGINE_SKELETON_SYSTEM_H__
 
 #include "Base/BaseTypes.h"
+#include "Debug/DVAssert.h"
 #include "Entity/SceneSystem.h"
+#include "Scene3D/SkeletonAnimation/JointKernels.h"
 
 namespace DAVA
 {
@@ -66,6 +68,8 @@ public:
      * 
      * Updates skeleton animations and transformations for all entities with skeletal components.
      * This method is called each frame to advance the animation state.
+     * Entities are iterated with `Scene::ForEach`, skeleton components are registered in archetype storage by the constructor.
+     * System mask is exactly SkeletonComponent, so iterated entities are the ones added to the system; that is asserted.
      * 
      * @param[in] timeElapsed Time passed since the last frame in seconds
      */
@@ -84,13 +88,51 @@ public:
      */
     void DrawSkeletons(RenderHelper* drawer);
 
+    /**
+     * @brief Sets implementation of batch kernels used to compose joint transforms
+     * @param[in] implementation Kernels implementation, must be available for current target
+     * @details All implementations produce the same results, scalar one is useful for comparison and debugging.
+     */
+    inline void SetKernelsImplementation(JointKernels::eImplementation implementation);
+    /**
+     * @brief Gets implementation of batch kernels used to compose joint transforms
+     * @return Current kernels implementation, the best available one by default
+     */
+    inline JointKernels::eImplementation GetKernelsImplementation() const;
+
+    /**
+     * @brief Sets whether skeletons are updated on JobManager worker threads
+     * @param[in] parallel If true, updated skeletons are split into ranges processed by workers, otherwise all skeletons are processed on the calling thread
+     * @details Every skeleton is updated by a single thread, so results don't depend on this setting. Enabled by default.
+     */
+    inline void SetParallelUpdate(bool parallel);
+    /**
+     * @brief Gets whether skeletons are updated on JobManager worker threads
+     * @return true if parallel update is enabled, false otherwise
+     */
+    inline bool GetParallelUpdate() const;
+
 private:
+    struct UpdatedSkeleton
+    {
+        SkeletonComponent* skeleton = nullptr;
+        SkinnedMesh* skinnedMesh = nullptr;
+    };
+
     /**
      * @brief Updates joint transforms for a skeleton
      * @param skeleton Skeleton component to update
      */
     void UpdateJointTransforms(SkeletonComponent* skeleton);
 
+    /**
+     * @brief Writes skeleton state to skinned mesh joint data and bounding box without marking it for render update
+     * @param skeleton Skeleton component to use for update
+     * @param skinnedMeshObject Skinned mesh to update
+     * @details Touches only given skeleton and mesh, so can be called for different skeletons from several threads at once.
+     */
+    void UpdateSkinnedMeshData(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject);
+
     /**
      * @brief Rebuilds skeleton data structure
      * @param skeleton Skeleton component to rebuild
@@ -104,8 +146,32 @@ private:
     void UpdateTestSkeletons(float32 timeElapsed);
 
     Vector<Entity*> entities;
+    Vector<UpdatedSkeleton> updatedSkeletons;
+    JointKernels::eImplementation kernelsImplementation = JointKernels::GetBestImplementation();
+    bool parallelUpdate = true;
 };
 
+inline void SkeletonSystem::SetKernelsImplementation(JointKernels::eImplementation implementation)
+{
+    DVASSERT(JointKernels::IsImplementationAvailable(implementation));
+    kernelsImplementation = implementation;
+}
+
+inline JointKernels::eImplementation SkeletonSystem::GetKernelsImplementation() const
+{
+    return kernelsImplementation;
+}
+
+inline void SkeletonSystem::SetParallelUpdate(bool parallel)
+{
+    parallelUpdate = parallel;
+}
+
+inline bool SkeletonSystem::GetParallelUpdate() const
+{
+    return parallelUpdate;
+}
+
 } //ns
 
 #endif
@@ -0,0 +1,113 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Scene3D/Scene.h"
+#include "Scene3D/Entity.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Components/SingleComponents/TransformSingleComponent.h"
+#include "Scene3D/Systems/TransformSystem.h"
+#include "Math/Transform.h"
+
+using namespace DAVA;
+
+namespace TransformSystemTestDetails
+{
+// enough roots to make level updates go to worker threads
+const uint32 ROOTS_COUNT = 3000;
+const uint32 CHILDREN_PER_NODE = 2;
+const uint32 DEPTH = 3;
+
+Transform MakeTransform(uint32 seed)
+{
+    float32 v = static_cast<float32>(seed % 97) * 0.1f;
+    Quaternion rotation;
+    rotation.Construct(Vector3(0.f, 0.f, 1.f), v);
+    return Transform(Vector3(v, -v, v * 0.5f), Vector3(1.f, 1.f, 1.f + v * 0.01f), rotation);
+}
+
+void AddChildren(Entity* parent, uint32 depth, uint32& seed, Vector<Entity*>& entities)
+{
+    if (depth == 0)
+    {
+        return;
+    }
+
+    for (uint32 i = 0; i < CHILDREN_PER_NODE; ++i)
+    {
+        ScopedPtr<Entity> child(new Entity());
+        child->GetComponent<TransformComponent>()->SetLocalTransform(MakeTransform(seed++));
+        parent->AddNode(child);
+        entities.push_back(child);
+        AddChildren(child, depth - 1, seed, entities);
+    }
+}
+
+Scene* CreateScene(TransformSystem::eUpdateMode mode, Vector<Entity*>& entities)
+{
+    Scene* scene = new Scene();
+    scene->transformSystem->SetUpdateMode(mode);
+
+    uint32 seed = 0;
+    for (uint32 i = 0; i < ROOTS_COUNT; ++i)
+    {
+        ScopedPtr<Entity> root(new Entity());
+        root->GetComponent<TransformComponent>()->SetLocalTransform(MakeTransform(seed++));
+        scene->AddNode(root);
+        entities.push_back(root);
+        AddChildren(root, DEPTH, seed, entities);
+    }
+
+    return scene;
+}
+
+void ProcessTransforms(Scene* scene)
+{
+    scene->transformSystem->Process(0.f);
+    scene->transformSingleComponent->Clear();
+}
+}
+
+DAVA_TESTCLASS (TransformSystemTest)
+{
+    DAVA_TEST (LevelArraysMatchHierarchyWalk)
+    {
+        using namespace TransformSystemTestDetails;
+
+        Vector<Entity*> walkEntities;
+        Vector<Entity*> levelEntities;
+        Scene* walkScene = CreateScene(TransformSystem::eUpdateMode::HIERARCHY_WALK, walkEntities);
+        Scene* levelScene = CreateScene(TransformSystem::eUpdateMode::LEVEL_ARRAYS, levelEntities);
+        SCOPE_EXIT
+        {
+            SafeRelease(walkScene);
+            SafeRelease(levelScene);
+        };
+
+        TEST_VERIFY(walkEntities.size() == levelEntities.size());
+
+        for (uint32 frame = 0; frame < 3; ++frame)
+        {
+            // move every 7th node, including roots and leafs
+            for (size_t i = frame; i < walkEntities.size(); i += 7)
+            {
+                Transform t = MakeTransform(static_cast<uint32>(i * 31 + frame));
+                walkEntities[i]->GetComponent<TransformComponent>()->SetLocalTransform(t);
+                levelEntities[i]->GetComponent<TransformComponent>()->SetLocalTransform(t);
+            }
+
+            ProcessTransforms(walkScene);
+            ProcessTransforms(levelScene);
+
+            TEST_VERIFY(walkScene->transformSystem->GetLastUpdatedNodesCount() == levelScene->transformSystem->GetLastUpdatedNodesCount());
+
+            bool allEqual = true;
+            for (size_t i = 0; i < walkEntities.size(); ++i)
+            {
+                TransformComponent* walkTransform = walkEntities[i]->GetComponent<TransformComponent>();
+                TransformComponent* levelTransform = levelEntities[i]->GetComponent<TransformComponent>();
+                allEqual = allEqual && (walkTransform->GetWorldTransform() == levelTransform->GetWorldTransform());
+                allEqual = allEqual && ((levelEntities[i]->GetFlags() & (Entity::TRANSFORM_NEED_UPDATE | Entity::TRANSFORM_DIRTY)) == 0);
+            }
+            TEST_VERIFY(allEqual);
+        }
+    }
+};
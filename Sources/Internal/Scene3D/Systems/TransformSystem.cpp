@@ -1,6 +1,10 @@
 #include "Debug/DVAssert.h"
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
+#include "Math/TransformUtils.h"
 #include "Scene3D/Components/AnimationComponent.h"
 #include "Scene3D/Components/ComponentHelpers.h"
 #include "Math/Transform.h"
@@ -12,6 +16,13 @@
 
 namespace DAVA
 {
+namespace TransformSystemDetails
+{
+// levels smaller than this are updated on the calling thread
+const uint32 PARALLEL_LEVEL_MIN_SIZE = 2048;
+const uint32 PARALLEL_GRAIN_SIZE = 512;
+}
+
 TransformSystem::TransformSystem(Scene* scene)
     : SceneSystem(scene)
 {
@@ -41,14 +52,165 @@ void TransformSystem::Process(float32 timeElapsed)
     passedNodes = 0;
     multipliedNodes = 0;
 
-    uint32 size = static_cast<uint32>(updatableEntities.size());
-    for (uint32 i = 0; i < size; ++i)
+    if (updateMode == eUpdateMode::LEVEL_ARRAYS)
     {
-        FindNodeThatRequireUpdate(updatableEntities[i]);
+        ProcessLevels();
+    }
+    else
+    {
+        uint32 size = static_cast<uint32>(updatableEntities.size());
+        for (uint32 i = 0; i < size; ++i)
+        {
+            FindNodeThatRequireUpdate(updatableEntities[i]);
+        }
     }
     updatableEntities.clear();
 }
 
+void TransformSystem::ProcessLevels()
+{
+    using namespace TransformSystemDetails;
+
+    levelEntities.clear();
+    levelParents.clear();
+    levelOffsets.clear();
+
+    for (Entity* entity : updatableEntities)
+    {
+        GatherLevelRoots(entity);
+    }
+    levelParents.resize(levelEntities.size(), -1);
+
+    // breadth-first expansion: every level is stored right after previous one
+    uint32 levelBegin = 0;
+    while (levelBegin < levelEntities.size())
+    {
+        uint32 levelEnd = static_cast<uint32>(levelEntities.size());
+        levelOffsets.push_back(levelBegin);
+
+        for (uint32 i = levelBegin; i < levelEnd; ++i)
+        {
+            Entity* entity = levelEntities[i];
+            entity->RemoveFlag(Entity::TRANSFORM_NEED_UPDATE | Entity::TRANSFORM_DIRTY);
+
+            uint32 childrenCount = entity->GetChildrenCount();
+            for (uint32 c = 0; c < childrenCount; ++c)
+            {
+                levelEntities.push_back(entity->GetChild(c));
+                levelParents.push_back(static_cast<int32>(i));
+            }
+        }
+
+        levelBegin = levelEnd;
+    }
+    levelOffsets.push_back(levelBegin);
+
+    uint32 nodesCount = static_cast<uint32>(levelEntities.size());
+    if (nodesCount == 0)
+    {
+        return;
+    }
+
+    levelWorldTransforms.resize(nodesCount);
+    levelUpdated.resize(nodesCount);
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    for (size_t level = 0; level + 1 < levelOffsets.size(); ++level)
+    {
+        uint32 begin = levelOffsets[level];
+        uint32 end = levelOffsets[level + 1];
+
+        if (jobManager != nullptr && (end - begin) >= PARALLEL_LEVEL_MIN_SIZE)
+        {
+            jobManager->ParallelFor(begin, end, PARALLEL_GRAIN_SIZE, MakeFunction(this, &TransformSystem::UpdateLevelRange));
+        }
+        else
+        {
+            UpdateLevelRange(begin, end);
+        }
+    }
+
+    // world changes are reported on the calling thread, SortedEntityContainer isn't thread-safe
+    TransformSingleComponent* tsc = GetScene()->transformSingleComponent;
+    for (uint32 i = 0; i < nodesCount; ++i)
+    {
+        if (levelUpdated[i] != 0)
+        {
+            tsc->worldTransformChanged.Push(levelEntities[i]);
+            multipliedNodes++;
+        }
+    }
+}
+
+void TransformSystem::GatherLevelRoots(Entity* entity)
+{
+    static const uint32 STACK_SIZE = 5000;
+    uint32 stackPosition = 0;
+    Entity* stack[STACK_SIZE];
+    stack[stackPosition++] = entity;
+
+    while (stackPosition > 0)
+    {
+        Entity* entity = stack[--stackPosition];
+
+        if (entity->GetFlags() & Entity::TRANSFORM_NEED_UPDATE)
+        {
+            // whole subtree will be updated
+            levelEntities.push_back(entity);
+        }
+        else
+        {
+            entity->RemoveFlag(Entity::TRANSFORM_NEED_UPDATE | Entity::TRANSFORM_DIRTY);
+
+            uint32 size = entity->GetChildrenCount();
+            for (uint32 i = 0; i < size; ++i)
+            {
+                Entity* childEntity = entity->GetChild(i);
+                if (childEntity->GetFlags() & Entity::TRANSFORM_DIRTY)
+                {
+                    DVASSERT(stackPosition < STACK_SIZE - 1);
+                    stack[stackPosition++] = childEntity;
+                }
+            }
+        }
+    }
+    DVASSERT(stackPosition == 0);
+}
+
+void TransformSystem::UpdateLevelRange(uint32 begin, uint32 end)
+{
+    for (uint32 i = begin; i < end; ++i)
+    {
+        Entity* entity = levelEntities[i];
+        TransformComponent* transform = entity->GetComponent<TransformComponent>();
+
+        if (transform->parentTransform)
+        {
+            int32 parentIndex = levelParents[i];
+            const Transform& parentWorld = (parentIndex >= 0) ? levelWorldTransforms[parentIndex] : *(transform->parentTransform);
+
+            AnimationComponent* animComp = GetAnimationComponent(entity);
+            if (animComp)
+            {
+                transform->worldTransform = Transform(animComp->animationTransform) * transform->localTransform * parentWorld;
+            }
+            else
+            {
+                transform->worldTransform = transform->localTransform * parentWorld;
+            }
+
+            transform->worldMatrix = TransformUtils::ToMatrix(transform->worldTransform);
+            levelUpdated[i] = 1;
+        }
+        else
+        {
+            levelUpdated[i] = 0;
+        }
+
+        levelWorldTransforms[i] = transform->worldTransform;
+    }
+}
+
 void TransformSystem::FindNodeThatRequireUpdate(Entity* entity)
 {
     static const uint32 STACK_SIZE = 5000;
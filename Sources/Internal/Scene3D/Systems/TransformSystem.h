@@ -3,19 +3,25 @@
 #include "Base/BaseTypes.h"
 #include "Math/MathConstants.h"
 #include "Math/Matrix4.h"
+#include "Math/Transform.h"
 #include "Base/Singleton.h"
 #include "Entity/SceneSystem.h"
 
 namespace DAVA
 {
 class Entity;
-class Transform;
 class TransformComponent;
-class Transform;
 
 class TransformSystem : public SceneSystem
 {
 public:
+    /** Way world transforms of dirty hierarchies are recalculated in Process. */
+    enum class eUpdateMode
+    {
+        HIERARCHY_WALK, ///< Depth-first walk over every dirty hierarchy on the calling thread.
+        LEVEL_ARRAYS ///< Dirty nodes are gathered into depth-sorted arrays and updated level by level, big levels are split across worker threads.
+    };
+
     /**
      * @brief Constructor for TransformSystem
      * @param scene Pointer to Scene this system belongs to
@@ -45,8 +51,34 @@ public:
      */
     void Process(float32 timeElapsed) override;
 
+    /**
+     * @brief Sets the way world transforms are recalculated, LEVEL_ARRAYS by default
+     * @param mode Update mode
+     */
+    void SetUpdateMode(eUpdateMode mode);
+
+    /**
+     * @brief Returns current update mode
+     */
+    eUpdateMode GetUpdateMode() const;
+
+    /**
+     * @brief Returns count of world transforms recalculated during last Process call
+     */
+    int32 GetLastUpdatedNodesCount() const;
+
 private:
     Vector<Entity*> updatableEntities;
+    eUpdateMode updateMode = eUpdateMode::LEVEL_ARRAYS;
+
+    // Depth-sorted arrays of nodes to update, filled every frame in LEVEL_ARRAYS mode.
+    // Nodes of level N are stored in range [levelOffsets[N], levelOffsets[N + 1]),
+    // so parents are always updated before children.
+    Vector<Entity*> levelEntities;
+    Vector<int32> levelParents; // index of parent node in level arrays, -1 for roots of updated subtrees
+    Vector<Transform> levelWorldTransforms;
+    Vector<uint8> levelUpdated; // 1 if world transform of the node was recalculated
+    Vector<uint32> levelOffsets;
 
     /**
      * @brief Marks entity as needing update
@@ -72,7 +104,40 @@ private:
      */
     void TransformAllChildEntities(Entity* entity);
 
+    /**
+     * @brief Updates dirty hierarchies using depth-sorted level arrays
+     */
+    void ProcessLevels();
+
+    /**
+     * @brief Finds roots of subtrees requiring update and adds them to the first level
+     * @param entity Topmost dirty entity
+     */
+    void GatherLevelRoots(Entity* entity);
+
+    /**
+     * @brief Recalculates world transforms of nodes in range of level arrays
+     * @param begin First node index
+     * @param end Index after the last node
+     */
+    void UpdateLevelRange(uint32 begin, uint32 end);
+
     int32 passedNodes;
     int32 multipliedNodes;
 };
+
+inline void TransformSystem::SetUpdateMode(eUpdateMode mode)
+{
+    updateMode = mode;
+}
+
+inline TransformSystem::eUpdateMode TransformSystem::GetUpdateMode() const
+{
+    return updateMode;
+}
+
+inline int32 TransformSystem::GetLastUpdatedNodesCount() const
+{
+    return multipliedNodes;
+}
 };
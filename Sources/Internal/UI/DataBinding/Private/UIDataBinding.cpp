@@ -11,6 +11,7 @@
 #include "UI/Formula/Private/FormulaExpression.h"
 #include "UI/Formula/Private/FormulaParser.h"
 #include "UI/Formula/Private/FormulaExecutor.h"
+#include "UI/Formula/Private/FormulaProgram.h"
 #include "UI/Formula/Private/FormulaFormatter.h"
 
 #include "UI/Styles/UIStyleSheetPropertyDataBase.h"
@@ -44,6 +45,7 @@ void UIDataBinding::ProcessReadFromModel(UIDataBindingDependenciesManager* depen
     {
         component->SetDirty(false);
         expression = nullptr;
+        program = nullptr;
         hasToResetError = true;
         expChanged = true;
 
@@ -83,10 +85,12 @@ void UIDataBinding::ProcessReadFromModel(UIDataBindingDependenciesManager* depen
         try
         {
             expression = parser.ParseExpression();
+            program = std::make_shared<FormulaProgram>(expression);
         }
         catch (const FormulaException& error)
         {
             expression = nullptr;
+            program = nullptr;
             hasToResetError = false;
             NotifyError(error.GetFormattedMessage(), component->GetControlFieldName());
         }
@@ -98,9 +102,8 @@ void UIDataBinding::ProcessReadFromModel(UIDataBindingDependenciesManager* depen
         hasToResetError = true;
         try
         {
-            FormulaExecutor executor(context);
-            Any val = executor.Calculate(expression.get());
-            const Vector<void*>& dependencies = executor.GetDependencies();
+            Any val = program->Calculate(context);
+            const Vector<void*>& dependencies = program->GetDependencies();
 
             if (!dependencies.empty())
             {
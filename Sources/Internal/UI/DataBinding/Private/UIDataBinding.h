@@ -7,6 +7,7 @@ namespace DAVA
 {
 class UIDataBindingComponent;
 class FormulaExpression;
+class FormulaProgram;
 class UIDataBindingIssueDelegate;
 class UIDataBindingDependenciesManager;
 
@@ -24,6 +25,7 @@ public:
 private:
     UIDataBindingComponent* component = nullptr;
     std::shared_ptr<FormulaExpression> expression;
+    std::shared_ptr<FormulaProgram> program;
 
     Reflection controlReflection;
 };
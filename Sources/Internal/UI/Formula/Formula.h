@@ -8,6 +8,7 @@ namespace DAVA
 {
 class FormulaExpression;
 class FormulaContext;
+class FormulaProgram;
 
 /**
  \ingroup formula
@@ -63,6 +64,7 @@ public:
 
 private:
     std::shared_ptr<FormulaExpression> exp;
+    std::shared_ptr<FormulaProgram> program;
 
     String parsingError;
     String calculationError;
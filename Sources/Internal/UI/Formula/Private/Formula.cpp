@@ -1,7 +1,8 @@
 #include "UI/Formula/Formula.h"
 
 #include "UI/Formula/Private/FormulaParser.h"
-#include "UI/Formula/Private/FormulaExecutor.h"
+#include "UI/Formula/Private/FormulaProgram.h"
+#include "UI/Formula/FormulaContext.h"
 #include "UI/Formula/Private/FormulaFormatter.h"
 
 namespace DAVA
@@ -22,6 +23,7 @@ bool Formula::Parse(const String& str)
     {
         FormulaParser parser(str);
         exp = parser.ParseExpression();
+        program = std::make_shared<FormulaProgram>(exp);
         return true;
     }
     catch (const FormulaException& error)
@@ -34,6 +36,7 @@ bool Formula::Parse(const String& str)
 void Formula::Reset()
 {
     exp.reset();
+    program.reset();
     parsingError = "";
     calculationError = "";
 }
@@ -51,8 +54,7 @@ Any Formula::Calculate(const std::shared_ptr<FormulaContext>& context)
     {
         try
         {
-            FormulaExecutor executor(context);
-            return executor.Calculate(exp.get());
+            return program->Calculate(context);
         }
         catch (const FormulaException& error)
         {
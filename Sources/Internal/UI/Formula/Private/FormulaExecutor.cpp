@@ -56,44 +56,13 @@ void FormulaExecutor::Visit(FormulaValueExpression* exp)
 void FormulaExecutor::Visit(FormulaNegExpression* exp)
 {
     const Any& val = CalculateImpl(exp->GetExp());
-
-    if (val.CanGet<float32>())
-    {
-        calculationResult = Any(-val.Get<float32>());
-    }
-    else if (val.CanGet<float64>())
-    {
-        calculationResult = Any(-val.Get<float64>());
-    }
-    else if (val.CanGet<int64>())
-    {
-        calculationResult = Any(-val.Get<int64>());
-    }
-    else
-    {
-        int32 res = 0;
-        if (CastToInt32(val, &res))
-        {
-            calculationResult = Any(-res);
-        }
-        else
-        {
-            DAVA_THROW(FormulaException, Format("Invalid argument type '%s' to unary '-' expression", FormulaFormatter::AnyTypeToString(val).c_str()), exp);
-        }
-    }
+    calculationResult = CalculateNeg(exp, val);
 }
 
 void FormulaExecutor::Visit(FormulaNotExpression* exp)
 {
     Any val = CalculateImpl(exp->GetExp());
-    if (val.CanGet<bool>())
-    {
-        calculationResult = Any(!val.Get<bool>());
-    }
-    else
-    {
-        DAVA_THROW(FormulaException, Format("Invalid argument type '%s' to unary 'not' expression", FormulaFormatter::AnyTypeToString(val).c_str()), exp);
-    }
+    calculationResult = CalculateNot(exp, val);
 }
 
 void FormulaExecutor::Visit(FormulaWhenExpression* exp)
@@ -121,116 +90,12 @@ void FormulaExecutor::Visit(FormulaBinaryOperatorExpression* exp)
 {
     Any l = CalculateImpl(exp->GetLhs());
     Any r = CalculateImpl(exp->GetRhs());
-
-    if (l.CanGet<uint64>() && r.CanGet<uint64>())
-    {
-        calculationResult = CalculateIntAnyValues<uint64>(exp->GetOperator(), l, r, exp);
-    }
-    else if (l.CanGet<int64>() && r.CanGet<int64>())
-    {
-        calculationResult = CalculateIntAnyValues<int64>(exp->GetOperator(), l, r, exp);
-    }
-    else if (l.CanGet<uint32>() && r.CanGet<uint32>())
-    {
-        calculationResult = CalculateIntAnyValues<uint32>(exp->GetOperator(), l, r, exp);
-    }
-    else if (l.CanGet<bool>() && r.CanGet<bool>())
-    {
-        bool lVal = l.Get<bool>();
-        bool rVal = r.Get<bool>();
-        switch (exp->GetOperator())
-        {
-        case FormulaBinaryOperatorExpression::OP_AND:
-            calculationResult = Any(lVal && rVal);
-            break;
-
-        case FormulaBinaryOperatorExpression::OP_OR:
-            calculationResult = Any(lVal || rVal);
-            break;
-
-        case FormulaBinaryOperatorExpression::OP_EQ:
-            calculationResult = Any(lVal == rVal);
-            break;
-
-        case FormulaBinaryOperatorExpression::OP_NOT_EQ:
-            calculationResult = Any(lVal != rVal);
-            break;
-
-        default:
-            DAVA_THROW(FormulaException, Format("Operator '%s' cannot be applied to '%s', '%s'",
-                                                FormulaFormatter::BinaryOpToString(exp->GetOperator()).c_str(),
-                                                FormulaFormatter::AnyTypeToString(l).c_str(),
-                                                FormulaFormatter::AnyTypeToString(r).c_str()),
-                       exp);
-        }
-    }
-    else if (l.CanGet<String>() && r.CanGet<String>())
-    {
-        String lVal = l.Get<String>();
-        String rVal = r.Get<String>();
-        switch (exp->GetOperator())
-        {
-        case FormulaBinaryOperatorExpression::OP_PLUS:
-            calculationResult = Any(lVal + rVal);
-            break;
-
-        case FormulaBinaryOperatorExpression::OP_EQ:
-            calculationResult = Any(lVal == rVal);
-            break;
-
-        case FormulaBinaryOperatorExpression::OP_NOT_EQ:
-            calculationResult = Any(lVal != rVal);
-            break;
-
-        default:
-            DAVA_THROW(FormulaException, Format("Operator '%s' cannot be applied to '%s', '%s'",
-                                                FormulaFormatter::BinaryOpToString(exp->GetOperator()).c_str(),
-                                                FormulaFormatter::AnyTypeToString(l).c_str(),
-                                                FormulaFormatter::AnyTypeToString(r).c_str()),
-                       exp);
-        }
-    }
-    else
-    {
-        int32 leftIntVal = 0;
-        bool isLeftInt = CastToInt32(l, &leftIntVal);
-
-        int32 rightIntVal = 0;
-        bool isRightInt = CastToInt32(r, &rightIntVal);
-
-        if (isLeftInt && isRightInt)
-        {
-            calculationResult = CalculateIntValues<int32>(exp->GetOperator(), leftIntVal, rightIntVal, exp);
-        }
-        else if ((l.CanGet<float32>() || isLeftInt) && (r.CanGet<float32>() || isRightInt))
-        {
-            float32 lVal = l.CanGet<float32>() ? l.Get<float32>() : static_cast<float32>(leftIntVal);
-            float32 rVal = r.CanGet<float32>() ? r.Get<float32>() : static_cast<float32>(rightIntVal);
-            calculationResult = CalculateNumberValues<float32>(exp->GetOperator(), lVal, rVal);
-        }
-        else if ((l.CanGet<float64>() && r.CanCast<float64>()) || (l.CanCast<float64>() && r.CanGet<float64>()))
-        {
-            float64 lVal = l.Cast<float64>();
-            float64 rVal = r.Cast<float64>();
-            calculationResult = CalculateNumberValues<float64>(exp->GetOperator(), lVal, rVal);
-        }
-        else
-        {
-            DAVA_THROW(FormulaException, Format("Operator '%s' cannot be applied to '%s', '%s'",
-                                                FormulaFormatter::BinaryOpToString(exp->GetOperator()).c_str(),
-                                                FormulaFormatter::AnyTypeToString(l).c_str(),
-                                                FormulaFormatter::AnyTypeToString(r).c_str()),
-                       exp);
-        }
-    }
+    calculationResult = CalculateBinaryOperator(exp, l, r);
 }
 
 void FormulaExecutor::Visit(FormulaFunctionExpression* exp)
 {
     const Vector<std::shared_ptr<FormulaExpression>>& params = exp->GetParms();
-    Vector<const Type*> types;
-    types.reserve(params.size());
-
     Vector<Any> values;
     values.reserve(params.size());
 
@@ -244,81 +109,10 @@ void FormulaExecutor::Visit(FormulaFunctionExpression* exp)
                                                 exp->GetName().c_str()),
                        paramExp.get());
         }
-        types.push_back(res.GetType());
         values.push_back(res);
     }
 
-    AnyFn fn = context->FindFunction(exp->GetName(), types);
-    if (!fn.IsValid())
-    {
-        String args;
-        for (size_t i = 0; i < values.size(); i++)
-        {
-            if (i > 0)
-            {
-                args += ", ";
-            }
-            args += FormulaFormatter::AnyTypeToString(values[i]);
-        }
-        DAVA_THROW(FormulaException, Format("Can't resolve function '%s(%s)'", exp->GetName().c_str(), args.c_str()), exp);
-    }
-
-    int32 index = 1; // Skip first arg (FormulaContext).
-    for (Any& v : values)
-    {
-        int32 intVal = 0;
-        if (fn.GetInvokeParams().argsType[index] == Type::Instance<float32>() && FormulaExecutor::CastToInt32(v, &intVal))
-        {
-            v = Any(static_cast<float32>(intVal));
-        }
-
-        index++;
-    }
-
-    switch (params.size())
-    {
-    case 0:
-        calculationResult = fn.Invoke(context);
-        break;
-
-    case 1:
-        calculationResult = fn.Invoke(context, values[0]);
-        break;
-
-    case 2:
-        calculationResult = fn.Invoke(context, values[0], values[1]);
-        break;
-
-    case 3:
-        calculationResult = fn.Invoke(context, values[0], values[1], values[2]);
-        break;
-
-    case 4:
-        calculationResult = fn.Invoke(context, values[0], values[1], values[2], values[3]);
-        break;
-
-    case 5:
-        calculationResult = fn.Invoke(context, values[0], values[1], values[2], values[3], values[4]);
-        break;
-
-    default:
-    {
-        String args;
-        for (size_t i = 0; i < values.size(); i++)
-        {
-            if (i > 0)
-            {
-                args += ", ";
-            }
-            args += FormulaFormatter::AnyTypeToString(values[i]);
-        }
-        DAVA_THROW(FormulaException,
-                   Format("Function '%s(%s)' has to much arguments (more than 5)",
-                          exp->GetName().c_str(),
-                          args.c_str()),
-                   exp);
-    }
-    }
+    calculationResult = CallFunction(context, exp, values);
 }
 
 void FormulaExecutor::Visit(FormulaFieldAccessExpression* exp)
@@ -453,8 +247,222 @@ const Reflection& FormulaExecutor::GetDataReferenceImpl(FormulaExpression* exp)
     }
 }
 
+Any FormulaExecutor::CalculateNeg(FormulaNegExpression* exp, const Any& val)
+{
+    if (val.CanGet<float32>())
+    {
+        return Any(-val.Get<float32>());
+    }
+    else if (val.CanGet<float64>())
+    {
+        return Any(-val.Get<float64>());
+    }
+    else if (val.CanGet<int64>())
+    {
+        return Any(-val.Get<int64>());
+    }
+    else
+    {
+        int32 res = 0;
+        if (CastToInt32(val, &res))
+        {
+            return Any(-res);
+        }
+        else
+        {
+            DAVA_THROW(FormulaException, Format("Invalid argument type '%s' to unary '-' expression", FormulaFormatter::AnyTypeToString(val).c_str()), exp);
+        }
+    }
+}
+
+Any FormulaExecutor::CalculateNot(FormulaNotExpression* exp, const Any& val)
+{
+    if (val.CanGet<bool>())
+    {
+        return Any(!val.Get<bool>());
+    }
+    else
+    {
+        DAVA_THROW(FormulaException, Format("Invalid argument type '%s' to unary 'not' expression", FormulaFormatter::AnyTypeToString(val).c_str()), exp);
+    }
+}
+
+Any FormulaExecutor::CalculateBinaryOperator(FormulaBinaryOperatorExpression* exp, const Any& l, const Any& r)
+{
+    if (l.CanGet<uint64>() && r.CanGet<uint64>())
+    {
+        return CalculateIntAnyValues<uint64>(exp->GetOperator(), l, r, exp);
+    }
+    else if (l.CanGet<int64>() && r.CanGet<int64>())
+    {
+        return CalculateIntAnyValues<int64>(exp->GetOperator(), l, r, exp);
+    }
+    else if (l.CanGet<uint32>() && r.CanGet<uint32>())
+    {
+        return CalculateIntAnyValues<uint32>(exp->GetOperator(), l, r, exp);
+    }
+    else if (l.CanGet<bool>() && r.CanGet<bool>())
+    {
+        bool lVal = l.Get<bool>();
+        bool rVal = r.Get<bool>();
+        switch (exp->GetOperator())
+        {
+        case FormulaBinaryOperatorExpression::OP_AND:
+            return Any(lVal && rVal);
+
+        case FormulaBinaryOperatorExpression::OP_OR:
+            return Any(lVal || rVal);
+
+        case FormulaBinaryOperatorExpression::OP_EQ:
+            return Any(lVal == rVal);
+
+        case FormulaBinaryOperatorExpression::OP_NOT_EQ:
+            return Any(lVal != rVal);
+
+        default:
+            DAVA_THROW(FormulaException, Format("Operator '%s' cannot be applied to '%s', '%s'",
+                                                FormulaFormatter::BinaryOpToString(exp->GetOperator()).c_str(),
+                                                FormulaFormatter::AnyTypeToString(l).c_str(),
+                                                FormulaFormatter::AnyTypeToString(r).c_str()),
+                       exp);
+        }
+    }
+    else if (l.CanGet<String>() && r.CanGet<String>())
+    {
+        String lVal = l.Get<String>();
+        String rVal = r.Get<String>();
+        switch (exp->GetOperator())
+        {
+        case FormulaBinaryOperatorExpression::OP_PLUS:
+            return Any(lVal + rVal);
+
+        case FormulaBinaryOperatorExpression::OP_EQ:
+            return Any(lVal == rVal);
+
+        case FormulaBinaryOperatorExpression::OP_NOT_EQ:
+            return Any(lVal != rVal);
+
+        default:
+            DAVA_THROW(FormulaException, Format("Operator '%s' cannot be applied to '%s', '%s'",
+                                                FormulaFormatter::BinaryOpToString(exp->GetOperator()).c_str(),
+                                                FormulaFormatter::AnyTypeToString(l).c_str(),
+                                                FormulaFormatter::AnyTypeToString(r).c_str()),
+                       exp);
+        }
+    }
+    else
+    {
+        int32 leftIntVal = 0;
+        bool isLeftInt = CastToInt32(l, &leftIntVal);
+
+        int32 rightIntVal = 0;
+        bool isRightInt = CastToInt32(r, &rightIntVal);
+
+        if (isLeftInt && isRightInt)
+        {
+            return CalculateIntValues<int32>(exp->GetOperator(), leftIntVal, rightIntVal, exp);
+        }
+        else if ((l.CanGet<float32>() || isLeftInt) && (r.CanGet<float32>() || isRightInt))
+        {
+            float32 lVal = l.CanGet<float32>() ? l.Get<float32>() : static_cast<float32>(leftIntVal);
+            float32 rVal = r.CanGet<float32>() ? r.Get<float32>() : static_cast<float32>(rightIntVal);
+            return CalculateNumberValues<float32>(exp->GetOperator(), lVal, rVal);
+        }
+        else if ((l.CanGet<float64>() && r.CanCast<float64>()) || (l.CanCast<float64>() && r.CanGet<float64>()))
+        {
+            float64 lVal = l.Cast<float64>();
+            float64 rVal = r.Cast<float64>();
+            return CalculateNumberValues<float64>(exp->GetOperator(), lVal, rVal);
+        }
+        else
+        {
+            DAVA_THROW(FormulaException, Format("Operator '%s' cannot be applied to '%s', '%s'",
+                                                FormulaFormatter::BinaryOpToString(exp->GetOperator()).c_str(),
+                                                FormulaFormatter::AnyTypeToString(l).c_str(),
+                                                FormulaFormatter::AnyTypeToString(r).c_str()),
+                       exp);
+        }
+    }
+}
+
+Any FormulaExecutor::CallFunction(const std::shared_ptr<FormulaContext>& context, FormulaFunctionExpression* exp, Vector<Any>& values)
+{
+    Vector<const Type*> types;
+    types.reserve(values.size());
+    for (const Any& v : values)
+    {
+        types.push_back(v.GetType());
+    }
+
+    AnyFn fn = context->FindFunction(exp->GetName(), types);
+    if (!fn.IsValid())
+    {
+        String args;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (i > 0)
+            {
+                args += ", ";
+            }
+            args += FormulaFormatter::AnyTypeToString(values[i]);
+        }
+        DAVA_THROW(FormulaException, Format("Can't resolve function '%s(%s)'", exp->GetName().c_str(), args.c_str()), exp);
+    }
+
+    int32 index = 1; // Skip first arg (FormulaContext).
+    for (Any& v : values)
+    {
+        int32 intVal = 0;
+        if (fn.GetInvokeParams().argsType[index] == Type::Instance<float32>() && FormulaExecutor::CastToInt32(v, &intVal))
+        {
+            v = Any(static_cast<float32>(intVal));
+        }
+
+        index++;
+    }
+
+    switch (values.size())
+    {
+    case 0:
+        return fn.Invoke(context);
+
+    case 1:
+        return fn.Invoke(context, values[0]);
+
+    case 2:
+        return fn.Invoke(context, values[0], values[1]);
+
+    case 3:
+        return fn.Invoke(context, values[0], values[1], values[2]);
+
+    case 4:
+        return fn.Invoke(context, values[0], values[1], values[2], values[3]);
+
+    case 5:
+        return fn.Invoke(context, values[0], values[1], values[2], values[3], values[4]);
+
+    default:
+    {
+        String args;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (i > 0)
+            {
+                args += ", ";
+            }
+            args += FormulaFormatter::AnyTypeToString(values[i]);
+        }
+        DAVA_THROW(FormulaException,
+                   Format("Function '%s(%s)' has to much arguments (more than 5)",
+                          exp->GetName().c_str(),
+                          args.c_str()),
+                   exp);
+    }
+    }
+}
+
 template <typename T>
-Any FormulaExecutor::CalculateNumberAnyValues(FormulaBinaryOperatorExpression::Operator op, Any anyLVal, Any anyRVal) const
+Any FormulaExecutor::CalculateNumberAnyValues(FormulaBinaryOperatorExpression::Operator op, Any anyLVal, Any anyRVal)
 {
     T lVal = anyLVal.Cast<T>();
     T rVal = anyRVal.Cast<T>();
@@ -462,7 +470,7 @@ Any FormulaExecutor::CalculateNumberAnyValues(FormulaBinaryOperatorExpression::O
 }
 
 template <typename T>
-Any FormulaExecutor::CalculateIntAnyValues(FormulaBinaryOperatorExpression::Operator op, Any anyLVal, Any anyRVal, FormulaExpression* exp) const
+Any FormulaExecutor::CalculateIntAnyValues(FormulaBinaryOperatorExpression::Operator op, Any anyLVal, Any anyRVal, FormulaExpression* exp)
 {
     T lVal = anyLVal.Cast<T>();
     T rVal = anyRVal.Cast<T>();
@@ -470,7 +478,7 @@ Any FormulaExecutor::CalculateIntAnyValues(FormulaBinaryOperatorExpression::Oper
 }
 
 template <typename T>
-Any FormulaExecutor::CalculateIntValues(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal, FormulaExpression* exp) const
+Any FormulaExecutor::CalculateIntValues(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal, FormulaExpression* exp)
 {
     if (op == FormulaBinaryOperatorExpression::OP_MOD)
     {
@@ -501,7 +509,7 @@ Any FormulaExecutor::CalculateIntValues(FormulaBinaryOperatorExpression::Operato
 }
 
 template <typename T>
-Any FormulaExecutor::CalculateNumberValues(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal) const
+Any FormulaExecutor::CalculateNumberValues(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal)
 {
     switch (op)
     {
@@ -532,7 +540,7 @@ Any FormulaExecutor::CalculateNumberValues(FormulaBinaryOperatorExpression::Oper
     }
 }
 
-bool FormulaExecutor::CastToInt32(const Any& val, int32* res) const
+bool FormulaExecutor::CastToInt32(const Any& val, int32* res)
 {
     if (val.CanGet<int32>())
     {
@@ -45,6 +45,22 @@ public:
      */
     const Vector<void*>& GetDependencies() const;
 
+    /**
+     \ingroup formula
+
+     Methods apply operators and functions to already calculated values.
+     They are shared with `FormulaProgram` to keep the same type rules and
+     error messages, throw `FormulaException` for invalid arguments.
+     Empty result of `CalculateBinaryOperator` means that operator can't be
+     applied to values of these types.
+     */
+    static Any CalculateNeg(FormulaNegExpression* exp, const Any& val);
+    static Any CalculateNot(FormulaNotExpression* exp, const Any& val);
+    static Any CalculateBinaryOperator(FormulaBinaryOperatorExpression* exp, const Any& l, const Any& r);
+    static Any CallFunction(const std::shared_ptr<FormulaContext>& context, FormulaFunctionExpression* exp, Vector<Any>& values);
+
+    static bool CastToInt32(const Any& val, int32* res);
+
 private:
     void Visit(FormulaValueExpression* exp) override;
     void Visit(FormulaNegExpression* exp) override;
@@ -59,18 +75,16 @@ private:
     const Reflection& GetDataReferenceImpl(FormulaExpression* exp);
 
     template <typename T>
-    Any CalculateNumberAnyValues(FormulaBinaryOperatorExpression::Operator op, Any lVal, Any rVal) const;
+    static Any CalculateNumberAnyValues(FormulaBinaryOperatorExpression::Operator op, Any lVal, Any rVal);
 
     template <typename T>
-    Any CalculateIntAnyValues(FormulaBinaryOperatorExpression::Operator op, Any lVal, Any rVal, FormulaExpression* exp) const;
+    static Any CalculateIntAnyValues(FormulaBinaryOperatorExpression::Operator op, Any lVal, Any rVal, FormulaExpression* exp);
 
     template <typename T>
-    Any CalculateIntValues(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal, FormulaExpression* exp) const;
+    static Any CalculateIntValues(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal, FormulaExpression* exp);
 
     template <typename T>
-    Any CalculateNumberValues(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal) const;
-
-    bool CastToInt32(const Any& val, int32* res) const;
+    static Any CalculateNumberValues(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal);
 
     std::shared_ptr<FormulaContext> context;
     Any calculationResult;
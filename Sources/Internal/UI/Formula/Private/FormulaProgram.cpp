@@ -0,0 +1,716 @@
+#include "UI/Formula/Private/FormulaProgram.h"
+
+#include "UI/Formula/FormulaContext.h"
+#include "UI/Formula/Private/FormulaData.h"
+#include "UI/Formula/Private/FormulaException.h"
+#include "UI/Formula/Private/FormulaExecutor.h"
+#include "UI/Formula/Private/FormulaFormatter.h"
+#include "Base/FastName.h"
+#include "Utils/StringFormat.h"
+#include "Reflection/ReflectedTypeDB.h"
+
+namespace DAVA
+{
+class FormulaProgram::Compiler : private FormulaExpressionVisitor
+{
+public:
+    Compiler(FormulaProgram* program_)
+        : program(program_)
+    {
+    }
+
+    void CompileValue(FormulaExpression* exp)
+    {
+        bool prevReferenceMode = referenceMode;
+        referenceMode = false;
+        exp->Accept(this);
+        referenceMode = prevReferenceMode;
+    }
+
+    void CompileReference(FormulaExpression* exp)
+    {
+        bool prevReferenceMode = referenceMode;
+        referenceMode = true;
+        exp->Accept(this);
+        referenceMode = prevReferenceMode;
+    }
+
+private:
+    void Visit(FormulaValueExpression* exp) override
+    {
+        const Any& value = exp->GetValue();
+        if (referenceMode)
+        {
+            if (value.CanGet<std::shared_ptr<FormulaDataMap>>())
+            {
+                std::shared_ptr<FormulaDataMap> ptr = value.Get<std::shared_ptr<FormulaDataMap>>();
+                EmitConstantReference(Reflection::Create(ReflectedObject(ptr.get())), exp);
+            }
+            else if (value.CanGet<std::shared_ptr<FormulaDataVector>>())
+            {
+                std::shared_ptr<FormulaDataVector> ptr = value.Get<std::shared_ptr<FormulaDataVector>>();
+                EmitConstantReference(Reflection::Create(ReflectedObject(ptr.get())), exp);
+            }
+            else
+            {
+                Emit(OP_FAIL_REF, 0, exp);
+            }
+        }
+        else
+        {
+            EmitConstant(value, exp);
+        }
+    }
+
+    void Visit(FormulaNegExpression* exp) override
+    {
+        size_t start = program->instructions.size();
+        CompileValue(exp->GetExp());
+
+        Any result;
+        if (IsConstantsTail(start, 1))
+        {
+            Any val = TakeConstant();
+            result = FoldConstant([&]() { return FormulaExecutor::CalculateNeg(exp, val); });
+            if (result.IsEmpty())
+            {
+                EmitConstant(val, exp->GetExp());
+            }
+        }
+
+        if (result.IsEmpty())
+        {
+            Emit(OP_NEG, 0, exp);
+        }
+        else
+        {
+            EmitConstant(result, exp);
+        }
+        FinishValue(exp);
+    }
+
+    void Visit(FormulaNotExpression* exp) override
+    {
+        size_t start = program->instructions.size();
+        CompileValue(exp->GetExp());
+
+        Any result;
+        if (IsConstantsTail(start, 1))
+        {
+            Any val = TakeConstant();
+            result = FoldConstant([&]() { return FormulaExecutor::CalculateNot(exp, val); });
+            if (result.IsEmpty())
+            {
+                EmitConstant(val, exp->GetExp());
+            }
+        }
+
+        if (result.IsEmpty())
+        {
+            Emit(OP_NOT, 0, exp);
+        }
+        else
+        {
+            EmitConstant(result, exp);
+        }
+        FinishValue(exp);
+    }
+
+    void Visit(FormulaWhenExpression* exp) override
+    {
+        Vector<size_t> jumpsToEnd;
+        bool resolved = false;
+
+        for (const auto& branch : exp->GetBranches())
+        {
+            size_t start = program->instructions.size();
+            CompileValue(branch.first.get());
+
+            // Constant conditions select branch on compilation
+            if (IsConstantsTail(start, 1) && program->constants[program->instructions.back().arg].kind == Value::KIND_BOOL)
+            {
+                Any condition = TakeConstant();
+                if (condition.Get<bool>())
+                {
+                    CompileValue(branch.second.get());
+                    resolved = true;
+                    break;
+                }
+                continue;
+            }
+
+            size_t jumpToNextBranch = Emit(OP_JUMP_IF_NOT, 0, branch.first.get());
+            CompileValue(branch.second.get());
+            jumpsToEnd.push_back(Emit(OP_JUMP, 0, exp));
+            program->instructions[jumpToNextBranch].arg = static_cast<int32>(program->instructions.size());
+        }
+
+        if (!resolved)
+        {
+            CompileValue(exp->GetElseBranch());
+        }
+
+        for (size_t jump : jumpsToEnd)
+        {
+            program->instructions[jump].arg = static_cast<int32>(program->instructions.size());
+        }
+        FinishValue(exp);
+    }
+
+    void Visit(FormulaBinaryOperatorExpression* exp) override
+    {
+        size_t start = program->instructions.size();
+        CompileValue(exp->GetLhs());
+        CompileValue(exp->GetRhs());
+
+        Any result;
+        if (IsConstantsTail(start, 2))
+        {
+            Any r = TakeConstant();
+            Any l = TakeConstant();
+            result = FoldConstant([&]() { return FormulaExecutor::CalculateBinaryOperator(exp, l, r); });
+            if (result.IsEmpty())
+            {
+                EmitConstant(l, exp->GetLhs());
+                EmitConstant(r, exp->GetRhs());
+            }
+        }
+
+        if (result.IsEmpty())
+        {
+            Emit(OP_BINARY, static_cast<int32>(exp->GetOperator()), exp);
+        }
+        else
+        {
+            EmitConstant(result, exp);
+        }
+        FinishValue(exp);
+    }
+
+    void Visit(FormulaFunctionExpression* exp) override
+    {
+        const Vector<std::shared_ptr<FormulaExpression>>& params = exp->GetParms();
+        for (const std::shared_ptr<FormulaExpression>& paramExp : params)
+        {
+            CompileValue(paramExp.get());
+        }
+        Emit(OP_CALL, static_cast<int32>(params.size()), exp);
+        FinishValue(exp);
+    }
+
+    void Visit(FormulaFieldAccessExpression* exp) override
+    {
+        if (exp->GetExp())
+        {
+            CompileReference(exp->GetExp());
+
+            // Key is converted to FastName once, structures look up fields by it
+            program->keys.push_back(Any(FastName(exp->GetFieldName())));
+            Emit(OP_FIELD, static_cast<int32>(program->keys.size() - 1), exp);
+        }
+        else
+        {
+            program->names.push_back(exp->GetFieldName());
+            Emit(OP_CONTEXT_FIELD, static_cast<int32>(program->names.size() - 1), exp);
+        }
+        Emit(referenceMode ? OP_DEREF : OP_LOAD, 0, exp);
+    }
+
+    void Visit(FormulaIndexExpression* exp) override
+    {
+        CompileValue(exp->GetIndexExp());
+        CompileReference(exp->GetExp());
+        Emit(OP_INDEX, 0, exp);
+        Emit(referenceMode ? OP_DEREF : OP_LOAD, 0, exp);
+    }
+
+    size_t Emit(OpCode opCode, int32 arg, FormulaExpression* exp)
+    {
+        program->instructions.push_back(Instruction{ opCode, arg, exp });
+        return program->instructions.size() - 1;
+    }
+
+    void EmitConstant(const Any& value, FormulaExpression* exp)
+    {
+        program->constants.emplace_back();
+        SetValue(program->constants.back(), Any(value));
+        Emit(OP_PUSH_CONST, static_cast<int32>(program->constants.size() - 1), exp);
+    }
+
+    void EmitConstantReference(const Reflection& ref, FormulaExpression* exp)
+    {
+        program->constantRefs.push_back(ref);
+        Emit(OP_PUSH_CONST_REF, static_cast<int32>(program->constantRefs.size() - 1), exp);
+    }
+
+    // Expression which isn't data access can't be used as reference, but its operands
+    // are still calculated before error as `FormulaExecutor` does
+    void FinishValue(FormulaExpression* exp)
+    {
+        if (referenceMode)
+        {
+            Emit(OP_FAIL_REF, 0, exp);
+        }
+    }
+
+    bool IsConstantsTail(size_t start, size_t count) const
+    {
+        const Vector<Instruction>& instructions = program->instructions;
+        if (instructions.size() != start + count)
+        {
+            return false;
+        }
+        for (size_t i = start; i < instructions.size(); i++)
+        {
+            if (instructions[i].opCode != OP_PUSH_CONST)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Any TakeConstant()
+    {
+        Instruction instruction = program->instructions.back();
+        program->instructions.pop_back();
+
+        Any value = GetValue(program->constants[instruction.arg]);
+        if (static_cast<size_t>(instruction.arg) + 1 == program->constants.size())
+        {
+            program->constants.pop_back();
+        }
+        return value;
+    }
+
+    // Errors aren't reported on compilation, expression is left to throw them on calculation
+    template <typename Fn>
+    Any FoldConstant(Fn fn)
+    {
+        try
+        {
+            return fn();
+        }
+        catch (const FormulaException&)
+        {
+            return Any();
+        }
+    }
+
+    FormulaProgram* program = nullptr;
+    bool referenceMode = false;
+};
+
+FormulaProgram::FormulaProgram(const std::shared_ptr<FormulaExpression>& exp)
+    : expression(exp)
+{
+    DVASSERT(expression);
+    Compiler(this).CompileValue(expression.get());
+}
+
+FormulaProgram::~FormulaProgram()
+{
+}
+
+Any FormulaProgram::Calculate(const std::shared_ptr<FormulaContext>& context)
+{
+    valuesStack.clear();
+    refsStack.clear();
+    dependencies.clear();
+
+    const size_t instructionsCount = instructions.size();
+    size_t pc = 0;
+    while (pc < instructionsCount)
+    {
+        const Instruction& instruction = instructions[pc++];
+        switch (instruction.opCode)
+        {
+        case OP_PUSH_CONST:
+            valuesStack.push_back(constants[instruction.arg]);
+            break;
+
+        case OP_PUSH_CONST_REF:
+            refsStack.push_back(constantRefs[instruction.arg]);
+            break;
+
+        case OP_CONTEXT_FIELD:
+        {
+            refsStack.push_back(context->FindReflection(names[instruction.arg]));
+            if (!refsStack.back().IsValid())
+            {
+                DAVA_THROW(FormulaException, Format("Can't resolve symbol '%s'", names[instruction.arg].c_str()), instruction.exp);
+            }
+            AddDependency(refsStack.back());
+            break;
+        }
+
+        case OP_FIELD:
+        {
+            Reflection& ref = refsStack.back();
+            ref = ref.GetField(keys[instruction.arg]);
+            if (!ref.IsValid())
+            {
+                const String& fieldName = static_cast<FormulaFieldAccessExpression*>(instruction.exp)->GetFieldName();
+                DAVA_THROW(FormulaException, Format("Can't resolve symbol '%s'", fieldName.c_str()), instruction.exp);
+            }
+            AddDependency(ref);
+            break;
+        }
+
+        case OP_INDEX:
+        {
+            Any indexVal = GetValue(valuesStack.back());
+            valuesStack.pop_back();
+
+            Reflection& ref = refsStack.back();
+            ref = ref.GetField(indexVal);
+            if (!ref.IsValid())
+            {
+                DAVA_THROW(FormulaException, Format("Can't get data '%s' by index '%s' with type '%s'",
+                                                    FormulaFormatter().Format(instruction.exp).c_str(),
+                                                    FormulaFormatter::AnyToString(indexVal).c_str(),
+                                                    FormulaFormatter::AnyTypeToString(indexVal).c_str()),
+                           instruction.exp);
+            }
+            AddDependency(ref);
+            break;
+        }
+
+        case OP_DEREF:
+            ExecuteNestedReference(refsStack.back(), context);
+            break;
+
+        case OP_LOAD:
+        {
+            valuesStack.emplace_back();
+            SetValue(valuesStack.back(), refsStack.back().GetValue());
+            refsStack.pop_back();
+            ExecuteNestedExpression(valuesStack.back(), context);
+            break;
+        }
+
+        case OP_NEG:
+        {
+            Value& value = valuesStack.back();
+            if (value.kind == Value::KIND_INT32)
+            {
+                value.intValue = -value.intValue;
+            }
+            else if (value.kind == Value::KIND_FLOAT32)
+            {
+                value.floatValue = -value.floatValue;
+            }
+            else
+            {
+                SetValue(value, FormulaExecutor::CalculateNeg(static_cast<FormulaNegExpression*>(instruction.exp), GetValue(value)));
+            }
+            break;
+        }
+
+        case OP_NOT:
+        {
+            Value& value = valuesStack.back();
+            if (value.kind == Value::KIND_BOOL)
+            {
+                value.boolValue = !value.boolValue;
+            }
+            else
+            {
+                SetValue(value, FormulaExecutor::CalculateNot(static_cast<FormulaNotExpression*>(instruction.exp), GetValue(value)));
+            }
+            break;
+        }
+
+        case OP_BINARY:
+            ExecuteBinaryOperator(instruction);
+            break;
+
+        case OP_CALL:
+            ExecuteCall(instruction, context);
+            break;
+
+        case OP_JUMP_IF_NOT:
+        {
+            const Value& value = valuesStack.back();
+            if (value.kind != Value::KIND_BOOL)
+            {
+                DAVA_THROW(FormulaException, Format("Invalid argument type '%s' to when selector expression", FormulaFormatter::AnyTypeToString(GetValue(value)).c_str()), instruction.exp);
+            }
+            if (!value.boolValue)
+            {
+                pc = static_cast<size_t>(instruction.arg);
+            }
+            valuesStack.pop_back();
+            break;
+        }
+
+        case OP_JUMP:
+            pc = static_cast<size_t>(instruction.arg);
+            break;
+
+        case OP_FAIL_REF:
+            DAVA_THROW(FormulaException, Format("Can't get data reference '%s'", FormulaFormatter().Format(instruction.exp).c_str()), instruction.exp);
+        }
+    }
+
+    DVASSERT(valuesStack.size() == 1 && refsStack.empty());
+    return GetValue(valuesStack.back());
+}
+
+const Vector<void*>& FormulaProgram::GetDependencies() const
+{
+    return dependencies;
+}
+
+FormulaExpression* FormulaProgram::GetExpression() const
+{
+    return expression.get();
+}
+
+uint32 FormulaProgram::GetInstructionsCount() const
+{
+    return static_cast<uint32>(instructions.size());
+}
+
+void FormulaProgram::SetValue(Value& value, Any&& any)
+{
+    const Type* type = any.GetType();
+    if (type == Type::Instance<bool>())
+    {
+        SetBool(value, any.Get<bool>());
+    }
+    else if (type == Type::Instance<int32>())
+    {
+        SetNumber(value, any.Get<int32>());
+    }
+    else if (type == Type::Instance<float32>())
+    {
+        SetNumber(value, any.Get<float32>());
+    }
+    else
+    {
+        value.kind = Value::KIND_ANY;
+        value.anyValue = std::move(any);
+    }
+}
+
+Any FormulaProgram::GetValue(const Value& value)
+{
+    switch (value.kind)
+    {
+    case Value::KIND_BOOL:
+        return Any(value.boolValue);
+    case Value::KIND_INT32:
+        return Any(value.intValue);
+    case Value::KIND_FLOAT32:
+        return Any(value.floatValue);
+    default:
+        return value.anyValue;
+    }
+}
+
+template <typename T>
+bool FormulaProgram::CalculateNumbers(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal, Value& result)
+{
+    switch (op)
+    {
+    case FormulaBinaryOperatorExpression::OP_PLUS:
+        SetNumber(result, static_cast<T>(lVal + rVal));
+        return true;
+    case FormulaBinaryOperatorExpression::OP_MINUS:
+        SetNumber(result, static_cast<T>(lVal - rVal));
+        return true;
+    case FormulaBinaryOperatorExpression::OP_MUL:
+        SetNumber(result, static_cast<T>(lVal * rVal));
+        return true;
+    case FormulaBinaryOperatorExpression::OP_DIV:
+        if (std::is_integral<T>::value && rVal == 0)
+        {
+            return false;
+        }
+        SetNumber(result, static_cast<T>(lVal / rVal));
+        return true;
+    case FormulaBinaryOperatorExpression::OP_EQ:
+        SetBool(result, lVal == rVal);
+        return true;
+    case FormulaBinaryOperatorExpression::OP_NOT_EQ:
+        SetBool(result, lVal != rVal);
+        return true;
+    case FormulaBinaryOperatorExpression::OP_LE:
+        SetBool(result, lVal <= rVal);
+        return true;
+    case FormulaBinaryOperatorExpression::OP_LT:
+        SetBool(result, lVal < rVal);
+        return true;
+    case FormulaBinaryOperatorExpression::OP_GE:
+        SetBool(result, lVal >= rVal);
+        return true;
+    case FormulaBinaryOperatorExpression::OP_GT:
+        SetBool(result, lVal > rVal);
+        return true;
+    default:
+        // Modulo, logical operators and errors are left to executor
+        return false;
+    }
+}
+
+void FormulaProgram::SetNumber(Value& value, int32 number)
+{
+    value.kind = Value::KIND_INT32;
+    value.intValue = number;
+    value.anyValue.Clear();
+}
+
+void FormulaProgram::SetNumber(Value& value, float32 number)
+{
+    value.kind = Value::KIND_FLOAT32;
+    value.floatValue = number;
+    value.anyValue.Clear();
+}
+
+void FormulaProgram::SetBool(Value& value, bool boolean)
+{
+    value.kind = Value::KIND_BOOL;
+    value.boolValue = boolean;
+    value.anyValue.Clear();
+}
+
+void FormulaProgram::ExecuteBinaryOperator(const Instruction& instruction)
+{
+    FormulaBinaryOperatorExpression::Operator op = static_cast<FormulaBinaryOperatorExpression::Operator>(instruction.arg);
+
+    Value& l = valuesStack[valuesStack.size() - 2];
+    const Value& r = valuesStack.back();
+
+    bool calculated = false;
+    if (l.kind == Value::KIND_INT32 && r.kind == Value::KIND_INT32)
+    {
+        if (op == FormulaBinaryOperatorExpression::OP_MOD)
+        {
+            if (r.intValue != 0)
+            {
+                SetNumber(l, l.intValue % r.intValue);
+                calculated = true;
+            }
+        }
+        else
+        {
+            calculated = CalculateNumbers<int32>(op, l.intValue, r.intValue, l);
+        }
+    }
+    else if ((l.kind == Value::KIND_INT32 || l.kind == Value::KIND_FLOAT32) && (r.kind == Value::KIND_INT32 || r.kind == Value::KIND_FLOAT32))
+    {
+        float32 lVal = l.kind == Value::KIND_FLOAT32 ? l.floatValue : static_cast<float32>(l.intValue);
+        float32 rVal = r.kind == Value::KIND_FLOAT32 ? r.floatValue : static_cast<float32>(r.intValue);
+        calculated = CalculateNumbers<float32>(op, lVal, rVal, l);
+    }
+    else if (l.kind == Value::KIND_BOOL && r.kind == Value::KIND_BOOL)
+    {
+        calculated = true;
+        switch (op)
+        {
+        case FormulaBinaryOperatorExpression::OP_AND:
+            l.boolValue = l.boolValue && r.boolValue;
+            break;
+        case FormulaBinaryOperatorExpression::OP_OR:
+            l.boolValue = l.boolValue || r.boolValue;
+            break;
+        case FormulaBinaryOperatorExpression::OP_EQ:
+            l.boolValue = l.boolValue == r.boolValue;
+            break;
+        case FormulaBinaryOperatorExpression::OP_NOT_EQ:
+            l.boolValue = l.boolValue != r.boolValue;
+            break;
+        default:
+            calculated = false;
+            break;
+        }
+    }
+
+    if (!calculated)
+    {
+        FormulaBinaryOperatorExpression* exp = static_cast<FormulaBinaryOperatorExpression*>(instruction.exp);
+        Any result = FormulaExecutor::CalculateBinaryOperator(exp, GetValue(l), GetValue(r));
+        if (result.IsEmpty())
+        {
+            DAVA_THROW(FormulaException, Format("Can't calculate expression '%s'", FormulaFormatter().Format(exp).c_str()), exp);
+        }
+        SetValue(l, std::move(result));
+    }
+
+    valuesStack.pop_back();
+}
+
+void FormulaProgram::ExecuteCall(const Instruction& instruction, const std::shared_ptr<FormulaContext>& context)
+{
+    FormulaFunctionExpression* exp = static_cast<FormulaFunctionExpression*>(instruction.exp);
+    const size_t argsCount = static_cast<size_t>(instruction.arg);
+    const size_t firstArg = valuesStack.size() - argsCount;
+
+    args.clear();
+    for (size_t i = 0; i < argsCount; i++)
+    {
+        args.push_back(GetValue(valuesStack[firstArg + i]));
+        if (args.back().IsEmpty())
+        {
+            FormulaExpression* paramExp = exp->GetParms()[i].get();
+            DAVA_THROW(FormulaException, Format("Can't calculate param '%s' for function '%s'",
+                                                FormulaFormatter().Format(paramExp).c_str(),
+                                                exp->GetName().c_str()),
+                       paramExp);
+        }
+    }
+    valuesStack.resize(firstArg);
+
+    Any result = FormulaExecutor::CallFunction(context, exp, args);
+    if (result.IsEmpty())
+    {
+        DAVA_THROW(FormulaException, Format("Can't calculate expression '%s'", FormulaFormatter().Format(exp).c_str()), exp);
+    }
+
+    valuesStack.emplace_back();
+    SetValue(valuesStack.back(), std::move(result));
+    ExecuteNestedExpression(valuesStack.back(), context);
+}
+
+void FormulaProgram::ExecuteNestedExpression(Value& value, const std::shared_ptr<FormulaContext>& context)
+{
+    if (value.kind == Value::KIND_ANY && value.anyValue.CanGet<std::shared_ptr<FormulaExpression>>())
+    {
+        // Expressions stored in data are rare, they are calculated by executor
+        std::shared_ptr<FormulaExpression> internalExpr = value.anyValue.Get<std::shared_ptr<FormulaExpression>>();
+        FormulaExecutor executor(context);
+        SetValue(value, executor.Calculate(internalExpr.get()));
+
+        const Vector<void*>& internalDependencies = executor.GetDependencies();
+        dependencies.insert(dependencies.end(), internalDependencies.begin(), internalDependencies.end());
+    }
+}
+
+void FormulaProgram::ExecuteNestedReference(Reflection& ref, const std::shared_ptr<FormulaContext>& context)
+{
+    // Only `Any` and expression fields can hold expression, value of other
+    // fields (e.g. whole containers) isn't copied to check it
+    const Type* type = ref.GetValueType()->Decay();
+    if (type != Type::Instance<Any>() && type != Type::Instance<std::shared_ptr<FormulaExpression>>())
+    {
+        return;
+    }
+
+    Any value = ref.GetValue();
+    if (value.CanCast<std::shared_ptr<FormulaExpression>>())
+    {
+        std::shared_ptr<FormulaExpression> internalExpr = value.Cast<std::shared_ptr<FormulaExpression>>();
+        FormulaExecutor executor(context);
+        ref = executor.GetDataReference(internalExpr.get());
+
+        const Vector<void*>& internalDependencies = executor.GetDependencies();
+        dependencies.insert(dependencies.end(), internalDependencies.begin(), internalDependencies.end());
+    }
+}
+
+void FormulaProgram::AddDependency(const Reflection& ref)
+{
+    dependencies.push_back(ref.GetValueObject().GetVoidPtr());
+}
+}
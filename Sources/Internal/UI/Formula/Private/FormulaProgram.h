@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/Any.h"
+#include "Reflection/Reflection.h"
+#include "UI/Formula/Private/FormulaExpression.h"
+
+namespace DAVA
+{
+class FormulaContext;
+
+/**
+ \ingroup formula
+
+ Expression compiled to compact stack bytecode.
+
+ Program gives the same results, dependencies and errors as `FormulaExecutor`
+ but doesn't walk AST for every calculation:
+ - subexpressions of constants are folded on compilation,
+ - bool, int32 and float32 values are kept unboxed on value stack and
+   arithmetic on them doesn't go through `Any` casts,
+ - field names are converted to reflection keys once.
+ Values of other types fall back to operators of `FormulaExecutor`.
+
+ Program keeps stacks between calculations, so it shouldn't be calculated
+ from several threads simultaneously.
+ */
+class FormulaProgram final
+{
+public:
+    FormulaProgram(const std::shared_ptr<FormulaExpression>& exp);
+    ~FormulaProgram();
+
+    /**
+     Calculates expression with data from context and returns result.
+     Throws `FormulaException` on errors as `FormulaExecutor` does.
+     */
+    Any Calculate(const std::shared_ptr<FormulaContext>& context);
+
+    /**
+     Data pointers which last calculation depends on, see `FormulaExecutor::GetDependencies`.
+     */
+    const Vector<void*>& GetDependencies() const;
+
+    FormulaExpression* GetExpression() const;
+
+    /**
+     Count of compiled instructions, expressions folded to constants take one instruction.
+     */
+    uint32 GetInstructionsCount() const;
+
+private:
+    class Compiler;
+
+    enum OpCode : uint8
+    {
+        OP_PUSH_CONST, // push `constants[arg]`
+        OP_PUSH_CONST_REF, // push `constantRefs[arg]` to references stack
+        OP_CONTEXT_FIELD, // push reference to context variable `names[arg]`
+        OP_FIELD, // replace top reference with its field `keys[arg]`
+        OP_INDEX, // pop index value, replace top reference with its field by index
+        OP_DEREF, // replace top reference to nested expression with reference calculated by expression
+        OP_LOAD, // pop reference and push its value
+        OP_NEG,
+        OP_NOT,
+        OP_BINARY,
+        OP_CALL, // pop `arg` values and push result of function call
+        OP_JUMP_IF_NOT, // pop when condition, jump to `arg` if it's false
+        OP_JUMP,
+        OP_FAIL_REF // throw error that expression isn't data reference
+    };
+
+    struct Instruction
+    {
+        OpCode opCode;
+        int32 arg;
+        FormulaExpression* exp;
+    };
+
+    struct Value
+    {
+        enum Kind : uint8
+        {
+            KIND_BOOL,
+            KIND_INT32,
+            KIND_FLOAT32,
+            KIND_ANY
+        };
+
+        Kind kind = KIND_ANY;
+        union
+        {
+            bool boolValue;
+            int32 intValue = 0;
+            float32 floatValue;
+        };
+        Any anyValue;
+    };
+
+    static void SetValue(Value& value, Any&& any);
+    static Any GetValue(const Value& value);
+
+    template <typename T>
+    static bool CalculateNumbers(FormulaBinaryOperatorExpression::Operator op, T lVal, T rVal, Value& result);
+    static void SetNumber(Value& value, int32 number);
+    static void SetNumber(Value& value, float32 number);
+    static void SetBool(Value& value, bool boolean);
+
+    void ExecuteBinaryOperator(const Instruction& instruction);
+    void ExecuteCall(const Instruction& instruction, const std::shared_ptr<FormulaContext>& context);
+    void ExecuteNestedExpression(Value& value, const std::shared_ptr<FormulaContext>& context);
+    void ExecuteNestedReference(Reflection& ref, const std::shared_ptr<FormulaContext>& context);
+    void AddDependency(const Reflection& ref);
+
+    std::shared_ptr<FormulaExpression> expression;
+
+    Vector<Instruction> instructions;
+    Vector<Value> constants;
+    Vector<Reflection> constantRefs;
+    Vector<String> names;
+    Vector<Any> keys;
+
+    Vector<Value> valuesStack;
+    Vector<Reflection> refsStack;
+    Vector<Any> args;
+    Vector<void*> dependencies;
+};
+}
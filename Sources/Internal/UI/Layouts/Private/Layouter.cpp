@@ -16,6 +16,7 @@ namespace DAVA
 void Layouter::ApplyLayout(UIControl* control)
 {
     CollectControls(control, true);
+    measuredControlsCount += static_cast<uint32>(layoutData.size());
 
     ProcessAxis(Vector2::AXIS_X, true);
     ProcessAxis(Vector2::AXIS_Y, true);
@@ -41,6 +41,10 @@ public:
     const Vector<ControlLayoutData>& GetLayoutData() const;
     Vector<ControlLayoutData>& GetLayoutData();
 
+    // Count of controls measured and positioned by `ApplyLayout` since the last reset
+    uint32 GetMeasuredControlsCount() const;
+    void ResetMeasuredControlsCount();
+
     Function<void(UIControl*, Vector2::eAxis, const LayoutFormula*)> onFormulaRemoved;
     Function<void(UIControl*, Vector2::eAxis, const LayoutFormula*)> onFormulaProcessed;
 
@@ -51,6 +55,7 @@ private:
     LayoutMargins safeAreaInsets;
     bool isLeftNotch = false;
     bool isRightNotch = false;
+    uint32 measuredControlsCount = 0;
 };
 
 inline const Vector<ControlLayoutData>& Layouter::GetLayoutData() const
@@ -63,6 +68,16 @@ inline Vector<ControlLayoutData>& Layouter::GetLayoutData()
     return layoutData;
 }
 
+inline uint32 Layouter::GetMeasuredControlsCount() const
+{
+    return measuredControlsCount;
+}
+
+inline void Layouter::ResetMeasuredControlsCount()
+{
+    measuredControlsCount = 0;
+}
+
 inline bool Layouter::IsRtl() const
 {
     return isRtl;
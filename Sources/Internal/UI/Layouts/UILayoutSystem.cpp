@@ -82,6 +82,9 @@ void UILayoutSystem::Process(float32 elapsedTime)
 
     DVASSERT(Thread::IsMainThread());
 
+    stats = Stats();
+    sharedLayouter->ResetMeasuredControlsCount();
+
     if (!IsAutoupdatesEnabled())
         return;
 
@@ -226,6 +229,7 @@ void UILayoutSystem::ProcessControl(UIControl* control)
     {
         UIControl* container = FindNotDependentOnChildrenControl(control);
         sharedLayouter->ApplyLayout(container);
+        stats.layoutsCount++;
 
         controlLayouted.Emit(container);
     }
@@ -233,6 +237,7 @@ void UILayoutSystem::ProcessControl(UIControl* control)
     {
         UIControl* container = control->GetParent();
         sharedLayouter->ApplyLayoutNonRecursive(container);
+        stats.repositionsCount++;
         controlLayouted.Emit(container);
     }
 }
@@ -257,6 +262,13 @@ void UILayoutSystem::ManualApplyLayout(UIControl* control)
     localLayouter.ApplyLayout(control);
 }
 
+UILayoutSystem::Stats UILayoutSystem::GetFrameStats() const
+{
+    Stats result = stats;
+    result.measuredControlsCount = sharedLayouter->GetMeasuredControlsCount();
+    return result;
+}
+
 bool UILayoutSystem::IsAutoupdatesEnabled() const
 {
     return autoupdatesEnabled;
@@ -331,6 +343,13 @@ bool UILayoutSystem::HaveToLayoutAfterReposition(const UIControl* control) const
 
 void UILayoutSystem::ProcessControlHierarhy(UIControl* control)
 {
+    // dirty controls mark all their ancestors, so subtrees without dirty layout are skipped
+    if (!control->IsLayoutHierarchyDirty())
+        return;
+
+    control->ResetLayoutHierarchyDirty();
+    stats.visitedControlsCount++;
+
     ProcessControl(control);
 
     // TODO: For now game has many places where changes in layouts can
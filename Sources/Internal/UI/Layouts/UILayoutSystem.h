@@ -19,6 +19,14 @@ class LayoutFormula;
 class UILayoutSystem : public UISystem
 {
 public:
+    struct Stats
+    {
+        uint32 visitedControlsCount = 0; ///< Controls checked for dirty layout, clean subtrees are skipped
+        uint32 layoutsCount = 0; ///< Full layouts of containers of dirty controls
+        uint32 repositionsCount = 0; ///< Position-only layouts of parents of moved controls
+        uint32 measuredControlsCount = 0; ///< Controls measured and positioned by full layouts
+    };
+
     UILayoutSystem();
     ~UILayoutSystem() override;
 
@@ -46,6 +54,9 @@ public:
 
     void ManualApplyLayout(UIControl* control); //DON'T USE IT!
 
+    /** Layout statistics of the last frame, including controls processed by `ForceProcessControl` after it. */
+    Stats GetFrameStats() const;
+
     Signal<UIControl*> controlLayouted;
     Signal<UIControl*, Vector2::eAxis, const LayoutFormula*> formulaProcessed;
     Signal<UIControl*, Vector2::eAxis, const LayoutFormula*> formulaRemoved;
@@ -89,6 +100,8 @@ private:
     bool isLeftNotch = false;
     bool isRightNotch = false;
 
+    Stats stats;
+
     friend UILayoutSystemTest;
 };
 
@@ -90,6 +90,7 @@ UIControl::UIControl(const Rect& rect)
     , layoutDirty(true)
     , layoutPositionDirty(true)
     , layoutOrderDirty(true)
+    , layoutHierarchyDirty(true)
     , inputEnabled(true)
 {
     StartControlTracking(this);
@@ -890,6 +891,7 @@ void UIControl::CopyDataFrom(UIControl* srcControl)
     layoutDirty = srcControl->layoutDirty;
     layoutPositionDirty = srcControl->layoutPositionDirty;
     layoutOrderDirty = srcControl->layoutOrderDirty;
+    layoutHierarchyDirty = true;
     packageContext = srcControl->packageContext;
 
     eventDispatcher = nullptr;
@@ -2316,6 +2318,7 @@ void UIControl::ResetStyleSheetDirty()
 void UIControl::SetLayoutDirty()
 {
     layoutDirty = true;
+    PropagateLayoutHierarchyDirty();
     if (scene)
     {
         scene->GetLayoutSystem()->SetDirty();
@@ -2336,6 +2339,7 @@ void UIControl::ResetLayoutDirty()
 void UIControl::SetLayoutPositionDirty()
 {
     layoutPositionDirty = true;
+    PropagateLayoutHierarchyDirty();
     if (scene)
     {
         scene->GetLayoutSystem()->SetDirty();
@@ -2354,6 +2358,7 @@ void UIControl::ResetLayoutPositionDirty()
 void UIControl::SetLayoutOrderDirty()
 {
     layoutOrderDirty = true;
+    PropagateLayoutHierarchyDirty();
 }
 
 void UIControl::ResetLayoutOrderDirty()
@@ -2361,6 +2366,20 @@ void UIControl::ResetLayoutOrderDirty()
     layoutOrderDirty = false;
 }
 
+void UIControl::ResetLayoutHierarchyDirty()
+{
+    layoutHierarchyDirty = false;
+}
+
+void UIControl::PropagateLayoutHierarchyDirty()
+{
+    // ancestors of marked control are marked already, except ones the layout system is processing right now
+    for (UIControl* control = this; control != nullptr && !control->layoutHierarchyDirty; control = control->parent)
+    {
+        control->layoutHierarchyDirty = true;
+    }
+}
+
 void UIControl::SetPackageContext(const RefPtr<UIControlPackageContext>& newPackageContext)
 {
     if (packageContext != newPackageContext)
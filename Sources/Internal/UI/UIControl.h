@@ -906,6 +906,7 @@ protected:
     bool layoutDirty : 1;
     bool layoutPositionDirty : 1;
     bool layoutOrderDirty : 1;
+    bool layoutHierarchyDirty : 1; // control or any of its descendants has dirty layout
 
     int32 inputProcessorsCount = 1;
 
@@ -1082,6 +1083,9 @@ public:
     void SetLayoutOrderDirty();
     void ResetLayoutOrderDirty();
 
+    bool IsLayoutHierarchyDirty() const;
+    void ResetLayoutHierarchyDirty();
+
     RefPtr<UIControlPackageContext> GetPackageContext() const;
     const RefPtr<UIControlPackageContext>& GetLocalPackageContext() const;
     void SetPackageContext(const RefPtr<UIControlPackageContext>& packageContext);
@@ -1095,6 +1099,7 @@ private:
     UIControl* parentWithContext = nullptr;
 
     void PropagateParentWithContext(UIControl* newParentWithContext);
+    void PropagateLayoutHierarchyDirty();
     /* Styles */
 
 public:
@@ -1238,4 +1243,9 @@ inline bool UIControl::IsLayoutOrderDirty() const
 {
     return layoutOrderDirty;
 }
+
+inline bool UIControl::IsLayoutHierarchyDirty() const
+{
+    return layoutHierarchyDirty;
+}
 };